@@ -26,15 +26,51 @@
 
 GRUB_MOD_LICENSE ("GPLv3+");
 
+/* Freed DMA chunks kept around for reuse.  USB and AHCI allocate and
+   free identically sized descriptor chunks on every transfer; handing a
+   previous chunk back skips the aligned heap walk and keeps transfers
+   from fragmenting the heap when several drivers interleave.  The list
+   stays small: only modest chunks are kept and the total is capped.  */
+struct dma_recycle_ent
+{
+  struct dma_recycle_ent *next;
+  void *ptr;
+  grub_size_t size;
+};
+
+#define GRUB_DMA_RECYCLE_CHUNK_MAX	0x8000
+#define GRUB_DMA_RECYCLE_TOTAL_MAX	0x20000
+
+static struct dma_recycle_ent *dma_recycle_list;
+static grub_size_t dma_recycle_bytes;
+
 /* FIXME: correctly support 64-bit architectures.  */
 /* #if GRUB_TARGET_SIZEOF_VOID_P == 4 */
 struct grub_pci_dma_chunk *
 grub_memalign_dma32 (grub_size_t align, grub_size_t size)
 {
+  struct dma_recycle_ent *ent, **link;
   void *ret;
   if (align < 64)
     align = 64;
   size = ALIGN_UP (size, align);
+
+  /* A recycled chunk is good if it is aligned enough and fits without
+     leaving more than a tail of slack; sizes repeat per driver, so
+     matches are the common case.  */
+  for (link = &dma_recycle_list; (ent = *link); link = &ent->next)
+    if (ent->size >= size && ent->size - size <= 256
+	&& ((grub_addr_t) ent->ptr & (align - 1)) == 0)
+      {
+	*link = ent->next;
+	dma_recycle_bytes -= ent->size;
+	ret = ent->ptr;
+	size = ent->size;
+	grub_free (ent);
+	grub_arch_sync_dma_caches (ret, size);
+	return ret;
+      }
+
   ret = grub_memalign (align, size);
 #if GRUB_CPU_SIZEOF_VOID_P == 8
   if ((grub_addr_t) ret >> 32)
@@ -58,6 +94,23 @@ grub_dma_free (struct grub_pci_dma_chunk *ch)
 {
   grub_size_t size = (((struct grub_mm_header *) ch) - 1)->size * GRUB_MM_ALIGN;
   grub_arch_sync_dma_caches (ch, size);
+
+  if (size <= GRUB_DMA_RECYCLE_CHUNK_MAX
+      && dma_recycle_bytes + size <= GRUB_DMA_RECYCLE_TOTAL_MAX)
+    {
+      struct dma_recycle_ent *ent = grub_malloc (sizeof (*ent));
+      if (ent)
+	{
+	  ent->ptr = ch;
+	  ent->size = size;
+	  ent->next = dma_recycle_list;
+	  dma_recycle_list = ent;
+	  dma_recycle_bytes += size;
+	  return;
+	}
+      grub_errno = GRUB_ERR_NONE;
+    }
+
   grub_free (ch);
 }
 /* #endif */
@@ -1297,6 +1297,9 @@ grub_ehci_parse_notrun (grub_usb_controller_t dev,
 
   grub_dprintf ("ehci", "parse_notrun: info\n");
 
+  /* The TD chain is walked below; make all of it visible.  */
+  sync_all_caches (e);
+
   /* QH can be in any state in this case. */
   /* But EHCI or AL is not running, so QH is surely not active
    * even if it has Active bit set... */
@@ -1333,6 +1336,9 @@ grub_ehci_parse_halt (grub_usb_controller_t dev,
 
   grub_dprintf ("ehci", "parse_halt: info\n");
 
+  /* The TD chain is walked below; make all of it visible.  */
+  sync_all_caches (e);
+
   /* Remember token before call pre-finish function */
   token = grub_le_to_cpu32 (cdata->qh_virt->td_overlay.token);
 
@@ -1371,6 +1377,9 @@ grub_ehci_parse_success (grub_usb_controller_t dev,
 
   grub_dprintf ("ehci", "parse_success: info\n");
 
+  /* The TD chain is walked below; make all of it visible.  */
+  sync_all_caches (e);
+
   /* QH should be not active in this case, but it is not halted. */
   grub_ehci_pre_finish_transfer (transfer);
   grub_ehci_free_tds (e, cdata->td_first_virt, transfer, actual);
@@ -1390,33 +1399,44 @@ grub_ehci_check_transfer (grub_usb_controller_t dev,
   struct grub_ehci *e = dev->data;
   struct grub_ehci_transfer_controller_data *cdata =
     transfer->controller_data;
-  grub_uint32_t token, token_ftd;
+  grub_uint32_t status, token, token_ftd;
+
+  /* Polling inspects only this transfer's QH overlay and first TD.
+   * Syncing just those keeps the cost of an empty poll low on
+   * architectures with non-coherent DMA; sync_all_caches walks the
+   * whole TD and QH pools and the frame list and is left to the
+   * parse functions, which really touch the whole TD chain. */
+  if (cdata->qh_virt)
+    grub_arch_sync_dma_caches (cdata->qh_virt, sizeof (struct grub_ehci_qh));
+  if (cdata->td_first_virt)
+    grub_arch_sync_dma_caches (cdata->td_first_virt,
+			       sizeof (struct grub_ehci_td));
 
-  sync_all_caches (e);
+  status = grub_ehci_oper_read32 (e, GRUB_EHCI_STATUS);
 
-  grub_dprintf ("ehci",
-		"check_transfer: EHCI STATUS=%08x, cdata=%p, qh=%p\n",
-		grub_ehci_oper_read32 (e, GRUB_EHCI_STATUS),
-		cdata, cdata->qh_virt);
-  grub_dprintf ("ehci", "check_transfer: qh_hptr=%08x, ep_char=%08x\n",
-		grub_le_to_cpu32 (cdata->qh_virt->qh_hptr),
-		grub_le_to_cpu32 (cdata->qh_virt->ep_char));
-  grub_dprintf ("ehci", "check_transfer: ep_cap=%08x, td_current=%08x\n",
-		grub_le_to_cpu32 (cdata->qh_virt->ep_cap),
-		grub_le_to_cpu32 (cdata->qh_virt->td_current));
-  grub_dprintf ("ehci", "check_transfer: next_td=%08x, alt_next_td=%08x\n",
-		grub_le_to_cpu32 (cdata->qh_virt->td_overlay.next_td),
-		grub_le_to_cpu32 (cdata->qh_virt->td_overlay.alt_next_td));
-  grub_dprintf ("ehci", "check_transfer: token=%08x, buffer[0]=%08x\n",
-		grub_le_to_cpu32 (cdata->qh_virt->td_overlay.token),
-		grub_le_to_cpu32 (cdata->qh_virt->td_overlay.buffer_page[0]));
+  if (grub_debug_enabled ("ehci"))
+    {
+      grub_dprintf ("ehci",
+		    "check_transfer: EHCI STATUS=%08x, cdata=%p, qh=%p\n",
+		    status, cdata, cdata->qh_virt);
+      grub_dprintf ("ehci", "check_transfer: qh_hptr=%08x, ep_char=%08x\n",
+		    grub_le_to_cpu32 (cdata->qh_virt->qh_hptr),
+		    grub_le_to_cpu32 (cdata->qh_virt->ep_char));
+      grub_dprintf ("ehci", "check_transfer: ep_cap=%08x, td_current=%08x\n",
+		    grub_le_to_cpu32 (cdata->qh_virt->ep_cap),
+		    grub_le_to_cpu32 (cdata->qh_virt->td_current));
+      grub_dprintf ("ehci", "check_transfer: next_td=%08x, alt_next_td=%08x\n",
+		    grub_le_to_cpu32 (cdata->qh_virt->td_overlay.next_td),
+		    grub_le_to_cpu32 (cdata->qh_virt->td_overlay.alt_next_td));
+      grub_dprintf ("ehci", "check_transfer: token=%08x, buffer[0]=%08x\n",
+		    grub_le_to_cpu32 (cdata->qh_virt->td_overlay.token),
+		    grub_le_to_cpu32 (cdata->qh_virt->td_overlay.buffer_page[0]));
+    }
 
   /* Check if EHCI is running and AL is enabled */
-  if ((grub_ehci_oper_read32 (e, GRUB_EHCI_STATUS)
-       & GRUB_EHCI_ST_HC_HALTED) != 0)
+  if ((status & GRUB_EHCI_ST_HC_HALTED) != 0)
     return grub_ehci_parse_notrun (dev, transfer, actual);
-  if ((grub_ehci_oper_read32 (e, GRUB_EHCI_STATUS)
-       & (GRUB_EHCI_ST_AS_STATUS | GRUB_EHCI_ST_PS_STATUS)) == 0)
+  if ((status & (GRUB_EHCI_ST_AS_STATUS | GRUB_EHCI_ST_PS_STATUS)) == 0)
     return grub_ehci_parse_notrun (dev, transfer, actual);
 
   token = grub_le_to_cpu32 (cdata->qh_virt->td_overlay.token);
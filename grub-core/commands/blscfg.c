@@ -136,6 +136,13 @@ static int bls_add_keyval(struct bls_entry *entry, char *key, char *val)
   kv->key = k;
   kv->val = v;
 
+  /* Remember the keys that get looked up once per entry per menu pass,
+   * so those paths don't rescan the keyval array. */
+  if (!entry->title && grub_strcmp (k, "title") == 0)
+    entry->title = v;
+  else if (!entry->clinux && grub_strcmp (k, "linux") == 0)
+    entry->clinux = v;
+
   entry->keyvals[entry->nkeyvals] = kv;
   grub_dprintf("blscfg", "new keyval at %p:%s:%s\n", entry->keyvals[entry->nkeyvals], k, v);
   entry->nkeyvals = new_n;
@@ -361,32 +368,19 @@ split_package_string (char *package_string, char **name,
     }
 }
 
-static int
-split_cmp(char *nvr0, char *nvr1, int has_name)
+/* Precompute the name/version/release sort key so comparisons don't
+ * re-copy and re-split the filename every time. */
+static int bls_make_key(struct bls_entry *entry)
 {
-  int ret = 0;
-  char *name0, *version0, *release0;
-  char *name1, *version1, *release1;
-
-  split_package_string(nvr0, has_name ? &name0 : NULL, &version0, &release0);
-  split_package_string(nvr1, has_name ? &name1 : NULL, &version1, &release1);
-
-  if (has_name)
-    {
-      ret = vercmp(name0 == NULL ? "" : name0,
-		   name1 == NULL ? "" : name1);
-      if (ret != 0)
-	return ret;
-    }
+  entry->verbuf = grub_strdup(entry->filename);
+  if (!entry->verbuf)
+    return grub_error (GRUB_ERR_OUT_OF_MEMORY,
+		       "couldn't find space for BLS entry");
 
-  ret = vercmp(version0 == NULL ? "" : version0,
-	       version1 == NULL ? "" : version1);
-  if (ret != 0)
-    return ret;
+  split_package_string(entry->verbuf, &entry->vername,
+		       &entry->verversion, &entry->verrelease);
 
-  ret = vercmp(release0 == NULL ? "" : release0,
-	       release1 == NULL ? "" : release1);
-  return ret;
+  return 0;
 }
 
 /* return 1: e0 is newer than e1 */
@@ -394,65 +388,125 @@ split_cmp(char *nvr0, char *nvr1, int has_name)
 /*       -1: e1 is newer than e0 */
 static int bls_cmp(const struct bls_entry *e0, const struct bls_entry *e1)
 {
-  char *id0, *id1;
   int r;
 
-  id0 = grub_strdup(e0->filename);
-  id1 = grub_strdup(e1->filename);
-
-  r = split_cmp(id0, id1, 1);
+  r = vercmp(e0->vername == NULL ? "" : e0->vername,
+	     e1->vername == NULL ? "" : e1->vername);
+  if (r != 0)
+    return r;
 
-  grub_free(id0);
-  grub_free(id1);
+  r = vercmp(e0->verversion == NULL ? "" : e0->verversion,
+	     e1->verversion == NULL ? "" : e1->verversion);
+  if (r != 0)
+    return r;
 
-  return r;
+  return vercmp(e0->verrelease == NULL ? "" : e0->verrelease,
+		e1->verrelease == NULL ? "" : e1->verrelease);
 }
 
-static void list_add_tail(struct bls_entry *head, struct bls_entry *item)
-{
-  item->next = head;
-  if (head->prev)
-    head->prev->next = item;
-  item->prev = head->prev;
-  head->prev = item;
-}
+static struct bls_entry *last_entry = NULL;
 
+/* Append in O(1); the list gets one sort pass after all snippets are
+ * read instead of a comparison-heavy insertion per entry. */
 static int bls_add_entry(struct bls_entry *entry)
 {
-  struct bls_entry *e, *last = NULL;
-  int rc;
+  grub_dprintf ("blscfg", "Add entry with id \"%s\"\n", entry->filename);
 
   if (!entries) {
-    grub_dprintf ("blscfg", "Add entry with id \"%s\"\n", entry->filename);
     entries = entry;
+    last_entry = entry;
     return 0;
   }
 
-  FOR_BLS_ENTRIES(e) {
-    rc = bls_cmp(entry, e);
+  entry->prev = last_entry;
+  last_entry->next = entry;
+  last_entry = entry;
 
-    if (!rc)
-      return GRUB_ERR_BAD_ARGUMENT;
-
-    if (rc == 1) {
-      grub_dprintf ("blscfg", "Add entry with id \"%s\"\n", entry->filename);
-      list_add_tail (e, entry);
-      if (e == entries) {
-	entries = entry;
-	entry->prev = NULL;
-      }
-      return 0;
+  return 0;
+}
+
+static void bls_free_entry(struct bls_entry *entry)
+{
+  int i;
+
+  for (i = 0; i < entry->nkeyvals; i++) {
+    grub_free ((char *)entry->keyvals[i]->key);
+    grub_free (entry->keyvals[i]->val);
+    grub_free (entry->keyvals[i]);
+  }
+  grub_free (entry->keyvals);
+  grub_free (entry->filename);
+  grub_free (entry->verbuf);
+  grub_free (entry);
+}
+
+/* Merge two lists sorted newest first.  On equal versions the entry
+ * from the first list wins, keeping the sort stable. */
+static struct bls_entry *bls_merge(struct bls_entry *e0, struct bls_entry *e1)
+{
+  struct bls_entry *head = NULL, **tail = &head;
+
+  while (e0 && e1) {
+    if (bls_cmp(e0, e1) >= 0) {
+      *tail = e0;
+      e0 = e0->next;
+    } else {
+      *tail = e1;
+      e1 = e1->next;
     }
-    last = e;
+    tail = &(*tail)->next;
   }
+  *tail = e0 ? e0 : e1;
 
-  if (last) {
-    grub_dprintf ("blscfg", "Add entry with id \"%s\"\n", entry->filename);
-    last->next = entry;
-    entry->prev = last;
+  return head;
+}
+
+static struct bls_entry *bls_sort_list(struct bls_entry *head)
+{
+  struct bls_entry *slow, *fast, *second;
+
+  if (!head || !head->next)
+    return head;
+
+  slow = head;
+  fast = head->next;
+  while (fast && fast->next) {
+    slow = slow->next;
+    fast = fast->next->next;
   }
+  second = slow->next;
+  slow->next = NULL;
 
-  return 0;
+  return bls_merge(bls_sort_list(head), bls_sort_list(second));
+}
+
+/* Sort all loaded entries newest first and drop entries that compare
+ * as the same version as one read earlier, as the insertion sort used
+ * to.  Entries already shown in the menu are always the earlier ones,
+ * so only never-registered duplicates get freed. */
+static void bls_sort_entries(void)
+{
+  struct bls_entry *e, *prev;
+
+  entries = bls_sort_list(entries);
+
+  prev = NULL;
+  e = entries;
+  while (e) {
+    struct bls_entry *next = e->next;
+
+    if (prev && !e->visible && bls_cmp(prev, e) == 0) {
+      grub_dprintf ("blscfg", "Drop duplicate entry with id \"%s\"\n",
+		    e->filename);
+      bls_free_entry(e);
+      prev->next = next;
+    } else {
+      e->prev = prev;
+      prev = e;
+    }
+    e = next;
+  }
+  last_entry = prev;
 }
 
 struct read_entry_info {
@@ -532,6 +586,9 @@ static int read_entry (
 
   entry->filename[n - 5] = '\0';
 
+  if (bls_make_key (entry))
+    goto finish;
+
   for (;;)
     {
       char *buf;
@@ -783,7 +840,7 @@ static void create_entry (struct bls_entry *entry)
   bool add_dt_prefix = false;
 
   grub_dprintf("blscfg", "%s got here\n", __func__);
-  clinux = bls_get_val (entry, "linux", NULL);
+  clinux = entry->clinux;
   if (!clinux)
     {
       grub_dprintf ("blscfg", "Skipping file %s with no 'linux' key.\n", entry->filename);
@@ -800,7 +857,7 @@ static void create_entry (struct bls_entry *entry)
   if (dotconf)
     dotconf[0] = '\0';
 
-  title = bls_get_val (entry, "title", NULL);
+  title = entry->title;
   options = expand_val (bls_get_val (entry, "options", NULL));
 
   if (!options)
@@ -1056,7 +1113,9 @@ bls_load_entries (const char *path)
       /*
        * read_entry() closes the file
        */
-      return read_entry(path, NULL, &rei);
+      r = read_entry(path, NULL, &rei);
+      bls_sort_entries();
+      return r;
     } else if (path[0] == '(') {
       devid = path + 1;
 
@@ -1098,6 +1157,7 @@ bls_load_entries (const char *path)
   info.dev = dev;
   info.fs = fs;
   find_entry(&info);
+  bls_sort_entries();
 
 finish:
   if (dev)
@@ -1118,7 +1178,7 @@ is_default_entry(const char *def_entry, struct bls_entry *entry, int idx)
   if (grub_strcmp(def_entry, entry->filename) == 0)
     return true;
 
-  title = bls_get_val(entry, "title", NULL);
+  title = entry->title;
 
   if (title && grub_strcmp(def_entry, title) == 0)
     return true;
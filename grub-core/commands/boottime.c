@@ -19,18 +19,95 @@
 #include <grub/dl.h>
 #include <grub/misc.h>
 #include <grub/command.h>
+#include <grub/env.h>
+#include <grub/disk.h>
 #include <grub/i18n.h>
 
 GRUB_MOD_LICENSE ("GPLv3+");
 
+struct profile_ctx
+{
+  char *p;
+  char *end;
+};
+
+static int
+profile_disk_hook (const struct grub_disk_cache_stats *stats, void *data)
+{
+  struct profile_ctx *ctx = data;
+
+  ctx->p += grub_snprintf (ctx->p, ctx->end - ctx->p, ";d=%s:%llu:%lu:%lu",
+			   stats->name ? stats->name : "?",
+			   stats->sectors_read << GRUB_DISK_SECTOR_BITS,
+			   stats->hits, stats->misses);
+  return 0;
+}
+
+/* Condense the trace into one line of printable key=value fields and
+   store it in the environment, so configurations can persist it with
+   save_env and an OS-side agent can harvest it from the environment
+   block.  Fields: v1 format tag, t= total milliseconds, n= number of
+   checkpoints, p= milliseconds between consecutive top-level
+   checkpoints, d= name:bytes read:cache hits:cache misses per disk.  */
+static grub_err_t
+boottime_export (const char *var)
+{
+  struct grub_boot_time *cur;
+  struct profile_ctx ctx;
+  char *buf;
+  grub_uint64_t start_time = 0, last_top = 0, end_time = 0;
+  unsigned n = 0;
+
+  buf = grub_malloc (1024);
+  if (!buf)
+    return grub_errno;
+  ctx.p = buf;
+  ctx.end = buf + 1024;
+
+  if (grub_boot_time_head)
+    start_time = last_top = grub_boot_time_head->tp;
+  for (cur = grub_boot_time_head; cur; cur = cur->next, n++)
+    end_time = cur->tp;
+
+  ctx.p += grub_snprintf (ctx.p, ctx.end - ctx.p, "v1;t=%llu;n=%u",
+			  (unsigned long long) (end_time - start_time), n);
+  for (cur = grub_boot_time_head; cur; cur = cur->next)
+    if (cur->level == 0)
+      {
+	ctx.p += grub_snprintf (ctx.p, ctx.end - ctx.p, ";p=%llu",
+				(unsigned long long) (cur->tp - last_top));
+	last_top = cur->tp;
+      }
+  grub_disk_cache_stats_iterate (profile_disk_hook, &ctx);
+
+  grub_env_set (var, buf);
+  grub_free (buf);
+  return grub_errno;
+}
+
 
 static grub_err_t
 grub_cmd_boottime (struct grub_command *cmd __attribute__ ((unused)),
-		   int argc __attribute__ ((unused)),
-		   char *argv[] __attribute__ ((unused)))
+		   int argc,
+		   char *argv[])
 {
   struct grub_boot_time *cur;
   grub_uint64_t last_time = 0, start_time = 0;
+  int tree = 0, raw = 0;
+
+  if (argc >= 1)
+    {
+      if (grub_strcmp (argv[0], "--tree") == 0)
+	tree = 1;
+      else if (grub_strcmp (argv[0], "--raw") == 0)
+	raw = 1;
+      else if (grub_strcmp (argv[0], "--export") == 0)
+	return boottime_export (argc >= 2 ? argv[1] : "boot_profile");
+      else
+	return grub_error (GRUB_ERR_BAD_ARGUMENT,
+			   N_("unrecognized option `%s'"), argv[0]);
+    }
+
   if (!grub_boot_time_head)
     {
       grub_puts_ (N_("No boot time statistics is available\n"));
@@ -43,9 +120,19 @@ grub_cmd_boottime (struct grub_command *cmd __attribute__ ((unused)),
       grub_uint32_t tmrel = cur->tp - last_time;
       last_time = cur->tp;
 
-      grub_printf ("%3d.%03ds %2d.%03ds %s:%d %s\n", 
-		   tmabs / 1000, tmabs % 1000, tmrel / 1000, tmrel % 1000, cur->file, cur->line,
-		   cur->msg);
+      if (raw)
+	{
+	  /* One record per line, tab-separated, for capture over serial.  */
+	  grub_printf ("%llu\t%d\t%s\t%d\t%s\n",
+		       (unsigned long long) cur->tp, cur->level,
+		       cur->file, cur->line, cur->msg);
+	  continue;
+	}
+
+      grub_printf ("%3d.%03ds %2d.%03ds %s:%d %*s%s\n",
+		   tmabs / 1000, tmabs % 1000, tmrel / 1000, tmrel % 1000,
+		   cur->file, cur->line,
+		   tree ? 2 * cur->level : 0, "", cur->msg);
     }
  return 0;
 }
@@ -56,7 +143,8 @@ GRUB_MOD_INIT(boottime)
 {
   cmd_boottime =
     grub_register_command ("boottime", grub_cmd_boottime,
-			   0, N_("Show boot time statistics."));
+			   N_("[--tree|--raw|--export [VARNAME]]"),
+			   N_("Show boot time statistics."));
 }
 
 GRUB_MOD_FINI(boottime)
@@ -0,0 +1,95 @@
+/* cachestat.c - Command to show disk cache statistics  */
+/*
+ *  GRUB  --  GRand Unified Bootloader
+ *  Copyright (C) 2013  Free Software Foundation, Inc.
+ *
+ *  GRUB is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GRUB is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GRUB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <grub/dl.h>
+#include <grub/disk.h>
+#include <grub/misc.h>
+#include <grub/command.h>
+#include <grub/i18n.h>
+
+GRUB_MOD_LICENSE ("GPLv3+");
+
+struct cachestat_totals
+{
+  unsigned long hits;
+  unsigned long misses;
+  unsigned occupancy;
+};
+
+static int
+print_disk_stats (const struct grub_disk_cache_stats *stats, void *data)
+{
+  struct cachestat_totals *totals = data;
+
+  grub_printf ("%-20s %10lu %10lu %10lu %10lu %6u\n",
+	       stats->name ? stats->name : "?",
+	       stats->hits, stats->misses, stats->evictions,
+	       stats->agglomerated, stats->occupancy);
+  totals->hits += stats->hits;
+  totals->misses += stats->misses;
+  totals->occupancy += stats->occupancy;
+  return 0;
+}
+
+static grub_err_t
+grub_cmd_cachestat (struct grub_command *cmd __attribute__ ((unused)),
+		    int argc, char *argv[])
+{
+  struct cachestat_totals totals;
+
+  if (argc >= 1)
+    {
+      if (grub_strcmp (argv[0], "--reset") == 0)
+	{
+	  grub_disk_cache_stats_reset ();
+	  return 0;
+	}
+      return grub_error (GRUB_ERR_BAD_ARGUMENT,
+			 N_("unrecognized option `%s'"), argv[0]);
+    }
+
+  grub_memset (&totals, 0, sizeof (totals));
+  grub_printf ("%-20s %10s %10s %10s %10s %6s\n",
+	       _("Device"), _("hits"), _("misses"), _("evicted"),
+	       _("agglom"), _("lines"));
+  grub_disk_cache_stats_iterate (print_disk_stats, &totals);
+  if (totals.hits + totals.misses)
+    grub_printf_ (N_("Total: %lu hits, %lu misses (%lu.%lu%% hit rate)\n"),
+		  totals.hits, totals.misses,
+		  totals.hits * 100 / (totals.hits + totals.misses),
+		  totals.hits * 1000 / (totals.hits + totals.misses) % 10);
+  grub_printf_ (N_("Cache lines in use: %u of %u\n"),
+		totals.occupancy, (unsigned) GRUB_DISK_CACHE_NUM);
+  return 0;
+}
+
+static grub_command_t cmd_cachestat;
+
+GRUB_MOD_INIT(cachestat)
+{
+  cmd_cachestat =
+    grub_register_command ("cachestat", grub_cmd_cachestat,
+			   N_("[--reset]"),
+			   N_("Show disk cache statistics."));
+}
+
+GRUB_MOD_FINI(cachestat)
+{
+  grub_unregister_command (cmd_cachestat);
+}
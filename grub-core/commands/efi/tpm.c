@@ -37,6 +37,15 @@ static grub_efi_guid_t cc_measurement_guid = GRUB_EFI_CC_MEASUREMENT_PROTOCOL_GU
 static grub_efi_handle_t *grub_tpm_handle;
 static grub_uint8_t grub_tpm_version;
 
+/* Measurements happen for every executed command and every loaded
+   file once the verifier is registered, so cache the protocol
+   interfaces instead of looking them up per event.  The handles never
+   change after boot services enumerated them.  */
+static grub_efi_tpm_protocol_t *grub_tpm1_protocol;
+static grub_efi_tpm2_protocol_t *grub_tpm2_protocol;
+static grub_efi_cc_protocol_t *grub_cc_protocol;
+static int grub_cc_protocol_checked;
+
 static grub_int8_t tpm1_present = -1;
 static grub_int8_t tpm2_present = -1;
 
@@ -163,8 +172,10 @@ grub_tpm1_log_event (grub_efi_handle_t tpm_handle, unsigned char *buf,
   grub_uint32_t algorithm;
   grub_uint32_t eventnum = 0;
 
-  tpm = grub_efi_open_protocol (tpm_handle, &tpm_guid,
-				GRUB_EFI_OPEN_PROTOCOL_GET_PROTOCOL);
+  if (!grub_tpm1_protocol)
+    grub_tpm1_protocol = grub_efi_open_protocol (tpm_handle, &tpm_guid,
+						 GRUB_EFI_OPEN_PROTOCOL_GET_PROTOCOL);
+  tpm = grub_tpm1_protocol;
 
   if (!grub_tpm1_present (tpm))
     return 0;
@@ -196,8 +207,10 @@ grub_tpm2_log_event (grub_efi_handle_t tpm_handle, unsigned char *buf,
   grub_efi_status_t status;
   grub_efi_tpm2_protocol_t *tpm;
 
-  tpm = grub_efi_open_protocol (tpm_handle, &tpm2_guid,
-				GRUB_EFI_OPEN_PROTOCOL_GET_PROTOCOL);
+  if (!grub_tpm2_protocol)
+    grub_tpm2_protocol = grub_efi_open_protocol (tpm_handle, &tpm2_guid,
+						 GRUB_EFI_OPEN_PROTOCOL_GET_PROTOCOL);
+  tpm = grub_tpm2_protocol;
 
   if (!grub_tpm2_present (tpm))
     return 0;
@@ -231,16 +244,33 @@ grub_cc_log_event (unsigned char *buf, grub_size_t size, grub_uint8_t pcr,
   grub_efi_status_t status;
   grub_efi_cc_protocol_t *cc;
   grub_efi_cc_mr_index_t mr;
+  static grub_efi_cc_mr_index_t mr_cache[32];
+  static grub_uint32_t mr_cache_valid;
 
-  cc = grub_efi_locate_protocol (&cc_measurement_guid, NULL);
+  if (!grub_cc_protocol_checked)
+    {
+      grub_cc_protocol = grub_efi_locate_protocol (&cc_measurement_guid, NULL);
+      grub_cc_protocol_checked = 1;
+    }
+  cc = grub_cc_protocol;
   if (cc == NULL)
     return;
 
-  status = efi_call_3 (cc->map_pcr_to_mr_index, cc, pcr, &mr);
-  if (status != GRUB_EFI_SUCCESS)
+  if (pcr < ARRAY_SIZE (mr_cache) && (mr_cache_valid & (1U << pcr)))
+    mr = mr_cache[pcr];
+  else
     {
-      grub_efi_log_event_status (status);
-      return;
+      status = efi_call_3 (cc->map_pcr_to_mr_index, cc, pcr, &mr);
+      if (status != GRUB_EFI_SUCCESS)
+	{
+	  grub_efi_log_event_status (status);
+	  return;
+	}
+      if (pcr < ARRAY_SIZE (mr_cache))
+	{
+	  mr_cache[pcr] = mr;
+	  mr_cache_valid |= 1U << pcr;
+	}
     }
 
   event = grub_zalloc (sizeof (grub_efi_cc_event_t) +
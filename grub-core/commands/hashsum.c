@@ -65,7 +65,9 @@ hash_file (grub_file_t file, const gcry_md_spec_t *hash, void *result)
 {
   void *context;
   grub_uint8_t *readbuf;
-#define BUF_SIZE 4096
+/* Read in big chunks: they let the disk layer agglomerate sectors and
+   keep the digest inner loop running over long runs.  */
+#define BUF_SIZE 0x10000
   readbuf = grub_malloc (BUF_SIZE);
   if (!readbuf)
     return grub_errno;
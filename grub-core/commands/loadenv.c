@@ -42,6 +42,26 @@ static const struct grub_arg_option options[] =
     {0, 0, 0, 0, 0, 0}
   };
 
+/* Return the file name to be used for the environment block: a copy of
+   FILENAME if given, else the default location under the prefix.  */
+static char *
+resolve_envblk_filename (const char *filename)
+{
+  const char *prefix;
+
+  if (filename)
+    return grub_strdup (filename);
+
+  prefix = grub_env_get ("prefix");
+  if (! prefix)
+    {
+      grub_error (GRUB_ERR_FILE_NOT_FOUND, N_("variable `%s' isn't set"), "prefix");
+      return 0;
+    }
+
+  return grub_xasprintf ("%s/" GRUB_ENVBLK_DEFCFG, prefix);
+}
+
 /* Opens 'filename' with compression filters disabled. Optionally disables the
    PUBKEY filter (that insists upon properly signed files) as well.  PUBKEY
    filter is restored before the function returns. */
@@ -49,36 +69,43 @@ static grub_file_t
 open_envblk_file (char *filename,
 		  enum grub_file_type type)
 {
-  grub_file_t file;
-  char *buf = 0;
-
-  if (! filename)
-    {
-      const char *prefix;
-      int len;
+  return grub_file_open (filename, type);
+}
 
-      prefix = grub_env_get ("prefix");
-      if (! prefix)
-        {
-          grub_error (GRUB_ERR_FILE_NOT_FOUND, N_("variable `%s' isn't set"), "prefix");
-          return 0;
-        }
+/* Parsed copy of the environment block accessed last, so that the
+   several load_env/save_env invocations a boot-counting setup makes per
+   boot do not each remount the filesystem and reparse the block.  The
+   block cannot change underneath us within one session: these commands
+   are its only writers.  */
+struct envblk_cache
+{
+  char *filename;
+  grub_envblk_t envblk;
+  /* For direct writes, populated on the first save_env.  */
+  char *devname;
+  grub_disk_addr_t part_start;
+  struct blocklist *blocklists;
+};
 
-      len = grub_strlen (prefix);
-      buf = grub_malloc (len + 1 + sizeof (GRUB_ENVBLK_DEFCFG));
-      if (! buf)
-        return 0;
-      filename = buf;
+static struct envblk_cache env_cache;
 
-      grub_strcpy (filename, prefix);
-      filename[len] = '/';
-      grub_strcpy (filename + len + 1, GRUB_ENVBLK_DEFCFG);
-    }
+static void free_blocklists (struct blocklist *p);
 
-  file = grub_file_open (filename, type);
+static void
+env_cache_clear (void)
+{
+  grub_free (env_cache.filename);
+  if (env_cache.envblk)
+    grub_envblk_close (env_cache.envblk);
+  grub_free (env_cache.devname);
+  free_blocklists (env_cache.blocklists);
+  grub_memset (&env_cache, 0, sizeof (env_cache));
+}
 
-  grub_free (buf);
-  return file;
+static int
+env_cache_matches (const char *filename)
+{
+  return env_cache.filename && grub_strcmp (env_cache.filename, filename) == 0;
 }
 
 static grub_err_t
@@ -86,19 +113,35 @@ grub_cmd_load_env (grub_extcmd_context_t ctxt, int argc, char **args)
 {
   struct grub_arg_list *state = ctxt->state;
   grub_file_t file;
-  grub_envblk_t envblk;
+  grub_envblk_t envblk = 0;
+  char *filename;
   grub_env_whitelist_t whitelist;
 
   whitelist.len = argc;
   whitelist.list = args;
 
-  /* state[0] is the -f flag; state[1] is the --skip-sig flag */
-  file = open_envblk_file ((state[0].set) ? state[0].arg : 0,
+  filename = resolve_envblk_filename ((state[0].set) ? state[0].arg : 0);
+  if (! filename)
+    return grub_errno;
+
+  if (env_cache_matches (filename))
+    {
+      grub_free (filename);
+      grub_envblk_iterate (env_cache.envblk, argc > 0 ? &whitelist : 0,
+			   set_var);
+      return grub_errno;
+    }
+
+  /* state[1] is the --skip-sig flag */
+  file = open_envblk_file (filename,
 			   GRUB_FILE_TYPE_LOADENV
 			   | (state[1].set
 			      ? GRUB_FILE_TYPE_SKIP_SIGNATURE : GRUB_FILE_TYPE_NONE));
   if (! file)
-    return grub_errno;
+    {
+      grub_free (filename);
+      return grub_errno;
+    }
 
   envblk = read_envblk_file (file);
   if (! envblk)
@@ -106,9 +149,16 @@ grub_cmd_load_env (grub_extcmd_context_t ctxt, int argc, char **args)
 
   /* argc > 0 indicates caller provided a whitelist of variables to read. */
   grub_envblk_iterate (envblk, argc > 0 ? &whitelist : 0, set_var);
-  grub_envblk_close (envblk);
+
+  /* Keep the parsed block for subsequent invocations.  */
+  env_cache_clear ();
+  env_cache.filename = filename;
+  env_cache.envblk = envblk;
+  filename = 0;
+  envblk = 0;
 
  fail:
+  grub_free (filename);
   grub_file_close (file);
   return grub_errno;
 }
@@ -130,11 +180,24 @@ grub_cmd_list_env (grub_extcmd_context_t ctxt,
   struct grub_arg_list *state = ctxt->state;
   grub_file_t file;
   grub_envblk_t envblk;
+  char *filename;
 
-  file = open_envblk_file ((state[0].set) ? state[0].arg : 0,
+  filename = resolve_envblk_filename ((state[0].set) ? state[0].arg : 0);
+  if (! filename)
+    return grub_errno;
+
+  if (env_cache_matches (filename))
+    {
+      grub_free (filename);
+      grub_envblk_iterate (env_cache.envblk, NULL, print_var);
+      return grub_errno;
+    }
+
+  file = open_envblk_file (filename,
 			   GRUB_FILE_TYPE_LOADENV
 			   | (state[1].set
 			      ? GRUB_FILE_TYPE_SKIP_SIGNATURE : GRUB_FILE_TYPE_NONE));
+  grub_free (filename);
   if (! file)
     return grub_errno;
 
@@ -249,26 +312,31 @@ check_blocklists (grub_envblk_t envblk, struct blocklist *blocklists,
 
 static int
 write_blocklists (grub_envblk_t envblk, struct blocklist *blocklists,
-                  grub_file_t file)
+                  grub_disk_t disk, grub_disk_addr_t part_start)
 {
   char *buf;
-  grub_disk_t disk;
-  grub_disk_addr_t part_start;
   struct blocklist *p;
   grub_size_t index;
 
   buf = grub_envblk_buffer (envblk);
-  disk = file->device->disk;
-  part_start = grub_partition_get_start (disk->partition);
 
+  /* Blocklist pieces are small and usually land in the same device
+     sector; combining them saves all but one program cycle.  */
+  grub_disk_write_begin (disk);
   index = 0;
   for (p = blocklists; p; index += p->length, p = p->next)
     {
       if (grub_disk_write (disk, p->sector - part_start,
                            p->offset, p->length, buf + index))
-        return 0;
+        {
+          grub_disk_write_flush (disk);
+          return 0;
+        }
     }
 
+  if (grub_disk_write_flush (disk))
+    return 0;
+
   return 1;
 }
 
@@ -303,12 +371,40 @@ save_env_read_hook (grub_disk_addr_t sector, unsigned offset, unsigned length,
     ctx->head = block;
 }
 
+/* Apply the values of the named variables to ENVBLK.  */
+static grub_err_t
+update_envblk (grub_envblk_t envblk, int argc, char **args)
+{
+  while (argc)
+    {
+      const char *value;
+
+      value = grub_env_get (args[0]);
+      if (value)
+        {
+          if (! grub_envblk_set (envblk, args[0], value))
+            return grub_error (GRUB_ERR_BAD_ARGUMENT,
+                               "environment block too small");
+        }
+      else
+	grub_envblk_delete (envblk, args[0]);
+
+      argc--;
+      args++;
+    }
+
+  return GRUB_ERR_NONE;
+}
+
 static grub_err_t
 grub_cmd_save_env (grub_extcmd_context_t ctxt, int argc, char **args)
 {
   struct grub_arg_list *state = ctxt->state;
   grub_file_t file;
-  grub_envblk_t envblk;
+  grub_envblk_t envblk = 0;
+  grub_disk_t disk;
+  grub_disk_addr_t part_start;
+  char *filename;
   struct grub_cmd_save_env_ctx ctx = {
     .head = 0,
     .tail = 0
@@ -317,14 +413,48 @@ grub_cmd_save_env (grub_extcmd_context_t ctxt, int argc, char **args)
   if (! argc)
     return grub_error (GRUB_ERR_BAD_ARGUMENT, "no variable is specified");
 
-  file = open_envblk_file ((state[0].set) ? state[0].arg : 0,
-			   GRUB_FILE_TYPE_SAVEENV
+  filename = resolve_envblk_filename ((state[0].set) ? state[0].arg : 0);
+  if (! filename)
+    return grub_errno;
+
+  /* Write through the cached block: no filesystem mount, no reparse,
+     just the sector writes themselves.  */
+  if (env_cache_matches (filename) && env_cache.blocklists)
+    {
+      grub_free (filename);
+
+      disk = grub_disk_open (env_cache.devname);
+      if (! disk)
+	{
+	  env_cache_clear ();
+	  return grub_errno;
+	}
+
+      if (update_envblk (env_cache.envblk, argc, args) != GRUB_ERR_NONE
+	  || ! write_blocklists (env_cache.envblk, env_cache.blocklists,
+				 disk, env_cache.part_start))
+	{
+	  grub_disk_close (disk);
+	  /* The cached copy may now disagree with the disk.  */
+	  env_cache_clear ();
+	  return grub_errno;
+	}
+
+      grub_disk_close (disk);
+      return GRUB_ERR_NONE;
+    }
+
+  file = open_envblk_file (filename, GRUB_FILE_TYPE_SAVEENV
 			   | GRUB_FILE_TYPE_SKIP_SIGNATURE);
   if (! file)
-    return grub_errno;
+    {
+      grub_free (filename);
+      return grub_errno;
+    }
 
   if (! file->device->disk)
     {
+      grub_free (filename);
       grub_file_close (file);
       return grub_error (GRUB_ERR_BAD_DEVICE, "disk device required");
     }
@@ -339,29 +469,45 @@ grub_cmd_save_env (grub_extcmd_context_t ctxt, int argc, char **args)
   if (check_blocklists (envblk, ctx.head, file))
     goto fail;
 
-  while (argc)
-    {
-      const char *value;
+  if (update_envblk (envblk, argc, args) != GRUB_ERR_NONE)
+    goto fail;
 
-      value = grub_env_get (args[0]);
-      if (value)
-        {
-          if (! grub_envblk_set (envblk, args[0], value))
-            {
-              grub_error (GRUB_ERR_BAD_ARGUMENT, "environment block too small");
-              goto fail;
-            }
-        }
-      else
-	grub_envblk_delete (envblk, args[0]);
+  disk = file->device->disk;
+  part_start = grub_partition_get_start (disk->partition);
 
-      argc--;
-      args++;
-    }
+  if (! write_blocklists (envblk, ctx.head, disk, part_start))
+    goto fail;
 
-  write_blocklists (envblk, ctx.head, file);
+  /* Keep the parsed block and its location for subsequent saves.  */
+  env_cache_clear ();
+  if (disk->partition)
+    {
+      char *partname = grub_partition_get_name (disk->partition);
+      if (partname)
+	{
+	  env_cache.devname = grub_xasprintf ("%s,%s", disk->name, partname);
+	  grub_free (partname);
+	}
+    }
+  else
+    env_cache.devname = grub_strdup (disk->name);
+  if (env_cache.devname)
+    {
+      env_cache.filename = filename;
+      env_cache.envblk = envblk;
+      env_cache.part_start = part_start;
+      env_cache.blocklists = ctx.head;
+      filename = 0;
+      envblk = 0;
+      ctx.head = 0;
+    }
+  else
+    /* Caching is optional; don't let an allocation failure here fail
+       the save.  */
+    grub_errno = GRUB_ERR_NONE;
 
  fail:
+  grub_free (filename);
   if (envblk)
     grub_envblk_close (envblk);
   free_blocklists (ctx.head);
@@ -391,6 +537,7 @@ GRUB_MOD_INIT(loadenv)
 
 GRUB_MOD_FINI(loadenv)
 {
+  env_cache_clear ();
   grub_unregister_extcmd (cmd_load);
   grub_unregister_extcmd (cmd_list);
   grub_unregister_extcmd (cmd_save);
@@ -116,35 +116,46 @@ print_files_long (const char *filename, const struct grub_dirhook_info *info,
 
   if (! info->dir)
     {
-      grub_file_t file;
-      char *pathname;
+      grub_off_t size;
 
-      if (ctx->dirname[grub_strlen (ctx->dirname) - 1] == '/')
-	pathname = grub_xasprintf ("%s%s", ctx->dirname, filename);
+      if (info->sizeset)
+	size = info->size;
       else
-	pathname = grub_xasprintf ("%s/%s", ctx->dirname, filename);
+	{
+	  /* The filesystem didn't provide the size with the directory
+	     entry; fall back to opening the file.  */
+	  grub_file_t file;
+	  char *pathname;
 
-      if (!pathname)
-	return 1;
+	  if (ctx->dirname[grub_strlen (ctx->dirname) - 1] == '/')
+	    pathname = grub_xasprintf ("%s%s", ctx->dirname, filename);
+	  else
+	    pathname = grub_xasprintf ("%s/%s", ctx->dirname, filename);
 
-      /* XXX: For ext2fs symlinks are detected as files while they
-	 should be reported as directories.  */
-      file = grub_file_open (pathname, GRUB_FILE_TYPE_GET_SIZE
-			     | GRUB_FILE_TYPE_NO_DECOMPRESS);
-      if (! file)
-	{
-	  grub_errno = 0;
+	  if (!pathname)
+	    return 1;
+
+	  /* XXX: For ext2fs symlinks are detected as files while they
+	     should be reported as directories.  */
+	  file = grub_file_open (pathname, GRUB_FILE_TYPE_GET_SIZE
+				 | GRUB_FILE_TYPE_NO_DECOMPRESS);
+	  if (! file)
+	    {
+	      grub_errno = 0;
+	      grub_free (pathname);
+	      return 0;
+	    }
+
+	  size = file->size;
+	  grub_file_close (file);
 	  grub_free (pathname);
-	  return 0;
 	}
 
       if (! ctx->human)
-	grub_printf ("%-12llu", (unsigned long long) file->size);
+	grub_printf ("%-12llu", (unsigned long long) size);
       else
-	grub_printf ("%-12s", grub_get_human_size (file->size,
+	grub_printf ("%-12s", grub_get_human_size (size,
 						   GRUB_HUMAN_SIZE_SHORT));
-      grub_file_close (file);
-      grub_free (pathname);
     }
   else
     grub_printf ("%-12s", _("DIR"));
@@ -0,0 +1,142 @@
+/* modbundle.c - load a pre-packed bundle of modules in one read */
+/*
+ *  GRUB  --  GRand Unified Bootloader
+ *  Copyright (C) 2026  Free Software Foundation, Inc.
+ *
+ *  GRUB is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GRUB is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GRUB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <grub/dl.h>
+#include <grub/file.h>
+#include <grub/misc.h>
+#include <grub/mm.h>
+#include <grub/command.h>
+#include <grub/modbundle.h>
+#include <grub/i18n.h>
+
+GRUB_MOD_LICENSE ("GPLv3+");
+
+/*
+ * Load all modules from a bundle created by grub-mkmodbundle(1).  The
+ * whole bundle is fetched with a single read, which on netboot and
+ * other high-latency media is far cheaper than one open/read round
+ * trip per module; the modules themselves go through the normal
+ * grub_dl_load_core linking.  Modules that are already loaded are
+ * skipped.
+ */
+static grub_err_t
+grub_cmd_modbundle (grub_command_t cmd __attribute__ ((unused)),
+		    int argc, char **args)
+{
+  grub_file_t file;
+  grub_ssize_t size;
+  grub_uint8_t *buf = NULL, *p;
+  struct grub_modbundle_header *head;
+  grub_uint32_t nmods, i;
+
+  if (argc != 1)
+    return grub_error (GRUB_ERR_BAD_ARGUMENT, N_("filename expected"));
+
+  file = grub_file_open (args[0], GRUB_FILE_TYPE_GRUB_MODULE);
+  if (! file)
+    return grub_errno;
+
+  size = grub_file_size (file);
+  if (size < (grub_ssize_t) sizeof (*head))
+    goto bad;
+
+  buf = grub_malloc (size);
+  if (! buf)
+    {
+      grub_file_close (file);
+      return grub_errno;
+    }
+
+  if (grub_file_read (file, buf, size) != size)
+    {
+      if (!grub_errno)
+	grub_error (GRUB_ERR_BAD_FILE_TYPE, N_("premature end of file %s"),
+		    args[0]);
+      grub_free (buf);
+      grub_file_close (file);
+      return grub_errno;
+    }
+
+  grub_file_close (file);
+  file = NULL;
+
+  head = (struct grub_modbundle_header *) buf;
+  if (grub_memcmp (head->magic, GRUB_MODBUNDLE_MAGIC,
+		   GRUB_MODBUNDLE_MAGIC_SIZE) != 0)
+    goto bad;
+
+  nmods = grub_le_to_cpu32 (head->nmods);
+  p = buf + sizeof (*head);
+
+  for (i = 0; i < nmods; i++)
+    {
+      struct grub_modbundle_entry *entry;
+      grub_uint32_t namelen, modlen;
+      char *name;
+      grub_uint8_t *mod;
+      grub_dl_t dlmod;
+
+      if (p + sizeof (*entry) > buf + size)
+	goto bad;
+      entry = (struct grub_modbundle_entry *) p;
+      namelen = grub_le_to_cpu32 (entry->namelen);
+      modlen = grub_le_to_cpu32 (entry->modlen);
+
+      name = (char *) (p + sizeof (*entry));
+      mod = (grub_uint8_t *) name + ALIGN_UP (namelen, GRUB_MODBUNDLE_ALIGN);
+      p = mod + ALIGN_UP (modlen, GRUB_MODBUNDLE_ALIGN);
+      if (namelen == 0 || p > buf + size || name[namelen - 1] != '\0')
+	goto bad;
+
+      if (grub_dl_get (name))
+	continue;
+
+      dlmod = grub_dl_load_core_noinit (mod, modlen);
+      if (! dlmod)
+	{
+	  grub_free (buf);
+	  return grub_errno;
+	}
+      grub_dl_init (dlmod);
+      dlmod->ref_count--;
+    }
+
+  grub_free (buf);
+  return GRUB_ERR_NONE;
+
+ bad:
+  grub_free (buf);
+  if (file)
+    grub_file_close (file);
+  return grub_error (GRUB_ERR_BAD_FILE_TYPE,
+		     N_("file `%s' is not a module bundle"), args[0]);
+}
+
+static grub_command_t cmd;
+
+GRUB_MOD_INIT(modbundle)
+{
+  cmd = grub_register_command ("modbundle", grub_cmd_modbundle, N_("FILE"),
+			       N_("Load all modules from a module bundle."));
+}
+
+GRUB_MOD_FINI(modbundle)
+{
+  grub_unregister_command (cmd);
+}
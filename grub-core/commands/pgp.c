@@ -784,6 +784,14 @@ grub_cmd_distrust (grub_command_t cmd  __attribute__ ((unused)),
   return grub_error (GRUB_ERR_BAD_SIGNATURE, N_("public key %08x not found"), keyid);
 }
 
+/* Verifying several artifacts against the same explicit key file is
+   common in signed netboot flows; keep the most recently loaded key
+   parsed across invocations instead of re-reading and re-parsing it
+   for every file.  Keys added with the trust command are parsed once
+   into the trust list anyway.  */
+static char *cached_pk_name;
+static struct grub_public_key *cached_pk;
+
 static grub_err_t
 grub_cmd_verify_signature (grub_extcmd_context_t ctxt,
 			   int argc, char **args)
@@ -791,6 +799,7 @@ grub_cmd_verify_signature (grub_extcmd_context_t ctxt,
   grub_file_t f = NULL;
   grub_err_t err = GRUB_ERR_NONE;
   struct grub_public_key *pk = NULL;
+  int pk_cached = 0;
 
   grub_dprintf ("crypt", "alive\n");
 
@@ -799,9 +808,17 @@ grub_cmd_verify_signature (grub_extcmd_context_t ctxt,
 
   grub_dprintf ("crypt", "alive\n");
 
-  if (argc > 2)
+  if (argc > 2 && cached_pk && cached_pk_name
+      && grub_strcmp (cached_pk_name, args[2]) == 0)
+    {
+      pk = cached_pk;
+      pk_cached = 1;
+    }
+  else if (argc > 2)
     {
       grub_file_t pkf;
+      char *name;
+
       pkf = grub_file_open (args[2],
 			    GRUB_FILE_TYPE_PUBLIC_KEY
 			    | GRUB_FILE_TYPE_NO_DECOMPRESS
@@ -817,6 +834,19 @@ grub_cmd_verify_signature (grub_extcmd_context_t ctxt,
 	  return grub_errno;
 	}
       grub_file_close (pkf);
+
+      name = grub_strdup (args[2]);
+      if (name)
+	{
+	  free_pk (cached_pk);
+	  grub_free (cached_pk_name);
+	  cached_pk = pk;
+	  cached_pk_name = name;
+	  pk_cached = 1;
+	}
+      else
+	/* The cache is best-effort; verify with the key as loaded.  */
+	grub_errno = GRUB_ERR_NONE;
     }
 
   f = grub_file_open (args[0], GRUB_FILE_TYPE_VERIFY_SIGNATURE);
@@ -830,7 +860,7 @@ grub_cmd_verify_signature (grub_extcmd_context_t ctxt,
  fail:
   if (f)
     grub_file_close (f);
-  if (pk)
+  if (pk && !pk_cached)
     free_pk (pk);
   return err;
 }
@@ -982,6 +1012,8 @@ GRUB_MOD_INIT(pgp)
 
 GRUB_MOD_FINI(pgp)
 {
+  free_pk (cached_pk);
+  grub_free (cached_pk_name);
   grub_verifier_unregister (&grub_pubkey_verifier);
   grub_unregister_extcmd (cmd);
   grub_unregister_extcmd (cmd_trust);
@@ -29,6 +29,97 @@
 
 GRUB_MOD_LICENSE ("GPLv3+");
 
+/* Boot scripts often invoke `regexp' many times with the same pattern
+   against different strings; keep the last few compiled programs around
+   so only the first use of a pattern pays for regcomp.  */
+struct regexp_cache_entry
+{
+  struct regexp_cache_entry *next;
+  char *pattern;
+  regex_t regex;
+};
+
+#define REGEXP_CACHE_MAX 4
+
+static struct regexp_cache_entry *regexp_cache;
+static int regexp_cache_count;
+
+static regex_t *
+regexp_cache_lookup (const char *pattern)
+{
+  struct regexp_cache_entry *ent, **link;
+
+  for (link = &regexp_cache; (ent = *link); link = &ent->next)
+    if (grub_strcmp (ent->pattern, pattern) == 0)
+      {
+	/* Move to the front so frequently used patterns stay cached.  */
+	*link = ent->next;
+	ent->next = regexp_cache;
+	regexp_cache = ent;
+	return &ent->regex;
+      }
+
+  return 0;
+}
+
+/* Take ownership of *REGEX on success.  Returns the cached copy, or 0 if
+   out of memory, in which case *REGEX is left with the caller.  */
+static regex_t *
+regexp_cache_insert (const char *pattern, const regex_t *regex)
+{
+  struct regexp_cache_entry *ent;
+
+  ent = grub_malloc (sizeof (*ent));
+  if (! ent)
+    {
+      grub_errno = GRUB_ERR_NONE;
+      return 0;
+    }
+  ent->pattern = grub_strdup (pattern);
+  if (! ent->pattern)
+    {
+      grub_free (ent);
+      grub_errno = GRUB_ERR_NONE;
+      return 0;
+    }
+
+  ent->regex = *regex;
+  ent->next = regexp_cache;
+  regexp_cache = ent;
+
+  if (++regexp_cache_count > REGEXP_CACHE_MAX)
+    {
+      struct regexp_cache_entry **link;
+
+      for (link = &regexp_cache; (*link)->next; link = &(*link)->next)
+	;
+      ent = *link;
+      *link = 0;
+      regfree (&ent->regex);
+      grub_free (ent->pattern);
+      grub_free (ent);
+      regexp_cache_count--;
+    }
+
+  return &regexp_cache->regex;
+}
+
+static void
+regexp_cache_flush (void)
+{
+  struct regexp_cache_entry *ent, *next;
+
+  for (ent = regexp_cache; ent; ent = next)
+    {
+      next = ent->next;
+      regfree (&ent->regex);
+      grub_free (ent->pattern);
+      grub_free (ent);
+    }
+  regexp_cache = 0;
+  regexp_cache_count = 0;
+}
+
 static const struct grub_arg_option options[] =
   {
     { "set", 's', GRUB_ARG_OPTION_REPEATABLE,
@@ -102,7 +193,9 @@ set_matches (char **varnames, char *str, grub_size_t nmatches,
 static grub_err_t
 grub_cmd_regexp (grub_extcmd_context_t ctxt, int argc, char **args)
 {
-  regex_t regex;
+  regex_t uncached;
+  regex_t *regex;
+  int cached = 0;
   int ret;
   grub_size_t s;
   char *comperr;
@@ -112,36 +205,57 @@ grub_cmd_regexp (grub_extcmd_context_t ctxt, int argc, char **args)
   if (argc != 2)
     return grub_error (GRUB_ERR_BAD_ARGUMENT, N_("two arguments expected"));
 
-  ret = regcomp (&regex, args[0], REG_EXTENDED);
-  if (ret)
-    goto fail;
+  regex = regexp_cache_lookup (args[0]);
+  if (regex)
+    cached = 1;
+  else
+    {
+      ret = regcomp (&uncached, args[0], REG_EXTENDED);
+      if (ret)
+	{
+	  regex = &uncached;
+	  goto fail;
+	}
+      /* Only successful compiles are worth remembering.  */
+      regex = regexp_cache_insert (args[0], &uncached);
+      if (regex)
+	cached = 1;
+      else
+	regex = &uncached;
+    }
 
-  matches = grub_calloc (regex.re_nsub + 1, sizeof (*matches));
+  matches = grub_calloc (regex->re_nsub + 1, sizeof (*matches));
   if (! matches)
-    goto fail;
+    {
+      ret = 0;
+      goto fail;
+    }
 
-  ret = regexec (&regex, args[1], regex.re_nsub + 1, matches, 0);
+  ret = regexec (regex, args[1], regex->re_nsub + 1, matches, 0);
   if (!ret)
     {
       err = set_matches (ctxt->state[0].args, args[1],
-			 regex.re_nsub + 1, matches);
-      regfree (&regex);
+			 regex->re_nsub + 1, matches);
+      if (! cached)
+	regfree (regex);
       grub_free (matches);
       return err;
     }
 
  fail:
   grub_free (matches);
-  s = regerror (ret, &regex, 0, 0);
+  s = regerror (ret, regex, 0, 0);
   comperr = grub_malloc (s);
   if (!comperr)
     {
-      regfree (&regex);
+      if (! cached)
+	regfree (regex);
       return grub_errno;
     }
-  regerror (ret, &regex, comperr, s);
+  regerror (ret, regex, comperr, s);
   err = grub_error (GRUB_ERR_TEST_FAILURE, "%s", comperr);
-  regfree (&regex);
+  if (! cached)
+    regfree (regex);
   grub_free (comperr);
   return err;
 }
@@ -163,6 +277,8 @@ GRUB_MOD_INIT(regexp)
 
 GRUB_MOD_FINI(regexp)
 {
+  regexp_cache_flush ();
+  grub_wildcard_regex_cache_flush ();
   grub_unregister_extcmd (cmd);
   grub_wildcard_translator = 0;
 }
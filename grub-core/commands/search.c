@@ -42,25 +42,208 @@ struct cache_entry
 
 static struct cache_entry *cache;
 
+/*
+ * The key->device cache above can be carried across boots through the
+ * environment block: entries are mirrored into an environment variable
+ * as `key=device;key=device', so a config doing
+ *
+ *   load_env search_cache_fs_uuid
+ *   search --fs-uuid --set=root ...
+ *   save_env search_cache_fs_uuid
+ *
+ * probes only the remembered device on stable hardware.  Cached hits
+ * are verified before use and outdated entries fall back to the full
+ * scan, so a stale mapping costs one extra probe, never a wrong root.
+ */
+#ifdef DO_SEARCH_FILE
+#define SEARCH_CACHE_VAR "search_cache_file"
+#elif defined (DO_SEARCH_FS_UUID)
+#define SEARCH_CACHE_VAR "search_cache_fs_uuid"
+#else
+#define SEARCH_CACHE_VAR "search_cache_label"
+#endif
+
+static int cache_loaded;
+
+static void
+cache_load (void)
+{
+  const char *val;
+  char *dup, *p, *next;
+
+  cache_loaded = 1;
+  val = grub_env_get (SEARCH_CACHE_VAR);
+  if (!val)
+    return;
+  dup = grub_strdup (val);
+  if (!dup)
+    {
+      grub_errno = GRUB_ERR_NONE;
+      return;
+    }
+  for (p = dup; p && *p; p = next)
+    {
+      char *eq;
+      struct cache_entry *ent;
+
+      next = grub_strchr (p, ';');
+      if (next)
+	*next++ = '\0';
+      eq = grub_strchr (p, '=');
+      if (!eq || eq == p || !eq[1])
+	continue;
+      *eq = '\0';
+      ent = grub_malloc (sizeof (*ent));
+      if (!ent)
+	break;
+      ent->key = grub_strdup (p);
+      ent->value = grub_strdup (eq + 1);
+      if (!ent->key || !ent->value)
+	{
+	  grub_free (ent->key);
+	  grub_free (ent->value);
+	  grub_free (ent);
+	  break;
+	}
+      ent->next = cache;
+      cache = ent;
+    }
+  grub_free (dup);
+  grub_errno = GRUB_ERR_NONE;
+}
+
+static void
+cache_store (void)
+{
+  struct cache_entry *ent;
+  grub_size_t len = 1;
+  char *buf, *p;
+
+  for (ent = cache; ent; ent = ent->next)
+    len += grub_strlen (ent->key) + grub_strlen (ent->value) + 2;
+  buf = grub_malloc (len);
+  if (!buf)
+    {
+      grub_errno = GRUB_ERR_NONE;
+      return;
+    }
+  p = buf;
+  for (ent = cache; ent; ent = ent->next)
+    {
+      /* The separators must not occur inside an entry.  */
+      if (grub_strchr (ent->key, '=') || grub_strchr (ent->key, ';')
+	  || grub_strchr (ent->value, ';'))
+	continue;
+      if (p != buf)
+	*p++ = ';';
+      p = grub_stpcpy (p, ent->key);
+      *p++ = '=';
+      p = grub_stpcpy (p, ent->value);
+    }
+  *p = '\0';
+  grub_env_set (SEARCH_CACHE_VAR, buf);
+  grub_free (buf);
+  grub_errno = GRUB_ERR_NONE;
+}
+
+struct found_dev
+{
+  struct found_dev *next;
+  char *name;
+};
+
 /* Context for FUNC_NAME.  */
 struct search_ctx
 {
-  const char *key;
-  const char *var;
+  /* The keys to look for and the variables to store the results in.
+     vars may be NULL, and so may single entries; targets without a
+     variable print every match instead of stopping at the first.  */
+  unsigned ntargets;
+  const char * const *keys;
+  const char * const *vars;
+  /* Per-target match counts.  */
+  int *counts;
   enum search_flags flags;
   char **hints;
   unsigned nhints;
   int count;
   int is_cache;
+  /* Device names seen by a full scan, replayed by the autoload retry
+     so the disks are not all opened and probed a second time.  */
+  struct found_dev *devs;
+  struct found_dev **devs_tail;
+  int devs_complete;
 };
 
+#ifdef DO_SEARCH_FS_UUID
+#define compare_fn grub_strcasecmp
+#else
+#define compare_fn grub_strcmp
+#endif
+
+/* Nonzero once target T needs no further probing.  */
+static int
+target_done (struct search_ctx *ctx, unsigned t)
+{
+  return ctx->counts[t] != 0 && ctx->vars && ctx->vars[t];
+}
+
+/* Nonzero when iteration can stop altogether.  */
+static int
+all_targets_done (struct search_ctx *ctx)
+{
+  unsigned t;
+
+  for (t = 0; t < ctx->ntargets; t++)
+    if (!target_done (ctx, t))
+      return 0;
+  return 1;
+}
+
+/* Account for device NAME matching target T.  */
+static void
+record_match (struct search_ctx *ctx, unsigned t, const char *name)
+{
+  if (!ctx->is_cache && ctx->counts[t] == 0)
+    {
+      struct cache_entry *cache_ent;
+      cache_ent = grub_malloc (sizeof (*cache_ent));
+      if (cache_ent)
+	{
+	  cache_ent->key = grub_strdup (ctx->keys[t]);
+	  cache_ent->value = grub_strdup (name);
+	  if (cache_ent->value && cache_ent->key)
+	    {
+	      cache_ent->next = cache;
+	      cache = cache_ent;
+	      cache_store ();
+	    }
+	  else
+	    {
+	      grub_free (cache_ent->value);
+	      grub_free (cache_ent->key);
+	      grub_free (cache_ent);
+	      grub_errno = GRUB_ERR_NONE;
+	    }
+	}
+      else
+	grub_errno = GRUB_ERR_NONE;
+    }
+
+  ctx->counts[t]++;
+  ctx->count++;
+  if (ctx->vars && ctx->vars[t])
+    grub_env_set (ctx->vars[t], name);
+  else
+    grub_printf (" %s", name);
+}
+
 /* Helper for FUNC_NAME.  */
 static int
 iterate_device (const char *name, void *data)
 {
   struct search_ctx *ctx = data;
   const char *root_dev;
-  int found = 0;
 
   /* Skip floppy drives when requested.  */
   if (ctx->flags & SEARCH_FLAGS_NO_FLOPPY &&
@@ -93,29 +276,32 @@ iterate_device (const char *name, void *data)
        name[2] != root_dev[2]))
     return 0;
 
-#ifdef DO_SEARCH_FS_UUID
-#define compare_fn grub_strcasecmp
-#else
-#define compare_fn grub_strcmp
-#endif
-
 #ifdef DO_SEARCH_FILE
     {
-      char *buf;
-      grub_file_t file;
-
-      buf = grub_xasprintf ("(%s)%s", name, ctx->key);
-      if (! buf)
-	return 1;
+      unsigned t;
 
-      file = grub_file_open (buf, GRUB_FILE_TYPE_FS_SEARCH
-			     | GRUB_FILE_TYPE_NO_DECOMPRESS);
-      if (file)
+      for (t = 0; t < ctx->ntargets; t++)
 	{
-	  found = 1;
-	  grub_file_close (file);
+	  char *buf;
+	  grub_file_t file;
+
+	  if (target_done (ctx, t))
+	    continue;
+
+	  buf = grub_xasprintf ("(%s)%s", name, ctx->keys[t]);
+	  if (! buf)
+	    return 1;
+
+	  file = grub_file_open (buf, GRUB_FILE_TYPE_FS_SEARCH
+				 | GRUB_FILE_TYPE_NO_DECOMPRESS);
+	  if (file)
+	    {
+	      record_match (ctx, t, name);
+	      grub_file_close (file);
+	    }
+	  grub_free (buf);
+	  grub_errno = GRUB_ERR_NONE;
 	}
-      grub_free (buf);
     }
 #else
     {
@@ -141,8 +327,14 @@ iterate_device (const char *name, void *data)
 
 	      if (grub_errno == GRUB_ERR_NONE && quid)
 		{
-		  if (compare_fn (quid, ctx->key) == 0)
-		    found = 1;
+		  unsigned t;
+
+		  /* The identifier is read once and compared against
+		     every outstanding target.  */
+		  for (t = 0; t < ctx->ntargets; t++)
+		    if (!target_done (ctx, t)
+			&& compare_fn (quid, ctx->keys[t]) == 0)
+		      record_match (ctx, t, name);
 
 		  grub_free (quid);
 		}
@@ -153,42 +345,55 @@ iterate_device (const char *name, void *data)
     }
 #endif
 
-  if (!ctx->is_cache && found && ctx->count == 0)
+  grub_errno = GRUB_ERR_NONE;
+  return all_targets_done (ctx);
+}
+
+/* Helper for FUNC_NAME.  */
+static void
+free_recorded_devs (struct search_ctx *ctx)
+{
+  struct found_dev *ent, *next;
+
+  for (ent = ctx->devs; ent; ent = next)
     {
-      struct cache_entry *cache_ent;
-      cache_ent = grub_malloc (sizeof (*cache_ent));
-      if (cache_ent)
-	{
-	  cache_ent->key = grub_strdup (ctx->key);
-	  cache_ent->value = grub_strdup (name);
-	  if (cache_ent->value && cache_ent->key)
-	    {
-	      cache_ent->next = cache;
-	      cache = cache_ent;
-	    }
-	  else
-	    {
-	      grub_free (cache_ent->value);
-	      grub_free (cache_ent->key);
-	      grub_free (cache_ent);
-	      grub_errno = GRUB_ERR_NONE;
-	    }
-	}
-      else
-	grub_errno = GRUB_ERR_NONE;
+      next = ent->next;
+      grub_free (ent->name);
+      grub_free (ent);
     }
+  ctx->devs = NULL;
+  ctx->devs_tail = NULL;
+  ctx->devs_complete = 0;
+}
+
+/* Helper for FUNC_NAME.  */
+static int
+iterate_device_record (const char *name, void *data)
+{
+  struct search_ctx *ctx = data;
 
-  if (found)
+  if (ctx->devs_tail)
     {
-      ctx->count++;
-      if (ctx->var)
-	grub_env_set (ctx->var, name);
+      struct found_dev *ent;
+
+      ent = grub_malloc (sizeof (*ent));
+      if (ent)
+	ent->name = grub_strdup (name);
+      if (ent && ent->name)
+	{
+	  ent->next = NULL;
+	  *ctx->devs_tail = ent;
+	  ctx->devs_tail = &ent->next;
+	}
       else
-	grub_printf (" %s", name);
+	{
+	  /* Keep searching, just without a replay list.  */
+	  grub_free (ent);
+	  free_recorded_devs (ctx);
+	  grub_errno = GRUB_ERR_NONE;
+	}
     }
-
-  grub_errno = GRUB_ERR_NONE;
-  return (found && ctx->var);
+  return iterate_device (name, ctx);
 }
 
 /* Helper for FUNC_NAME.  */
@@ -215,18 +420,23 @@ part_hook (grub_disk_t disk, const grub_partition_t partition, void *data)
 
 /* Helper for FUNC_NAME.  */
 static void
-try (struct search_ctx *ctx)    
+try (struct search_ctx *ctx)
 {
-  unsigned i;
+  unsigned i, t;
   struct cache_entry **prev;
   struct cache_entry *cache_ent;
 
-  for (prev = &cache, cache_ent = *prev; cache_ent;
-       prev = &cache_ent->next, cache_ent = *prev)
-    if (compare_fn (cache_ent->key, ctx->key) == 0)
-      break;
-  if (cache_ent)
+  if (!cache_loaded)
+    cache_load ();
+
+  for (t = 0; t < ctx->ntargets; t++)
     {
+      for (prev = &cache, cache_ent = *prev; cache_ent;
+	   prev = &cache_ent->next, cache_ent = *prev)
+	if (compare_fn (cache_ent->key, ctx->keys[t]) == 0)
+	  break;
+      if (!cache_ent)
+	continue;
       ctx->is_cache = 1;
       if (iterate_device (cache_ent->value, ctx))
 	{
@@ -235,12 +445,13 @@ try (struct search_ctx *ctx)
 	}
       ctx->is_cache = 0;
       /* Cache entry was outdated. Remove it.  */
-      if (!ctx->count)
+      if (!ctx->counts[t])
 	{
 	  *prev = cache_ent->next;
 	  grub_free (cache_ent->key);
 	  grub_free (cache_ent->value);
 	  grub_free (cache_ent);
+	  cache_store ();
 	}
     }
 
@@ -284,26 +495,64 @@ try (struct search_ctx *ctx)
 	    return;
 	}
     }
-  grub_device_iterate (iterate_device, ctx);
+  if (ctx->devs_complete)
+    {
+      /* The previous pass enumerated every device; walk the recorded
+	 names instead of re-opening all the disks and re-reading their
+	 partition tables.  */
+      struct found_dev *ent;
+
+      for (ent = ctx->devs; ent; ent = ent->next)
+	if (iterate_device (ent->name, ctx))
+	  return;
+      return;
+    }
+  if (grub_device_iterate (iterate_device_record, ctx) == 0
+      && ctx->devs_tail)
+    ctx->devs_complete = 1;
 }
 
 void
-FUNC_NAME (const char *key, const char *var, enum search_flags flags,
-	   char **hints, unsigned nhints)
+FUNC_NAME_MULTI (unsigned ntargets, const char * const *keys,
+		 const char * const *vars, enum search_flags flags,
+		 char **hints, unsigned nhints)
 {
   struct search_ctx ctx = {
-    .key = key,
-    .var = var,
+    .ntargets = ntargets,
+    .keys = keys,
+    .vars = vars,
+    .counts = NULL,
     .flags = flags,
     .hints = hints,
     .nhints = nhints,
     .count = 0,
-    .is_cache = 0
+    .is_cache = 0,
+    .devs = NULL,
+    .devs_tail = NULL,
+    .devs_complete = 0
   };
   grub_fs_autoload_hook_t saved_autoload;
+  unsigned t;
+  int set_vars = vars != NULL;
+
+  if (ntargets == 0)
+    return;
 
-  /* First try without autoloading if we're setting variable. */
-  if (var)
+  ctx.counts = grub_calloc (ntargets, sizeof (*ctx.counts));
+  if (!ctx.counts)
+    return;
+
+  for (t = 0; vars && t < ntargets; t++)
+    if (!vars[t])
+      set_vars = 0;
+
+  /* Only the variable-setting form retries the scan, so only it needs
+     the replay list.  */
+  if (set_vars)
+    ctx.devs_tail = &ctx.devs;
+
+  /* First try without autoloading if we're setting variables. */
+  if (set_vars)
     {
       saved_autoload = grub_fs_autoload_hook;
       grub_fs_autoload_hook = 0;
@@ -312,15 +561,34 @@ FUNC_NAME (const char *key, const char *var, enum search_flags flags,
       /* Restore autoload hook.  */
       grub_fs_autoload_hook = saved_autoload;
 
-      /* Retry with autoload if nothing found.  */
-      if (grub_errno == GRUB_ERR_NONE && ctx.count == 0)
+      /* Retry with autoload if something is still missing.  */
+      if (grub_errno == GRUB_ERR_NONE && !all_targets_done (&ctx))
 	try (&ctx);
     }
   else
     try (&ctx);
 
-  if (grub_errno == GRUB_ERR_NONE && ctx.count == 0)
-    grub_error (GRUB_ERR_FILE_NOT_FOUND, "no such device: %s", key);
+  free_recorded_devs (&ctx);
+
+  if (grub_errno == GRUB_ERR_NONE)
+    for (t = 0; t < ntargets; t++)
+      if (ctx.counts[t] == 0)
+	{
+	  grub_error (GRUB_ERR_FILE_NOT_FOUND, "no such device: %s", keys[t]);
+	  break;
+	}
+
+  grub_free (ctx.counts);
+}
+
+void
+FUNC_NAME (const char *key, const char *var, enum search_flags flags,
+	   char **hints, unsigned nhints)
+{
+  const char *keys[1] = { key };
+  const char *vars[1] = { var };
+
+  FUNC_NAME_MULTI (1, keys, var ? vars : NULL, flags, hints, nhints);
 }
 
 static grub_err_t
@@ -1,5 +1,6 @@
 #define DO_SEARCH_FILE 1
 #define FUNC_NAME grub_search_fs_file
+#define FUNC_NAME_MULTI grub_search_fs_file_multi
 #define COMMAND_NAME "search.file"
 #define HELP_MESSAGE N_("Search devices by file. If VARIABLE is specified, the first device found is set to a variable.")
 #include "search.c"
@@ -1,5 +1,6 @@
 #define DO_SEARCH_FS_UUID 1
 #define FUNC_NAME grub_search_fs_uuid
+#define FUNC_NAME_MULTI grub_search_fs_uuid_multi
 #define COMMAND_NAME "search.fs_uuid"
 #define HELP_MESSAGE N_("Search devices by UUID. If VARIABLE is specified, the first device found is set to a variable.")
 #include "search.c"
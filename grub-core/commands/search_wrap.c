@@ -39,6 +39,9 @@ static const struct grub_arg_option options[] =
     {"set",		's', GRUB_ARG_OPTION_OPTIONAL,
      N_("Set a variable to the first device found."), N_("VARNAME"),
      ARG_TYPE_STRING},
+    {"set-many",	0, GRUB_ARG_OPTION_REPEATABLE,
+     N_("Resolve several VARIABLE=NAME pairs in a single device scan."),
+     N_("VARIABLE=NAME"), ARG_TYPE_STRING},
     {"no-floppy",	'n', 0, N_("Do not probe any floppy drive."), 0, 0},
     {"efidisk-only",	0, 0, N_("Only probe EFI disks."), 0, 0},
     {"root-dev-only",  'r', 0, N_("Only probe root device."), 0, 0},
@@ -74,6 +77,7 @@ enum options
     SEARCH_LABEL,
     SEARCH_FS_UUID,
     SEARCH_SET,
+    SEARCH_SET_MANY,
     SEARCH_NO_FLOPPY,
     SEARCH_EFIDISK_ONLY,
     SEARCH_ROOTDEV_ONLY,
@@ -169,6 +173,61 @@ grub_cmd_search (grub_extcmd_context_t ctxt, int argc, char **args)
     if (grub_memcmp (args[j], "--hint-", sizeof ("--hint-") - 1) != 0)
       break;
 
+  if (state[SEARCH_NO_FLOPPY].set)
+    flags |= SEARCH_FLAGS_NO_FLOPPY;
+
+  if (state[SEARCH_EFIDISK_ONLY].set)
+    flags |= SEARCH_FLAGS_EFIDISK_ONLY;
+
+  if (state[SEARCH_ROOTDEV_ONLY].set)
+    flags |= SEARCH_FLAGS_ROOTDEV_ONLY;
+
+  if (state[SEARCH_SET_MANY].set)
+    {
+      unsigned n, t;
+      const char **keys;
+      const char **vars;
+
+      for (n = 0; state[SEARCH_SET_MANY].args[n]; n++);
+      keys = grub_calloc (n, sizeof (*keys));
+      vars = grub_calloc (n, sizeof (*vars));
+      if (!keys || !vars)
+	{
+	  grub_free (keys);
+	  grub_free (vars);
+	  goto out;
+	}
+      for (t = 0; t < n; t++)
+	{
+	  char *eq = grub_strchr (state[SEARCH_SET_MANY].args[t], '=');
+
+	  if (!eq || eq == state[SEARCH_SET_MANY].args[t] || !eq[1])
+	    {
+	      grub_error (GRUB_ERR_BAD_ARGUMENT,
+			  N_("expected VARIABLE=NAME, got `%s'"),
+			  state[SEARCH_SET_MANY].args[t]);
+	      break;
+	    }
+	  *eq = '\0';
+	  vars[t] = state[SEARCH_SET_MANY].args[t];
+	  keys[t] = eq + 1;
+	}
+      if (t == n)
+	{
+	  if (state[SEARCH_LABEL].set)
+	    grub_search_label_multi (n, keys, vars, flags, hints, nhints);
+	  else if (state[SEARCH_FS_UUID].set)
+	    grub_search_fs_uuid_multi (n, keys, vars, flags, hints, nhints);
+	  else if (state[SEARCH_FILE].set)
+	    grub_search_fs_file_multi (n, keys, vars, flags, hints, nhints);
+	  else
+	    grub_error (GRUB_ERR_INVALID_COMMAND, "unspecified search type");
+	}
+      grub_free (keys);
+      grub_free (vars);
+      goto out;
+    }
+
   if (state[SEARCH_SET].set)
     var = state[SEARCH_SET].arg ? state[SEARCH_SET].arg : "root";
 
@@ -185,15 +244,6 @@ grub_cmd_search (grub_extcmd_context_t ctxt, int argc, char **args)
       goto out;
     }
 
-  if (state[SEARCH_NO_FLOPPY].set)
-    flags |= SEARCH_FLAGS_NO_FLOPPY;
-
-  if (state[SEARCH_EFIDISK_ONLY].set)
-    flags |= SEARCH_FLAGS_EFIDISK_ONLY;
-
-  if (state[SEARCH_ROOTDEV_ONLY].set)
-    flags |= SEARCH_FLAGS_ROOTDEV_ONLY;
-
   if (state[SEARCH_LABEL].set)
     grub_search_label (id, var, flags, hints, nhints);
   else if (state[SEARCH_FS_UUID].set)
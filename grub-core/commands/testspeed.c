@@ -19,6 +19,7 @@
 
 #include <grub/mm.h>
 #include <grub/file.h>
+#include <grub/disk.h>
 #include <grub/time.h>
 #include <grub/misc.h>
 #include <grub/dl.h>
@@ -29,13 +30,32 @@
 GRUB_MOD_LICENSE ("GPLv3+");
 
 #define DEFAULT_BLOCK_SIZE	65536
+#define DEFAULT_RANDOM_COUNT	256
+
+/* Power-of-two millisecond buckets: <1ms, <2ms, <4ms, ...  */
+#define LATENCY_BUCKETS		16
 
 static const struct grub_arg_option options[] =
   {
     {"size", 's', 0, N_("Specify size for each read operation"), 0, ARG_TYPE_INT},
+    {"random", 'r', 0, N_("Read blocks at random offsets instead of sequentially"), 0, 0},
+    {"count", 'c', 0, N_("Number of reads for random mode"), 0, ARG_TYPE_INT},
+    {"nocache", 'n', 0, N_("Invalidate the disk cache before every read"), 0, 0},
+    {"histogram", 'g', 0, N_("Show a per-read latency histogram"), 0, 0},
+    {"csv", 0, 0, N_("Output results in CSV format"), 0, 0},
     {0, 0, 0, 0, 0, 0}
   };
 
+/* A fixed-increment 64-bit LCG is plenty for scattering read offsets.  */
+static grub_uint64_t prng_state;
+
+static grub_uint64_t
+prng_next (void)
+{
+  prng_state = prng_state * 6364136223846793005ULL + 1442695040888963407ULL;
+  return prng_state >> 16;
+}
+
 static grub_err_t
 grub_cmd_testspeed (grub_extcmd_context_t ctxt, int argc, char **args)
 {
@@ -47,6 +67,13 @@ grub_cmd_testspeed (grub_extcmd_context_t ctxt, int argc, char **args)
   char *buffer;
   grub_file_t file;
   grub_uint64_t whole, fraction;
+  int random = state[1].set;
+  int nocache = state[3].set;
+  int histogram = state[4].set;
+  int csv = state[5].set;
+  grub_uint64_t count, nreads = 0;
+  grub_uint64_t buckets[LATENCY_BUCKETS];
+  grub_uint64_t lat_min = (grub_uint64_t) -1, lat_max = 0;
 
   if (argc == 0)
     return grub_error (GRUB_ERR_BAD_ARGUMENT, N_("filename expected"));
@@ -57,6 +84,13 @@ grub_cmd_testspeed (grub_extcmd_context_t ctxt, int argc, char **args)
   if (block_size <= 0)
     return grub_error (GRUB_ERR_BAD_ARGUMENT, N_("invalid block size"));
 
+  count = (state[2].set) ?
+    grub_strtoull (state[2].arg, 0, 0) : DEFAULT_RANDOM_COUNT;
+  if (count == 0)
+    return grub_error (GRUB_ERR_BAD_ARGUMENT, N_("invalid read count"));
+
+  grub_memset (buckets, 0, sizeof (buckets));
+
   buffer = grub_malloc (block_size);
   if (buffer == NULL)
     return grub_errno;
@@ -65,20 +99,89 @@ grub_cmd_testspeed (grub_extcmd_context_t ctxt, int argc, char **args)
   if (file == NULL)
     goto quit;
 
+  if (random && grub_file_size (file) < (grub_off_t) block_size)
+    {
+      grub_error (GRUB_ERR_BAD_ARGUMENT,
+		  N_("file smaller than one block"));
+      grub_file_close (file);
+      goto quit;
+    }
+
+  prng_state = grub_get_time_ms () | 1;
+
   total_size = 0;
   start = grub_get_time_ms ();
   while (1)
     {
-      grub_ssize_t size = grub_file_read (file, buffer, block_size);
+      grub_ssize_t size;
+      grub_uint64_t req_start, latency;
+      int bucket;
+
+      if (random)
+	{
+	  grub_uint64_t nblocks = grub_divmod64 (grub_file_size (file),
+						 block_size, 0);
+	  grub_uint64_t blk;
+
+	  if (nreads >= count)
+	    break;
+	  grub_divmod64 (prng_next (), nblocks, &blk);
+	  grub_file_seek (file, blk * block_size);
+	}
+
+      if (nocache)
+	grub_disk_cache_invalidate_all ();
+
+      req_start = grub_get_time_ms ();
+      size = grub_file_read (file, buffer, block_size);
       if (size <= 0)
 	break;
+      latency = grub_get_time_ms () - req_start;
+
+      if (latency < lat_min)
+	lat_min = latency;
+      if (latency > lat_max)
+	lat_max = latency;
+      for (bucket = 0; bucket < LATENCY_BUCKETS - 1; bucket++)
+	if (latency < (1ULL << bucket))
+	  break;
+      buckets[bucket]++;
+
       total_size += size;
+      nreads++;
     }
   end = grub_get_time_ms ();
   grub_file_close (file);
 
-  grub_printf_ (N_("File size: %s\n"),
-		grub_get_human_size (total_size, GRUB_HUMAN_SIZE_NORMAL));
+  if (csv)
+    {
+      int i;
+
+      grub_printf ("pattern,block_size,reads,bytes,elapsed_ms,"
+		   "lat_min_ms,lat_max_ms\n");
+      grub_printf ("%s,%llu,%llu,%llu,%llu,%llu,%llu\n",
+		   random ? "random" : "sequential",
+		   (unsigned long long) block_size,
+		   (unsigned long long) nreads,
+		   (unsigned long long) total_size,
+		   (unsigned long long) (end - start),
+		   (unsigned long long) (nreads ? lat_min : 0),
+		   (unsigned long long) lat_max);
+      if (histogram)
+	{
+	  grub_printf ("lat_below_ms,count\n");
+	  for (i = 0; i < LATENCY_BUCKETS; i++)
+	    if (buckets[i])
+	      grub_printf ("%llu,%llu\n",
+			   (unsigned long long) (1ULL << i),
+			   (unsigned long long) buckets[i]);
+	}
+      goto quit;
+    }
+
+  grub_printf_ (N_("Transferred: %s in %llu reads\n"),
+		grub_get_human_size (total_size, GRUB_HUMAN_SIZE_NORMAL),
+		(unsigned long long) nreads);
   whole = grub_divmod64 (end - start, 1000, &fraction);
   grub_printf_ (N_("Elapsed time: %d.%03d s \n"),
 		(unsigned) whole,
@@ -94,6 +197,21 @@ grub_cmd_testspeed (grub_extcmd_context_t ctxt, int argc, char **args)
 					 GRUB_HUMAN_SIZE_SPEED));
     }
 
+  if (nreads)
+    grub_printf_ (N_("Latency: min %llums max %llums\n"),
+		  (unsigned long long) lat_min,
+		  (unsigned long long) lat_max);
+
+  if (histogram)
+    {
+      int i;
+      for (i = 0; i < LATENCY_BUCKETS; i++)
+	if (buckets[i])
+	  grub_printf_ (N_("  < %4llums: %llu\n"),
+			(unsigned long long) (1ULL << i),
+			(unsigned long long) buckets[i]);
+    }
+
  quit:
   grub_free (buffer);
 
@@ -104,8 +222,9 @@ static grub_extcmd_t cmd;
 
 GRUB_MOD_INIT(testspeed)
 {
-  cmd = grub_register_extcmd ("testspeed", grub_cmd_testspeed, 0, N_("[-s SIZE] FILENAME"),
-			      N_("Test file read speed."),
+  cmd = grub_register_extcmd ("testspeed", grub_cmd_testspeed, 0,
+			      N_("[-s SIZE] [-r] [-c COUNT] [-n] [-g] [--csv] FILENAME"),
+			      N_("Benchmark file read speed and latency."),
 			      options);
 }
 
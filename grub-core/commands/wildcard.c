@@ -21,6 +21,7 @@
 #include <grub/fs.h>
 #include <grub/env.h>
 #include <grub/file.h>
+#include <grub/disk.h>
 #include <grub/device.h>
 #include <grub/script_sh.h>
 #include <grub/safemath.h>
@@ -30,8 +31,7 @@
 static inline int isregexop (char ch);
 static char ** merge (char **lhs, char **rhs);
 static char *make_dir (const char *prefix, const char *start, const char *end);
-static int make_regex (const char *regex_start, const char *regex_end,
-		       regex_t *regexp);
+static regex_t *make_regex (const char *regex_start, const char *regex_end);
 static void split_path (const char *path, const char **suffix_end, const char **regex_end);
 static char ** match_devices (const regex_t *regexp, int noparts);
 static char ** match_files (const char *prefix, const char *suffix_start,
@@ -43,6 +43,58 @@ struct grub_script_wildcard_translator grub_filename_translator = {
   .expand = wildcard_expand,
 };
 
+/* Expanding a menu full of kernel entries recompiles the same handful of
+   glob patterns over and over; keep the last few compiled programs so
+   regcomp runs once per pattern.  Flushed from the regexp module FINI.  */
+struct wildcard_regex_cache_entry
+{
+  struct wildcard_regex_cache_entry *next;
+  char *pattern;
+  regex_t regex;
+};
+
+#define WILDCARD_REGEX_CACHE_MAX 4
+
+static struct wildcard_regex_cache_entry *wildcard_regex_cache;
+static int wildcard_regex_cache_count;
+
+/* Device names from the last full enumeration, in iteration order so
+   expansions keep their usual order.  Revalidated against the disk
+   device generation; a full grub_device_iterate rescans every driver
+   and is by far the dearest part of expanding patterns like (hd*).  */
+static char **dev_name_cache;
+static unsigned long dev_name_cache_generation;
+
+static void
+dev_name_cache_flush (void)
+{
+  int i;
+
+  for (i = 0; dev_name_cache && dev_name_cache[i]; i++)
+    grub_free (dev_name_cache[i]);
+  grub_free (dev_name_cache);
+  dev_name_cache = 0;
+  dev_name_cache_generation = 0;
+}
+
+void
+grub_wildcard_regex_cache_flush (void)
+{
+  struct wildcard_regex_cache_entry *ent, *next;
+
+  for (ent = wildcard_regex_cache; ent; ent = next)
+    {
+      next = ent->next;
+      regfree (&ent->regex);
+      grub_free (ent->pattern);
+      grub_free (ent);
+    }
+  wildcard_regex_cache = 0;
+  wildcard_regex_cache_count = 0;
+
+  dev_name_cache_flush ();
+}
+
 static char **
 merge (char **dest, char **ps)
 {
@@ -116,23 +168,24 @@ make_dir (const char *prefix, const char *start, const char *end)
   return result;
 }
 
-static int
-make_regex (const char *start, const char *end, regex_t *regexp)
+static regex_t *
+make_regex (const char *start, const char *end)
 {
   char ch;
   int i = 0;
   unsigned len = end - start;
   char *buffer;
   grub_size_t sz;
+  struct wildcard_regex_cache_entry *ent, **link;
 
   /* Worst case size is (len * 2 + 2 + 1). */
   if (grub_mul (len, 2, &sz) ||
       grub_add (sz, 3, &sz))
-    return 1;
+    return 0;
 
   buffer = grub_malloc (sz);
   if (! buffer)
-    return 1;
+    return 0;
 
   buffer[i++] = '^';
   while (start < end)
@@ -177,14 +230,48 @@ make_regex (const char *start, const char *end, regex_t *regexp)
   buffer[i] = '\0';
   grub_dprintf ("expand", "Regexp is %s\n", buffer);
 
-  if (regcomp (regexp, buffer, RE_SYNTAX_GNU_AWK))
+  for (link = &wildcard_regex_cache; (ent = *link); link = &ent->next)
+    if (grub_strcmp (ent->pattern, buffer) == 0)
+      {
+	/* Move to the front so frequently used patterns stay cached.  */
+	*link = ent->next;
+	ent->next = wildcard_regex_cache;
+	wildcard_regex_cache = ent;
+	grub_free (buffer);
+	return &ent->regex;
+      }
+
+  ent = grub_malloc (sizeof (*ent));
+  if (! ent)
     {
       grub_free (buffer);
-      return 1;
+      return 0;
     }
 
-  grub_free (buffer);
-  return 0;
+  if (regcomp (&ent->regex, buffer, RE_SYNTAX_GNU_AWK))
+    {
+      grub_free (ent);
+      grub_free (buffer);
+      return 0;
+    }
+
+  ent->pattern = buffer;
+  ent->next = wildcard_regex_cache;
+  wildcard_regex_cache = ent;
+
+  if (++wildcard_regex_cache_count > WILDCARD_REGEX_CACHE_MAX)
+    {
+      for (link = &wildcard_regex_cache; (*link)->next; link = &(*link)->next)
+	;
+      ent = *link;
+      *link = 0;
+      regfree (&ent->regex);
+      grub_free (ent->pattern);
+      grub_free (ent);
+      wildcard_regex_cache_count--;
+    }
+
+  return &wildcard_regex_cache->regex;
 }
 
 /* Split `str' into two parts: (1) dirname that is regexop free (2)
@@ -276,6 +363,75 @@ match_devices_iter (const char *name, void *data)
   return 0;
 }
 
+/* Context for collect_devices.  */
+struct collect_devices_ctx
+{
+  int ndev;
+  char **devs;
+};
+
+/* Helper for ensure_dev_name_cache.  */
+static int
+collect_devices_iter (const char *name, void *data)
+{
+  struct collect_devices_ctx *ctx = data;
+  char **t;
+  char *dup;
+  grub_size_t sz;
+
+  dup = grub_strdup (name);
+  if (! dup)
+    return 1;
+
+  if (grub_add (ctx->ndev, 2, &sz) ||
+      grub_mul (sz, sizeof (char *), &sz))
+    {
+      grub_free (dup);
+      return 1;
+    }
+
+  t = grub_realloc (ctx->devs, sz);
+  if (! t)
+    {
+      grub_free (dup);
+      return 1;
+    }
+
+  ctx->devs = t;
+  ctx->devs[ctx->ndev++] = dup;
+  ctx->devs[ctx->ndev] = 0;
+  return 0;
+}
+
+/* Enumerate devices once and keep the names until the device set
+   changes.  Returns the cached list or 0 on failure (which is not an
+   error; the caller just sees no matches, as a failed iteration did
+   before).  */
+static char **
+ensure_dev_name_cache (void)
+{
+  struct collect_devices_ctx ctx = { 0, 0 };
+  unsigned long generation = grub_disk_dev_generation ();
+  int i;
+
+  if (dev_name_cache && dev_name_cache_generation == generation)
+    return dev_name_cache;
+
+  dev_name_cache_flush ();
+
+  if (grub_device_iterate (collect_devices_iter, &ctx))
+    {
+      for (i = 0; ctx.devs && ctx.devs[i]; i++)
+	grub_free (ctx.devs[i]);
+      grub_free (ctx.devs);
+      return 0;
+    }
+
+  dev_name_cache = ctx.devs;
+  dev_name_cache_generation = generation;
+  return dev_name_cache;
+}
+
 static char **
 match_devices (const regex_t *regexp, int noparts)
 {
@@ -285,10 +441,13 @@ match_devices (const regex_t *regexp, int noparts)
     .ndev = 0,
     .devs = 0
   };
+  char **names;
   int i;
 
-  if (grub_device_iterate (match_devices_iter, &ctx))
-    goto fail;
+  names = ensure_dev_name_cache ();
+  for (i = 0; names && names[i]; i++)
+    if (match_devices_iter (names[i], &ctx))
+      goto fail;
 
   return ctx.devs;
 
@@ -533,7 +692,7 @@ wildcard_expand (const char *s, char ***strs)
   int had_regexp = 0;
 
   unsigned i;
-  regex_t regexp;
+  regex_t *regexp;
 
   *strs = 0;
   if (s[0] != '/' && s[0] != '(' && s[0] != '*')
@@ -610,7 +769,8 @@ wildcard_expand (const char *s, char ***strs)
 	  continue;
 	}
 
-      if (make_regex (noregexop, regexop, &regexp))
+      regexp = make_regex (noregexop, regexop);
+      if (! regexp)
 	goto fail;
 
       had_regexp = 1;
@@ -618,10 +778,10 @@ wildcard_expand (const char *s, char ***strs)
       if (paths == 0)
 	{
 	  if (start == noregexop) /* device part has regexop */
-	    paths = match_devices (&regexp, *start != '(');
+	    paths = match_devices (regexp, *start != '(');
 
 	  else  /* device part explicit wo regexop */
-	    paths = match_files ("", start, noregexop, &regexp);
+	    paths = match_files ("", start, noregexop, regexp);
 	}
       else
 	{
@@ -631,7 +791,7 @@ wildcard_expand (const char *s, char ***strs)
 	    {
 	      char **p;
 
-	      p = match_files (paths[i], start, noregexop, &regexp);
+	      p = match_files (paths[i], start, noregexop, regexp);
 	      grub_free (paths[i]);
 	      if (! p)
 		continue;
@@ -644,7 +804,6 @@ wildcard_expand (const char *s, char ***strs)
 	  paths = r;
 	}
 
-      regfree (&regexp);
       if (! paths)
 	goto done;
 
@@ -661,6 +820,5 @@ wildcard_expand (const char *s, char ***strs)
   for (i = 0; paths && paths[i]; i++)
     grub_free (paths[i]);
   grub_free (paths);
-  regfree (&regexp);
   return grub_errno;
 }
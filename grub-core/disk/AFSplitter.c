@@ -41,26 +41,30 @@ diffuse (const gcry_md_spec_t * hash, grub_uint8_t * src,
   grub_size_t fullblocks = size / hash->mdlen;
   int padding = size % hash->mdlen;
   grub_uint8_t final[GRUB_CRYPTO_MAX_MDLEN];
-  grub_uint8_t temp[sizeof (IV) + GRUB_CRYPTO_MAX_MDLEN];
+  GRUB_PROPERLY_ALIGNED_ARRAY (ctx, GRUB_CRYPTO_MAX_MD_CONTEXT_SIZE);
 
   /* hash block the whole data set with different IVs to produce
-   * more than just a single data block
+   * more than just a single data block; the IV and the data are fed to
+   * the hash incrementally, so no bounce buffer copy is needed per block
    */
   for (i = 0; i < fullblocks; i++)
     {
       IV = grub_cpu_to_be32 (i);
-      grub_memcpy (temp, &IV, sizeof (IV));
-      grub_memcpy (temp + sizeof (IV), src + hash->mdlen * i, hash->mdlen);
-      grub_crypto_hash (hash, dst + hash->mdlen * i, temp,
-			sizeof (IV) + hash->mdlen);
+      hash->init (&ctx);
+      hash->write (&ctx, &IV, sizeof (IV));
+      hash->write (&ctx, src + hash->mdlen * i, hash->mdlen);
+      hash->final (&ctx);
+      grub_memcpy (dst + hash->mdlen * i, hash->read (&ctx), hash->mdlen);
     }
 
   if (padding)
     {
       IV = grub_cpu_to_be32 (i);
-      grub_memcpy (temp, &IV, sizeof (IV));
-      grub_memcpy (temp + sizeof (IV), src + hash->mdlen * i, padding);
-      grub_crypto_hash (hash, final, temp, sizeof (IV) + padding);
+      hash->init (&ctx);
+      hash->write (&ctx, &IV, sizeof (IV));
+      hash->write (&ctx, src + hash->mdlen * i, padding);
+      hash->final (&ctx);
+      grub_memcpy (final, hash->read (&ctx), hash->mdlen);
       grub_memcpy (dst + hash->mdlen * i, final, padding);
     }
 }
@@ -75,14 +79,14 @@ AF_merge (const gcry_md_spec_t * hash, grub_uint8_t * src, grub_uint8_t * dst,
   grub_size_t i;
   grub_uint8_t *bufblock;
 
-  if (hash->mdlen > GRUB_CRYPTO_MAX_MDLEN || hash->mdlen == 0)
+  if (hash->mdlen > GRUB_CRYPTO_MAX_MDLEN || hash->mdlen == 0
+      || hash->contextsize > GRUB_CRYPTO_MAX_MD_CONTEXT_SIZE)
     return GPG_ERR_INV_ARG;
 
   bufblock = grub_zalloc (blocksize);
   if (bufblock == NULL)
     return GPG_ERR_OUT_OF_MEMORY;
 
-  grub_memset (bufblock, 0, blocksize);
   for (i = 0; i < blocknumbers - 1; i++)
     {
       grub_crypto_xor (bufblock, src + (blocksize * i), bufblock, blocksize);
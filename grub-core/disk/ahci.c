@@ -115,9 +115,17 @@ struct grub_ahci_received_fis
 
 enum
   {
-    GRUB_AHCI_HBA_CAP_NPORTS_MASK = 0x1f
+    GRUB_AHCI_HBA_CAP_NPORTS_MASK = 0x1f,
+    GRUB_AHCI_HBA_CAP_SNCQ = 0x40000000
   };
 
+/* Number of command slots used by the queued-read path.  The HBA has 32
+   slots but queue depth 4 already hides most per-command latency and
+   keeps the DMA bounce-buffer footprint small.  */
+#define GRUB_AHCI_QUEUE_DEPTH 4
+
+#define GRUB_AHCI_CMD_READ_FPDMA_QUEUED 0x60
+
 enum
   {
     GRUB_AHCI_HBA_GLOBAL_CONTROL_RESET = 0x00000001,
@@ -148,6 +156,9 @@ struct grub_ahci_device
   struct grub_pci_dma_chunk *rfis;
   int present;
   int atapi;
+  /* NCQ state: 0 = untried, 1 = working, -1 = disabled after a failed
+     queued command.  */
+  int ncq;
 };
 
 static grub_err_t 
@@ -380,7 +391,8 @@ grub_ahci_pciinit (grub_pci_device_t dev,
 	  }
 
 	adevs[i]->command_table_chunk = grub_memalign_dma32 (1024,
-							    sizeof (struct grub_ahci_cmd_table));
+							    sizeof (struct grub_ahci_cmd_table)
+							    * GRUB_AHCI_QUEUE_DEPTH);
 	if (!adevs[i]->command_table_chunk)
 	  {
 	    grub_dma_free (adevs[i]->command_list_chunk);
@@ -392,9 +404,10 @@ grub_ahci_pciinit (grub_pci_device_t dev,
 	adevs[i]->command_table = grub_dma_get_virt (adevs[i]->command_table_chunk);
 
 	grub_memset ((void *) adevs[i]->command_list, 0,
-		     sizeof (struct grub_ahci_cmd_table));
-	grub_memset ((void *) adevs[i]->command_table, 0,
 		     sizeof (struct grub_ahci_cmd_head) * 32);
+	grub_memset ((void *) adevs[i]->command_table, 0,
+		     sizeof (struct grub_ahci_cmd_table)
+		     * GRUB_AHCI_QUEUE_DEPTH);
 
 	adevs[i]->command_list->command_table_base
 	  = grub_dma_get_phys (adevs[i]->command_table_chunk);
@@ -1094,12 +1107,180 @@ grub_ahci_readwrite_real (struct grub_ahci_device *dev,
   return err;
 }
 
-static grub_err_t 
+/* Fill command slot SLOT with a READ FPDMA QUEUED of COUNT sectors at
+   LBA into the DMA buffer at PHYS.  The NCQ tag equals the slot number,
+   so completion is tracked per slot in both CI and SACT.  */
+static void
+grub_ahci_submit_fpdma_read (struct grub_ahci_device *dev, unsigned slot,
+			     grub_uint64_t lba, grub_uint16_t count,
+			     grub_uint32_t phys, grub_size_t size)
+{
+  volatile struct grub_ahci_cmd_table *tbl = &dev->command_table[slot];
+
+  dev->command_list[slot].config
+    = (5 << GRUB_AHCI_CONFIG_CFIS_LENGTH_SHIFT)
+    | (0 << GRUB_AHCI_CONFIG_PMP_SHIFT)
+    | (1 << GRUB_AHCI_CONFIG_PRDT_LENGTH_SHIFT)
+    | GRUB_AHCI_CONFIG_READ;
+  dev->command_list[slot].transferred = 0;
+  dev->command_list[slot].command_table_base
+    = grub_dma_get_phys (dev->command_table_chunk)
+    + slot * sizeof (struct grub_ahci_cmd_table);
+  grub_memset ((char *) dev->command_list[slot].unused, 0,
+	       sizeof (dev->command_list[slot].unused));
+
+  grub_memset ((char *) tbl, 0, sizeof (*tbl));
+  tbl->cfis[0] = GRUB_AHCI_FIS_REG_H2D;
+  tbl->cfis[1] = 0x80;
+  tbl->cfis[2] = GRUB_AHCI_CMD_READ_FPDMA_QUEUED;
+  /* In FPDMA commands the sector count lives in the FEATURES pair and
+     the tag in the count field.  */
+  tbl->cfis[3] = count & 0xff;
+  tbl->cfis[11] = count >> 8;
+  tbl->cfis[4] = lba & 0xff;
+  tbl->cfis[5] = (lba >> 8) & 0xff;
+  tbl->cfis[6] = (lba >> 16) & 0xff;
+  tbl->cfis[7] = 0x40;
+  tbl->cfis[8] = (lba >> 24) & 0xff;
+  tbl->cfis[9] = (lba >> 32) & 0xff;
+  tbl->cfis[10] = (lba >> 40) & 0xff;
+  tbl->cfis[12] = slot << 3;
+
+  tbl->prdt[0].data_base = phys;
+  tbl->prdt[0].unused = 0;
+  tbl->prdt[0].size = size - 1;
+}
+
+/* Split a large LBA48 DMA read across up to GRUB_AHCI_QUEUE_DEPTH
+   command slots issued as NCQ commands in flight simultaneously, and
+   wait for all of them to complete.  */
+static grub_err_t
+grub_ahci_read_queued (struct grub_ahci_device *dev,
+		       struct grub_disk_ata_pass_through_parms *parms)
+{
+  struct grub_pci_dma_chunk *bufc[GRUB_AHCI_QUEUE_DEPTH];
+  grub_uint64_t lba;
+  grub_uint64_t endtime;
+  grub_size_t total_sectors, slot_sectors;
+  unsigned nslots, slot;
+  grub_uint32_t mask;
+  grub_err_t err = GRUB_ERR_NONE;
+
+  lba = parms->taskfile.lba_low
+    | ((grub_uint64_t) parms->taskfile.lba_mid << 8)
+    | ((grub_uint64_t) parms->taskfile.lba_high << 16)
+    | ((grub_uint64_t) parms->taskfile.lba48_low << 24)
+    | ((grub_uint64_t) parms->taskfile.lba48_mid << 32)
+    | ((grub_uint64_t) parms->taskfile.lba48_high << 40);
+
+  total_sectors = parms->size >> GRUB_DISK_SECTOR_BITS;
+  slot_sectors = (total_sectors + GRUB_AHCI_QUEUE_DEPTH - 1)
+    / GRUB_AHCI_QUEUE_DEPTH;
+  nslots = (total_sectors + slot_sectors - 1) / slot_sectors;
+
+  grub_ahci_reset_port (dev, 0);
+  dev->hba->ports[dev->port].task_file_data = 0;
+  dev->hba->ports[dev->port].sata_error
+    = dev->hba->ports[dev->port].sata_error;
+
+  mask = 0;
+  for (slot = 0; slot < nslots; slot++)
+    {
+      grub_size_t cur = slot_sectors;
+
+      if ((slot + 1) * slot_sectors > total_sectors)
+	cur = total_sectors - slot * slot_sectors;
+      bufc[slot] = grub_memalign_dma32 (1024, cur << GRUB_DISK_SECTOR_BITS);
+      if (!bufc[slot])
+	{
+	  while (slot--)
+	    grub_dma_free (bufc[slot]);
+	  return grub_errno;
+	}
+      grub_ahci_submit_fpdma_read (dev, slot, lba + slot * slot_sectors,
+				   cur, grub_dma_get_phys (bufc[slot]),
+				   cur << GRUB_DISK_SECTOR_BITS);
+      mask |= 1 << slot;
+    }
+
+  grub_dprintf ("ahci", "AHCI NCQ read: %u slots, %" PRIuGRUB_SIZE
+		" sectors each\n", nslots, slot_sectors);
+
+  dev->hba->ports[dev->port].inten = 0xffffffff;
+  dev->hba->ports[dev->port].intstatus = 0xffffffff;
+  /* For NCQ the tags must be marked active before the commands are
+     issued.  */
+  dev->hba->ports[dev->port].sata_active = mask;
+  dev->hba->ports[dev->port].command_issue = mask;
+
+  endtime = grub_get_time_ms () + 20000;
+  while ((dev->hba->ports[dev->port].command_issue & mask)
+	 || (dev->hba->ports[dev->port].sata_active & mask))
+    if (grub_get_time_ms () > endtime
+	|| (dev->hba->ports[dev->port].intstatus
+	    & GRUB_AHCI_HBA_PORT_IS_FATAL_MASK))
+      {
+	grub_dprintf ("ahci", "AHCI NCQ status <%x %x %x %x>\n",
+		      dev->hba->ports[dev->port].command_issue,
+		      dev->hba->ports[dev->port].sata_active,
+		      dev->hba->ports[dev->port].intstatus,
+		      dev->hba->ports[dev->port].task_file_data);
+	dev->hba->ports[dev->port].command_issue = 0;
+	err = grub_error (GRUB_ERR_IO, "AHCI NCQ transfer failed");
+	grub_ahci_reset_port (dev, 1);
+	break;
+      }
+
+  for (slot = 0; slot < nslots; slot++)
+    {
+      grub_size_t cur = slot_sectors;
+
+      if ((slot + 1) * slot_sectors > total_sectors)
+	cur = total_sectors - slot * slot_sectors;
+      if (!err)
+	grub_memcpy ((char *) parms->buffer
+		     + ((grub_size_t) slot * slot_sectors
+			<< GRUB_DISK_SECTOR_BITS),
+		     (char *) grub_dma_get_virt (bufc[slot]),
+		     cur << GRUB_DISK_SECTOR_BITS);
+      grub_dma_free (bufc[slot]);
+    }
+
+  return err;
+}
+
+static grub_err_t
 grub_ahci_readwrite (grub_ata_t disk,
 		     struct grub_disk_ata_pass_through_parms *parms,
 		     int spinup)
 {
-  return grub_ahci_readwrite_real (disk->data, parms, spinup, 0);
+  struct grub_ahci_device *dev = disk->data;
+
+  /* Large LBA48 DMA reads go through the NCQ path when the HBA supports
+     it, with several commands in flight per port; everything else stays
+     on the single-slot path.  */
+  if (!parms->write && !parms->cmdsize && parms->dma && !spinup
+      && parms->taskfile.cmd == GRUB_ATA_CMD_READ_SECTORS_DMA_EXT
+      && parms->size >= (GRUB_AHCI_QUEUE_DEPTH << GRUB_DISK_SECTOR_BITS)
+      && (parms->size & (GRUB_DISK_SECTOR_SIZE - 1)) == 0
+      && dev->ncq >= 0 && (dev->hba->cap & GRUB_AHCI_HBA_CAP_SNCQ))
+    {
+      grub_err_t err = grub_ahci_read_queued (dev, parms);
+
+      if (err == GRUB_ERR_NONE)
+	{
+	  dev->ncq = 1;
+	  return GRUB_ERR_NONE;
+	}
+      if (dev->ncq != 0)
+	return err;
+      /* The device choked on its first queued command: disable NCQ for
+	 it and retry on the synchronous path.  */
+      dev->ncq = -1;
+      grub_errno = GRUB_ERR_NONE;
+    }
+
+  return grub_ahci_readwrite_real (dev, parms, spinup, 0);
 }
 
 static grub_err_t
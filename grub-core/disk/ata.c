@@ -158,6 +158,11 @@ grub_ata_identify (struct grub_ata *dev)
   /* CHS is always supported.  */
   dev->addr = GRUB_ATA_CHS;
 
+  /* The transport may have offered DMA; only keep it when the device
+     reports DMA support too.  */
+  if (! (info16[49] & grub_cpu_to_le16_compile_time ((1 << 8))))
+    dev->dma = 0;
+
   /* Check if LBA is supported.  */
   if (info16[49] & grub_cpu_to_le16_compile_time ((1 << 9)))
     {
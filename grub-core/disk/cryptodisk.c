@@ -46,6 +46,128 @@ static const struct grub_arg_option options[] =
 
 /* Our irreducible polynom is x^128+x^7+x^2+x+1. Lowest byte of it is:  */
 #define GF_POLYNOM 0x87
+
+/* Chunk size used to pipeline large reads against decryption.  */
+#define GRUB_CRYPTODISK_PIPELINE_BYTES 0x10000
+
+/* Plaintext cache of recently decrypted small reads.  The generic disk
+   cache above cryptodisk already holds decrypted lines, but it is
+   shared by every disk, so ciphertext traffic on the source disk can
+   evict decrypted metadata and force the cipher to run again on the
+   next superblock or directory read.  Keep a second, crypto-local copy
+   of small reads only: bulk payload reads never enter, which is what
+   biases the cache towards filesystem metadata.  */
+#define GRUB_CRYPTODISK_PLAIN_CACHE_LINE_BYTES	0x8000
+#define GRUB_CRYPTODISK_PLAIN_CACHE_BYTES	0x10000
+
+struct grub_cryptodisk_plain_line
+{
+  struct grub_cryptodisk_plain_line *next;
+  grub_disk_addr_t sector;
+  grub_size_t nsectors;
+  grub_uint8_t *data;
+};
+
+/* Serve BUF from the plaintext cache if a line fully covers the
+   request, moving the line to the front of the list.  */
+static int
+plain_cache_fetch (grub_cryptodisk_t dev, grub_disk_addr_t sector,
+		   grub_size_t size, char *buf)
+{
+  struct grub_cryptodisk_plain_line *line, **prev;
+
+  for (prev = &dev->plain_cache, line = *prev; line;
+       prev = &line->next, line = *prev)
+    if (sector >= line->sector
+	&& size <= line->nsectors
+	&& sector - line->sector <= line->nsectors - size)
+      {
+	grub_memcpy (buf, line->data
+		     + ((sector - line->sector) << dev->log_sector_size),
+		     size << dev->log_sector_size);
+	*prev = line->next;
+	line->next = dev->plain_cache;
+	dev->plain_cache = line;
+	return 1;
+      }
+  return 0;
+}
+
+/* Remember a decrypted read, evicting least recently used lines to stay
+   inside the budget.  Failure to allocate just skips the store.  */
+static void
+plain_cache_store (grub_cryptodisk_t dev, grub_disk_addr_t sector,
+		   grub_size_t size, const char *buf)
+{
+  struct grub_cryptodisk_plain_line *line, **prev;
+  grub_size_t bytes = size << dev->log_sector_size;
+
+  if (bytes > GRUB_CRYPTODISK_PLAIN_CACHE_LINE_BYTES)
+    return;
+
+  line = grub_malloc (sizeof (*line));
+  if (!line)
+    {
+      grub_errno = GRUB_ERR_NONE;
+      return;
+    }
+  line->data = grub_malloc (bytes);
+  if (!line->data)
+    {
+      grub_free (line);
+      grub_errno = GRUB_ERR_NONE;
+      return;
+    }
+  grub_memcpy (line->data, buf, bytes);
+  line->sector = sector;
+  line->nsectors = size;
+  line->next = dev->plain_cache;
+  dev->plain_cache = line;
+  dev->plain_cache_bytes += bytes;
+
+  /* Truncate the tail once the running total passes the budget; the
+     fresh line at the head always fits.  */
+  bytes = 0;
+  prev = &dev->plain_cache;
+  while ((line = *prev) != NULL
+	 && bytes + (line->nsectors << dev->log_sector_size)
+	    <= GRUB_CRYPTODISK_PLAIN_CACHE_BYTES)
+    {
+      bytes += line->nsectors << dev->log_sector_size;
+      prev = &line->next;
+    }
+  while ((line = *prev) != NULL)
+    {
+      *prev = line->next;
+      dev->plain_cache_bytes -= line->nsectors << dev->log_sector_size;
+      grub_free (line->data);
+      grub_free (line);
+    }
+}
+
+/* Drop every cached line overlapping the written range.  */
+static void
+plain_cache_invalidate (grub_cryptodisk_t dev, grub_disk_addr_t sector,
+			grub_size_t size)
+{
+  struct grub_cryptodisk_plain_line *line, **prev;
+
+  prev = &dev->plain_cache;
+  while ((line = *prev) != NULL)
+    {
+      if (line->sector < sector + size
+	  && sector < line->sector + line->nsectors)
+	{
+	  *prev = line->next;
+	  dev->plain_cache_bytes -= line->nsectors << dev->log_sector_size;
+	  grub_free (line->data);
+	  grub_free (line);
+	}
+      else
+	prev = &line->next;
+    }
+}
+
 static inline int GF_PER_SECTOR (const struct grub_cryptodisk *dev)
 {
   return 1U << (dev->log_sector_size - GRUB_CRYPTODISK_GF_LOG_BYTES);
@@ -57,18 +179,19 @@ static grub_uint8_t last_cryptodisk_id = 0;
 static void
 gf_mul_x (grub_uint8_t *g)
 {
-  int over = 0, over2 = 0;
-  unsigned j;
-
-  for (j = 0; j < GRUB_CRYPTODISK_GF_BYTES; j++)
-    {
-      over2 = !!(g[j] & 0x80);
-      g[j] <<= 1;
-      g[j] |= over;
-      over = over2;
-    }
-  if (over)
-    g[0] ^= GF_POLYNOM;
+  grub_uint64_t lo, hi;
+
+  COMPILE_TIME_ASSERT (GRUB_CRYPTODISK_GF_BYTES
+		       == 2 * sizeof (grub_uint64_t));
+
+  /* The array is a 128-bit little-endian number; double it, folding
+     the polynomial back in when the top bit falls out.  */
+  lo = grub_le_to_cpu64 (grub_get_unaligned64 (g));
+  hi = grub_le_to_cpu64 (grub_get_unaligned64 (g + sizeof (grub_uint64_t)));
+  grub_set_unaligned64 (g, grub_cpu_to_le64 ((lo << 1)
+					     ^ ((hi >> 63) ? GF_POLYNOM : 0)));
+  grub_set_unaligned64 (g + sizeof (grub_uint64_t),
+			grub_cpu_to_le64 ((hi << 1) | (lo >> 63)));
 }
 
 
@@ -345,30 +468,39 @@ grub_cryptodisk_endecrypt (struct grub_cryptodisk *dev,
 	  break;
 	case GRUB_CRYPTODISK_MODE_XTS:
 	  {
-	    unsigned j;
+	    unsigned j, bs = dev->cipher->cipher->blocksize;
+	    /* Expanding the tweaks for eight blocks at a time lets a
+	       single ECB call and two wide xors cover all of them,
+	       instead of paying the mode-call overhead per block.  */
+	    grub_uint8_t tw[8 * GRUB_CRYPTO_MAX_CIPHER_BLOCKSIZE];
+
 	    err = grub_crypto_ecb_encrypt (dev->secondary_cipher, iv, iv,
-					   dev->cipher->cipher->blocksize);
+					   bs);
 	    if (err)
 	      return err;
-	    
-	    for (j = 0; j < (1U << log_sector_size);
-		 j += dev->cipher->cipher->blocksize)
+
+	    for (j = 0; j < (1U << log_sector_size); j += sizeof (tw))
 	      {
-		grub_crypto_xor (data + i + j, data + i + j, iv,
-				 dev->cipher->cipher->blocksize);
+		unsigned n, chunk;
+
+		chunk = sizeof (tw);
+		if (chunk > (1U << log_sector_size) - j)
+		  chunk = (1U << log_sector_size) - j;
+		for (n = 0; n < chunk; n += bs)
+		  {
+		    grub_memcpy (tw + n, iv, bs);
+		    gf_mul_x ((grub_uint8_t *) iv);
+		  }
+		grub_crypto_xor (data + i + j, data + i + j, tw, chunk);
 		if (do_encrypt)
-		  err = grub_crypto_ecb_encrypt (dev->cipher, data + i + j, 
-						 data + i + j,
-						 dev->cipher->cipher->blocksize);
+		  err = grub_crypto_ecb_encrypt (dev->cipher, data + i + j,
+						 data + i + j, chunk);
 		else
-		  err = grub_crypto_ecb_decrypt (dev->cipher, data + i + j, 
-						 data + i + j,
-						 dev->cipher->cipher->blocksize);
+		  err = grub_crypto_ecb_decrypt (dev->cipher, data + i + j,
+						 data + i + j, chunk);
 		if (err)
 		  return err;
-		grub_crypto_xor (data + i + j, data + i + j, iv,
-				 dev->cipher->cipher->blocksize);
-		gf_mul_x ((grub_uint8_t *) iv);
+		grub_crypto_xor (data + i + j, data + i + j, tw, chunk);
 	      }
 	  }
 	  break;
@@ -752,6 +884,7 @@ grub_cryptodisk_read (grub_disk_t disk, grub_disk_addr_t sector,
   grub_cryptodisk_t dev = (grub_cryptodisk_t) disk->data;
   grub_err_t err;
   gcry_err_code_t gcry_err;
+  grub_size_t chunk;
 
 #ifdef GRUB_UTIL
   if (dev->cheat)
@@ -774,6 +907,50 @@ grub_cryptodisk_read (grub_disk_t disk, grub_disk_addr_t sector,
 		PRIxGRUB_UINT64_T " with offset of %" PRIuGRUB_UINT64_T "\n",
 		size, sector, dev->offset_sectors);
 
+  if (plain_cache_fetch (dev, sector, size, buf))
+    return GRUB_ERR_NONE;
+
+  /* Pipeline large reads: process them in chunks with sequential
+     readahead enabled on the source disk, so the disk layer fetches
+     ahead of the decryption loop instead of transferring the whole
+     region before the first cipher block is touched.  */
+  chunk = GRUB_CRYPTODISK_PIPELINE_BYTES >> disk->log_sector_size;
+  if (chunk != 0 && size > 2 * chunk)
+    {
+      grub_size_t done, n;
+
+      grub_disk_set_readahead (dev->source_disk, GRUB_DISK_READAHEAD_ON);
+      for (done = 0; done < size; done += n)
+	{
+	  n = size - done;
+	  if (n > chunk)
+	    n = chunk;
+	  err = grub_disk_read (dev->source_disk,
+				grub_disk_from_native_sector (disk, sector + done
+							      + dev->offset_sectors),
+				0, n << disk->log_sector_size,
+				buf + (done << disk->log_sector_size));
+	  if (err)
+	    break;
+	  gcry_err = grub_cryptodisk_endecrypt (dev,
+						(grub_uint8_t *) buf
+						+ (done << disk->log_sector_size),
+						n << disk->log_sector_size,
+						sector + done,
+						dev->log_sector_size, 0);
+	  if (gcry_err)
+	    {
+	      grub_disk_set_readahead (dev->source_disk, GRUB_DISK_READAHEAD_OFF);
+	      return grub_crypto_gcry_error (gcry_err);
+	    }
+	}
+      grub_disk_set_readahead (dev->source_disk, GRUB_DISK_READAHEAD_OFF);
+      if (err)
+	grub_dprintf ("cryptodisk", "grub_disk_read failed with error %d\n",
+		      err);
+      return err;
+    }
+
   err = grub_disk_read (dev->source_disk,
 			grub_disk_from_native_sector (disk, sector + dev->offset_sectors),
 			0, size << disk->log_sector_size, buf);
@@ -785,6 +962,8 @@ grub_cryptodisk_read (grub_disk_t disk, grub_disk_addr_t sector,
   gcry_err = grub_cryptodisk_endecrypt (dev, (grub_uint8_t *) buf,
 					size << disk->log_sector_size,
 					sector, dev->log_sector_size, 0);
+  if (gcry_err == GPG_ERR_NO_ERROR)
+    plain_cache_store (dev, sector, size, buf);
   return grub_crypto_gcry_error (gcry_err);
 }
 
@@ -832,6 +1011,8 @@ grub_cryptodisk_write (grub_disk_t disk, grub_disk_addr_t sector,
       return grub_crypto_gcry_error (gcry_err);
     }
 
+  plain_cache_invalidate (dev, sector, size);
+
   /* Since ->write was called so disk.mod is loaded but be paranoid  */
   sector = sector + dev->offset_sectors;
   if (grub_disk_write_weak)
@@ -899,6 +1080,7 @@ grub_cryptodisk_insert (grub_cryptodisk_t newdev, const char *name,
   newdev->partition_start = grub_partition_get_start (source->partition);
   newdev->next = cryptodisk_list;
   cryptodisk_list = newdev;
+  grub_disk_dev_generation_bump ();
 
   return GRUB_ERR_NONE;
 }
@@ -946,6 +1128,7 @@ grub_cryptodisk_cheat_insert (grub_cryptodisk_t newdev, const char *name,
   newdev->id = last_cryptodisk_id++;
   newdev->next = cryptodisk_list;
   cryptodisk_list = newdev;
+  grub_disk_dev_generation_bump ();
 
   return GRUB_ERR_NONE;
 }
@@ -152,6 +152,50 @@ scan_disk_partition_iter (grub_disk_t disk, grub_partition_t p, void *data)
 	  return 0;
     }
 
+  /* Every detector inspects only the first sectors (LVM labels, mdraid
+     1.1/1.2 superblocks) and the last 128KiB (mdraid 0.9/1.0, dmraid,
+     LDM) of the device.  Pull those regions into the sector cache with
+     a few large reads, so the detectors' own small reads are served
+     from the cache instead of each issuing separate device commands.
+     Failures are ignored here; the detectors read and report for
+     themselves.  */
+  {
+    char *warm_buf;
+
+    warm_buf = grub_malloc (2 << (GRUB_DISK_CACHE_BITS
+				  + GRUB_DISK_SECTOR_BITS));
+    if (warm_buf)
+      {
+	grub_uint64_t nsectors;
+
+	grub_disk_read (disk, 0, 0,
+			GRUB_DISK_CACHE_SIZE << GRUB_DISK_SECTOR_BITS,
+			warm_buf);
+	grub_errno = GRUB_ERR_NONE;
+
+	nsectors = grub_disk_native_sectors (disk);
+	if (nsectors != GRUB_DISK_SIZE_UNKNOWN
+	    && nsectors > 4 * GRUB_DISK_CACHE_SIZE)
+	  {
+	    grub_disk_addr_t tail;
+
+	    tail = (nsectors & ~((grub_uint64_t) GRUB_DISK_CACHE_SIZE - 1))
+	      - 3 * GRUB_DISK_CACHE_SIZE;
+	    grub_disk_read (disk, tail, 0,
+			    2 << (GRUB_DISK_CACHE_BITS
+				  + GRUB_DISK_SECTOR_BITS), warm_buf);
+	    grub_errno = GRUB_ERR_NONE;
+	    grub_disk_read (disk, tail + 2 * GRUB_DISK_CACHE_SIZE, 0,
+			    (grub_size_t) (nsectors - tail
+					   - 2 * GRUB_DISK_CACHE_SIZE)
+			    << GRUB_DISK_SECTOR_BITS, warm_buf);
+	    grub_errno = GRUB_ERR_NONE;
+	  }
+	grub_free (warm_buf);
+      }
+    grub_errno = GRUB_ERR_NONE;
+  }
+
   for (diskfilter = grub_diskfilter_list; diskfilter; diskfilter = diskfilter->next)
     {
 #ifdef GRUB_UTIL
@@ -160,6 +204,7 @@ scan_disk_partition_iter (grub_disk_t disk, grub_partition_t p, void *data)
 #endif
       id.uuid = 0;
       id.uuidlen = 0;
+      id.recovery_offset = 0;
       arr = diskfilter->detect (disk, &id, &start_sector);
       if (arr &&
 	  (! insert_array (disk, &id, arr, start_sector, diskfilter)))
@@ -473,6 +518,14 @@ grub_diskfilter_read_node (const struct grub_diskfilter_node *node,
      read from.  */
   if (node->pv)
     {
+      /* A member under rebuild holds stale data past its recovered
+	 point.  Refuse such reads like a medium error, so the mirror
+	 and parity fallbacks move on to an in-sync member.  */
+      if (node->pv->recovery_offset
+	  && sector + node->start + size > node->pv->recovery_offset)
+	return grub_error (GRUB_ERR_READ_ERROR,
+			   N_("physical volume %s is still being rebuilt"),
+			   node->pv->name ? : "?");
       if (node->pv->disk)
 	return grub_disk_read (node->pv->disk, sector + node->start
 			       + node->pv->start_sector,
@@ -577,6 +630,73 @@ validate_segment (struct grub_diskfilter_segment *seg)
 
 }
 
+/* Read a striped (RAID0) segment with one call per member.
+   Consecutive stripes held by one member are contiguous on it, so the
+   member's whole share of the request can be fetched at once and
+   scattered into place, letting the underlying disk see a large
+   sequential read instead of stripe-sized pieces.  */
+static grub_err_t
+read_segment_striped (struct grub_diskfilter_segment *seg,
+		      grub_disk_addr_t sector, grub_size_t size, char *buf)
+{
+  char *bounce;
+  grub_uint64_t stripe_first, stripe_last;
+  grub_uint64_t b_first, b_last, max_count;
+  unsigned m;
+  grub_err_t err = GRUB_ERR_NONE;
+
+  stripe_first = grub_divmod64 (sector, seg->stripe_size, &b_first);
+  stripe_last = grub_divmod64 (sector + size - 1, seg->stripe_size, &b_last);
+
+  max_count = grub_divmod64 (stripe_last - stripe_first,
+			     seg->node_count, 0) + 1;
+  bounce = grub_malloc ((max_count * seg->stripe_size)
+			<< GRUB_DISK_SECTOR_BITS);
+  if (!bounce)
+    return grub_errno;
+
+  for (m = 0; m < seg->node_count; m++)
+    {
+      grub_uint64_t st, row, d, count, len, i;
+
+      /* First stripe at or after stripe_first held by member M.  */
+      grub_divmod64 (stripe_first, seg->node_count, &d);
+      st = stripe_first + ((m + seg->node_count - (unsigned) d)
+			   % seg->node_count);
+      if (st > stripe_last)
+	continue;
+      row = grub_divmod64 (st, seg->node_count, 0);
+      count = grub_divmod64 (stripe_last - st, seg->node_count, 0) + 1;
+
+      /* Trim the member read if its last stripe ends the request.  */
+      len = count * seg->stripe_size;
+      if (st + (count - 1) * seg->node_count == stripe_last)
+	len -= seg->stripe_size - (b_last + 1);
+
+      err = grub_diskfilter_read_node (&seg->nodes[m],
+				       row * seg->stripe_size, len, bounce);
+      if (err)
+	break;
+
+      for (i = 0; i < count; i++)
+	{
+	  grub_uint64_t st_i = st + i * seg->node_count;
+	  grub_uint64_t start = (st_i == stripe_first) ? b_first : 0;
+	  grub_uint64_t end = (st_i == stripe_last)
+	    ? b_last + 1 : seg->stripe_size;
+
+	  grub_memcpy (buf + ((st_i * seg->stripe_size + start - sector)
+			      << GRUB_DISK_SECTOR_BITS),
+		       bounce + ((i * seg->stripe_size + start)
+				 << GRUB_DISK_SECTOR_BITS),
+		       (end - start) << GRUB_DISK_SECTOR_BITS);
+	}
+    }
+
+  grub_free (bounce);
+  return err;
+}
+
 static grub_err_t
 read_segment (struct grub_diskfilter_segment *seg, grub_disk_addr_t sector,
 	      grub_size_t size, char *buf)
@@ -588,6 +708,9 @@ read_segment (struct grub_diskfilter_segment *seg, grub_disk_addr_t sector,
       if (seg->node_count == 1)
 	return grub_diskfilter_read_node (&seg->nodes[0],
 					  sector, size, buf);
+      /* Batch big requests; small ones aren't worth the bounce copy.  */
+      if (size >= (grub_uint64_t) seg->stripe_size * seg->node_count)
+	return read_segment_striped (seg, sector, size, buf);
       /* Fallthrough.  */
     case GRUB_DISKFILTER_MIRROR:
     case GRUB_DISKFILTER_RAID10:
@@ -873,15 +996,53 @@ read_lv (struct grub_diskfilter_lv *lv, grub_disk_addr_t sector,
       /* Find the right segment.  */
       {
 	unsigned int i;
-	for (i = 0; i < lv->segment_count; i++)
+
+	if (lv->segment_count == 0)
+	  return grub_error (GRUB_ERR_READ_ERROR, "incorrect segment");
+
+	/* Metadata normally lists segments in extent order; check once
+	   so that later lookups can bisect instead of scanning.  */
+	if (lv->segments_sorted == 0)
 	  {
-	    if ((seg->start_extent <= extent)
-		&& ((seg->start_extent + seg->extent_count) > extent))
-	      break;
-	    seg++;
+	    lv->segments_sorted = 1;
+	    for (i = 1; i < lv->segment_count; i++)
+	      if (lv->segments[i - 1].start_extent
+		  > lv->segments[i].start_extent)
+		{
+		  lv->segments_sorted = -1;
+		  break;
+		}
+	  }
+
+	if (lv->segments_sorted > 0)
+	  {
+	    unsigned int lo = 0, hi = lv->segment_count;
+
+	    while (hi - lo > 1)
+	      {
+		i = lo + (hi - lo) / 2;
+		if (lv->segments[i].start_extent <= extent)
+		  lo = i;
+		else
+		  hi = i;
+	      }
+	    seg = lv->segments + lo;
+	    if (! ((seg->start_extent <= extent)
+		   && ((seg->start_extent + seg->extent_count) > extent)))
+	      return grub_error (GRUB_ERR_READ_ERROR, "incorrect segment");
+	  }
+	else
+	  {
+	    for (i = 0; i < lv->segment_count; i++)
+	      {
+		if ((seg->start_extent <= extent)
+		    && ((seg->start_extent + seg->extent_count) > extent))
+		  break;
+		seg++;
+	      }
+	    if (i == lv->segment_count)
+	      return grub_error (GRUB_ERR_READ_ERROR, "incorrect segment");
 	  }
-	if (i == lv->segment_count)
-	  return grub_error (GRUB_ERR_READ_ERROR, "incorrect segment");
       }
       to_read = ((seg->start_extent + seg->extent_count)
 		 * vg->extent_size) - sector;
@@ -1240,6 +1401,7 @@ insert_array (grub_disk_t disk, const struct grub_diskfilter_pv_id *id,
 	if (start_sector != (grub_uint64_t)-1)
 	  pv->start_sector = start_sector;
 	pv->start_sector += pv->part_start;
+	pv->recovery_offset = id->recovery_offset;
 	/* Add the device to the array. */
 	for (lv = array->lvs; lv; lv = lv->next)
 	  if (!lv->became_readable_at && lv->fullname && is_lv_readable (lv, 0))
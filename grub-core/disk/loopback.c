@@ -25,6 +25,7 @@
 #include <grub/mm.h>
 #include <grub/extcmd.h>
 #include <grub/i18n.h>
+#include <grub/partition.h>
 
 GRUB_MOD_LICENSE ("GPLv3+");
 
@@ -58,14 +59,128 @@ delete_loopback (const char *name)
 
   /* Remove the device from the list.  */
   *prev = dev->next;
+  grub_disk_dev_generation_bump ();
 
   grub_free (dev->devname);
+  grub_free (dev->blockmap);
   grub_file_close (dev->file);
   grub_free (dev);
 
   return 0;
 }
 
+/* Context for grub_loopback_make_blockmap.  */
+struct blockmap_ctx
+{
+  struct grub_loopback_extent *extents;
+  grub_size_t nextents;
+  grub_size_t nalloc;
+  grub_off_t file_ofs;
+  grub_disk_addr_t part_start;
+  int dead;
+};
+
+/* Helper for grub_loopback_make_blockmap.  Record where the bytes just
+   read from the backing disk sit, merging runs that are contiguous both
+   in the file and on the disk.  */
+static void
+record_extent (grub_disk_addr_t sector, unsigned offset, unsigned length,
+	       void *data)
+{
+  struct blockmap_ctx *ctx = data;
+  grub_uint64_t disk_ofs;
+  struct grub_loopback_extent *ext;
+
+  if (ctx->dead || sector < ctx->part_start)
+    {
+      ctx->dead = 1;
+      return;
+    }
+
+  disk_ofs = ((sector - ctx->part_start) << GRUB_DISK_SECTOR_BITS) + offset;
+
+  if (ctx->nextents)
+    {
+      ext = &ctx->extents[ctx->nextents - 1];
+      if (ext->disk_ofs + ext->len == disk_ofs)
+	{
+	  ext->len += length;
+	  ctx->file_ofs += length;
+	  return;
+	}
+    }
+
+  if (ctx->nextents == ctx->nalloc)
+    {
+      grub_size_t nalloc = ctx->nalloc ? 2 * ctx->nalloc : 16;
+      ext = grub_realloc (ctx->extents, nalloc * sizeof (*ext));
+      if (!ext)
+	{
+	  grub_errno = GRUB_ERR_NONE;
+	  ctx->dead = 1;
+	  return;
+	}
+      ctx->extents = ext;
+      ctx->nalloc = nalloc;
+    }
+
+  ext = &ctx->extents[ctx->nextents++];
+  ext->file_ofs = ctx->file_ofs;
+  ext->disk_ofs = disk_ofs;
+  ext->len = length;
+  ctx->file_ofs += length;
+}
+
+/* Take a snapshot of DEV's backing file block map so that reads can go
+   straight to the backing disk, the same way blocklists do.  The file is
+   read through once with a read hook attached; the map is kept only if
+   the recorded runs cover every byte of the file in order, which rules
+   out filesystems that transform data or fill holes without a disk
+   read.  Failure only means reads keep going through the backing
+   filesystem.  */
+static void
+grub_loopback_make_blockmap (struct grub_loopback *dev)
+{
+  grub_file_t file = dev->file;
+  struct blockmap_ctx ctx = { 0, 0, 0, 0, 0, 0 };
+  char *buf;
+
+  if (!file->device || !file->device->disk
+      || file->size == GRUB_FILE_SIZE_UNKNOWN)
+    return;
+
+  buf = grub_malloc (GRUB_DISK_SECTOR_SIZE << 6);
+  if (!buf)
+    {
+      grub_errno = GRUB_ERR_NONE;
+      return;
+    }
+
+  if (file->device->disk->partition)
+    ctx.part_start = grub_partition_get_start (file->device->disk->partition);
+
+  file->read_hook = record_extent;
+  file->read_hook_data = &ctx;
+  while (grub_file_read (file, buf, GRUB_DISK_SECTOR_SIZE << 6) > 0
+	 && !ctx.dead)
+    ;
+  file->read_hook = 0;
+  file->read_hook_data = 0;
+  grub_file_seek (file, 0);
+  grub_free (buf);
+
+  if (grub_errno != GRUB_ERR_NONE || ctx.dead
+      || ctx.file_ofs != file->size)
+    {
+      grub_errno = GRUB_ERR_NONE;
+      grub_free (ctx.extents);
+      return;
+    }
+
+  dev->blockmap = ctx.extents;
+  dev->nextents = ctx.nextents;
+}
+
 /* The command to add and remove loopback devices.  */
 static grub_err_t
 grub_cmd_loopback (grub_extcmd_context_t ctxt, int argc, char **args)
@@ -108,11 +223,16 @@ grub_cmd_loopback (grub_extcmd_context_t ctxt, int argc, char **args)
     }
 
   newdev->file = file;
+  newdev->blockmap = 0;
+  newdev->nextents = 0;
   newdev->id = last_id++;
 
+  grub_loopback_make_blockmap (newdev);
+
   /* Add the new entry to the list.  */
   newdev->next = loopback_list;
   loopback_list = newdev;
+  grub_disk_dev_generation_bump ();
 
   return 0;
 
@@ -167,13 +287,76 @@ grub_loopback_open (const char *name, grub_disk_t disk)
   return 0;
 }
 
+/* Serve a read from the block-map snapshot, translating loopback bytes
+   straight to backing-device bytes and bypassing the backing filesystem.  */
+static grub_err_t
+grub_loopback_read_mapped (struct grub_loopback *dev, grub_off_t pos,
+			   grub_size_t len, char *buf)
+{
+  grub_disk_t disk = dev->file->device->disk;
+  grub_size_t lo, hi;
+
+  while (len)
+    {
+      struct grub_loopback_extent *ext;
+      grub_uint64_t skip, chunk;
+
+      /* Find the extent containing POS.  */
+      lo = 0;
+      hi = dev->nextents;
+      while (hi - lo > 1)
+	{
+	  grub_size_t mid = (lo + hi) / 2;
+	  if (dev->blockmap[mid].file_ofs <= pos)
+	    lo = mid;
+	  else
+	    hi = mid;
+	}
+      ext = &dev->blockmap[lo];
+
+      skip = pos - ext->file_ofs;
+      chunk = ext->len - skip;
+      if (chunk > len)
+	chunk = len;
+
+      if (grub_disk_read (disk, (ext->disk_ofs + skip) >> GRUB_DISK_SECTOR_BITS,
+			  (ext->disk_ofs + skip) & (GRUB_DISK_SECTOR_SIZE - 1),
+			  chunk, buf))
+	return grub_errno;
+
+      pos += chunk;
+      buf += chunk;
+      len -= chunk;
+    }
+
+  return GRUB_ERR_NONE;
+}
+
 static grub_err_t
 grub_loopback_read (grub_disk_t disk, grub_disk_addr_t sector,
 		    grub_size_t size, char *buf)
 {
-  grub_file_t file = ((struct grub_loopback *) disk->data)->file;
+  struct grub_loopback *dev = disk->data;
+  grub_file_t file = dev->file;
   grub_off_t pos;
 
+  if (dev->blockmap)
+    {
+      grub_off_t start = sector << GRUB_DISK_SECTOR_BITS;
+      grub_size_t len = size << GRUB_DISK_SECTOR_BITS;
+
+      /* Zero-fill the tail past the end of files that are not a
+	 multiple of GRUB_DISK_SECTOR_SIZE.  */
+      if (start + len > file->size)
+	{
+	  grub_size_t amount = start + len - file->size;
+	  grub_memset (buf + len - amount, 0, amount);
+	  len -= amount;
+	}
+
+      return grub_loopback_read_mapped (dev, start, len, buf);
+    }
+
   grub_file_seek (file, sector << GRUB_DISK_SECTOR_BITS);
 
   grub_file_read (file, buf, size << GRUB_DISK_SECTOR_BITS);
@@ -24,6 +24,7 @@
 #include <grub/err.h>
 #include <grub/disk.h>
 #include <grub/crypto.h>
+#include <grub/argon2.h>
 #include <grub/partition.h>
 #include <grub/i18n.h>
 
@@ -40,6 +41,7 @@ GRUB_MOD_LICENSE ("GPLv3+");
 enum grub_luks2_kdf_type
 {
   LUKS2_KDF_TYPE_ARGON2I,
+  LUKS2_KDF_TYPE_ARGON2ID,
   LUKS2_KDF_TYPE_PBKDF2
 };
 typedef enum grub_luks2_kdf_type grub_luks2_kdf_type_t;
@@ -162,7 +164,8 @@ luks2_parse_keyslot (grub_luks2_keyslot_t *out, const grub_json_t *keyslot)
     return grub_error (GRUB_ERR_BAD_ARGUMENT, "Missing or invalid KDF");
   else if (!grub_strcmp (type, "argon2i") || !grub_strcmp (type, "argon2id"))
     {
-      out->kdf.type = LUKS2_KDF_TYPE_ARGON2I;
+      out->kdf.type = !grub_strcmp (type, "argon2i")
+		      ? LUKS2_KDF_TYPE_ARGON2I : LUKS2_KDF_TYPE_ARGON2ID;
       if (grub_json_getint64 (&out->kdf.u.argon2i.time, &kdf, "time") ||
 	  grub_json_getint64 (&out->kdf.u.argon2i.memory, &kdf, "memory") ||
 	  grub_json_getint64 (&out->kdf.u.argon2i.cpus, &kdf, "cpus"))
@@ -383,6 +386,41 @@ luks2_scan (grub_disk_t disk, const char *check_uuid, int check_boot)
   return cryptodisk;
 }
 
+/* One-entry cache of the parsed JSON area, keyed by device UUID, so
+   that passphrase retries don't re-read and re-parse the metadata.  */
+static struct
+{
+  char *uuid;
+  char *json_header;
+  grub_json_t *json;
+} luks2_cache;
+
+static void
+luks2_cache_clear (void)
+{
+  grub_free (luks2_cache.uuid);
+  grub_free (luks2_cache.json_header);
+  grub_json_free (luks2_cache.json);
+  luks2_cache.uuid = NULL;
+  luks2_cache.json_header = NULL;
+  luks2_cache.json = NULL;
+}
+
+/* Peek at a keyslot's priority without parsing the whole slot.
+   Missing priority means normal (1).  */
+static grub_int64_t
+luks2_keyslot_priority (const grub_json_t *keyslots, grub_size_t idx)
+{
+  grub_json_t keyslot;
+  grub_int64_t priority;
+
+  if (grub_json_getchild (&keyslot, keyslots, idx) ||
+      grub_json_getchild (&keyslot, &keyslot, 0) ||
+      grub_json_getint64 (&priority, &keyslot, "priority"))
+    priority = 1;
+  return priority;
+}
+
 static grub_err_t
 luks2_verify_key (grub_luks2_digest_t *d, grub_uint8_t *candidate_key,
 		  grub_size_t candidate_key_len)
@@ -445,8 +483,21 @@ luks2_decrypt_key (grub_uint8_t *out_key,
   switch (k->kdf.type)
     {
       case LUKS2_KDF_TYPE_ARGON2I:
-	ret = grub_error (GRUB_ERR_BAD_ARGUMENT, "Argon2 not supported");
-	goto err;
+      case LUKS2_KDF_TYPE_ARGON2ID:
+	gcry_ret = grub_argon2 (k->kdf.type == LUKS2_KDF_TYPE_ARGON2I
+				? GRUB_ARGON2I : GRUB_ARGON2ID,
+				k->kdf.u.argon2i.time,
+				k->kdf.u.argon2i.memory,
+				k->kdf.u.argon2i.cpus,
+				passphrase, passphraselen,
+				salt, saltlen,
+				area_key, k->area.key_size);
+	if (gcry_ret)
+	  {
+	    ret = grub_crypto_gcry_error (gcry_ret);
+	    goto err;
+	  }
+	break;
       case LUKS2_KDF_TYPE_PBKDF2:
 	hash = grub_crypto_lookup_md_by_name (k->kdf.u.pbkdf2.hash);
 	if (!hash)
@@ -548,6 +599,7 @@ luks2_recover_key (grub_disk_t source,
   char passphrase[MAX_PASSPHRASE], cipher[32];
   char *json_header = NULL, *part = NULL, *ptr;
   grub_size_t candidate_key_len = 0, json_idx, size;
+  grub_size_t *slot_order = NULL, order_idx, n_order = 0;
   grub_luks2_header_t header;
   grub_luks2_keyslot_t keyslot;
   grub_luks2_digest_t digest;
@@ -560,25 +612,44 @@ luks2_recover_key (grub_disk_t source,
   if (ret)
     return ret;
 
-  json_header = grub_zalloc (grub_be_to_cpu64 (header.hdr_size) - sizeof (header));
-  if (!json_header)
-      return GRUB_ERR_OUT_OF_MEMORY;
+  if (luks2_cache.uuid != NULL
+      && grub_strcmp (luks2_cache.uuid, crypt->uuid) == 0)
+    json = luks2_cache.json;
+  else
+    {
+      luks2_cache_clear ();
 
-  /* Read the JSON area. */
-  ret = grub_disk_read (source, 0, grub_be_to_cpu64 (header.hdr_offset) + sizeof (header),
-			grub_be_to_cpu64 (header.hdr_size) - sizeof (header), json_header);
-  if (ret)
-      goto err;
+      json_header = grub_zalloc (grub_be_to_cpu64 (header.hdr_size) - sizeof (header));
+      if (!json_header)
+	  return GRUB_ERR_OUT_OF_MEMORY;
 
-  ptr = grub_memchr (json_header, 0, grub_be_to_cpu64 (header.hdr_size) - sizeof (header));
-  if (!ptr)
-    goto err;
+      /* Read the JSON area. */
+      ret = grub_disk_read (source, 0, grub_be_to_cpu64 (header.hdr_offset) + sizeof (header),
+			    grub_be_to_cpu64 (header.hdr_size) - sizeof (header), json_header);
+      if (ret)
+	  goto err;
 
-  ret = grub_json_parse (&json, json_header, grub_be_to_cpu64 (header.hdr_size));
-  if (ret)
-    {
-      ret = grub_error (GRUB_ERR_BAD_ARGUMENT, "Invalid LUKS2 JSON header");
-      goto err;
+      ptr = grub_memchr (json_header, 0, grub_be_to_cpu64 (header.hdr_size) - sizeof (header));
+      if (!ptr)
+	goto err;
+
+      ret = grub_json_parse (&json, json_header, grub_be_to_cpu64 (header.hdr_size));
+      if (ret)
+	{
+	  ret = grub_error (GRUB_ERR_BAD_ARGUMENT, "Invalid LUKS2 JSON header");
+	  goto err;
+	}
+
+      /* Hand the parsed area over to the cache; caching is optional,
+	 so an allocation failure just leaves this call uncached.  */
+      luks2_cache.uuid = grub_strdup (crypt->uuid);
+      if (luks2_cache.uuid == NULL)
+	grub_errno = GRUB_ERR_NONE;
+      else
+	{
+	  luks2_cache.json_header = json_header;
+	  luks2_cache.json = json;
+	}
     }
 
   /* Get the passphrase from the user. */
@@ -609,12 +680,27 @@ luks2_recover_key (grub_disk_t source,
       goto err;
     }
 
-  /* Try all keyslot */
+  /* Visit high-priority (2) keyslots before normal ones.  */
+  slot_order = grub_calloc (size, sizeof (*slot_order));
+  if (!slot_order)
+    {
+      ret = GRUB_ERR_OUT_OF_MEMORY;
+      goto err;
+    }
+  for (json_idx = 0; json_idx < size; json_idx++)
+    if (luks2_keyslot_priority (&keyslots, json_idx) >= 2)
+      slot_order[n_order++] = json_idx;
   for (json_idx = 0; json_idx < size; json_idx++)
+    if (luks2_keyslot_priority (&keyslots, json_idx) < 2)
+      slot_order[n_order++] = json_idx;
+
+  /* Try all keyslot */
+  for (order_idx = 0; order_idx < n_order; order_idx++)
     {
       char indexstr[21]; /* log10(2^64) ~ 20, plus NUL character. */
       typeof (source->total_sectors) max_crypt_sectors = 0;
 
+      json_idx = slot_order[order_idx];
       grub_errno = GRUB_ERR_NONE;
       ret = luks2_get_keyslot (&keyslot, &digest, &segment, json, json_idx);
       if (ret)
@@ -753,7 +839,10 @@ luks2_recover_key (grub_disk_t source,
   grub_strncpy (cipher, segment.encryption, sizeof (cipher));
   ptr = grub_memchr (cipher, '-', grub_strlen (cipher));
   if (!ptr)
-      return grub_error (GRUB_ERR_BAD_ARGUMENT, "Invalid encryption");
+    {
+      ret = grub_error (GRUB_ERR_BAD_ARGUMENT, "Invalid encryption");
+      goto err;
+    }
   *ptr = '\0';
 
   ret = grub_cryptodisk_setcipher (crypt, cipher, ptr + 1);
@@ -770,8 +859,12 @@ luks2_recover_key (grub_disk_t source,
 
  err:
   grub_free (part);
-  grub_free (json_header);
-  grub_json_free (json);
+  grub_free (slot_order);
+  /* Don't tear down what the cache now owns.  */
+  if (json_header != luks2_cache.json_header)
+    grub_free (json_header);
+  if (json != NULL && json != luks2_cache.json)
+    grub_json_free (json);
   return ret;
 }
 
@@ -787,5 +880,6 @@ GRUB_MOD_INIT (luks2)
 
 GRUB_MOD_FINI (luks2)
 {
+  luks2_cache_clear ();
   grub_cryptodisk_dev_unregister (&luks2_crypto);
 }
@@ -197,6 +197,13 @@ grub_mdraid_detect (grub_disk_t disk,
       id->uuidlen = 0;
       id->id = grub_le_to_cpu16 (role);
 
+      /* Feature map bit 1: this member is being rebuilt and only the
+	 data-area sectors below recovery_offset are valid.  A zero
+	 offset (nothing recovered yet) can't be told apart from "in
+	 sync" and keeps today's behaviour.  */
+      if (grub_le_to_cpu32 (sb.feature_map) & 0x2)
+	id->recovery_offset = grub_le_to_cpu64 (sb.recovery_offset);
+
       uuid = grub_malloc (16);
       if (!uuid)
 	return NULL;
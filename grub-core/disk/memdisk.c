@@ -73,6 +73,15 @@ grub_memdisk_write (grub_disk_t disk __attribute((unused)), grub_disk_addr_t sec
   return 0;
 }
 
+static const char *
+grub_memdisk_direct_ptr (grub_disk_t disk __attribute((unused)),
+			 grub_uint64_t addr, grub_size_t size)
+{
+  if (addr > memdisk_size || size > memdisk_size - addr)
+    return NULL;
+  return memdisk_addr + addr;
+}
+
 static struct grub_disk_dev grub_memdisk_dev =
   {
     .name = "memdisk",
@@ -82,6 +91,7 @@ static struct grub_disk_dev grub_memdisk_dev =
     .disk_close = grub_memdisk_close,
     .disk_read = grub_memdisk_read,
     .disk_write = grub_memdisk_write,
+    .disk_direct_ptr = grub_memdisk_direct_ptr,
     .next = 0
   };
 
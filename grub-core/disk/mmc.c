@@ -0,0 +1,830 @@
+/* mmc.c - SD/MMC support via SDHCI host controllers.  */
+/*
+ *  GRUB  --  GRand Unified Bootloader
+ *  Copyright (C) 2026  Free Software Foundation, Inc.
+ *
+ *  GRUB is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GRUB is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GRUB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <grub/dl.h>
+#include <grub/disk.h>
+#include <grub/mm.h>
+#include <grub/time.h>
+#include <grub/pci.h>
+#include <grub/misc.h>
+#include <grub/list.h>
+#include <grub/loader.h>
+
+GRUB_MOD_LICENSE ("GPLv3+");
+
+/* SDHCI register offsets.  */
+enum
+  {
+    GRUB_MMC_BLOCK_SIZE = 0x04,
+    GRUB_MMC_BLOCK_COUNT = 0x06,
+    GRUB_MMC_ARGUMENT = 0x08,
+    GRUB_MMC_XFER_MODE = 0x0c,
+    GRUB_MMC_COMMAND = 0x0e,
+    GRUB_MMC_RESPONSE = 0x10,
+    GRUB_MMC_PRESENT_STATE = 0x24,
+    GRUB_MMC_HOST_CONTROL = 0x28,
+    GRUB_MMC_POWER_CONTROL = 0x29,
+    GRUB_MMC_CLOCK_CONTROL = 0x2c,
+    GRUB_MMC_TIMEOUT_CONTROL = 0x2e,
+    GRUB_MMC_SW_RESET = 0x2f,
+    GRUB_MMC_INT_STATUS = 0x30,
+    GRUB_MMC_ERROR_STATUS = 0x32,
+    GRUB_MMC_INT_STATUS_ENABLE = 0x34,
+    GRUB_MMC_ERROR_STATUS_ENABLE = 0x36,
+    GRUB_MMC_INT_SIGNAL_ENABLE = 0x38,
+    GRUB_MMC_ERROR_SIGNAL_ENABLE = 0x3a,
+    GRUB_MMC_CAPABILITIES = 0x40,
+    GRUB_MMC_ADMA_ADDRESS = 0x58,
+    GRUB_MMC_ADMA_ADDRESS_HI = 0x5c,
+    GRUB_MMC_HOST_VERSION = 0xfe,
+  };
+
+enum
+  {
+    GRUB_MMC_PRESENT_CMD_INHIBIT = 0x00000001,
+    GRUB_MMC_PRESENT_DAT_INHIBIT = 0x00000002,
+    GRUB_MMC_PRESENT_CARD_INSERTED = 0x00010000,
+
+    GRUB_MMC_HCTRL_HIGH_SPEED = 0x04,
+    GRUB_MMC_HCTRL_4BIT = 0x02,
+    GRUB_MMC_HCTRL_8BIT = 0x20,
+    GRUB_MMC_HCTRL_ADMA2 = 0x10,
+
+    GRUB_MMC_CLOCK_INTERNAL_ENABLE = 0x0001,
+    GRUB_MMC_CLOCK_STABLE = 0x0002,
+    GRUB_MMC_CLOCK_CARD_ENABLE = 0x0004,
+
+    GRUB_MMC_RESET_ALL = 0x01,
+    GRUB_MMC_RESET_CMD = 0x02,
+    GRUB_MMC_RESET_DAT = 0x04,
+
+    GRUB_MMC_INT_CMD_COMPLETE = 0x0001,
+    GRUB_MMC_INT_XFER_COMPLETE = 0x0002,
+    GRUB_MMC_INT_ERROR = 0x8000,
+
+    GRUB_MMC_XFER_DMA = 0x0001,
+    GRUB_MMC_XFER_BLKCNT_ENABLE = 0x0002,
+    GRUB_MMC_XFER_AUTO_CMD12 = 0x0004,
+    GRUB_MMC_XFER_READ = 0x0010,
+    GRUB_MMC_XFER_MULTI = 0x0020,
+  };
+
+/* Response type field of the command register.  */
+enum
+  {
+    GRUB_MMC_RESP_NONE = 0x00,
+    GRUB_MMC_RESP_R1 = 0x1a,
+    GRUB_MMC_RESP_R1B = 0x1b,
+    GRUB_MMC_RESP_R2 = 0x09,
+    GRUB_MMC_RESP_R3 = 0x02,
+    GRUB_MMC_CMD_DATA = 0x20,
+  };
+
+/* Host controller specification version (register 0xfe, low byte).  */
+#define GRUB_MMC_HOST_V3 2
+
+/* ADMA2 32-bit descriptor.  */
+struct grub_mmc_adma_desc
+{
+  grub_uint16_t attr;
+  grub_uint16_t len;
+  grub_uint32_t addr;
+};
+
+enum
+  {
+    GRUB_MMC_ADMA_VALID = 0x0001,
+    GRUB_MMC_ADMA_END = 0x0002,
+    GRUB_MMC_ADMA_TRAN = 0x0020,
+  };
+
+/* Each descriptor carries up to 32 KiB so the 16-bit length field never
+   gets near its limit.  */
+#define GRUB_MMC_ADMA_CHUNK (32 * 1024)
+
+/* Maximum payload of one CMD18; with 512-byte blocks this stays well
+   under the 16-bit block count register.  */
+#define GRUB_MMC_MAX_READ (512 * 1024)
+
+#define GRUB_MMC_BLKSIZE 512
+
+struct grub_mmc_device
+{
+  struct grub_mmc_device *next;
+  struct grub_mmc_device **prev;
+  volatile grub_uint8_t *regs;
+  struct grub_pci_dma_chunk *adma_chunk;
+  grub_uint64_t nsectors;
+  grub_uint32_t rca;
+  /* Base clock of the host in Hz, from the capabilities register.  */
+  unsigned base_clock;
+  grub_uint8_t version;
+  int is_mmc;
+  /* High-capacity cards are addressed in blocks, older ones in bytes.  */
+  int high_capacity;
+  int num;
+  int present;
+};
+
+static struct grub_mmc_device *grub_mmc_devices;
+static int numdevs;
+
+static grub_uint32_t
+grub_mmc_read32 (struct grub_mmc_device *dev, grub_uint32_t ofs)
+{
+  return *(volatile grub_uint32_t *) (dev->regs + ofs);
+}
+
+static void
+grub_mmc_write32 (struct grub_mmc_device *dev, grub_uint32_t ofs,
+		  grub_uint32_t val)
+{
+  *(volatile grub_uint32_t *) (dev->regs + ofs) = val;
+}
+
+static grub_uint16_t
+grub_mmc_read16 (struct grub_mmc_device *dev, grub_uint32_t ofs)
+{
+  return *(volatile grub_uint16_t *) (dev->regs + ofs);
+}
+
+static void
+grub_mmc_write16 (struct grub_mmc_device *dev, grub_uint32_t ofs,
+		  grub_uint16_t val)
+{
+  *(volatile grub_uint16_t *) (dev->regs + ofs) = val;
+}
+
+static grub_uint8_t
+grub_mmc_read8 (struct grub_mmc_device *dev, grub_uint32_t ofs)
+{
+  return *(volatile grub_uint8_t *) (dev->regs + ofs);
+}
+
+static void
+grub_mmc_write8 (struct grub_mmc_device *dev, grub_uint32_t ofs,
+		 grub_uint8_t val)
+{
+  *(volatile grub_uint8_t *) (dev->regs + ofs) = val;
+}
+
+static grub_err_t
+grub_mmc_reset (struct grub_mmc_device *dev, grub_uint8_t mask)
+{
+  grub_uint64_t endtime;
+
+  grub_mmc_write8 (dev, GRUB_MMC_SW_RESET, mask);
+  endtime = grub_get_time_ms () + 100;
+  while (grub_mmc_read8 (dev, GRUB_MMC_SW_RESET) & mask)
+    if (grub_get_time_ms () > endtime)
+      return grub_error (GRUB_ERR_IO, "SDHCI reset timed out");
+  return GRUB_ERR_NONE;
+}
+
+static grub_err_t
+grub_mmc_set_clock (struct grub_mmc_device *dev, unsigned hz)
+{
+  grub_uint64_t endtime;
+  grub_uint16_t div = 0, val;
+
+  /* Stop the card clock while changing the divisor.  */
+  grub_mmc_write16 (dev, GRUB_MMC_CLOCK_CONTROL, 0);
+
+  if (dev->base_clock > hz)
+    {
+      if (dev->version >= GRUB_MMC_HOST_V3)
+	/* 10-bit divided clock: frequency is base / (2 * div).  */
+	div = (dev->base_clock + 2 * hz - 1) / (2 * hz);
+      else
+	/* Pre-3.0 hosts only divide by powers of two.  */
+	for (div = 1; div < 0x80 && dev->base_clock / (2 * div) > hz;)
+	  div <<= 1;
+      if (div > 0x3ff)
+	div = 0x3ff;
+    }
+
+  val = GRUB_MMC_CLOCK_INTERNAL_ENABLE
+    | ((div & 0xff) << 8) | (((div >> 8) & 0x3) << 6);
+  grub_mmc_write16 (dev, GRUB_MMC_CLOCK_CONTROL, val);
+
+  endtime = grub_get_time_ms () + 100;
+  while (!(grub_mmc_read16 (dev, GRUB_MMC_CLOCK_CONTROL)
+	   & GRUB_MMC_CLOCK_STABLE))
+    if (grub_get_time_ms () > endtime)
+      return grub_error (GRUB_ERR_IO, "SDHCI clock did not stabilize");
+
+  grub_mmc_write16 (dev, GRUB_MMC_CLOCK_CONTROL,
+		    val | GRUB_MMC_CLOCK_CARD_ENABLE);
+  return GRUB_ERR_NONE;
+}
+
+/* Issue command IDX with ARG and wait for command completion.  RESP, if
+   not NULL, receives one word for short responses and four for R2.  */
+static grub_err_t
+grub_mmc_command (struct grub_mmc_device *dev, grub_uint8_t idx,
+		  grub_uint32_t arg, grub_uint8_t flags, grub_uint32_t *resp)
+{
+  grub_uint64_t endtime;
+  grub_uint16_t status;
+  grub_uint32_t inhibit = GRUB_MMC_PRESENT_CMD_INHIBIT;
+
+  if ((flags & GRUB_MMC_CMD_DATA)
+      || (flags & 0x3) == (GRUB_MMC_RESP_R1B & 0x3))
+    inhibit |= GRUB_MMC_PRESENT_DAT_INHIBIT;
+
+  endtime = grub_get_time_ms () + 1000;
+  while (grub_mmc_read32 (dev, GRUB_MMC_PRESENT_STATE) & inhibit)
+    if (grub_get_time_ms () > endtime)
+      return grub_error (GRUB_ERR_IO, "SD/MMC bus stuck busy");
+
+  grub_mmc_write16 (dev, GRUB_MMC_INT_STATUS, 0xffff);
+  grub_mmc_write16 (dev, GRUB_MMC_ERROR_STATUS, 0xffff);
+
+  grub_mmc_write32 (dev, GRUB_MMC_ARGUMENT, arg);
+  grub_mmc_write16 (dev, GRUB_MMC_COMMAND, (idx << 8) | flags);
+
+  endtime = grub_get_time_ms () + 1000;
+  while (1)
+    {
+      status = grub_mmc_read16 (dev, GRUB_MMC_INT_STATUS);
+      if (status & GRUB_MMC_INT_ERROR)
+	{
+	  grub_mmc_reset (dev, GRUB_MMC_RESET_CMD | GRUB_MMC_RESET_DAT);
+	  return grub_error (GRUB_ERR_IO, "SD/MMC command %d failed (%x)",
+			     idx, grub_mmc_read16 (dev,
+						   GRUB_MMC_ERROR_STATUS));
+	}
+      if (status & GRUB_MMC_INT_CMD_COMPLETE)
+	break;
+      if (grub_get_time_ms () > endtime)
+	{
+	  grub_mmc_reset (dev, GRUB_MMC_RESET_CMD | GRUB_MMC_RESET_DAT);
+	  return grub_error (GRUB_ERR_IO, "SD/MMC command %d timed out", idx);
+	}
+    }
+  grub_mmc_write16 (dev, GRUB_MMC_INT_STATUS, GRUB_MMC_INT_CMD_COMPLETE);
+
+  if (resp)
+    {
+      resp[0] = grub_mmc_read32 (dev, GRUB_MMC_RESPONSE);
+      if ((flags & 0x3) == (GRUB_MMC_RESP_R2 & 0x3))
+	{
+	  resp[1] = grub_mmc_read32 (dev, GRUB_MMC_RESPONSE + 4);
+	  resp[2] = grub_mmc_read32 (dev, GRUB_MMC_RESPONSE + 8);
+	  resp[3] = grub_mmc_read32 (dev, GRUB_MMC_RESPONSE + 12);
+	}
+    }
+  return GRUB_ERR_NONE;
+}
+
+/* Issue data command IDX reading BLKCNT blocks of BLKSIZE bytes into the
+   contiguous bounce buffer BUFC through an ADMA2 descriptor chain.  */
+static grub_err_t
+grub_mmc_data_read (struct grub_mmc_device *dev, grub_uint8_t idx,
+		    grub_uint32_t arg, grub_uint16_t blksize,
+		    grub_uint16_t blkcnt, struct grub_pci_dma_chunk *bufc)
+{
+  volatile struct grub_mmc_adma_desc *desc
+    = grub_dma_get_virt (dev->adma_chunk);
+  grub_uint32_t phys = grub_dma_get_phys (bufc);
+  grub_size_t bytes = (grub_size_t) blksize * blkcnt;
+  grub_uint64_t endtime;
+  grub_uint16_t mode, status;
+  grub_err_t err;
+  unsigned i;
+
+  for (i = 0; bytes; i++)
+    {
+      grub_size_t cur = bytes > GRUB_MMC_ADMA_CHUNK
+	? GRUB_MMC_ADMA_CHUNK : bytes;
+
+      desc[i].addr = phys;
+      desc[i].len = cur;
+      desc[i].attr = GRUB_MMC_ADMA_VALID | GRUB_MMC_ADMA_TRAN;
+      phys += cur;
+      bytes -= cur;
+      if (!bytes)
+	desc[i].attr |= GRUB_MMC_ADMA_END;
+    }
+
+  grub_mmc_write32 (dev, GRUB_MMC_ADMA_ADDRESS,
+		    grub_dma_get_phys (dev->adma_chunk));
+  grub_mmc_write32 (dev, GRUB_MMC_ADMA_ADDRESS_HI, 0);
+  grub_mmc_write16 (dev, GRUB_MMC_BLOCK_SIZE, blksize);
+  grub_mmc_write16 (dev, GRUB_MMC_BLOCK_COUNT, blkcnt);
+
+  mode = GRUB_MMC_XFER_DMA | GRUB_MMC_XFER_BLKCNT_ENABLE
+    | GRUB_MMC_XFER_READ;
+  if (blkcnt > 1)
+    mode |= GRUB_MMC_XFER_MULTI | GRUB_MMC_XFER_AUTO_CMD12;
+  grub_mmc_write16 (dev, GRUB_MMC_XFER_MODE, mode);
+
+  err = grub_mmc_command (dev, idx, arg,
+			  GRUB_MMC_RESP_R1 | GRUB_MMC_CMD_DATA, NULL);
+  if (err)
+    return err;
+
+  endtime = grub_get_time_ms () + 2000;
+  while (1)
+    {
+      status = grub_mmc_read16 (dev, GRUB_MMC_INT_STATUS);
+      if (status & GRUB_MMC_INT_ERROR)
+	{
+	  grub_mmc_reset (dev, GRUB_MMC_RESET_CMD | GRUB_MMC_RESET_DAT);
+	  return grub_error (GRUB_ERR_IO, "SD/MMC transfer failed (%x)",
+			     grub_mmc_read16 (dev, GRUB_MMC_ERROR_STATUS));
+	}
+      if (status & GRUB_MMC_INT_XFER_COMPLETE)
+	break;
+      if (grub_get_time_ms () > endtime)
+	{
+	  grub_mmc_reset (dev, GRUB_MMC_RESET_CMD | GRUB_MMC_RESET_DAT);
+	  return grub_error (GRUB_ERR_IO, "SD/MMC transfer timed out");
+	}
+    }
+  grub_mmc_write16 (dev, GRUB_MMC_INT_STATUS, GRUB_MMC_INT_XFER_COMPLETE);
+  return GRUB_ERR_NONE;
+}
+
+/* Extract LEN bits starting at CSD bit START.  The response registers
+   hold CSD[127:8]; the CRC byte is stripped by the host.  */
+static grub_uint32_t
+grub_mmc_csd_bits (grub_uint32_t *resp, int start, int len)
+{
+  grub_uint64_t v;
+  int bit = start - 8;
+
+  v = resp[bit / 32] >> (bit % 32);
+  if (bit % 32 + len > 32)
+    v |= (grub_uint64_t) resp[bit / 32 + 1] << (32 - bit % 32);
+  return v & ((1ULL << len) - 1);
+}
+
+/* Take the card through identification to transfer state, widen the bus
+   and switch it into high-speed timing.  Used both at probe time and
+   when restoring hardware after a loader handoff was cancelled.  */
+static grub_err_t
+grub_mmc_init_card (struct grub_mmc_device *dev)
+{
+  grub_uint32_t caps, resp[4];
+  grub_uint64_t endtime;
+  grub_uint8_t power, hctrl;
+  unsigned clock;
+  grub_err_t err;
+  struct grub_pci_dma_chunk *bufc;
+
+  err = grub_mmc_reset (dev, GRUB_MMC_RESET_ALL);
+  if (err)
+    return err;
+
+  dev->version = grub_mmc_read8 (dev, GRUB_MMC_HOST_VERSION) & 0xff;
+  caps = grub_mmc_read32 (dev, GRUB_MMC_CAPABILITIES);
+  dev->base_clock = ((caps >> 8) & 0xff) * 1000000;
+  if (!dev->base_clock)
+    return grub_error (GRUB_ERR_IO, "SDHCI base clock unknown");
+
+  /* Status bits latch; signal (interrupt) lines stay off, we poll.  */
+  grub_mmc_write16 (dev, GRUB_MMC_INT_STATUS_ENABLE, 0xffff);
+  grub_mmc_write16 (dev, GRUB_MMC_ERROR_STATUS_ENABLE, 0xffff);
+  grub_mmc_write16 (dev, GRUB_MMC_INT_SIGNAL_ENABLE, 0);
+  grub_mmc_write16 (dev, GRUB_MMC_ERROR_SIGNAL_ENABLE, 0);
+
+  if (caps & (1 << 24))
+    power = 0x0e;			/* 3.3V */
+  else if (caps & (1 << 25))
+    power = 0x0c;			/* 3.0V */
+  else
+    power = 0x0a;			/* 1.8V */
+  grub_mmc_write8 (dev, GRUB_MMC_POWER_CONTROL, power);
+  grub_mmc_write8 (dev, GRUB_MMC_POWER_CONTROL, power | 1);
+  grub_millisleep (10);
+
+  grub_mmc_write8 (dev, GRUB_MMC_TIMEOUT_CONTROL, 0x0e);
+
+  /* Identification runs at 400 kHz.  */
+  err = grub_mmc_set_clock (dev, 400000);
+  if (err)
+    return err;
+  grub_millisleep (10);
+
+  /* CMD0: back to idle state.  */
+  err = grub_mmc_command (dev, 0, 0, GRUB_MMC_RESP_NONE, NULL);
+  if (err)
+    return err;
+
+  /* CMD8 voltage check succeeds on SD 2.0+ cards and times out on
+     eMMC; use that to tell the two init sequences apart.  */
+  dev->is_mmc = (grub_mmc_command (dev, 8, 0x1aa, GRUB_MMC_RESP_R1, resp)
+		 != GRUB_ERR_NONE);
+  grub_errno = GRUB_ERR_NONE;
+
+  endtime = grub_get_time_ms () + 1000;
+  while (1)
+    {
+      if (dev->is_mmc)
+	/* CMD1: query OCR, announce sector addressing support.  */
+	err = grub_mmc_command (dev, 1, 0x40ff8080, GRUB_MMC_RESP_R3, resp);
+      else
+	{
+	  /* ACMD41 with HCS set.  */
+	  err = grub_mmc_command (dev, 55, 0, GRUB_MMC_RESP_R1, NULL);
+	  if (!err)
+	    err = grub_mmc_command (dev, 41, 0x40ff8000, GRUB_MMC_RESP_R3,
+				    resp);
+	}
+      if (err)
+	return err;
+      if (resp[0] & 0x80000000)
+	break;
+      if (grub_get_time_ms () > endtime)
+	return grub_error (GRUB_ERR_IO, "SD/MMC card stuck in idle state");
+      grub_millisleep (10);
+    }
+  dev->high_capacity = !!(resp[0] & 0x40000000);
+
+  /* CMD2: ALL_SEND_CID.  */
+  err = grub_mmc_command (dev, 2, 0, GRUB_MMC_RESP_R2, resp);
+  if (err)
+    return err;
+
+  /* CMD3: the card sends its RCA (SD) or we assign one (eMMC).  */
+  if (dev->is_mmc)
+    {
+      dev->rca = 1;
+      err = grub_mmc_command (dev, 3, dev->rca << 16, GRUB_MMC_RESP_R1,
+			      NULL);
+    }
+  else
+    {
+      err = grub_mmc_command (dev, 3, 0, GRUB_MMC_RESP_R1, resp);
+      dev->rca = resp[0] >> 16;
+    }
+  if (err)
+    return err;
+
+  /* CMD9: capacity from the CSD, except for high-capacity eMMC where
+     only EXT_CSD (read below) has the real sector count.  */
+  err = grub_mmc_command (dev, 9, dev->rca << 16, GRUB_MMC_RESP_R2, resp);
+  if (err)
+    return err;
+  if (!dev->is_mmc && grub_mmc_csd_bits (resp, 126, 2) >= 1)
+    /* SD CSD version 2.0: fixed 512-byte blocks.  */
+    dev->nsectors = ((grub_uint64_t) grub_mmc_csd_bits (resp, 48, 22) + 1)
+      * 1024;
+  else
+    {
+      unsigned read_bl_len = grub_mmc_csd_bits (resp, 80, 4);
+      unsigned c_size = grub_mmc_csd_bits (resp, 62, 12);
+      unsigned c_size_mult = grub_mmc_csd_bits (resp, 47, 3);
+
+      dev->nsectors = ((grub_uint64_t) (c_size + 1)
+		       << (c_size_mult + 2 + read_bl_len))
+	>> GRUB_DISK_SECTOR_BITS;
+    }
+
+  /* CMD7: select the card, moving it to transfer state.  */
+  err = grub_mmc_command (dev, 7, dev->rca << 16, GRUB_MMC_RESP_R1B, NULL);
+  if (err)
+    return err;
+
+  if (!dev->high_capacity)
+    {
+      /* CMD16: fix the block length; high-capacity cards ignore it.  */
+      err = grub_mmc_command (dev, 16, GRUB_MMC_BLKSIZE, GRUB_MMC_RESP_R1,
+			      NULL);
+      if (err)
+	return err;
+    }
+
+  hctrl = GRUB_MMC_HCTRL_ADMA2;
+  clock = 25000000;
+
+  bufc = grub_memalign_dma32 (GRUB_MMC_BLKSIZE, GRUB_MMC_BLKSIZE);
+  if (!bufc)
+    return grub_errno;
+
+  if (dev->is_mmc)
+    {
+      /* EXT_CSD switches: HS_TIMING (byte 185) = 1, BUS_WIDTH (byte
+	 183) = 2 for 8-bit SDR.  HS200/HS400 would additionally need
+	 1.2V signaling and a per-board tuning procedure, so stay at
+	 high-speed (52 MHz) timing.  */
+      err = grub_mmc_command (dev, 6, (3 << 24) | (185 << 16) | (1 << 8),
+			      GRUB_MMC_RESP_R1B, NULL);
+      if (!err)
+	{
+	  clock = 52000000;
+	  hctrl |= GRUB_MMC_HCTRL_HIGH_SPEED;
+	}
+      else
+	grub_errno = GRUB_ERR_NONE;
+
+      err = grub_mmc_command (dev, 6, (3 << 24) | (183 << 16) | (2 << 8),
+			      GRUB_MMC_RESP_R1B, NULL);
+      if (!err)
+	hctrl |= GRUB_MMC_HCTRL_8BIT;
+      else
+	grub_errno = GRUB_ERR_NONE;
+
+      if (dev->high_capacity)
+	{
+	  /* CMD8 in transfer state: read EXT_CSD for SEC_COUNT.  */
+	  grub_mmc_write8 (dev, GRUB_MMC_HOST_CONTROL, hctrl);
+	  err = grub_mmc_data_read (dev, 8, 0, GRUB_MMC_BLKSIZE, 1, bufc);
+	  if (err)
+	    {
+	      grub_dma_free (bufc);
+	      return err;
+	    }
+	  dev->nsectors
+	    = grub_get_unaligned32 ((grub_uint8_t *)
+				    grub_dma_get_virt (bufc) + 212);
+	}
+    }
+  else
+    {
+      /* ACMD6: 4-bit bus.  */
+      err = grub_mmc_command (dev, 55, dev->rca << 16, GRUB_MMC_RESP_R1,
+			      NULL);
+      if (!err)
+	err = grub_mmc_command (dev, 6, 2, GRUB_MMC_RESP_R1, NULL);
+      if (!err)
+	hctrl |= GRUB_MMC_HCTRL_4BIT;
+      else
+	grub_errno = GRUB_ERR_NONE;
+
+      /* CMD6: switch function group 1 to high-speed; the 64-byte
+	 status block reports which function was actually selected.  */
+      grub_mmc_write8 (dev, GRUB_MMC_HOST_CONTROL, hctrl);
+      err = grub_mmc_data_read (dev, 6, 0x80fffff1, 64, 1, bufc);
+      if (!err
+	  && (((grub_uint8_t *) grub_dma_get_virt (bufc))[16] & 0xf) == 1)
+	{
+	  clock = 50000000;
+	  hctrl |= GRUB_MMC_HCTRL_HIGH_SPEED;
+	}
+      else
+	grub_errno = GRUB_ERR_NONE;
+    }
+
+  grub_dma_free (bufc);
+
+  grub_mmc_write8 (dev, GRUB_MMC_HOST_CONTROL, hctrl);
+  return grub_mmc_set_clock (dev, clock);
+}
+
+static int
+grub_mmc_pciinit (grub_pci_device_t dev,
+		  grub_pci_id_t pciid __attribute__ ((unused)),
+		  void *data __attribute__ ((unused)))
+{
+  struct grub_mmc_device *mdev;
+  grub_pci_address_t addr;
+  grub_uint32_t class;
+  grub_uint32_t bar;
+
+  /* Check if this class ID matches that of an SD host controller.  */
+  addr = grub_pci_make_address (dev, GRUB_PCI_REG_CLASS);
+  class = grub_pci_read (addr);
+  if (class >> 16 != 0x0805)
+    return 0;
+
+  addr = grub_pci_make_address (dev, GRUB_PCI_REG_ADDRESS_REG0);
+  bar = grub_pci_read (addr);
+  if ((bar & GRUB_PCI_ADDR_SPACE_MASK) != GRUB_PCI_ADDR_SPACE_MEMORY)
+    return 0;
+
+  addr = grub_pci_make_address (dev, GRUB_PCI_REG_COMMAND);
+  grub_pci_write_word (addr, grub_pci_read_word (addr)
+		       | GRUB_PCI_COMMAND_MEM_ENABLED
+		       | GRUB_PCI_COMMAND_BUS_MASTER);
+
+  mdev = grub_zalloc (sizeof (*mdev));
+  if (!mdev)
+    return 0;
+
+  mdev->regs = grub_pci_device_map_range (dev, bar & GRUB_PCI_ADDR_MEM_MASK,
+					  0x100);
+
+  if (!(grub_mmc_read32 (mdev, GRUB_MMC_PRESENT_STATE)
+	& GRUB_MMC_PRESENT_CARD_INSERTED))
+    {
+      grub_free (mdev);
+      return 0;
+    }
+
+  mdev->adma_chunk = grub_memalign_dma32 (GRUB_MMC_BLKSIZE, 4096);
+  if (!mdev->adma_chunk)
+    {
+      grub_errno = GRUB_ERR_NONE;
+      grub_free (mdev);
+      return 0;
+    }
+
+  if (grub_mmc_init_card (mdev) || !mdev->nsectors)
+    {
+      grub_errno = GRUB_ERR_NONE;
+      grub_dma_free (mdev->adma_chunk);
+      grub_free (mdev);
+      return 0;
+    }
+
+  mdev->present = 1;
+  mdev->num = numdevs++;
+  grub_dprintf ("mmc", "found device mmc%d (%s, %" PRIuGRUB_UINT64_T
+		" sectors)\n", mdev->num, mdev->is_mmc ? "eMMC" : "SD",
+		mdev->nsectors);
+
+  grub_list_push (GRUB_AS_LIST_P (&grub_mmc_devices),
+		  GRUB_AS_LIST (mdev));
+  return 0;
+}
+
+static grub_err_t
+grub_mmc_initialize (void)
+{
+  grub_pci_iterate (grub_mmc_pciinit, NULL);
+  return grub_errno;
+}
+
+static grub_err_t
+grub_mmc_fini_hw (int noreturn __attribute__ ((unused)))
+{
+  struct grub_mmc_device *dev;
+
+  FOR_LIST_ELEMENTS(dev, grub_mmc_devices)
+    grub_mmc_reset (dev, GRUB_MMC_RESET_ALL);
+  return GRUB_ERR_NONE;
+}
+
+static grub_err_t
+grub_mmc_restore_hw (void)
+{
+  struct grub_mmc_device *dev;
+
+  FOR_LIST_ELEMENTS(dev, grub_mmc_devices)
+    if (grub_mmc_init_card (dev))
+      dev->present = 0;
+  return grub_errno;
+}
+
+
+
+static int
+grub_mmc_iterate (grub_disk_dev_iterate_hook_t hook, void *hook_data,
+		  grub_disk_pull_t pull)
+{
+  struct grub_mmc_device *dev;
+  char name[16];
+
+  if (pull != GRUB_DISK_PULL_NONE)
+    return 0;
+
+  FOR_LIST_ELEMENTS(dev, grub_mmc_devices)
+    {
+      if (!dev->present)
+	continue;
+      grub_snprintf (name, sizeof (name), "mmc%d", dev->num);
+      if (hook (name, hook_data))
+	return 1;
+    }
+  return 0;
+}
+
+static grub_err_t
+grub_mmc_open (const char *name, grub_disk_t disk)
+{
+  struct grub_mmc_device *dev;
+  unsigned long num;
+  const char *p;
+
+  if (grub_strncmp (name, "mmc", 3) != 0)
+    return grub_error (GRUB_ERR_UNKNOWN_DEVICE, "not an SD/MMC device");
+  num = grub_strtoul (name + 3, &p, 10);
+  if (grub_errno || *p)
+    {
+      grub_errno = GRUB_ERR_NONE;
+      return grub_error (GRUB_ERR_UNKNOWN_DEVICE, "not an SD/MMC device");
+    }
+
+  FOR_LIST_ELEMENTS(dev, grub_mmc_devices)
+    if (dev->num == (int) num && dev->present)
+      break;
+
+  if (!dev)
+    return grub_error (GRUB_ERR_UNKNOWN_DEVICE, "no such SD/MMC device");
+
+  disk->total_sectors = dev->nsectors;
+  disk->log_sector_size = GRUB_DISK_SECTOR_BITS;
+  disk->max_agglomerate = GRUB_MMC_MAX_READ
+    >> (GRUB_DISK_SECTOR_BITS + GRUB_DISK_CACHE_BITS);
+  disk->id = dev->num;
+  disk->data = dev;
+
+  return GRUB_ERR_NONE;
+}
+
+static void
+grub_mmc_close (grub_disk_t disk __attribute__ ((unused)))
+{
+}
+
+static grub_err_t
+grub_mmc_read (grub_disk_t disk, grub_disk_addr_t sector,
+	       grub_size_t size, char *buf)
+{
+  struct grub_mmc_device *dev = disk->data;
+  struct grub_pci_dma_chunk *bufc;
+  grub_size_t max_sectors = GRUB_MMC_MAX_READ >> GRUB_DISK_SECTOR_BITS;
+  grub_err_t err = GRUB_ERR_NONE;
+
+  bufc = grub_memalign_dma32 (GRUB_MMC_BLKSIZE,
+			      (size > max_sectors ? max_sectors : size)
+			      << GRUB_DISK_SECTOR_BITS);
+  if (!bufc)
+    return grub_errno;
+
+  while (size && !err)
+    {
+      grub_size_t cur = size > max_sectors ? max_sectors : size;
+      /* CMD17/CMD18: single reads take a block address on
+	 high-capacity cards and a byte address on older ones.  */
+      grub_uint32_t arg = dev->high_capacity
+	? sector : sector << GRUB_DISK_SECTOR_BITS;
+
+      err = grub_mmc_data_read (dev, cur > 1 ? 18 : 17, arg,
+				GRUB_MMC_BLKSIZE, cur, bufc);
+      if (!err)
+	grub_memcpy (buf, (char *) grub_dma_get_virt (bufc),
+		     cur << GRUB_DISK_SECTOR_BITS);
+      sector += cur;
+      buf += cur << GRUB_DISK_SECTOR_BITS;
+      size -= cur;
+    }
+
+  grub_dma_free (bufc);
+  return err;
+}
+
+static grub_err_t
+grub_mmc_write (grub_disk_t disk __attribute__ ((unused)),
+		grub_disk_addr_t sector __attribute__ ((unused)),
+		grub_size_t size __attribute__ ((unused)),
+		const char *buf __attribute__ ((unused)))
+{
+  return grub_error (GRUB_ERR_NOT_IMPLEMENTED_YET,
+		     "SD/MMC writes are not implemented");
+}
+
+static struct grub_disk_dev grub_mmc_dev =
+  {
+    .name = "mmc",
+    .id = GRUB_DISK_DEVICE_MMC_ID,
+    .disk_iterate = grub_mmc_iterate,
+    .disk_open = grub_mmc_open,
+    .disk_close = grub_mmc_close,
+    .disk_read = grub_mmc_read,
+    .disk_write = grub_mmc_write,
+    .next = 0
+  };
+
+
+
+static struct grub_preboot *fini_hnd;
+
+GRUB_MOD_INIT(mmc)
+{
+  grub_stop_disk_firmware ();
+
+  grub_mmc_initialize ();
+
+  grub_disk_dev_register (&grub_mmc_dev);
+
+  fini_hnd = grub_loader_register_preboot_hook (grub_mmc_fini_hw,
+						grub_mmc_restore_hw,
+						GRUB_LOADER_PREBOOT_HOOK_PRIO_DISK);
+}
+
+GRUB_MOD_FINI(mmc)
+{
+  grub_mmc_fini_hw (0);
+  grub_loader_unregister_preboot_hook (fini_hnd);
+
+  grub_disk_dev_unregister (&grub_mmc_dev);
+}
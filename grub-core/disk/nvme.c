@@ -0,0 +1,634 @@
+/* nvme.c - NVMe support.  */
+/*
+ *  GRUB  --  GRand Unified Bootloader
+ *  Copyright (C) 2026  Free Software Foundation, Inc.
+ *
+ *  GRUB is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GRUB is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GRUB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <grub/dl.h>
+#include <grub/disk.h>
+#include <grub/mm.h>
+#include <grub/time.h>
+#include <grub/pci.h>
+#include <grub/misc.h>
+#include <grub/list.h>
+#include <grub/loader.h>
+
+GRUB_MOD_LICENSE ("GPLv3+");
+
+/* Controller registers (offsets into BAR0).  */
+struct grub_nvme_regs
+{
+  grub_uint32_t cap_lo;
+  grub_uint32_t cap_hi;
+  grub_uint32_t vs;
+  grub_uint32_t intms;
+  grub_uint32_t intmc;
+  grub_uint32_t cc;
+  grub_uint32_t unused1;
+  grub_uint32_t csts;
+  grub_uint32_t nssr;
+  grub_uint32_t aqa;
+  grub_uint32_t asq_lo;
+  grub_uint32_t asq_hi;
+  grub_uint32_t acq_lo;
+  grub_uint32_t acq_hi;
+};
+
+enum
+  {
+    GRUB_NVME_CC_EN = 0x00000001,
+    GRUB_NVME_CC_IOSQES = 6 << 16,
+    GRUB_NVME_CC_IOCQES = 4 << 20,
+    GRUB_NVME_CSTS_RDY = 0x00000001,
+    GRUB_NVME_CSTS_CFS = 0x00000002,
+  };
+
+enum
+  {
+    GRUB_NVME_ADMIN_DELETE_SQ = 0x00,
+    GRUB_NVME_ADMIN_CREATE_SQ = 0x01,
+    GRUB_NVME_ADMIN_DELETE_CQ = 0x04,
+    GRUB_NVME_ADMIN_CREATE_CQ = 0x05,
+    GRUB_NVME_ADMIN_IDENTIFY = 0x06,
+  };
+
+enum
+  {
+    GRUB_NVME_IO_READ = 0x02,
+  };
+
+/* 64B submission queue entry.  */
+struct grub_nvme_sqe
+{
+  grub_uint8_t opcode;
+  grub_uint8_t flags;
+  grub_uint16_t cid;
+  grub_uint32_t nsid;
+  grub_uint64_t rsvd2;
+  grub_uint64_t mptr;
+  grub_uint64_t prp1;
+  grub_uint64_t prp2;
+  grub_uint32_t cdw10;
+  grub_uint32_t cdw11;
+  grub_uint32_t cdw12;
+  grub_uint32_t cdw13;
+  grub_uint32_t cdw14;
+  grub_uint32_t cdw15;
+};
+
+/* 16B completion queue entry.  */
+struct grub_nvme_cqe
+{
+  grub_uint32_t result;
+  grub_uint32_t rsvd;
+  grub_uint16_t sq_head;
+  grub_uint16_t sq_id;
+  grub_uint16_t cid;
+  grub_uint16_t status;
+};
+
+#define GRUB_NVME_PAGE_SIZE 4096
+#define GRUB_NVME_PAGE_BITS 12
+
+/* Queue depth of both the admin and the I/O queue pair.  */
+#define GRUB_NVME_QUEUE_DEPTH 32
+
+/* Maximum payload of one READ command.  The bounce buffer is contiguous,
+   so a single PRP list page covers it with room to spare.  */
+#define GRUB_NVME_MAX_READ (128 * 1024)
+
+struct grub_nvme_queue
+{
+  struct grub_pci_dma_chunk *sq_chunk;
+  struct grub_pci_dma_chunk *cq_chunk;
+  volatile struct grub_nvme_sqe *sq;
+  volatile struct grub_nvme_cqe *cq;
+  unsigned sq_tail;
+  unsigned cq_head;
+  unsigned phase;
+  volatile grub_uint32_t *sq_doorbell;
+  volatile grub_uint32_t *cq_doorbell;
+};
+
+struct grub_nvme_device
+{
+  struct grub_nvme_device *next;
+  struct grub_nvme_device **prev;
+  volatile struct grub_nvme_regs *regs;
+  volatile grub_uint32_t *doorbells;
+  unsigned doorbell_stride;
+  struct grub_nvme_queue admin;
+  struct grub_nvme_queue io;
+  struct grub_pci_dma_chunk *prp_list_chunk;
+  grub_uint32_t nsid;
+  grub_uint64_t nsectors;
+  unsigned log_sector_size;
+  int num;
+  int present;
+};
+
+static struct grub_nvme_device *grub_nvme_devices;
+static int numdevs;
+
+static void
+grub_nvme_queue_reset (struct grub_nvme_device *dev,
+		       struct grub_nvme_queue *q, unsigned qid)
+{
+  grub_memset ((void *) q->sq, 0,
+	       sizeof (struct grub_nvme_sqe) * GRUB_NVME_QUEUE_DEPTH);
+  grub_memset ((void *) q->cq, 0,
+	       sizeof (struct grub_nvme_cqe) * GRUB_NVME_QUEUE_DEPTH);
+  q->sq_tail = 0;
+  q->cq_head = 0;
+  q->phase = 1;
+  q->sq_doorbell = dev->doorbells
+    + (2 * qid) * (1 << dev->doorbell_stride);
+  q->cq_doorbell = dev->doorbells
+    + (2 * qid + 1) * (1 << dev->doorbell_stride);
+}
+
+/* Disable the controller and wait for it to acknowledge.  Once
+   CSTS.RDY is clear no DMA is in flight and the queue memory may be
+   reused or freed.  */
+static grub_err_t
+grub_nvme_disable_ctrl (struct grub_nvme_device *dev)
+{
+  grub_uint64_t endtime;
+  grub_uint64_t timeout;
+
+  /* CAP.TO is in 500ms units.  */
+  timeout = ((dev->regs->cap_lo >> 24) & 0xff) * 500;
+
+  dev->regs->cc = 0;
+  endtime = grub_get_time_ms () + timeout;
+  while (dev->regs->csts & GRUB_NVME_CSTS_RDY)
+    if (grub_get_time_ms () > endtime)
+      return grub_error (GRUB_ERR_IO, "NVMe controller didn't reset");
+  return GRUB_ERR_NONE;
+}
+
+/* Submit CMD on Q and poll its completion queue until the command is
+   done.  Queue-pair plumbing is fully polled: the bootloader has no
+   interrupt handling and the doorbell/phase-bit protocol needs none.
+   If the command times out or the completion doesn't match it, the
+   controller still owns the submission entry and the data buffer, so
+   the device is quiesced and retired before returning: a completion
+   arriving after the caller has freed its buffer would DMA into the
+   heap and desync the queue pair for every later command.  */
+static grub_err_t
+grub_nvme_do_command (struct grub_nvme_device *dev,
+		      struct grub_nvme_queue *q,
+		      const struct grub_nvme_sqe *cmd)
+{
+  volatile struct grub_nvme_cqe *cqe;
+  grub_uint64_t endtime;
+  grub_uint16_t status;
+  grub_uint16_t cid = q->sq_tail;
+
+  q->sq[q->sq_tail] = *cmd;
+  q->sq[q->sq_tail].cid = cid;
+  q->sq_tail = (q->sq_tail + 1) % GRUB_NVME_QUEUE_DEPTH;
+  *q->sq_doorbell = q->sq_tail;
+
+  cqe = &q->cq[q->cq_head];
+  endtime = grub_get_time_ms () + 5000;
+  while (((cqe->status & 1) != q->phase))
+    if (grub_get_time_ms () > endtime)
+      {
+	grub_nvme_disable_ctrl (dev);
+	dev->present = 0;
+	return grub_error (GRUB_ERR_IO, "NVMe command timed out");
+      }
+
+  if (cqe->cid != cid)
+    {
+      grub_nvme_disable_ctrl (dev);
+      dev->present = 0;
+      return grub_error (GRUB_ERR_IO, "NVMe completion out of sync");
+    }
+
+  status = cqe->status >> 1;
+  q->cq_head++;
+  if (q->cq_head == GRUB_NVME_QUEUE_DEPTH)
+    {
+      q->cq_head = 0;
+      q->phase ^= 1;
+    }
+  *q->cq_doorbell = q->cq_head;
+
+  if (status)
+    return grub_error (GRUB_ERR_IO, "NVMe command failed (status %x)",
+		       status);
+  return GRUB_ERR_NONE;
+}
+
+static grub_err_t
+grub_nvme_identify (struct grub_nvme_device *dev, grub_uint32_t nsid,
+		    grub_uint32_t cns, grub_uint32_t phys)
+{
+  struct grub_nvme_sqe cmd;
+
+  grub_memset (&cmd, 0, sizeof (cmd));
+  cmd.opcode = GRUB_NVME_ADMIN_IDENTIFY;
+  cmd.nsid = nsid;
+  cmd.prp1 = phys;
+  cmd.cdw10 = cns;
+  return grub_nvme_do_command (dev, &dev->admin, &cmd);
+}
+
+/* Bring the controller up: reset, configure the admin queue pair,
+   enable, and create the I/O queue pair.  Used both at PCI probe time
+   and when restoring hardware after a loader handoff was cancelled.  */
+static grub_err_t
+grub_nvme_init_ctrl (struct grub_nvme_device *dev)
+{
+  grub_uint64_t endtime;
+  grub_uint64_t timeout;
+  struct grub_nvme_sqe cmd;
+  grub_err_t err;
+
+  /* CAP.TO is in 500ms units.  */
+  timeout = ((dev->regs->cap_lo >> 24) & 0xff) * 500;
+
+  err = grub_nvme_disable_ctrl (dev);
+  if (err)
+    return err;
+
+  grub_nvme_queue_reset (dev, &dev->admin, 0);
+  grub_nvme_queue_reset (dev, &dev->io, 1);
+
+  dev->regs->aqa = ((GRUB_NVME_QUEUE_DEPTH - 1) << 16)
+    | (GRUB_NVME_QUEUE_DEPTH - 1);
+  dev->regs->asq_lo = grub_dma_get_phys (dev->admin.sq_chunk);
+  dev->regs->asq_hi = 0;
+  dev->regs->acq_lo = grub_dma_get_phys (dev->admin.cq_chunk);
+  dev->regs->acq_hi = 0;
+
+  /* MPS = 0 selects 4KiB pages.  */
+  dev->regs->cc = GRUB_NVME_CC_IOSQES | GRUB_NVME_CC_IOCQES
+    | GRUB_NVME_CC_EN;
+  endtime = grub_get_time_ms () + timeout;
+  while (!(dev->regs->csts & GRUB_NVME_CSTS_RDY))
+    {
+      if (dev->regs->csts & GRUB_NVME_CSTS_CFS)
+	return grub_error (GRUB_ERR_IO, "NVMe controller fatal status");
+      if (grub_get_time_ms () > endtime)
+	return grub_error (GRUB_ERR_IO, "NVMe controller didn't start");
+    }
+
+  /* The completion queue must exist before the submission queue
+     referencing it.  */
+  grub_memset (&cmd, 0, sizeof (cmd));
+  cmd.opcode = GRUB_NVME_ADMIN_CREATE_CQ;
+  cmd.prp1 = grub_dma_get_phys (dev->io.cq_chunk);
+  cmd.cdw10 = ((GRUB_NVME_QUEUE_DEPTH - 1) << 16) | 1;
+  cmd.cdw11 = 1;	/* Physically contiguous, no interrupts.  */
+  err = grub_nvme_do_command (dev, &dev->admin, &cmd);
+  if (err)
+    return err;
+
+  grub_memset (&cmd, 0, sizeof (cmd));
+  cmd.opcode = GRUB_NVME_ADMIN_CREATE_SQ;
+  cmd.prp1 = grub_dma_get_phys (dev->io.sq_chunk);
+  cmd.cdw10 = ((GRUB_NVME_QUEUE_DEPTH - 1) << 16) | 1;
+  cmd.cdw11 = (1 << 16) | 1;	/* CQ 1, physically contiguous.  */
+  return grub_nvme_do_command (dev, &dev->admin, &cmd);
+}
+
+static int
+grub_nvme_pciinit (grub_pci_device_t dev,
+		   grub_pci_id_t pciid __attribute__ ((unused)),
+		   void *data __attribute__ ((unused)))
+{
+  struct grub_nvme_device *ndev = NULL;
+  grub_pci_address_t addr;
+  grub_uint32_t class;
+  grub_uint32_t bar;
+  grub_uint32_t *ident;
+  struct grub_pci_dma_chunk *ident_chunk = NULL;
+  volatile struct grub_nvme_regs *regs;
+  grub_uint8_t flbas;
+  grub_uint8_t lbads;
+
+  /* Check if this class ID matches that of an NVM Express controller.  */
+  addr = grub_pci_make_address (dev, GRUB_PCI_REG_CLASS);
+  class = grub_pci_read (addr);
+  if (class >> 8 != 0x010802)
+    return 0;
+
+  addr = grub_pci_make_address (dev, GRUB_PCI_REG_ADDRESS_REG0);
+  bar = grub_pci_read (addr);
+  if ((bar & GRUB_PCI_ADDR_SPACE_MASK) != GRUB_PCI_ADDR_SPACE_MEMORY)
+    return 0;
+
+  addr = grub_pci_make_address (dev, GRUB_PCI_REG_COMMAND);
+  grub_pci_write_word (addr, grub_pci_read_word (addr)
+		       | GRUB_PCI_COMMAND_MEM_ENABLED
+		       | GRUB_PCI_COMMAND_BUS_MASTER);
+
+  regs = grub_pci_device_map_range (dev, bar & GRUB_PCI_ADDR_MEM_MASK,
+				    0x2000);
+
+  ndev = grub_zalloc (sizeof (*ndev));
+  if (!ndev)
+    return 0;
+
+  ndev->regs = regs;
+  ndev->doorbells = (volatile grub_uint32_t *) ((char *) regs + 0x1000);
+  ndev->doorbell_stride = (regs->cap_hi >> 0) & 0xf;
+  ndev->nsid = 1;
+
+  ndev->admin.sq_chunk
+    = grub_memalign_dma32 (GRUB_NVME_PAGE_SIZE,
+			   sizeof (struct grub_nvme_sqe)
+			   * GRUB_NVME_QUEUE_DEPTH);
+  ndev->admin.cq_chunk
+    = grub_memalign_dma32 (GRUB_NVME_PAGE_SIZE,
+			   sizeof (struct grub_nvme_cqe)
+			   * GRUB_NVME_QUEUE_DEPTH);
+  ndev->io.sq_chunk
+    = grub_memalign_dma32 (GRUB_NVME_PAGE_SIZE,
+			   sizeof (struct grub_nvme_sqe)
+			   * GRUB_NVME_QUEUE_DEPTH);
+  ndev->io.cq_chunk
+    = grub_memalign_dma32 (GRUB_NVME_PAGE_SIZE,
+			   sizeof (struct grub_nvme_cqe)
+			   * GRUB_NVME_QUEUE_DEPTH);
+  ndev->prp_list_chunk = grub_memalign_dma32 (GRUB_NVME_PAGE_SIZE,
+					      GRUB_NVME_PAGE_SIZE);
+  ident_chunk = grub_memalign_dma32 (GRUB_NVME_PAGE_SIZE,
+				     GRUB_NVME_PAGE_SIZE);
+  if (!ndev->admin.sq_chunk || !ndev->admin.cq_chunk
+      || !ndev->io.sq_chunk || !ndev->io.cq_chunk
+      || !ndev->prp_list_chunk || !ident_chunk)
+    goto fail;
+
+  ndev->admin.sq = grub_dma_get_virt (ndev->admin.sq_chunk);
+  ndev->admin.cq = grub_dma_get_virt (ndev->admin.cq_chunk);
+  ndev->io.sq = grub_dma_get_virt (ndev->io.sq_chunk);
+  ndev->io.cq = grub_dma_get_virt (ndev->io.cq_chunk);
+
+  if (grub_nvme_init_ctrl (ndev))
+    goto fail;
+
+  /* Identify the boot namespace to get its size and LBA format.  */
+  if (grub_nvme_identify (ndev, ndev->nsid, 0,
+			  grub_dma_get_phys (ident_chunk)))
+    goto fail;
+
+  ident = (void *) grub_dma_get_virt (ident_chunk);
+  ndev->nsectors = ident[0] | ((grub_uint64_t) ident[1] << 32);
+  flbas = ((grub_uint8_t *) ident)[26] & 0xf;
+  lbads = (ident[32 + flbas] >> 16) & 0xff;
+  if (!ndev->nsectors || lbads < GRUB_DISK_SECTOR_BITS || lbads > 14)
+    goto fail;
+  ndev->log_sector_size = lbads;
+
+  grub_dma_free (ident_chunk);
+
+  ndev->present = 1;
+  ndev->num = numdevs++;
+  grub_dprintf ("nvme", "found device nvme%d (%" PRIuGRUB_UINT64_T
+		" sectors of %d bytes)\n", ndev->num,
+		ndev->nsectors, 1 << ndev->log_sector_size);
+
+  grub_list_push (GRUB_AS_LIST_P (&grub_nvme_devices),
+		  GRUB_AS_LIST (ndev));
+  return 0;
+
+ fail:
+  /* The controller may still be enabled with the admin queue pointing
+     at the chunks below; stop it before they go back to the heap.  */
+  grub_nvme_disable_ctrl (ndev);
+  grub_errno = GRUB_ERR_NONE;
+  if (ident_chunk)
+    grub_dma_free (ident_chunk);
+  if (ndev->admin.sq_chunk)
+    grub_dma_free (ndev->admin.sq_chunk);
+  if (ndev->admin.cq_chunk)
+    grub_dma_free (ndev->admin.cq_chunk);
+  if (ndev->io.sq_chunk)
+    grub_dma_free (ndev->io.sq_chunk);
+  if (ndev->io.cq_chunk)
+    grub_dma_free (ndev->io.cq_chunk);
+  if (ndev->prp_list_chunk)
+    grub_dma_free (ndev->prp_list_chunk);
+  grub_free (ndev);
+  return 0;
+}
+
+static grub_err_t
+grub_nvme_initialize (void)
+{
+  grub_pci_iterate (grub_nvme_pciinit, NULL);
+  return grub_errno;
+}
+
+static grub_err_t
+grub_nvme_fini_hw (int noreturn __attribute__ ((unused)))
+{
+  struct grub_nvme_device *dev;
+
+  FOR_LIST_ELEMENTS(dev, grub_nvme_devices)
+    dev->regs->cc = 0;
+  return GRUB_ERR_NONE;
+}
+
+static grub_err_t
+grub_nvme_restore_hw (void)
+{
+  struct grub_nvme_device *dev;
+
+  FOR_LIST_ELEMENTS(dev, grub_nvme_devices)
+    if (grub_nvme_init_ctrl (dev))
+      dev->present = 0;
+  return grub_errno;
+}
+
+
+
+static int
+grub_nvme_iterate (grub_disk_dev_iterate_hook_t hook, void *hook_data,
+		   grub_disk_pull_t pull)
+{
+  struct grub_nvme_device *dev;
+  char name[16];
+
+  if (pull != GRUB_DISK_PULL_NONE)
+    return 0;
+
+  FOR_LIST_ELEMENTS(dev, grub_nvme_devices)
+    {
+      if (!dev->present)
+	continue;
+      grub_snprintf (name, sizeof (name), "nvme%d", dev->num);
+      if (hook (name, hook_data))
+	return 1;
+    }
+  return 0;
+}
+
+static grub_err_t
+grub_nvme_open (const char *name, grub_disk_t disk)
+{
+  struct grub_nvme_device *dev;
+  unsigned long num;
+  const char *p;
+
+  if (grub_strncmp (name, "nvme", 4) != 0)
+    return grub_error (GRUB_ERR_UNKNOWN_DEVICE, "not an NVMe device");
+  num = grub_strtoul (name + 4, &p, 10);
+  if (grub_errno || *p)
+    {
+      grub_errno = GRUB_ERR_NONE;
+      return grub_error (GRUB_ERR_UNKNOWN_DEVICE, "not an NVMe device");
+    }
+
+  FOR_LIST_ELEMENTS(dev, grub_nvme_devices)
+    if (dev->num == (int) num && dev->present)
+      break;
+
+  if (!dev)
+    return grub_error (GRUB_ERR_UNKNOWN_DEVICE, "no such NVMe device");
+
+  disk->total_sectors = dev->nsectors;
+  disk->log_sector_size = dev->log_sector_size;
+  disk->max_agglomerate = GRUB_NVME_MAX_READ
+    >> (GRUB_DISK_SECTOR_BITS + GRUB_DISK_CACHE_BITS);
+  disk->id = dev->num;
+  disk->data = dev;
+
+  return GRUB_ERR_NONE;
+}
+
+static void
+grub_nvme_close (grub_disk_t disk __attribute__ ((unused)))
+{
+}
+
+/* Issue one READ of NSECTORS device sectors at SECTOR into the bounce
+   buffer BUFC.  The buffer is physically contiguous, so the PRP list is
+   a simple run of page addresses.  */
+static grub_err_t
+grub_nvme_read_chunk (struct grub_nvme_device *dev, grub_disk_addr_t sector,
+		      grub_size_t nsectors, struct grub_pci_dma_chunk *bufc)
+{
+  struct grub_nvme_sqe cmd;
+  grub_uint32_t phys = grub_dma_get_phys (bufc);
+  grub_size_t bytes = nsectors << dev->log_sector_size;
+  grub_size_t npages = (bytes + GRUB_NVME_PAGE_SIZE - 1)
+    >> GRUB_NVME_PAGE_BITS;
+
+  grub_memset (&cmd, 0, sizeof (cmd));
+  cmd.opcode = GRUB_NVME_IO_READ;
+  cmd.nsid = dev->nsid;
+  cmd.prp1 = phys;
+  if (npages == 2)
+    cmd.prp2 = phys + GRUB_NVME_PAGE_SIZE;
+  else if (npages > 2)
+    {
+      grub_uint64_t *list = (void *) grub_dma_get_virt (dev->prp_list_chunk);
+      grub_size_t i;
+
+      for (i = 0; i + 1 < npages; i++)
+	list[i] = phys + ((i + 1) << GRUB_NVME_PAGE_BITS);
+      cmd.prp2 = grub_dma_get_phys (dev->prp_list_chunk);
+    }
+  cmd.cdw10 = sector & 0xffffffff;
+  cmd.cdw11 = sector >> 32;
+  cmd.cdw12 = nsectors - 1;
+
+  return grub_nvme_do_command (dev, &dev->io, &cmd);
+}
+
+static grub_err_t
+grub_nvme_read (grub_disk_t disk, grub_disk_addr_t sector,
+		grub_size_t size, char *buf)
+{
+  struct grub_nvme_device *dev = disk->data;
+  struct grub_pci_dma_chunk *bufc;
+  grub_size_t max_sectors = GRUB_NVME_MAX_READ >> dev->log_sector_size;
+  grub_err_t err = GRUB_ERR_NONE;
+
+  bufc = grub_memalign_dma32 (GRUB_NVME_PAGE_SIZE,
+			      (size > max_sectors ? max_sectors : size)
+			      << dev->log_sector_size);
+  if (!bufc)
+    return grub_errno;
+
+  while (size && !err)
+    {
+      grub_size_t cur = size > max_sectors ? max_sectors : size;
+
+      err = grub_nvme_read_chunk (dev, sector, cur, bufc);
+      if (!err)
+	grub_memcpy (buf, (char *) grub_dma_get_virt (bufc),
+		     cur << dev->log_sector_size);
+      sector += cur;
+      buf += cur << dev->log_sector_size;
+      size -= cur;
+    }
+
+  grub_dma_free (bufc);
+  return err;
+}
+
+static grub_err_t
+grub_nvme_write (grub_disk_t disk __attribute__ ((unused)),
+		 grub_disk_addr_t sector __attribute__ ((unused)),
+		 grub_size_t size __attribute__ ((unused)),
+		 const char *buf __attribute__ ((unused)))
+{
+  return grub_error (GRUB_ERR_NOT_IMPLEMENTED_YET,
+		     "NVMe writes are not implemented");
+}
+
+static struct grub_disk_dev grub_nvme_dev =
+  {
+    .name = "nvme",
+    .id = GRUB_DISK_DEVICE_NVME_ID,
+    .disk_iterate = grub_nvme_iterate,
+    .disk_open = grub_nvme_open,
+    .disk_close = grub_nvme_close,
+    .disk_read = grub_nvme_read,
+    .disk_write = grub_nvme_write,
+    .next = 0
+  };
+
+
+
+static struct grub_preboot *fini_hnd;
+
+GRUB_MOD_INIT(nvme)
+{
+  grub_stop_disk_firmware ();
+
+  grub_nvme_initialize ();
+
+  grub_disk_dev_register (&grub_nvme_dev);
+
+  fini_hnd = grub_loader_register_preboot_hook (grub_nvme_fini_hw,
+						grub_nvme_restore_hw,
+						GRUB_LOADER_PREBOOT_HOOK_PRIO_DISK);
+}
+
+GRUB_MOD_FINI(nvme)
+{
+  grub_nvme_fini_hw (0);
+  grub_loader_unregister_preboot_hook (fini_hnd);
+
+  grub_disk_dev_unregister (&grub_nvme_dev);
+}
@@ -50,6 +50,10 @@ struct grub_pata_device
      (commonly known as "slave").  */
   int device;
 
+  /* Busmaster DMA registers for this channel, or 0 when the
+     controller offers none.  */
+  grub_port_t bmaddress;
+
   int present;
 
   struct grub_pata_device *next;
@@ -146,6 +150,152 @@ grub_pata_pio_write (struct grub_pata_device *dev, char *buf, grub_size_t size)
     grub_outw(grub_cpu_to_ata16 (grub_get_unaligned16 (buf + 2 * i)), dev->ioaddress + GRUB_ATA_REG_DATA);
 }
 
+#ifndef GRUB_MACHINE_MIPS_QEMU_MIPS
+/* Busmaster IDE (SFF-8038i) registers, relative to the channel's
+   8-byte half of the BAR4 region.  */
+#define GRUB_PATA_BM_CMD		0
+#define GRUB_PATA_BM_STATUS		2
+#define GRUB_PATA_BM_PRDT		4
+
+#define GRUB_PATA_BM_CMD_START		0x01
+#define GRUB_PATA_BM_CMD_READ		0x08
+
+#define GRUB_PATA_BM_STATUS_ACTIVE	0x01
+#define GRUB_PATA_BM_STATUS_ERROR	0x02
+#define GRUB_PATA_BM_STATUS_IRQ		0x04
+
+/* Physical region descriptor.  An entry may not cross a 64K boundary;
+   a byte count of zero means 64K.  */
+struct grub_pata_prd
+{
+  grub_uint32_t addr;
+  grub_uint16_t size;
+  grub_uint16_t flags;
+} GRUB_PACKED;
+
+#define GRUB_PATA_PRD_EOT	grub_cpu_to_le16_compile_time (0x8000)
+
+/* Translate a DMA command into its PIO equivalent for fallback.  */
+static int
+grub_pata_cmd_to_pio (int cmd)
+{
+  switch (cmd)
+    {
+    case GRUB_ATA_CMD_READ_SECTORS_DMA:
+      return GRUB_ATA_CMD_READ_SECTORS;
+    case GRUB_ATA_CMD_READ_SECTORS_DMA_EXT:
+      return GRUB_ATA_CMD_READ_SECTORS_EXT;
+    case GRUB_ATA_CMD_WRITE_SECTORS_DMA:
+      return GRUB_ATA_CMD_WRITE_SECTORS;
+    case GRUB_ATA_CMD_WRITE_SECTORS_DMA_EXT:
+      return GRUB_ATA_CMD_WRITE_SECTORS_EXT;
+    }
+  return cmd;
+}
+
+/* Program the PRD table and the busmaster engine for the transfer
+   described by PARMS, but don't start it yet.  */
+static grub_err_t
+grub_pata_dma_setup (struct grub_pata_device *dev,
+		     struct grub_disk_ata_pass_through_parms *parms,
+		     struct grub_pci_dma_chunk **bufc,
+		     struct grub_pci_dma_chunk **prdc)
+{
+  struct grub_pata_prd *prd;
+  grub_uint32_t phys, remaining;
+  unsigned i = 0;
+
+  *bufc = grub_memalign_dma32 (GRUB_DISK_SECTOR_SIZE, parms->size);
+  if (! *bufc)
+    return grub_errno;
+  /* A transfer of up to 256 sectors spans at most three 64K chunks.  */
+  *prdc = grub_memalign_dma32 (16, 4 * sizeof (struct grub_pata_prd));
+  if (! *prdc)
+    {
+      grub_dma_free (*bufc);
+      return grub_errno;
+    }
+
+  if (parms->write)
+    grub_memcpy ((char *) grub_dma_get_virt (*bufc), parms->buffer,
+		 parms->size);
+
+  prd = (struct grub_pata_prd *) grub_dma_get_virt (*prdc);
+  phys = grub_dma_get_phys (*bufc);
+  remaining = parms->size;
+  while (remaining)
+    {
+      grub_uint32_t cnt = 0x10000 - (phys & 0xffff);
+
+      if (cnt > remaining)
+	cnt = remaining;
+      prd[i].addr = grub_cpu_to_le32 (phys);
+      prd[i].size = grub_cpu_to_le16 (cnt & 0xffff);
+      prd[i].flags = 0;
+      i++;
+      phys += cnt;
+      remaining -= cnt;
+    }
+  prd[i - 1].flags = GRUB_PATA_PRD_EOT;
+
+  grub_outl (grub_dma_get_phys (*prdc),
+	     dev->bmaddress + GRUB_PATA_BM_PRDT);
+  /* Writing the latched bits back clears them.  */
+  grub_outb (GRUB_PATA_BM_STATUS_ERROR | GRUB_PATA_BM_STATUS_IRQ,
+	     dev->bmaddress + GRUB_PATA_BM_STATUS);
+  grub_outb (parms->write ? 0 : GRUB_PATA_BM_CMD_READ,
+	     dev->bmaddress + GRUB_PATA_BM_CMD);
+
+  return GRUB_ERR_NONE;
+}
+
+/* Start the previously set up busmaster engine and wait for the
+   transfer to finish.  The ATA command has already been issued.  */
+static grub_err_t
+grub_pata_dma_run (struct grub_pata_device *dev,
+		   struct grub_disk_ata_pass_through_parms *parms,
+		   struct grub_pci_dma_chunk *bufc)
+{
+  grub_uint8_t bmsts;
+  int i = 1;
+
+  grub_outb ((parms->write ? 0 : GRUB_PATA_BM_CMD_READ)
+	     | GRUB_PATA_BM_CMD_START,
+	     dev->bmaddress + GRUB_PATA_BM_CMD);
+
+  while (1)
+    {
+      bmsts = grub_inb (dev->bmaddress + GRUB_PATA_BM_STATUS);
+      if (bmsts & GRUB_PATA_BM_STATUS_ERROR)
+	break;
+      if ((bmsts & GRUB_PATA_BM_STATUS_IRQ)
+	  && ! (grub_pata_regget (dev, GRUB_ATA_REG_STATUS)
+		& GRUB_ATA_STATUS_BUSY))
+	break;
+      if (i >= GRUB_ATA_TOUT_DATA)
+	break;
+      grub_millisleep (1);
+      i++;
+    }
+
+  /* Stop the engine whatever happened.  */
+  grub_outb (parms->write ? 0 : GRUB_PATA_BM_CMD_READ,
+	     dev->bmaddress + GRUB_PATA_BM_CMD);
+
+  if (bmsts & GRUB_PATA_BM_STATUS_ERROR)
+    return grub_error (parms->write ? GRUB_ERR_WRITE_ERROR
+		       : GRUB_ERR_READ_ERROR, "PATA busmaster error");
+  if (! (bmsts & GRUB_PATA_BM_STATUS_IRQ))
+    return grub_error (GRUB_ERR_TIMEOUT, "PATA DMA timeout");
+
+  if (! parms->write)
+    grub_memcpy (parms->buffer, (char *) grub_dma_get_virt (bufc),
+		 parms->size);
+
+  return GRUB_ERR_NONE;
+}
+#endif
+
 /* ATA pass through support, used by hdparm.mod.  */
 static grub_err_t
 grub_pata_readwrite (struct grub_ata *disk,
@@ -155,6 +305,13 @@ grub_pata_readwrite (struct grub_ata *disk,
   struct grub_pata_device *dev = (struct grub_pata_device *) disk->data;
   grub_size_t nread = 0;
   int i;
+#ifndef GRUB_MACHINE_MIPS_QEMU_MIPS
+  int dma = 0;
+  struct grub_pci_dma_chunk *bufc = NULL, *prdc = NULL;
+
+  if (parms->dma && parms->size && ! parms->cmdsize && dev->bmaddress)
+    dma = 1;
+#endif
 
   if (! (parms->cmdsize == 0 || parms->cmdsize == 12))
     return grub_error (GRUB_ERR_NOT_IMPLEMENTED_YET,
@@ -182,9 +339,37 @@ grub_pata_readwrite (struct grub_ata *disk,
   for (i = GRUB_ATA_REG_FEATURES; i <= GRUB_ATA_REG_LBAHIGH; i++)
     grub_pata_regset (dev, i, parms->taskfile.raw[i - GRUB_ATA_REG_FEATURES]);
 
+#ifndef GRUB_MACHINE_MIPS_QEMU_MIPS
+  if (dma && grub_pata_dma_setup (dev, parms, &bufc, &prdc))
+    {
+      /* Can't set the engine up; issue the transfer via PIO instead.  */
+      grub_errno = GRUB_ERR_NONE;
+      parms->taskfile.cmd = grub_pata_cmd_to_pio (parms->taskfile.cmd);
+      dma = 0;
+    }
+#endif
+
   /* Start command. */
   grub_pata_regset (dev, GRUB_ATA_REG_CMD, parms->taskfile.cmd);
 
+#ifndef GRUB_MACHINE_MIPS_QEMU_MIPS
+  if (dma)
+    {
+      grub_err_t err = grub_pata_dma_run (dev, parms, bufc);
+
+      grub_dma_free (prdc);
+      grub_dma_free (bufc);
+      if (err)
+	{
+	  /* Leave DMA off for this device so that subsequent
+	     commands go through the PIO path.  */
+	  disk->dma = 0;
+	  return err;
+	}
+      nread = parms->size;
+    }
+#endif
+
   /* Wait for !BSY.  */
   if (grub_pata_wait_not_busy (dev, GRUB_ATA_TOUT_DATA))
     return grub_errno;
@@ -306,7 +491,7 @@ check_device (struct grub_pata_device *dev)
 }
 
 static grub_err_t
-grub_pata_device_initialize (int port, int device, int addr)
+grub_pata_device_initialize (int port, int device, int addr, int bmaddr)
 {
   struct grub_pata_device *dev;
   struct grub_pata_device **devp;
@@ -323,6 +508,7 @@ grub_pata_device_initialize (int port, int device, int addr)
   dev->port = port;
   dev->device = device;
   dev->ioaddress = addr + GRUB_MACHINE_PCI_IO_BASE;
+  dev->bmaddress = bmaddr ? bmaddr + GRUB_MACHINE_PCI_IO_BASE : 0;
   dev->present = 1;
   dev->next = NULL;
 
@@ -354,6 +540,7 @@ grub_pata_pciinit (grub_pci_device_t dev,
   grub_uint32_t class;
   grub_uint32_t bar1;
   grub_uint32_t bar2;
+  grub_uint32_t bmbase = 0;
   int rega;
   int i;
   static int controller = 0;
@@ -375,6 +562,22 @@ grub_pata_pciinit (grub_pci_device_t dev,
   if (!cs5536 && (class >> 16 != 0x0101))
     return 0;
 
+  /* BAR4 points at the busmaster DMA registers, which both channels
+     share: 8 bytes each.  */
+  addr = grub_pci_make_address (dev, GRUB_PCI_REG_ADDRESSES
+				+ 4 * sizeof (grub_uint32_t));
+  bmbase = grub_pci_read (addr);
+  if ((bmbase & 1) && (bmbase & ~3))
+    {
+      bmbase &= ~3;
+      addr = grub_pci_make_address (dev, GRUB_PCI_REG_COMMAND);
+      grub_pci_write_word (addr, grub_pci_read_word (addr)
+			   | GRUB_PCI_COMMAND_IO_ENABLED
+			   | GRUB_PCI_COMMAND_BUS_MASTER);
+    }
+  else
+    bmbase = 0;
+
   for (i = 0; i < nports; i++)
     {
       /* Set to 0 when the channel operated in compatibility mode.  */
@@ -428,7 +631,8 @@ grub_pata_pciinit (grub_pci_device_t dev,
       if (rega)
 	{
 	  grub_errno = GRUB_ERR_NONE;
-	  grub_pata_device_initialize (controller * 2 + i, 0, rega);
+	  grub_pata_device_initialize (controller * 2 + i, 0, rega,
+				       bmbase ? bmbase + 8 * i : 0);
 
 	  /* Most errors raised by grub_ata_device_initialize() are harmless.
 	     They just indicate this particular drive is not responding, most
@@ -440,7 +644,8 @@ grub_pata_pciinit (grub_pci_device_t dev,
 	      grub_errno = GRUB_ERR_NONE;
 	    }
 
-	  grub_pata_device_initialize (controller * 2 + i, 1, rega);
+	  grub_pata_device_initialize (controller * 2 + i, 1, rega,
+				       bmbase ? bmbase + 8 * i : 0);
 
 	  /* Likewise.  */
 	  if (grub_errno)
@@ -469,8 +674,8 @@ grub_pata_initialize (void)
   int i;
   for (i = 0; i < 2; i++)
     {
-      grub_pata_device_initialize (i, 0, grub_pata_ioaddress[i]);
-      grub_pata_device_initialize (i, 1, grub_pata_ioaddress[i]);
+      grub_pata_device_initialize (i, 0, grub_pata_ioaddress[i], 0);
+      grub_pata_device_initialize (i, 1, grub_pata_ioaddress[i], 0);
     }
   return 0;
 }
@@ -505,7 +710,7 @@ grub_pata_open (int id, int devnum, struct grub_ata *ata)
     return err;
 
   ata->data = devfnd;
-  ata->dma = 0;
+  ata->dma = devfnd->bmaddress != 0;
   ata->maxbuffer = 256 * 512;
   ata->present = &devfnd->present;
 
@@ -514,6 +514,7 @@ grub_scsi_open (const char *name, grub_disk_t disk)
   scsi = grub_malloc (sizeof (*scsi));
   if (! scsi)
     return grub_errno;
+  scsi->max_bytes = 0;
 
   for (id = 0; id < ARRAY_SIZE (grub_scsi_names); id++)
     if (grub_strncmp (grub_scsi_names[id], name, nameend - name) == 0)
@@ -606,12 +607,13 @@ grub_scsi_open (const char *name, grub_disk_t disk)
 	}
 
       disk->total_sectors = scsi->last_block + 1;
-      /* PATA doesn't support more than 32K reads.
-	 Not sure about AHCI and USB. If it's confirmed that either of
-	 them can do bigger reads reliably this value can be moved to 'scsi'
-	 structure.  */
-      disk->max_agglomerate = 32768 >> (GRUB_DISK_SECTOR_BITS
-					+ GRUB_DISK_CACHE_BITS);
+      /* PATA doesn't support more than 32K reads, so that's the
+	 default when the transport didn't declare a limit of its own
+	 at open time.  */
+      if (scsi->max_bytes == 0)
+	scsi->max_bytes = 32768;
+      disk->max_agglomerate = scsi->max_bytes >> (GRUB_DISK_SECTOR_BITS
+						  + GRUB_DISK_CACHE_BITS);
 
       if (scsi->blocksize & (scsi->blocksize - 1) || !scsi->blocksize)
 	{
@@ -621,6 +621,10 @@ grub_usbms_open (int id, int devnum, struct grub_scsi *scsi)
 
   scsi->data = grub_usbms_devices[devnum];
   scsi->luns = grub_usbms_devices[devnum]->luns;
+  /* Bulk-only transport has no intrinsic length limit and the host
+     controller drivers chain transfer descriptors as needed, so issue
+     big reads to amortize the CBW/CSW round-trip per command.  */
+  scsi->max_bytes = 1048576;
 
   return GRUB_ERR_NONE;
 }
@@ -63,6 +63,7 @@ static int register_font (grub_font_t font);
 static void font_init (grub_font_t font);
 static void free_font (grub_font_t font);
 static void remove_font (grub_font_t font);
+static void preload_ascii_glyphs (grub_font_t font);
 
 struct font_file_section
 {
@@ -666,6 +667,8 @@ grub_font_load (const char *filename)
   if (register_font (font) != 0)
     goto fail;
 
+  preload_ascii_glyphs (font);
+
   return font;
 
 fail:
@@ -757,6 +760,7 @@ grub_font_get_glyph_internal (grub_font_t font, grub_uint32_t code)
   if (index_entry)
     {
       struct grub_font_glyph *glyph = 0;
+      grub_uint8_t raw[10];
       grub_uint16_t width;
       grub_uint16_t height;
       grub_int16_t xoff;
@@ -779,14 +783,22 @@ grub_font_get_glyph_internal (grub_font_t font, grub_uint32_t code)
 
       grub_file_seek (font->file, index_entry->offset);
 
-      /* Read the glyph width, height, and baseline.  */
-      if (read_be_uint16 (font->file, &width) != 0
-	  || read_be_uint16 (font->file, &height) != 0
-	  || read_be_int16 (font->file, &xoff) != 0
-	  || read_be_int16 (font->file, &yoff) != 0
-	  || read_be_int16 (font->file, &dwidth) != 0
-	  || width > font->max_char_width
-	  || height > font->max_char_height)
+      /* Read the glyph width, height, and baseline in one go instead
+	 of five 2-byte reads through the file layer.  */
+      if (grub_file_read (font->file, raw, sizeof (raw))
+	  != (grub_ssize_t) sizeof (raw))
+	{
+	  remove_font (font);
+	  return 0;
+	}
+
+      width = grub_be_to_cpu16 (grub_get_unaligned16 (raw + 0));
+      height = grub_be_to_cpu16 (grub_get_unaligned16 (raw + 2));
+      xoff = (grub_int16_t) grub_be_to_cpu16 (grub_get_unaligned16 (raw + 4));
+      yoff = (grub_int16_t) grub_be_to_cpu16 (grub_get_unaligned16 (raw + 6));
+      dwidth = (grub_int16_t) grub_be_to_cpu16 (grub_get_unaligned16 (raw + 8));
+
+      if (width > font->max_char_width || height > font->max_char_height)
 	{
 	  remove_font (font);
 	  return 0;
@@ -838,6 +850,135 @@ grub_font_get_glyph_internal (grub_font_t font, grub_uint32_t code)
   return 0;
 }
 
+/* Build a glyph from an in-memory copy of its file representation at
+   RAW, of which AVAIL bytes are valid.  Returns NULL if the data does
+   not fit or is malformed; the glyph can still be loaded lazily from
+   the file later in that case.  */
+static struct grub_font_glyph *
+glyph_from_memory (grub_font_t font, const grub_uint8_t *raw,
+		   grub_size_t avail)
+{
+  struct grub_font_glyph *glyph;
+  grub_uint16_t width;
+  grub_uint16_t height;
+  grub_int16_t xoff;
+  grub_int16_t yoff;
+  grub_int16_t dwidth;
+  grub_ssize_t len;
+  grub_size_t sz;
+
+  if (avail < 10)
+    return NULL;
+
+  width = grub_be_to_cpu16 (grub_get_unaligned16 (raw + 0));
+  height = grub_be_to_cpu16 (grub_get_unaligned16 (raw + 2));
+  xoff = (grub_int16_t) grub_be_to_cpu16 (grub_get_unaligned16 (raw + 4));
+  yoff = (grub_int16_t) grub_be_to_cpu16 (grub_get_unaligned16 (raw + 6));
+  dwidth = (grub_int16_t) grub_be_to_cpu16 (grub_get_unaligned16 (raw + 8));
+
+  if (width > font->max_char_width || height > font->max_char_height)
+    return NULL;
+
+  if (grub_video_bitmap_calc_1bpp_bufsz (width, height, &len)
+      || grub_add (sizeof (struct grub_font_glyph), len, &sz))
+    return NULL;
+
+  if (avail - 10 < (grub_size_t) len)
+    return NULL;
+
+  glyph = grub_malloc (sz);
+  if (glyph == NULL)
+    return NULL;
+
+  glyph->font = font;
+  glyph->width = width;
+  glyph->height = height;
+  glyph->offset_x = xoff;
+  glyph->offset_y = yoff;
+  glyph->device_width = dwidth;
+  grub_memcpy (glyph->bitmap, raw + 10, len);
+
+  return glyph;
+}
+
+#define ASCII_PRELOAD_FIRST	0x20
+#define ASCII_PRELOAD_LAST	0x7e
+/* Give up if the glyphs are scattered over more than this; a terminal
+   font keeps them well under it.  */
+#define ASCII_PRELOAD_MAX_SPAN	32768
+
+/* Eagerly decode the printable ASCII glyphs with one contiguous read.
+   grub-mkfont emits glyph data in code point order, so these glyphs
+   occupy a dense span of the data section; decoding them together
+   replaces a seek and two reads per character on the terminal's hottest
+   code points.  Purely an optimization: on any failure the glyphs are
+   simply loaded on demand as before.  */
+static void
+preload_ascii_glyphs (grub_font_t font)
+{
+  struct char_index_entry
+    *entries[ASCII_PRELOAD_LAST - ASCII_PRELOAD_FIRST + 1];
+  grub_uint32_t code;
+  grub_uint32_t lo = (grub_uint32_t) -1, hi = 0;
+  grub_uint8_t *buf;
+  grub_size_t span;
+  grub_ssize_t maxbitmap;
+  int n = 0, i;
+
+  if (!font->file)
+    return;
+
+  for (code = ASCII_PRELOAD_FIRST; code <= ASCII_PRELOAD_LAST; code++)
+    {
+      struct char_index_entry *entry = find_glyph (font, code);
+
+      if (!entry || entry->glyph)
+	continue;
+      entries[n++] = entry;
+      if (entry->offset < lo)
+	lo = entry->offset;
+      if (entry->offset > hi)
+	hi = entry->offset;
+    }
+  if (n == 0)
+    return;
+
+  /* Leave room for the largest possible bitmap after the last header.  */
+  if (grub_video_bitmap_calc_1bpp_bufsz (font->max_char_width,
+					 font->max_char_height, &maxbitmap))
+    return;
+  if (lo >= grub_file_size (font->file))
+    return;
+  span = (grub_size_t) (hi - lo) + 10 + maxbitmap;
+  if (lo + span > grub_file_size (font->file))
+    span = grub_file_size (font->file) - lo;
+  if (span > ASCII_PRELOAD_MAX_SPAN)
+    return;
+
+  buf = grub_malloc (span);
+  if (!buf)
+    {
+      grub_errno = GRUB_ERR_NONE;
+      return;
+    }
+
+  grub_file_seek (font->file, lo);
+  if (grub_file_read (font->file, buf, span) != (grub_ssize_t) span)
+    {
+      grub_free (buf);
+      grub_errno = GRUB_ERR_NONE;
+      return;
+    }
+
+  for (i = 0; i < n; i++)
+    entries[i]->glyph = glyph_from_memory (font,
+					   buf + (entries[i]->offset - lo),
+					   span - (entries[i]->offset - lo));
+
+  grub_free (buf);
+  grub_errno = GRUB_ERR_NONE;
+}
+
 /* Free the memory used by FONT.
    This should not be called if the font has been made available to
    users (once it is added to the global font list), since there would
@@ -857,6 +998,37 @@ free_font (grub_font_t font)
     }
 }
 
+/* A fallback resolution is stable as long as the font list does not
+   change, so memoize codepoint to owning font per requested font.
+   CJK text rendered with a latin font first in the list otherwise
+   walks every registered font for every character on every redraw.
+   A NULL owner marks a free slot; the cache is flushed whenever a
+   font is registered or removed.  */
+#define FONT_FALLBACK_CACHE_SIZE	512
+
+struct font_fallback_cache_entry
+{
+  grub_uint32_t code;
+  grub_font_t requested;
+  grub_font_t owner;
+};
+
+static struct font_fallback_cache_entry
+  font_fallback_cache[FONT_FALLBACK_CACHE_SIZE];
+
+static inline unsigned
+font_fallback_cache_slot (grub_font_t font, grub_uint32_t code)
+{
+  return (code ^ (grub_uint32_t) ((grub_addr_t) font >> 4))
+    & (FONT_FALLBACK_CACHE_SIZE - 1);
+}
+
+static void
+font_fallback_cache_clear (void)
+{
+  grub_memset (font_fallback_cache, 0, sizeof (font_fallback_cache));
+}
+
 /* Add FONT to the global font registry.
    Returns 0 upon success, nonzero on failure
    (the font was not registered).  */
@@ -873,6 +1045,8 @@ register_font (grub_font_t font)
   node->next = grub_font_list;
   grub_font_list = node;
 
+  font_fallback_cache_clear ();
+
   return 0;
 }
 
@@ -893,6 +1067,8 @@ remove_font (grub_font_t font)
 	  /* Free the node, but not the font itself.  */
 	  grub_free (cur);
 
+	  font_fallback_cache_clear ();
+
 	  return;
 	}
     }
@@ -1047,6 +1223,19 @@ grub_font_get_glyph_with_fallback (grub_font_t font, grub_uint32_t code)
 	return glyph;
     }
 
+  /* A previous walk may have resolved this codepoint already.  */
+  {
+    struct font_fallback_cache_entry *ent;
+
+    ent = &font_fallback_cache[font_fallback_cache_slot (font, code)];
+    if (ent->owner && ent->code == code && ent->requested == font)
+      {
+	glyph = grub_font_get_glyph_internal (ent->owner, code);
+	if (glyph)
+	  return glyph;
+      }
+  }
+
   /* Otherwise, search all loaded fonts for the glyph and use the one from
      the font that best matches the requested font.  */
   best_diversity = 10000;
@@ -1061,7 +1250,15 @@ grub_font_get_glyph_with_fallback (grub_font_t font, grub_uint32_t code)
 
       glyph = grub_font_get_glyph_internal (curfont, code);
       if (glyph && !font)
-	return glyph;
+	{
+	  struct font_fallback_cache_entry *ent;
+
+	  ent = &font_fallback_cache[font_fallback_cache_slot (font, code)];
+	  ent->code = code;
+	  ent->requested = font;
+	  ent->owner = glyph->font;
+	  return glyph;
+	}
       if (glyph)
 	{
 	  int d;
@@ -1075,6 +1272,16 @@ grub_font_get_glyph_with_fallback (grub_font_t font, grub_uint32_t code)
 	}
     }
 
+  if (best_glyph)
+    {
+      struct font_fallback_cache_entry *ent;
+
+      ent = &font_fallback_cache[font_fallback_cache_slot (font, code)];
+      ent->code = code;
+      ent->requested = font;
+      ent->owner = best_glyph->font;
+    }
+
   return best_glyph;
 }
 
@@ -111,6 +111,13 @@ struct grub_fshelp_node
   grub_uint32_t last_block_cache;
 };
 
+/* A directory entry remembered by the directory cache.  */
+struct grub_affs_dirent
+{
+  grub_uint32_t block;
+  struct grub_affs_file di;
+};
+
 /* Information about a "mounted" affs filesystem.  */
 struct grub_affs_data
 {
@@ -123,6 +130,16 @@ struct grub_affs_data
 
   /* The number of entries in the hashtable.  */
   unsigned int htsize;
+
+  /* Entry table of the last fully iterated directory, so repeated
+     iterations (several lookups in one directory, symlink re-walks)
+     do not re-read every hash chain node.  Freed by
+     grub_affs_unmount.  */
+  grub_uint32_t dircache_block;
+  struct grub_affs_dirent *dircache;
+  grub_size_t dircache_count;
+  grub_size_t dircache_allocated;
+  int dircache_valid;
 };
 
 static grub_dl_t my_mod;
@@ -180,6 +197,16 @@ grub_affs_read_block (grub_fshelp_node_t node, grub_disk_addr_t fileblock)
   return grub_be_to_cpu32 (pos);
 }
 
+/* Free DATA and the directory cache hanging off it.  */
+static void
+grub_affs_unmount (struct grub_affs_data *data)
+{
+  if (!data)
+    return;
+  grub_free (data->dircache);
+  grub_free (data);
+}
+
 static struct grub_affs_data *
 grub_affs_mount (grub_disk_t disk)
 {
@@ -273,7 +300,7 @@ grub_affs_mount (grub_disk_t disk)
   if (grub_errno == GRUB_ERR_NONE || grub_errno == GRUB_ERR_OUT_OF_RANGE)
     grub_error (GRUB_ERR_BAD_FS, "not an AFFS filesystem");
 
-  grub_free (data);
+  grub_affs_unmount (data);
   grub_free (rootblock);
   return 0;
 }
@@ -403,6 +430,7 @@ grub_affs_iterate_dir (grub_fshelp_node_t dir,
   struct grub_fshelp_node *node, *orig_node;
   struct grub_affs_data *data = dir->data;
   grub_uint32_t *hashtable;
+  int cacheable = 1;
 
   /* Create the directory entries for `.' and `..'.  */
   node = orig_node = grub_zalloc (sizeof (*node));
@@ -419,6 +447,30 @@ grub_affs_iterate_dir (grub_fshelp_node_t dir,
 	return 1;
     }
 
+  /* Serve the entries from the cache when this directory has already
+     been fully iterated since the mount.  */
+  if (data->dircache_valid && data->dircache_block == dir->block)
+    {
+      grub_size_t n;
+
+      hashtable = 0;
+      for (n = 0; n < data->dircache_count; n++)
+	{
+	  file = data->dircache[n].di;
+	  if (grub_affs_create_node (dir, hook, hook_data, &node, &hashtable,
+				     data->dircache[n].block, &file))
+	    {
+	      grub_free (orig_node);
+	      return 1;
+	    }
+	}
+      grub_free (orig_node);
+      return 0;
+    }
+
+  data->dircache_valid = 0;
+  data->dircache_count = 0;
+
   hashtable = grub_calloc (data->htsize, sizeof (*hashtable));
   if (!hashtable)
     return 1;
@@ -451,6 +503,32 @@ grub_affs_iterate_dir (grub_fshelp_node_t dir,
 	  if (grub_errno)
 	    goto fail;
 
+	  /* Remember the raw entry for later iterations.  */
+	  if (cacheable && data->dircache_count == data->dircache_allocated)
+	    {
+	      struct grub_affs_dirent *nc;
+	      grub_size_t na = data->dircache_allocated
+		? 2 * data->dircache_allocated : 16;
+
+	      nc = grub_realloc (data->dircache, na * sizeof (*nc));
+	      if (nc)
+		{
+		  data->dircache = nc;
+		  data->dircache_allocated = na;
+		}
+	      else
+		{
+		  cacheable = 0;
+		  grub_errno = GRUB_ERR_NONE;
+		}
+	    }
+	  if (cacheable)
+	    {
+	      data->dircache[data->dircache_count].block = next;
+	      data->dircache[data->dircache_count].di = file;
+	      data->dircache_count++;
+	    }
+
 	  if (grub_affs_create_node (dir, hook, hook_data, &node, &hashtable,
 				     next, &file))
 	    {
@@ -463,6 +541,12 @@ grub_affs_iterate_dir (grub_fshelp_node_t dir,
 	}
     }
 
+  if (cacheable)
+    {
+      data->dircache_block = dir->block;
+      data->dircache_valid = 1;
+    }
+
  fail:
   grub_free (orig_node);
   grub_free (hashtable);
@@ -500,7 +584,7 @@ grub_affs_open (struct grub_file *file, const char *name)
  fail:
   if (data && fdiro != &data->diropen)
     grub_free (fdiro);
-  grub_free (data);
+  grub_affs_unmount (data);
 
   grub_dl_unref (my_mod);
 
@@ -591,7 +675,7 @@ grub_affs_dir (grub_device_t device, const char *path,
  fail:
   if (data && fdiro != &data->diropen)
     grub_free (fdiro);
-  grub_free (data);
+  grub_affs_unmount (data);
 
   grub_dl_unref (my_mod);
 
@@ -635,7 +719,7 @@ grub_affs_label (grub_device_t device, char **label)
 
   grub_dl_unref (my_mod);
 
-  grub_free (data);
+  grub_affs_unmount (data);
 
   return grub_errno;
 }
@@ -667,14 +751,14 @@ grub_affs_mtime (grub_device_t device, grub_int64_t *t)
   if (grub_errno)
     {
       grub_dl_unref (my_mod);
-      grub_free (data);
+      grub_affs_unmount (data);
       return grub_errno;
     }
 
   *t = aftime2ctime (&af_time);
   grub_dl_unref (my_mod);
 
-  grub_free (data);
+  grub_affs_unmount (data);
 
   return GRUB_ERR_NONE;
 }
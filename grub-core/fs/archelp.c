@@ -20,10 +20,214 @@
 #include <grub/err.h>
 #include <grub/fs.h>
 #include <grub/disk.h>
+#include <grub/mm.h>
 #include <grub/dl.h>
 
 GRUB_MOD_LICENSE ("GPLv3+");
 
+struct archelp_index_entry
+{
+  char *name;
+  /* Target of a symlink, resolved at record time; NULL otherwise.  */
+  char *linkname;
+  grub_int32_t mtime;
+  grub_uint32_t mode;
+  grub_uint64_t pos[GRUB_ARCHELP_POS_WORDS];
+};
+
+/* Member index of the most recently scanned archive.  Finding a member
+   is a linear scan from offset zero, so every open rereads all the
+   headers in front of it; images like the grub-mkstandalone memdisk
+   open dozens of files from one archive at startup.  The index records
+   members as the driver first returns them and replays them from memory
+   in later scans.  Only drivers providing the position ops take part;
+   on any allocation failure it turns itself off until the archive is
+   mounted afresh.  */
+static struct
+{
+  struct grub_archelp_ops *arcops;
+  unsigned long dev_id;
+  unsigned long disk_id;
+  int dead;
+  int complete;
+  struct archelp_index_entry *entries;
+  grub_size_t nentries;
+  grub_size_t nalloc;
+  /* Scanning session the cursor belongs to.  Every session starts at
+     the beginning of the archive: mounts create a fresh data object and
+     rewinds reset the cursor explicitly.  */
+  struct grub_archelp_data *cur_data;
+  grub_size_t cursor;
+  /* Link target of the entry most recently served from the index.  */
+  const char *cur_linkname;
+} member_index;
+
+static int
+index_capable (struct grub_archelp_ops *arcops)
+{
+  return arcops->get_disk && arcops->get_pos && arcops->set_pos;
+}
+
+static int
+index_matches (struct grub_archelp_data *data,
+	       struct grub_archelp_ops *arcops)
+{
+  grub_disk_t disk = arcops->get_disk (data);
+
+  return member_index.arcops == arcops && member_index.dev_id == disk->dev->id
+    && member_index.disk_id == disk->id;
+}
+
+static void
+index_reset (struct grub_archelp_data *data,
+	     struct grub_archelp_ops *arcops)
+{
+  grub_disk_t disk = arcops->get_disk (data);
+  grub_size_t i;
+
+  for (i = 0; i < member_index.nentries; i++)
+    {
+      grub_free (member_index.entries[i].name);
+      grub_free (member_index.entries[i].linkname);
+    }
+  grub_free (member_index.entries);
+  grub_memset (&member_index, 0, sizeof (member_index));
+  member_index.arcops = arcops;
+  member_index.dev_id = disk->dev->id;
+  member_index.disk_id = disk->id;
+}
+
+static void
+index_record (struct grub_archelp_data *data,
+	      struct grub_archelp_ops *arcops,
+	      const char *name, grub_int32_t mtime, grub_uint32_t mode)
+{
+  struct archelp_index_entry *ent;
+
+  if (member_index.nentries == member_index.nalloc)
+    {
+      struct archelp_index_entry *n;
+      grub_size_t nalloc = member_index.nalloc ? 2 * member_index.nalloc : 16;
+
+      n = grub_realloc (member_index.entries, nalloc * sizeof (*n));
+      if (!n)
+	goto dead;
+      member_index.entries = n;
+      member_index.nalloc = nalloc;
+    }
+
+  ent = &member_index.entries[member_index.nentries];
+  ent->name = grub_strdup (name);
+  if (!ent->name)
+    goto dead;
+  ent->linkname = NULL;
+  if ((mode & GRUB_ARCHELP_ATTR_TYPE) == GRUB_ARCHELP_ATTR_LNK
+      && arcops->get_link_target)
+    {
+      ent->linkname = arcops->get_link_target (data);
+      if (!ent->linkname)
+	{
+	  grub_free (ent->name);
+	  goto dead;
+	}
+    }
+  ent->mtime = mtime;
+  ent->mode = mode;
+  arcops->get_pos (data, ent->pos);
+  member_index.nentries++;
+  member_index.cursor = member_index.nentries;
+  return;
+
+dead:
+  /* The scan itself is unaffected; just stop indexing.  */
+  grub_errno = GRUB_ERR_NONE;
+  member_index.dead = 1;
+}
+
+/* Every call of grub_archelp_dir / grub_archelp_open is one scanning
+   session over freshly mounted data, i.e. positioned at the start of
+   the archive.  Pointer identity of DATA is only meaningful within a
+   session (allocators reuse addresses across mounts), so sessions are
+   opened explicitly.  */
+static void
+archelp_session_begin (struct grub_archelp_data *data,
+		       struct grub_archelp_ops *arcops)
+{
+  member_index.cur_linkname = NULL;
+  if (!index_capable (arcops))
+    return;
+  if (!index_matches (data, arcops) || member_index.dead)
+    index_reset (data, arcops);
+  member_index.cur_data = data;
+  member_index.cursor = 0;
+}
+
+static grub_err_t
+archelp_find_file (struct grub_archelp_data *data,
+		   struct grub_archelp_ops *arcops,
+		   char **name, grub_int32_t *mtime,
+		   grub_uint32_t *mode)
+{
+  grub_err_t err;
+  int indexable = 0;
+
+  member_index.cur_linkname = NULL;
+
+  if (index_capable (arcops) && data == member_index.cur_data
+      && !member_index.dead)
+    {
+      indexable = 1;
+
+      if (member_index.cursor < member_index.nentries)
+	{
+	  struct archelp_index_entry *ent
+	    = &member_index.entries[member_index.cursor];
+
+	  *name = grub_strdup (ent->name);
+	  if (!*name)
+	    return grub_errno;
+	  if (mtime)
+	    *mtime = ent->mtime;
+	  *mode = ent->mode;
+	  arcops->set_pos (data, ent->pos);
+	  member_index.cur_linkname = ent->linkname;
+	  member_index.cursor++;
+	  return GRUB_ERR_NONE;
+	}
+
+      if (member_index.complete)
+	{
+	  *mode = GRUB_ARCHELP_ATTR_END;
+	  return GRUB_ERR_NONE;
+	}
+    }
+
+  err = arcops->find_file (data, name, mtime,
+			   (grub_archelp_mode_t *) mode);
+  if (err)
+    return err;
+
+  if (indexable && !member_index.dead
+      && member_index.cursor == member_index.nentries)
+    {
+      if (*mode == GRUB_ARCHELP_ATTR_END)
+	member_index.complete = 1;
+      else
+	index_record (data, arcops, *name, mtime ? *mtime : 0, *mode);
+    }
+
+  return GRUB_ERR_NONE;
+}
+
+static void
+archelp_rewind (struct grub_archelp_data *data,
+		struct grub_archelp_ops *arcops)
+{
+  if (index_capable (arcops) && data == member_index.cur_data)
+    member_index.cursor = 0;
+  arcops->rewind (data);
+}
+
 static inline void
 canonicalize (char *name)
 {
@@ -92,7 +296,10 @@ handle_symlink (struct grub_archelp_data *data,
   if (prefixlen)
     prefixlen++;
 
-  linktarget = arcops->get_link_target (data);
+  if (member_index.cur_linkname)
+    linktarget = grub_strdup (member_index.cur_linkname);
+  else
+    linktarget = arcops->get_link_target (data);
   if (!linktarget)
     return grub_errno;
   if (linktarget[0] == '\0')
@@ -152,6 +359,8 @@ grub_archelp_dir (struct grub_archelp_data *data,
 
   prev = 0;
 
+  archelp_session_begin (data, arcops);
+
   len = grub_strlen (path);
   while (1)
     {
@@ -159,7 +368,7 @@ grub_archelp_dir (struct grub_archelp_data *data,
       grub_uint32_t mode;
       grub_err_t err;
 
-      if (arcops->find_file (data, &name, &mtime, &mode))
+      if (archelp_find_file (data, arcops, &name, &mtime, &mode))
 	goto fail;
 
       if (mode == GRUB_ARCHELP_ATTR_END)
@@ -216,7 +425,7 @@ grub_archelp_dir (struct grub_archelp_data *data,
 				  N_("too deep nesting of symlinks"));
 		      goto fail;
 		    }
-		  arcops->rewind (data);
+		  archelp_rewind (data, arcops);
 		}
 	    }
 	}
@@ -246,13 +455,15 @@ grub_archelp_open (struct grub_archelp_data *data,
 
   canonicalize (name);
 
+  archelp_session_begin (data, arcops);
+
   while (1)
     {
       grub_uint32_t mode;
       grub_int32_t mtime;
       int restart;
 
-      if (arcops->find_file (data, &fn, &mtime, &mode))
+      if (archelp_find_file (data, arcops, &fn, &mtime, &mode))
 	goto fail;
 
       if (mode == GRUB_ARCHELP_ATTR_END)
@@ -271,7 +482,7 @@ grub_archelp_open (struct grub_archelp_data *data,
 
       if (restart)
 	{
-	  arcops->rewind (data);
+	  archelp_rewind (data, arcops);
 	  if (++symlinknest == 8)
 	    {
 	      grub_error (GRUB_ERR_SYMLINK_LOOP,
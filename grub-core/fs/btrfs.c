@@ -110,6 +110,23 @@ struct grub_btrfs_device_desc
   grub_uint64_t id;
 };
 
+struct grub_btrfs_chunk_item;
+
+/* Number of chunk descriptors remembered after resolution through the
+   chunk tree.  A boot volume rarely has more live chunks than this, so
+   in practice every chunk is resolved once per mount.  */
+#define GRUB_BTRFS_CHUNK_CACHE_SIZE 8
+
+struct grub_btrfs_chunk_cache_entry
+{
+  /* Copy of the chunk key; start and size of the cached descriptor are
+     derived from it.  An empty slot has chunk == NULL.  */
+  struct grub_btrfs_key key;
+  struct grub_btrfs_chunk_item *chunk;
+  grub_size_t chsize;
+  grub_uint64_t last_use;
+};
+
 struct grub_btrfs_data
 {
   struct grub_btrfs_superblock sblock;
@@ -128,6 +145,10 @@ struct grub_btrfs_data
   grub_size_t extsize;
   struct grub_btrfs_extent_data *extent;
   grub_uint64_t fs_tree;
+
+  /* Resolved logical->physical chunk descriptors, LRU replaced.  */
+  struct grub_btrfs_chunk_cache_entry chunk_cache[GRUB_BTRFS_CHUNK_CACHE_SIZE];
+  grub_uint64_t chunk_cache_tick;
 };
 
 struct grub_btrfs_chunk_item
@@ -905,6 +926,28 @@ grub_btrfs_read_logical (struct grub_btrfs_data *data, grub_disk_addr_t addr,
 
       grub_dprintf ("btrfs", "searching for laddr %" PRIxGRUB_UINT64_T "\n",
 		    addr);
+
+      /* Already resolved through the chunk tree before?  */
+      {
+	unsigned n;
+
+	for (n = 0; n < GRUB_BTRFS_CHUNK_CACHE_SIZE; n++)
+	  {
+	    struct grub_btrfs_chunk_cache_entry *ent = &data->chunk_cache[n];
+
+	    if (ent->chunk
+		&& grub_le_to_cpu64 (ent->key.offset) <= addr
+		&& addr < grub_le_to_cpu64 (ent->key.offset)
+		+ grub_le_to_cpu64 (ent->chunk->size))
+	      {
+		key = &ent->key;
+		chunk = ent->chunk;
+		ent->last_use = ++data->chunk_cache_tick;
+		goto chunk_found;
+	      }
+	  }
+      }
+
       for (ptr = data->sblock.bootstrap_mapping;
 	   ptr < data->sblock.bootstrap_mapping
 	   + sizeof (data->sblock.bootstrap_mapping)
@@ -971,6 +1014,25 @@ grub_btrfs_read_logical (struct grub_btrfs_data *data, grub_disk_addr_t addr,
 	  return err;
 	}
 
+      /* Hand the freshly resolved descriptor over to the chunk cache,
+	 evicting the least recently used slot, so the next read in this
+	 chunk skips the tree descent.  */
+      {
+	struct grub_btrfs_chunk_cache_entry *lru = &data->chunk_cache[0];
+	unsigned n;
+
+	for (n = 1; n < GRUB_BTRFS_CHUNK_CACHE_SIZE; n++)
+	  if (data->chunk_cache[n].last_use < lru->last_use)
+	    lru = &data->chunk_cache[n];
+	grub_free (lru->chunk);
+	lru->key = key_out;
+	lru->chunk = chunk;
+	lru->chsize = chsize;
+	lru->last_use = ++data->chunk_cache_tick;
+	key = &lru->key;
+	challoc = 0;
+      }
+
     chunk_found:
       {
 	grub_uint64_t stripen;
@@ -1441,6 +1503,8 @@ grub_btrfs_unmount (struct grub_btrfs_data *data)
   for (i = 1; i < data->n_devices_attached; i++)
     if (data->devices_attached[i].dev)
         grub_device_close (data->devices_attached[i].dev);
+  for (i = 0; i < GRUB_BTRFS_CHUNK_CACHE_SIZE; i++)
+    grub_free (data->chunk_cache[i].chunk);
   grub_free (data->devices_attached);
   grub_free (data->extent);
   grub_free (data);
@@ -134,11 +134,40 @@ grub_cpio_rewind (struct grub_archelp_data *data)
   data->next_hofs = 0;
 }
 
+static grub_disk_t
+grub_cpio_get_disk (struct grub_archelp_data *data)
+{
+  return data->disk;
+}
+
+static void
+grub_cpio_get_pos (struct grub_archelp_data *data,
+		   grub_uint64_t pos[GRUB_ARCHELP_POS_WORDS])
+{
+  pos[0] = data->hofs;
+  pos[1] = data->dofs;
+  pos[2] = data->size;
+  pos[3] = data->next_hofs;
+}
+
+static void
+grub_cpio_set_pos (struct grub_archelp_data *data,
+		   const grub_uint64_t pos[GRUB_ARCHELP_POS_WORDS])
+{
+  data->hofs = pos[0];
+  data->dofs = pos[1];
+  data->size = pos[2];
+  data->next_hofs = pos[3];
+}
+
 static struct grub_archelp_ops arcops =
   {
     .find_file = grub_cpio_find_file,
     .get_link_target = grub_cpio_get_link_target,
-    .rewind = grub_cpio_rewind
+    .rewind = grub_cpio_rewind,
+    .get_disk = grub_cpio_get_disk,
+    .get_pos = grub_cpio_get_pos,
+    .set_pos = grub_cpio_set_pos
   };
 
 static struct grub_archelp_data *
@@ -334,6 +334,18 @@ struct grub_fshelp_node
   struct grub_ext2_inode inode;
   int ino;
   int inode_read;
+
+  /* Lazily built mapping cache, so sequential reads don't re-walk the
+     mapping tree from the root for every file block.  For extent-based
+     inodes this holds the extent run containing the most recently
+     mapped block (map_len == 0 means invalid); for classic inodes it
+     holds the location of the last-level indirect block.  */
+  grub_disk_addr_t map_fileblock;
+  grub_disk_addr_t map_physblock;
+  grub_disk_addr_t map_len;
+  grub_disk_addr_t ind_first;
+  grub_disk_addr_t ind_phys;
+  int ind_valid;
 };
 
 /* Information about a "mounted" ext2 filesystem.  */
@@ -474,6 +486,14 @@ grub_ext2_read_block (grub_fshelp_node_t node, grub_disk_addr_t fileblock)
   int log_perblock = log2_blksz + 9 - 2;
   grub_uint32_t indir;
   int shift;
+  grub_disk_addr_t orig_fileblock = fileblock;
+
+  /* Served by the extent-run cache?  */
+  if (node->map_len
+      && fileblock >= node->map_fileblock
+      && fileblock - node->map_fileblock < node->map_len)
+    return node->map_physblock
+      ? node->map_physblock + (fileblock - node->map_fileblock) : 0;
 
   if (inode->flags & grub_cpu_to_le32_compile_time (EXT4_EXTENTS_FLAG))
     {
@@ -498,9 +518,47 @@ grub_ext2_read_block (grub_fshelp_node_t node, grub_disk_addr_t fileblock)
 
       if (--i >= 0)
         {
+	  grub_uint16_t raw_len = grub_le_to_cpu16 (ext[i].len);
+	  grub_uint16_t ext_len = raw_len;
+	  int unwritten = 0;
+
+	  /* Lengths above 32768 mark an unwritten (preallocated)
+	     extent: the blocks are assigned but their content was never
+	     written and must read back as zeros.  */
+	  if (raw_len > 0x8000)
+	    {
+	      unwritten = 1;
+	      ext_len = raw_len - 0x8000;
+	    }
+
           fileblock -= grub_le_to_cpu32 (ext[i].block);
-          if (fileblock >= grub_le_to_cpu16 (ext[i].len))
-	    ret = 0;
+          if (fileblock >= ext_len)
+	    {
+	      ret = 0;
+
+	      /* Remember the hole up to the next extent in this leaf,
+		 so a long sparse region doesn't re-walk the tree for
+		 every block.  */
+	      if (i + 1 < grub_le_to_cpu16 (leaf->entries)
+		  && grub_le_to_cpu32 (ext[i + 1].block)
+		  > grub_le_to_cpu32 (ext[i].block) + ext_len)
+		{
+		  node->map_fileblock = grub_le_to_cpu32 (ext[i].block)
+		    + ext_len;
+		  node->map_physblock = 0;
+		  node->map_len = grub_le_to_cpu32 (ext[i + 1].block)
+		    - node->map_fileblock;
+		}
+	    }
+	  else if (unwritten)
+	    {
+	      /* Zero-fill without touching the disk; cache the run like
+		 a mapped extent.  */
+	      node->map_fileblock = grub_le_to_cpu32 (ext[i].block);
+	      node->map_physblock = 0;
+	      node->map_len = ext_len;
+	      ret = 0;
+	    }
           else
             {
               grub_disk_addr_t start;
@@ -509,6 +567,12 @@ grub_ext2_read_block (grub_fshelp_node_t node, grub_disk_addr_t fileblock)
               start = (start << 32) + grub_le_to_cpu32 (ext[i].start);
 
               ret = fileblock + start;
+
+	      /* Remember the whole run: the following blocks of this
+		 extent map without another tree walk.  */
+	      node->map_fileblock = grub_le_to_cpu32 (ext[i].block);
+	      node->map_physblock = start;
+	      node->map_len = ext_len;
             }
         }
       else
@@ -526,6 +590,22 @@ grub_ext2_read_block (grub_fshelp_node_t node, grub_disk_addr_t fileblock)
   /* Direct blocks.  */
   if (fileblock < INDIRECT_BLOCKS)
     return grub_le_to_cpu32 (inode->blocks.dir_blocks[fileblock]);
+
+  /* Served by the cached last-level indirect block?  One short read
+     instead of re-walking up to three levels of the chain.  */
+  if (node->ind_valid && fileblock >= node->ind_first
+      && fileblock - node->ind_first < (1ULL << log_perblock))
+    {
+      if (node->ind_phys == 0)
+	return 0;
+      if (grub_disk_read (data->disk,
+			  node->ind_phys << log2_blksz,
+			  (fileblock - node->ind_first) * sizeof (indir),
+			  sizeof (indir), &indir))
+	return -1;
+      return grub_le_to_cpu32 (indir);
+    }
+
   fileblock -= INDIRECT_BLOCKS;
   /* Indirect.  */
   if (fileblock < blksz_quarter)
@@ -555,20 +635,37 @@ grub_ext2_read_block (grub_fshelp_node_t node, grub_disk_addr_t fileblock)
   return -1;
 
 indirect:
-  do {
-    /* If the indirect block is zero, all child blocks are absent
-       (i.e. filled with zeros.) */
-    if (indir == 0)
-      return 0;
-    if (grub_disk_read (data->disk,
-			((grub_disk_addr_t) grub_le_to_cpu32 (indir))
-			<< log2_blksz,
-			((fileblock >> (log_perblock * shift))
-			 & ((1 << log_perblock) - 1))
-			* sizeof (indir),
-			sizeof (indir), &indir))
-      return -1;
-  } while (shift--);
+  while (shift--)
+    {
+      /* If the indirect block is zero, all child blocks are absent
+	 (i.e. filled with zeros.) */
+      if (indir == 0)
+	return 0;
+      if (grub_disk_read (data->disk,
+			  ((grub_disk_addr_t) grub_le_to_cpu32 (indir))
+			  << log2_blksz,
+			  ((fileblock >> (log_perblock * (shift + 1)))
+			   & ((1 << log_perblock) - 1))
+			  * sizeof (indir),
+			  sizeof (indir), &indir))
+	return -1;
+    }
+
+  /* INDIR is now the last-level indirect block.  Remember where it is
+     and which file blocks it covers.  */
+  node->ind_phys = grub_le_to_cpu32 (indir);
+  node->ind_first = orig_fileblock - (fileblock & ((1 << log_perblock) - 1));
+  node->ind_valid = 1;
+
+  if (indir == 0)
+    return 0;
+  if (grub_disk_read (data->disk,
+		      ((grub_disk_addr_t) grub_le_to_cpu32 (indir))
+		      << log2_blksz,
+		      (fileblock & ((1 << log_perblock) - 1))
+		      * sizeof (indir),
+		      sizeof (indir), &indir))
+    return -1;
 
   return grub_le_to_cpu32 (indir);
 }
@@ -637,7 +734,7 @@ grub_ext2_mount (grub_disk_t disk)
 {
   struct grub_ext2_data *data;
 
-  data = grub_malloc (sizeof (struct grub_ext2_data));
+  data = grub_zalloc (sizeof (struct grub_ext2_data));
   if (!data)
     return 0;
 
@@ -805,7 +902,7 @@ grub_ext2_iterate_dir (grub_fshelp_node_t dir,
 	  if (grub_errno)
 	    return 0;
 
-	  fdiro = grub_malloc (sizeof (struct grub_fshelp_node));
+	  fdiro = grub_zalloc (sizeof (struct grub_fshelp_node));
 	  if (! fdiro)
 	    return 0;
 
@@ -970,6 +1067,14 @@ grub_ext2_dir_iter (const char *filename, enum grub_fshelp_filetype filetype,
     }
 
   info.dir = ((filetype & GRUB_FSHELP_TYPE_MASK) == GRUB_FSHELP_DIR);
+  /* size_high is only valid for regular files (it holds the directory
+     ACL for directories).  */
+  if (node->inode_read && ! info.dir)
+    {
+      info.sizeset = 1;
+      info.size = grub_cpu_to_le32 (node->inode.size)
+	| (((grub_off_t) grub_cpu_to_le32 (node->inode.size_high)) << 32);
+    }
   grub_free (node);
   return ctx->hook (filename, &info, ctx->hook_data);
 }
@@ -305,6 +305,21 @@ struct grub_f2fs_data
   char                            *nat_bitmap;
   grub_uint32_t                   nat_bitmap_size;
 
+  /* Last NAT block read by get_node_blkaddr.  Node ids used by one
+     file cluster, so consecutive lookups tend to land in the same
+     block.  */
+  struct grub_f2fs_nat_block      *nat_cache;
+  grub_uint32_t                   nat_cache_block_off;
+  int                             nat_cache_valid;
+
+  /* Last direct node block resolved by grub_f2fs_get_block, keyed by
+     inode and logical node index, so mapping consecutive data blocks
+     does not re-read the node chain.  */
+  struct grub_f2fs_node           *node_cache;
+  grub_uint32_t                   node_cache_ino;
+  grub_uint32_t                   node_cache_idx;
+  int                             node_cache_valid;
+
   grub_disk_t                     disk;
   struct grub_f2fs_node           *inode;
   struct grub_fshelp_node         diropen;
@@ -669,7 +684,6 @@ get_blkaddr_from_nat_journal (struct grub_f2fs_data *data, grub_uint32_t nid,
 static grub_uint32_t
 get_node_blkaddr (struct grub_f2fs_data *data, grub_uint32_t nid)
 {
-  struct grub_f2fs_nat_block *nat_block;
   grub_uint32_t seg_off, block_off, entry_off, block_addr;
   grub_uint32_t blkaddr = 0;
   grub_err_t err;
@@ -682,13 +696,20 @@ get_node_blkaddr (struct grub_f2fs_data *data, grub_uint32_t nid)
   if (blkaddr)
     return blkaddr;
 
-  nat_block = grub_malloc (F2FS_BLKSIZE);
-  if (!nat_block)
-    return 0;
-
   block_off = nid / NAT_ENTRY_PER_BLOCK;
   entry_off = nid % NAT_ENTRY_PER_BLOCK;
 
+  if (data->nat_cache_valid && data->nat_cache_block_off == block_off)
+    return grub_le_to_cpu32 (data->nat_cache->ne[entry_off].block_addr);
+
+  if (!data->nat_cache)
+    {
+      data->nat_cache = grub_malloc (F2FS_BLKSIZE);
+      if (!data->nat_cache)
+        return 0;
+    }
+  data->nat_cache_valid = 0;
+
   seg_off = block_off / data->blocks_per_seg;
   block_addr = data->nat_blkaddr +
         ((seg_off * data->blocks_per_seg) << 1) +
@@ -699,23 +720,16 @@ get_node_blkaddr (struct grub_f2fs_data *data, grub_uint32_t nid)
   if (result_bit > 0)
     block_addr += data->blocks_per_seg;
   else if (result_bit == -1)
-    {
-      grub_free (nat_block);
-      return 0;
-    }
+    return 0;
 
-  err = grub_f2fs_block_read (data, block_addr, nat_block);
+  err = grub_f2fs_block_read (data, block_addr, data->nat_cache);
   if (err)
-    {
-      grub_free (nat_block);
-      return 0;
-    }
-
-  blkaddr = grub_le_to_cpu32 (nat_block->ne[entry_off].block_addr);
+    return 0;
 
-  grub_free (nat_block);
+  data->nat_cache_block_off = block_off;
+  data->nat_cache_valid = 1;
 
-  return blkaddr;
+  return grub_le_to_cpu32 (data->nat_cache->ne[entry_off].block_addr);
 }
 
 static int
@@ -819,6 +833,16 @@ grub_f2fs_read_node (struct grub_f2fs_data *data,
   return grub_f2fs_block_read (data, blkaddr, np);
 }
 
+static void
+grub_f2fs_unmount (struct grub_f2fs_data *data)
+{
+  if (!data)
+    return;
+  grub_free (data->nat_cache);
+  grub_free (data->node_cache);
+  grub_free (data);
+}
+
 static struct grub_f2fs_data *
 grub_f2fs_mount (grub_disk_t disk)
 {
@@ -830,6 +854,10 @@ grub_f2fs_mount (grub_disk_t disk)
     return NULL;
 
   data->disk = disk;
+  data->nat_cache = NULL;
+  data->nat_cache_valid = 0;
+  data->node_cache = NULL;
+  data->node_cache_valid = 0;
 
   if (grub_f2fs_read_sb (data, F2FS_SUPER_OFFSET0))
     {
@@ -872,7 +900,7 @@ grub_f2fs_mount (grub_disk_t disk)
   return data;
 
  fail:
-  grub_free (data);
+  grub_f2fs_unmount (data);
 
   return NULL;
 }
@@ -896,9 +924,18 @@ grub_f2fs_get_block (grub_fshelp_node_t node, grub_disk_addr_t block_ofs)
   if (level == 0)
     return grub_le_to_cpu32 (inode->i_addr[offset[0]]);
 
-  node_block = grub_malloc (F2FS_BLKSIZE);
-  if (!node_block)
-    return -1;
+  if (data->node_cache_valid && data->node_cache_ino == node->ino
+      && data->node_cache_idx == noffset[level])
+    return grub_le_to_cpu32 (data->node_cache->dn.addr[offset[level]]);
+
+  if (!data->node_cache)
+    {
+      data->node_cache = grub_malloc (F2FS_BLKSIZE);
+      if (!data->node_cache)
+        return -1;
+    }
+  node_block = data->node_cache;
+  data->node_cache_valid = 0;
 
   nids[1] = get_node_id (&node->inode, offset[0], 1);
 
@@ -914,10 +951,11 @@ grub_f2fs_get_block (grub_fshelp_node_t node, grub_disk_addr_t block_ofs)
     }
 
   block_addr = grub_le_to_cpu32 (node_block->dn.addr[offset[level]]);
+  data->node_cache_ino = node->ino;
+  data->node_cache_idx = noffset[level];
+  data->node_cache_valid = 1;
 
  fail:
-  grub_free (node_block);
-
   return block_addr;
 }
 
@@ -1173,7 +1211,7 @@ grub_f2fs_dir (grub_device_t device, const char *path,
  fail:
   if (fdiro != &ctx.data->diropen)
     grub_free (fdiro);
-  grub_free (ctx.data);
+  grub_f2fs_unmount (ctx.data);
   grub_dl_unref (my_mod);
 
   return grub_errno;
@@ -1222,7 +1260,7 @@ grub_f2fs_open (struct grub_file *file, const char *name)
  fail:
   if (fdiro != &data->diropen)
     grub_free (fdiro);
-  grub_free (data);
+  grub_f2fs_unmount (data);
 
   grub_dl_unref (my_mod);
 
@@ -1244,7 +1282,7 @@ grub_f2fs_close (grub_file_t file)
 {
   struct grub_f2fs_data *data = (struct grub_f2fs_data *) file->data;
 
-  grub_free (data);
+  grub_f2fs_unmount (data);
 
   grub_dl_unref (my_mod);
 
@@ -1291,7 +1329,7 @@ grub_f2fs_label (grub_device_t device, char **label)
   else
     *label = NULL;
 
-  grub_free (data);
+  grub_f2fs_unmount (data);
   grub_dl_unref (my_mod);
 
   return grub_errno;
@@ -1327,7 +1365,7 @@ grub_f2fs_uuid (grub_device_t device, char **uuid)
   else
     *uuid = NULL;
 
-  grub_free (data);
+  grub_f2fs_unmount (data);
   grub_dl_unref (my_mod);
 
   return grub_errno;
@@ -185,6 +185,17 @@ struct grub_fat_data
   grub_uint32_t uuid;
 };
 
+/* A run of consecutive clusters in a cluster chain.  */
+struct grub_fat_run
+{
+  grub_uint32_t start;
+  grub_uint32_t len;
+};
+
+/* Number of runs remembered per file.  Chains more fragmented than
+   this fall back to walking the FAT for the tail.  */
+#define GRUB_FAT_NUM_RUNS	32
+
 struct grub_fshelp_node {
   grub_disk_t disk;
   struct grub_fat_data *data;
@@ -202,6 +213,13 @@ struct grub_fshelp_node {
 #ifdef MODE_EXFAT
   int is_contiguous;
 #endif
+
+  /* Decoded prefix of the cluster chain, filled lazily as the chain
+     is walked, so seeks and repeated reads need not re-walk the FAT.  */
+  struct grub_fat_run runs[GRUB_FAT_NUM_RUNS];
+  grub_uint32_t num_runs;
+  /* Number of clusters covered by runs[].  */
+  grub_uint32_t runs_clusters;
 };
 
 static grub_dl_t my_mod;
@@ -449,6 +467,32 @@ grub_fat_mount (grub_disk_t disk)
   return 0;
 }
 
+/* Record CLUSTER as the next cluster of NODE's decoded chain prefix.  */
+static void
+grub_fat_append_run (grub_fshelp_node_t node, grub_uint32_t cluster)
+{
+  struct grub_fat_run *run;
+
+  if (node->num_runs > 0)
+    {
+      run = &node->runs[node->num_runs - 1];
+      if (cluster == run->start + run->len)
+	{
+	  run->len++;
+	  node->runs_clusters++;
+	  return;
+	}
+    }
+
+  if (node->num_runs >= GRUB_FAT_NUM_RUNS)
+    return;
+
+  run = &node->runs[node->num_runs++];
+  run->start = cluster;
+  run->len = 1;
+  node->runs_clusters++;
+}
+
 static grub_ssize_t
 grub_fat_read_data (grub_disk_t disk, grub_fshelp_node_t node,
 		    grub_disk_read_hook_t read_hook, void *read_hook_data,
@@ -502,10 +546,36 @@ grub_fat_read_data (grub_disk_t disk, grub_fshelp_node_t node,
   logical_cluster = offset >> logical_cluster_bits;
   offset &= (1ULL << logical_cluster_bits) - 1;
 
-  if (logical_cluster < node->cur_cluster_num)
+  /* Position the cluster walker from the decoded run index whenever
+     possible instead of re-walking the FAT from the start.  */
+  if (logical_cluster < node->runs_clusters)
+    {
+      grub_uint32_t i, base = 0;
+
+      for (i = 0; logical_cluster >= base + node->runs[i].len; i++)
+	base += node->runs[i].len;
+      node->cur_cluster = node->runs[i].start + (logical_cluster - base);
+      node->cur_cluster_num = logical_cluster;
+    }
+  else if (node->runs_clusters > 0)
+    {
+      /* The target lies beyond the decoded prefix; resume the walk
+	 from its last cluster unless the walker is already between
+	 the two.  */
+      if (node->cur_cluster_num < node->runs_clusters - 1
+	  || node->cur_cluster_num > logical_cluster)
+	{
+	  struct grub_fat_run *run = &node->runs[node->num_runs - 1];
+
+	  node->cur_cluster_num = node->runs_clusters - 1;
+	  node->cur_cluster = run->start + run->len - 1;
+	}
+    }
+  else
     {
       node->cur_cluster_num = 0;
       node->cur_cluster = node->file_cluster;
+      grub_fat_append_run (node, node->file_cluster);
     }
 
   while (len)
@@ -566,6 +636,8 @@ grub_fat_read_data (grub_disk_t disk, grub_fshelp_node_t node,
 
 	  node->cur_cluster = next_cluster;
 	  node->cur_cluster_num++;
+	  if (node->cur_cluster_num == node->runs_clusters)
+	    grub_fat_append_run (node, next_cluster);
 	}
 
       /* Read the data here.  */
@@ -952,6 +1024,8 @@ static grub_err_t lookup_file (grub_fshelp_node_t node,
 	    (*foundnode)->file_cluster = node->data->root_cluster;
 #endif
 	  (*foundnode)->cur_cluster_num = ~0U;
+	  (*foundnode)->num_runs = 0;
+	  (*foundnode)->runs_clusters = 0;
 	  (*foundnode)->data = node->data;
 	  (*foundnode)->disk = node->disk;
 
@@ -1020,12 +1094,16 @@ grub_fat_dir (grub_device_t device, const char *path, grub_fs_dir_hook_t hook,
       info.mtimeset = grub_exfat_timestamp (grub_le_to_cpu32 (ctxt.entry.type_specific.file.m_time),
 					    ctxt.entry.type_specific.file.m_time_tenth,
 					    &info.mtime);
+      info.sizeset = 1;
+      info.size = ctxt.dir.file_size;
 #else
       if (ctxt.dir.attr & GRUB_FAT_ATTR_VOLUME_ID)
 	continue;
       info.mtimeset = grub_fat_timestamp (grub_le_to_cpu16 (ctxt.dir.w_time),
 					  grub_le_to_cpu16 (ctxt.dir.w_date),
 					  &info.mtime);
+      info.sizeset = 1;
+      info.size = grub_le_to_cpu32 (ctxt.dir.file_size);
 #endif
 
       if (hook (ctxt.filename, &info, hook_data))
@@ -158,6 +158,14 @@ directory_find_file (grub_fshelp_node_t node, const char *name, grub_fshelp_node
   return GRUB_ERR_NONE;
 }
 
+/*
+ * Note on caching: nodes are opaque blobs owned by the filesystem and
+ * reference per-mount state that the caller frees after each operation,
+ * so this layer cannot retain or clone them between calls.  Lookup
+ * caches that survive across operations therefore live in the
+ * individual filesystems, which know their node layout and lifetime
+ * (see the directory cache in iso9660.c for the pattern).
+ */
 static grub_err_t
 find_file (char *currpath,
 	   iterate_dir_func iterate_dir, lookup_file_func lookup_file,
@@ -361,6 +369,11 @@ grub_fshelp_read_file (grub_disk_t disk, grub_fshelp_node_t node,
 {
   grub_disk_addr_t i, blockcnt;
   int blocksize = 1 << (log2blocksize + GRUB_DISK_SECTOR_BITS);
+  /* Block reads are collected here and issued in batches through
+     grub_disk_read_multi, which merges extents that are adjacent on
+     disk.  */
+  struct grub_disk_extent vec[16];
+  grub_size_t nvec = 0;
 
   /*
    * Catch blatantly invalid log2blocksize. We could be a lot stricter, but
@@ -422,14 +435,34 @@ grub_fshelp_read_file (grub_disk_t disk, grub_fshelp_node_t node,
 	 is zero filled instead.  */
       if (blknr)
 	{
-	  disk->read_hook = read_hook;
-	  disk->read_hook_data = read_hook_data;
-
-	  grub_disk_read (disk, blknr + blocks_start, skipfirst,
-			  blockend, buf);
-	  disk->read_hook = 0;
-	  if (grub_errno)
-	    return -1;
+	  /* Blocklist callers depend on the hook firing once per block
+	     in file order, so bypass batching when a hook is set.  */
+	  if (read_hook)
+	    {
+	      disk->read_hook = read_hook;
+	      disk->read_hook_data = read_hook_data;
+
+	      grub_disk_read (disk, blknr + blocks_start, skipfirst,
+			      blockend, buf);
+	      disk->read_hook = 0;
+	      if (grub_errno)
+		return -1;
+	    }
+	  else
+	    {
+	      vec[nvec].sector = blknr + blocks_start;
+	      vec[nvec].offset = skipfirst;
+	      vec[nvec].size = blockend;
+	      vec[nvec].buf = buf;
+	      nvec++;
+
+	      if (nvec == ARRAY_SIZE (vec))
+		{
+		  if (grub_disk_read_multi (disk, vec, nvec))
+		    return -1;
+		  nvec = 0;
+		}
+	    }
 	}
       else
 	grub_memset (buf, 0, blockend);
@@ -437,5 +470,8 @@ grub_fshelp_read_file (grub_disk_t disk, grub_fshelp_node_t node,
       buf += blocksize - skipfirst;
     }
 
+  if (nvec && grub_disk_read_multi (disk, vec, nvec))
+    return -1;
+
   return len;
 }
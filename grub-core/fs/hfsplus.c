@@ -148,6 +148,20 @@ grub_hfsplus_read_block (grub_fshelp_node_t node, grub_disk_addr_t fileblock)
   grub_disk_addr_t blksleft = fileblock;
   struct grub_hfsplus_extent *extents = node->compressed
     ? &node->resource_extents[0] : &node->extents[0];
+  struct grub_hfsplus_data *data = node->data;
+  grub_uint8_t exttype = node->compressed ? 0xff : 0;
+
+  /* If the last lookup for this fork ended up in the extent overflow
+     tree, resume from that record instead of walking the whole chain
+     again.  */
+  if (data->extcache_valid
+      && data->extcache_fileid == node->fileid
+      && data->extcache_type == exttype
+      && fileblock >= data->extcache_start)
+    {
+      extents = &data->extcache[0];
+      blksleft = fileblock - data->extcache_start;
+    }
 
   while (1)
     {
@@ -210,6 +224,13 @@ grub_hfsplus_read_block (grub_fshelp_node_t node, grub_disk_addr_t fileblock)
 	grub_hfsplus_btree_recptr (&node->data->extoverflow_tree, nnode, ptr);
       extents = (struct grub_hfsplus_extent *) (key + 1);
 
+      /* Remember this record for the next call.  */
+      grub_memcpy (data->extcache, extents, sizeof (data->extcache));
+      data->extcache_start = fileblock - blksleft;
+      data->extcache_fileid = node->fileid;
+      data->extcache_type = exttype;
+      data->extcache_valid = 1;
+
       /* The block wasn't found.  Perhaps the next iteration will find
 	 it.  The last block we found is stored in BLKSLEFT now.  */
     }
@@ -236,6 +257,18 @@ grub_hfsplus_read_file (grub_fshelp_node_t node,
 				node->data->embedded_offset);
 }
 
+/* Free DATA and the B-tree node caches hanging off it.  */
+static void
+grub_hfsplus_unmount (struct grub_hfsplus_data *data)
+{
+  if (!data)
+    return;
+  grub_free (data->catalog_tree.root_cache);
+  grub_free (data->extoverflow_tree.root_cache);
+  grub_free (data->attr_tree.root_cache);
+  grub_free (data);
+}
+
 static struct grub_hfsplus_data *
 grub_hfsplus_mount (grub_disk_t disk)
 {
@@ -254,6 +287,13 @@ grub_hfsplus_mount (grub_disk_t disk)
 
   data->disk = disk;
   data->extoverflow_tree_ready = 0;
+  data->catalog_tree.root_cache = 0;
+  data->catalog_tree.root_cache_valid = 0;
+  data->extoverflow_tree.root_cache = 0;
+  data->extoverflow_tree.root_cache_valid = 0;
+  data->attr_tree.root_cache = 0;
+  data->attr_tree.root_cache_valid = 0;
+  data->extcache_valid = 0;
 
   /* Read the bootblock.  */
   grub_disk_read (disk, GRUB_HFSPLUS_SBLOCK, 0, sizeof (volheader),
@@ -396,7 +436,7 @@ grub_hfsplus_mount (grub_disk_t disk)
   if (grub_errno == GRUB_ERR_OUT_OF_RANGE)
     grub_error (GRUB_ERR_BAD_FS, "not a HFS+ filesystem");
 
-  grub_free (data);
+  grub_hfsplus_unmount (data);
   return 0;
 }
 
@@ -603,15 +643,28 @@ grub_hfsplus_btree_search (struct grub_hfsplus_btree *btree,
 	save_node = currnode;
       node_count++;
 
-      /* Read a node.  */
-      if (grub_hfsplus_read_file (&btree->file, 0, 0,
-				  (grub_disk_addr_t) currnode
-				  * (grub_disk_addr_t) btree->nodesize,
-				  btree->nodesize, (char *) node) <= 0)
+      /* Read a node.  Every search passes through the root node, so
+	 it is kept memory-resident after the first read.  */
+      if (currnode == btree->root && btree->root_cache_valid)
+	grub_memcpy (node, btree->root_cache, btree->nodesize);
+      else if (grub_hfsplus_read_file (&btree->file, 0, 0,
+				       (grub_disk_addr_t) currnode
+				       * (grub_disk_addr_t) btree->nodesize,
+				       btree->nodesize, (char *) node) <= 0)
 	{
 	  grub_free (node);
 	  return grub_error (GRUB_ERR_BAD_FS, "couldn't read i-node");
 	}
+      else if (currnode == btree->root)
+	{
+	  if (!btree->root_cache)
+	    btree->root_cache = grub_malloc (btree->nodesize);
+	  if (btree->root_cache)
+	    {
+	      grub_memcpy (btree->root_cache, node, btree->nodesize);
+	      btree->root_cache_valid = 1;
+	    }
+	}
 
       nodedesc = (struct grub_hfsplus_btnode *) node;
 
@@ -891,7 +944,7 @@ grub_hfsplus_open (struct grub_file *file, const char *name)
  fail:
   if (data && fdiro != &data->dirroot)
     grub_free (fdiro);
-  grub_free (data);
+  grub_hfsplus_unmount (data);
 
   grub_dl_unref (my_mod);
 
@@ -908,7 +961,7 @@ grub_hfsplus_close (grub_file_t file)
   grub_free (data->opened_file.cbuf);
   grub_free (data->opened_file.compress_index);
 
-  grub_free (data);
+  grub_hfsplus_unmount (data);
 
   grub_dl_unref (my_mod);
 
@@ -987,7 +1040,7 @@ grub_hfsplus_dir (grub_device_t device, const char *path,
  fail:
   if (data && fdiro != &data->dirroot)
     grub_free (fdiro);
-  grub_free (data);
+  grub_hfsplus_unmount (data);
 
   grub_dl_unref (my_mod);
 
@@ -1023,7 +1076,7 @@ grub_hfsplus_label (grub_device_t device, char **label)
 				 grub_hfsplus_cmp_catkey_id, &node, &ptr)
       || !node)
     {
-      grub_free (data);
+      grub_hfsplus_unmount (data);
       return 0;
     }
 
@@ -1044,7 +1097,7 @@ grub_hfsplus_label (grub_device_t device, char **label)
   if (!label_name)
     {
       grub_free (node);
-      grub_free (data);
+      grub_hfsplus_unmount (data);
       return grub_errno;
     }
 
@@ -1057,7 +1110,7 @@ grub_hfsplus_label (grub_device_t device, char **label)
 	{
 	  grub_free (label_name);
 	  grub_free (node);
-	  grub_free (data);
+	  grub_hfsplus_unmount (data);
 	  return 0;
 	}
     }
@@ -1067,7 +1120,7 @@ grub_hfsplus_label (grub_device_t device, char **label)
     {
       grub_free (label_name);
       grub_free (node);
-      grub_free (data);
+      grub_hfsplus_unmount (data);
       return grub_errno;
     }
 
@@ -1076,7 +1129,7 @@ grub_hfsplus_label (grub_device_t device, char **label)
 
   grub_free (label_name);
   grub_free (node);
-  grub_free (data);
+  grub_hfsplus_unmount (data);
 
   return GRUB_ERR_NONE;
 }
@@ -1098,7 +1151,7 @@ grub_hfsplus_mtime (grub_device_t device, grub_int64_t *tm)
 
   grub_dl_unref (my_mod);
 
-  grub_free (data);
+  grub_hfsplus_unmount (data);
 
   return grub_errno;
 
@@ -1124,7 +1177,7 @@ grub_hfsplus_uuid (grub_device_t device, char **uuid)
 
   grub_dl_unref (my_mod);
 
-  grub_free (data);
+  grub_hfsplus_unmount (data);
 
   return grub_errno;
 }
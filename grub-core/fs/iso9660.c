@@ -175,6 +175,173 @@ enum
   };
 
 static grub_dl_t my_mod;
+
+/*
+ * Cache of parsed directories.
+ *
+ * Every fs operation mounts the volume afresh, so the cache is keyed by
+ * the disk id and survives across mounts: a path lookup that walks the
+ * same directories as a previous one (as `search --file' does for every
+ * candidate path) replays the parsed entries instead of re-reading the
+ * directory records and re-walking the SUSP/Rock Ridge chains.  Each
+ * cached entry keeps a template of the fshelp node; a fresh copy is
+ * handed to the iterate hook on replay since hooks take ownership.
+ *
+ * Media is assumed immutable for the session, like the disk cache does.
+ */
+
+struct iso9660_cached_entry
+{
+  struct iso9660_cached_entry *next;
+  char *filename;
+  enum grub_fshelp_filetype type;
+  grub_size_t node_size;
+  struct grub_fshelp_node *node;
+};
+
+struct iso9660_cached_dir
+{
+  struct iso9660_cached_dir *next;
+  grub_disk_addr_t extent;
+  grub_off_t size;
+  struct iso9660_cached_entry *entries;
+  struct iso9660_cached_entry **entries_end;
+};
+
+#define ISO9660_DIR_CACHE_MAX	32
+
+static unsigned long iso9660_cache_disk_id;
+static int iso9660_cache_valid;
+static struct iso9660_cached_dir *iso9660_cached_dirs;
+static grub_size_t iso9660_cached_dir_count;
+
+static void
+iso9660_dir_cache_free (struct iso9660_cached_dir *cdir)
+{
+  struct iso9660_cached_entry *ent, *next;
+
+  for (ent = cdir->entries; ent; ent = next)
+    {
+      next = ent->next;
+      grub_free (ent->filename);
+      grub_free (ent->node);
+      grub_free (ent);
+    }
+  grub_free (cdir);
+}
+
+static void
+iso9660_dir_cache_flush (void)
+{
+  struct iso9660_cached_dir *cdir, *next;
+
+  for (cdir = iso9660_cached_dirs; cdir; cdir = next)
+    {
+      next = cdir->next;
+      iso9660_dir_cache_free (cdir);
+    }
+  iso9660_cached_dirs = NULL;
+  iso9660_cached_dir_count = 0;
+  iso9660_cache_valid = 0;
+}
+
+/* Stop filling CDIR and throw it away; the directory stays uncached.  */
+static void
+iso9660_dir_cache_abandon (struct iso9660_cached_dir **cdir)
+{
+  if (*cdir)
+    {
+      iso9660_dir_cache_free (*cdir);
+      *cdir = NULL;
+    }
+}
+
+/* Size of the variable-length node allocation, matching the realloc
+   arithmetic in grub_iso9660_iterate_dir.  */
+static grub_size_t
+iso9660_node_size (const struct grub_fshelp_node *node)
+{
+  grub_size_t size = sizeof (struct grub_fshelp_node);
+
+  if (node->have_dirents > ARRAY_SIZE (node->dirents))
+    size += (node->have_dirents - ARRAY_SIZE (node->dirents))
+      * sizeof (node->dirents[0]);
+  if (node->have_symlink)
+    {
+      grub_size_t tail = sizeof (struct grub_fshelp_node)
+	+ node->have_dirents * sizeof (node->dirents[0])
+	- sizeof (node->dirents);
+
+      tail += grub_strlen ((const char *) node + tail) + 1;
+      if (tail > size)
+	size = tail;
+    }
+  return size;
+}
+
+static void
+iso9660_dir_cache_record (struct iso9660_cached_dir **cdir,
+			  const char *filename,
+			  enum grub_fshelp_filetype type,
+			  const struct grub_fshelp_node *node)
+{
+  struct iso9660_cached_entry *ent;
+  grub_size_t node_size;
+
+  if (!*cdir)
+    return;
+  if (!filename)
+    {
+      /* An entry we cannot replay; leave the directory uncached.  */
+      iso9660_dir_cache_abandon (cdir);
+      return;
+    }
+  ent = grub_zalloc (sizeof (*ent));
+  if (ent)
+    {
+      node_size = iso9660_node_size (node);
+      ent->filename = grub_strdup (filename);
+      ent->node = grub_malloc (node_size);
+      if (ent->filename && ent->node)
+	{
+	  grub_memcpy (ent->node, node, node_size);
+	  ent->node->data = NULL;
+	  ent->node_size = node_size;
+	  ent->type = type;
+	  *(*cdir)->entries_end = ent;
+	  (*cdir)->entries_end = &ent->next;
+	  return;
+	}
+      grub_free (ent->filename);
+      grub_free (ent->node);
+      grub_free (ent);
+    }
+  /* The cache is best effort; drop it and keep iterating.  */
+  iso9660_dir_cache_abandon (cdir);
+  grub_errno = GRUB_ERR_NONE;
+}
+
+static int
+iso9660_dir_cache_replay (struct iso9660_cached_dir *cdir,
+			  struct grub_iso9660_data *data,
+			  grub_fshelp_iterate_dir_hook_t hook, void *hook_data)
+{
+  struct iso9660_cached_entry *ent;
+
+  for (ent = cdir->entries; ent; ent = ent->next)
+    {
+      struct grub_fshelp_node *node;
+
+      node = grub_malloc (ent->node_size);
+      if (!node)
+	return 0;
+      grub_memcpy (node, ent->node, ent->node_size);
+      node->data = data;
+      if (hook (ent->filename, ent->type, node, hook_data))
+	return 1;
+    }
+  return 0;
+}
 
 
 static grub_err_t
@@ -683,8 +850,10 @@ susp_iterate_dir (struct grub_iso9660_susp_entry *entry,
 }
 
 static int
-grub_iso9660_iterate_dir (grub_fshelp_node_t dir,
-			  grub_fshelp_iterate_dir_hook_t hook, void *hook_data)
+grub_iso9660_iterate_dir_real (grub_fshelp_node_t dir,
+			       grub_fshelp_iterate_dir_hook_t hook,
+			       void *hook_data,
+			       struct iso9660_cached_dir **cdir)
 {
   struct grub_iso9660_dir dirent;
   grub_off_t offset = 0;
@@ -699,7 +868,10 @@ grub_iso9660_iterate_dir (grub_fshelp_node_t dir,
       ctx.was_continue = 0;
 
       if (read_node (dir, offset, sizeof (dirent), (char *) &dirent))
-	return 0;
+	{
+	  iso9660_dir_cache_abandon (cdir);
+	  return 0;
+	}
 
       /* The end of the block, skip to the next one.  */
       if (!dirent.len)
@@ -725,15 +897,24 @@ grub_iso9660_iterate_dir (grub_fshelp_node_t dir,
 	if (dir->data->rockridge
 	    && grub_iso9660_susp_iterate (dir, sua_off, sua_size,
 					  susp_iterate_dir, &ctx))
-	  return 0;
+	  {
+	    iso9660_dir_cache_abandon (cdir);
+	    return 0;
+	  }
 
 	/* Read the name.  */
 	if (read_node (dir, nameoffset, dirent.namelen, (char *) name))
-	  return 0;
+	  {
+	    iso9660_dir_cache_abandon (cdir);
+	    return 0;
+	  }
 
 	node = grub_malloc (sizeof (struct grub_fshelp_node));
 	if (!node)
-	  return 0;
+	  {
+	    iso9660_dir_cache_abandon (cdir);
+	    return 0;
+	  }
 
 	node->alloc_dirents = ARRAY_SIZE (node->dirents);
 	node->have_dirents = 1;
@@ -800,6 +981,7 @@ grub_iso9660_iterate_dir (grub_fshelp_node_t dir,
 		if (ctx.filename_alloc)
 		  grub_free (ctx.filename);
 		grub_free (node);
+		iso9660_dir_cache_abandon (cdir);
 		return 0;
 	      }
 	    if (node->have_dirents >= node->alloc_dirents)
@@ -820,6 +1002,7 @@ grub_iso9660_iterate_dir (grub_fshelp_node_t dir,
 		    if (ctx.filename_alloc)
 		      grub_free (ctx.filename);
 		    grub_free (node);
+		    iso9660_dir_cache_abandon (cdir);
 		    return 0;
 		  }
 		node = new_node;
@@ -847,6 +1030,7 @@ grub_iso9660_iterate_dir (grub_fshelp_node_t dir,
 		    if (ctx.filename_alloc)
 		      grub_free (ctx.filename);
 		    grub_free (node);
+		    iso9660_dir_cache_abandon (cdir);
 		    return 0;
 		  }
 		node = new_node;
@@ -859,6 +1043,7 @@ grub_iso9660_iterate_dir (grub_fshelp_node_t dir,
 	    ctx.symlink = 0;
 	    ctx.was_continue = 0;
 	  }
+	iso9660_dir_cache_record (cdir, ctx.filename, ctx.type, node);
 	if (hook (ctx.filename, ctx.type, node, hook_data))
 	  {
 	    if (ctx.filename_alloc)
@@ -873,6 +1058,68 @@ grub_iso9660_iterate_dir (grub_fshelp_node_t dir,
   return 0;
 }
 
+static int
+grub_iso9660_iterate_dir (grub_fshelp_node_t dir,
+			  grub_fshelp_iterate_dir_hook_t hook, void *hook_data)
+{
+  struct iso9660_cached_dir *cdir, **prev;
+  grub_disk_addr_t extent = grub_le_to_cpu32 (dir->dirents[0].first_sector);
+  grub_off_t size = get_node_size (dir);
+  int ret;
+
+  if (!iso9660_cache_valid
+      || iso9660_cache_disk_id != dir->data->disk->id)
+    {
+      iso9660_dir_cache_flush ();
+      iso9660_cache_disk_id = dir->data->disk->id;
+      iso9660_cache_valid = 1;
+    }
+
+  for (prev = &iso9660_cached_dirs; *prev; prev = &(*prev)->next)
+    if ((*prev)->extent == extent && (*prev)->size == size)
+      {
+	/* Hit: move to the front and replay the parsed entries.  */
+	cdir = *prev;
+	*prev = cdir->next;
+	cdir->next = iso9660_cached_dirs;
+	iso9660_cached_dirs = cdir;
+	return iso9660_dir_cache_replay (cdir, dir->data, hook, hook_data);
+      }
+
+  cdir = grub_zalloc (sizeof (*cdir));
+  if (cdir)
+    {
+      cdir->extent = extent;
+      cdir->size = size;
+      cdir->entries_end = &cdir->entries;
+    }
+  else
+    /* No room for the cache; iterate uncached.  */
+    grub_errno = GRUB_ERR_NONE;
+
+  ret = grub_iso9660_iterate_dir_real (dir, hook, hook_data, &cdir);
+  if (!cdir)
+    return ret;
+  if (ret)
+    {
+      /* The hook stopped the walk early; the copy is incomplete.  */
+      iso9660_dir_cache_free (cdir);
+      return ret;
+    }
+
+  cdir->next = iso9660_cached_dirs;
+  iso9660_cached_dirs = cdir;
+  if (++iso9660_cached_dir_count > ISO9660_DIR_CACHE_MAX)
+    {
+      for (prev = &iso9660_cached_dirs; (*prev)->next;
+	   prev = &(*prev)->next);
+      iso9660_dir_cache_free (*prev);
+      *prev = NULL;
+      iso9660_cached_dir_count--;
+    }
+  return ret;
+}
+
 
 
 /* Context for grub_iso9660_dir.  */
@@ -894,6 +1141,11 @@ grub_iso9660_dir_iter (const char *filename,
   grub_memset (&info, 0, sizeof (info));
   info.dir = ((filetype & GRUB_FSHELP_TYPE_MASK) == GRUB_FSHELP_DIR);
   info.mtimeset = !!iso9660_to_unixtime2 (&node->dirents[0].mtime, &info.mtime);
+  if (! info.dir)
+    {
+      info.sizeset = 1;
+      info.size = get_node_size (node);
+    }
 
   grub_free (node);
   return ctx->hook (filename, &info, ctx->hook_data);
@@ -1158,5 +1410,6 @@ GRUB_MOD_INIT(iso9660)
 
 GRUB_MOD_FINI(iso9660)
 {
+  iso9660_dir_cache_flush ();
   grub_fs_unregister (&grub_iso9660_fs);
 }
@@ -226,6 +226,16 @@ struct grub_jfs_data
   int pos;
   int linknest;
   int namecomponentlen;
+
+  /* Memo of the leaf extent the last grub_jfs_blkno call resolved,
+     so sequential reads do not re-descend the extent tree for every
+     block.  */
+  struct grub_jfs_inode *extcache_inode;
+  grub_uint32_t extcache_ino;
+  grub_uint64_t extcache_lstart;
+  grub_uint64_t extcache_lend;
+  grub_uint64_t extcache_pblk;
+  int extcache_valid;
 } GRUB_PACKED;
 
 struct grub_jfs_diropen
@@ -278,8 +288,16 @@ getblk (struct grub_jfs_treehead *treehead,
 	      && ((grub_le_to_cpu16 (extents[i].extent.length))
 		  + (extents[i].extent.length2 << 16)
 		  + grub_le_to_cpu32 (extents[i].offset2)) > blk)
-	    return (blk - grub_le_to_cpu32 (extents[i].offset2)
-		    + grub_le_to_cpu32 (extents[i].extent.blk2));
+	    {
+	      data->extcache_lstart = grub_le_to_cpu32 (extents[i].offset2);
+	      data->extcache_lend = (grub_le_to_cpu32 (extents[i].offset2)
+				     + (grub_le_to_cpu16 (extents[i].extent.length))
+				     + (extents[i].extent.length2 << 16));
+	      data->extcache_pblk = grub_le_to_cpu32 (extents[i].extent.blk2);
+	      data->extcache_valid = 1;
+	      return (blk - grub_le_to_cpu32 (extents[i].offset2)
+		      + grub_le_to_cpu32 (extents[i].extent.blk2));
+	    }
 	}
       else
 	if (blk >= grub_le_to_cpu32 (extents[i].offset2))
@@ -327,7 +345,25 @@ static grub_int64_t
 grub_jfs_blkno (struct grub_jfs_data *data, struct grub_jfs_inode *inode,
 		grub_uint64_t blk)
 {
-  return getblk (&inode->file.tree, &inode->file.extents[0], 16, data, blk);
+  grub_int64_t ret;
+
+  /* The leaf extent found by the last descent usually covers the
+     next block as well.  */
+  if (data->extcache_valid
+      && data->extcache_inode == inode
+      && data->extcache_ino == inode->inode
+      && blk >= data->extcache_lstart
+      && blk < data->extcache_lend)
+    return data->extcache_pblk + (blk - data->extcache_lstart);
+
+  data->extcache_valid = 0;
+  ret = getblk (&inode->file.tree, &inode->file.extents[0], 16, data, blk);
+  if (ret >= 0 && data->extcache_valid)
+    {
+      data->extcache_inode = inode;
+      data->extcache_ino = inode->inode;
+    }
+  return ret;
 }
 
 
@@ -399,6 +435,7 @@ grub_jfs_mount (grub_disk_t disk)
   data->disk = disk;
   data->pos = 0;
   data->linknest = 0;
+  data->extcache_valid = 0;
 
   /* Read the inode of the first fileset.  */
   if (grub_disk_read (data->disk, GRUB_JFS_FS1_INODE_BLK, 0,
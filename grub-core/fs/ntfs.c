@@ -493,11 +493,48 @@ read_attr (struct grub_ntfs_attr *at, grub_uint8_t *dest, grub_disk_addr_t ofs,
 static grub_err_t
 read_mft (struct grub_ntfs_data *data, grub_uint8_t *buf, grub_uint64_t mftno)
 {
+  struct grub_ntfs_mft_cache_entry *lru;
+  grub_size_t recsize = data->mft_size << GRUB_NTFS_BLK_SHR;
+  int i;
+
+  /* Directory iteration and repeated file operations keep coming back
+     to the same records; serve them from the cache already fixed up.  */
+  lru = &data->mft_cache[0];
+  for (i = 0; i < GRUB_NTFS_MFT_CACHE_NUM; i++)
+    {
+      struct grub_ntfs_mft_cache_entry *ent = &data->mft_cache[i];
+
+      if (ent->buf && ent->mftno == mftno)
+	{
+	  ent->last_use = ++data->mft_cache_tick;
+	  grub_memcpy (buf, ent->buf, recsize);
+	  return GRUB_ERR_NONE;
+	}
+      if (ent->last_use < lru->last_use)
+	lru = ent;
+    }
+
   if (read_attr
       (&data->mmft.attr, buf, mftno * ((grub_disk_addr_t) data->mft_size << GRUB_NTFS_BLK_SHR),
        data->mft_size << GRUB_NTFS_BLK_SHR, 0, 0, 0))
     return grub_error (GRUB_ERR_BAD_FS, "read MFT 0x%llx fails", (unsigned long long) mftno);
-  return fixup (buf, data->mft_size, (const grub_uint8_t *) "FILE");
+  if (fixup (buf, data->mft_size, (const grub_uint8_t *) "FILE"))
+    return grub_errno;
+
+  /* Cache the record after fixup, evicting the least recently used
+     slot.  Failing to allocate just means no caching.  */
+  if (!lru->buf)
+    lru->buf = grub_malloc (recsize);
+  if (lru->buf)
+    {
+      grub_memcpy (lru->buf, buf, recsize);
+      lru->mftno = mftno;
+      lru->last_use = ++data->mft_cache_tick;
+    }
+  else
+    grub_errno = GRUB_ERR_NONE;
+
+  return GRUB_ERR_NONE;
 }
 
 static grub_err_t
@@ -549,6 +586,15 @@ free_file (struct grub_ntfs_file *mft)
   grub_free (mft->buf);
 }
 
+static void
+free_mft_cache (struct grub_ntfs_data *data)
+{
+  int i;
+
+  for (i = 0; i < GRUB_NTFS_MFT_CACHE_NUM; i++)
+    grub_free (data->mft_cache[i].buf);
+}
+
 static char *
 get_utf8 (grub_uint8_t *in, grub_size_t len)
 {
@@ -969,6 +1015,7 @@ fail:
     {
       free_file (&data->mmft);
       free_file (&data->cmft);
+      free_mft_cache (data);
       grub_free (data);
     }
   return 0;
@@ -1031,6 +1078,7 @@ fail:
     {
       free_file (&data->mmft);
       free_file (&data->cmft);
+      free_mft_cache (data);
       grub_free (data);
     }
 
@@ -1080,6 +1128,7 @@ fail:
     {
       free_file (&data->mmft);
       free_file (&data->cmft);
+      free_mft_cache (data);
       grub_free (data);
     }
 
@@ -1113,6 +1162,7 @@ grub_ntfs_close (grub_file_t file)
     {
       free_file (&data->mmft);
       free_file (&data->cmft);
+      free_mft_cache (data);
       grub_free (data);
     }
 
@@ -1173,6 +1223,7 @@ fail:
     {
       free_file (&data->mmft);
       free_file (&data->cmft);
+      free_mft_cache (data);
       grub_free (data);
     }
 
@@ -1199,6 +1250,7 @@ grub_ntfs_uuid (grub_device_t device, char **uuid)
 	  *ptr = grub_toupper (*ptr);
       free_file (&data->mmft);
       free_file (&data->cmft);
+      free_mft_cache (data);
       grub_free (data);
     }
   else
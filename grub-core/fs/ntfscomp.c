@@ -61,6 +61,15 @@ decomp_get16 (struct grub_ntfs_comp *cc, grub_uint16_t * res)
 {
   grub_uint8_t c1 = 0, c2 = 0;
 
+  /* Both bytes are usually available in the cluster buffer.  */
+  if (cc->cbuf_ofs + 2 <= (1U << (cc->log_spc + GRUB_NTFS_BLK_SHR)))
+    {
+      *res = ((grub_uint16_t) cc->cbuf[cc->cbuf_ofs + 1]) * 256
+	     + ((grub_uint16_t) cc->cbuf[cc->cbuf_ofs]);
+      cc->cbuf_ofs += 2;
+      return 0;
+    }
+
   if ((decomp_getch (cc, &c1)) || (decomp_getch (cc, &c2)))
     return grub_errno;
   *res = ((grub_uint16_t) c2) * 256 + ((grub_uint16_t) c1);
@@ -128,15 +137,48 @@ decomp_block (struct grub_ntfs_comp *cc, grub_uint8_t *dest)
 		  delta = code >> dshift;
 		  len = (code & lmask) + 3;
 
-		  for (i = 0; i < len; i++)
+		  if (delta + 1 >= len)
 		    {
-		      dest[copied] = dest[copied - delta - 1];
-		      copied++;
+		      /* Source and destination do not overlap.  */
+		      grub_memcpy (&dest[copied],
+				   &dest[copied - delta - 1], len);
+		      copied += len;
 		    }
+		  else
+		    for (i = 0; i < len; i++)
+		      {
+			dest[copied] = dest[copied - delta - 1];
+			copied++;
+		      }
 		}
 	      else
 		{
 		  grub_uint8_t ch = 0;
+		  grub_uint32_t run = 1, avail;
+
+		  /* Batch consecutive literals that sit wholly inside the
+		     cluster buffer.  */
+		  while (run < bits && ! ((tag >> run) & 1))
+		    run++;
+		  if (run > (grub_uint32_t) cnt)
+		    run = cnt;
+		  if (copied + run > GRUB_NTFS_COM_LEN)
+		    run = GRUB_NTFS_COM_LEN - copied;
+		  avail = (1U << (cc->log_spc + GRUB_NTFS_BLK_SHR))
+			  - cc->cbuf_ofs;
+		  if (run > avail)
+		    run = avail;
+		  if (run > 1)
+		    {
+		      grub_memcpy (&dest[copied], &cc->cbuf[cc->cbuf_ofs],
+				   run);
+		      cc->cbuf_ofs += run;
+		      copied += run;
+		      cnt -= run;
+		      tag >>= run;
+		      bits -= run;
+		      continue;
+		    }
 
 		  if (decomp_getch (cc, &ch))
 		    return grub_errno;
@@ -225,6 +225,14 @@ struct grub_reiserfs_data
 {
   struct grub_reiserfs_superblock superblock;
   grub_disk_t disk;
+
+  /* Copy of the leaf block the last grub_reiserfs_get_item descent
+     ended in.  Keys falling between its first and last items can be
+     resolved from it directly instead of re-descending the whole
+     tree.  Freed by grub_reiserfs_unmount.  */
+  struct grub_reiserfs_block_header *leaf_cache;
+  grub_uint32_t leaf_cache_block;
+  int leaf_cache_valid;
 };
 
 static grub_ssize_t
@@ -497,6 +505,54 @@ grub_reiserfs_get_item (struct grub_reiserfs_data *data,
 
   block_size = grub_le_to_cpu16 (data->superblock.block_size);
   block_number = grub_le_to_cpu32 (data->superblock.root_block);
+
+  /* If the wanted key lies strictly inside the leaf found by the
+     previous descent, the search is bound to end in that leaf again
+     and it can be resolved without re-reading the tree.  Matches on
+     the last item fall through to the full descent, as the offset of
+     the following key is only known to the internal nodes then.  */
+  if (data->leaf_cache_valid)
+    {
+      struct grub_reiserfs_item_header *headers
+        = (struct grub_reiserfs_item_header *) (data->leaf_cache + 1);
+      int count = grub_le_to_cpu16 (data->leaf_cache->item_count);
+      int j = count;
+
+      if (count > 1
+          && grub_reiserfs_compare_keys (key, &(headers[0].key)) >= 0
+          && grub_reiserfs_compare_keys (key, &(headers[count - 1].key)) <= 0)
+        for (j = 0; j < count; j++)
+          {
+            int val = grub_reiserfs_compare_keys (key, &(headers[j].key));
+            if (val == 0)
+              break;
+            if (val < 0)
+              {
+                if (exact)
+                  j = count;
+                else
+                  j--;
+                break;
+              }
+          }
+
+      if (j >= 0 && j + 1 < count)
+        {
+          item->data = data;
+          item->block_number = data->leaf_cache_block;
+          item->block_position = j;
+          item->type = grub_reiserfs_get_key_type (&(headers[j].key));
+          grub_memcpy (&(item->header), &(headers[j]),
+                       sizeof (struct grub_reiserfs_item_header));
+          if (key->directory_id == headers[j + 1].key.directory_id
+              && key->object_id == headers[j + 1].key.object_id)
+            item->next_offset
+              = grub_reiserfs_get_key_offset (&(headers[j + 1].key));
+          else
+            item->next_offset = 0;
+          return GRUB_ERR_NONE;
+        }
+    }
 #ifdef GRUB_REISERFS_DEBUG
   grub_printf("Searching for ");
   grub_reiserfs_print_key (key);
@@ -616,6 +672,16 @@ grub_reiserfs_get_item (struct grub_reiserfs_data *data,
     }
   while (current_level > 1);
 
+  /* Remember the leaf for the next lookup.  */
+  if (! data->leaf_cache)
+    data->leaf_cache = grub_malloc (block_size);
+  if (data->leaf_cache)
+    {
+      grub_memcpy (data->leaf_cache, block_header, block_size);
+      data->leaf_cache_block = block_number;
+      data->leaf_cache_valid = 1;
+    }
+
   item->data = data;
 
   if (!block_key)
@@ -693,6 +759,8 @@ grub_reiserfs_mount (grub_disk_t disk)
       goto fail;
     }
   data->disk = disk;
+  data->leaf_cache = 0;
+  data->leaf_cache_valid = 0;
   return data;
 
  fail:
@@ -704,6 +772,16 @@ grub_reiserfs_mount (grub_disk_t disk)
   return 0;
 }
 
+/* Free DATA and the leaf cache hanging off it.  */
+static void
+grub_reiserfs_unmount (struct grub_reiserfs_data *data)
+{
+  if (! data)
+    return;
+  grub_free (data->leaf_cache);
+  grub_free (data);
+}
+
 /* Call HOOK for each file in directory ITEM.  */
 static int
 grub_reiserfs_iterate_dir (grub_fshelp_node_t item,
@@ -1038,7 +1116,7 @@ grub_reiserfs_open (struct grub_file *file, const char *name)
   assert (grub_errno != GRUB_ERR_NONE);
   if (found != &root)
     grub_free (found);
-  grub_free (data);
+  grub_reiserfs_unmount (data);
   grub_dl_unref (my_mod);
   return grub_errno;
 }
@@ -1256,7 +1334,7 @@ grub_reiserfs_close (grub_file_t file)
   struct grub_fshelp_node *node = file->data;
   struct grub_reiserfs_data *data = node->data;
 
-  grub_free (data);
+  grub_reiserfs_unmount (data);
   grub_free (node);
   grub_dl_unref (my_mod);
   return GRUB_ERR_NONE;
@@ -1317,12 +1395,12 @@ grub_reiserfs_dir (grub_device_t device, const char *path,
   if (grub_errno)
     goto fail;
   grub_reiserfs_iterate_dir (found, grub_reiserfs_dir_iter, &ctx);
-  grub_free (data);
+  grub_reiserfs_unmount (data);
   grub_dl_unref (my_mod);
   return GRUB_ERR_NONE;
 
  fail:
-  grub_free (data);
+  grub_reiserfs_unmount (data);
   grub_dl_unref (my_mod);
   return grub_errno;
 }
@@ -1349,7 +1427,7 @@ grub_reiserfs_label (grub_device_t device, char **label)
 
   grub_dl_unref (my_mod);
 
-  grub_free (data);
+  grub_reiserfs_unmount (data);
 
   return grub_errno;
 }
@@ -1384,7 +1462,7 @@ grub_reiserfs_uuid (grub_device_t device, char **uuid)
 
   grub_dl_unref (my_mod);
 
-  grub_free (data);
+  grub_reiserfs_unmount (data);
 
   return grub_errno;
 }
@@ -190,6 +190,21 @@ enum
 #define SQUASH_CHUNK_SIZE 0x2000
 #define XZBUFSIZ 0x2000
 
+/* Number of decompressed blocks kept per mount.  Metadata chunks,
+   fragment blocks and data blocks all go through it, so re-reading the
+   same inode table chunk or file tail stops re-inflating it.  */
+#define GRUB_SQUASH_CACHE_ENTRIES 8
+
+struct grub_squash_block_cache_entry
+{
+  /* On-disk offset of the compressed block.  Empty slots have
+     buf == NULL.  */
+  grub_uint64_t daddr;
+  char *buf;
+  grub_size_t size;
+  grub_uint64_t last_use;
+};
+
 struct grub_squash_data
 {
   grub_disk_t disk;
@@ -203,6 +218,8 @@ struct grub_squash_data
 			      struct grub_squash_data *data);
   struct xz_dec *xzdec;
   char *xzbuf;
+  struct grub_squash_block_cache_entry block_cache[GRUB_SQUASH_CACHE_ENTRIES];
+  grub_uint64_t block_cache_tick;
 };
 
 struct grub_fshelp_node
@@ -217,6 +234,68 @@ struct grub_fshelp_node
   } stack[1];
 };
 
+/* Return the decompressed contents of the compressed block of CSIZE
+   bytes at on-disk offset DADDR, at most OUTSIZE bytes, reading and
+   inflating it only if it isn't cached yet.  The decompressed length is
+   returned in *LEN.  The returned buffer is owned by the cache and
+   valid until the next fetch.  */
+static char *
+squash_cache_fetch (struct grub_squash_data *data, grub_uint64_t daddr,
+		    grub_size_t csize, grub_size_t outsize, grub_size_t *len)
+{
+  struct grub_squash_block_cache_entry *ent, *lru;
+  char *tmp;
+  grub_ssize_t usize;
+  unsigned i;
+
+  lru = &data->block_cache[0];
+  for (i = 0; i < GRUB_SQUASH_CACHE_ENTRIES; i++)
+    {
+      ent = &data->block_cache[i];
+      if (ent->buf && ent->daddr == daddr)
+	{
+	  ent->last_use = ++data->block_cache_tick;
+	  *len = ent->size;
+	  return ent->buf;
+	}
+      if (ent->last_use < lru->last_use)
+	lru = ent;
+    }
+
+  tmp = grub_malloc (csize);
+  if (!tmp)
+    return NULL;
+  if (grub_disk_read (data->disk, daddr >> GRUB_DISK_SECTOR_BITS,
+		      daddr & (GRUB_DISK_SECTOR_SIZE - 1), csize, tmp))
+    {
+      grub_free (tmp);
+      return NULL;
+    }
+
+  grub_free (lru->buf);
+  lru->buf = grub_zalloc (outsize);
+  if (!lru->buf)
+    {
+      grub_free (tmp);
+      return NULL;
+    }
+
+  usize = data->decompress (tmp, csize, 0, lru->buf, outsize, data);
+  grub_free (tmp);
+  if (usize < 0)
+    {
+      grub_free (lru->buf);
+      lru->buf = NULL;
+      return NULL;
+    }
+
+  lru->daddr = daddr;
+  lru->size = usize;
+  lru->last_use = ++data->block_cache_tick;
+  *len = lru->size;
+  return lru->buf;
+}
+
 static grub_err_t
 read_chunk (struct grub_squash_data *data, void *buf, grub_size_t len,
 	    grub_uint64_t chunk_start, grub_off_t offset)
@@ -255,29 +334,22 @@ read_chunk (struct grub_squash_data *data, void *buf, grub_size_t len,
 	}
       else
 	{
-	  char *tmp;
+	  char *chunk;
 	  grub_size_t bsize = grub_le_to_cpu16 (d) & ~SQUASH_CHUNK_FLAGS;
-	  grub_disk_addr_t a = chunk_start + 2;
-	  tmp = grub_malloc (bsize);
-	  if (!tmp)
-	    return grub_errno;
-	  /* FIXME: buffer uncompressed data.  */
-	  err = grub_disk_read (data->disk, (a >> GRUB_DISK_SECTOR_BITS),
-				a & (GRUB_DISK_SECTOR_SIZE - 1),
-				bsize, tmp);
-	  if (err)
-	    {
-	      grub_free (tmp);
-	      return err;
-	    }
+	  grub_size_t usize;
 
-	  if (data->decompress (tmp, bsize, offset,
-				buf, csize, data) < 0)
+	  chunk = squash_cache_fetch (data, chunk_start + 2, bsize,
+				      SQUASH_CHUNK_SIZE, &usize);
+	  if (!chunk)
+	    return grub_errno;
+	  if (usize < offset + csize)
 	    {
-	      grub_free (tmp);
-	      return grub_errno;
+	      grub_memset (buf, 0, csize);
+	      if (usize > offset)
+		grub_memcpy (buf, chunk + offset, usize - offset);
 	    }
-	  grub_free (tmp);
+	  else
+	    grub_memcpy (buf, chunk + offset, csize);
 	}
       len -= csize;
       offset += csize;
@@ -651,6 +723,10 @@ make_root_node (struct grub_squash_data *data, struct grub_fshelp_node *root)
 static void
 squash_unmount (struct grub_squash_data *data)
 {
+  unsigned i;
+
+  for (i = 0; i < GRUB_SQUASH_CACHE_ENTRIES; i++)
+    grub_free (data->block_cache[i].buf);
   if (data->xzdec)
     xz_dec_end (data->xzdec);
   grub_free (data->xzbuf);
@@ -855,31 +931,17 @@ direct_read (struct grub_squash_data *data,
 	    & grub_cpu_to_le32_compile_time (SQUASH_BLOCK_UNCOMPRESSED)))
 	{
 	  char *block;
-	  grub_size_t csize;
+	  grub_size_t csize, usize;
 	  csize = grub_le_to_cpu32 (ino->block_sizes[i]) & ~SQUASH_BLOCK_FLAGS;
-	  block = grub_malloc (csize);
-	  if (!block)
-	    return -1;
-	  err = grub_disk_read (data->disk,
-				(ino->cumulated_block_sizes[i] + a)
-				>> GRUB_DISK_SECTOR_BITS,
-				(ino->cumulated_block_sizes[i] + a)
-				& (GRUB_DISK_SECTOR_SIZE - 1),
-				csize, block);
-	  if (err)
-	    {
-	      grub_free (block);
-	      return -1;
-	    }
-	  if (data->decompress (block, csize, boff, buf, curread, data)
-	      != (grub_ssize_t) curread)
+	  block = squash_cache_fetch (data, ino->cumulated_block_sizes[i] + a,
+				      csize, data->blksz, &usize);
+	  if (!block || usize < boff + curread)
 	    {
-	      grub_free (block);
 	      if (!grub_errno)
 		grub_error (GRUB_ERR_BAD_FS, "incorrect compressed chunk");
 	      return -1;
 	    }
-	  grub_free (block);
+	  grub_memcpy (buf, block + boff, curread);
 	}
       else
 	err = grub_disk_read (data->disk,
@@ -958,32 +1020,20 @@ grub_squash_read (grub_file_t file, char *buf, grub_size_t len)
   else
     b = grub_le_to_cpu32 (ino->ino.file.offset) + off;
 
-  /* FIXME: cache uncompressed chunks.  */
   if (compressed)
     {
       char *block;
-      block = grub_malloc (grub_le_to_cpu32 (frag.size));
-      if (!block)
-	return -1;
-      err = grub_disk_read (data->disk,
-			    a >> GRUB_DISK_SECTOR_BITS,
-			    a & (GRUB_DISK_SECTOR_SIZE - 1),
-			    grub_le_to_cpu32 (frag.size), block);
-      if (err)
-	{
-	  grub_free (block);
-	  return -1;
-	}
-      if (data->decompress (block, grub_le_to_cpu32 (frag.size),
-			    b, buf, len, data)
-	  != (grub_ssize_t) len)
+      grub_size_t usize;
+
+      block = squash_cache_fetch (data, a, grub_le_to_cpu32 (frag.size),
+				  data->blksz, &usize);
+      if (!block || usize < b + len)
 	{
-	  grub_free (block);
 	  if (!grub_errno)
 	    grub_error (GRUB_ERR_BAD_FS, "incorrect compressed chunk");
 	  return -1;
 	}
-      grub_free (block);
+      grub_memcpy (buf, block + b, len);
     }
   else
     {
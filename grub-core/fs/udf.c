@@ -381,6 +381,19 @@ struct grub_udf_data
   struct grub_udf_partmap *pms[GRUB_UDF_MAX_PMS];
   struct grub_udf_long_ad root_icb;
   int npd, npm, lbshift;
+
+  /* Memo of the extent the last grub_udf_read_block call resolved,
+     so sequential reads do not re-walk the whole allocation
+     descriptor chain (and re-read its extension blocks) for every
+     file block.  The owning file is identified by the location of
+     its file entry.  */
+  grub_uint32_t ext_cache_tag_loc;
+  int ext_cache_node_part;
+  grub_uint16_t ext_cache_part;
+  grub_uint32_t ext_cache_pos;
+  grub_uint64_t ext_cache_fstart;
+  grub_uint64_t ext_cache_fend;
+  int ext_cache_valid;
 };
 
 struct grub_fshelp_node
@@ -458,6 +471,20 @@ grub_udf_read_block (grub_fshelp_node_t node, grub_disk_addr_t fileblock)
   char *ptr;
   grub_ssize_t len;
   grub_disk_addr_t filebytes;
+  grub_disk_addr_t skipped = 0;
+  struct grub_udf_data *data = node->data;
+  grub_uint32_t tag_loc = U32 (node->block.fe.tag.tag_location);
+
+  filebytes = fileblock * U32 (data->lvd.bsize);
+  if (data->ext_cache_valid
+      && data->ext_cache_tag_loc == tag_loc
+      && data->ext_cache_node_part == node->part_ref
+      && filebytes >= data->ext_cache_fstart
+      && filebytes < data->ext_cache_fend)
+    return (grub_udf_get_block (data, data->ext_cache_part,
+				data->ext_cache_pos)
+	    + ((filebytes - data->ext_cache_fstart)
+	       >> (GRUB_DISK_SECTOR_BITS + data->lbshift)));
 
   switch (U16 (node->block.fe.tag.tag_ident))
     {
@@ -481,7 +508,6 @@ grub_udf_read_block (grub_fshelp_node_t node, grub_disk_addr_t fileblock)
     {
       struct grub_udf_short_ad *ad = (struct grub_udf_short_ad *) ptr;
 
-      filebytes = fileblock * U32 (node->data->lvd.bsize);
       while (len >= (grub_ssize_t) sizeof (struct grub_udf_short_ad))
 	{
 	  grub_uint32_t adlen = U32 (ad->length) & 0x3fffffff;
@@ -519,12 +545,21 @@ grub_udf_read_block (grub_fshelp_node_t node, grub_disk_addr_t fileblock)
 	    {
 	      grub_uint32_t ad_pos = ad->position;
 	      grub_free (buf);
-	      return ((U32 (ad_pos) & GRUB_UDF_EXT_MASK) ? 0 :
-		      (grub_udf_get_block (node->data, node->part_ref, ad_pos)
-		       + (filebytes >> (GRUB_DISK_SECTOR_BITS
-					+ node->data->lbshift))));
+	      if (U32 (ad_pos) & GRUB_UDF_EXT_MASK)
+		return 0;
+	      data->ext_cache_tag_loc = tag_loc;
+	      data->ext_cache_node_part = node->part_ref;
+	      data->ext_cache_part = node->part_ref;
+	      data->ext_cache_pos = ad_pos;
+	      data->ext_cache_fstart = skipped;
+	      data->ext_cache_fend = skipped + adlen;
+	      data->ext_cache_valid = 1;
+	      return (grub_udf_get_block (node->data, node->part_ref, ad_pos)
+		      + (filebytes >> (GRUB_DISK_SECTOR_BITS
+				       + node->data->lbshift)));
 	    }
 
+	  skipped += adlen;
 	  filebytes -= adlen;
 	  ad++;
 	  len -= sizeof (struct grub_udf_short_ad);
@@ -534,7 +569,6 @@ grub_udf_read_block (grub_fshelp_node_t node, grub_disk_addr_t fileblock)
     {
       struct grub_udf_long_ad *ad = (struct grub_udf_long_ad *) ptr;
 
-      filebytes = fileblock * U32 (node->data->lvd.bsize);
       while (len >= (grub_ssize_t) sizeof (struct grub_udf_long_ad))
 	{
 	  grub_uint32_t adlen = U32 (ad->length) & 0x3fffffff;
@@ -571,15 +605,24 @@ grub_udf_read_block (grub_fshelp_node_t node, grub_disk_addr_t fileblock)
 	  if (filebytes < adlen)
 	    {
 	      grub_uint32_t ad_block_num = ad->block.block_num;
-	      grub_uint32_t ad_part_ref = ad->block.part_ref;
+	      grub_uint16_t ad_part_ref = ad->block.part_ref;
 	      grub_free (buf);
-	      return ((U32 (ad_block_num) & GRUB_UDF_EXT_MASK) ?  0 :
-		      (grub_udf_get_block (node->data, ad_part_ref,
-					   ad_block_num)
-		       + (filebytes >> (GRUB_DISK_SECTOR_BITS
-				        + node->data->lbshift))));
+	      if (U32 (ad_block_num) & GRUB_UDF_EXT_MASK)
+		return 0;
+	      data->ext_cache_tag_loc = tag_loc;
+	      data->ext_cache_node_part = node->part_ref;
+	      data->ext_cache_part = ad_part_ref;
+	      data->ext_cache_pos = ad_block_num;
+	      data->ext_cache_fstart = skipped;
+	      data->ext_cache_fend = skipped + adlen;
+	      data->ext_cache_valid = 1;
+	      return (grub_udf_get_block (node->data, ad_part_ref,
+					  ad_block_num)
+		      + (filebytes >> (GRUB_DISK_SECTOR_BITS
+				       + node->data->lbshift)));
 	    }
 
+	  skipped += adlen;
 	  filebytes -= adlen;
 	  ad++;
 	  len -= sizeof (struct grub_udf_long_ad);
@@ -642,6 +685,7 @@ grub_udf_mount (grub_disk_t disk)
     return 0;
 
   data->disk = disk;
+  data->ext_cache_valid = 0;
 
   /* Search for Anchor Volume Descriptor Pointer (AVDP)
    * and determine logical block size.  */
@@ -258,6 +258,12 @@ struct grub_xfs_data
   grub_uint32_t agsize;
   unsigned int hasftype:1;
   unsigned int hascrc:1;
+  /* Last BMBT leaf visited by grub_xfs_read_block, so that mapping
+     consecutive blocks of a B+tree format inode does not re-walk the
+     tree from the root every time.  */
+  grub_uint64_t leaf_cache_ino;
+  struct grub_xfs_btree_node *leaf_cache;
+  int leaf_cache_valid;
   struct grub_fshelp_node diropen;
 };
 
@@ -579,9 +585,32 @@ grub_xfs_read_block (grub_fshelp_node_t node, grub_disk_addr_t fileblock)
       const char *keys;
       int recoffset;
 
-      leaf = grub_malloc (node->data->bsize);
-      if (leaf == 0)
-        return 0;
+      /* Serve repeated mappings from the last leaf visited; extents
+	 within a leaf are sorted by file offset, so when the wanted
+	 block falls inside the cached range this leaf is the one the
+	 walk from the root would find.  */
+      if (node->data->leaf_cache_valid
+	  && node->data->leaf_cache_ino == node->ino)
+	{
+	  leaf = node->data->leaf_cache;
+	  nrec = grub_be_to_cpu16 (leaf->numrecs);
+	  exts = (struct grub_xfs_extent *)
+	    grub_xfs_btree_keys (node->data, leaf);
+	  if (nrec != 0
+	      && fileblock >= GRUB_XFS_EXTENT_OFFSET (exts, 0)
+	      && fileblock < (GRUB_XFS_EXTENT_OFFSET (exts, nrec - 1)
+			      + GRUB_XFS_EXTENT_SIZE (exts, nrec - 1)))
+	    goto search;
+	}
+
+      if (node->data->leaf_cache == 0)
+	{
+	  node->data->leaf_cache = grub_malloc (node->data->bsize);
+	  if (node->data->leaf_cache == 0)
+	    return 0;
+	}
+      leaf = node->data->leaf_cache;
+      node->data->leaf_cache_valid = 0;
 
       root = (struct grub_xfs_btree_root *) grub_xfs_inode_data(&node->inode);
       nrec = grub_be_to_cpu16 (root->numrecs);
@@ -604,25 +633,18 @@ grub_xfs_read_block (grub_fshelp_node_t node, grub_disk_addr_t fileblock)
 
           /* Sparse block.  */
           if (i == 0)
-            {
-              grub_free (leaf);
-              return 0;
-            }
+	    return 0;
 
           if (grub_disk_read (node->data->disk,
                               GRUB_XFS_FSB_TO_BLOCK (node->data, get_fsb (keys, i - 1 + recoffset)) << (node->data->sblock.log2_bsize - GRUB_DISK_SECTOR_BITS),
                               0, node->data->bsize, leaf))
-            {
-              grub_free (leaf);
-              return 0;
-            }
+	    return 0;
 
 	  if ((!node->data->hascrc &&
 	       grub_strncmp ((char *) leaf->magic, "BMAP", 4)) ||
 	      (node->data->hascrc &&
 	       grub_strncmp ((char *) leaf->magic, "BMA3", 4)))
             {
-              grub_free (leaf);
               grub_error (GRUB_ERR_BAD_FS, "not a correct XFS BMAP node");
               return 0;
             }
@@ -635,6 +657,8 @@ grub_xfs_read_block (grub_fshelp_node_t node, grub_disk_addr_t fileblock)
 	}
       while (leaf->level);
       exts = (struct grub_xfs_extent *) keys;
+      node->data->leaf_cache_ino = node->ino;
+      node->data->leaf_cache_valid = 1;
     }
   else if (node->inode.format == XFS_INODE_FORMAT_EXT)
     {
@@ -661,6 +685,7 @@ grub_xfs_read_block (grub_fshelp_node_t node, grub_disk_addr_t fileblock)
       return 0;
     }
 
+ search:
   /* Iterate over each extent to figure out which extent has
      the block we are looking for.  */
   for (ex = 0; ex < nrec; ex++)
@@ -679,8 +704,6 @@ grub_xfs_read_block (grub_fshelp_node_t node, grub_disk_addr_t fileblock)
         }
     }
 
-  grub_free (leaf);
-
   return GRUB_XFS_FSB_TO_BLOCK(node->data, ret);
 }
 
@@ -1055,6 +1078,15 @@ grub_xfs_mount (grub_disk_t disk)
   return 0;
 }
 
+static void
+grub_xfs_unmount (struct grub_xfs_data *data)
+{
+  if (!data)
+    return;
+  grub_free (data->leaf_cache);
+  grub_free (data);
+}
+
 
 /* Context for grub_xfs_dir.  */
 struct grub_xfs_dir_ctx
@@ -1127,7 +1159,7 @@ grub_xfs_dir (grub_device_t device, const char *path,
  fail:
   if (fdiro != &data->diropen)
     grub_free (fdiro);
-  grub_free (data);
+  grub_xfs_unmount (data);
 
  mount_fail:
 
@@ -1177,7 +1209,7 @@ grub_xfs_open (struct grub_file *file, const char *name)
  fail:
   if (fdiro != &data->diropen)
     grub_free (fdiro);
-  grub_free (data);
+  grub_xfs_unmount (data);
 
  mount_fail:
   grub_dl_unref (my_mod);
@@ -1201,7 +1233,7 @@ grub_xfs_read (grub_file_t file, char *buf, grub_size_t len)
 static grub_err_t
 grub_xfs_close (grub_file_t file)
 {
-  grub_free (file->data);
+  grub_xfs_unmount (file->data);
 
   grub_dl_unref (my_mod);
 
@@ -1225,7 +1257,7 @@ grub_xfs_label (grub_device_t device, char **label)
 
   grub_dl_unref (my_mod);
 
-  grub_free (data);
+  grub_xfs_unmount (data);
 
   return grub_errno;
 }
@@ -1256,7 +1288,7 @@ grub_xfs_uuid (grub_device_t device, char **uuid)
 
   grub_dl_unref (my_mod);
 
-  grub_free (data);
+  grub_xfs_unmount (data);
 
   return grub_errno;
 }
@@ -231,6 +231,34 @@ struct subvolume
   } *keyring;
 };
 
+/* Number of decompressed indirect blocks kept across reads.  */
+#define GRUB_ZFS_BLK_CACHE_NUM 8
+/* Number of dnode blocks kept across object lookups.  */
+#define GRUB_ZFS_DNODE_CACHE_NUM 4
+
+struct grub_zfs_blk_cache_entry
+{
+  /* First DVA and birth txg of the block pointer, in on-disk
+     representation.  */
+  grub_uint64_t dva_word[2];
+  grub_uint64_t birth;
+  /* Decompressed block, owned by the cache; NULL marks a free slot.  */
+  void *buf;
+  grub_uint64_t last_use;
+};
+
+struct grub_zfs_dnode_cache_entry
+{
+  /* Meta dnode the block was read through.  */
+  dnode_end_t mdn;
+  /* The dnode block itself; NULL marks a free slot.  */
+  dnode_phys_t *buf;
+  grub_uint64_t objnum_start;
+  grub_uint64_t objnum_end;
+  grub_zfs_endian_t endian;
+  grub_uint64_t last_use;
+};
+
 struct grub_zfs_data
 {
   /* cache for a file block of the currently zfs_open()-ed file */
@@ -238,12 +266,10 @@ struct grub_zfs_data
   grub_uint64_t file_start;
   grub_uint64_t file_end;
 
-  /* cache for a dnode block */
-  dnode_phys_t *dnode_buf;
-  dnode_phys_t *dnode_mdn;
-  grub_uint64_t dnode_start;
-  grub_uint64_t dnode_end;
-  grub_zfs_endian_t dnode_endian;
+  /* caches for dnode blocks and indirect blocks */
+  struct grub_zfs_dnode_cache_entry dnode_cache[GRUB_ZFS_DNODE_CACHE_NUM];
+  struct grub_zfs_blk_cache_entry blk_cache[GRUB_ZFS_BLK_CACHE_NUM];
+  grub_uint64_t cache_tick;
 
   dnode_end_t mos;
   dnode_end_t dnode;
@@ -2002,6 +2028,49 @@ zio_read (blkptr_t *bp, grub_zfs_endian_t endian, void **buf,
   return GRUB_ERR_NONE;
 }
 
+/* Look BP up in the indirect block cache.  The returned buffer stays
+   owned by the cache.  */
+static void *
+zfs_blk_cache_find (struct grub_zfs_data *data, blkptr_t *bp)
+{
+  unsigned i;
+
+  if (BP_IS_EMBEDDED (bp))
+    return NULL;
+  for (i = 0; i < GRUB_ZFS_BLK_CACHE_NUM; i++)
+    if (data->blk_cache[i].buf
+	&& data->blk_cache[i].dva_word[0] == bp->blk_dva[0].dva_word[0]
+	&& data->blk_cache[i].dva_word[1] == bp->blk_dva[0].dva_word[1]
+	&& data->blk_cache[i].birth == bp->blk_birth)
+      {
+	data->blk_cache[i].last_use = ++data->cache_tick;
+	return data->blk_cache[i].buf;
+      }
+  return NULL;
+}
+
+/* Remember the decompressed block BUF of BP, taking ownership of BUF.
+   Returns 1 if ownership was taken.  */
+static int
+zfs_blk_cache_store (struct grub_zfs_data *data, blkptr_t *bp, void *buf)
+{
+  unsigned i;
+  struct grub_zfs_blk_cache_entry *lru = &data->blk_cache[0];
+
+  if (BP_IS_EMBEDDED (bp))
+    return 0;
+  for (i = 1; i < GRUB_ZFS_BLK_CACHE_NUM; i++)
+    if (data->blk_cache[i].last_use < lru->last_use)
+      lru = &data->blk_cache[i];
+  grub_free (lru->buf);
+  lru->buf = buf;
+  lru->dva_word[0] = bp->blk_dva[0].dva_word[0];
+  lru->dva_word[1] = bp->blk_dva[0].dva_word[1];
+  lru->birth = bp->blk_birth;
+  lru->last_use = ++data->cache_tick;
+  return 1;
+}
+
 /*
  * Get the block from a block id.
  * push the block onto the stack.
@@ -2014,6 +2083,7 @@ dmu_read (dnode_end_t * dn, grub_uint64_t blkid, void **buf,
   int level;
   grub_off_t idx;
   blkptr_t *bp_array = dn->dn.dn_blkptr;
+  int bp_array_owned = 0;
   int epbs = dn->dn.dn_indblkshift - SPA_BLKPTRSHIFT;
   blkptr_t *bp;
   void *tmpbuf = 0;
@@ -2030,10 +2100,11 @@ dmu_read (dnode_end_t * dn, grub_uint64_t blkid, void **buf,
       grub_dprintf ("zfs", "endian = %d\n", endian);
       idx = (blkid >> (epbs * level)) & ((1 << epbs) - 1);
       *bp = bp_array[idx];
-      if (bp_array != dn->dn.dn_blkptr)
+      if (bp_array_owned)
 	{
 	  grub_free (bp_array);
 	  bp_array = 0;
+	  bp_array_owned = 0;
 	}
 
       if (BP_IS_HOLE (bp))
@@ -2059,13 +2130,21 @@ dmu_read (dnode_end_t * dn, grub_uint64_t blkid, void **buf,
 	  break;
 	}
       grub_dprintf ("zfs", "endian = %d\n", endian);
+      tmpbuf = zfs_blk_cache_find (data, bp);
+      if (tmpbuf)
+	{
+	  endian = (grub_zfs_to_cpu64 (bp->blk_prop, endian) >> 63) & 1;
+	  bp_array = tmpbuf;
+	  continue;
+	}
       err = zio_read (bp, endian, &tmpbuf, 0, data);
       endian = (grub_zfs_to_cpu64 (bp->blk_prop, endian) >> 63) & 1;
       if (err)
 	break;
       bp_array = tmpbuf;
+      bp_array_owned = !zfs_blk_cache_store (data, bp, tmpbuf);
     }
-  if (bp_array != dn->dn.dn_blkptr)
+  if (bp_array_owned)
     grub_free (bp_array);
   if (endian_out)
     *endian_out = endian;
@@ -2678,40 +2757,43 @@ dnode_get (dnode_end_t * mdn, grub_uint64_t objnum, grub_uint8_t type,
   blkid = objnum >> epbs;
   idx = objnum & ((1 << epbs) - 1);
 
-  if (data->dnode_buf != NULL && grub_memcmp (data->dnode_mdn, mdn,
-					      sizeof (*mdn)) == 0
-      && objnum >= data->dnode_start && objnum < data->dnode_end)
-    {
-      grub_memmove (&(buf->dn), &(data->dnode_buf)[idx], DNODE_SIZE);
-      buf->endian = data->dnode_endian;
-      if (type && buf->dn.dn_type != type)
-	return grub_error(GRUB_ERR_BAD_FS, "incorrect dnode type");
-      return GRUB_ERR_NONE;
-    }
+  {
+    struct grub_zfs_dnode_cache_entry *ent, *lru;
 
-  grub_dprintf ("zfs", "endian = %d, blkid=%llx\n", mdn->endian,
-		(unsigned long long) blkid);
-  err = dmu_read (mdn, blkid, &dnbuf, &endian, data);
-  if (err)
-    return err;
-  grub_dprintf ("zfs", "alive\n");
+    lru = &data->dnode_cache[0];
+    for (ent = data->dnode_cache;
+	 ent < data->dnode_cache + GRUB_ZFS_DNODE_CACHE_NUM; ent++)
+      {
+	if (ent->buf != NULL && grub_memcmp (&ent->mdn, mdn,
+					     sizeof (*mdn)) == 0
+	    && objnum >= ent->objnum_start && objnum < ent->objnum_end)
+	  {
+	    ent->last_use = ++data->cache_tick;
+	    grub_memmove (&(buf->dn), &ent->buf[idx], DNODE_SIZE);
+	    buf->endian = ent->endian;
+	    if (type && buf->dn.dn_type != type)
+	      return grub_error(GRUB_ERR_BAD_FS, "incorrect dnode type");
+	    return GRUB_ERR_NONE;
+	  }
+	if (ent->last_use < lru->last_use)
+	  lru = ent;
+      }
 
-  grub_free (data->dnode_buf);
-  grub_free (data->dnode_mdn);
-  data->dnode_mdn = grub_malloc (sizeof (*mdn));
-  if (! data->dnode_mdn)
-    {
-      grub_errno = GRUB_ERR_NONE;
-      data->dnode_buf = 0;
-    }
-  else
-    {
-      grub_memcpy (data->dnode_mdn, mdn, sizeof (*mdn));
-      data->dnode_buf = dnbuf;
-      data->dnode_start = blkid << epbs;
-      data->dnode_end = (blkid + 1) << epbs;
-      data->dnode_endian = endian;
-    }
+    grub_dprintf ("zfs", "endian = %d, blkid=%llx\n", mdn->endian,
+		  (unsigned long long) blkid);
+    err = dmu_read (mdn, blkid, &dnbuf, &endian, data);
+    if (err)
+      return err;
+    grub_dprintf ("zfs", "alive\n");
+
+    grub_free (lru->buf);
+    grub_memcpy (&lru->mdn, mdn, sizeof (*mdn));
+    lru->buf = dnbuf;
+    lru->objnum_start = blkid << epbs;
+    lru->objnum_end = (blkid + 1) << epbs;
+    lru->endian = endian;
+    lru->last_use = ++data->cache_tick;
+  }
 
   grub_memmove (&(buf->dn), (dnode_phys_t *) dnbuf + idx, DNODE_SIZE);
   buf->endian = endian;
@@ -3622,8 +3704,10 @@ zfs_unmount (struct grub_zfs_data *data)
   for (i = 0; i < data->n_devices_attached; i++)
     unmount_device (&data->devices_attached[i]);
   grub_free (data->devices_attached);
-  grub_free (data->dnode_buf);
-  grub_free (data->dnode_mdn);
+  for (i = 0; i < GRUB_ZFS_DNODE_CACHE_NUM; i++)
+    grub_free (data->dnode_cache[i].buf);
+  for (i = 0; i < GRUB_ZFS_BLK_CACHE_NUM; i++)
+    grub_free (data->blk_cache[i].buf);
   grub_free (data->file_buf);
   for (i = 0; i < data->subvol.nkeys; i++)
     grub_crypto_cipher_close (data->subvol.keyring[i].cipher);
@@ -68,9 +68,33 @@ fletcher_4 (const void *buf, grub_uint64_t size, grub_zfs_endian_t endian,
   const grub_uint32_t *ipend = ip + (size / sizeof (grub_uint32_t));
   grub_uint64_t a, b, c, d;
 
-  for (a = b = c = d = 0; ip < ipend; ip++)
+  a = b = c = d = 0;
+
+  /* Consume four words per iteration using the closed form of four
+     chained updates:
+	a' = a + (w0 + w1 + w2 + w3)
+	b' = b + 4a + (4w0 + 3w1 + 2w2 + w3)
+	c' = c + 4b + 10a + (10w0 + 6w1 + 3w2 + w3)
+	d' = d + 4c + 10b + 20a + (20w0 + 10w1 + 4w2 + w3)
+     This breaks the one-word-per-cycle dependency chain of the naive
+     loop; this checksum runs over every block ZFS reads, so it shows
+     up prominently in boot profiles.  */
+  for (; ip + 4 <= ipend; ip += 4)
+    {
+      grub_uint64_t w0 = grub_zfs_to_cpu32 (ip[0], endian);
+      grub_uint64_t w1 = grub_zfs_to_cpu32 (ip[1], endian);
+      grub_uint64_t w2 = grub_zfs_to_cpu32 (ip[2], endian);
+      grub_uint64_t w3 = grub_zfs_to_cpu32 (ip[3], endian);
+
+      d += 4 * c + 10 * b + 20 * a + (20 * w0 + 10 * w1 + 4 * w2 + w3);
+      c += 4 * b + 10 * a + (10 * w0 + 6 * w1 + 3 * w2 + w3);
+      b += 4 * a + (4 * w0 + 3 * w1 + 2 * w2 + w3);
+      a += w0 + w1 + w2 + w3;
+    }
+
+  for (; ip < ipend; ip++)
     {
-      a += grub_zfs_to_cpu32 (ip[0], endian);;
+      a += grub_zfs_to_cpu32 (ip[0], endian);
       b += a;
       c += b;
       d += c;
@@ -31,6 +31,183 @@
 #include <grub/fontformat.h>
 #include <grub/gfxmenu_view.h>
 
+/* Lay STR out once: shape it, compose every glyph into a single 1-bit
+   scratch surface and remember the extents.  Components keep the
+   result across frames, so a redraw costs one blit instead of a
+   per-character trip through metrics, glyph lookup and the blit
+   pipeline.  Returns NULL on failure with grub_errno set.  */
+grub_font_string_layout_t
+grub_font_layout_string (const char *str, grub_font_t font)
+{
+  int x;
+  grub_uint32_t *logical;
+  grub_ssize_t logical_len, visual_len;
+  struct grub_unicode_glyph *visual, *ptr;
+  struct grub_font_glyph **glyphs = NULL;
+  grub_font_string_layout_t layout = NULL;
+  int min_left = 0, max_right = 0, min_top = 0, max_bottom = 0;
+  int have_bounds = 0;
+  grub_ssize_t k;
+
+  logical_len = grub_utf8_to_ucs4_alloc (str, &logical, 0);
+  if (logical_len < 0)
+    return NULL;
+
+  visual_len = grub_bidi_logical_to_visual (logical, logical_len, &visual,
+					    0, 0, 0, 0, 0, 0, 0);
+  grub_free (logical);
+  if (visual_len < 0)
+    return NULL;
+
+  layout = grub_zalloc (sizeof (*layout));
+  if (!layout)
+    goto fail;
+
+  glyphs = grub_malloc (visual_len * sizeof (*glyphs));
+  if (!glyphs && visual_len)
+    goto fail;
+
+  for (k = 0, x = 0; k < visual_len; k++)
+    {
+      struct grub_font_glyph *glyph;
+
+      glyph = grub_font_construct_glyph (font, &visual[k]);
+      if (!glyph)
+	goto fail;
+      glyphs[k] = glyph;
+      if (glyph->width && glyph->height)
+	{
+	  int l = x + glyph->offset_x;
+	  int r = l + glyph->width;
+	  int t = -(glyph->offset_y + glyph->height);
+	  int b = -glyph->offset_y;
+
+	  if (!have_bounds || l < min_left)
+	    min_left = l;
+	  if (!have_bounds || r > max_right)
+	    max_right = r;
+	  if (!have_bounds || t < min_top)
+	    min_top = t;
+	  if (!have_bounds || b > max_bottom)
+	    max_bottom = b;
+	  have_bounds = 1;
+	}
+      x += glyph->device_width;
+    }
+
+  layout->advance = x;
+
+  /* Strings with no visible pixels keep a NULL surface; drawing them
+     is a no-op but the advance still positions neighbours.  */
+  if (have_bounds)
+    {
+      int width = max_right - min_left;
+      int height = max_bottom - min_top;
+
+      layout->scratch = grub_zalloc (((grub_size_t) width * height + 7) / 8);
+      if (!layout->scratch)
+	goto fail;
+      layout->width = width;
+      layout->height = height;
+      layout->min_left = min_left;
+      layout->min_top = min_top;
+
+      for (k = 0, x = 0; k < visual_len; k++)
+	{
+	  struct grub_font_glyph *glyph = glyphs[k];
+	  int dx = x + glyph->offset_x - min_left;
+	  int dy = -(glyph->offset_y + glyph->height) - min_top;
+	  unsigned i, j, src_bit, tgt_bit, src_byte, tgt_byte;
+
+	  for (i = 0; i < glyph->height; i++)
+	    {
+	      src_bit = (glyph->width * i) % 8;
+	      src_byte = (glyph->width * i) / 8;
+	      tgt_bit = (width * (dy + i) + dx) % 8;
+	      tgt_byte = (width * (dy + i) + dx) / 8;
+	      for (j = 0; j < glyph->width; j++)
+		{
+		  layout->scratch[tgt_byte]
+		    |= ((glyph->bitmap[src_byte] << src_bit) & 0x80) >> tgt_bit;
+		  src_bit++;
+		  tgt_bit++;
+		  if (src_bit == 8)
+		    {
+		      src_byte++;
+		      src_bit = 0;
+		    }
+		  if (tgt_bit == 8)
+		    {
+		      tgt_byte++;
+		      tgt_bit = 0;
+		    }
+		}
+	    }
+	  x += glyph->device_width;
+	}
+    }
+
+  grub_free (glyphs);
+  for (ptr = visual; ptr < visual + visual_len; ptr++)
+    grub_unicode_destroy_glyph (ptr);
+  grub_free (visual);
+  return layout;
+
+fail:
+  grub_free (glyphs);
+  for (ptr = visual; ptr < visual + visual_len; ptr++)
+    grub_unicode_destroy_glyph (ptr);
+  grub_free (visual);
+  grub_font_layout_free (layout);
+  return NULL;
+}
+
+/* Blit a prepared layout.  The y coordinate designates the baseline,
+   the x coordinate the pen start, as with grub_font_draw_string.  */
+grub_err_t
+grub_font_layout_draw (grub_font_string_layout_t layout,
+		       grub_video_color_t color,
+		       int left_x, int baseline_y)
+{
+  struct grub_video_bitmap bitmap;
+
+  if (!layout->scratch)
+    return GRUB_ERR_NONE;
+
+  grub_memset (&bitmap, 0, sizeof (bitmap));
+  bitmap.mode_info.width = layout->width;
+  bitmap.mode_info.height = layout->height;
+  bitmap.mode_info.mode_type
+    = (1 << GRUB_VIDEO_MODE_TYPE_DEPTH_POS) | GRUB_VIDEO_MODE_TYPE_1BIT_BITMAP;
+  bitmap.mode_info.blit_format = GRUB_VIDEO_BLIT_FORMAT_1BIT_PACKED;
+  bitmap.mode_info.bpp = 1;
+  /* Really 1 bit per pixel.  */
+  bitmap.mode_info.bytes_per_pixel = 0;
+  /* Packed densely as bits.  */
+  bitmap.mode_info.pitch = layout->width;
+  bitmap.mode_info.number_of_colors = 2;
+  grub_video_unmap_color (color,
+			  &bitmap.mode_info.fg_red,
+			  &bitmap.mode_info.fg_green,
+			  &bitmap.mode_info.fg_blue,
+			  &bitmap.mode_info.fg_alpha);
+  bitmap.data = layout->scratch;
+
+  return grub_video_blit_bitmap (&bitmap, GRUB_VIDEO_BLIT_BLEND,
+				 left_x + layout->min_left,
+				 baseline_y + layout->min_top,
+				 0, 0, layout->width, layout->height);
+}
+
+void
+grub_font_layout_free (grub_font_string_layout_t layout)
+{
+  if (!layout)
+    return;
+  grub_free (layout->scratch);
+  grub_free (layout);
+}
+
 /* Draw a UTF-8 string of text on the current video render target.
    The x coordinate specifies the starting x position for the first character,
    while the y coordinate specifies the baseline position.
@@ -45,8 +222,19 @@ grub_font_draw_string (const char *str, grub_font_t font,
   grub_uint32_t *logical;
   grub_ssize_t logical_len, visual_len;
   struct grub_unicode_glyph *visual, *ptr;
+  grub_font_string_layout_t layout;
   grub_err_t err;
 
+  layout = grub_font_layout_string (str, font);
+  if (layout)
+    {
+      err = grub_font_layout_draw (layout, color, left_x, baseline_y);
+      grub_font_layout_free (layout);
+      return err;
+    }
+  /* Not enough memory to batch; draw glyph by glyph.  */
+  grub_errno = GRUB_ERR_NONE;
+
   logical_len = grub_utf8_to_ucs4_alloc (str, &logical, 0);
   if (logical_len < 0)
     return grub_errno;
@@ -46,6 +46,16 @@ struct grub_gui_circular_progress
   char *tick_file;
   struct grub_video_bitmap *center_bitmap;
   struct grub_video_bitmap *tick_bitmap;
+  /* Tick positions precomputed for the current geometry, so repaints
+     driven by the timeout tick do not redo the trigonometry.  */
+  int *tick_x;
+  int *tick_y;
+  int cache_width;
+  int cache_height;
+  int cache_tick_width;
+  int cache_tick_height;
+  unsigned cache_num_ticks;
+  int cache_start_angle;
 };
 
 typedef struct grub_gui_circular_progress *circular_progress_t;
@@ -55,6 +65,8 @@ circprog_destroy (void *vself)
 {
   circular_progress_t self = vself;
   grub_gfxmenu_timeout_unregister ((grub_gui_component_t) self);
+  grub_free (self->tick_x);
+  grub_free (self->tick_y);
   grub_free (self);
 }
 
@@ -110,6 +122,59 @@ check_pixmaps (circular_progress_t self)
   return (self->center_bitmap != 0 && self->tick_bitmap != 0);
 }
 
+/* Return the tick positions for the current geometry, computing them
+   only when it changed.  Returns 0 when no cache could be allocated;
+   the caller then computes positions inline.  */
+static int
+circprog_update_ticks (circular_progress_t self, int width, int height,
+		       int tick_width, int tick_height, int radius)
+{
+  unsigned i;
+
+  if (self->tick_x
+      && self->cache_width == width && self->cache_height == height
+      && self->cache_tick_width == tick_width
+      && self->cache_tick_height == tick_height
+      && self->cache_num_ticks == self->num_ticks
+      && self->cache_start_angle == self->start_angle)
+    return 1;
+
+  grub_free (self->tick_x);
+  grub_free (self->tick_y);
+  self->tick_x = grub_malloc (self->num_ticks * sizeof (*self->tick_x));
+  self->tick_y = grub_malloc (self->num_ticks * sizeof (*self->tick_y));
+  if (!self->tick_x || !self->tick_y)
+    {
+      grub_free (self->tick_x);
+      grub_free (self->tick_y);
+      self->tick_x = 0;
+      self->tick_y = 0;
+      grub_errno = GRUB_ERR_NONE;
+      return 0;
+    }
+
+  for (i = 0; i < self->num_ticks; i++)
+    {
+      int angle = self->start_angle
+	+ i * GRUB_TRIG_ANGLE_MAX / self->num_ticks;
+
+      self->tick_x[i] = width / 2
+	+ (grub_cos (angle) * radius / GRUB_TRIG_FRACTION_SCALE)
+	- tick_width / 2;
+      self->tick_y[i] = height / 2
+	+ (grub_sin (angle) * radius / GRUB_TRIG_FRACTION_SCALE)
+	- tick_height / 2;
+    }
+
+  self->cache_width = width;
+  self->cache_height = height;
+  self->cache_tick_width = tick_width;
+  self->cache_tick_height = tick_height;
+  self->cache_num_ticks = self->num_ticks;
+  self->cache_start_angle = self->start_angle;
+  return 1;
+}
+
 static void
 circprog_paint (void *vself, const grub_video_rect_t *region)
 {
@@ -163,6 +228,9 @@ circprog_paint (void *vself, const grub_video_rect_t *region)
 	  tick_end = nticks;
 	}
 
+      int cached = circprog_update_ticks (self, width, height,
+					  tick_width, tick_height, radius);
+
       unsigned i;
       for (i = tick_begin; i < tick_end; i++)
 	{
@@ -170,15 +238,23 @@ circprog_paint (void *vself, const grub_video_rect_t *region)
 	  int y;
 	  int angle;
 
-	  /* Calculate the location of the tick.  */
-	  angle = self->start_angle
-	    + i * GRUB_TRIG_ANGLE_MAX / self->num_ticks;
-	  x = width / 2 + (grub_cos (angle) * radius / GRUB_TRIG_FRACTION_SCALE);
-	  y = height / 2 + (grub_sin (angle) * radius / GRUB_TRIG_FRACTION_SCALE);
-
-	  /* Adjust (x,y) so the tick is centered.  */
-	  x -= tick_width / 2;
-	  y -= tick_height / 2;
+	  if (cached)
+	    {
+	      x = self->tick_x[i];
+	      y = self->tick_y[i];
+	    }
+	  else
+	    {
+	      /* Calculate the location of the tick.  */
+	      angle = self->start_angle
+		+ i * GRUB_TRIG_ANGLE_MAX / self->num_ticks;
+	      x = width / 2 + (grub_cos (angle) * radius / GRUB_TRIG_FRACTION_SCALE);
+	      y = height / 2 + (grub_sin (angle) * radius / GRUB_TRIG_FRACTION_SCALE);
+
+	      /* Adjust (x,y) so the tick is centered.  */
+	      x -= tick_width / 2;
+	      y -= tick_height / 2;
+	    }
 
 	  /* Draw the tick.  */
 	  grub_video_blit_bitmap (self->tick_bitmap, GRUB_VIDEO_BLIT_BLEND,
@@ -216,15 +292,19 @@ circprog_get_bounds (void *vself, grub_video_rect_t *bounds)
   *bounds = self->bounds;
 }
 
-static void
+static int
 circprog_set_state (void *vself, int visible, int start,
 		    int current, int end)
 {
   circular_progress_t self = vself;  
+  int changed = (visible != self->visible || start != self->start
+		 || current != self->value || end != self->end);
+
   self->visible = visible;
   self->start = start;
   self->value = current;
   self->end = end;
+  return changed;
 }
 
 static int
@@ -24,6 +24,11 @@
 #include <grub/bitmap.h>
 #include <grub/bitmap_scale.h>
 
+/* Number of scaled versions of the image kept around.  Two is enough
+   for the sizes a theme typically alternates between, e.g. the selected
+   and unselected variants of a menu item decoration.  */
+#define SCALE_CACHE_SIZE	2
+
 struct grub_gui_image
 {
   struct grub_gui_component component;
@@ -34,18 +39,41 @@ struct grub_gui_image
   char *theme_dir;
   struct grub_video_bitmap *raw_bitmap;
   struct grub_video_bitmap *bitmap;
+
+  /* Recently used scaled versions of raw_bitmap, most recent first.
+     The cache owns the bitmaps; self->bitmap is either an alias of a
+     cache entry or of raw_bitmap and is never destroyed directly.  */
+  struct
+  {
+    unsigned width;
+    unsigned height;
+    struct grub_video_bitmap *bitmap;
+  } scale_cache[SCALE_CACHE_SIZE];
 };
 
 typedef struct grub_gui_image *grub_gui_image_t;
 
+static void
+scale_cache_flush (grub_gui_image_t self)
+{
+  int i;
+
+  for (i = 0; i < SCALE_CACHE_SIZE; i++)
+    {
+      if (self->scale_cache[i].bitmap)
+	grub_video_bitmap_destroy (self->scale_cache[i].bitmap);
+      self->scale_cache[i].bitmap = 0;
+    }
+}
+
 static void
 image_destroy (void *vself)
 {
   grub_gui_image_t self = vself;
 
-  /* Free the scaled bitmap, unless it's a reference to the raw bitmap.  */
-  if (self->bitmap && (self->bitmap != self->raw_bitmap))
-    grub_video_bitmap_destroy (self->bitmap);
+  /* Scaled bitmaps are owned by the cache; self->bitmap only aliases
+     a cache entry or the raw bitmap.  */
+  scale_cache_flush (self);
   if (self->raw_bitmap)
     grub_video_bitmap_destroy (self->raw_bitmap);
 
@@ -103,14 +131,12 @@ rescale_image (grub_gui_image_t self)
 {
   signed width;
   signed height;
+  struct grub_video_bitmap *scaled;
+  int i;
 
   if (! self->raw_bitmap)
     {
-      if (self->bitmap)
-        {
-          grub_video_bitmap_destroy (self->bitmap);
-          self->bitmap = 0;
-        }
+      self->bitmap = 0;
       return grub_errno;
     }
 
@@ -125,15 +151,10 @@ rescale_image (grub_gui_image_t self)
       return grub_errno;
     }
 
-  /* Free any old scaled bitmap,
-     *unless* it's a reference to the raw bitmap.  */
-  if (self->bitmap && (self->bitmap != self->raw_bitmap))
-    grub_video_bitmap_destroy (self->bitmap);
-
   self->bitmap = 0;
 
-  /* Create a scaled bitmap, unless the requested size is the same
-     as the raw size -- in that case a reference is made.  */
+  /* Make a reference to the raw bitmap if the requested size is the
+     same as the raw size.  */
   if ((signed) grub_video_bitmap_get_width (self->raw_bitmap) == width
       && (signed) grub_video_bitmap_get_height (self->raw_bitmap) == height)
     {
@@ -145,12 +166,43 @@ rescale_image (grub_gui_image_t self)
   if (width <= 0 || height <= 0)
     return grub_errno;
 
+  /* Themes bounce a handful of images between the same few sizes
+     (e.g. selected vs. unselected menu decorations), so check whether
+     this size was scaled recently before redoing the work.  */
+  for (i = 0; i < SCALE_CACHE_SIZE; i++)
+    if (self->scale_cache[i].bitmap
+	&& self->scale_cache[i].width == (unsigned) width
+	&& self->scale_cache[i].height == (unsigned) height)
+      {
+	self->bitmap = self->scale_cache[i].bitmap;
+	/* Move to the front, keeping the order of the others.  */
+	for (; i > 0; i--)
+	  self->scale_cache[i] = self->scale_cache[i - 1];
+	self->scale_cache[0].width = width;
+	self->scale_cache[0].height = height;
+	self->scale_cache[0].bitmap = self->bitmap;
+	return grub_errno;
+      }
+
   /* Create the scaled bitmap.  */
-  grub_video_bitmap_create_scaled (&self->bitmap,
+  grub_video_bitmap_create_scaled (&scaled,
                                    width,
                                    height,
                                    self->raw_bitmap,
                                    GRUB_VIDEO_BITMAP_SCALE_METHOD_BEST);
+  if (! scaled)
+    return grub_errno;
+
+  /* Insert at the front, evicting the least recently used entry.  */
+  if (self->scale_cache[SCALE_CACHE_SIZE - 1].bitmap)
+    grub_video_bitmap_destroy (self->scale_cache[SCALE_CACHE_SIZE - 1].bitmap);
+  for (i = SCALE_CACHE_SIZE - 1; i > 0; i--)
+    self->scale_cache[i] = self->scale_cache[i - 1];
+  self->scale_cache[0].width = width;
+  self->scale_cache[0].height = height;
+  self->scale_cache[0].bitmap = scaled;
+
+  self->bitmap = scaled;
   return grub_errno;
 }
 
@@ -194,11 +246,9 @@ load_image (grub_gui_image_t self, const char *path)
   if (grub_video_bitmap_load (&bitmap, path) != GRUB_ERR_NONE)
     return grub_errno;
 
-  if (self->bitmap && (self->bitmap != self->raw_bitmap))
-    {
-      grub_video_bitmap_destroy (self->bitmap);
-      self->bitmap = 0;
-    }
+  /* Cached scalings belong to the old raw bitmap.  */
+  scale_cache_flush (self);
+  self->bitmap = 0;
   if (self->raw_bitmap)
     grub_video_bitmap_destroy (self->raw_bitmap);
 
@@ -53,6 +53,8 @@ struct grub_gui_label
   grub_video_rgba_color_t color;
   int value;
   enum align_mode align;
+  /* Retained layout for the current text/font; rebuilt lazily.  */
+  grub_font_string_layout_t layout;
 };
 
 typedef struct grub_gui_label *grub_gui_label_t;
@@ -62,6 +64,7 @@ label_destroy (void *vself)
 {
   grub_gui_label_t self = vself;
   grub_gfxmenu_timeout_unregister ((grub_gui_component_t) self);
+  grub_font_layout_free (self->layout);
   grub_free (self->text);
   grub_free (self->template);
   grub_free (self);
@@ -91,16 +94,23 @@ label_paint (void *vself, const grub_video_rect_t *region)
   if (!grub_video_have_common_points (region, &self->bounds))
     return;
 
+  if (! self->layout)
+    {
+      self->layout = grub_font_layout_string (self->text, self->font);
+      /* Lack of memory only costs the caching.  */
+      grub_errno = GRUB_ERR_NONE;
+    }
+
   /* Calculate the starting x coordinate.  */
   int left_x;
+  int text_width = self->layout ? self->layout->advance
+    : grub_font_get_string_width (self->font, self->text);
   if (self->align == align_left)
     left_x = 0;
   else if (self->align == align_center)
-    left_x = (self->bounds.width
-	      - grub_font_get_string_width (self->font, self->text)) / 2;
+    left_x = (self->bounds.width - text_width) / 2;
   else if (self->align == align_right)
-    left_x = (self->bounds.width
-              - grub_font_get_string_width (self->font, self->text));
+    left_x = (self->bounds.width - text_width);
   else
     return;   /* Invalid alignment.  */
 
@@ -109,11 +119,17 @@ label_paint (void *vself, const grub_video_rect_t *region)
 
   grub_video_rect_t vpsave;
   grub_gui_set_viewport (&self->bounds, &vpsave);
-  grub_font_draw_string (self->text,
-                         self->font,
-                         grub_video_map_rgba_color (self->color),
-                         left_x,
-                         grub_font_get_ascent (self->font));
+  if (self->layout)
+    grub_font_layout_draw (self->layout,
+			   grub_video_map_rgba_color (self->color),
+			   left_x,
+			   grub_font_get_ascent (self->font));
+  else
+    grub_font_draw_string (self->text,
+			   self->font,
+			   grub_video_map_rgba_color (self->color),
+			   left_x,
+			   grub_font_get_ascent (self->font));
   grub_gui_restore_viewport (&vpsave);
 }
 
@@ -149,22 +165,39 @@ static void
 label_get_minimal_size (void *vself, unsigned *width, unsigned *height)
 {
   grub_gui_label_t self = vself;
-  *width = grub_font_get_string_width (self->font, self->text);
+  if (self->layout)
+    *width = self->layout->advance;
+  else
+    *width = grub_font_get_string_width (self->font, self->text);
   *height = (grub_font_get_ascent (self->font)
              + grub_font_get_descent (self->font));
 }
 
 #pragma GCC diagnostic ignored "-Wformat-nonliteral"
 
-static void
+static int
 label_set_state (void *vself, int visible, int start __attribute__ ((unused)),
 		 int current, int end __attribute__ ((unused)))
 {
   grub_gui_label_t self = vself;  
+  char *text;
+  int changed;
+
   self->value = -current;
+  text = grub_xasprintf (self->template ? : "%d", self->value);
+  if (! text)
+    return 0;
+  changed = (visible != self->visible
+	     || ! self->text || grub_strcmp (text, self->text) != 0);
   self->visible = visible;
   grub_free (self->text);
-  self->text = grub_xasprintf (self->template ? : "%d", self->value);
+  self->text = text;
+  if (changed)
+    {
+      grub_font_layout_free (self->layout);
+      self->layout = 0;
+    }
+  return changed;
 }
 
 static grub_err_t
@@ -173,6 +206,8 @@ label_set_property (void *vself, const char *name, const char *value)
   grub_gui_label_t self = vself;
   if (grub_strcmp (name, "text") == 0)
     {
+      grub_font_layout_free (self->layout);
+      self->layout = 0;
       grub_free (self->text);
       grub_free (self->template);
       if (! value)
@@ -204,6 +239,8 @@ label_set_property (void *vself, const char *name, const char *value)
   else if (grub_strcmp (name, "font") == 0)
     {
       self->font = grub_font_get (value);
+      grub_font_layout_free (self->layout);
+      self->layout = 0;
     }
   else if (grub_strcmp (name, "color") == 0)
     {
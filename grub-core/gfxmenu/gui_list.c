@@ -81,16 +81,41 @@ struct grub_gui_list_impl
 
   grub_gfxmenu_icon_manager_t icon_manager;
 
+  /* Retained per-entry title layouts, one set per font, so the
+     per-frame redraws triggered by the timeout tick reuse composed
+     text instead of laying every title out again.  */
+  grub_font_string_layout_t *item_layouts;
+  grub_font_string_layout_t *sel_layouts;
+  int n_layouts;
+
   grub_gfxmenu_view_t view;
 };
 
 typedef struct grub_gui_list_impl *list_impl_t;
 
+static void
+free_title_layouts (list_impl_t self)
+{
+  int i;
+
+  for (i = 0; i < self->n_layouts; i++)
+    {
+      grub_font_layout_free (self->item_layouts[i]);
+      grub_font_layout_free (self->sel_layouts[i]);
+    }
+  grub_free (self->item_layouts);
+  grub_free (self->sel_layouts);
+  self->item_layouts = 0;
+  self->sel_layouts = 0;
+  self->n_layouts = 0;
+}
+
 static void
 list_destroy (void *vself)
 {
   list_impl_t self = vself;
 
+  free_title_layouts (self);
   grub_free (self->theme_dir);
   grub_free (self->menu_box_pattern);
   grub_free (self->item_box_pattern);
@@ -333,6 +358,21 @@ draw_menu (list_impl_t self, int num_shown_items)
 
   make_selected_item_visible (self);
 
+  if (self->n_layouts != self->view->menu->size)
+    {
+      free_title_layouts (self);
+      self->item_layouts = grub_zalloc (self->view->menu->size
+					* sizeof (*self->item_layouts));
+      self->sel_layouts = grub_zalloc (self->view->menu->size
+				       * sizeof (*self->sel_layouts));
+      if (self->item_layouts && self->sel_layouts)
+	self->n_layouts = self->view->menu->size;
+      else
+	free_title_layouts (self);
+      /* Lack of memory only costs the caching.  */
+      grub_errno = GRUB_ERR_NONE;
+    }
+
   grub_gfxmenu_box_t itembox = self->item_box;
   grub_gfxmenu_box_t selbox = self->selected_item_box;
   int item_leftpad = itembox->get_left_pad (itembox);
@@ -432,15 +472,28 @@ draw_menu (list_impl_t self, int num_shown_items)
 
       const char *item_title =
         grub_menu_get_entry (self->view->menu, menu_index)->title;
+      grub_font_string_layout_t *slot = 0;
+
+      if (menu_index < self->n_layouts)
+        slot = is_selected ? &self->sel_layouts[menu_index]
+                           : &self->item_layouts[menu_index];
+      if (slot && ! *slot)
+        {
+          *slot = grub_font_layout_string (item_title, font);
+          grub_errno = GRUB_ERR_NONE;
+        }
 
       sviewport.y = item_top + top_pad;
       sviewport.width = viewport_width;
       grub_gui_set_viewport (&sviewport, &svpsave);
-      grub_font_draw_string (item_title,
-                             font,
-                             color,
-                             0,
-                             text_top_offset);
+      if (slot && *slot)
+        grub_font_layout_draw (*slot, color, 0, text_top_offset);
+      else
+        grub_font_draw_string (item_title,
+                               font,
+                               color,
+                               0,
+                               text_top_offset);
       grub_gui_restore_viewport (&svpsave);
 
       item_top += text_box_height + item_vspace;
@@ -665,6 +718,7 @@ list_set_property (void *vself, const char *name, const char *value)
       self->item_font = grub_font_get (value);
       if (self->selected_item_font_inherit)
         self->selected_item_font = self->item_font;
+      free_title_layouts (self);
     }
   else if (grub_strcmp (name, "selected_item_font") == 0)
     {
@@ -678,6 +732,7 @@ list_set_property (void *vself, const char *name, const char *value)
           self->selected_item_font = grub_font_get (value);
           self->selected_item_font_inherit = 0;
         }
+      free_title_layouts (self);
     }
   else if (grub_strcmp (name, "item_color") == 0)
     {
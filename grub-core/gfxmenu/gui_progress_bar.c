@@ -316,15 +316,19 @@ progress_bar_get_minimal_size (void *vself,
     *height = min_height;
 }
 
-static void
+static int
 progress_bar_set_state (void *vself, int visible, int start,
 			int current, int end)
 {
   grub_gui_progress_bar_t self = vself;  
+  int changed = (visible != self->visible || start != self->start
+		 || current != self->value || end != self->end);
+
   self->visible = visible;
   self->start = start;
   self->value = current;
   self->end = end;
+  return changed;
 }
 
 static grub_err_t
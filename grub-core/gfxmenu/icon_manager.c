@@ -31,9 +31,17 @@
 /* Currently hard coded to '.png' extension.  */
 static const char icon_extension[] = ".png";
 
+/* Maximum number of cached entries.  With one icon per class a large
+   menu can reference many classes; entries past this limit are evicted
+   least recently used.  */
+#define ICON_CACHE_MAX 64
+
 typedef struct icon_entry
 {
   char *class_name;
+  /* The scaled icon, or 0 if no icon exists for this class.  Negative
+     results are cached too, so a class without an icon doesn't cause a
+     filesystem search on every redraw.  */
   struct grub_video_bitmap *bitmap;
   struct icon_entry *next;
 } *icon_entry_t;
@@ -44,8 +52,10 @@ struct grub_gfxmenu_icon_manager
   int icon_width;
   int icon_height;
 
-  /* Icon cache: linked list w/ dummy head node.  */
+  /* Icon cache: linked list w/ dummy head node, most recently used
+     first.  */
   struct icon_entry cache;
+  int cache_count;
 };
 
 
@@ -66,6 +76,7 @@ grub_gfxmenu_icon_manager_new (void)
   mgr->cache.class_name = 0;
   mgr->cache.bitmap = 0;
   mgr->cache.next = 0;
+  mgr->cache_count = 0;
 
   return mgr;
 }
@@ -97,6 +108,7 @@ grub_gfxmenu_icon_manager_clear_cache (grub_gfxmenu_icon_manager_t mgr)
       grub_free (cur);
     }
   mgr->cache.next = 0;
+  mgr->cache_count = 0;
 }
 
 /* Set the theme path.  If the theme path is changed, the icon cache
@@ -181,10 +193,19 @@ get_icon_by_class (grub_gfxmenu_icon_manager_t mgr, const char *class_name)
 {
   /* First check the icon cache.  */
   icon_entry_t entry;
-  for (entry = mgr->cache.next; entry; entry = entry->next)
+  icon_entry_t prev;
+  for (prev = &mgr->cache, entry = prev->next;
+       entry;
+       prev = entry, entry = entry->next)
     {
       if (grub_strcmp (entry->class_name, class_name) == 0)
-        return entry->bitmap;
+        {
+          /* Move to the front so recently used icons stay cached.  */
+          prev->next = entry->next;
+          entry->next = mgr->cache.next;
+          mgr->cache.next = entry;
+          return entry->bitmap;
+        }
     }
 
   if (! mgr->theme_path)
@@ -213,13 +234,9 @@ get_icon_by_class (grub_gfxmenu_icon_manager_t mgr, const char *class_name)
 	icon = try_loading_icon (mgr, icondir, class_name);
     }
 
-  /* No icon was found.  */
-  /* This should probably be noted in the cache, so that a search is not
-     performed each time an icon for CLASS_NAME is requested.  */
-  if (! icon)
-    return 0;
-
-  /* Insert a new cache entry for this icon.  */
+  /* Insert a new cache entry for this icon.  ICON may be 0 here; the
+     negative result is cached as well so the search is not repeated on
+     every redraw.  */
   entry = grub_malloc (sizeof (*entry));
   if (! entry)
     {
@@ -227,10 +244,32 @@ get_icon_by_class (grub_gfxmenu_icon_manager_t mgr, const char *class_name)
       return 0;
     }
   entry->class_name = grub_strdup (class_name);
+  if (! entry->class_name)
+    {
+      grub_free (entry);
+      grub_video_bitmap_destroy (icon);
+      return 0;
+    }
   entry->bitmap = icon;
   entry->next = mgr->cache.next;
   mgr->cache.next = entry;   /* Link it into the cache.  */
-  return entry->bitmap;
+
+  if (++mgr->cache_count > ICON_CACHE_MAX)
+    {
+      /* Evict the least recently used entry from the tail.  */
+      icon_entry_t prev;
+
+      for (prev = &mgr->cache; prev->next->next; prev = prev->next)
+        ;
+      entry = prev->next;
+      prev->next = 0;
+      grub_free (entry->class_name);
+      grub_video_bitmap_destroy (entry->bitmap);
+      grub_free (entry);
+      mgr->cache_count--;
+    }
+
+  return mgr->cache.next->bitmap;
 }
 
 /* Get the best available icon for ENTRY.  Beginning with the first class
@@ -169,8 +169,10 @@ redraw_background (grub_gfxmenu_view_t view,
 }
 
 static void
-draw_title (grub_gfxmenu_view_t view)
+draw_title (grub_gfxmenu_view_t view, const grub_video_rect_t *region)
 {
+  grub_video_rect_t bounds;
+
   if (! view->title_text)
     return;
 
@@ -179,6 +181,15 @@ draw_title (grub_gfxmenu_view_t view)
                                                 view->title_text);
   int x = (view->screen.width - title_width) / 2;
   int y = 40 + grub_font_get_ascent (view->title_font);
+
+  bounds.x = x;
+  bounds.y = 40;
+  bounds.width = title_width;
+  bounds.height = (grub_font_get_ascent (view->title_font)
+		   + grub_font_get_descent (view->title_font));
+  if (!grub_video_have_common_points (region, &bounds))
+    return;
+
   grub_font_draw_string (view->title_text,
                          view->title_font,
                          grub_video_map_rgba_color (view->title_color),
@@ -201,7 +212,7 @@ update_timeouts (int visible, int start, int value, int end)
   struct grub_gfxmenu_timeout_notify *cur;
 
   for (cur = grub_gfxmenu_timeout_notifications; cur; cur = cur->next)
-    cur->set_state (cur->self, visible, start, value, end);
+    cur->changed = cur->set_state (cur->self, visible, start, value, end);
 }
 
 static void
@@ -212,6 +223,13 @@ redraw_timeouts (struct grub_gfxmenu_view *view)
   for (cur = grub_gfxmenu_timeout_notifications; cur; cur = cur->next)
     {
       grub_video_rect_t bounds;
+
+      /* Leave components whose displayed state is already current
+	 alone; a static message registered for timeout notifications
+	 would otherwise force a repaint of its area every second.  */
+      if (!cur->changed)
+	continue;
+
       cur->self->ops->get_bounds (cur->self, &bounds);
       grub_video_set_area_status (GRUB_VIDEO_AREA_ENABLED);
       grub_gfxmenu_view_redraw (view, &bounds);
@@ -331,7 +349,7 @@ grub_gfxmenu_view_redraw (grub_gfxmenu_view_t view,
   redraw_background (view, region);
   if (view->canvas)
     view->canvas->component.ops->paint (view->canvas, region);
-  draw_title (view);
+  draw_title (view, region);
   if (grub_video_have_common_points (&view->progress_message_frame, region))
     draw_message (view);
 
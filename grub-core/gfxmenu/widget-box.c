@@ -115,7 +115,104 @@ draw (grub_gfxmenu_box_t self, int x, int y)
   blit (self, BOX_PIXMAP_SW, x, y + height_n + self->content_height);
 
   /* Draw center.  */
-  blit (self, BOX_PIXMAP_CENTER, x + width_w, y + height_n);
+  if (self->center_uniform)
+    grub_video_fill_rect (grub_video_map_rgba (self->center_rgba[0],
+					       self->center_rgba[1],
+					       self->center_rgba[2],
+					       self->center_rgba[3]),
+			  x + width_w, y + height_n,
+			  self->content_width, self->content_height);
+  else
+    blit (self, BOX_PIXMAP_CENTER, x + width_w, y + height_n);
+}
+
+/* Retired scaled patches, keyed by their source pixmap and size.  Menu
+   redraws bounce the selection box between a handful of content sizes;
+   keeping the last few scalings around turns those bounces into list
+   lookups instead of repeated bilinear scaling.  Entries own their
+   bitmap until a box takes it back or it falls off the end.  */
+struct scaled_cache_ent
+{
+  struct scaled_cache_ent *next;
+  struct grub_video_bitmap *raw;
+  struct grub_video_bitmap *scaled;
+};
+
+#define SCALED_CACHE_MAX 16
+
+static struct scaled_cache_ent *scaled_cache;
+static unsigned scaled_cache_len;
+
+static struct grub_video_bitmap *
+scaled_cache_take (struct grub_video_bitmap *raw, int w, int h)
+{
+  struct scaled_cache_ent *ent, **link;
+
+  for (link = &scaled_cache; (ent = *link); link = &ent->next)
+    if (ent->raw == raw
+	&& (int) grub_video_bitmap_get_width (ent->scaled) == w
+	&& (int) grub_video_bitmap_get_height (ent->scaled) == h)
+      {
+	struct grub_video_bitmap *ret = ent->scaled;
+
+	*link = ent->next;
+	scaled_cache_len--;
+	grub_free (ent);
+	return ret;
+      }
+  return 0;
+}
+
+static void
+scaled_cache_put (struct grub_video_bitmap *raw,
+		  struct grub_video_bitmap *scaled)
+{
+  struct scaled_cache_ent *ent;
+
+  ent = grub_malloc (sizeof (*ent));
+  if (! ent)
+    {
+      /* Not worth failing over; just drop the bitmap.  */
+      grub_errno = GRUB_ERR_NONE;
+      grub_video_bitmap_destroy (scaled);
+      return;
+    }
+  ent->raw = raw;
+  ent->scaled = scaled;
+  ent->next = scaled_cache;
+  scaled_cache = ent;
+  if (++scaled_cache_len > SCALED_CACHE_MAX)
+    {
+      struct scaled_cache_ent **link = &scaled_cache;
+
+      while ((*link)->next)
+	link = &(*link)->next;
+      ent = *link;
+      *link = 0;
+      scaled_cache_len--;
+      grub_video_bitmap_destroy (ent->scaled);
+      grub_free (ent);
+    }
+}
+
+/* Drop every cached scaling of RAW; called when the pixmap itself goes
+   away so a later allocation at the same address can't match.  */
+static void
+scaled_cache_drop (struct grub_video_bitmap *raw)
+{
+  struct scaled_cache_ent *ent, **link;
+
+  link = &scaled_cache;
+  while ((ent = *link))
+    if (ent->raw == raw)
+      {
+	*link = ent->next;
+	scaled_cache_len--;
+	grub_video_bitmap_destroy (ent->scaled);
+	grub_free (ent);
+      }
+    else
+      link = &ent->next;
 }
 
 static grub_err_t
@@ -138,19 +235,74 @@ scale_pixmap (grub_gfxmenu_box_t self, int i, int w, int h)
     {
       if (*scaled)
         {
-          grub_video_bitmap_destroy (*scaled);
+          scaled_cache_put (raw, *scaled);
           *scaled = 0;
         }
 
       /* Don't try to create a bitmap with a zero dimension.  */
       if (w != 0 && h != 0)
-        grub_video_bitmap_create_scaled (scaled, w, h, raw,
-                                         GRUB_VIDEO_BITMAP_SCALE_METHOD_BEST);
+        {
+          *scaled = scaled_cache_take (raw, w, h);
+          if (*scaled == 0)
+            grub_video_bitmap_create_scaled (scaled, w, h, raw,
+                                             GRUB_VIDEO_BITMAP_SCALE_METHOD_BEST);
+        }
     }
 
   return grub_errno;
 }
 
+/* Detect a center pixmap consisting of one fully opaque color, which
+   lets draw () fill the interior instead of blitting.  */
+static void
+check_uniform_center (grub_gfxmenu_box_t self)
+{
+  struct grub_video_bitmap *c = self->raw_pixmaps[BOX_PIXMAP_CENTER];
+  const grub_uint8_t *data, *row, *pix;
+  unsigned w, h, i, j, bpp;
+
+  self->center_uniform = 0;
+  if (! c)
+    return;
+
+  switch (c->mode_info.blit_format)
+    {
+    case GRUB_VIDEO_BLIT_FORMAT_RGBA_8888:
+      bpp = 4;
+      break;
+    case GRUB_VIDEO_BLIT_FORMAT_RGB_888:
+      bpp = 3;
+      break;
+    default:
+      return;
+    }
+
+  data = c->data;
+  w = grub_video_bitmap_get_width (c);
+  h = grub_video_bitmap_get_height (c);
+  if (w == 0 || h == 0)
+    return;
+  if (bpp == 4 && data[3] != 0xff)
+    return;
+
+  for (j = 0; j < h; j++)
+    {
+      row = data + j * c->mode_info.pitch;
+      for (i = 0; i < w; i++)
+	{
+	  pix = row + i * bpp;
+	  if (grub_memcmp (pix, data, bpp) != 0)
+	    return;
+	}
+    }
+
+  self->center_rgba[0] = data[0];
+  self->center_rgba[1] = data[1];
+  self->center_rgba[2] = data[2];
+  self->center_rgba[3] = 0xff;
+  self->center_uniform = 1;
+}
+
 static void
 set_content_size (grub_gfxmenu_box_t self,
                   int width, int height)
@@ -183,8 +335,10 @@ set_content_size (grub_gfxmenu_box_t self,
   if (scale_pixmap(self, BOX_PIXMAP_SE, -1, -1) != GRUB_ERR_NONE)
     return;
 
-  /* Scale the center area. */
-  if (scale_pixmap(self, BOX_PIXMAP_CENTER, width, height) != GRUB_ERR_NONE)
+  /* Scale the center area.  A uniform center is filled directly by
+     draw () and needs no scaled bitmap at all.  */
+  if (! self->center_uniform
+      && scale_pixmap(self, BOX_PIXMAP_CENTER, width, height) != GRUB_ERR_NONE)
     return;
 }
 
@@ -266,7 +420,10 @@ destroy (grub_gfxmenu_box_t self)
   for (i = 0; i < BOX_NUM_PIXMAPS; i++)
     {
       if (self->raw_pixmaps[i])
-        grub_video_bitmap_destroy(self->raw_pixmaps[i]);
+        {
+          scaled_cache_drop (self->raw_pixmaps[i]);
+          grub_video_bitmap_destroy(self->raw_pixmaps[i]);
+        }
       self->raw_pixmaps[i] = 0;
 
       if (self->scaled_pixmaps[i])
@@ -343,6 +500,8 @@ grub_gfxmenu_create_box (const char *pixmaps_prefix,
         }
     }
 
+  check_uniform_center (box);
+
   box->draw = draw;
   box->set_content_size = set_content_size;
   box->get_border_width = get_border_width;
@@ -34,9 +34,11 @@ struct grub_bufio
 {
   grub_file_t file;
   grub_size_t block_size;
+  /* Upper bound for adaptive window growth.  */
+  grub_size_t max_size;
   grub_size_t buffer_len;
   grub_off_t buffer_at;
-  char buffer[0];
+  char *buffer;
 };
 typedef struct grub_bufio *grub_bufio_t;
 
@@ -68,16 +70,36 @@ grub_bufio_open (grub_file_t io, grub_size_t size)
   while (size & (size - 1))
     size = (size | (size - 1)) + 1;
 
-  bufio = grub_zalloc (sizeof (struct grub_bufio) + size);
+  bufio = grub_zalloc (sizeof (struct grub_bufio));
   if (! bufio)
     {
       grub_free (file);
       return 0;
     }
 
+  bufio->buffer = grub_malloc (size);
+  if (! bufio->buffer)
+    {
+      grub_free (bufio);
+      grub_free (file);
+      return 0;
+    }
+
   bufio->file = io;
   bufio->block_size = size;
 
+  /* The window may grow while the file is consumed sequentially, but
+     never beyond the file itself (rounded up to a power of two).  */
+  bufio->max_size = GRUB_BUFIO_MAX_SIZE;
+  if (io->size != GRUB_FILE_SIZE_UNKNOWN && io->size < bufio->max_size)
+    {
+      bufio->max_size = io->size;
+      while (bufio->max_size & (bufio->max_size - 1))
+	bufio->max_size = (bufio->max_size | (bufio->max_size - 1)) + 1;
+      if (bufio->max_size < size)
+	bufio->max_size = size;
+    }
+
   file->device = io->device;
   file->size = io->size;
   file->data = bufio;
@@ -138,6 +160,26 @@ grub_bufio_read (grub_file_t file, char *buf, grub_size_t len)
   if (len == 0)
     return res;
 
+  /* A consumer that exhausts full windows back to back is streaming
+     the file; per-request latency then dominates, so double the
+     window (up to the cap) before refilling.  On allocation failure
+     just keep the current window.  */
+  if (bufio->buffer_len == bufio->block_size
+      && bufio->block_size < bufio->max_size
+      && file->offset + res == bufio->buffer_at + bufio->buffer_len)
+    {
+      grub_size_t new_size = bufio->block_size * 2;
+      char *new_buffer = grub_malloc (new_size);
+
+      if (new_buffer)
+	{
+	  grub_free (bufio->buffer);
+	  bufio->buffer = new_buffer;
+	  bufio->block_size = new_size;
+	  bufio->buffer_len = 0;
+	}
+    }
+
   /* Need to read some more.  */
   next_buf = (grub_divmod64 (file->offset + res + len - 1, bufio->block_size, NULL)) * bufio->block_size;
   /* Now read between file->offset + res and bufio->buffer_at.  */
@@ -195,6 +237,7 @@ grub_bufio_close (grub_file_t file)
   grub_bufio_t bufio = file->data;
 
   grub_file_close (bufio->file);
+  grub_free (bufio->buffer);
   grub_free (bufio);
 
   file->device = 0;
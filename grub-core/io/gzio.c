@@ -84,7 +84,7 @@ struct grub_gzio
   grub_uint8_t inbuf[INBUFSIZ];
   int inbuf_d;
   /* The bit buffer.  */
-  unsigned long bb;
+  grub_uint64_t bb;
   /* The bits in the bit buffer.  */
   unsigned bk;
   /* The sliding window in uncompressed data.  */
@@ -375,7 +375,47 @@ static ush mask_bits[] =
   0x01ff, 0x03ff, 0x07ff, 0x0fff, 0x1fff, 0x3fff, 0x7fff, 0xffff
 };
 
-#define NEEDBITS(n) do {while(k<(n)){b|=((ulg)get_byte(gzio))<<k;k+=8;}} while (0)
+/* Refill the bit buffer.  The buffer is 64 bits wide, so whenever at
+   least four input bytes are at hand they are pulled in as one 32-bit
+   load instead of a byte at a time; the byte loop remains as the
+   fallback near buffer and stream boundaries.  Refills are always a
+   whole number of bytes, which the stored-block code relies on.  */
+#define NEEDBITS(n) \
+  do \
+    { \
+      if (k < (n)) \
+	{ \
+	  if (k <= 32 && gzio->mem_input \
+	      && gzio->mem_input_off + 4 <= gzio->mem_input_size) \
+	    { \
+	      b |= (grub_uint64_t) \
+		grub_le_to_cpu32 (grub_get_unaligned32 (gzio->mem_input \
+							+ gzio->mem_input_off)) \
+		<< k; \
+	      gzio->mem_input_off += 4; \
+	      k += 32; \
+	    } \
+	  else if (k <= 32 && !gzio->mem_input && gzio->file \
+		   && gzio->inbuf_d + 4 <= INBUFSIZ \
+		   && grub_file_tell (gzio->file) \
+		      != (grub_off_t) gzio->data_offset) \
+	    { \
+	      b |= (grub_uint64_t) \
+		grub_le_to_cpu32 (grub_get_unaligned32 (gzio->inbuf \
+							+ gzio->inbuf_d)) \
+		<< k; \
+	      gzio->inbuf_d += 4; \
+	      k += 32; \
+	    } \
+	  else \
+	    while (k < (n)) \
+	      { \
+		b |= ((grub_uint64_t) get_byte (gzio)) << k; \
+		k += 8; \
+	      } \
+	} \
+    } \
+  while (0)
 #define DUMPBITS(n) do {b>>=(n);k-=(n);} while (0)
 
 static int
@@ -660,7 +700,7 @@ inflate_codes_in_window (grub_gzio_t gzio)
   unsigned w;			/* current window position */
   struct huft *t;		/* pointer to table entry */
   unsigned ml, md;		/* masks for bl and bd bits */
-  register ulg b;		/* bit buffer */
+  register grub_uint64_t b;	/* bit buffer */
   register unsigned k;		/* number of bits in bit buffer */
 
   /* make local copies of globals */
@@ -770,8 +810,22 @@ inflate_codes_in_window (grub_gzio_t gzio)
 	      else
 		/* purposefully use the overlap for extra copies here!! */
 		{
-		  while (e--)
-		    gzio->slide[w++] = gzio->slide[d++];
+		  /* The run repeats the W - D bytes before it.  Rather
+		     than copying a byte at a time, replicate the span
+		     and double it with every pass.  */
+		  unsigned left = e;
+
+		  while (left)
+		    {
+		      unsigned c = w - d;
+
+		      if (c > left)
+			c = left;
+		      grub_memmove (gzio->slide + w, gzio->slide + d, c);
+		      w += c;
+		      left -= c;
+		    }
+		  d += e;
 		}
 
 	      if (w == WSIZE)
@@ -804,7 +858,7 @@ inflate_codes_in_window (grub_gzio_t gzio)
 static void
 init_stored_block (grub_gzio_t gzio)
 {
-  register ulg b;		/* bit buffer */
+  register grub_uint64_t b;	/* bit buffer */
   register unsigned k;		/* number of bits in bit buffer */
 
   /* make local copies of globals */
@@ -892,7 +946,7 @@ init_dynamic_block (grub_gzio_t gzio)
   unsigned nl;			/* number of literal/length codes */
   unsigned nd;			/* number of distance codes */
   unsigned ll[286 + 30];	/* literal/length and distance code lengths */
-  register ulg b;		/* bit buffer */
+  register grub_uint64_t b;	/* bit buffer */
   register unsigned k;		/* number of bits in bit buffer */
 
   /* make local bit buffer */
@@ -1041,7 +1095,7 @@ init_dynamic_block (grub_gzio_t gzio)
 static void
 get_new_block (grub_gzio_t gzio)
 {
-  register ulg b;		/* bit buffer */
+  register grub_uint64_t b;	/* bit buffer */
   register unsigned k;		/* number of bits in bit buffer */
 
   /* make local bit buffer */
@@ -1117,6 +1171,16 @@ inflate_window (grub_gzio_t gzio)
 	   *  This is basically a glorified pass-through
 	   */
 
+	  /* Bulk refills may have left whole bytes in the bit buffer;
+	     they precede anything get_byte returns.  */
+	  while (gzio->block_len && w < WSIZE && gzio->bk >= 8)
+	    {
+	      gzio->slide[w++] = (grub_uint8_t) gzio->bb;
+	      gzio->bb >>= 8;
+	      gzio->bk -= 8;
+	      gzio->block_len--;
+	    }
+
 	  while (gzio->block_len && w < WSIZE && grub_errno == GRUB_ERR_NONE)
 	    {
 	      gzio->slide[w++] = get_byte (gzio);
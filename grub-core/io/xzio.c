@@ -30,6 +30,8 @@ GRUB_MOD_LICENSE ("GPLv3+");
 #include "xz_stream.h"
 
 #define XZBUFSIZ 0x2000
+/* Must be a power of two.  */
+#define XZ_HISTORY_SIZE 0x10000
 #define VLI_MAX_DIGITS 9
 #define XZ_STREAM_FOOTER_SIZE 12
 
@@ -41,8 +43,49 @@ struct grub_xzio
   grub_uint8_t inbuf[XZBUFSIZ];
   grub_uint8_t outbuf[XZBUFSIZ];
   grub_off_t saved_offset;
+  /* Ring of the most recently produced output, so short backward
+     seeks (header probing, verifier rewinds) are served without
+     restarting the decoder from the beginning of the stream.  */
+  grub_uint8_t history[XZ_HISTORY_SIZE];
+  /* Stream offset just past the last byte in the ring.  */
+  grub_off_t hist_end;
+  /* Number of valid bytes in the ring, ending at hist_end.  */
+  grub_size_t hist_filled;
 };
 
+static void
+xzio_history_append (grub_xzio_t xzio, grub_off_t offset,
+		     const grub_uint8_t *data, grub_size_t size)
+{
+  if (offset != xzio->hist_end)
+    /* Discontinuity: restart the ring at the new position.  */
+    xzio->hist_filled = 0;
+
+  if (size > XZ_HISTORY_SIZE)
+    {
+      data += size - XZ_HISTORY_SIZE;
+      offset += size - XZ_HISTORY_SIZE;
+      size = XZ_HISTORY_SIZE;
+    }
+
+  while (size)
+    {
+      grub_size_t pos = offset & (XZ_HISTORY_SIZE - 1);
+      grub_size_t chunk = XZ_HISTORY_SIZE - pos;
+
+      if (chunk > size)
+	chunk = size;
+      grub_memcpy (xzio->history + pos, data, chunk);
+      data += chunk;
+      offset += chunk;
+      size -= chunk;
+      xzio->hist_filled += chunk;
+    }
+  if (xzio->hist_filled > XZ_HISTORY_SIZE)
+    xzio->hist_filled = XZ_HISTORY_SIZE;
+  xzio->hist_end = offset;
+}
+
 typedef struct grub_xzio *grub_xzio_t;
 static struct grub_fs grub_xzio_fs;
 
@@ -237,16 +280,43 @@ grub_xzio_read (grub_file_t file, char *buf, grub_size_t len)
   grub_xzio_t xzio = file->data;
   grub_off_t current_offset;
 
-  /* If seek backward need to reset decoder and start from beginning of file.
+  /* A backward seek landing in the retained output window is served
+     from there and the decoder keeps its position.  Only seeks below
+     the window reset decompression to the beginning of the stream.
      TODO Possible improvement by jumping blocks.  */
   if (file->offset < xzio->saved_offset)
     {
-      xz_dec_reset (xzio->dec);
-      xzio->saved_offset = 0;
-      xzio->buf.out_pos = 0;
-      xzio->buf.in_pos = 0;
-      xzio->buf.in_size = 0;
-      grub_file_seek (xzio->file, 0);
+      if (xzio->hist_end == xzio->saved_offset
+	  && file->offset + xzio->hist_filled >= xzio->hist_end)
+	{
+	  while (len > 0 && file->offset + ret < xzio->hist_end)
+	    {
+	      grub_size_t pos = (file->offset + ret)
+		& (XZ_HISTORY_SIZE - 1);
+	      grub_size_t chunk = XZ_HISTORY_SIZE - pos;
+
+	      if (chunk > len)
+		chunk = len;
+	      if (chunk > xzio->hist_end - (file->offset + ret))
+		chunk = xzio->hist_end - (file->offset + ret);
+	      grub_memcpy (buf, xzio->history + pos, chunk);
+	      buf += chunk;
+	      len -= chunk;
+	      ret += chunk;
+	    }
+	  /* Anything left continues from the decoder's position.  */
+	}
+      else
+	{
+	  xz_dec_reset (xzio->dec);
+	  xzio->saved_offset = 0;
+	  xzio->hist_end = 0;
+	  xzio->hist_filled = 0;
+	  xzio->buf.out_pos = 0;
+	  xzio->buf.in_pos = 0;
+	  xzio->buf.in_size = 0;
+	  grub_file_seek (xzio->file, 0);
+	}
     }
 
   current_offset = xzio->saved_offset;
@@ -281,6 +351,9 @@ grub_xzio_read (grub_file_t file, char *buf, grub_size_t len)
 	  break;
 	}
 
+      xzio_history_append (xzio, current_offset, xzio->outbuf,
+			   xzio->buf.out_pos);
+
       {
 	grub_off_t new_offset = current_offset + xzio->buf.out_pos;
 	
@@ -0,0 +1,272 @@
+/* zstdio.c - decompression support for zstd */
+/*
+ *  GRUB  --  GRand Unified Bootloader
+ *  Copyright (C) 2026  Free Software Foundation, Inc.
+ *
+ *  GRUB is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GRUB is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GRUB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <grub/err.h>
+#include <grub/mm.h>
+#include <grub/misc.h>
+#include <grub/file.h>
+#include <grub/fs.h>
+#include <grub/dl.h>
+
+#define ZSTD_STATIC_LINKING_ONLY
+#include <zstd.h>
+
+GRUB_MOD_LICENSE ("GPLv3+");
+
+#define ZSTDBUFSIZ 0x8000
+
+struct grub_zstdio
+{
+  grub_file_t file;
+  ZSTD_DStream *dstream;
+  ZSTD_inBuffer in;
+  ZSTD_outBuffer out;
+  grub_uint8_t inbuf[ZSTDBUFSIZ];
+  grub_uint8_t outbuf[ZSTDBUFSIZ];
+  grub_off_t saved_offset;
+};
+
+typedef struct grub_zstdio *grub_zstdio_t;
+static struct grub_fs grub_zstdio_fs;
+
+static void *
+grub_zstd_malloc (void *state __attribute__((unused)), size_t size)
+{
+  return grub_malloc (size);
+}
+
+static void
+grub_zstd_free (void *state __attribute__((unused)), void *address)
+{
+  return grub_free (address);
+}
+
+static ZSTD_customMem
+grub_zstd_allocator (void)
+{
+  ZSTD_customMem allocator;
+
+  allocator.customAlloc = &grub_zstd_malloc;
+  allocator.customFree = &grub_zstd_free;
+  allocator.opaque = NULL;
+
+  return allocator;
+}
+
+/* Check the frame magic and pick up the content size from the frame
+   header, if the compressor recorded it.  */
+static int
+test_zstd_header (grub_file_t file)
+{
+  grub_zstdio_t zstdio = file->data;
+  grub_uint8_t header[ZSTD_FRAMEHEADERSIZE_MAX];
+  grub_ssize_t read_bytes;
+  unsigned long long csize;
+
+  read_bytes = grub_file_read (zstdio->file, header, sizeof (header));
+  if (read_bytes < (grub_ssize_t) sizeof (grub_uint32_t)
+      || grub_le_to_cpu32 (grub_get_unaligned32 (header)) != ZSTD_MAGICNUMBER)
+    return 0;
+
+  csize = ZSTD_getFrameContentSize (header, read_bytes);
+  if (csize == ZSTD_CONTENTSIZE_ERROR)
+    return 0;
+  if (csize != ZSTD_CONTENTSIZE_UNKNOWN)
+    file->size = csize;
+
+  grub_file_seek (zstdio->file, 0);
+  return 1;
+}
+
+static grub_file_t
+grub_zstdio_open (grub_file_t io, enum grub_file_type type)
+{
+  grub_file_t file;
+  grub_zstdio_t zstdio;
+
+  if (type & GRUB_FILE_TYPE_NO_DECOMPRESS)
+    return io;
+
+  file = (grub_file_t) grub_zalloc (sizeof (*file));
+  if (!file)
+    return 0;
+
+  zstdio = grub_zalloc (sizeof (*zstdio));
+  if (!zstdio)
+    {
+      grub_free (file);
+      return 0;
+    }
+
+  zstdio->file = io;
+
+  file->device = io->device;
+  file->data = zstdio;
+  file->fs = &grub_zstdio_fs;
+  file->size = GRUB_FILE_SIZE_UNKNOWN;
+  file->not_easily_seekable = 1;
+
+  if (grub_file_tell (zstdio->file) != 0)
+    grub_file_seek (zstdio->file, 0);
+
+  if (!test_zstd_header (file))
+    {
+      grub_errno = GRUB_ERR_NONE;
+      grub_file_seek (io, 0);
+      grub_free (zstdio);
+      grub_free (file);
+
+      return io;
+    }
+
+  zstdio->dstream = ZSTD_createDStream_advanced (grub_zstd_allocator ());
+  if (!zstdio->dstream)
+    {
+      grub_error (GRUB_ERR_OUT_OF_MEMORY, "failed to create a zstd context");
+      grub_file_seek (io, 0);
+      grub_free (zstdio);
+      grub_free (file);
+
+      return io;
+    }
+  ZSTD_initDStream (zstdio->dstream);
+
+  zstdio->in.src = zstdio->inbuf;
+  zstdio->out.dst = zstdio->outbuf;
+
+  return file;
+}
+
+static grub_ssize_t
+grub_zstdio_read (grub_file_t file, char *buf, grub_size_t len)
+{
+  grub_ssize_t ret = 0;
+  grub_ssize_t readret;
+  grub_size_t zret;
+  grub_zstdio_t zstdio = file->data;
+  grub_off_t current_offset;
+
+  /* If seek backward need to reset decoder and start from beginning of file.
+     TODO Possible improvement by jumping frames.  */
+  if (file->offset < zstdio->saved_offset)
+    {
+      ZSTD_initDStream (zstdio->dstream);
+      zstdio->saved_offset = 0;
+      zstdio->out.pos = 0;
+      zstdio->in.pos = 0;
+      zstdio->in.size = 0;
+      grub_file_seek (zstdio->file, 0);
+    }
+
+  current_offset = zstdio->saved_offset;
+
+  while (len > 0)
+    {
+      zstdio->out.size = file->offset + ret + len - current_offset;
+      if (zstdio->out.size > ZSTDBUFSIZ)
+	zstdio->out.size = ZSTDBUFSIZ;
+      zstdio->out.pos = 0;
+
+      /* Feed input.  */
+      if (zstdio->in.pos == zstdio->in.size)
+	{
+	  readret = grub_file_read (zstdio->file, zstdio->inbuf, ZSTDBUFSIZ);
+	  if (readret < 0)
+	    return -1;
+	  zstdio->in.size = readret;
+	  zstdio->in.pos = 0;
+	  if (readret == 0)
+	    /* EOF: anything still buffered in the decoder would have
+	       been flushed by the previous pass.  */
+	    break;
+	}
+
+      zret = ZSTD_decompressStream (zstdio->dstream, &zstdio->out,
+				    &zstdio->in);
+      if (ZSTD_isError (zret))
+	{
+	  grub_error (GRUB_ERR_BAD_COMPRESSED_DATA,
+		      N_("zstd file corrupted"));
+	  return -1;
+	}
+
+      {
+	grub_off_t new_offset = current_offset + zstdio->out.pos;
+
+	if (file->offset <= new_offset)
+	  /* Store first chunk of data in buffer.  */
+	  {
+	    grub_size_t delta = new_offset - (file->offset + ret);
+	    grub_memmove (buf, (grub_uint8_t *) zstdio->out.dst
+			  + (zstdio->out.pos - delta), delta);
+	    len -= delta;
+	    buf += delta;
+	    ret += delta;
+	  }
+	current_offset = new_offset;
+      }
+
+      /* Frame fully decoded and no more input: EOF.  */
+      if (zret == 0 && zstdio->in.pos == zstdio->in.size
+	  && grub_file_tell (zstdio->file) >= grub_file_size (zstdio->file))
+	break;
+    }
+
+  if (ret >= 0)
+    zstdio->saved_offset = file->offset + ret;
+
+  return ret;
+}
+
+/* Release everything, including the underlying file object.  */
+static grub_err_t
+grub_zstdio_close (grub_file_t file)
+{
+  grub_zstdio_t zstdio = file->data;
+
+  ZSTD_freeDStream (zstdio->dstream);
+
+  grub_file_close (zstdio->file);
+  grub_free (zstdio);
+
+  /* Device must not be closed twice.  */
+  file->device = 0;
+  file->name = 0;
+  return grub_errno;
+}
+
+static struct grub_fs grub_zstdio_fs = {
+  .name = "zstdio",
+  .fs_dir = 0,
+  .fs_open = 0,
+  .fs_read = grub_zstdio_read,
+  .fs_close = grub_zstdio_close,
+  .fs_label = 0,
+  .next = 0
+};
+
+GRUB_MOD_INIT (zstdio)
+{
+  grub_file_filter_register (GRUB_FILE_FILTER_ZSTDIO, grub_zstdio_open);
+}
+
+GRUB_MOD_FINI (zstdio)
+{
+  grub_file_filter_unregister (GRUB_FILE_FILTER_ZSTDIO);
+}
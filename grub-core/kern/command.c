@@ -18,11 +18,121 @@
  */
 
 #include <grub/lockdown.h>
+#include <grub/misc.h>
 #include <grub/mm.h>
 #include <grub/command.h>
 
 grub_command_t grub_command_list;
 
+/*
+ * A side index over grub_command_list: an open-addressing hash table
+ * mapping a name to its active (first listed) command, so that
+ * grub_command_find is one probe instead of a walk over every
+ * registered command.  The table is advisory: if it cannot be grown,
+ * it is dropped and lookups fall back to the list.
+ */
+#define GRUB_COMMAND_HASH_INITIAL_SIZE	128
+
+static grub_command_t *grub_command_hash;
+static grub_size_t grub_command_hash_size;
+static grub_size_t grub_command_hash_used;
+
+/* The marker stored in slots of removed commands.  */
+static struct grub_command grub_command_tombstone;
+
+static unsigned int
+grub_command_hashval (const char *s)
+{
+  unsigned int i = 5381;
+
+  while (*s)
+    i = i * 33 + (grub_uint8_t) *(s++);
+
+  return i;
+}
+
+/* Find the slot for NAME: either its live entry or the first free or
+   deleted slot of its probe sequence.  */
+static grub_command_t *
+grub_command_hash_slot (const char *name)
+{
+  grub_size_t mask = grub_command_hash_size - 1;
+  grub_size_t idx;
+  grub_command_t *reuse = 0;
+
+  for (idx = grub_command_hashval (name) & mask; grub_command_hash[idx];
+       idx = (idx + 1) & mask)
+    {
+      if (grub_command_hash[idx] == &grub_command_tombstone)
+	{
+	  if (! reuse)
+	    reuse = &grub_command_hash[idx];
+	  continue;
+	}
+      if (grub_strcmp (grub_command_hash[idx]->name, name) == 0)
+	return &grub_command_hash[idx];
+    }
+
+  return reuse ? reuse : &grub_command_hash[idx];
+}
+
+/* Record CMD as the active command for its name.  On allocation
+   failure the whole index is dropped; lookups then use the list.  */
+static void
+grub_command_hash_set (grub_command_t cmd)
+{
+  grub_command_t *slot;
+
+  if ((grub_command_hash_used + 1) * 4 > grub_command_hash_size * 3)
+    {
+      grub_size_t new_size = grub_command_hash_size
+	? grub_command_hash_size * 2 : GRUB_COMMAND_HASH_INITIAL_SIZE;
+      grub_command_t *old = grub_command_hash;
+      grub_size_t old_size = grub_command_hash_size, i;
+
+      grub_command_hash = grub_calloc (new_size, sizeof (*grub_command_hash));
+      if (! grub_command_hash)
+	{
+	  grub_free (old);
+	  grub_command_hash_size = 0;
+	  grub_command_hash_used = 0;
+	  grub_errno = GRUB_ERR_NONE;
+	  return;
+	}
+      grub_command_hash_size = new_size;
+      grub_command_hash_used = 0;
+      for (i = 0; i < old_size; i++)
+	if (old[i] && old[i] != &grub_command_tombstone)
+	  {
+	    *grub_command_hash_slot (old[i]->name) = old[i];
+	    grub_command_hash_used++;
+	  }
+      grub_free (old);
+    }
+
+  slot = grub_command_hash_slot (cmd->name);
+  if (! *slot)
+    grub_command_hash_used++;
+  *slot = cmd;
+}
+
+grub_command_t
+grub_command_find (const char *name)
+{
+  grub_command_t cmd;
+
+  if (grub_command_hash)
+    {
+      grub_command_t *slot = grub_command_hash_slot (name);
+
+      cmd = (*slot && *slot != &grub_command_tombstone) ? *slot : 0;
+    }
+  else
+    cmd = grub_named_list_find (GRUB_AS_NAMED_LIST (grub_command_list), name);
+
+  return cmd;
+}
+
 grub_command_t
 grub_register_command_prio (const char *name,
 			    grub_command_func_t func,
@@ -73,7 +183,10 @@ grub_register_command_prio (const char *name,
   cmd->prev = p;
 
   if (! inactive)
-    cmd->prio |= GRUB_COMMAND_FLAG_ACTIVE;
+    {
+      cmd->prio |= GRUB_COMMAND_FLAG_ACTIVE;
+      grub_command_hash_set (cmd);
+    }
 
   return cmd;
 }
@@ -106,6 +219,21 @@ grub_unregister_command (grub_command_t cmd)
 {
   if ((cmd->prio & GRUB_COMMAND_FLAG_ACTIVE) && (cmd->next))
     cmd->next->prio |= GRUB_COMMAND_FLAG_ACTIVE;
+
+  if (grub_command_hash)
+    {
+      grub_command_t *slot = grub_command_hash_slot (cmd->name);
+
+      if (*slot == cmd)
+	{
+	  /* Promote the next command of the same name, if any.  */
+	  if (cmd->next && grub_strcmp (cmd->next->name, cmd->name) == 0)
+	    *slot = cmd->next;
+	  else
+	    *slot = &grub_command_tombstone;
+	}
+    }
+
   grub_list_remove (GRUB_AS_LIST (cmd));
   grub_free (cmd);
 }
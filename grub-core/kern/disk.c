@@ -33,6 +33,10 @@ static grub_uint64_t grub_last_time = 0;
 
 struct grub_disk_cache grub_disk_cache_table[GRUB_DISK_CACHE_NUM];
 
+/* Monotonic counter stamping cache entries on every hit or store,
+   driving the per-set LRU replacement.  */
+static grub_uint64_t grub_disk_cache_tick;
+
 void (*grub_disk_firmware_fini) (void);
 int grub_disk_firmware_is_tainted;
 
@@ -48,6 +52,121 @@ grub_disk_cache_get_performance (unsigned long *hits, unsigned long *misses)
 }
 #endif
 
+/* Per-identity cache statistics, always compiled in.  One slot per
+   (dev_id, disk_id) pair ever seen; the table is small since only a
+   handful of disks are touched during a boot.  */
+#define GRUB_DISK_CACHE_STATS_SLOTS	12
+
+struct cache_stat_slot
+{
+  unsigned long dev_id;
+  unsigned long disk_id;
+  char *name;
+  unsigned long hits;
+  unsigned long misses;
+  unsigned long evictions;
+  unsigned long agglomerated;
+  unsigned long long sectors_read;
+  int used;
+};
+
+static struct cache_stat_slot cache_stat_slots[GRUB_DISK_CACHE_STATS_SLOTS];
+
+static struct cache_stat_slot *
+grub_disk_cache_stat_find (unsigned long dev_id, unsigned long disk_id)
+{
+  unsigned i;
+
+  for (i = 0; i < GRUB_DISK_CACHE_STATS_SLOTS; i++)
+    if (cache_stat_slots[i].used
+	&& cache_stat_slots[i].dev_id == dev_id
+	&& cache_stat_slots[i].disk_id == disk_id)
+      return &cache_stat_slots[i];
+  for (i = 0; i < GRUB_DISK_CACHE_STATS_SLOTS; i++)
+    if (! cache_stat_slots[i].used)
+      {
+	cache_stat_slots[i].dev_id = dev_id;
+	cache_stat_slots[i].disk_id = disk_id;
+	cache_stat_slots[i].used = 1;
+	return &cache_stat_slots[i];
+      }
+  return 0;
+}
+
+/* Remember the name a disk identity was opened under, for reporting.  */
+static void
+grub_disk_cache_stat_set_name (grub_disk_t disk)
+{
+  struct cache_stat_slot *slot;
+
+  slot = grub_disk_cache_stat_find (disk->dev->id, disk->id);
+  if (slot && ! slot->name)
+    {
+      slot->name = grub_strdup (disk->name);
+      /* Statistics must never fail an open.  */
+      grub_errno = GRUB_ERR_NONE;
+    }
+}
+
+/* Account for NSEC sectors of GRUB_DISK_SECTOR_SIZE transferred from
+   the device on a successful read.  */
+static void
+grub_disk_cache_stat_count_read (unsigned long dev_id, unsigned long disk_id,
+				 grub_disk_addr_t nsec)
+{
+  struct cache_stat_slot *slot;
+
+  slot = grub_disk_cache_stat_find (dev_id, disk_id);
+  if (slot)
+    slot->sectors_read += nsec;
+}
+
+void
+grub_disk_cache_stats_iterate (grub_disk_cache_stats_hook_t hook,
+			       void *hook_data)
+{
+  unsigned i, j;
+
+  for (i = 0; i < GRUB_DISK_CACHE_STATS_SLOTS; i++)
+    {
+      struct grub_disk_cache_stats stats;
+
+      if (! cache_stat_slots[i].used)
+	continue;
+      stats.name = cache_stat_slots[i].name;
+      stats.dev_id = cache_stat_slots[i].dev_id;
+      stats.disk_id = cache_stat_slots[i].disk_id;
+      stats.hits = cache_stat_slots[i].hits;
+      stats.misses = cache_stat_slots[i].misses;
+      stats.evictions = cache_stat_slots[i].evictions;
+      stats.agglomerated = cache_stat_slots[i].agglomerated;
+      stats.sectors_read = cache_stat_slots[i].sectors_read;
+      stats.occupancy = 0;
+      for (j = 0; j < GRUB_DISK_CACHE_NUM; j++)
+	if (grub_disk_cache_table[j].data
+	    && grub_disk_cache_table[j].dev_id == stats.dev_id
+	    && grub_disk_cache_table[j].disk_id == stats.disk_id)
+	  stats.occupancy++;
+      if (hook (&stats, hook_data))
+	return;
+    }
+}
+
+void
+grub_disk_cache_stats_reset (void)
+{
+  unsigned i;
+
+  for (i = 0; i < GRUB_DISK_CACHE_STATS_SLOTS; i++)
+    {
+      cache_stat_slots[i].hits = 0;
+      cache_stat_slots[i].misses = 0;
+      cache_stat_slots[i].evictions = 0;
+      cache_stat_slots[i].agglomerated = 0;
+      cache_stat_slots[i].sectors_read = 0;
+    }
+}
+
 grub_err_t (*grub_disk_write_weak) (grub_disk_t disk,
 				    grub_disk_addr_t sector,
 				    grub_off_t offset,
@@ -77,21 +196,24 @@ grub_disk_cache_fetch (unsigned long dev_id, unsigned long disk_id,
 		       grub_disk_addr_t sector)
 {
   struct grub_disk_cache *cache;
-  unsigned cache_index;
-
-  cache_index = grub_disk_cache_get_index (dev_id, disk_id, sector);
-  cache = grub_disk_cache_table + cache_index;
+  struct cache_stat_slot *slot;
 
-  if (cache->dev_id == dev_id && cache->disk_id == disk_id
-      && cache->sector == sector)
+  cache = grub_disk_cache_find (dev_id, disk_id, sector, 0);
+  slot = grub_disk_cache_stat_find (dev_id, disk_id);
+  if (cache)
     {
       cache->lock = 1;
+      cache->last_use = ++grub_disk_cache_tick;
+      if (slot)
+	slot->hits++;
 #if DISK_CACHE_STATS
       grub_disk_cache_hits++;
 #endif
       return cache->data;
     }
 
+  if (slot)
+    slot->misses++;
 #if DISK_CACHE_STATS
   grub_disk_cache_misses++;
 #endif
@@ -104,13 +226,9 @@ grub_disk_cache_unlock (unsigned long dev_id, unsigned long disk_id,
 			grub_disk_addr_t sector)
 {
   struct grub_disk_cache *cache;
-  unsigned cache_index;
-
-  cache_index = grub_disk_cache_get_index (dev_id, disk_id, sector);
-  cache = grub_disk_cache_table + cache_index;
 
-  if (cache->dev_id == dev_id && cache->disk_id == disk_id
-      && cache->sector == sector)
+  cache = grub_disk_cache_find (dev_id, disk_id, sector, 0);
+  if (cache)
     cache->lock = 0;
 }
 
@@ -118,11 +236,25 @@ static grub_err_t
 grub_disk_cache_store (unsigned long dev_id, unsigned long disk_id,
 		       grub_disk_addr_t sector, const char *data)
 {
-  unsigned cache_index;
   struct grub_disk_cache *cache;
+  struct grub_disk_cache *lru;
 
-  cache_index = grub_disk_cache_get_index (dev_id, disk_id, sector);
-  cache = grub_disk_cache_table + cache_index;
+  /* Replace an existing entry for the same chunk if any, the least
+     recently used way of the set otherwise.  */
+  cache = grub_disk_cache_find (dev_id, disk_id, sector, &lru);
+  if (! cache)
+    {
+      cache = lru;
+      /* Charge the eviction to the identity losing its line.  */
+      if (cache->data)
+	{
+	  struct cache_stat_slot *slot;
+
+	  slot = grub_disk_cache_stat_find (cache->dev_id, cache->disk_id);
+	  if (slot)
+	    slot->evictions++;
+	}
+    }
 
   cache->lock = 1;
   grub_free (cache->data);
@@ -138,6 +270,7 @@ grub_disk_cache_store (unsigned long dev_id, unsigned long disk_id,
   cache->dev_id = dev_id;
   cache->disk_id = disk_id;
   cache->sector = sector;
+  cache->last_use = ++grub_disk_cache_tick;
 
   return GRUB_ERR_NONE;
 }
@@ -146,11 +279,34 @@ grub_disk_cache_store (unsigned long dev_id, unsigned long disk_id,
 
 grub_disk_dev_t grub_disk_dev_list;
 
+/* Starts at 1 so 0 can mean "nothing cached" for callers.  */
+static unsigned long disk_dev_generation = 1;
+
+unsigned long
+grub_disk_dev_generation (void)
+{
+  return disk_dev_generation;
+}
+
+static void grub_disk_open_cache_flush (void);
+
+void
+grub_disk_dev_generation_bump (void)
+{
+  /* Drain cached open disks while the driver triggering the bump is
+     still in a consistent state.  */
+  grub_disk_open_cache_flush ();
+  disk_dev_generation++;
+  if (disk_dev_generation == 0)
+    disk_dev_generation = 1;
+}
+
 void
 grub_disk_dev_register (grub_disk_dev_t dev)
 {
   dev->next = grub_disk_dev_list;
   grub_disk_dev_list = dev;
+  grub_disk_dev_generation_bump ();
 }
 
 void
@@ -164,6 +320,7 @@ grub_disk_dev_unregister (grub_disk_dev_t dev)
         *p = q->next;
 	break;
       }
+  grub_disk_dev_generation_bump ();
 }
 
 /* Return the location of the first ',', if any, which is not
@@ -184,6 +341,33 @@ find_part_sep (const char *name)
   return NULL;
 }
 
+/* Recently closed disks, kept fully opened for reuse.  A boot opens the
+   same `(hd0,gpt2)' string once per file; handing back the previous
+   structure skips the driver open and the partition probe.  Disks enter
+   the cache only once closed, so every caller still owns its structure
+   exclusively and read hooks cannot leak between users.  The cache is
+   drained on every device generation bump and when the removable media
+   timeout expires, so a hit cannot go stale.  */
+#define GRUB_DISK_OPEN_CACHE_NUM	4
+
+static grub_disk_t disk_open_cache[GRUB_DISK_OPEN_CACHE_NUM];
+static unsigned disk_open_cache_pos;
+
+static void grub_disk_close_real (grub_disk_t disk);
+
+static void
+grub_disk_open_cache_flush (void)
+{
+  unsigned i;
+
+  for (i = 0; i < GRUB_DISK_OPEN_CACHE_NUM; i++)
+    if (disk_open_cache[i])
+      {
+	grub_disk_close_real (disk_open_cache[i]);
+	disk_open_cache[i] = 0;
+      }
+}
+
 grub_disk_t
 grub_disk_open (const char *name)
 {
@@ -195,6 +379,26 @@ grub_disk_open (const char *name)
 
   grub_dprintf ("disk", "Opening `%s'...\n", name);
 
+  /* Reuse a recently closed disk when the open string matches.  */
+  current_time = grub_get_time_ms ();
+  if (current_time > (grub_last_time + GRUB_CACHE_TIMEOUT * 1000))
+    grub_disk_open_cache_flush ();
+  else
+    {
+      unsigned i;
+
+      for (i = 0; i < GRUB_DISK_OPEN_CACHE_NUM; i++)
+	if (disk_open_cache[i]
+	    && grub_strcmp (disk_open_cache[i]->open_name, name) == 0)
+	  {
+	    disk = disk_open_cache[i];
+	    disk_open_cache[i] = 0;
+	    grub_last_time = current_time;
+	    grub_dprintf ("disk", "Opening `%s' succeeded (reused).\n", name);
+	    return disk;
+	  }
+    }
+
   disk = (grub_disk_t) grub_zalloc (sizeof (*disk));
   if (! disk)
     return 0;
@@ -270,6 +474,8 @@ grub_disk_open (const char *name)
 
   grub_last_time = current_time;
 
+  grub_disk_cache_stat_set_name (disk);
+
  fail:
 
   if (raw && raw != name)
@@ -285,116 +491,81 @@ grub_disk_open (const char *name)
       return 0;
     }
 
+  /* Key for the closed-disk reuse cache; on allocation failure the disk
+     simply isn't cached.  */
+  disk->open_name = grub_strdup (name);
+  grub_errno = GRUB_ERR_NONE;
+
   grub_dprintf ("disk", "Opening `%s' succeeded.\n", name);
 
   return disk;
 }
 
-void
-grub_disk_close (grub_disk_t disk)
+static void
+grub_disk_close_real (grub_disk_t disk)
 {
   grub_partition_t part;
-  grub_dprintf ("disk", "Closing `%s'...\n", disk->name);
 
   if (disk->dev && disk->dev->disk_close)
     (disk->dev->disk_close) (disk);
 
-  /* Reset the timer.  */
-  grub_last_time = grub_get_time_ms ();
-
   while (disk->partition)
     {
       part = disk->partition->parent;
       grub_free (disk->partition);
       disk->partition = part;
     }
+  grub_partition_cache_free (disk);
   grub_dprintf ("disk", "Closing `%s' succeeded.\n", disk->name);
+  grub_free (disk->open_name);
   grub_free ((void *) disk->name);
   grub_free (disk);
-
 }
 
-/* Small read (less than cache size and not pass across cache unit boundaries).
-   sector is already adjusted and is divisible by cache unit size.
- */
-static grub_err_t
-grub_disk_read_small_real (grub_disk_t disk, grub_disk_addr_t sector,
-			   grub_off_t offset, grub_size_t size, void *buf)
+void
+grub_disk_close (grub_disk_t disk)
 {
-  char *data;
-  char *tmp_buf;
+  grub_dprintf ("disk", "Closing `%s'...\n", disk->name);
 
-  /* Fetch the cache.  */
-  data = grub_disk_cache_fetch (disk->dev->id, disk->id, sector);
-  if (data)
+  /* Reset the timer.  */
+  grub_last_time = grub_get_time_ms ();
+
+  if (disk->open_name)
     {
-      /* Just copy it!  */
-      grub_memcpy (buf, data + offset, size);
-      grub_disk_cache_unlock (disk->dev->id, disk->id, sector);
-      return GRUB_ERR_NONE;
+      unsigned i = disk_open_cache_pos;
+
+      if (disk_open_cache[i])
+	grub_disk_close_real (disk_open_cache[i]);
+
+      disk->read_hook = 0;
+      disk->read_hook_data = 0;
+      disk->readahead = 0;
+      disk->readahead_seq = 0;
+      disk->readahead_next = 0;
+      disk_open_cache[i] = disk;
+      disk_open_cache_pos = (i + 1) % GRUB_DISK_OPEN_CACHE_NUM;
+      return;
     }
 
-  /* Allocate a temporary buffer.  */
-  tmp_buf = grub_malloc (GRUB_DISK_SECTOR_SIZE << GRUB_DISK_CACHE_BITS);
-  if (! tmp_buf)
-    return grub_errno;
+  grub_disk_close_real (disk);
+}
 
-  /* Otherwise read data from the disk actually.  */
-  if (disk->total_sectors == GRUB_DISK_SIZE_UNKNOWN
-      || sector + GRUB_DISK_CACHE_SIZE
-      < (disk->total_sectors << (disk->log_sector_size - GRUB_DISK_SECTOR_BITS)))
-    {
-      grub_err_t err;
-      err = (disk->dev->disk_read) (disk, transform_sector (disk, sector),
-				    1U << (GRUB_DISK_CACHE_BITS
-					   + GRUB_DISK_SECTOR_BITS
-					   - disk->log_sector_size), tmp_buf);
-      if (!err)
-	{
-	  /* Copy it and store it in the disk cache.  */
-	  grub_memcpy (buf, tmp_buf + offset, size);
-	  grub_disk_cache_store (disk->dev->id, disk->id,
-				 sector, tmp_buf);
-	  grub_free (tmp_buf);
-	  return GRUB_ERR_NONE;
-	}
-    }
+/* The small-read path in disk_read.c is instantiated once with the
+   sector size as a runtime value and once for each of the two sector
+   sizes disks actually ship with, so the common cases run with
+   constant-folded shifts.  grub_disk_read_small picks the variant once
+   per call.  */
+#define GRUB_DISK_RD_SMALL_REAL grub_disk_read_small_real
+#define GRUB_DISK_RD_LOG_SECTOR_SIZE (disk->log_sector_size)
+#include "disk_read.c"
 
-  grub_free (tmp_buf);
-  grub_errno = GRUB_ERR_NONE;
+#define GRUB_DISK_RD_SMALL_REAL grub_disk_read_small_real_512
+#define GRUB_DISK_RD_LOG_SECTOR_SIZE GRUB_DISK_SECTOR_BITS
+#include "disk_read.c"
 
-  {
-    /* Uggh... Failed. Instead, just read necessary data.  */
-    unsigned num;
-    grub_disk_addr_t aligned_sector;
-
-    sector += (offset >> GRUB_DISK_SECTOR_BITS);
-    offset &= ((1 << GRUB_DISK_SECTOR_BITS) - 1);
-    aligned_sector = (sector & ~((1ULL << (disk->log_sector_size
-					   - GRUB_DISK_SECTOR_BITS))
-				 - 1));
-    offset += ((sector - aligned_sector) << GRUB_DISK_SECTOR_BITS);
-    num = ((size + offset + (1ULL << (disk->log_sector_size))
-	    - 1) >> (disk->log_sector_size));
-
-    tmp_buf = grub_malloc (num << disk->log_sector_size);
-    if (!tmp_buf)
-      return grub_errno;
-    
-    if ((disk->dev->disk_read) (disk, transform_sector (disk, aligned_sector),
-				num, tmp_buf))
-      {
-	grub_error_push ();
-	grub_dprintf ("disk", "%s read failed\n", disk->name);
-	grub_error_pop ();
-	grub_free (tmp_buf);
-	return grub_errno;
-      }
-    grub_memcpy (buf, tmp_buf + offset, size);
-    grub_free (tmp_buf);
-    return GRUB_ERR_NONE;
-  }
-}
+#define GRUB_DISK_RD_SMALL_REAL grub_disk_read_small_real_4096
+#define GRUB_DISK_RD_LOG_SECTOR_SIZE 12
+#include "disk_read.c"
 
 static grub_err_t
 grub_disk_read_small (grub_disk_t disk, grub_disk_addr_t sector,
@@ -402,7 +573,12 @@ grub_disk_read_small (grub_disk_t disk, grub_disk_addr_t sector,
 {
   grub_err_t err;
 
-  err = grub_disk_read_small_real (disk, sector, offset, size, buf);
+  if (disk->log_sector_size == GRUB_DISK_SECTOR_BITS)
+    err = grub_disk_read_small_real_512 (disk, sector, offset, size, buf);
+  else if (disk->log_sector_size == 12)
+    err = grub_disk_read_small_real_4096 (disk, sector, offset, size, buf);
+  else
+    err = grub_disk_read_small_real (disk, sector, offset, size, buf);
   if (err)
     return err;
   if (disk->read_hook)
@@ -412,6 +588,72 @@ grub_disk_read_small (grub_disk_t disk, grub_disk_addr_t sector,
   return GRUB_ERR_NONE;
 }
 
+/* Set the speculative sequential readahead level of DISK
+   (GRUB_DISK_READAHEAD_*).  Loaders streaming large files (kernel,
+   initrd) opt in; random-access callers are unaffected.  */
+void
+grub_disk_set_readahead (grub_disk_t disk, int enable)
+{
+  disk->readahead = enable;
+  disk->readahead_seq = (enable == GRUB_DISK_READAHEAD_EAGER) ? 2 : 0;
+}
+
+/* Speculatively read chunks starting at the cache-aligned SECTOR into the
+   disk cache, ahead of demand.  Errors are swallowed: a failed readahead
+   must not fail the read that triggered it.  */
+static void
+grub_disk_readahead (grub_disk_t disk, grub_disk_addr_t sector)
+{
+  grub_disk_addr_t chunks;
+  char *tmp_buf;
+  grub_disk_addr_t i;
+
+  /* Grow the window with the length of the sequential run, up to the
+     device agglomeration limit.  */
+  chunks = (grub_disk_addr_t) 1 << (disk->readahead_seq < 4
+				    ? disk->readahead_seq : 4);
+  if (chunks > disk->max_agglomerate)
+    chunks = disk->max_agglomerate;
+
+  if (disk->total_sectors == GRUB_DISK_SIZE_UNKNOWN)
+    return;
+  if (sector + (chunks << GRUB_DISK_CACHE_BITS)
+      > (disk->total_sectors << (disk->log_sector_size - GRUB_DISK_SECTOR_BITS)))
+    return;
+
+  /* Already resident: a previous readahead covered this window.  */
+  if (grub_disk_cache_fetch (disk->dev->id, disk->id, sector))
+    {
+      grub_disk_cache_unlock (disk->dev->id, disk->id, sector);
+      return;
+    }
+
+  tmp_buf = grub_malloc (chunks << (GRUB_DISK_CACHE_BITS
+				    + GRUB_DISK_SECTOR_BITS));
+  if (! tmp_buf)
+    {
+      grub_errno = GRUB_ERR_NONE;
+      return;
+    }
+
+  if ((disk->dev->disk_read) (disk, transform_sector (disk, sector),
+			      chunks << (GRUB_DISK_CACHE_BITS
+					 + GRUB_DISK_SECTOR_BITS
+					 - disk->log_sector_size),
+			      tmp_buf) == GRUB_ERR_NONE)
+    {
+      grub_disk_cache_stat_count_read (disk->dev->id, disk->id,
+				       chunks << GRUB_DISK_CACHE_BITS);
+      for (i = 0; i < chunks; i++)
+	grub_disk_cache_store (disk->dev->id, disk->id,
+			       sector + (i << GRUB_DISK_CACHE_BITS),
+			       tmp_buf + (i << (GRUB_DISK_CACHE_BITS
+						+ GRUB_DISK_SECTOR_BITS)));
+    }
+  grub_errno = GRUB_ERR_NONE;
+  grub_free (tmp_buf);
+}
+
 /* Read data from the disk.  */
 grub_err_t
 grub_disk_read (grub_disk_t disk, grub_disk_addr_t sector,
@@ -427,6 +669,42 @@ grub_disk_read (grub_disk_t disk, grub_disk_addr_t sector,
       return grub_errno;
     }
 
+  /* A directly addressable device (memdisk) serves the whole request
+     with one copy; the sector cache and readahead would only duplicate
+     memory that is already resident.  */
+  if (disk->dev->disk_direct_ptr)
+    {
+      const char *src;
+
+      src = disk->dev->disk_direct_ptr (disk,
+					(sector << GRUB_DISK_SECTOR_BITS)
+					+ offset, size);
+      if (src)
+	{
+	  grub_memcpy (buf, src, size);
+	  if (disk->read_hook)
+	    (disk->read_hook) (sector + (offset >> GRUB_DISK_SECTOR_BITS),
+			       offset & (GRUB_DISK_SECTOR_SIZE - 1),
+			       size, disk->read_hook_data);
+	  return GRUB_ERR_NONE;
+	}
+    }
+
+  /* Track sequential access for readahead.  The run length resets on
+     the first non-contiguous read; an eager stream only drops back to a
+     modest window, so a metadata read in the middle of a bulk copy does
+     not force the prefetcher through a fresh ramp-up.  */
+  if (disk->readahead)
+    {
+      if (sector == disk->readahead_next && disk->readahead_seq < 31)
+	disk->readahead_seq++;
+      else
+	disk->readahead_seq
+	  = (disk->readahead == GRUB_DISK_READAHEAD_EAGER) ? 2 : 0;
+      disk->readahead_next = sector
+	+ ((offset + size + GRUB_DISK_SECTOR_SIZE - 1) >> GRUB_DISK_SECTOR_BITS);
+    }
+
   /* First read until first cache boundary.   */
   if (offset || (sector & (GRUB_DISK_CACHE_SIZE - 1)))
     {
@@ -486,6 +764,11 @@ grub_disk_read (grub_disk_t disk, grub_disk_addr_t sector,
       if (agglomerate)
 	{
 	  grub_disk_addr_t i;
+	  struct cache_stat_slot *slot;
+
+	  slot = grub_disk_cache_stat_find (disk->dev->id, disk->id);
+	  if (slot)
+	    slot->agglomerated += agglomerate;
 
 	  err = (disk->dev->disk_read) (disk, transform_sector (disk, sector),
 					agglomerate << (GRUB_DISK_CACHE_BITS
@@ -494,13 +777,24 @@ grub_disk_read (grub_disk_t disk, grub_disk_addr_t sector,
 					buf);
 	  if (err)
 	    return err;
-	  
-	  for (i = 0; i < agglomerate; i ++)
-	    grub_disk_cache_store (disk->dev->id, disk->id,
-				   sector + (i << GRUB_DISK_CACHE_BITS),
-				   (char *) buf
-				   + (i << (GRUB_DISK_CACHE_BITS
-					    + GRUB_DISK_SECTOR_BITS)));
+
+	  grub_disk_cache_stat_count_read (disk->dev->id, disk->id,
+					   (grub_disk_addr_t) agglomerate
+					   << GRUB_DISK_CACHE_BITS);
+
+	  /* The device has already transferred into the caller's
+	     buffer; copying bulk data into the cache as well would
+	     only evict hotter metadata and double the memory
+	     traffic.  Sector-aligned reads of this size are file
+	     payloads read once, so populate the cache only for
+	     smaller reads.  */
+	  if (agglomerate < GRUB_DISK_CACHE_BULK_LINES)
+	    for (i = 0; i < agglomerate; i ++)
+	      grub_disk_cache_store (disk->dev->id, disk->id,
+				     sector + (i << GRUB_DISK_CACHE_BITS),
+				     (char *) buf
+				     + (i << (GRUB_DISK_CACHE_BITS
+					      + GRUB_DISK_SECTOR_BITS)));
 
 
 	  if (disk->read_hook)
@@ -533,9 +827,118 @@ grub_disk_read (grub_disk_t disk, grub_disk_addr_t sector,
 	return err;
     }
 
+  /* After a second consecutive sequential read, pull the next window
+     into the cache so the following reads hit without device I/O.  */
+  if (disk->readahead && disk->readahead_seq >= 2)
+    grub_disk_readahead (disk,
+			 ALIGN_UP (disk->readahead_next,
+				   GRUB_DISK_CACHE_SIZE));
+
   return grub_errno;
 }
 
+static inline grub_uint64_t
+grub_disk_extent_start (const struct grub_disk_extent *ext)
+{
+  return (ext->sector << GRUB_DISK_SECTOR_BITS) + ext->offset;
+}
+
+/* Extents whose disk gap is at most this many bytes are served by one
+   read through the gap: on rotational media the head passes over the
+   gap anyway, and on any transport one larger command is cheaper than
+   two round trips.  */
+#define GRUB_DISK_MERGE_GAP	(32 * 1024)
+
+/* Upper bound on the disk span covered by one merged dispatch, which
+   is also the bounce buffer size for gapped merges.  */
+#define GRUB_DISK_MERGE_MAX	(128 * 1024)
+
+/* Read a batch of extents in one pass.  The vector is sorted in place by
+   disk position, and extents that are close on disk are merged into
+   single reads - directly into the destination when disk and buffer are
+   both contiguous, through a bounce buffer when small gaps have to be
+   read over - so a fragmented file costs one round trip per disk
+   neighborhood instead of one per extent.  */
+grub_err_t
+grub_disk_read_multi (grub_disk_t disk, struct grub_disk_extent *vec,
+		      grub_size_t n)
+{
+  grub_size_t i, j, k;
+
+  /* Insertion sort: batches are small and usually already nearly
+     sorted.  */
+  for (i = 1; i < n; i++)
+    {
+      struct grub_disk_extent tmp = vec[i];
+
+      for (j = i;
+	   j > 0 && grub_disk_extent_start (&vec[j - 1])
+	     > grub_disk_extent_start (&tmp);
+	   j--)
+	vec[j] = vec[j - 1];
+      vec[j] = tmp;
+    }
+
+  for (i = 0; i < n; i = j)
+    {
+      grub_uint64_t start = grub_disk_extent_start (&vec[i]);
+      grub_uint64_t end = start + vec[i].size;
+      int contiguous = 1;
+      char *bounce;
+      grub_err_t err;
+
+      for (j = i + 1; j < n; j++)
+	{
+	  grub_uint64_t s = grub_disk_extent_start (&vec[j]);
+
+	  if (s < end || s - end > GRUB_DISK_MERGE_GAP
+	      || s + vec[j].size - start > GRUB_DISK_MERGE_MAX)
+	    break;
+	  if (s != end || (char *) vec[j].buf
+	      != (char *) vec[j - 1].buf + vec[j - 1].size)
+	    contiguous = 0;
+	  end = s + vec[j].size;
+	}
+
+      if (contiguous)
+	{
+	  err = grub_disk_read (disk, vec[i].sector, vec[i].offset,
+				end - start, vec[i].buf);
+	  if (err)
+	    return err;
+	  continue;
+	}
+
+      bounce = grub_malloc (end - start);
+      if (!bounce)
+	{
+	  /* Fall back to one read per extent.  */
+	  grub_errno = GRUB_ERR_NONE;
+	  for (k = i; k < j; k++)
+	    {
+	      err = grub_disk_read (disk, vec[k].sector, vec[k].offset,
+				    vec[k].size, vec[k].buf);
+	      if (err)
+		return err;
+	    }
+	  continue;
+	}
+
+      err = grub_disk_read (disk, vec[i].sector, vec[i].offset,
+			    end - start, bounce);
+      if (!err)
+	for (k = i; k < j; k++)
+	  grub_memcpy (vec[k].buf,
+		       bounce + (grub_disk_extent_start (&vec[k]) - start),
+		       vec[k].size);
+      grub_free (bounce);
+      if (err)
+	return err;
+    }
+
+  return GRUB_ERR_NONE;
+}
+
 grub_uint64_t
 grub_disk_native_sectors (grub_disk_t disk)
 {
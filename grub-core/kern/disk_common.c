@@ -62,5 +62,34 @@ grub_disk_cache_get_index (unsigned long dev_id, unsigned long disk_id,
 {
   return ((dev_id * 524287UL + disk_id * 2606459UL
 	   + ((unsigned) (sector >> GRUB_DISK_CACHE_BITS)))
-	  % GRUB_DISK_CACHE_NUM);
+	  % GRUB_DISK_CACHE_SETS) * GRUB_DISK_CACHE_WAYS;
+}
+
+/* Probe all ways of the set SECTOR hashes to.  Return the matching entry,
+   or NULL.  If LRU is non-NULL, also return the least recently used way of
+   the set there, so a caller storing a new chunk knows which way to evict.  */
+static struct grub_disk_cache *
+grub_disk_cache_find (unsigned long dev_id, unsigned long disk_id,
+		      grub_disk_addr_t sector, struct grub_disk_cache **lru)
+{
+  struct grub_disk_cache *set;
+  unsigned way;
+
+  set = grub_disk_cache_table
+    + grub_disk_cache_get_index (dev_id, disk_id, sector);
+
+  if (lru)
+    *lru = set;
+  for (way = 0; way < GRUB_DISK_CACHE_WAYS; way++)
+    {
+      struct grub_disk_cache *cache = set + way;
+
+      if (cache->data && cache->dev_id == dev_id
+	  && cache->disk_id == disk_id && cache->sector == sector)
+	return cache;
+      if (lru && cache->last_use < (*lru)->last_use)
+	*lru = cache;
+    }
+
+  return NULL;
 }
@@ -0,0 +1,105 @@
+/* Template for the small-read path, included from disk.c with
+   GRUB_DISK_RD_SMALL_REAL set to the function name and
+   GRUB_DISK_RD_LOG_SECTOR_SIZE to the disk's log2 sector size.  The 512
+   and 4096 instantiations make every sector-size shift a compile-time
+   constant, so the compiler folds the address arithmetic that otherwise
+   reloads log_sector_size on each use; the generic instantiation keeps
+   the runtime value for odd sector sizes.  */
+
+/* Small read (less than cache size and not pass across cache unit boundaries).
+   sector is already adjusted and is divisible by cache unit size.
+ */
+static grub_err_t
+GRUB_DISK_RD_SMALL_REAL (grub_disk_t disk, grub_disk_addr_t sector,
+			 grub_off_t offset, grub_size_t size, void *buf)
+{
+  char *data;
+  char *tmp_buf;
+
+  /* Fetch the cache.  */
+  data = grub_disk_cache_fetch (disk->dev->id, disk->id, sector);
+  if (data)
+    {
+      /* Just copy it!  */
+      grub_memcpy (buf, data + offset, size);
+      grub_disk_cache_unlock (disk->dev->id, disk->id, sector);
+      return GRUB_ERR_NONE;
+    }
+
+  /* Allocate a temporary buffer.  */
+  tmp_buf = grub_malloc (GRUB_DISK_SECTOR_SIZE << GRUB_DISK_CACHE_BITS);
+  if (! tmp_buf)
+    return grub_errno;
+
+  /* Otherwise read data from the disk actually.  */
+  if (disk->total_sectors == GRUB_DISK_SIZE_UNKNOWN
+      || sector + GRUB_DISK_CACHE_SIZE
+      < (disk->total_sectors << (GRUB_DISK_RD_LOG_SECTOR_SIZE
+				 - GRUB_DISK_SECTOR_BITS)))
+    {
+      grub_err_t err;
+      err = (disk->dev->disk_read) (disk,
+				    sector >> (GRUB_DISK_RD_LOG_SECTOR_SIZE
+					       - GRUB_DISK_SECTOR_BITS),
+				    1U << (GRUB_DISK_CACHE_BITS
+					   + GRUB_DISK_SECTOR_BITS
+					   - GRUB_DISK_RD_LOG_SECTOR_SIZE),
+				    tmp_buf);
+      if (!err)
+	{
+	  grub_disk_cache_stat_count_read (disk->dev->id, disk->id,
+					   GRUB_DISK_CACHE_SIZE);
+	  /* Copy it and store it in the disk cache.  */
+	  grub_memcpy (buf, tmp_buf + offset, size);
+	  grub_disk_cache_store (disk->dev->id, disk->id,
+				 sector, tmp_buf);
+	  grub_free (tmp_buf);
+	  return GRUB_ERR_NONE;
+	}
+    }
+
+  grub_free (tmp_buf);
+  grub_errno = GRUB_ERR_NONE;
+
+  {
+    /* Uggh... Failed. Instead, just read necessary data.  */
+    unsigned num;
+    grub_disk_addr_t aligned_sector;
+
+    sector += (offset >> GRUB_DISK_SECTOR_BITS);
+    offset &= ((1 << GRUB_DISK_SECTOR_BITS) - 1);
+    aligned_sector = (sector & ~((1ULL << (GRUB_DISK_RD_LOG_SECTOR_SIZE
+					   - GRUB_DISK_SECTOR_BITS))
+				 - 1));
+    offset += ((sector - aligned_sector) << GRUB_DISK_SECTOR_BITS);
+    num = ((size + offset + (1ULL << (GRUB_DISK_RD_LOG_SECTOR_SIZE))
+	    - 1) >> (GRUB_DISK_RD_LOG_SECTOR_SIZE));
+
+    tmp_buf = grub_malloc (num << GRUB_DISK_RD_LOG_SECTOR_SIZE);
+    if (!tmp_buf)
+      return grub_errno;
+
+    if ((disk->dev->disk_read) (disk,
+				aligned_sector
+				>> (GRUB_DISK_RD_LOG_SECTOR_SIZE
+				    - GRUB_DISK_SECTOR_BITS),
+				num, tmp_buf))
+      {
+	grub_error_push ();
+	grub_dprintf ("disk", "%s read failed\n", disk->name);
+	grub_error_pop ();
+	grub_free (tmp_buf);
+	return grub_errno;
+      }
+    grub_disk_cache_stat_count_read (disk->dev->id, disk->id,
+				     (grub_disk_addr_t) num
+				     << (GRUB_DISK_RD_LOG_SECTOR_SIZE
+					 - GRUB_DISK_SECTOR_BITS));
+    grub_memcpy (buf, tmp_buf + offset, size);
+    grub_free (tmp_buf);
+    return GRUB_ERR_NONE;
+  }
+}
+
+#undef GRUB_DISK_RD_SMALL_REAL
+#undef GRUB_DISK_RD_LOG_SECTOR_SIZE
@@ -84,7 +84,6 @@ grub_dl_remove (grub_dl_t mod)
 
 struct grub_symbol
 {
-  struct grub_symbol *next;
   const char *name;
   void *addr;
   int isfunc;
@@ -92,22 +91,34 @@ struct grub_symbol
 };
 typedef struct grub_symbol *grub_symbol_t;
 
-/* The size of the symbol table.  */
-#define GRUB_SYMTAB_SIZE	509
+/* The initial capacity of the symbol table.  */
+#define GRUB_SYMTAB_INITIAL_SIZE	512
 
-/* The symbol table (using an open-hash).  */
-static struct grub_symbol *grub_symtab[GRUB_SYMTAB_SIZE];
+/* The symbol table: an array of symbols kept sorted by name, so that
+   resolving the undefined symbols of a module is a binary search per
+   symbol instead of a hash chain walk.  */
+static grub_symbol_t *grub_symtab;
+static grub_size_t grub_symtab_len;
+static grub_size_t grub_symtab_size;
 
-/* Simple hash function.  */
-static unsigned
-grub_symbol_hash (const char *s)
+/* Return the index of the first symbol whose name is not less than
+   NAME (which is grub_symtab_len if there is none).  */
+static grub_size_t
+grub_symtab_lower_bound (const char *name)
 {
-  unsigned key = 0;
+  grub_size_t lo = 0, hi = grub_symtab_len;
 
-  while (*s)
-    key = key * 65599 + *s++;
+  while (lo < hi)
+    {
+      grub_size_t mid = lo + (hi - lo) / 2;
+
+      if (grub_strcmp (grub_symtab[mid]->name, name) < 0)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
 
-  return (key + (key >> 5)) % GRUB_SYMTAB_SIZE;
+  return lo;
 }
 
 /* Resolve the symbol name NAME and return the address.
@@ -115,11 +126,11 @@ grub_symbol_hash (const char *s)
 static grub_symbol_t
 grub_dl_resolve_symbol (const char *name)
 {
-  grub_symbol_t sym;
+  grub_size_t idx = grub_symtab_lower_bound (name);
 
-  for (sym = grub_symtab[grub_symbol_hash (name)]; sym; sym = sym->next)
-    if (grub_strcmp (sym->name, name) == 0)
-      return sym;
+  if (idx < grub_symtab_len
+      && grub_strcmp (grub_symtab[idx]->name, name) == 0)
+    return grub_symtab[idx];
 
   return 0;
 }
@@ -138,28 +149,26 @@ grub_resolve_symbol (const char *name)
 const char *
 grub_get_symbol_by_addr(const void *addr, int isfunc)
 {
-  unsigned int i;
+  grub_size_t i;
   grub_symbol_t before = NULL, after = NULL;
-  for (i = 0; i < GRUB_SYMTAB_SIZE; i++)
+  for (i = 0; i < grub_symtab_len; i++)
     {
-      grub_symbol_t sym;
-      for (sym = grub_symtab[i]; sym; sym = sym->next)
+      grub_symbol_t sym = grub_symtab[i];
+
+      //grub_printf ("addr 0x%08llx symbol %s\n", (unsigned long long)sym->addr, sym->name);
+      if (sym->addr > addr)
 	{
-	  //grub_printf ("addr 0x%08llx symbol %s\n", (unsigned long long)sym->addr, sym->name);
-	  if (sym->addr > addr)
-	    {
-	      if (!after || sym->addr > after->addr)
-		after = sym;
-	    }
+	  if (!after || sym->addr > after->addr)
+	    after = sym;
+	}
 
-	  if (isfunc != sym->isfunc)
-	    continue;
-	  if (sym->addr > addr)
-	    continue;
+      if (isfunc != sym->isfunc)
+	continue;
+      if (sym->addr > addr)
+	continue;
 
-	  if ((!before && sym->addr <= addr) || (before && before->addr <= sym->addr))
-	    before = sym;
-	}
+      if ((!before && sym->addr <= addr) || (before && before->addr <= sym->addr))
+	before = sym;
     }
 
   if (before && addr < after->addr)
@@ -174,7 +183,21 @@ grub_dl_register_symbol (const char *name, void *addr, int isfunc,
 			 grub_dl_t mod)
 {
   grub_symbol_t sym;
-  unsigned k;
+  grub_size_t idx;
+
+  if (grub_symtab_len == grub_symtab_size)
+    {
+      grub_size_t new_size = grub_symtab_size ? grub_symtab_size * 2
+					      : GRUB_SYMTAB_INITIAL_SIZE;
+      grub_symbol_t *new_symtab;
+
+      new_symtab = grub_realloc (grub_symtab,
+				 new_size * sizeof (*new_symtab));
+      if (! new_symtab)
+	return grub_errno;
+      grub_symtab = new_symtab;
+      grub_symtab_size = new_size;
+    }
 
   sym = (grub_symbol_t) grub_malloc (sizeof (*sym));
   if (! sym)
@@ -196,9 +219,14 @@ grub_dl_register_symbol (const char *name, void *addr, int isfunc,
   sym->mod = mod;
   sym->isfunc = isfunc;
 
-  k = grub_symbol_hash (name);
-  sym->next = grub_symtab[k];
-  grub_symtab[k] = sym;
+  /* Insert before any symbol of the same name, so a later
+     registration shadows an earlier one just as the old hash chains
+     did.  */
+  idx = grub_symtab_lower_bound (sym->name);
+  grub_memmove (grub_symtab + idx + 1, grub_symtab + idx,
+		(grub_symtab_len - idx) * sizeof (*grub_symtab));
+  grub_symtab[idx] = sym;
+  grub_symtab_len++;
 
   return GRUB_ERR_NONE;
 }
@@ -207,28 +235,26 @@ grub_dl_register_symbol (const char *name, void *addr, int isfunc,
 static void
 grub_dl_unregister_symbols (grub_dl_t mod)
 {
-  unsigned i;
+  grub_size_t i, j;
 
   if (! mod)
     grub_fatal ("core symbols cannot be unregistered");
 
-  for (i = 0; i < GRUB_SYMTAB_SIZE; i++)
+  /* Compact the array, dropping the symbols of MOD; the surviving
+     symbols keep their relative order, so it stays sorted.  */
+  for (i = 0, j = 0; i < grub_symtab_len; i++)
     {
-      grub_symbol_t sym, *p, q;
+      grub_symbol_t sym = grub_symtab[i];
 
-      for (p = &grub_symtab[i], sym = *p; sym; sym = q)
+      if (sym->mod == mod)
 	{
-	  q = sym->next;
-	  if (sym->mod == mod)
-	    {
-	      *p = q;
-	      grub_free ((void *) sym->name);
-	      grub_free (sym);
-	    }
-	  else
-	    p = &sym->next;
+	  grub_free ((void *) sym->name);
+	  grub_free (sym);
 	}
+      else
+	grub_symtab[j++] = sym;
     }
+  grub_symtab_len = j;
 }
 
 /* Return the address of a section whose index is N.  */
@@ -406,6 +432,9 @@ grub_dl_resolve_symbols (grub_dl_t mod, Elf_Ehdr *e)
   Elf_Sym *sym;
   const char *str;
   Elf_Word size, entsize;
+  void **secaddr;
+  grub_dl_segment_t seg;
+  grub_err_t err = GRUB_ERR_NONE;
 
   grub_dprintf ("modules", "Resolving symbols for \"%s\"\n", mod->name);
   for (i = 0, s = (Elf_Shdr *) ((char *) e + e->e_shoff);
@@ -436,6 +465,16 @@ grub_dl_resolve_symbols (grub_dl_t mod, Elf_Ehdr *e)
   s = (Elf_Shdr *) ((char *) e + e->e_shoff + e->e_shentsize * s->sh_link);
   str = (char *) e + s->sh_offset;
 
+  /* Every symbol below is adjusted by its section's load address.
+     Walking the segment list once per symbol is quadratic on big
+     modules, so flatten it into a table indexed by section number.  */
+  secaddr = grub_zalloc (e->e_shnum * sizeof (*secaddr));
+  if (! secaddr)
+    return grub_errno;
+  for (seg = mod->segment; seg; seg = seg->next)
+    if (seg->section < e->e_shnum)
+      secaddr[seg->section] = seg->addr;
+
   for (i = 0;
        i < size / entsize;
        i++, sym = (Elf_Sym *) ((char *) sym + entsize))
@@ -443,6 +482,7 @@ grub_dl_resolve_symbols (grub_dl_t mod, Elf_Ehdr *e)
       unsigned char type = ELF_ST_TYPE (sym->st_info);
       unsigned char bind = ELF_ST_BIND (sym->st_info);
       const char *name = str + sym->st_name;
+      void *sec_addr = sym->st_shndx < e->e_shnum ? secaddr[sym->st_shndx] : 0;
 
       switch (type)
 	{
@@ -453,32 +493,39 @@ grub_dl_resolve_symbols (grub_dl_t mod, Elf_Ehdr *e)
 	    {
 	      grub_symbol_t nsym = grub_dl_resolve_symbol (name);
 	      if (! nsym)
-		return grub_error (GRUB_ERR_BAD_MODULE,
-				   N_("symbol `%s' not found"), name);
+		{
+		  err = grub_error (GRUB_ERR_BAD_MODULE,
+				    N_("symbol `%s' not found"), name);
+		  goto out;
+		}
 	      sym->st_value = (Elf_Addr) nsym->addr;
 	      if (nsym->isfunc)
 		sym->st_info = ELF_ST_INFO (bind, STT_FUNC);
 	    }
 	  else
 	    {
-	      sym->st_value += (Elf_Addr) grub_dl_get_section_addr (mod,
-								    sym->st_shndx);
+	      sym->st_value += (Elf_Addr) sec_addr;
 	      if (bind != STB_LOCAL)
 		if (grub_dl_register_symbol (name, (void *) sym->st_value, 0, mod))
-		  return grub_errno;
+		  {
+		    err = grub_errno;
+		    goto out;
+		  }
 	    }
 	  break;
 
 	case STT_FUNC:
-	  sym->st_value += (Elf_Addr) grub_dl_get_section_addr (mod,
-								sym->st_shndx);
+	  sym->st_value += (Elf_Addr) sec_addr;
 #ifdef __ia64__
 	  {
 	      /* FIXME: free descriptor once it's not used anymore. */
 	      char **desc;
 	      desc = grub_malloc (2 * sizeof (char *));
 	      if (!desc)
-		return grub_errno;
+		{
+		  err = grub_errno;
+		  goto out;
+		}
 	      desc[0] = (void *) sym->st_value;
 	      desc[1] = mod->base;
 	      sym->st_value = (grub_addr_t) desc;
@@ -486,7 +533,10 @@ grub_dl_resolve_symbols (grub_dl_t mod, Elf_Ehdr *e)
 #endif
 	  if (bind != STB_LOCAL)
 	    if (grub_dl_register_symbol (name, (void *) sym->st_value, 1, mod))
-	      return grub_errno;
+	      {
+		err = grub_errno;
+		goto out;
+	      }
 	  if (grub_strcmp (name, "grub_mod_init") == 0)
 	    mod->init = (void (*) (grub_dl_t)) sym->st_value;
 	  else if (grub_strcmp (name, "grub_mod_fini") == 0)
@@ -494,8 +544,7 @@ grub_dl_resolve_symbols (grub_dl_t mod, Elf_Ehdr *e)
 	  break;
 
 	case STT_SECTION:
-	  sym->st_value = (Elf_Addr) grub_dl_get_section_addr (mod,
-							       sym->st_shndx);
+	  sym->st_value = (Elf_Addr) sec_addr;
 	  break;
 
 	case STT_FILE:
@@ -503,12 +552,15 @@ grub_dl_resolve_symbols (grub_dl_t mod, Elf_Ehdr *e)
 	  break;
 
 	default:
-	  return grub_error (GRUB_ERR_BAD_MODULE,
-			     "unknown symbol type `%d'", (int) type);
+	  err = grub_error (GRUB_ERR_BAD_MODULE,
+			    "unknown symbol type `%d'", (int) type);
+	  goto out;
 	}
     }
 
-  return GRUB_ERR_NONE;
+ out:
+  grub_free (secaddr);
+  return err;
 }
 
 static Elf_Shdr *
@@ -687,6 +739,9 @@ grub_dl_set_mem_attrs (grub_dl_t mod, void *ehdr)
   unsigned i;
   const Elf_Shdr *s;
   const Elf_Ehdr *e = ehdr;
+  grub_addr_t run_start = 0, run_end = 0;
+  grub_uint64_t run_set = 0, run_clear = 0;
+  int have_run = 0;
 #if !defined (__i386__) && !defined (__x86_64__) && !defined(__riscv)
   grub_size_t arch_addralign = grub_arch_dl_min_alignment ();
   grub_addr_t tgaddr;
@@ -730,9 +785,31 @@ grub_dl_set_mem_attrs (grub_dl_t mod, void *ehdr)
 		    (set_attrs & GRUB_MEM_ATTR_R) ? "r" : "",
 		    (set_attrs & GRUB_MEM_ATTR_W) ? "w" : "",
 		    (set_attrs & GRUB_MEM_ATTR_X) ? "x" : "");
-      grub_update_mem_attrs ((grub_addr_t)(seg->addr), seg->size, set_attrs, clear_attrs);
+
+      /* Segments are laid out in section order inside the module
+	 allocation, so consecutive sections wanting the same
+	 permissions form one contiguous range.  Batch them into a
+	 single attribute transition instead of paying the TLB
+	 maintenance cost once per section.  */
+      if (have_run && set_attrs == run_set && clear_attrs == run_clear
+	  && (grub_addr_t) seg->addr >= run_end)
+	run_end = (grub_addr_t) seg->addr + seg->size;
+      else
+	{
+	  if (have_run)
+	    grub_update_mem_attrs (run_start, run_end - run_start,
+				   run_set, run_clear);
+	  run_start = (grub_addr_t) seg->addr;
+	  run_end = run_start + seg->size;
+	  run_set = set_attrs;
+	  run_clear = clear_attrs;
+	  have_run = 1;
+	}
     }
 
+  if (have_run)
+    grub_update_mem_attrs (run_start, run_end - run_start, run_set, run_clear);
+
 #if !defined (__i386__) && !defined (__x86_64__) && !defined(__riscv)
   tgaddr = grub_min((grub_addr_t)mod->tramp, (grub_addr_t)mod->got);
   tgsz = grub_max((grub_addr_t)mod->trampptr, (grub_addr_t)mod->gotptr) - tgaddr;
@@ -858,6 +935,16 @@ grub_dl_load_core_noinit (void *addr, grub_size_t size)
 
   grub_dl_print_gdb_info (mod, e);
 
+  /* The symbol table is only needed while relocating.  For file-loaded
+     modules it points into the caller's ELF buffer and would dangle
+     from here on anyway; on platforms keeping a private copy this also
+     returns that copy to the heap.  */
+#ifdef GRUB_MODULES_MACHINE_READONLY
+  grub_free (mod->symtab);
+#endif
+  mod->symtab = 0;
+  mod->symsize = 0;
+
   if (grub_dl_add (mod))
     {
       grub_dl_unload (mod);
@@ -872,16 +959,19 @@ grub_dl_load_core (void *addr, grub_size_t size)
 {
   grub_dl_t mod;
 
-  grub_boot_time ("Parsing module");
+  grub_boot_time_enter ("Parsing module");
 
   mod = grub_dl_load_core_noinit (addr, size);
 
   if (!mod)
-    return NULL;
+    {
+      grub_boot_time_exit ("Module parsing failed");
+      return NULL;
+    }
 
   grub_boot_time ("Initing module %s", mod->name);
   grub_dl_init (mod);
-  grub_boot_time ("Module %s inited", mod->name);
+  grub_boot_time_exit ("Module %s inited", mod->name);
 
   return mod;
 }
@@ -170,10 +170,17 @@ shim_lock_verifier_init (grub_file_t io __attribute__ ((unused)),
     }
 }
 
+/* Located once at verifier setup; the protocol database does not
+   change underneath us after that.  */
+static grub_efi_shim_lock_protocol_t *shim_lock;
+
 static grub_err_t
 shim_lock_verifier_write (void *context __attribute__ ((unused)), void *buf, grub_size_t size)
 {
-  grub_efi_shim_lock_protocol_t *sl = grub_efi_locate_protocol (&shim_lock_guid, 0);
+  grub_efi_shim_lock_protocol_t *sl = shim_lock;
+
+  if (!sl)
+    sl = grub_efi_locate_protocol (&shim_lock_guid, 0);
 
   if (!sl)
     return grub_error (GRUB_ERR_ACCESS_DENIED, N_("shim_lock protocol not found"));
@@ -213,6 +220,7 @@ grub_shim_lock_verifier_setup (void)
     return;
 
   /* Enforce shim_lock_verifier. */
+  shim_lock = sl;
   grub_verifier_register (&shim_lock_verifier);
 
   grub_env_set ("shim_lock", "y");
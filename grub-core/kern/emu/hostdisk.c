@@ -279,8 +279,8 @@ grub_util_fd_open_device (const grub_disk_t disk, grub_disk_addr_t sector, int f
 
 
 static grub_err_t
-grub_util_biosdisk_read (grub_disk_t disk, grub_disk_addr_t sector,
-			 grub_size_t size, char *buf)
+grub_util_biosdisk_read_raw (grub_disk_t disk, grub_disk_addr_t sector,
+			     grub_size_t size, char *buf)
 {
   while (size)
     {
@@ -313,10 +313,119 @@ grub_util_biosdisk_read (grub_disk_t disk, grub_disk_addr_t sector,
   return GRUB_ERR_NONE;
 }
 
+/* Probing opens and closes the same device several times and re-reads
+   the same signature sectors on every pass.  This small block cache is
+   keyed by drive, not by the open disk, so each region of a device
+   costs one OS read per process no matter how often the device is
+   reopened.  */
+#define GRUB_HOSTDISK_CACHE_BLOCKS	32
+#define GRUB_HOSTDISK_CACHE_BYTES	(64 * 1024)
+
+struct hostdisk_cache_block
+{
+  int drive;			/* -1 when the slot is free.  */
+  unsigned log_sector_size;
+  grub_disk_addr_t start;	/* First device sector of the block.  */
+  grub_size_t sectors;		/* Valid device sectors.  */
+  char *data;
+};
+
+static struct hostdisk_cache_block hostdisk_cache[GRUB_HOSTDISK_CACHE_BLOCKS];
+static unsigned hostdisk_cache_next;
+static int hostdisk_cache_inited;
+
+static void
+grub_util_hostdisk_cache_invalidate (grub_disk_t disk)
+{
+  unsigned i;
+
+  for (i = 0; i < GRUB_HOSTDISK_CACHE_BLOCKS; i++)
+    if (hostdisk_cache[i].drive == (int) disk->id)
+      hostdisk_cache[i].drive = -1;
+}
+
+static grub_err_t
+grub_util_biosdisk_read (grub_disk_t disk, grub_disk_addr_t sector,
+			 grub_size_t size, char *buf)
+{
+  grub_size_t block_sectors
+    = GRUB_HOSTDISK_CACHE_BYTES >> disk->log_sector_size;
+  unsigned i;
+
+  if (!hostdisk_cache_inited)
+    {
+      for (i = 0; i < GRUB_HOSTDISK_CACHE_BLOCKS; i++)
+	hostdisk_cache[i].drive = -1;
+      hostdisk_cache_inited = 1;
+    }
+
+  if (!block_sectors)
+    return grub_util_biosdisk_read_raw (disk, sector, size, buf);
+
+  while (size)
+    {
+      grub_disk_addr_t bstart
+	= sector & ~(grub_disk_addr_t) (block_sectors - 1);
+      struct hostdisk_cache_block *blk = NULL;
+      grub_size_t ofs, n;
+
+      for (i = 0; i < GRUB_HOSTDISK_CACHE_BLOCKS; i++)
+	if (hostdisk_cache[i].drive == (int) disk->id
+	    && hostdisk_cache[i].log_sector_size == disk->log_sector_size
+	    && hostdisk_cache[i].start == bstart)
+	  {
+	    blk = &hostdisk_cache[i];
+	    break;
+	  }
+
+      if (!blk)
+	{
+	  grub_size_t n_fill = block_sectors;
+
+	  blk = &hostdisk_cache[hostdisk_cache_next++
+				% GRUB_HOSTDISK_CACHE_BLOCKS];
+	  if (!blk->data)
+	    blk->data = malloc (GRUB_HOSTDISK_CACHE_BYTES);
+	  if (!blk->data)
+	    return grub_util_biosdisk_read_raw (disk, sector, size, buf);
+
+	  if (disk->total_sectors != GRUB_DISK_SIZE_UNKNOWN
+	      && bstart + n_fill > disk->total_sectors)
+	    n_fill = disk->total_sectors - bstart;
+
+	  blk->drive = -1;
+	  if (grub_util_biosdisk_read_raw (disk, bstart, n_fill, blk->data))
+	    return grub_errno;
+	  blk->drive = disk->id;
+	  blk->log_sector_size = disk->log_sector_size;
+	  blk->start = bstart;
+	  blk->sectors = n_fill;
+	}
+
+      ofs = sector - blk->start;
+      if (ofs >= blk->sectors)
+	/* Past the cached tail of the device; should not happen as
+	   requests are range-checked upstream.  */
+	return grub_util_biosdisk_read_raw (disk, sector, size, buf);
+
+      n = blk->sectors - ofs;
+      if (n > size)
+	n = size;
+      memcpy (buf, blk->data + (ofs << disk->log_sector_size),
+	      n << disk->log_sector_size);
+      sector += n;
+      size -= n;
+      buf += n << disk->log_sector_size;
+    }
+  return GRUB_ERR_NONE;
+}
+
 static grub_err_t
 grub_util_biosdisk_write (grub_disk_t disk, grub_disk_addr_t sector,
 			  grub_size_t size, const char *buf)
 {
+  grub_util_hostdisk_cache_invalidate (disk);
+
   while (size)
     {
       grub_util_fd_t fd;
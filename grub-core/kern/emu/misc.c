@@ -173,6 +173,53 @@ grub_get_time_ms (void)
   return (tv.tv_sec * 1000 + tv.tv_usec / 1000);
 }
 
+/* Optional cache of image sizes and raw bytes, keyed by path.  Tools
+   such as grub-mkrescue read the same module files once per target
+   image, and grub-mkimage stats every module several times while laying
+   out the core image; the sources never change during a run, so both
+   results can be reused.  Entries with a NULL data pointer record only
+   the size.  */
+struct image_cache_entry
+{
+  struct image_cache_entry *next;
+  char *path;
+  char *data;
+  size_t size;
+};
+
+static struct image_cache_entry *image_cache;
+static int image_cache_enabled;
+
+void
+grub_util_enable_image_cache (void)
+{
+  image_cache_enabled = 1;
+}
+
+static struct image_cache_entry *
+image_cache_find (const char *path)
+{
+  struct image_cache_entry *ent;
+
+  for (ent = image_cache; ent; ent = ent->next)
+    if (strcmp (ent->path, path) == 0)
+      return ent;
+  return NULL;
+}
+
+static struct image_cache_entry *
+image_cache_insert (const char *path, size_t size)
+{
+  struct image_cache_entry *ent = xmalloc (sizeof (*ent));
+
+  ent->path = xstrdup (path);
+  ent->data = NULL;
+  ent->size = size;
+  ent->next = image_cache;
+  image_cache = ent;
+  return ent;
+}
+
 size_t
 grub_util_get_image_size (const char *path)
 {
@@ -180,6 +227,13 @@ grub_util_get_image_size (const char *path)
   size_t ret;
   off_t sz;
 
+  if (image_cache_enabled)
+    {
+      struct image_cache_entry *ent = image_cache_find (path);
+      if (ent)
+	return ent->size;
+    }
+
   f = grub_util_fopen (path, "rb");
 
   if (!f)
@@ -196,6 +250,9 @@ grub_util_get_image_size (const char *path)
 
   fclose (f);
 
+  if (image_cache_enabled)
+    image_cache_insert (path, ret);
+
   return ret;
 }
 
@@ -207,6 +264,16 @@ grub_util_load_image (const char *path, char *buf)
 
   grub_util_info ("reading %s", path);
 
+  if (image_cache_enabled)
+    {
+      struct image_cache_entry *ent = image_cache_find (path);
+      if (ent && ent->data)
+	{
+	  memcpy (buf, ent->data, ent->size);
+	  return;
+	}
+    }
+
   size = grub_util_get_image_size (path);
 
   fp = grub_util_fopen (path, "rb");
@@ -219,6 +286,15 @@ grub_util_load_image (const char *path, char *buf)
 		     strerror (errno));
 
   fclose (fp);
+
+  if (image_cache_enabled)
+    {
+      struct image_cache_entry *ent = image_cache_find (path);
+      if (!ent)
+	ent = image_cache_insert (path, size);
+      ent->data = xmalloc (size);
+      memcpy (ent->data, buf, size);
+    }
 }
 
 void
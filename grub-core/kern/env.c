@@ -28,54 +28,156 @@ static struct grub_env_context initial_context;
 /* The current context.  */
 struct grub_env_context *grub_current_context = &initial_context;
 
+/* The marker stored in slots of deleted variables, so that probe
+   sequences keep running past them.  */
+struct grub_env_var grub_env_tombstone;
+
+/* Interned names of variables that scripts read constantly.  A cache
+   hit in grub_env_find skips hashing and probing altogether; the
+   cached pointers are dropped whenever the variable is removed or the
+   context changes.  */
+static const char *const grub_env_hot_names[] = { "root", "prefix", "default" };
+static struct grub_env_var *grub_env_hot_vars[ARRAY_SIZE (grub_env_hot_names)];
+
+void
+grub_env_hot_reset (void)
+{
+  grub_memset (grub_env_hot_vars, 0, sizeof (grub_env_hot_vars));
+}
+
+/* Remember VAR if NAME is one of the hot names.  */
+static void
+grub_env_hot_note (const char *name, struct grub_env_var *var)
+{
+  grub_size_t i;
+
+  for (i = 0; i < ARRAY_SIZE (grub_env_hot_names); i++)
+    if (grub_strcmp (name, grub_env_hot_names[i]) == 0)
+      {
+	grub_env_hot_vars[i] = var;
+	return;
+      }
+}
+
+static void
+grub_env_hot_forget (struct grub_env_var *var)
+{
+  grub_size_t i;
+
+  for (i = 0; i < ARRAY_SIZE (grub_env_hot_names); i++)
+    if (grub_env_hot_vars[i] == var)
+      grub_env_hot_vars[i] = 0;
+}
+
 /* Return the hash representation of the string S.  */
 static unsigned int
 grub_env_hashval (const char *s)
 {
-  unsigned int i = 0;
+  unsigned int i = 5381;
 
-  /* XXX: This can be done much more efficiently.  */
   while (*s)
-    i += 5 * *(s++);
+    i = i * 33 + (grub_uint8_t) *(s++);
 
-  return i % HASHSZ;
+  return i;
 }
 
 static struct grub_env_var *
 grub_env_find (const char *name)
 {
-  struct grub_env_var *var;
-  int idx = grub_env_hashval (name);
+  struct grub_env_context *context = grub_current_context;
+  grub_size_t mask, idx, i;
+
+  for (i = 0; i < ARRAY_SIZE (grub_env_hot_names); i++)
+    if (grub_env_hot_vars[i]
+	&& grub_strcmp (name, grub_env_hot_names[i]) == 0)
+      return grub_env_hot_vars[i];
+
+  if (context->nslots == 0)
+    return 0;
 
   /* Look for the variable in the current context.  */
-  for (var = grub_current_context->vars[idx]; var; var = var->next)
-    if (grub_strcmp (var->name, name) == 0)
-      return var;
+  mask = context->nslots - 1;
+  for (idx = grub_env_hashval (name) & mask; context->vars[idx];
+       idx = (idx + 1) & mask)
+    if (context->vars[idx] != &grub_env_tombstone
+	&& grub_strcmp (context->vars[idx]->name, name) == 0)
+      {
+	grub_env_hot_note (name, context->vars[idx]);
+	return context->vars[idx];
+      }
 
   return 0;
 }
 
-static void
+static grub_err_t
 grub_env_insert (struct grub_env_context *context,
 		 struct grub_env_var *var)
 {
-  int idx = grub_env_hashval (var->name);
+  grub_size_t mask, idx;
+
+  /* Grow the table when it would become three quarters full.  */
+  if ((context->nused + 1) * 4 > context->nslots * 3)
+    {
+      grub_size_t new_nslots, i;
+      struct grub_env_var **new_vars;
+
+      new_nslots = context->nslots ? context->nslots * 2
+				   : GRUB_ENV_INITIAL_SLOTS;
+      new_vars = grub_calloc (new_nslots, sizeof (*new_vars));
+      if (! new_vars)
+	return grub_errno;
+
+      /* Rehash the live variables; tombstones are left behind.  */
+      mask = new_nslots - 1;
+      context->nused = 0;
+      for (i = 0; i < context->nslots; i++)
+	{
+	  struct grub_env_var *p = context->vars[i];
+
+	  if (! p || p == &grub_env_tombstone)
+	    continue;
+	  for (idx = grub_env_hashval (p->name) & mask; new_vars[idx];
+	       idx = (idx + 1) & mask)
+	    ;
+	  new_vars[idx] = p;
+	  context->nused++;
+	}
 
-  /* Insert the variable into the hashtable.  */
-  var->prevp = &context->vars[idx];
-  var->next = context->vars[idx];
-  if (var->next)
-    var->next->prevp = &(var->next);
+      grub_free (context->vars);
+      context->vars = new_vars;
+      context->nslots = new_nslots;
+    }
+
+  /* Insert the variable into the first free or deleted slot.  */
+  mask = context->nslots - 1;
+  for (idx = grub_env_hashval (var->name) & mask;
+       context->vars[idx] && context->vars[idx] != &grub_env_tombstone;
+       idx = (idx + 1) & mask)
+    ;
+  if (context->vars[idx] != &grub_env_tombstone)
+    context->nused++;
   context->vars[idx] = var;
+
+  return GRUB_ERR_NONE;
 }
 
 static void
 grub_env_remove (struct grub_env_var *var)
 {
-  /* Remove the entry from the variable table.  */
-  *var->prevp = var->next;
-  if (var->next)
-    var->next->prevp = var->prevp;
+  struct grub_env_context *context = grub_current_context;
+  grub_size_t mask = context->nslots - 1;
+  grub_size_t idx;
+
+  /* Replace the entry with a tombstone.  */
+  for (idx = grub_env_hashval (var->name) & mask; context->vars[idx];
+       idx = (idx + 1) & mask)
+    if (context->vars[idx] == var)
+      {
+	context->vars[idx] = &grub_env_tombstone;
+	break;
+      }
+
+  grub_env_hot_forget (var);
 }
 
 grub_err_t
@@ -117,7 +219,8 @@ grub_env_set (const char *name, const char *val)
   if (! var->value)
     goto fail;
 
-  grub_env_insert (grub_current_context, var);
+  if (grub_env_insert (grub_current_context, var) != GRUB_ERR_NONE)
+    goto fail;
 
   return GRUB_ERR_NONE;
 
@@ -170,26 +273,25 @@ struct grub_env_var *
 grub_env_update_get_sorted (void)
 {
   struct grub_env_var *sorted_list = 0;
-  int i;
+  grub_size_t i;
 
   /* Add variables associated with this context into a sorted list.  */
-  for (i = 0; i < HASHSZ; i++)
+  for (i = 0; i < grub_current_context->nslots; i++)
     {
-      struct grub_env_var *var;
+      struct grub_env_var *var = grub_current_context->vars[i];
+      struct grub_env_var *p, **q;
 
-      for (var = grub_current_context->vars[i]; var; var = var->next)
-	{
-	  struct grub_env_var *p, **q;
-
-	  for (q = &sorted_list, p = *q; p; q = &((*q)->sorted_next), p = *q)
-	    {
-	      if (grub_strcmp (p->name, var->name) > 0)
-		break;
-	    }
+      if (! var || var == &grub_env_tombstone)
+	continue;
 
-	  var->sorted_next = *q;
-	  *q = var;
+      for (q = &sorted_list, p = *q; p; q = &((*q)->sorted_next), p = *q)
+	{
+	  if (grub_strcmp (p->name, var->name) > 0)
+	    break;
 	}
+
+      var->sorted_next = *q;
+      *q = var;
     }
 
   return sorted_list;
@@ -33,6 +33,9 @@ static struct grub_error_saved grub_error_stack_items[GRUB_ERROR_STACK_SIZE];
 static int grub_error_stack_pos;
 static int grub_error_stack_assert;
 
+/* Depth of open probe sections; see grub_error_probe_begin().  */
+static int grub_error_probe_depth;
+
 #ifdef grub_error
 #undef grub_error
 #endif
@@ -45,6 +48,16 @@ grub_error (grub_err_t n, const char *file, const int line, const char *fmt, ...
 
   grub_errno = n;
 
+  /* Probe loops try one driver after another and throw these error
+     classes away without ever reporting them; skip the formatting they
+     would pay for each miss.  */
+  if (grub_error_probe_depth
+      && (n == GRUB_ERR_BAD_FS || n == GRUB_ERR_OUT_OF_RANGE))
+    {
+      grub_errmsg[0] = '\0';
+      return n;
+    }
+
   m = grub_snprintf (grub_errmsg, sizeof (grub_errmsg), "%s:%d:", file, line);
   if (m < 0)
     m = 0;
@@ -56,6 +69,19 @@ grub_error (grub_err_t n, const char *file, const int line, const char *fmt, ...
   return n;
 }
 
+void
+grub_error_probe_begin (void)
+{
+  grub_error_probe_depth++;
+}
+
+void
+grub_error_probe_end (void)
+{
+  if (grub_error_probe_depth > 0)
+    grub_error_probe_depth--;
+}
+
 void
 grub_error_push (void)
 {
@@ -24,6 +24,7 @@
 #include <grub/mm.h>
 #include <grub/fs.h>
 #include <grub/device.h>
+#include <grub/disk.h>
 #include <grub/i18n.h>
 
 void (*EXPORT_VAR (grub_grubnet_fini)) (void);
@@ -35,6 +36,7 @@ static const char *filter_names[] = {
     [GRUB_FILE_FILTER_GZIO] = "GRUB_FILE_FILTER_GZIO",
     [GRUB_FILE_FILTER_XZIO] = "GRUB_FILE_FILTER_XZIO",
     [GRUB_FILE_FILTER_LZOPIO] = "GRUB_FILE_FILTER_LZOPIO",
+    [GRUB_FILE_FILTER_ZSTDIO] = "GRUB_FILE_FILTER_ZSTDIO",
     [GRUB_FILE_FILTER_MAX] = "GRUB_FILE_FILTER_MAX"
 };
 
@@ -124,6 +126,13 @@ grub_file_open (const char *name, enum grub_file_type type)
   if ((file->fs->fs_open) (file, file_name) != GRUB_ERR_NONE)
     goto fail;
 
+  /* Each file holds its own disk handle, so a per-file readahead hint
+     cannot disturb other users of the device.  Sequential consumers
+     (loaders, decompressors, verifiers) then find the next window
+     already in the disk cache while they process the current chunk.  */
+  if (device->disk)
+    grub_disk_set_readahead (device->disk, GRUB_DISK_READAHEAD_ON);
+
   file->name = grub_strdup (name);
   grub_errno = GRUB_ERR_NONE;
 
@@ -41,6 +41,71 @@ probe_dummy_iter (const char *filename __attribute__ ((unused)),
   return 1;
 }
 
+/* Superblock magics of filesystems whose absence can be decided from a
+   fixed byte string, so their drivers can be skipped without a mount
+   attempt.  Filesystems with ambiguous or variable signatures (fat,
+   zfs, udf, ...) have no entry here and are always probed.  A name may
+   appear several times; the driver is skipped only if no entry for it
+   matches.  */
+struct grub_fs_signature
+{
+  const char *fsname;
+  grub_off_t offset;
+  const char *magic;
+  grub_size_t len;
+};
+
+static const struct grub_fs_signature grub_fs_signatures[] =
+  {
+    { "ext2", 0x438, "\x53\xef", 2 },
+    { "btrfs", 0x10040, "_BHRfS_M", 8 },
+    { "xfs", 0, "XFSB", 4 },
+    { "ntfs", 3, "NTFS    ", 8 },
+    { "iso9660", 0x8001, "CD001", 5 },
+    { "squash4", 0, "hsqs", 4 },
+    { "reiserfs", 0x2034, "ReIsEr", 6 },
+    { "reiserfs", 0x10034, "ReIsEr", 6 },
+    { "jfs", 0x8000, "JFS1", 4 },
+  };
+
+/* Covers the largest magic offset above (btrfs).  */
+#define GRUB_FS_SIGNATURE_READ	(0x10040 + 8)
+
+/* Return 0 if BUF (the first LEN bytes of the device) proves that
+   filesystem NAME is not present, 1 if it may be.  */
+static int
+grub_fs_signature_match (const char *buf, grub_size_t len, const char *name)
+{
+  unsigned i;
+  int seen = 0;
+
+  for (i = 0; i < ARRAY_SIZE (grub_fs_signatures); i++)
+    {
+      if (grub_strcmp (grub_fs_signatures[i].fsname, name) != 0)
+	continue;
+      if (grub_fs_signatures[i].offset + grub_fs_signatures[i].len > len)
+	return 1;
+      seen = 1;
+      if (grub_memcmp (buf + grub_fs_signatures[i].offset,
+		       grub_fs_signatures[i].magic,
+		       grub_fs_signatures[i].len) == 0)
+	return 1;
+    }
+
+  return !seen;
+}
+
+/* Move FS to the head of grub_fs_list, so the next probe tries the most
+   recently successful driver first.  */
+static void
+grub_fs_promote (grub_fs_t fs)
+{
+  if (grub_fs_list == fs)
+    return;
+  grub_list_remove (GRUB_AS_LIST (fs));
+  grub_list_push (GRUB_AS_LIST_P (&grub_fs_list), GRUB_AS_LIST (fs));
+}
+
 grub_fs_t
 grub_fs_probe (grub_device_t device)
 {
@@ -50,11 +115,38 @@ grub_fs_probe (grub_device_t device)
     {
       /* Make it sure not to have an infinite recursive calls.  */
       static int count = 0;
+      /* With "fs" debugging off nobody sees the per-driver failure
+	 messages, so don't pay for formatting and saving them.  */
+      int quiet = !grub_debug_enabled ("fs");
+      char *sig_buf;
+      grub_size_t sig_len = 0;
+
+      /* One read covering every known superblock magic; it also warms
+	 the sector cache for the winning driver's own superblock read.
+	 If it fails (tiny device, I/O error) every driver is probed as
+	 before.  */
+      sig_buf = grub_malloc (GRUB_FS_SIGNATURE_READ);
+      if (sig_buf
+	  && grub_disk_read (device->disk, 0, 0, GRUB_FS_SIGNATURE_READ,
+			     sig_buf) == GRUB_ERR_NONE)
+	sig_len = GRUB_FS_SIGNATURE_READ;
+      grub_errno = GRUB_ERR_NONE;
 
       for (p = grub_fs_list; p; p = p->next)
 	{
+	  if (sig_len
+	      && !grub_fs_signature_match (sig_buf, sig_len, p->name))
+	    {
+	      grub_dprintf ("fs", "%s skipped by signature prefilter.\n",
+			    p->name);
+	      continue;
+	    }
+
 	  grub_dprintf ("fs", "Detecting %s...\n", p->name);
 
+	  if (quiet)
+	    grub_error_probe_begin ();
+
 	  /* This is evil: newly-created just mounted BtrFS after copying all
 	     GRUB files has a very peculiar unrecoverable corruption which
 	     will be fixed at sync but we'd rather not do a global sync and
@@ -71,21 +163,35 @@ grub_fs_probe (grub_device_t device)
 	  else
 #endif
 	    (p->fs_dir) (device, "/", probe_dummy_iter, NULL);
+	  if (quiet)
+	    grub_error_probe_end ();
 	  if (grub_errno == GRUB_ERR_NONE)
-	    return p;
+	    {
+	      grub_free (sig_buf);
+	      grub_fs_promote (p);
+	      return p;
+	    }
 
-	  grub_dprintf ("fs", _("error: %s.\n"), grub_errmsg);
-	  grub_error_push ();
-	  grub_dprintf ("fs", "%s detection failed.\n", p->name);
-	  grub_error_pop ();
+	  if (!quiet)
+	    {
+	      grub_dprintf ("fs", _("error: %s.\n"), grub_errmsg);
+	      grub_error_push ();
+	      grub_dprintf ("fs", "%s detection failed.\n", p->name);
+	      grub_error_pop ();
+	    }
 
 	  if (grub_errno != GRUB_ERR_BAD_FS
 	      && grub_errno != GRUB_ERR_OUT_OF_RANGE)
-	    return 0;
+	    {
+	      grub_free (sig_buf);
+	      return 0;
+	    }
 
 	  grub_errno = GRUB_ERR_NONE;
 	}
 
+      grub_free (sig_buf);
+
       /* Let's load modules automatically.  */
       if (grub_fs_autoload_hook && count == 0)
 	{
@@ -95,10 +201,15 @@ grub_fs_probe (grub_device_t device)
 	    {
 	      p = grub_fs_list;
 
+	      if (quiet)
+		grub_error_probe_begin ();
 	      (p->fs_dir) (device, "/", probe_dummy_iter, NULL);
+	      if (quiet)
+		grub_error_probe_end ();
 	      if (grub_errno == GRUB_ERR_NONE)
 		{
 		  count--;
+		  grub_fs_promote (p);
 		  return p;
 		}
 
@@ -79,6 +79,12 @@ grub_gettext_dummy (const char *s)
 
 const char* (*grub_gettext) (const char *s) = grub_gettext_dummy;
 
+#ifdef __clang__
+#define VOLATILE_CLANG volatile
+#else
+#define VOLATILE_CLANG
+#endif
+
 void *
 grub_memmove (void *dest, const void *src, grub_size_t n)
 {
@@ -86,13 +92,52 @@ grub_memmove (void *dest, const void *src, grub_size_t n)
   const char *s = (const char *) src;
 
   if (d < s)
-    while (n--)
-      *d++ = *s++;
+    {
+      /* Copy a word at a time once source and destination can be
+	 aligned together.  Forward word copies are overlap-safe when
+	 the destination lies below the source.  */
+      if (n >= 3 * sizeof (unsigned long)
+	  && (((grub_addr_t) d ^ (grub_addr_t) s)
+	      & (sizeof (unsigned long) - 1)) == 0)
+	{
+	  while (((grub_addr_t) d & (sizeof (unsigned long) - 1)) != 0)
+	    {
+	      *d++ = *s++;
+	      n--;
+	    }
+	  while (n >= sizeof (unsigned long))
+	    {
+	      *(VOLATILE_CLANG unsigned long *) d = *(const unsigned long *) s;
+	      d += sizeof (unsigned long);
+	      s += sizeof (unsigned long);
+	      n -= sizeof (unsigned long);
+	    }
+	}
+      while (n--)
+	*d++ = *s++;
+    }
   else
     {
       d += n;
       s += n;
 
+      if (n >= 3 * sizeof (unsigned long)
+	  && (((grub_addr_t) d ^ (grub_addr_t) s)
+	      & (sizeof (unsigned long) - 1)) == 0)
+	{
+	  while (((grub_addr_t) d & (sizeof (unsigned long) - 1)) != 0)
+	    {
+	      *--d = *--s;
+	      n--;
+	    }
+	  while (n >= sizeof (unsigned long))
+	    {
+	      d -= sizeof (unsigned long);
+	      s -= sizeof (unsigned long);
+	      n -= sizeof (unsigned long);
+	      *(VOLATILE_CLANG unsigned long *) d = *(const unsigned long *) s;
+	    }
+	}
       while (n--)
 	*--d = *--s;
     }
@@ -547,12 +592,6 @@ grub_strndup (const char *s, grub_size_t n)
 /* clang detects that we're implementing here a memset so it decides to
    optimise and calls memset resulting in infinite recursion. With volatile
    we make it not optimise in this way.  */
-#ifdef __clang__
-#define VOLATILE_CLANG volatile
-#else
-#define VOLATILE_CLANG
-#endif
-
 void *
 grub_memset (void *s, int c, grub_size_t len)
 {
@@ -1311,6 +1350,15 @@ grub_fatal (const char *fmt, ...)
 
 struct grub_boot_time *grub_boot_time_head;
 static struct grub_boot_time **boot_time_last = &grub_boot_time_head;
+static int boot_time_level;
+
+void
+grub_boot_time_adjust_level (int delta)
+{
+  boot_time_level += delta;
+  if (boot_time_level < 0)
+    boot_time_level = 0;
+}
 
 void
 grub_real_boot_time (const char *file,
@@ -1331,6 +1379,7 @@ grub_real_boot_time (const char *file,
   n->file = file;
   n->line = line;
   n->tp = grub_get_time_ms ();
+  n->level = boot_time_level;
   n->next = 0;
 
   va_start (args, fmt);
@@ -453,6 +453,47 @@ grub_real_malloc (grub_mm_header_t *first, grub_size_t n, grub_size_t align)
 }
 
 /* Allocate SIZE bytes with the alignment ALIGN and return the pointer.  */
+/*
+ * Fast bins for small objects.  Freed blocks of up to
+ * GRUB_MM_BIN_MAX_UNITS cells are kept on per-size singly linked
+ * lists (threaded through their payload) instead of going back to the
+ * region free ring, and grub_malloc pops them in constant time.  The
+ * blocks stay marked allocated from the region's point of view; under
+ * memory pressure the bins are flushed back to the regions.
+ */
+#define GRUB_MM_BIN_MAX_UNITS	8
+#define GRUB_MM_BIN_MAX_COUNT	128
+
+static grub_mm_header_t grub_mm_bins[GRUB_MM_BIN_MAX_UNITS + 1];
+static unsigned int grub_mm_bin_counts[GRUB_MM_BIN_MAX_UNITS + 1];
+
+static void grub_free_to_region (grub_mm_header_t p, grub_mm_region_t r);
+
+/* Return every binned block to its region.  */
+static void
+grub_mm_bins_flush (void)
+{
+  grub_size_t i;
+
+  for (i = 2; i <= GRUB_MM_BIN_MAX_UNITS; i++)
+    {
+      grub_mm_header_t p = grub_mm_bins[i];
+
+      grub_mm_bins[i] = 0;
+      grub_mm_bin_counts[i] = 0;
+      while (p)
+	{
+	  grub_mm_header_t next = *(grub_mm_header_t *) (p + 1);
+	  grub_mm_header_t q;
+	  grub_mm_region_t r;
+
+	  get_header_from_pointer (p + 1, &q, &r);
+	  grub_free_to_region (q, r);
+	  p = next;
+	}
+    }
+}
+
 void *
 grub_memalign (grub_size_t align, grub_size_t size)
 {
@@ -539,7 +580,8 @@ grub_memalign (grub_size_t align, grub_size_t size)
       /* fallthrough */
 
     case 2:
-      /* Invalidate disk caches.  */
+      /* Flush the small-object bins and invalidate disk caches.  */
+      grub_mm_bins_flush ();
       grub_disk_cache_invalidate_all ();
       count++;
       goto again;
@@ -581,6 +623,17 @@ grub_calloc (grub_size_t nmemb, grub_size_t size)
 void *
 grub_malloc (grub_size_t size)
 {
+  grub_size_t n = ((size + GRUB_MM_ALIGN - 1) >> GRUB_MM_ALIGN_LOG2) + 1;
+
+  if (n <= GRUB_MM_BIN_MAX_UNITS && grub_mm_bins[n])
+    {
+      grub_mm_header_t p = grub_mm_bins[n];
+
+      grub_mm_bins[n] = *(grub_mm_header_t *) (p + 1);
+      grub_mm_bin_counts[n]--;
+      return p + 1;
+    }
+
   return grub_memalign (0, size);
 }
 
@@ -609,6 +662,25 @@ grub_free (void *ptr)
 
   get_header_from_pointer (ptr, &p, &r);
 
+  /* Small blocks go to the fast bins; the header stays intact, so the
+     block is handed out again without touching the free ring.  */
+  if (p->size >= 2 && p->size <= GRUB_MM_BIN_MAX_UNITS
+      && grub_mm_bin_counts[p->size] < GRUB_MM_BIN_MAX_COUNT)
+    {
+      *(grub_mm_header_t *) (p + 1) = grub_mm_bins[p->size];
+      grub_mm_bins[p->size] = p;
+      grub_mm_bin_counts[p->size]++;
+      return;
+    }
+
+  grub_free_to_region (p, r);
+}
+
+/* Insert the block P into the free ring of region R, coalescing with
+   its neighbors.  */
+static void
+grub_free_to_region (grub_mm_header_t p, grub_mm_region_t r)
+{
   if (r->first->magic == GRUB_MM_ALLOC_MAGIC)
     {
       p->magic = GRUB_MM_FREE_MAGIC;
@@ -722,6 +794,73 @@ grub_realloc (void *ptr, grub_size_t size)
   return q;
 }
 
+/* Default chunk size for arenas initialized with chunk_size == 0.  */
+#define GRUB_ARENA_DEF_CHUNK_SIZE	4096
+
+struct grub_arena_chunk
+{
+  struct grub_arena_chunk *next;
+  /* Keeps the payload aligned for any object.  */
+  grub_uint64_t data[];
+};
+
+/* Prepare ARENA for use.  CHUNK_SIZE is the granularity of the
+   underlying grub_malloc calls, or 0 for a sensible default.  */
+void
+grub_arena_init (grub_arena_t arena, grub_size_t chunk_size)
+{
+  arena->chunks = 0;
+  arena->cur = 0;
+  arena->left = 0;
+  arena->chunk_size = chunk_size ? chunk_size : GRUB_ARENA_DEF_CHUNK_SIZE;
+}
+
+/* Allocate SIZE bytes from ARENA.  Individual objects cannot be freed;
+   the whole arena is released at once with grub_arena_release.  */
+void *
+grub_arena_alloc (grub_arena_t arena, grub_size_t size)
+{
+  void *p;
+
+  size = ALIGN_UP (size, sizeof (grub_uint64_t));
+  if (size > arena->left)
+    {
+      struct grub_arena_chunk *c;
+      grub_size_t csize = arena->chunk_size;
+
+      if (csize < size)
+	csize = size;
+      c = grub_malloc (sizeof (*c) + csize);
+      if (! c)
+	return 0;
+      c->next = arena->chunks;
+      arena->chunks = c;
+      arena->cur = (grub_uint8_t *) c->data;
+      arena->left = csize;
+    }
+
+  p = arena->cur;
+  arena->cur += size;
+  arena->left -= size;
+  return p;
+}
+
+/* Free everything ever allocated from ARENA and reset it for reuse.  */
+void
+grub_arena_release (grub_arena_t arena)
+{
+  struct grub_arena_chunk *c, *next;
+
+  for (c = arena->chunks; c; c = next)
+    {
+      next = c->next;
+      grub_free (c);
+    }
+  arena->chunks = 0;
+  arena->cur = 0;
+  arena->left = 0;
+}
+
 #ifdef MM_DEBUG
 int grub_mm_debug = 0;
 
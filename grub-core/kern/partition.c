@@ -86,6 +86,27 @@ probe_iter (grub_disk_t dsk, const grub_partition_t partition, void *data)
   return 1;
 }
 
+/* Helper for grub_partition_cache_free.  */
+static void
+partcache_free_list (struct grub_partition_cache *head)
+{
+  struct grub_partition_cache *next;
+
+  while (head)
+    {
+      next = head->next;
+      grub_free (head);
+      head = next;
+    }
+}
+
+void
+grub_partition_cache_free (struct grub_disk *disk)
+{
+  partcache_free_list (disk->partcache);
+  disk->partcache = NULL;
+}
+
 static grub_partition_t
 grub_partition_map_probe (const grub_partition_map_t partmap,
 			  grub_disk_t disk, int partnum)
@@ -95,6 +116,23 @@ grub_partition_map_probe (const grub_partition_map_t partmap,
     .p = 0
   };
 
+  /* Serve the probe from the cached top-level list when we have one.  */
+  if (disk->partition == NULL && disk->partcache)
+    {
+      struct grub_partition_cache *ent;
+
+      for (ent = disk->partcache; ent; ent = ent->next)
+	if (ent->part.partmap == partmap && ent->part.number == partnum)
+	  {
+	    ctx.p = (grub_partition_t) grub_malloc (sizeof (*ctx.p));
+	    if (! ctx.p)
+	      return 0;
+	    grub_memcpy (ctx.p, &ent->part, sizeof (*ctx.p));
+	    return ctx.p;
+	  }
+      return 0;
+    }
+
   partmap->iterate (disk, probe_iter, &ctx);
   if (grub_errno)
     goto fail;
@@ -219,6 +257,53 @@ part_iterate (grub_disk_t dsk, const grub_partition_t partition, void *data)
   return ctx->ret;
 }
 
+/* Context for partcache_fill_iter.  */
+struct partcache_fill_ctx
+{
+  struct grub_partition_iterate_ctx *inner;
+  struct grub_partition_cache *head;
+  struct grub_partition_cache **tail;
+  int complete;
+};
+
+/* Helper for grub_partition_iterate: record a copy of each top-level
+   partition while forwarding it to part_iterate.  */
+static int
+partcache_fill_iter (grub_disk_t dsk, const grub_partition_t partition,
+		     void *data)
+{
+  struct partcache_fill_ctx *ctx = data;
+
+  if (ctx->complete)
+    {
+      struct grub_partition_cache *ent;
+
+      ent = grub_malloc (sizeof (*ent));
+      if (ent)
+	{
+	  ent->part = *partition;
+	  ent->next = NULL;
+	  *ctx->tail = ent;
+	  ctx->tail = &ent->next;
+	}
+      else
+	{
+	  /* Caching is optional; carry on uncached.  */
+	  grub_errno = GRUB_ERR_NONE;
+	  ctx->complete = 0;
+	}
+    }
+
+  if (part_iterate (dsk, partition, ctx->inner))
+    {
+      /* The hook cut the iteration short; the list is incomplete.  */
+      ctx->complete = 0;
+      return 1;
+    }
+
+  return 0;
+}
+
 int
 grub_partition_iterate (struct grub_disk *disk,
 			grub_partition_iterate_hook_t hook, void *hook_data)
@@ -229,17 +314,46 @@ grub_partition_iterate (struct grub_disk *disk,
     .hook_data = hook_data
   };
   const struct grub_partition_map *partmap;
+  struct partcache_fill_ctx fillctx = {
+    .inner = &ctx,
+    .head = NULL,
+    .tail = &fillctx.head,
+    /* Only the top-level list is worth caching; reads relative to a
+       parent partition would produce a different one.  */
+    .complete = disk->partition == NULL
+  };
+
+  if (disk->partition == NULL && disk->partcache)
+    {
+      struct grub_partition_cache *ent;
+
+      for (ent = disk->partcache; ent; ent = ent->next)
+	if (part_iterate (disk, &ent->part, &ctx))
+	  break;
+      return ctx.ret;
+    }
 
   FOR_PARTITION_MAPS(partmap)
   {
     grub_err_t err;
-    err = partmap->iterate (disk, part_iterate, &ctx);
+    err = partmap->iterate (disk, partcache_fill_iter, &fillctx);
     if (err)
-      grub_errno = GRUB_ERR_NONE;
+      {
+	/* A transient read error would make a replay lie; don't cache
+	   after one.  Maps that simply didn't match are fine.  */
+	if (err != GRUB_ERR_BAD_PART_TABLE)
+	  fillctx.complete = 0;
+	grub_errno = GRUB_ERR_NONE;
+      }
     if (ctx.ret)
       break;
   }
 
+  if (fillctx.complete && fillctx.head)
+    disk->partcache = fillctx.head;
+  else
+    partcache_free_list (fillctx.head);
+
   return ctx.ret;
 }
 
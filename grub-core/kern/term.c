@@ -83,6 +83,59 @@ grub_xputs_dumb (const char *str)
 
 void (*grub_xputs) (const char *str) = grub_xputs_dumb;
 
+static grub_idle_task_t idle_tasks;
+static int in_idle_pump;
+
+void
+grub_idle_task_register (grub_idle_task_t task)
+{
+  grub_idle_task_t *p;
+
+  for (p = &idle_tasks; *p && (*p)->priority >= task->priority;
+       p = &(*p)->next);
+  task->next = *p;
+  *p = task;
+}
+
+void
+grub_idle_task_unregister (grub_idle_task_t task)
+{
+  grub_idle_task_t *p;
+
+  for (p = &idle_tasks; *p; p = &(*p)->next)
+    if (*p == task)
+      {
+	*p = task->next;
+	return;
+      }
+}
+
+/* Run one step of the highest priority pending task.  Called whenever
+   a key poll comes up empty; a task polling for keys itself does not
+   recurse here.  */
+void
+grub_idle_pump (void)
+{
+  grub_idle_task_t task = idle_tasks;
+
+  if (task == NULL || in_idle_pump)
+    return;
+
+  in_idle_pump = 1;
+  if (task->hook (task->data))
+    grub_idle_task_unregister (task);
+  in_idle_pump = 0;
+}
+
+/* Time of the last key returned by grub_getkey_noblock, for pacing the
+   blocking wait loops.  */
+static grub_uint64_t last_key_time;
+
+/* Milliseconds after a key press during which wait loops keep polling
+   back to back, so bursts (escape sequences on serial, fast typing)
+   are picked up with minimal latency.  */
+#define POLL_FAST_WINDOW_MS	10
+
 int
 grub_getkey_noblock (void)
 {
@@ -98,12 +151,32 @@ grub_getkey_noblock (void)
   {
     int key = term->getkey (term);
     if (key != GRUB_TERM_NO_KEY)
-      return key;
+      {
+	last_key_time = grub_get_time_ms ();
+	return key;
+      }
   }
 
+  grub_idle_pump ();
+
   return GRUB_TERM_NO_KEY;
 }
 
+/* Called by wait loops after an empty poll.  Shortly after input
+   activity only yield the CPU, so the next poll happens immediately;
+   once the terminal has been quiet, space the polls a timer tick
+   apart so an idle prompt does not hammer the keyboard controller,
+   the USB stack and the UARTs at full CPU speed.  One tick still
+   drains a 16-byte UART FIFO faster than 115200 baud can fill it.  */
+void
+grub_term_poll_pause (void)
+{
+  if (grub_get_time_ms () - last_key_time < POLL_FAST_WINDOW_MS)
+    grub_cpu_idle ();
+  else
+    grub_millisleep (1);
+}
+
 int
 grub_getkey (void)
 {
@@ -116,7 +189,7 @@ grub_getkey (void)
       ret = grub_getkey_noblock ();
       if (ret != GRUB_TERM_NO_KEY)
 	return ret;
-      grub_cpu_idle ();
+      grub_term_poll_pause ();
     }
 }
 
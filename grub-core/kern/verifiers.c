@@ -26,6 +26,9 @@ GRUB_MOD_LICENSE ("GPLv3+");
 
 struct grub_file_verifier *grub_file_verifiers;
 
+/* Read/hash granularity for verifiers accepting incremental writes.  */
+#define VERIFY_CHUNK_SIZE	(1 << 20)
+
 struct grub_verified
 {
   grub_file_t file;
@@ -83,6 +86,7 @@ grub_verifiers_open (grub_file_t io, enum grub_file_type type)
   void *context;
   grub_file_t ret = 0;
   grub_err_t err;
+  enum grub_verify_flags ver_flags = GRUB_VERIFY_FLAGS_NONE;
   int defer = 0;
 
   grub_dprintf ("verify", "file: %s type: %d\n", io->name, type);
@@ -109,7 +113,10 @@ grub_verifiers_open (grub_file_t io, enum grub_file_type type)
 	  continue;
 	}
       if (!(flags & GRUB_VERIFY_FLAGS_SKIP_VERIFICATION))
-	break;
+	{
+	  ver_flags = flags;
+	  break;
+	}
     }
 
   if (!ver)
@@ -150,17 +157,48 @@ grub_verifiers_open (grub_file_t io, enum grub_file_type type)
     {
       goto fail;
     }
-  if (grub_file_read (io, verified->buf, ret->size) != (grub_ssize_t) ret->size)
+  if (ver_flags & GRUB_VERIFY_FLAGS_SINGLE_CHUNK)
     {
-      if (!grub_errno)
-	grub_error (GRUB_ERR_FILE_READ_ERROR, N_("premature end of file %s"),
-		    io->name);
-      goto fail;
+      if (grub_file_read (io, verified->buf, ret->size)
+	  != (grub_ssize_t) ret->size)
+	{
+	  if (!grub_errno)
+	    grub_error (GRUB_ERR_FILE_READ_ERROR,
+			N_("premature end of file %s"), io->name);
+	  goto fail;
+	}
+
+      err = ver->write (context, verified->buf, ret->size);
+      if (err)
+	goto fail;
     }
+  else
+    {
+      /* The verifier accepts incremental writes: hash each chunk right
+	 after reading it, while the data is still cache-hot, instead of
+	 streaming a large file through memory a second time.  */
+      grub_size_t off;
 
-  err = ver->write (context, verified->buf, ret->size);
-  if (err)
-    goto fail;
+      for (off = 0; off < ret->size; off += VERIFY_CHUNK_SIZE)
+	{
+	  grub_size_t sz = ret->size - off;
+
+	  if (sz > VERIFY_CHUNK_SIZE)
+	    sz = VERIFY_CHUNK_SIZE;
+	  if (grub_file_read (io, (char *) verified->buf + off, sz)
+	      != (grub_ssize_t) sz)
+	    {
+	      if (!grub_errno)
+		grub_error (GRUB_ERR_FILE_READ_ERROR,
+			    N_("premature end of file %s"), io->name);
+	      goto fail;
+	    }
+
+	  err = ver->write (context, (char *) verified->buf + off, sz);
+	  if (err)
+	    goto fail;
+	}
+    }
 
   err = ver->fini ? ver->fini (context) : GRUB_ERR_NONE;
   if (err)
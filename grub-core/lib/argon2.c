@@ -0,0 +1,559 @@
+/* argon2.c - Argon2i/Argon2id key derivation function (RFC 9106) */
+/*
+ *  GRUB  --  GRand Unified Bootloader
+ *  Copyright (C) 2026  Free Software Foundation, Inc.
+ *
+ *  GRUB is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GRUB is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GRUB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <grub/types.h>
+#include <grub/misc.h>
+#include <grub/mm.h>
+#include <grub/crypto.h>
+#include <grub/argon2.h>
+
+#define ARGON2_VERSION			0x13
+#define ARGON2_BLOCK_SIZE		1024
+#define ARGON2_QWORDS_IN_BLOCK		(ARGON2_BLOCK_SIZE / 8)
+#define ARGON2_SYNC_POINTS		4
+#define ARGON2_ADDRESSES_IN_BLOCK	128
+
+#define BLAKE2B_OUTBYTES	64
+#define BLAKE2B_BLOCKBYTES	128
+
+/* Minimal sequential BLAKE2b, no key support: Argon2 needs nothing
+   more and the libgcrypt import carries no BLAKE2.  */
+
+struct blake2b_state
+{
+  grub_uint64_t h[8];
+  grub_uint64_t t;
+  grub_uint8_t buf[BLAKE2B_BLOCKBYTES];
+  grub_size_t buflen;
+};
+
+static const grub_uint64_t blake2b_iv[8] =
+  {
+    0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL,
+    0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+    0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL,
+    0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+  };
+
+static const grub_uint8_t blake2b_sigma[12][16] =
+  {
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 },
+    { 11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4 },
+    {  7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8 },
+    {  9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13 },
+    {  2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9 },
+    { 12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11 },
+    { 13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10 },
+    {  6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5 },
+    { 10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0 },
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 }
+  };
+
+static inline grub_uint64_t
+rotr64 (grub_uint64_t w, unsigned c)
+{
+  return (w >> c) | (w << (64 - c));
+}
+
+static void
+blake2b_compress (struct blake2b_state *S, const grub_uint8_t *block,
+		  grub_uint64_t f0)
+{
+  grub_uint64_t m[16], v[16];
+  unsigned i, r;
+
+  for (i = 0; i < 16; i++)
+    m[i] = grub_le_to_cpu64 (grub_get_unaligned64 (block + i * 8));
+  for (i = 0; i < 8; i++)
+    v[i] = S->h[i];
+  for (i = 0; i < 8; i++)
+    v[i + 8] = blake2b_iv[i];
+  /* Inputs here never reach 2^64 bytes, so the high counter word
+     stays zero.  */
+  v[12] ^= S->t;
+  v[14] ^= f0;
+
+#define G(r, i, a, b, c, d)				\
+  do {							\
+    a = a + b + m[blake2b_sigma[r][2 * i]];		\
+    d = rotr64 (d ^ a, 32);				\
+    c = c + d;						\
+    b = rotr64 (b ^ c, 24);				\
+    a = a + b + m[blake2b_sigma[r][2 * i + 1]];		\
+    d = rotr64 (d ^ a, 16);				\
+    c = c + d;						\
+    b = rotr64 (b ^ c, 63);				\
+  } while (0)
+
+  for (r = 0; r < 12; r++)
+    {
+      G (r, 0, v[0], v[4], v[8], v[12]);
+      G (r, 1, v[1], v[5], v[9], v[13]);
+      G (r, 2, v[2], v[6], v[10], v[14]);
+      G (r, 3, v[3], v[7], v[11], v[15]);
+      G (r, 4, v[0], v[5], v[10], v[15]);
+      G (r, 5, v[1], v[6], v[11], v[12]);
+      G (r, 6, v[2], v[7], v[8], v[13]);
+      G (r, 7, v[3], v[4], v[9], v[14]);
+    }
+#undef G
+
+  for (i = 0; i < 8; i++)
+    S->h[i] ^= v[i] ^ v[i + 8];
+}
+
+static void
+blake2b_init (struct blake2b_state *S, grub_size_t outlen)
+{
+  unsigned i;
+
+  grub_memset (S, 0, sizeof (*S));
+  for (i = 0; i < 8; i++)
+    S->h[i] = blake2b_iv[i];
+  S->h[0] ^= 0x01010000 | outlen;
+}
+
+static void
+blake2b_update (struct blake2b_state *S, const void *in, grub_size_t inlen)
+{
+  const grub_uint8_t *p = in;
+
+  while (inlen > 0)
+    {
+      grub_size_t fill = BLAKE2B_BLOCKBYTES - S->buflen;
+
+      if (inlen > fill)
+	{
+	  grub_memcpy (S->buf + S->buflen, p, fill);
+	  S->t += BLAKE2B_BLOCKBYTES;
+	  blake2b_compress (S, S->buf, 0);
+	  S->buflen = 0;
+	  p += fill;
+	  inlen -= fill;
+	}
+      else
+	{
+	  grub_memcpy (S->buf + S->buflen, p, inlen);
+	  S->buflen += inlen;
+	  break;
+	}
+    }
+}
+
+static void
+blake2b_final (struct blake2b_state *S, grub_uint8_t *out, grub_size_t outlen)
+{
+  grub_size_t i;
+
+  S->t += S->buflen;
+  grub_memset (S->buf + S->buflen, 0, BLAKE2B_BLOCKBYTES - S->buflen);
+  blake2b_compress (S, S->buf, ~(grub_uint64_t) 0);
+  for (i = 0; i < outlen; i++)
+    out[i] = (grub_uint8_t) (S->h[i / 8] >> (8 * (i % 8)));
+}
+
+static void
+blake2b_update_le32 (struct blake2b_state *S, grub_uint32_t val)
+{
+  grub_uint32_t le = grub_cpu_to_le32 (val);
+
+  blake2b_update (S, &le, sizeof (le));
+}
+
+/* The variable-length hash H' from the spec, built on BLAKE2b.  */
+static void
+argon2_hprime (grub_uint8_t *out, grub_size_t outlen,
+	       const grub_uint8_t *in, grub_size_t inlen)
+{
+  struct blake2b_state S;
+  grub_uint8_t v[BLAKE2B_OUTBYTES];
+  grub_size_t done;
+
+  if (outlen <= BLAKE2B_OUTBYTES)
+    {
+      blake2b_init (&S, outlen);
+      blake2b_update_le32 (&S, outlen);
+      blake2b_update (&S, in, inlen);
+      blake2b_final (&S, out, outlen);
+      return;
+    }
+
+  blake2b_init (&S, BLAKE2B_OUTBYTES);
+  blake2b_update_le32 (&S, outlen);
+  blake2b_update (&S, in, inlen);
+  blake2b_final (&S, v, BLAKE2B_OUTBYTES);
+  grub_memcpy (out, v, BLAKE2B_OUTBYTES / 2);
+  done = BLAKE2B_OUTBYTES / 2;
+  while (outlen - done > BLAKE2B_OUTBYTES)
+    {
+      blake2b_init (&S, BLAKE2B_OUTBYTES);
+      blake2b_update (&S, v, BLAKE2B_OUTBYTES);
+      blake2b_final (&S, v, BLAKE2B_OUTBYTES);
+      grub_memcpy (out + done, v, BLAKE2B_OUTBYTES / 2);
+      done += BLAKE2B_OUTBYTES / 2;
+    }
+  blake2b_init (&S, outlen - done);
+  blake2b_update (&S, v, BLAKE2B_OUTBYTES);
+  blake2b_final (&S, out + done, outlen - done);
+}
+
+/* Argon2 memory blocks and the BlaMka compression function G.  */
+
+struct argon2_block
+{
+  grub_uint64_t v[ARGON2_QWORDS_IN_BLOCK];
+};
+
+struct argon2_instance
+{
+  struct argon2_block *memory;
+  grub_uint32_t passes;
+  grub_uint32_t memory_blocks;
+  grub_uint32_t segment_length;
+  grub_uint32_t lane_length;
+  grub_uint32_t lanes;
+  grub_argon2_type_t type;
+};
+
+static void
+load_block (struct argon2_block *dst, const grub_uint8_t *in)
+{
+  unsigned i;
+
+  for (i = 0; i < ARGON2_QWORDS_IN_BLOCK; i++)
+    dst->v[i] = grub_le_to_cpu64 (grub_get_unaligned64 (in + i * 8));
+}
+
+static void
+store_block (grub_uint8_t *out, const struct argon2_block *src)
+{
+  unsigned i;
+
+  for (i = 0; i < ARGON2_QWORDS_IN_BLOCK; i++)
+    grub_set_unaligned64 (out + i * 8, grub_cpu_to_le64 (src->v[i]));
+}
+
+static inline grub_uint64_t
+fblamka (grub_uint64_t x, grub_uint64_t y)
+{
+  grub_uint64_t m = (grub_uint64_t) (grub_uint32_t) x * (grub_uint32_t) y;
+
+  return x + y + 2 * m;
+}
+
+#define BG(a, b, c, d)				\
+  do {						\
+    a = fblamka (a, b);				\
+    d = rotr64 (d ^ a, 32);			\
+    c = fblamka (c, d);				\
+    b = rotr64 (b ^ c, 24);			\
+    a = fblamka (a, b);				\
+    d = rotr64 (d ^ a, 16);			\
+    c = fblamka (c, d);				\
+    b = rotr64 (b ^ c, 63);			\
+  } while (0)
+
+#define BLAKE2_ROUND(v0, v1, v2, v3, v4, v5, v6, v7,		\
+		     v8, v9, v10, v11, v12, v13, v14, v15)	\
+  do {								\
+    BG (v0, v4, v8, v12);					\
+    BG (v1, v5, v9, v13);					\
+    BG (v2, v6, v10, v14);					\
+    BG (v3, v7, v11, v15);					\
+    BG (v0, v5, v10, v15);					\
+    BG (v1, v6, v11, v12);					\
+    BG (v2, v7, v8, v13);					\
+    BG (v3, v4, v9, v14);					\
+  } while (0)
+
+static void
+fill_block (const struct argon2_block *prev, const struct argon2_block *ref,
+	    struct argon2_block *next, int with_xor)
+{
+  struct argon2_block r, tmp;
+  unsigned i;
+
+  for (i = 0; i < ARGON2_QWORDS_IN_BLOCK; i++)
+    r.v[i] = ref->v[i] ^ prev->v[i];
+  tmp = r;
+  if (with_xor)
+    for (i = 0; i < ARGON2_QWORDS_IN_BLOCK; i++)
+      tmp.v[i] ^= next->v[i];
+
+  /* Apply BlaMka rounds to the rows, then to the columns, of the
+     8x8 matrix of 16-byte registers the block forms.  */
+  for (i = 0; i < 8; i++)
+    BLAKE2_ROUND (r.v[16 * i], r.v[16 * i + 1], r.v[16 * i + 2],
+		  r.v[16 * i + 3], r.v[16 * i + 4], r.v[16 * i + 5],
+		  r.v[16 * i + 6], r.v[16 * i + 7], r.v[16 * i + 8],
+		  r.v[16 * i + 9], r.v[16 * i + 10], r.v[16 * i + 11],
+		  r.v[16 * i + 12], r.v[16 * i + 13], r.v[16 * i + 14],
+		  r.v[16 * i + 15]);
+
+  for (i = 0; i < 8; i++)
+    BLAKE2_ROUND (r.v[2 * i], r.v[2 * i + 1], r.v[2 * i + 16],
+		  r.v[2 * i + 17], r.v[2 * i + 32], r.v[2 * i + 33],
+		  r.v[2 * i + 48], r.v[2 * i + 49], r.v[2 * i + 64],
+		  r.v[2 * i + 65], r.v[2 * i + 80], r.v[2 * i + 81],
+		  r.v[2 * i + 96], r.v[2 * i + 97], r.v[2 * i + 112],
+		  r.v[2 * i + 113]);
+
+  for (i = 0; i < ARGON2_QWORDS_IN_BLOCK; i++)
+    next->v[i] = r.v[i] ^ tmp.v[i];
+}
+
+static grub_uint32_t
+index_alpha (const struct argon2_instance *inst, grub_uint32_t pass,
+	     grub_uint32_t slice, grub_uint32_t index,
+	     grub_uint32_t pseudo_rand, int same_lane)
+{
+  grub_uint32_t reference_area_size, start_position;
+  grub_uint64_t relative_position;
+
+  if (pass == 0)
+    {
+      if (slice == 0)
+	reference_area_size = index - 1;
+      else if (same_lane)
+	reference_area_size = slice * inst->segment_length + index - 1;
+      else
+	reference_area_size = slice * inst->segment_length
+	  + ((index == 0) ? -1 : 0);
+    }
+  else
+    {
+      if (same_lane)
+	reference_area_size = inst->lane_length - inst->segment_length
+	  + index - 1;
+      else
+	reference_area_size = inst->lane_length - inst->segment_length
+	  + ((index == 0) ? -1 : 0);
+    }
+
+  relative_position = pseudo_rand;
+  relative_position = (relative_position * relative_position) >> 32;
+  relative_position = reference_area_size - 1
+    - (((grub_uint64_t) reference_area_size * relative_position) >> 32);
+
+  start_position = 0;
+  if (pass != 0)
+    start_position = (slice == ARGON2_SYNC_POINTS - 1)
+      ? 0 : (slice + 1) * inst->segment_length;
+
+  return ((grub_uint32_t) (start_position + relative_position))
+    % inst->lane_length;
+}
+
+static void
+fill_segment (const struct argon2_instance *inst, grub_uint32_t pass,
+	      grub_uint32_t lane, grub_uint32_t slice,
+	      struct argon2_block *scratch)
+{
+  /* SCRATCH holds three blocks: address, input, zero.  They only
+     matter for data-independent addressing but are caller-provided to
+     keep them off the stack.  */
+  struct argon2_block *address_block = scratch;
+  struct argon2_block *input_block = scratch + 1;
+  struct argon2_block *zero_block = scratch + 2;
+  int data_independent;
+  grub_uint32_t starting_index = 0;
+  grub_uint32_t i, curr_offset, prev_offset;
+
+  data_independent = (inst->type == GRUB_ARGON2I)
+    || (inst->type == GRUB_ARGON2ID && pass == 0
+	&& slice < ARGON2_SYNC_POINTS / 2);
+
+  if (data_independent)
+    {
+      grub_memset (zero_block, 0, sizeof (*zero_block));
+      grub_memset (input_block, 0, sizeof (*input_block));
+      input_block->v[0] = pass;
+      input_block->v[1] = lane;
+      input_block->v[2] = slice;
+      input_block->v[3] = inst->memory_blocks;
+      input_block->v[4] = inst->passes;
+      input_block->v[5] = inst->type;
+    }
+
+  if (pass == 0 && slice == 0)
+    {
+      starting_index = 2;	/* The first two blocks are from H'.  */
+      /* The loop below only regenerates addresses at multiples of
+	 128, so produce the first batch here.  */
+      if (data_independent)
+	{
+	  input_block->v[6]++;
+	  fill_block (zero_block, input_block, address_block, 0);
+	  fill_block (zero_block, address_block, address_block, 0);
+	}
+    }
+
+  curr_offset = lane * inst->lane_length + slice * inst->segment_length
+    + starting_index;
+
+  for (i = starting_index; i < inst->segment_length; i++, curr_offset++)
+    {
+      grub_uint64_t pseudo_rand;
+      grub_uint32_t ref_lane, ref_index;
+      int same_lane;
+
+      if (curr_offset % inst->lane_length == 0)
+	prev_offset = curr_offset + inst->lane_length - 1;
+      else
+	prev_offset = curr_offset - 1;
+
+      if (data_independent)
+	{
+	  if (i % ARGON2_ADDRESSES_IN_BLOCK == 0)
+	    {
+	      input_block->v[6]++;
+	      fill_block (zero_block, input_block, address_block, 0);
+	      fill_block (zero_block, address_block, address_block, 0);
+	    }
+	  pseudo_rand = address_block->v[i % ARGON2_ADDRESSES_IN_BLOCK];
+	}
+      else
+	pseudo_rand = inst->memory[prev_offset].v[0];
+
+      ref_lane = (grub_uint32_t) (pseudo_rand >> 32) % inst->lanes;
+      if (pass == 0 && slice == 0)
+	ref_lane = lane;
+      same_lane = (ref_lane == lane);
+
+      ref_index = index_alpha (inst, pass, slice, i,
+			       (grub_uint32_t) pseudo_rand, same_lane);
+
+      fill_block (&inst->memory[prev_offset],
+		  &inst->memory[ref_lane * inst->lane_length + ref_index],
+		  &inst->memory[curr_offset], pass != 0);
+    }
+}
+
+gcry_err_code_t
+grub_argon2 (grub_argon2_type_t type, grub_uint32_t t_cost,
+	     grub_uint32_t m_cost, grub_uint32_t lanes,
+	     const grub_uint8_t *pwd, grub_size_t pwdlen,
+	     const grub_uint8_t *salt, grub_size_t saltlen,
+	     grub_uint8_t *out, grub_size_t outlen)
+{
+  struct argon2_instance inst;
+  struct argon2_block *scratch;
+  struct blake2b_state S;
+  grub_uint8_t h0[BLAKE2B_OUTBYTES + 8];
+  grub_uint8_t blockbytes[ARGON2_BLOCK_SIZE];
+  grub_uint32_t memory_blocks, pass, slice, lane;
+
+  if (type != GRUB_ARGON2I && type != GRUB_ARGON2ID)
+    return GPG_ERR_INV_ARG;
+  if (t_cost == 0 || lanes == 0 || outlen < 4 || pwdlen > 0xffffffffUL
+      || saltlen < 8 || saltlen > 0xffffffffUL || outlen > 0xffffffffUL)
+    return GPG_ERR_INV_ARG;
+
+  memory_blocks = m_cost;
+  if (memory_blocks < 2 * ARGON2_SYNC_POINTS * lanes)
+    memory_blocks = 2 * ARGON2_SYNC_POINTS * lanes;
+
+  inst.segment_length = memory_blocks / (lanes * ARGON2_SYNC_POINTS);
+  inst.memory_blocks = inst.segment_length * lanes * ARGON2_SYNC_POINTS;
+  inst.lane_length = inst.segment_length * ARGON2_SYNC_POINTS;
+  inst.lanes = lanes;
+  inst.passes = t_cost;
+  inst.type = type;
+
+  inst.memory = grub_malloc ((grub_size_t) inst.memory_blocks
+			     * sizeof (struct argon2_block));
+  if (!inst.memory)
+    return GPG_ERR_OUT_OF_MEMORY;
+  scratch = grub_malloc (3 * sizeof (struct argon2_block));
+  if (!scratch)
+    {
+      grub_free (inst.memory);
+      return GPG_ERR_OUT_OF_MEMORY;
+    }
+
+  /* H0 binds all parameters and the password.  Secret and associated
+     data, which LUKS2 does not use, are empty.  */
+  blake2b_init (&S, BLAKE2B_OUTBYTES);
+  blake2b_update_le32 (&S, lanes);
+  blake2b_update_le32 (&S, outlen);
+  blake2b_update_le32 (&S, m_cost);
+  blake2b_update_le32 (&S, t_cost);
+  blake2b_update_le32 (&S, ARGON2_VERSION);
+  blake2b_update_le32 (&S, type);
+  blake2b_update_le32 (&S, pwdlen);
+  blake2b_update (&S, pwd, pwdlen);
+  blake2b_update_le32 (&S, saltlen);
+  blake2b_update (&S, salt, saltlen);
+  blake2b_update_le32 (&S, 0);	/* Secret.  */
+  blake2b_update_le32 (&S, 0);	/* Associated data.  */
+  blake2b_final (&S, h0, BLAKE2B_OUTBYTES);
+
+  /* The first two blocks of every lane come straight from H0.  */
+  for (lane = 0; lane < lanes; lane++)
+    {
+      grub_uint32_t i;
+
+      for (i = 0; i < 2; i++)
+	{
+	  grub_set_unaligned32 (h0 + BLAKE2B_OUTBYTES,
+				grub_cpu_to_le32 (i));
+	  grub_set_unaligned32 (h0 + BLAKE2B_OUTBYTES + 4,
+				grub_cpu_to_le32 (lane));
+	  argon2_hprime (blockbytes, ARGON2_BLOCK_SIZE, h0, sizeof (h0));
+	  load_block (&inst.memory[lane * inst.lane_length + i],
+		      blockbytes);
+	}
+    }
+
+  /* Lanes within a slice have no data dependencies on each other, so
+     filling them one after another gives the multi-lane result.  */
+  for (pass = 0; pass < t_cost; pass++)
+    for (slice = 0; slice < ARGON2_SYNC_POINTS; slice++)
+      for (lane = 0; lane < lanes; lane++)
+	fill_segment (&inst, pass, lane, slice, scratch);
+
+  /* XOR the last block of every lane and hash the result.  */
+  {
+    struct argon2_block final_block;
+    grub_uint32_t i;
+
+    final_block = inst.memory[inst.lane_length - 1];
+    for (lane = 1; lane < lanes; lane++)
+      for (i = 0; i < ARGON2_QWORDS_IN_BLOCK; i++)
+	final_block.v[i]
+	  ^= inst.memory[lane * inst.lane_length
+			 + inst.lane_length - 1].v[i];
+    store_block (blockbytes, &final_block);
+    argon2_hprime (out, outlen, blockbytes, ARGON2_BLOCK_SIZE);
+    grub_memset (&final_block, 0, sizeof (final_block));
+  }
+
+  grub_memset (h0, 0, sizeof (h0));
+  grub_memset (blockbytes, 0, sizeof (blockbytes));
+  grub_memset (inst.memory, 0,
+	       (grub_size_t) inst.memory_blocks
+	       * sizeof (struct argon2_block));
+  grub_free (inst.memory);
+  grub_memset (scratch, 0, 3 * sizeof (struct argon2_block));
+  grub_free (scratch);
+
+  return GPG_ERR_NO_ERROR;
+}
@@ -34,15 +34,12 @@ static void
 grub_disk_cache_invalidate (unsigned long dev_id, unsigned long disk_id,
 			    grub_disk_addr_t sector)
 {
-  unsigned cache_index;
   struct grub_disk_cache *cache;
 
   sector &= ~((grub_disk_addr_t) GRUB_DISK_CACHE_SIZE - 1);
-  cache_index = grub_disk_cache_get_index (dev_id, disk_id, sector);
-  cache = grub_disk_cache_table + cache_index;
+  cache = grub_disk_cache_find (dev_id, disk_id, sector, 0);
 
-  if (cache->dev_id == dev_id && cache->disk_id == disk_id
-      && cache->sector == sector && cache->data)
+  if (cache)
     {
       cache->lock = 1;
       grub_free (cache->data);
@@ -51,6 +48,75 @@ grub_disk_cache_invalidate (unsigned long dev_id, unsigned long disk_id,
     }
 }
 
+/* One-sector write-combining buffer, activated by grub_disk_write_begin
+   and drained by grub_disk_write_flush.  While active, the
+   read-modify-write cycles of piecewise writes landing in the same
+   device sector (an environment block updated field by field) collapse
+   into a single read and a single program of that sector.  Until the
+   flush, reads of the pending sector return the on-disk contents.  */
+static struct
+{
+  grub_disk_t disk;
+  grub_disk_addr_t sector;
+  char *data;
+  int active;
+  int loaded;
+} wc;
+
+static grub_err_t
+grub_disk_write_sector (grub_disk_t disk, grub_disk_addr_t sector,
+			const char *data)
+{
+  grub_disk_cache_invalidate (disk->dev->id, disk->id, sector);
+  return (disk->dev->disk_write) (disk, transform_sector (disk, sector),
+				  1, data);
+}
+
+static grub_err_t
+grub_disk_wc_drain (void)
+{
+  grub_err_t err = GRUB_ERR_NONE;
+
+  if (wc.loaded)
+    err = grub_disk_write_sector (wc.disk, wc.sector, wc.data);
+  wc.loaded = 0;
+  return err;
+}
+
+void
+grub_disk_write_begin (grub_disk_t disk)
+{
+  if (wc.active)
+    grub_disk_write_flush (wc.disk);
+
+  wc.data = grub_malloc (1U << disk->log_sector_size);
+  if (!wc.data)
+    {
+      /* Writes still work, just without combining.  */
+      grub_errno = GRUB_ERR_NONE;
+      return;
+    }
+  wc.active = 1;
+  wc.disk = disk;
+  wc.loaded = 0;
+}
+
+grub_err_t
+grub_disk_write_flush (grub_disk_t disk)
+{
+  grub_err_t err;
+
+  if (!wc.active || wc.disk != disk)
+    return GRUB_ERR_NONE;
+
+  err = grub_disk_wc_drain ();
+  wc.active = 0;
+  wc.disk = NULL;
+  grub_free (wc.data);
+  wc.data = NULL;
+  return err;
+}
+
 grub_err_t
 grub_disk_write (grub_disk_t disk, grub_disk_addr_t sector,
 		 grub_off_t offset, grub_size_t size, const void *buf)
@@ -60,6 +126,9 @@ grub_disk_write (grub_disk_t disk, grub_disk_addr_t sector,
 
   grub_dprintf ("disk", "Writing `%s'...\n", disk->name);
 
+  /* The write may touch the partition table.  */
+  grub_partition_cache_free (disk);
+
   if (grub_disk_adjust_range (disk, &sector, &offset, size) != GRUB_ERR_NONE)
     return -1;
 
@@ -77,6 +146,43 @@ grub_disk_write (grub_disk_t disk, grub_disk_addr_t sector,
 	  grub_size_t len;
 	  grub_partition_t part;
 
+	  if (wc.active && wc.disk == disk)
+	    {
+	      /* Accumulate into the combining buffer; the sector is
+		 programmed once, at the flush or when the next piece
+		 moves to a different sector.  */
+	      if (!(wc.loaded && wc.sector == sector))
+		{
+		  if (grub_disk_wc_drain () != GRUB_ERR_NONE)
+		    goto finish;
+
+		  part = disk->partition;
+		  disk->partition = 0;
+		  if (grub_disk_read (disk, sector, 0,
+				      (1U << disk->log_sector_size), wc.data)
+		      != GRUB_ERR_NONE)
+		    {
+		      disk->partition = part;
+		      goto finish;
+		    }
+		  disk->partition = part;
+		  wc.sector = sector;
+		  wc.loaded = 1;
+		}
+
+	      len = (1U << disk->log_sector_size) - real_offset;
+	      if (len > size)
+		len = size;
+	      grub_memcpy (wc.data + real_offset, buf, len);
+
+	      sector += (1U << (disk->log_sector_size
+				- GRUB_DISK_SECTOR_BITS));
+	      buf = (const char *) buf + len;
+	      size -= len;
+	      real_offset = 0;
+	      continue;
+	    }
+
 	  tmp_buf = grub_malloc (1U << disk->log_sector_size);
 	  if (!tmp_buf)
 	    return grub_errno;
@@ -120,6 +226,11 @@ grub_disk_write (grub_disk_t disk, grub_disk_addr_t sector,
 	  grub_size_t len;
 	  grub_size_t n;
 
+	  /* Keep ordering with any pending combined sector.  */
+	  if (wc.active && wc.disk == disk
+	      && grub_disk_wc_drain () != GRUB_ERR_NONE)
+	    goto finish;
+
 	  len = size & ~((1ULL << disk->log_sector_size) - 1);
 	  n = size >> disk->log_sector_size;
 
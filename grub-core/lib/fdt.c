@@ -48,6 +48,196 @@
   }	\
   token = (grub_uint32_t *) ALIGN_UP((grub_addr_t) (name), sizeof(*token))
 
+/* Lazily built index of one tree, mapping (parent offset, name hash) to
+   node offsets, so that lookups and sibling iteration cost a scan of a
+   compact array instead of a token walk over whole subtrees.  The
+   entries are stored in token order, hence the first match is also the
+   first node in the tree.  Any mutation of the indexed tree drops the
+   index; a checksum of the structure block guards against a different
+   tree appearing at a recycled address.  */
+struct fdt_index_entry
+{
+  grub_uint32_t parent;
+  grub_uint32_t hash;
+  grub_uint32_t offset;
+};
+
+#define FDT_INDEX_SUM_WORDS	16
+#define FDT_INDEX_MAX_DEPTH	32
+#define FDT_INDEX_ROOT_PARENT	0xffffffff
+
+static struct
+{
+  const void *fdt;
+  grub_uint32_t size_dt_struct;
+  grub_uint32_t totalsize;
+  grub_uint32_t sum;
+  struct fdt_index_entry *entries;
+  unsigned int nentries;
+  unsigned int nalloc;
+  /* Nonzero if indexing FDT failed; lookups fall back to token walks
+     without retrying the build on every call.  */
+  int dead;
+} node_index;
+
+static grub_uint32_t
+fdt_name_hash (const char *name)
+{
+  grub_uint32_t hash = 5381;
+
+  while (*name)
+    hash = hash * 33 + (grub_uint8_t) *name++;
+  return hash;
+}
+
+static grub_uint32_t
+fdt_struct_sum (const void *fdt)
+{
+  const grub_uint32_t *w = (const void *) ((grub_addr_t) fdt
+					   + grub_fdt_get_off_dt_struct (fdt));
+  grub_uint32_t sum = 0;
+  unsigned int i, n;
+
+  n = grub_fdt_get_size_dt_struct (fdt) / sizeof (*w);
+  if (n > FDT_INDEX_SUM_WORDS)
+    n = FDT_INDEX_SUM_WORDS;
+  for (i = 0; i < n; i++)
+    sum = sum * 33 + w[i];
+  return sum;
+}
+
+static void
+fdt_index_reset (void)
+{
+  grub_free (node_index.entries);
+  grub_memset (&node_index, 0, sizeof (node_index));
+}
+
+static void
+fdt_index_invalidate (const void *fdt)
+{
+  if (node_index.fdt == fdt)
+    fdt_index_reset ();
+}
+
+static int
+fdt_index_matches (const void *fdt)
+{
+  return (node_index.fdt == fdt
+	  && node_index.size_dt_struct == grub_fdt_get_size_dt_struct (fdt)
+	  && node_index.totalsize == grub_fdt_get_totalsize (fdt)
+	  && node_index.sum == fdt_struct_sum (fdt));
+}
+
+/* Walk the whole structure block once and record every node.  On any
+   failure the index is marked dead for this tree and lookups keep using
+   the token walks.  */
+static void
+fdt_index_build (const void *fdt)
+{
+  const grub_uint32_t *start = (const void *) ((grub_addr_t) fdt
+					       + grub_fdt_get_off_dt_struct (fdt));
+  const grub_uint32_t *end = (const void *) struct_end (fdt);
+  const grub_uint32_t *token = start;
+  grub_uint32_t parents[FDT_INDEX_MAX_DEPTH];
+  unsigned int depth = 0;
+  char *name;
+
+  fdt_index_reset ();
+  node_index.fdt = fdt;
+  node_index.size_dt_struct = grub_fdt_get_size_dt_struct (fdt);
+  node_index.totalsize = grub_fdt_get_totalsize (fdt);
+  node_index.sum = fdt_struct_sum (fdt);
+
+  while (token < end)
+    {
+      switch (grub_be_to_cpu32 (*token))
+	{
+	case FDT_BEGIN_NODE:
+	  {
+	    struct fdt_index_entry *ent;
+	    grub_uint32_t offset = (grub_addr_t) token - (grub_addr_t) start;
+
+	    if (depth >= FDT_INDEX_MAX_DEPTH)
+	      goto fail;
+	    if (node_index.nentries == node_index.nalloc)
+	      {
+		unsigned int nalloc = node_index.nalloc ? 2 * node_index.nalloc
+		  : 32;
+		ent = grub_realloc (node_index.entries,
+				    nalloc * sizeof (*ent));
+		if (!ent)
+		  {
+		    grub_errno = GRUB_ERR_NONE;
+		    goto fail;
+		  }
+		node_index.entries = ent;
+		node_index.nalloc = nalloc;
+	      }
+	    ent = &node_index.entries[node_index.nentries++];
+	    ent->parent = depth ? parents[depth - 1] : FDT_INDEX_ROOT_PARENT;
+	    ent->offset = offset;
+	    ent->hash = fdt_name_hash ((const char *) (token + 1));
+	    parents[depth++] = offset;
+	    SKIP_NODE_NAME (name, token, end);
+	  }
+	  break;
+	case FDT_END_NODE:
+	  if (!depth)
+	    goto fail;
+	  depth--;
+	  token++;
+	  break;
+	case FDT_PROP:
+	  if (token >= end - 1)
+	    goto fail;
+	  token += grub_fdt_prop_entry_size (grub_be_to_cpu32 (*(token + 1)))
+	    / sizeof (*token);
+	  break;
+	case FDT_NOP:
+	  token++;
+	  break;
+	case FDT_END:
+	  if (depth)
+	    goto fail;
+	  return;
+	default:
+	  goto fail;
+	}
+    }
+  if (depth)
+    goto fail;
+  return;
+
+fail:
+  grub_free (node_index.entries);
+  node_index.entries = NULL;
+  node_index.nentries = node_index.nalloc = 0;
+  node_index.dead = 1;
+}
+
+/* Return nonzero if the index serves FDT, building it on first use.  */
+static int
+fdt_index_usable (const void *fdt)
+{
+  if (!fdt_index_matches (fdt))
+    fdt_index_build (fdt);
+  return !node_index.dead;
+}
+
+/* Position of PARENTOFFSET's entry in the index, or the number of
+   entries if the offset does not name an indexed node.  */
+static unsigned int
+fdt_index_find (grub_uint32_t parentoffset)
+{
+  unsigned int i;
+
+  for (i = 0; i < node_index.nentries; i++)
+    if (node_index.entries[i].offset == parentoffset)
+      break;
+  return i;
+}
+
 
 static grub_uint32_t *get_next_node (const void *fdt, char *node_name)
 {
@@ -328,6 +518,21 @@ advance_token (const void *fdt, const grub_uint32_t *token, const grub_uint32_t
 int grub_fdt_next_node (const void *fdt, unsigned int currentoffset)
 {
   const grub_uint32_t *token = (const grub_uint32_t *) fdt + (currentoffset + grub_fdt_get_off_dt_struct (fdt)) / 4;
+  if (fdt_index_usable (fdt))
+    {
+      unsigned int i = fdt_index_find (currentoffset);
+
+      if (i < node_index.nentries)
+	{
+	  grub_uint32_t parent = node_index.entries[i].parent;
+
+	  for (i++; i < node_index.nentries; i++)
+	    if (node_index.entries[i].parent == parent)
+	      return node_index.entries[i].offset;
+	  return -1;
+	}
+      /* Not a node offset; let the token walk decide.  */
+    }
   token = advance_token (fdt, token, (const void *) struct_end (fdt), 1);
   if (!token)
     return -1;
@@ -347,6 +552,15 @@ int grub_fdt_first_node (const void *fdt, unsigned int parentoffset)
   end = (const void *) struct_end (fdt);
   if ((token >= end) || (grub_be_to_cpu32(*token) != FDT_BEGIN_NODE))
     return -1;
+  if (fdt_index_usable (fdt))
+    {
+      unsigned int i = fdt_index_find (parentoffset);
+
+      for (i++; i < node_index.nentries; i++)
+	if (node_index.entries[i].parent == (grub_uint32_t) parentoffset)
+	  return node_index.entries[i].offset;
+      return -1;
+    }
   SKIP_NODE_NAME(node_name, token, end);
   token = advance_token (fdt, token, end, 0);
   if (!token)
@@ -370,6 +584,20 @@ int grub_fdt_find_subnode (const void *fdt, unsigned int parentoffset,
   end = (const void *) struct_end (fdt);
   if ((token >= end) || (grub_be_to_cpu32(*token) != FDT_BEGIN_NODE))
     return -1;
+  if (fdt_index_usable (fdt))
+    {
+      grub_uint32_t hash = fdt_name_hash (name);
+      unsigned int i;
+
+      for (i = 0; i < node_index.nentries; i++)
+	if (node_index.entries[i].parent == (grub_uint32_t) parentoffset
+	    && node_index.entries[i].hash == hash
+	    && grub_strcmp (grub_fdt_get_nodename (fdt,
+						   node_index.entries[i].offset),
+			    name) == 0)
+	  return node_index.entries[i].offset;
+      return -1;
+    }
   SKIP_NODE_NAME(node_name, token, end);
   while (1) {
     token = advance_token (fdt, token, end, skip_current);
@@ -394,6 +622,8 @@ int grub_fdt_add_subnode (void *fdt, unsigned int parentoffset,
 {
   unsigned int entry_size = node_entry_size(name);
 
+  fdt_index_invalidate (fdt);
+
   if ((parentoffset & 0x3) || (get_free_space (fdt) < entry_size))
     return -1;
 
@@ -430,6 +660,7 @@ int grub_fdt_set_prop (void *fdt, unsigned int nodeoffset, const char *name,
   int prop_name_present = 0;
   grub_uint32_t nameoff = 0;
 
+  fdt_index_invalidate (fdt);
   if ((nodeoffset >= grub_fdt_get_size_dt_struct (fdt)) || (nodeoffset & 0x3)
       || (grub_be_to_cpu32(*(grub_uint32_t *) ((grub_addr_t) fdt
                            + grub_fdt_get_off_dt_struct (fdt) + nodeoffset))
@@ -507,6 +738,8 @@ grub_fdt_create_empty_tree (void *fdt, unsigned int size)
   if (size < GRUB_FDT_EMPTY_TREE_SZ)
     return -1;
 
+  fdt_index_invalidate (fdt);
+
   grub_memset (fdt, 0, size);
   et = fdt;
 
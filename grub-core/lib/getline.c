@@ -37,46 +37,61 @@
 char *
 grub_file_getline (grub_file_t file)
 {
-  char c;
+  char chunk[128];
   grub_size_t pos = 0;
   char *cmdline;
   int have_newline = 0;
   grub_size_t max_len = 64;
+  int seekable = !file->not_easily_seekable;
 
   /* Initially locate some space.  */
   cmdline = grub_malloc (max_len);
   if (! cmdline)
     return 0;
 
-  while (1)
+  while (! have_newline)
     {
-      if (grub_file_read (file, &c, 1) != 1)
+      grub_ssize_t got, i;
+
+      /* Reading byte by byte costs one pass through the whole file
+	 layer per character; on seekable files take a chunk and give
+	 back whatever lies past the newline instead.  */
+      got = grub_file_read (file, chunk, seekable ? sizeof (chunk) : 1);
+      if (got <= 0)
 	break;
 
-      /* Skip all carriage returns.  */
-      if (c == '\r')
-	continue;
+      for (i = 0; i < got; i++)
+	{
+	  char c = chunk[i];
 
+	  /* Skip all carriage returns.  */
+	  if (c == '\r')
+	    continue;
 
-      if (pos + 1 >= max_len)
-	{
-	  char *old_cmdline = cmdline;
-	  max_len = max_len * 2;
-	  cmdline = grub_realloc (cmdline, max_len);
-	  if (! cmdline)
+	  if (c == '\n')
 	    {
-	      grub_free (old_cmdline);
-	      return 0;
+	      have_newline = 1;
+	      i++;
+	      break;
 	    }
-	}
 
-      if (c == '\n')
-	{
-	  have_newline = 1;
-	  break;
+	  if (pos + 1 >= max_len)
+	    {
+	      char *old_cmdline = cmdline;
+	      max_len = max_len * 2;
+	      cmdline = grub_realloc (cmdline, max_len);
+	      if (! cmdline)
+		{
+		  grub_free (old_cmdline);
+		  return 0;
+		}
+	    }
+
+	  cmdline[pos++] = c;
 	}
 
-      cmdline[pos++] = c;
+      if (i < got)
+	grub_file_seek (file, grub_file_tell (file) - (got - i));
     }
 
   cmdline[pos] = '\0';
@@ -32,6 +32,28 @@ GRUB_MOD_LICENSE ("GPLv2+");
    must have room for at least DKLEN octets.  The output buffer will
    be filled with the derived data.  */
 
+/* One HMAC computation from precomputed pad states: ICTX and OCTX
+   already hold the digest state after the inner and outer key pads,
+   so only the message and digest blocks remain to be compressed.
+   TCTX is scratch of md->contextsize bytes.  */
+static void
+hmac_from_states (const struct gcry_md_spec *md, const void *ictx,
+		  const void *octx, void *tctx,
+		  const void *data, grub_size_t datalen, grub_uint8_t *out)
+{
+  grub_uint8_t dig[GRUB_CRYPTO_MAX_MDLEN];
+
+  grub_memcpy (tctx, ictx, md->contextsize);
+  md->write (tctx, data, datalen);
+  md->final (tctx);
+  grub_memcpy (dig, md->read (tctx), md->mdlen);
+
+  grub_memcpy (tctx, octx, md->contextsize);
+  md->write (tctx, dig, md->mdlen);
+  md->final (tctx);
+  grub_memcpy (out, md->read (tctx), md->mdlen);
+}
+
 gcry_err_code_t
 grub_crypto_pbkdf2 (const struct gcry_md_spec *md,
 		    const grub_uint8_t *P, grub_size_t Plen,
@@ -42,18 +64,24 @@ grub_crypto_pbkdf2 (const struct gcry_md_spec *md,
   unsigned int hLen = md->mdlen;
   grub_uint8_t U[GRUB_CRYPTO_MAX_MDLEN];
   grub_uint8_t T[GRUB_CRYPTO_MAX_MDLEN];
+  grub_uint8_t helpkey[GRUB_CRYPTO_MAX_MDLEN];
   unsigned int u;
   unsigned int l;
   unsigned int r;
   unsigned int i;
   unsigned int k;
-  gcry_err_code_t rc;
+  gcry_err_code_t rc = GPG_ERR_NO_ERROR;
   grub_uint8_t *tmp;
+  grub_uint8_t *pad = NULL;
+  void *ictx = NULL, *octx = NULL, *tctx = NULL;
   grub_size_t tmplen = Slen + 4;
 
   if (md->mdlen > GRUB_CRYPTO_MAX_MDLEN || md->mdlen == 0)
     return GPG_ERR_INV_ARG;
 
+  if (md->mdlen > md->blocksize)
+    return GPG_ERR_INV_ARG;
+
   if (c == 0)
     return GPG_ERR_INV_ARG;
 
@@ -72,6 +100,40 @@ grub_crypto_pbkdf2 (const struct gcry_md_spec *md,
 
   grub_memcpy (tmp, S, Slen);
 
+  /* The password is the same for every HMAC, so absorb the key pads
+     once and run each iteration from copies of the two states.  This
+     leaves two message compressions per iteration instead of four,
+     and no setup work.  */
+  pad = grub_zalloc (md->blocksize);
+  ictx = grub_malloc (md->contextsize);
+  octx = grub_malloc (md->contextsize);
+  tctx = grub_malloc (md->contextsize);
+  if (pad == NULL || ictx == NULL || octx == NULL || tctx == NULL)
+    {
+      rc = GPG_ERR_OUT_OF_MEMORY;
+      goto out;
+    }
+
+  if (Plen > md->blocksize)
+    {
+      grub_crypto_hash (md, helpkey, P, Plen);
+      P = helpkey;
+      Plen = md->mdlen;
+    }
+
+  grub_memcpy (pad, P, Plen);
+  for (k = 0; k < md->blocksize; k++)
+    pad[k] ^= 0x36;
+  md->init (ictx);
+  md->write (ictx, pad, md->blocksize);
+
+  grub_memset (pad, 0, md->blocksize);
+  grub_memcpy (pad, P, Plen);
+  for (k = 0; k < md->blocksize; k++)
+    pad[k] ^= 0x5c;
+  md->init (octx);
+  md->write (octx, pad, md->blocksize);
+
   for (i = 1; i - 1 < l; i++)
     {
       grub_memset (T, 0, hLen);
@@ -85,16 +147,10 @@ grub_crypto_pbkdf2 (const struct gcry_md_spec *md,
 	      tmp[Slen + 2] = (i & 0x0000ff00) >> 8;
 	      tmp[Slen + 3] = (i & 0x000000ff) >> 0;
 
-	      rc = grub_crypto_hmac_buffer (md, P, Plen, tmp, tmplen, U);
+	      hmac_from_states (md, ictx, octx, tctx, tmp, tmplen, U);
 	    }
 	  else
-	    rc = grub_crypto_hmac_buffer (md, P, Plen, U, hLen, U);
-
-	  if (rc != GPG_ERR_NO_ERROR)
-	    {
-	      grub_free (tmp);
-	      return rc;
-	    }
+	    hmac_from_states (md, ictx, octx, tctx, U, hLen, U);
 
 	  for (k = 0; k < hLen; k++)
 	    T[k] ^= U[k];
@@ -103,7 +159,21 @@ grub_crypto_pbkdf2 (const struct gcry_md_spec *md,
       grub_memcpy (DK + (i - 1) * hLen, T, i == l ? r : hLen);
     }
 
+ out:
+  if (pad)
+    grub_memset (pad, 0, md->blocksize);
+  grub_free (pad);
+  if (ictx)
+    grub_memset (ictx, 0, md->contextsize);
+  grub_free (ictx);
+  if (octx)
+    grub_memset (octx, 0, md->contextsize);
+  grub_free (octx);
+  if (tctx)
+    grub_memset (tctx, 0, md->contextsize);
+  grub_free (tctx);
+  grub_memset (helpkey, 0, sizeof (helpkey));
   grub_free (tmp);
 
-  return GPG_ERR_NO_ERROR;
+  return rc;
 }
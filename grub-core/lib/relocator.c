@@ -1597,6 +1597,30 @@ grub_relocator_prepare_relocs (struct grub_relocator *rel, grub_addr_t addr,
     grub_free (to);
   }
 
+  /* Merge chunks that are adjacent in both source and target: they move
+     by the same displacement, so one mover covers them all.  Multiboot
+     loads with many segments and multi-file initrds commonly produce
+     long runs of these, and one large copy is much cheaper than dozens
+     of mover invocations.  */
+  {
+    grub_size_t m = 0;
+
+    for (j = 0; j < nchunks; j++)
+      {
+	if (m != 0
+	    && sorted[m - 1].src + sorted[m - 1].size == sorted[j].src
+	    && sorted[m - 1].target + sorted[m - 1].size == sorted[j].target
+	    && (grub_uint8_t *) sorted[m - 1].srcv + sorted[m - 1].size
+	    == (grub_uint8_t *) sorted[j].srcv)
+	  {
+	    sorted[m - 1].size += sorted[j].size;
+	    continue;
+	  }
+	sorted[m++] = sorted[j];
+      }
+    nchunks = m;
+  }
+
   for (j = 0; j < nchunks; j++)
     {
       grub_dprintf ("relocator", "sorted chunk %p->%p, 0x%lx\n", 
@@ -38,6 +38,8 @@ struct syslinux_menuentry
 {
   struct syslinux_menuentry *next;
   struct syslinux_menuentry *prev;
+  /* Next entry in the same label index chain, in list order.  */
+  struct syslinux_menuentry *labelnext;
   char *label;
   char *extlabel;
   char *kernel_file;
@@ -74,6 +76,11 @@ struct syslinux_menu
   unsigned long timeout;
   struct syslinux_say *say;
   grub_syslinux_flavour_t flavour;
+  /* Hash chains over entry labels, built once after parsing so that
+     print_entry does not rescan the whole entry list per lookup.  NULL
+     means fall back to the linear walk.  */
+  struct syslinux_menuentry **label_index;
+  grub_size_t label_index_size;
 };
 
 struct output_buffer
@@ -124,6 +131,143 @@ print (struct output_buffer *outbuf, const char *str, grub_size_t len)
   return GRUB_ERR_NONE;
 }
 
+/* Contents of configuration files already read during this conversion.
+   Shared INCLUDE fragments are parsed once per inclusion (the directives
+   legitimately apply each time), but hit the disk only once.  The cache
+   lives for one grub_syslinux_config_file call.  */
+struct syslinux_file_cache
+{
+  struct syslinux_file_cache *next;
+  char *filename;
+  char *data;
+  grub_size_t len;
+};
+
+static struct syslinux_file_cache *file_cache;
+
+/* Cursor over a cached file, standing in for a grub_file_t.  */
+struct syslinux_line_reader
+{
+  const char *ptr;
+  const char *end;
+};
+
+static grub_err_t
+file_cache_open (const char *filename, struct syslinux_line_reader *r)
+{
+  struct syslinux_file_cache *ent;
+  grub_file_t file;
+  char *data = NULL;
+  grub_size_t len = 0, alloc = 0;
+
+  for (ent = file_cache; ent; ent = ent->next)
+    if (grub_strcmp (ent->filename, filename) == 0)
+      {
+	r->ptr = ent->data;
+	r->end = ent->data + ent->len;
+	return GRUB_ERR_NONE;
+      }
+
+  file = grub_file_open (filename, GRUB_FILE_TYPE_CONFIG);
+  if (!file)
+    return grub_errno;
+
+  while (1)
+    {
+      grub_ssize_t got;
+
+      if (len == alloc)
+	{
+	  char *ndata;
+	  alloc = alloc ? alloc * 2 : 1024;
+	  ndata = grub_realloc (data, alloc);
+	  if (!ndata)
+	    goto fail;
+	  data = ndata;
+	}
+      got = grub_file_read (file, data + len, alloc - len);
+      if (got < 0)
+	goto fail;
+      if (got == 0)
+	break;
+      len += got;
+    }
+  grub_file_close (file);
+  file = NULL;
+
+  ent = grub_malloc (sizeof (*ent));
+  if (!ent)
+    goto fail;
+  ent->filename = grub_strdup (filename);
+  if (!ent->filename)
+    {
+      grub_free (ent);
+      goto fail;
+    }
+  ent->data = data;
+  ent->len = len;
+  ent->next = file_cache;
+  file_cache = ent;
+
+  r->ptr = data;
+  r->end = data + len;
+  return GRUB_ERR_NONE;
+
+ fail:
+  if (file)
+    grub_file_close (file);
+  grub_free (data);
+  return grub_errno;
+}
+
+static void
+file_cache_free (void)
+{
+  struct syslinux_file_cache *ent, *next;
+
+  for (ent = file_cache; ent; ent = next)
+    {
+      next = ent->next;
+      grub_free (ent->filename);
+      grub_free (ent->data);
+      grub_free (ent);
+    }
+  file_cache = NULL;
+}
+
+/* Same contract as grub_file_getline: a malloc'd line with carriage
+   returns dropped and no trailing newline, or NULL at end of file.  */
+static char *
+file_cache_getline (struct syslinux_line_reader *r)
+{
+  const char *p, *nl;
+  char *line, *out;
+
+  if (r->ptr >= r->end)
+    return NULL;
+
+  for (nl = r->ptr; nl < r->end && *nl != '\n'; nl++);
+
+  line = grub_malloc (nl - r->ptr + 1);
+  if (!line)
+    return NULL;
+  out = line;
+  for (p = r->ptr; p < nl; p++)
+    if (*p != '\r')
+      *out++ = *p;
+  *out = '\0';
+
+  r->ptr = nl < r->end ? nl + 1 : nl;
+
+  if (out == line && nl == r->end)
+    {
+      /* Only carriage returns before end of file; that is no line.  */
+      grub_free (line);
+      return NULL;
+    }
+  return line;
+}
+
 static grub_err_t
 add_comment (struct syslinux_menu *menu, const char *comment, int nl)
 {
@@ -642,7 +786,8 @@ struct
 };
 
 static grub_err_t
-helptext (const char *line, grub_file_t file, struct syslinux_menu *menu)
+helptext (const char *line, struct syslinux_line_reader *r,
+	  struct syslinux_menu *menu)
 {
   char *help;
   char *buf = NULL;
@@ -652,7 +797,7 @@ helptext (const char *line, grub_file_t file, struct syslinux_menu *menu)
   if (!help)
     return grub_errno;
   helplen = grub_strlen (line);
-  while ((grub_free (buf), buf = grub_file_getline (file)))
+  while ((grub_free (buf), buf = file_cache_getline (r)))
     {
       char *ptr;
       grub_size_t needlen;
@@ -692,14 +837,14 @@ helptext (const char *line, grub_file_t file, struct syslinux_menu *menu)
 static grub_err_t
 syslinux_parse_real (struct syslinux_menu *menu)
 {
-  grub_file_t file;
+  struct syslinux_line_reader r;
   char *buf = NULL;
   grub_err_t err = GRUB_ERR_NONE;
 
-  file = grub_file_open (menu->filename, GRUB_FILE_TYPE_CONFIG);
-  if (!file)
-    return grub_errno;
-  while ((grub_free (buf), buf = grub_file_getline (file)))
+  err = file_cache_open (menu->filename, &r);
+  if (err)
+    return err;
+  while ((grub_free (buf), buf = file_cache_getline (&r)))
     {
       const char *ptr1, *ptr2, *ptr3, *ptr4, *ptr5;
       char *end;
@@ -736,7 +881,7 @@ syslinux_parse_real (struct syslinux_menu *menu)
 	      && (sizeof ("help") - 1 == ptr4 - ptr3
 		  && grub_strncasecmp ("help", ptr3, ptr4 - ptr3) == 0))
 	    {
-	      if (helptext (ptr5, file, menu))
+	      if (helptext (ptr5, &r, menu))
 		{
 		  grub_free (buf);
 		  return 1;
@@ -759,7 +904,6 @@ syslinux_parse_real (struct syslinux_menu *menu)
 	}
     }
  fail:
-  grub_file_close (file);
   grub_free (buf);
   return err;
 }
@@ -1376,13 +1520,63 @@ write_entry (struct output_buffer *outbuf,
   return GRUB_ERR_NONE;
 }
 
+/* Labels are matched case-insensitively, so hash them folded.  */
+static grub_uint32_t
+label_hash (const char *label)
+{
+  grub_uint32_t hash = 5381;
+  const char *ptr;
+
+  for (ptr = label; *ptr; ptr++)
+    hash = hash * 33 + (grub_uint8_t) grub_tolower (*ptr);
+  return hash;
+}
+
+static void
+build_label_index (struct syslinux_menu *menu)
+{
+  struct syslinux_menuentry *entry;
+  grub_size_t n = 0, size;
+
+  for (entry = menu->entries; entry; entry = entry->next)
+    n++;
+  if (n == 0)
+    return;
+  for (size = 1; size < 2 * n; size <<= 1);
+
+  menu->label_index = grub_calloc (size, sizeof (menu->label_index[0]));
+  if (!menu->label_index)
+    {
+      /* print_entry falls back to the linear walk.  */
+      grub_errno = GRUB_ERR_NONE;
+      return;
+    }
+  menu->label_index_size = size;
+
+  /* Insert oldest first so each chain ends up in list order.  */
+  for (entry = menu->entries; entry->next; entry = entry->next);
+  for (; entry; entry = entry->prev)
+    {
+      grub_size_t idx = label_hash (entry->label) & (size - 1);
+      entry->labelnext = menu->label_index[idx];
+      menu->label_index[idx] = entry;
+    }
+}
+
 static grub_err_t
 print_entry (struct output_buffer *outbuf,
 	     struct syslinux_menu *menu,
 	     const char *str)
 {
   struct syslinux_menuentry *curentry;
-  for (curentry = menu->entries; curentry; curentry = curentry->next)
+
+  if (menu->label_index)
+    curentry = menu->label_index[label_hash (str)
+				 & (menu->label_index_size - 1)];
+  else
+    curentry = menu->entries;
+  for (; curentry;
+       curentry = menu->label_index ? curentry->labelnext : curentry->next)
     if (grub_strcasecmp (curentry->label, str) == 0)
       {
 	grub_err_t err;
@@ -1402,6 +1596,7 @@ free_menu (struct syslinux_menu *menu)
   grub_free (menu->def);
   grub_free (menu->comments);
   grub_free (menu->background);
+  grub_free (menu->label_index);
   for (say = menu->say; say ; say = nsay)
     {
       nsay = say->next;
@@ -1455,6 +1650,8 @@ config_file (struct output_buffer *outbuf,
   if (err)
     return err;
 
+  build_label_index (&menu);
+
   for (say = menu.say; say && say->next; say = say->next);
   for (; say && say->prev; say = say->prev)
     {
@@ -1546,6 +1743,7 @@ grub_syslinux_config_file (const char *base, const char *target_base,
   grub_err_t err;
   err = config_file (&outbuf, base, target_base, cwd, target_cwd,
 		     fname, NULL, flav);
+  file_cache_free ();
   if (err)
     return NULL;
   err = print (&outbuf, "\0", 1);
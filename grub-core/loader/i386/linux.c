@@ -652,13 +652,12 @@ grub_cmd_linux (grub_command_t cmd __attribute__ ((unused)),
   struct linux_i386_kernel_header lh;
   grub_uint8_t *linux_params_ptr;
   grub_uint8_t setup_sects;
-  grub_size_t real_size, prot_size, prot_file_size, kernel_offset;
+  grub_size_t real_size, prot_size, prot_file_size;
   grub_ssize_t len;
   int i;
   grub_size_t align, min_align;
   int relocatable;
   grub_uint64_t preferred_address = GRUB_LINUX_BZIMAGE_ADDR;
-  grub_uint8_t *kernel = NULL;
 
   grub_dl_ref (my_mod);
 
@@ -672,15 +671,12 @@ grub_cmd_linux (grub_command_t cmd __attribute__ ((unused)),
   if (! file)
     goto fail;
 
-  len = grub_file_size (file);
-  kernel = grub_malloc (len);
-  if (!kernel)
-    {
-      grub_error (GRUB_ERR_OUT_OF_MEMORY, N_("cannot allocate kernel buffer"));
-      goto fail;
-    }
-
-  if (grub_file_read (file, kernel, len) != len)
+  /* Only the setup header is parsed; the protected-mode body is streamed
+     straight into its relocator chunk further down instead of going
+     through a file-sized bounce buffer.  When a verifier is active the
+     whole file has already been buffered and checked at open time, so
+     these reads are served from the verified copy either way.  */
+  if (grub_file_read (file, &lh, sizeof (lh)) != sizeof (lh))
     {
       if (!grub_errno)
 	grub_error (GRUB_ERR_BAD_OS, N_("premature end of file %s"),
@@ -688,9 +684,6 @@ grub_cmd_linux (grub_command_t cmd __attribute__ ((unused)),
       goto fail;
     }
 
-  grub_memcpy (&lh, kernel, sizeof (lh));
-  kernel_offset = sizeof (lh);
-
   if (lh.boot_flag != grub_cpu_to_le16_compile_time (0xaa55))
     {
       grub_error (GRUB_ERR_BAD_OS, "invalid magic number");
@@ -799,10 +792,13 @@ grub_cmd_linux (grub_command_t cmd __attribute__ ((unused)),
   len -= sizeof(lh);
 
   linux_params_ptr = (void *)&linux_params;
-  if (len > 0)
+  if (len > 0
+      && grub_file_read (file, linux_params_ptr + sizeof (lh), len) != len)
     {
-      grub_memcpy (linux_params_ptr + sizeof (lh), kernel + kernel_offset, len);
-      kernel_offset += len;
+      if (!grub_errno)
+	grub_error (GRUB_ERR_BAD_OS, N_("premature end of file %s"),
+		    argv[0]);
+      goto fail;
     }
 
   grub_dprintf("efi", "setting attributes for %p (%zu bytes) to +rw-x\n",
@@ -870,7 +866,7 @@ grub_cmd_linux (grub_command_t cmd __attribute__ ((unused)),
 
   /* The other parameters are filled when booting.  */
 
-  kernel_offset = real_size + GRUB_DISK_SECTOR_SIZE;
+  grub_file_seek (file, real_size + GRUB_DISK_SECTOR_SIZE);
 
   grub_dprintf ("linux", "bzImage, setup=0x%x, size=0x%x\n",
 		(unsigned) real_size, (unsigned) prot_size);
@@ -1023,8 +1019,22 @@ grub_cmd_linux (grub_command_t cmd __attribute__ ((unused)),
       goto fail;
   }
 
+  /* The protected-mode image is consumed start to finish into placed
+     memory, possibly through a decompression filter reading the
+     underlying file in small pieces; promise the disk layer a
+     sequential stream so it prefetches at full width from the first
+     chunk.  */
+  if (file->device->disk)
+    grub_disk_set_readahead (file->device->disk, GRUB_DISK_READAHEAD_EAGER);
+
   len = prot_file_size;
-  grub_memcpy (prot_mode_mem, kernel + kernel_offset, len);
+  if (grub_file_read (file, prot_mode_mem, len) != len)
+    {
+      if (!grub_errno)
+	grub_error (GRUB_ERR_BAD_OS, N_("premature end of file %s"),
+		    argv[0]);
+      goto fail;
+    }
 
   if (grub_errno == GRUB_ERR_NONE)
     {
@@ -1035,8 +1045,6 @@ grub_cmd_linux (grub_command_t cmd __attribute__ ((unused)),
 
  fail:
 
-  grub_free (kernel);
-
   if (file)
     grub_file_close (file);
 
@@ -1113,6 +1121,11 @@ grub_cmd_initrd (grub_command_t cmd __attribute__ ((unused)),
 
   {
     grub_relocator_chunk_t ch;
+    /* When the chunk can be carved out of [addr_min, addr] directly,
+       the relocator places it at its final physical address (target ==
+       src), so grub_initrd_load below streams the initrd into its boot
+       location with no further copy; only an allocation forced outside
+       the range is moved at boot time.  */
     err = grub_relocator_alloc_chunk_align (relocator, &ch,
 					    addr_min, addr, aligned_size,
 					    0x1000,
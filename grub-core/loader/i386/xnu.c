@@ -864,18 +864,6 @@ grub_xnu_set_video (struct grub_xnu_boot_params_common *params)
 	 bitmap = grub_xnu_bitmap;
      }
 
-  if (bitmap)
-    {
-      if (grub_xnu_bitmap_mode == GRUB_XNU_BITMAP_STRETCH)
-	err = grub_video_bitmap_create_scaled (&bitmap,
-					       mode_info.width,
-					       mode_info.height,
-					       grub_xnu_bitmap,
-					       GRUB_VIDEO_BITMAP_SCALE_METHOD_BEST);
-      else
-	bitmap = grub_xnu_bitmap;
-    }
-
   if (bitmap)
     {
       int x, y;
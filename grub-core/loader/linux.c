@@ -3,6 +3,7 @@
 #include <grub/linux.h>
 #include <grub/misc.h>
 #include <grub/file.h>
+#include <grub/disk.h>
 #include <grub/mm.h>
 #include <grub/safemath.h>
 
@@ -312,6 +313,11 @@ grub_initrd_load (struct grub_linux_initrd_context *initrd_ctx,
 	}
 
       cursize = initrd_ctx->components[i].size;
+      /* Each component is copied start to finish; stream it with the
+	 prefetch window fully open.  */
+      if (initrd_ctx->components[i].file->device->disk)
+	grub_disk_set_readahead (initrd_ctx->components[i].file->device->disk,
+				 GRUB_DISK_READAHEAD_EAGER);
       if (grub_file_read (initrd_ctx->components[i].file, ptr, cursize)
 	  != cursize)
 	{
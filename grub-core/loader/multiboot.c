@@ -428,8 +428,12 @@ grub_cmd_module (grub_command_t cmd __attribute__ ((unused)),
       return err;
     }
 
+  grub_boot_time_enter ("Reading multiboot module %s (%llu bytes)",
+			argv[0], (unsigned long long) size);
+
   if (size && grub_file_read (file, module, size) != size)
     {
+      grub_boot_time_exit ("Multiboot module read failed");
       grub_file_close (file);
       if (!grub_errno)
 	grub_error (GRUB_ERR_FILE_READ_ERROR, N_("premature end of file %s"),
@@ -437,6 +441,8 @@ grub_cmd_module (grub_command_t cmd __attribute__ ((unused)),
       return grub_errno;
     }
 
+  grub_boot_time_exit ("Read multiboot module %s", argv[0]);
+
   grub_file_close (file);
   return GRUB_ERR_NONE;
 }
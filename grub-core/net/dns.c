@@ -569,35 +569,40 @@ grub_net_dns_lookup (const char *name,
 
   nbd = nb->data;
 
-  for (i = 0; i < n_servers * 4; i++)
+  /* Open every configured server up front so the first round of
+     queries is in flight to all of them at once; the first valid
+     answer wins.  sockets[] stays aligned with servers[] so the
+     per-server address-family preference below reads the right
+     entry even when some opens fail.  */
+  for (try_server = 0; try_server < n_servers; try_server++)
     {
-      /* Connect to a next server.  */
-      while (!(i & 1) && try_server < n_servers)
+      sockets[try_server] = grub_net_udp_open (servers[try_server],
+					       DNS_PORT,
+					       recv_hook,
+					       &data);
+      if (!sockets[try_server])
 	{
-	  sockets[send_servers] = grub_net_udp_open (servers[try_server++],
-						     DNS_PORT,
-						     recv_hook,
-						     &data);
-	  if (!sockets[send_servers])
-	    {
-	      err = grub_errno;
-	      grub_errno = GRUB_ERR_NONE;
-	    }
-	  else
-	    {
-	      send_servers++;
-	      break;
-	    }
+	  err = grub_errno;
+	  grub_errno = GRUB_ERR_NONE;
 	}
-      if (!send_servers)
-	goto out;
+      else
+	send_servers++;
+    }
+  if (!send_servers)
+    goto out;
+
+  for (i = 0; i < n_servers * 4; i++)
+    {
       if (*data.naddresses)
 	goto out;
-      for (j = 0; j < send_servers; j++)
+      for (j = 0; j < n_servers; j++)
 	{
           grub_err_t err2;
 
           grub_size_t t = 0;
+
+          if (!sockets[j])
+            continue;
           do
             {
               nb->data = nbd;
@@ -626,8 +631,9 @@ grub_net_dns_lookup (const char *name,
  out:
   grub_free (data.name);
   grub_netbuff_free (nb);
-  for (j = 0; j < send_servers; j++)
-    grub_net_udp_close (sockets[j]);
+  for (j = 0; j < n_servers; j++)
+    if (sockets[j])
+      grub_net_udp_close (sockets[j]);
   
   grub_free (sockets);
 
@@ -66,20 +66,40 @@ send_ethernet_packet (struct grub_net_network_level_interface *inf,
   if (err)
     return err;
   eth = nb->data;
-  grub_memcpy (eth, target_addr.mac, hw_addr_len);
-  eth += hw_addr_len;
-  grub_memcpy (eth, inf->hwaddress.mac, hw_addr_len);
-  eth += hw_addr_len;
 
-  /* Check if a vlan-tag is present. */
-  if (vlantag != 0)
+  /* During a transfer every packet goes to the same target with the
+     same ethertype; reuse the header assembled for the previous one
+     when the key still matches.  */
+  if (inf->llhdr_cache_valid
+      && inf->llhdr_cache_size == etherhdr_size
+      && inf->llhdr_cache_ethertype == ethertype
+      && grub_net_hwaddr_cmp (&inf->llhdr_cache_target, &target_addr) == 0)
     {
-      *((grub_uint32_t *)eth) = grub_cpu_to_be32 (vlantag);
-      eth += sizeof (vlantag);
+      grub_memcpy (eth, inf->llhdr_cache, etherhdr_size);
     }
+  else
+    {
+      grub_memcpy (eth, target_addr.mac, hw_addr_len);
+      eth += hw_addr_len;
+      grub_memcpy (eth, inf->hwaddress.mac, hw_addr_len);
+      eth += hw_addr_len;
+
+      /* Check if a vlan-tag is present. */
+      if (vlantag != 0)
+	{
+	  *((grub_uint32_t *)eth) = grub_cpu_to_be32 (vlantag);
+	  eth += sizeof (vlantag);
+	}
 
-  /* Write ethertype */
-  *((grub_uint16_t*) eth) = grub_cpu_to_be16 (ethertype);
+      /* Write ethertype */
+      *((grub_uint16_t*) eth) = grub_cpu_to_be16 (ethertype);
+
+      grub_memcpy (inf->llhdr_cache, nb->data, etherhdr_size);
+      inf->llhdr_cache_target = target_addr;
+      inf->llhdr_cache_ethertype = ethertype;
+      inf->llhdr_cache_size = etherhdr_size;
+      inf->llhdr_cache_valid = 1;
+    }
 
   if (!inf->card->opened)
     {
@@ -53,6 +53,45 @@ typedef struct http_data
   int in_chunk_len;
 } *http_data_t;
 
+/*
+ * A single idle keep-alive connection, kept after a fully consumed
+ * response so that fetching the next file from the same server (the
+ * kernel+initrd pair being the common case) skips the TCP handshake.
+ */
+static struct
+{
+  char *server;
+  int port;
+  grub_net_tcp_socket_t sock;
+} idle_conn;
+
+static void
+idle_conn_drop (void)
+{
+  idle_conn.sock = 0;
+  grub_free (idle_conn.server);
+  idle_conn.server = 0;
+}
+
+static void
+idle_conn_err (grub_net_tcp_socket_t sock,
+	       void *f __attribute__ ((unused)))
+{
+  if (idle_conn.sock == sock)
+    idle_conn_drop ();
+  grub_net_tcp_close (sock, GRUB_NET_TCP_ABORT);
+}
+
+static void
+idle_conn_fin (grub_net_tcp_socket_t sock,
+	       void *f __attribute__ ((unused)))
+{
+  /* The server timed the connection out.  */
+  if (idle_conn.sock == sock)
+    idle_conn_drop ();
+  grub_net_tcp_close (sock, GRUB_NET_TCP_ABORT);
+}
+
 static grub_off_t
 have_ahead (struct grub_file *file)
 {
@@ -413,12 +452,26 @@ http_establish (struct grub_file *file, grub_off_t offset, int initial)
   grub_netbuff_put (nb, 2);
   grub_memcpy (ptr, "\r\n", 2);
 
-  grub_dprintf ("http", "opening path %s on host %s TCP port %d\n",
-		data->filename, server, port ? port : HTTP_PORT);
-  data->sock = grub_net_tcp_open (server,
-				  port ? port : HTTP_PORT, http_receive,
-				  http_err, NULL,
-				  file);
+  if (idle_conn.sock && idle_conn.port == (port ? port : HTTP_PORT)
+      && grub_strcmp (idle_conn.server, server) == 0)
+    {
+      grub_dprintf ("http", "reusing connection to host %s TCP port %d"
+		    " for path %s\n", server, port ? port : HTTP_PORT,
+		    data->filename);
+      data->sock = idle_conn.sock;
+      idle_conn_drop ();
+      grub_net_tcp_set_hooks (data->sock, http_receive, http_err, NULL,
+			      file);
+    }
+  else
+    {
+      grub_dprintf ("http", "opening path %s on host %s TCP port %d\n",
+		    data->filename, server, port ? port : HTTP_PORT);
+      data->sock = grub_net_tcp_open (server,
+				      port ? port : HTTP_PORT, http_receive,
+				      http_err, NULL,
+				      file);
+    }
   if (!data->sock)
     {
       grub_netbuff_free (nb);
@@ -551,6 +604,32 @@ http_close (struct grub_file *file)
   if (!data)
     return GRUB_ERR_NONE;
 
+  /* If the whole response was received and consumed, the connection is
+     cleanly between requests: park it for the next open instead of
+     closing.  A mid-body close (aborted transfer, chunked stream, seek)
+     leaves unread body bytes in the pipe and must tear down.  */
+  if (data->sock && data->headers_recv && !data->chunked && !data->err
+      && !data->current_line
+      && file->size != GRUB_FILE_SIZE_UNKNOWN
+      && file->device->net->offset >= file->size
+      && !file->device->net->packs.first)
+    {
+      char *server = grub_strdup (file->device->net->server);
+
+      if (server)
+	{
+	  if (idle_conn.sock)
+	    grub_net_tcp_close (idle_conn.sock, GRUB_NET_TCP_ABORT);
+	  grub_free (idle_conn.server);
+	  idle_conn.server = server;
+	  idle_conn.port = file->device->net->port ? : HTTP_PORT;
+	  idle_conn.sock = data->sock;
+	  grub_net_tcp_set_hooks (data->sock, NULL, idle_conn_err,
+				  idle_conn_fin, NULL);
+	  data->sock = 0;
+	}
+    }
+
   if (data->sock)
     grub_net_tcp_close (data->sock, GRUB_NET_TCP_ABORT);
   if (data->current_line)
@@ -591,5 +670,10 @@ GRUB_MOD_INIT (http)
 
 GRUB_MOD_FINI (http)
 {
+  if (idle_conn.sock)
+    {
+      grub_net_tcp_close (idle_conn.sock, GRUB_NET_TCP_ABORT);
+      idle_conn_drop ();
+    }
   grub_net_app_level_unregister (&grub_http_protocol);
 }
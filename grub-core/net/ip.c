@@ -96,22 +96,31 @@ static struct reassemble *reassembles;
 grub_uint16_t
 grub_net_ip_chksum (void *ipv, grub_size_t len)
 {
-  grub_uint16_t *ip = (grub_uint16_t *) ipv;
-  grub_uint32_t sum = 0;
+  const grub_uint8_t *ip = ipv;
+  grub_uint64_t acc = 0;
+  grub_uint32_t sum;
 
-  for (; len >= 2; len -= 2)
+  /* Accumulate four bytes per iteration into a wide register and
+     defer the carry folds to the end; folding after every 16-bit
+     word dominated receive time on full-size segments.  */
+  for (; len >= 4; len -= 4, ip += 4)
+    acc += grub_be_to_cpu32 (grub_get_unaligned32 (ip));
+
+  acc = (acc >> 32) + (acc & 0xFFFFFFFF);
+  acc = (acc >> 32) + (acc & 0xFFFFFFFF);
+  sum = (acc >> 16) + (acc & 0xFFFF);
+
+  if (len >= 2)
     {
-      sum += grub_be_to_cpu16 (grub_get_unaligned16 (ip++));
-      if (sum > 0xFFFF)
-	sum -= 0xFFFF;
+      sum += grub_be_to_cpu16 (grub_get_unaligned16 (ip));
+      len -= 2;
+      ip += 2;
     }
   if (len)
-    {
-      sum += *((grub_uint8_t *) ip) << 8;
-      if (sum > 0xFFFF)
-	sum -= 0xFFFF;
-    }
+    sum += *ip << 8;
 
+  while (sum >> 16)
+    sum = (sum >> 16) + (sum & 0xFFFF);
   if (sum >= 0xFFFF)
     sum -= 0xFFFF;
 
@@ -853,12 +853,17 @@ addr_set_env (struct grub_env_var *var __attribute__ ((unused)),
   return NULL;
 }
 
+/* Nonzero once the idle loop has primed the caches for the current
+   default server; reset whenever the server changes.  */
+static int defserver_prefetched;
+
 static char *
 defserver_set_env (struct grub_env_var *var __attribute__ ((unused)),
 		   const char *val)
 {
   grub_free (grub_net_default_server);
   grub_net_default_server = grub_strdup (val);
+  defserver_prefetched = 0;
   return grub_strdup (val);
 }
 
@@ -1631,6 +1636,9 @@ grub_net_fs_close (grub_file_t file)
   return GRUB_ERR_NONE;
 }
 
+/* How many frames to pull off a card before processing them.  */
+#define RECEIVE_BATCH_SIZE 16
+
 static void
 receive_packets (struct grub_net_card *card, int *stop_condition)
 {
@@ -1652,25 +1660,47 @@ receive_packets (struct grub_net_card *card, int *stop_condition)
   while (received < 100)
     {
       /* Maybe should be better have a fixed number of packets for each card
-	 and just mark them as used and not used.  */ 
-      struct grub_net_buff *nb;
+	 and just mark them as used and not used.  */
+      struct grub_net_buff *batch[RECEIVE_BATCH_SIZE];
+      int nbatch = 0, drained = 0, i;
 
       if (received > 10 && stop_condition && *stop_condition)
 	break;
 
-      nb = card->driver->recv (card);
-      if (!nb)
+      /*
+       * Drain the card into a batch before running any protocol
+       * processing: the card's receive ring keeps filling while we walk
+       * the protocol layers, and fetching frames back to back both
+       * protects the ring from overflowing and amortizes the per-call
+       * overhead of the driver's receive path.
+       */
+      while (nbatch < RECEIVE_BATCH_SIZE && received + nbatch < 100)
 	{
-	  card->last_poll = grub_get_time_ms ();
-	  break;
+	  struct grub_net_buff *nb;
+
+	  nb = card->driver->recv (card);
+	  if (!nb)
+	    {
+	      drained = 1;
+	      break;
+	    }
+	  batch[nbatch++] = nb;
 	}
-      received++;
-      grub_net_recv_ethernet_packet (nb, card);
-      if (grub_errno)
+      received += nbatch;
+      for (i = 0; i < nbatch; i++)
 	{
-	  grub_dprintf ("net", "error receiving: %d: %s\n", grub_errno,
-			grub_errmsg);
-	  grub_errno = GRUB_ERR_NONE;
+	  grub_net_recv_ethernet_packet (batch[i], card);
+	  if (grub_errno)
+	    {
+	      grub_dprintf ("net", "error receiving: %d: %s\n", grub_errno,
+			    grub_errmsg);
+	      grub_errno = GRUB_ERR_NONE;
+	    }
+	}
+      if (drained)
+	{
+	  card->last_poll = grub_get_time_ms ();
+	  break;
 	}
     }
   grub_print_error ();
@@ -1727,6 +1757,31 @@ grub_net_poll_cards (unsigned time, int *stop_condition)
   grub_net_tcp_retransmit ();
 }
 
+/*
+ * Resolve the default server while nobody is waiting for it.  Run from
+ * the idle loop, i.e. typically while the menu timeout counts down:
+ * the DNS answer lands in the resolver cache and the next hop's ARP
+ * entry in the card's link-layer table, so the eventual fetch starts
+ * without any setup round trips.  Failures are ignored -- the fetch
+ * path will retry them and report properly.
+ */
+static void
+defserver_prefetch (void)
+{
+  grub_net_network_level_address_t addr, gateway;
+  struct grub_net_network_level_interface *inf;
+  grub_net_link_level_address_t ll;
+
+  defserver_prefetched = 1;
+  if (!grub_net_default_server || !*grub_net_default_server
+      || !grub_net_network_level_interfaces)
+    return;
+  if (grub_net_resolve_address (grub_net_default_server, &addr) == GRUB_ERR_NONE
+      && grub_net_route_address (addr, &gateway, &inf) == GRUB_ERR_NONE)
+    grub_net_link_layer_resolve (inf, &gateway, &ll);
+  grub_errno = GRUB_ERR_NONE;
+}
+
 static void
 grub_net_poll_cards_idle_real (void)
 {
@@ -1739,6 +1794,8 @@ grub_net_poll_cards_idle_real (void)
 	|| ctime >= card->last_poll + card->idle_poll_delay_ms)
       receive_packets (card, 0);
   }
+  if (!defserver_prefetched)
+    defserver_prefetch ();
   grub_net_tcp_retransmit ();
 }
 
@@ -2180,6 +2237,7 @@ GRUB_MOD_FINI(net)
   grub_fs_unregister (&grub_net_fs);
   grub_net_open = NULL;
   grub_net_fini_hw (0);
+  grub_netbuff_free_pool ();
   grub_loader_unregister_preboot_hook (fini_hnd);
   grub_net_poll_cards_idle = grub_net_poll_cards_idle_real;
 #ifdef GRUB_MACHINE_EFI
@@ -21,6 +21,26 @@
 #include <grub/mm.h>
 #include <grub/net/netbuff.h>
 
+/*
+ * Nearly every buffer on the receive path is an MTU-sized frame, and
+ * grub_netbuff_alloc rounds all of them up to the same NETBUFF_ALIGN
+ * size class.  Instead of going through the allocator for each packet,
+ * keep a small free list of buffers of that class and recycle them in
+ * O(1): grub_netbuff_free pushes the buffer onto the list and the next
+ * grub_netbuff_alloc pops it off again.  The link lives in the first
+ * bytes of the (dead) data area, so the pool costs no extra memory.
+ */
+#define NETBUFF_POOL_CLASS	NETBUFF_ALIGN
+#define NETBUFF_POOL_MAX	64
+
+struct netbuff_pool_entry
+{
+  struct netbuff_pool_entry *next;
+};
+
+static struct netbuff_pool_entry *netbuff_pool;
+static unsigned netbuff_pool_count;
+
 grub_err_t
 grub_netbuff_put (struct grub_net_buff *nb, grub_size_t len)
 {
@@ -96,11 +116,20 @@ grub_netbuff_alloc (grub_size_t len)
 
   len = ALIGN_UP (len, NETBUFF_ALIGN);
 
+  if (len == NETBUFF_POOL_CLASS && netbuff_pool)
+    {
+      data = netbuff_pool;
+      netbuff_pool = netbuff_pool->next;
+      netbuff_pool_count--;
+    }
+  else
+    {
 #ifdef GRUB_MACHINE_EMU
-  data = grub_malloc (len + sizeof (*nb));
+      data = grub_malloc (len + sizeof (*nb));
 #else
-  data = grub_memalign (NETBUFF_ALIGN, len + sizeof (*nb));
+      data = grub_memalign (NETBUFF_ALIGN, len + sizeof (*nb));
 #endif
+    }
   if (!data)
     return NULL;
   nb = (struct grub_net_buff *) ((grub_properly_aligned_t *) data
@@ -135,9 +164,34 @@ grub_netbuff_free (struct grub_net_buff *nb)
 {
   if (!nb)
     return;
+  /* The descriptor sits at the end of a heap buffer iff nb == end.  */
+  if (nb->end == (grub_uint8_t *) nb
+      && nb->end - nb->head == NETBUFF_POOL_CLASS
+      && netbuff_pool_count < NETBUFF_POOL_MAX)
+    {
+      struct netbuff_pool_entry *entry = (struct netbuff_pool_entry *) nb->head;
+
+      entry->next = netbuff_pool;
+      netbuff_pool = entry;
+      netbuff_pool_count++;
+      return;
+    }
   grub_free (nb->head);
 }
 
+void
+grub_netbuff_free_pool (void)
+{
+  while (netbuff_pool)
+    {
+      struct netbuff_pool_entry *entry = netbuff_pool;
+
+      netbuff_pool = entry->next;
+      grub_free (entry);
+    }
+  netbuff_pool_count = 0;
+}
+
 grub_err_t
 grub_netbuff_clear (struct grub_net_buff *nb)
 {
@@ -28,6 +28,13 @@
 #define TCP_RETRANSMISSION_TIMEOUT GRUB_NET_INTERVAL
 #define TCP_RETRANSMISSION_COUNT GRUB_NET_TRIES
 
+/* ACK at the latest after every second in-order data segment, or after
+   this many milliseconds, whichever comes first.  The delay is far
+   below TCP_RETRANSMISSION_TIMEOUT on the peer, so a batched ACK never
+   looks like a loss.  */
+#define TCP_PENDING_ACK_LIMIT	2
+#define TCP_ACK_DELAY_MS	50
+
 struct unacked
 {
   struct unacked *next;
@@ -66,6 +73,10 @@ struct grub_net_tcp_socket
   grub_uint32_t their_start_seq;
   grub_uint32_t their_cur_seq;
   grub_uint16_t my_window;
+  /* Number of in-order data segments received but not yet ACKed, and
+     the time by which an ACK covering them must go out.  */
+  int pending_acks;
+  grub_uint64_t ack_deadline;
   struct unacked *unack_first;
   struct unacked *unack_last;
   grub_err_t (*recv_hook) (grub_net_tcp_socket_t sock, struct grub_net_buff *nb,
@@ -168,6 +179,23 @@ grub_net_tcp_stop_listen (grub_net_tcp_listen_t listen)
   grub_list_remove (GRUB_AS_LIST (listen));
 }
 
+void
+grub_net_tcp_set_hooks (grub_net_tcp_socket_t sock,
+			grub_err_t (*recv_hook) (grub_net_tcp_socket_t sock_,
+						 struct grub_net_buff *nb,
+						 void *data),
+			void (*error_hook) (grub_net_tcp_socket_t sock_,
+					    void *data),
+			void (*fin_hook) (grub_net_tcp_socket_t sock_,
+					  void *data),
+			void *hook_data)
+{
+  sock->recv_hook = recv_hook;
+  sock->error_hook = error_hook;
+  sock->fin_hook = fin_hook;
+  sock->hook_data = hook_data;
+}
+
 static inline void
 tcp_socket_register (grub_net_tcp_socket_t sock)
 {
@@ -361,9 +389,27 @@ ack_real (grub_net_tcp_socket_t sock, int res)
 static void
 ack (grub_net_tcp_socket_t sock)
 {
+  sock->pending_acks = 0;
+  sock->ack_deadline = 0;
   ack_real (sock, 0);
 }
 
+/* Note a received in-order data segment and ACK it either now or,
+   within TCP_ACK_DELAY_MS, batched with its successors.  FORCE
+   requests an immediate ACK (FIN, PUSH, stall transitions).  */
+static void
+ack_delayed (grub_net_tcp_socket_t sock, int force)
+{
+  sock->pending_acks++;
+  if (force || sock->pending_acks >= TCP_PENDING_ACK_LIMIT)
+    {
+      ack (sock);
+      return;
+    }
+  if (!sock->ack_deadline)
+    sock->ack_deadline = grub_get_time_ms () + TCP_ACK_DELAY_MS;
+}
+
 static void
 reset (grub_net_tcp_socket_t sock)
 {
@@ -380,6 +426,10 @@ grub_net_tcp_retransmit (void)
   FOR_TCP_SOCKETS (sock)
   {
     struct unacked *unack;
+
+    if (sock->ack_deadline && sock->ack_deadline <= ctime)
+      ack (sock);
+
     for (unack = sock->unack_first; unack; unack = unack->next)
       {
 	struct tcphdr *tcph;
@@ -879,12 +929,24 @@ grub_net_recv_tcp_packet (struct grub_net_buff *nb,
 	  sock->unack_last = NULL;
       }
 
-    if (grub_be_to_cpu32 (tcph->seqnr) < sock->their_cur_seq)
-      {
-	ack (sock);
-	grub_netbuff_free (nb);
-	return GRUB_ERR_NONE;
-      }
+    {
+      grub_uint32_t seg_len;
+
+      seg_len = (nb->tail - nb->data
+		 - (grub_be_to_cpu16 (tcph->flags) >> 12)
+		 * sizeof (grub_uint32_t));
+      if (grub_be_to_cpu16 (tcph->flags) & TCP_FIN)
+	seg_len++;
+
+      /* Discard only segments carrying nothing new; a retransmission
+	 extending past their_cur_seq still has a usable tail.  */
+      if (grub_be_to_cpu32 (tcph->seqnr) + seg_len <= sock->their_cur_seq)
+	{
+	  ack (sock);
+	  grub_netbuff_free (nb);
+	  return GRUB_ERR_NONE;
+	}
+    }
     if (sock->i_reseted && (nb->tail - nb->data
 			    - (grub_be_to_cpu16 (tcph->flags)
 			       >> 12) * sizeof (grub_uint32_t)) > 0)
@@ -903,32 +965,45 @@ grub_net_recv_tcp_packet (struct grub_net_buff *nb,
       struct grub_net_buff **nb_top_p, *nb_top;
       int do_ack = 0;
       int just_closed = 0;
+      int pushed = 0;
       while (1)
 	{
+	  grub_uint32_t seg_len;
+
 	  nb_top_p = grub_priority_queue_top (sock->pq);
 	  if (!nb_top_p)
 	    return GRUB_ERR_NONE;
 	  nb_top = *nb_top_p;
 	  tcph = (struct tcphdr *) nb_top->data;
-	  if (grub_be_to_cpu32 (tcph->seqnr) >= sock->their_cur_seq)
+	  seg_len = (nb_top->tail - nb_top->data
+		     - (grub_be_to_cpu16 (tcph->flags) >> 12)
+		     * sizeof (grub_uint32_t));
+	  if (grub_be_to_cpu16 (tcph->flags) & TCP_FIN)
+	    seg_len++;
+	  if (grub_be_to_cpu32 (tcph->seqnr) + seg_len > sock->their_cur_seq)
 	    break;
 	  grub_netbuff_free (nb_top);
 	  grub_priority_queue_pop (sock->pq);
 	}
-      if (grub_be_to_cpu32 (tcph->seqnr) != sock->their_cur_seq)
+      if (grub_be_to_cpu32 (tcph->seqnr) > sock->their_cur_seq)
 	{
+	  /* A hole: immediately duplicate-ACK so the peer can fast
+	     retransmit.  */
 	  ack (sock);
 	  return GRUB_ERR_NONE;
 	}
       while (1)
 	{
+	  grub_uint32_t seqnr;
+
 	  nb_top_p = grub_priority_queue_top (sock->pq);
 	  if (!nb_top_p)
 	    break;
 	  nb_top = *nb_top_p;
 	  tcph = (struct tcphdr *) nb_top->data;
 
-	  if (grub_be_to_cpu32 (tcph->seqnr) != sock->their_cur_seq)
+	  seqnr = grub_be_to_cpu32 (tcph->seqnr);
+	  if (seqnr > sock->their_cur_seq)
 	    break;
 	  grub_priority_queue_pop (sock->pq);
 
@@ -940,6 +1015,17 @@ grub_net_recv_tcp_packet (struct grub_net_buff *nb,
 	      return err;
 	    }
 
+	  /* Skip the prefix already delivered by an earlier segment.  */
+	  if (seqnr < sock->their_cur_seq)
+	    {
+	      err = grub_netbuff_pull (nb_top, sock->their_cur_seq - seqnr);
+	      if (err)
+		{
+		  grub_netbuff_free (nb_top);
+		  return err;
+		}
+	    }
+
 	  sock->their_cur_seq += (nb_top->tail - nb_top->data);
 	  if (grub_be_to_cpu16 (tcph->flags) & TCP_FIN)
 	    {
@@ -948,6 +1034,8 @@ grub_net_recv_tcp_packet (struct grub_net_buff *nb,
 	      sock->their_cur_seq++;
 	      do_ack = 1;
 	    }
+	  if (grub_be_to_cpu16 (tcph->flags) & TCP_PUSH)
+	    pushed = 1;
 	  /* If there is data, puts packet in socket list. */
 	  if ((nb_top->tail - nb_top->data) > 0)
 	    {
@@ -958,7 +1046,7 @@ grub_net_recv_tcp_packet (struct grub_net_buff *nb,
 	    grub_netbuff_free (nb_top);
 	}
       if (do_ack)
-	ack (sock);
+	ack_delayed (sock, just_closed || pushed);
       while (sock->packs.first)
 	{
 	  nb = sock->packs.first->nb;
@@ -101,7 +101,13 @@ typedef struct tftp_data
   grub_uint64_t file_size;
   grub_uint64_t block;
   grub_uint32_t block_size;
+  /* Number of blocks the server may send between our ACKs (RFC 7440).
+     1 means plain lockstep TFTP.  */
+  grub_uint32_t window_size;
   grub_uint64_t ack_sent;
+  /* Nonzero while we are waiting for the server to rewind after a lost
+     block; suppresses duplicate-ACK storms for every packet in flight.  */
+  int in_window_gap;
   int have_oack;
   struct grub_error_saved save_err;
   grub_net_udp_socket_t sock;
@@ -157,7 +163,8 @@ tftp_receive (grub_net_udp_socket_t sock __attribute__ ((unused)),
     {
     case TFTP_OACK:
       data->block_size = TFTP_DEFAULTSIZE_PACKET;
-      data->have_oack = 1; 
+      data->window_size = 1;
+      data->have_oack = 1;
       for (ptr = nb->data + sizeof (tftph->opcode); ptr < nb->tail;)
 	{
 	  if (grub_memcmp (ptr, "tsize\0", sizeof ("tsize\0") - 1) == 0)
@@ -166,10 +173,16 @@ tftp_receive (grub_net_udp_socket_t sock __attribute__ ((unused)),
 	  if (grub_memcmp (ptr, "blksize\0", sizeof ("blksize\0") - 1) == 0)
 	    data->block_size = grub_strtoul ((char *) ptr + sizeof ("blksize\0")
 					     - 1, 0, 0);
+	  if (grub_memcmp (ptr, "windowsize\0", sizeof ("windowsize\0") - 1) == 0)
+	    data->window_size = grub_strtoul ((char *) ptr
+					      + sizeof ("windowsize\0") - 1,
+					      0, 0);
 	  while (ptr < nb->tail && *ptr)
 	    ptr++;
 	  ptr++;
 	}
+      if (data->window_size == 0)
+	data->window_size = 1;
       data->block = 0;
       grub_netbuff_free (nb);
       err = ack (data, 0);
@@ -197,18 +210,36 @@ tftp_receive (grub_net_udp_socket_t sock __attribute__ ((unused)),
        */
       if (grub_be_to_cpu16 (tftph->u.data.block) < ((grub_uint16_t) (data->block + 1)))
 	ack (data, grub_be_to_cpu16 (tftph->u.data.block));
-      /* Ignore unexpected block. */
       else if (grub_be_to_cpu16 (tftph->u.data.block) > ((grub_uint16_t) (data->block + 1)))
-	grub_dprintf ("tftp", "TFTP unexpected block # %d\n", tftph->u.data.block);
+	{
+	  /*
+	   * A block inside the current window was lost.  Per RFC 7440 the
+	   * receiver re-ACKs the last block it got in order, which makes the
+	   * server rewind and resend from there.  Do it only once per gap:
+	   * the rest of the window is still in flight and would otherwise
+	   * trigger one rewind per stray packet.
+	   */
+	  grub_dprintf ("tftp", "TFTP unexpected block # %d\n", tftph->u.data.block);
+	  if (data->window_size > 1 && !data->in_window_gap)
+	    {
+	      data->in_window_gap = 1;
+	      ack (data, data->block);
+	    }
+	}
       else
 	{
 	  unsigned size;
 
+	  data->in_window_gap = 0;
 	  if (file->device->net->packs.count < 50)
 	    {
-	      err = ack (data, data->block + 1);
-	      if (err)
-		return err;
+	      /* ACK only the last block of each window.  */
+	      if (data->block + 1 - data->ack_sent >= data->window_size)
+		{
+		  err = ack (data, data->block + 1);
+		  if (err)
+		    return err;
+		}
 	    }
 	  else
 	    file->device->net->stall = 1;
@@ -300,6 +331,7 @@ tftp_open (struct grub_file *file, const char *filename)
   data = grub_zalloc (sizeof (*data));
   if (!data)
     return grub_errno;
+  data->window_size = 1;
 
   nb.head = open_data;
   nb.end = open_data + sizeof (open_data);
@@ -340,6 +372,14 @@ tftp_open (struct grub_file *file, const char *filename)
   rrqlen += grub_strlen ("1024") + 1;
   rrq += grub_strlen ("1024") + 1;
 
+  grub_strcpy (rrq, "windowsize");
+  rrqlen += grub_strlen ("windowsize") + 1;
+  rrq += grub_strlen ("windowsize") + 1;
+
+  grub_strcpy (rrq, "8");
+  rrqlen += grub_strlen ("8") + 1;
+  rrq += grub_strlen ("8") + 1;
+
   grub_strcpy (rrq, "tsize");
   rrqlen += grub_strlen ("tsize") + 1;
   rrq += grub_strlen ("tsize") + 1;
@@ -209,8 +209,10 @@ grub_utf8_to_ucs4_alloc (const char *msg, grub_uint32_t **unicode_msg,
   if (!*unicode_msg)
     return -1;
 
+  /* Passing the known length rather than -1 lets the converter use its
+     word-at-a-time ASCII path.  */
   msg_len = grub_utf8_to_ucs4 (*unicode_msg, msg_len,
-  			      (grub_uint8_t *) msg, -1, 0);
+  			      (grub_uint8_t *) msg, msg_len, 0);
 
   if (last_position)
     *last_position = *unicode_msg + msg_len;
@@ -239,6 +241,30 @@ grub_utf8_to_ucs4 (grub_uint32_t *dest, grub_size_t destsize,
   while (srcsize && destsize)
     {
       int was_count = count;
+
+      /* Eight input bytes at a time as long as they are plain ASCII.
+	 The high-bit test rejects multibyte sequences, the zero test
+	 keeps the NUL-terminates-conversion behaviour of the scalar
+	 loop below.  Only done with an explicit SRCSIZE: with -1 the
+	 wide load could read past the terminating NUL.  */
+      while (count == 0 && srcsize != (grub_size_t) -1
+	     && srcsize >= 8 && destsize >= 8)
+	{
+	  grub_uint64_t w = grub_get_unaligned64 (src);
+	  int j;
+
+	  if ((w & 0x8080808080808080ULL)
+	      || ((w - 0x0101010101010101ULL) & ~w & 0x8080808080808080ULL))
+	    break;
+	  for (j = 0; j < 8; j++)
+	    *p++ = src[j];
+	  src += 8;
+	  srcsize -= 8;
+	  destsize -= 8;
+	}
+      if (!srcsize || !destsize)
+	break;
+
       if (srcsize != (grub_size_t)-1)
 	srcsize--;
       if (!grub_utf8_process (*src++, &code, &count))
@@ -262,130 +288,146 @@ grub_utf8_to_ucs4 (grub_uint32_t *dest, grub_size_t destsize,
   return p - dest;
 }
 
-static grub_uint8_t *join_types = NULL;
+/* Character attributes (bidi type, mirror flag, joining type and
+   combining class) come from the generated grub_unicode_compact range
+   table.  Unpack it once into a two-level page table, so the per
+   character lookup on the output path is two array dereferences
+   instead of a range search.  The default attributes (bidi type L,
+   nonjoining, combining class none, not mirrored) all encode to zero,
+   so pages holding only defaults stay unallocated and NULL in the
+   page index reads as all-zero.  */
+
+#define GRUB_UNICODE_PAGE_BITS		8
+#define GRUB_UNICODE_PAGE_SIZE		(1 << GRUB_UNICODE_PAGE_BITS)
+#define GRUB_UNICODE_NPAGES		(0x110000 >> GRUB_UNICODE_PAGE_BITS)
+
+/* Attribute encoding: bits 0-4 bidi type, bits 5-7 joining type,
+   bits 8-15 combining class, bit 16 mirror flag.  */
+#define GRUB_UNICODE_ATTR_BIDI(a)	((a) & 0x1f)
+#define GRUB_UNICODE_ATTR_JOIN(a)	(((a) >> 5) & 0x7)
+#define GRUB_UNICODE_ATTR_COMB(a)	(((a) >> 8) & 0xff)
+#define GRUB_UNICODE_ATTR_MIRROR(a)	(((a) >> 16) & 0x1)
+
+static grub_uint32_t **attr_pages;
+static int attr_pages_failed;
+
+static grub_uint32_t
+pack_attrs (const struct grub_unicode_compact_range *cur)
+{
+  return cur->bidi_type | (cur->join_type << 5) | (cur->comb_type << 8)
+    | ((grub_uint32_t) cur->bidi_mirror << 16);
+}
 
 static void
-unpack_join (void)
+unpack_attrs (void)
 {
-  unsigned i;
   struct grub_unicode_compact_range *cur;
+  unsigned i;
+
+  attr_pages = grub_zalloc (GRUB_UNICODE_NPAGES * sizeof (*attr_pages));
+  if (!attr_pages)
+    goto fail;
 
-  join_types = grub_zalloc (GRUB_UNICODE_MAX_CACHED_CHAR);
-  if (!join_types)
-    {
-      grub_errno = GRUB_ERR_NONE;
-      return;
-    }
   for (cur = grub_unicode_compact; cur->len; cur++)
-    for (i = cur->start; i < cur->start + (unsigned) cur->len
-	   && i < GRUB_UNICODE_MAX_CACHED_CHAR; i++)
-      join_types[i] = cur->join_type;
-}
+    {
+      grub_uint32_t attrs = pack_attrs (cur);
 
-static grub_uint8_t *bidi_types = NULL;
+      if (!attrs)
+	continue;
+      for (i = cur->start; i < cur->start + (unsigned) cur->len; i++)
+	{
+	  grub_uint32_t **page = &attr_pages[i >> GRUB_UNICODE_PAGE_BITS];
 
-static void
-unpack_bidi (void)
-{
-  unsigned i;
-  struct grub_unicode_compact_range *cur;
+	  if (!*page)
+	    {
+	      *page = grub_zalloc (GRUB_UNICODE_PAGE_SIZE * sizeof (**page));
+	      if (!*page)
+		goto fail;
+	    }
+	  (*page)[i & (GRUB_UNICODE_PAGE_SIZE - 1)] = attrs;
+	}
+    }
+  return;
 
-  bidi_types = grub_zalloc (GRUB_UNICODE_MAX_CACHED_CHAR);
-  if (!bidi_types)
+fail:
+  if (attr_pages)
     {
-      grub_errno = GRUB_ERR_NONE;
-      return;
+      for (i = 0; i < GRUB_UNICODE_NPAGES; i++)
+	grub_free (attr_pages[i]);
+      grub_free (attr_pages);
+      attr_pages = NULL;
     }
-  for (cur = grub_unicode_compact; cur->len; cur++)
-    for (i = cur->start; i < cur->start + (unsigned) cur->len
-	   && i < GRUB_UNICODE_MAX_CACHED_CHAR; i++)
-      if (cur->bidi_mirror)
-	bidi_types[i] = cur->bidi_type | 0x80;
-      else
-	bidi_types[i] = cur->bidi_type | 0x00;
+  /* Degraded lookups must not fail the caller.  */
+  attr_pages_failed = 1;
+  grub_errno = GRUB_ERR_NONE;
 }
 
-static inline enum grub_bidi_type
-get_bidi_type (grub_uint32_t c)
+/* Fallback when the page table could not be allocated.  The generated
+   ranges are sorted by start and do not overlap, so bisect.  */
+static grub_uint32_t
+search_attrs (grub_uint32_t c)
 {
-  struct grub_unicode_compact_range *cur;
-
-  if (!bidi_types)
-    unpack_bidi ();
+  static grub_size_t nranges;
+  grub_size_t lo, hi;
 
-  if (bidi_types && c < GRUB_UNICODE_MAX_CACHED_CHAR)
-    return bidi_types[c] & 0x7f;
+  if (!nranges)
+    while (grub_unicode_compact[nranges].len)
+      nranges++;
 
-  for (cur = grub_unicode_compact; cur->len; cur++)
-    if (cur->start <= c && c < cur->start + (unsigned) cur->len)
-      return cur->bidi_type;
+  lo = 0;
+  hi = nranges;
+  while (lo < hi)
+    {
+      grub_size_t mid = (lo + hi) / 2;
+      struct grub_unicode_compact_range *cur = &grub_unicode_compact[mid];
 
-  return GRUB_BIDI_TYPE_L;
+      if (c < cur->start)
+	hi = mid;
+      else if (c >= cur->start + (unsigned) cur->len)
+	lo = mid + 1;
+      else
+	return pack_attrs (cur);
+    }
+  return 0;
 }
 
-static inline enum grub_join_type
-get_join_type (grub_uint32_t c)
+static grub_uint32_t
+get_attrs (grub_uint32_t c)
 {
-  struct grub_unicode_compact_range *cur;
+  if (!attr_pages && !attr_pages_failed)
+    unpack_attrs ();
 
-  if (!join_types)
-    unpack_join ();
+  if (attr_pages && (c >> GRUB_UNICODE_PAGE_BITS) < GRUB_UNICODE_NPAGES)
+    {
+      grub_uint32_t *page = attr_pages[c >> GRUB_UNICODE_PAGE_BITS];
+      return page ? page[c & (GRUB_UNICODE_PAGE_SIZE - 1)] : 0;
+    }
 
-  if (join_types && c < GRUB_UNICODE_MAX_CACHED_CHAR)
-    return join_types[c];
+  return search_attrs (c);
+}
 
-  for (cur = grub_unicode_compact; cur->len; cur++)
-    if (cur->start <= c && c < cur->start + (unsigned) cur->len)
-      return cur->join_type;
+static inline enum grub_bidi_type
+get_bidi_type (grub_uint32_t c)
+{
+  return GRUB_UNICODE_ATTR_BIDI (get_attrs (c));
+}
 
-  return GRUB_JOIN_TYPE_NONJOINING;
+static inline enum grub_join_type
+get_join_type (grub_uint32_t c)
+{
+  return GRUB_UNICODE_ATTR_JOIN (get_attrs (c));
 }
 
 static inline int
 is_mirrored (grub_uint32_t c)
 {
-  struct grub_unicode_compact_range *cur;
-
-  if (!bidi_types)
-    unpack_bidi ();
-
-  if (bidi_types && c < GRUB_UNICODE_MAX_CACHED_CHAR)
-    return !!(bidi_types[c] & 0x80);
-
-  for (cur = grub_unicode_compact; cur->len; cur++)
-    if (cur->start <= c && c < cur->start + (unsigned) cur->len)
-      return cur->bidi_mirror;
-
-  return 0;
+  return GRUB_UNICODE_ATTR_MIRROR (get_attrs (c));
 }
 
 enum grub_comb_type
 grub_unicode_get_comb_type (grub_uint32_t c)
 {
-  static grub_uint8_t *comb_types = NULL;
-  struct grub_unicode_compact_range *cur;
-
-  if (!comb_types)
-    {
-      unsigned i;
-      comb_types = grub_zalloc (GRUB_UNICODE_MAX_CACHED_CHAR);
-      if (comb_types)
-	for (cur = grub_unicode_compact; cur->len; cur++)
-	  for (i = cur->start; i < cur->start + (unsigned) cur->len
-		 && i < GRUB_UNICODE_MAX_CACHED_CHAR; i++)
-	    comb_types[i] = cur->comb_type;
-      else
-	grub_errno = GRUB_ERR_NONE;
-    }
-
-  if (comb_types && c < GRUB_UNICODE_MAX_CACHED_CHAR)
-    return comb_types[c];
-
-  for (cur = grub_unicode_compact; cur->len; cur++)
-    if (cur->start <= c && c < cur->start + (unsigned) cur->len)
-      return cur->comb_type;
-
-  return GRUB_UNICODE_COMB_NONE;
+  return GRUB_UNICODE_ATTR_COMB (get_attrs (c));
 }
 
 #if HAVE_FONT_SOURCE
@@ -571,7 +613,7 @@ bidi_line_wrap (struct grub_unicode_glyph *visual_out,
 		grub_size_t maxwidth, grub_size_t startwidth,
 		grub_uint32_t contchar,
 		struct grub_term_pos *pos, int primitive_wrap,
-		grub_size_t log_end)
+		grub_size_t log_end, int all_ascii)
 {
   struct grub_unicode_glyph *outptr = visual_out;
   unsigned line_start = 0;
@@ -683,86 +725,91 @@ bidi_line_wrap (struct grub_unicode_glyph *visual_out,
 	      }
 	  }
 	  
-	  {
-	    unsigned i;
-	    for (i = line_start; i < kk; i++)
+	  /* Plain ASCII lines never need mirroring or joining; skip the
+	     per-character lookups entirely.  */
+	  if (! all_ascii)
+	    {
 	      {
-		if (is_mirrored (visual[i].base) && visual[i].bidi_level)
-		  visual[i].attributes |= GRUB_UNICODE_GLYPH_ATTRIBUTE_MIRROR;
-		if ((visual[i].attributes & GRUB_UNICODE_GLYPH_ATTRIBUTES_JOIN)
-		    && visual[i].bidi_level)
+		unsigned i;
+		for (i = line_start; i < kk; i++)
 		  {
-		    int left, right;
-		    left = visual[i].attributes
-		      & (GRUB_UNICODE_GLYPH_ATTRIBUTE_LEFT_JOINED 
-			 | GRUB_UNICODE_GLYPH_ATTRIBUTE_LEFT_JOINED_EXPLICIT);
-		    right = visual[i].attributes
-		      & (GRUB_UNICODE_GLYPH_ATTRIBUTE_RIGHT_JOINED 
-			 | GRUB_UNICODE_GLYPH_ATTRIBUTE_RIGHT_JOINED_EXPLICIT);
-		    visual[i].attributes &= ~GRUB_UNICODE_GLYPH_ATTRIBUTES_JOIN;
-		    left <<= GRUB_UNICODE_GLYPH_ATTRIBUTES_JOIN_LEFT_TO_RIGHT_SHIFT;
-		    right >>= GRUB_UNICODE_GLYPH_ATTRIBUTES_JOIN_LEFT_TO_RIGHT_SHIFT;
-		    visual[i].attributes |= (left | right);
+		    if (is_mirrored (visual[i].base) && visual[i].bidi_level)
+		      visual[i].attributes |= GRUB_UNICODE_GLYPH_ATTRIBUTE_MIRROR;
+		    if ((visual[i].attributes & GRUB_UNICODE_GLYPH_ATTRIBUTES_JOIN)
+			&& visual[i].bidi_level)
+		      {
+			int left, right;
+			left = visual[i].attributes
+			  & (GRUB_UNICODE_GLYPH_ATTRIBUTE_LEFT_JOINED 
+			     | GRUB_UNICODE_GLYPH_ATTRIBUTE_LEFT_JOINED_EXPLICIT);
+			right = visual[i].attributes
+			  & (GRUB_UNICODE_GLYPH_ATTRIBUTE_RIGHT_JOINED 
+			     | GRUB_UNICODE_GLYPH_ATTRIBUTE_RIGHT_JOINED_EXPLICIT);
+			visual[i].attributes &= ~GRUB_UNICODE_GLYPH_ATTRIBUTES_JOIN;
+			left <<= GRUB_UNICODE_GLYPH_ATTRIBUTES_JOIN_LEFT_TO_RIGHT_SHIFT;
+			right >>= GRUB_UNICODE_GLYPH_ATTRIBUTES_JOIN_LEFT_TO_RIGHT_SHIFT;
+			visual[i].attributes |= (left | right);
+		      }
 		  }
 	      }
-	  }
 
-	  {
-	    int left_join = 0;
-	    unsigned i;
-	    for (i = line_start; i < kk; i++)
 	      {
-		enum grub_join_type join_type = get_join_type (visual[i].base);
-		if (!(visual[i].attributes
-		      & GRUB_UNICODE_GLYPH_ATTRIBUTE_LEFT_JOINED_EXPLICIT)
-		    && (join_type == GRUB_JOIN_TYPE_LEFT
-			|| join_type == GRUB_JOIN_TYPE_DUAL))
+		int left_join = 0;
+		unsigned i;
+		for (i = line_start; i < kk; i++)
 		  {
-		    if (left_join)
-		      visual[i].attributes
-			|= GRUB_UNICODE_GLYPH_ATTRIBUTE_LEFT_JOINED;
-		    else
-		      visual[i].attributes
-			&= ~GRUB_UNICODE_GLYPH_ATTRIBUTE_LEFT_JOINED;
+		    enum grub_join_type join_type = get_join_type (visual[i].base);
+		    if (!(visual[i].attributes
+			  & GRUB_UNICODE_GLYPH_ATTRIBUTE_LEFT_JOINED_EXPLICIT)
+			&& (join_type == GRUB_JOIN_TYPE_LEFT
+			    || join_type == GRUB_JOIN_TYPE_DUAL))
+		      {
+			if (left_join)
+			  visual[i].attributes
+			    |= GRUB_UNICODE_GLYPH_ATTRIBUTE_LEFT_JOINED;
+			else
+			  visual[i].attributes
+			    &= ~GRUB_UNICODE_GLYPH_ATTRIBUTE_LEFT_JOINED;
+		      }
+		    if (join_type == GRUB_JOIN_TYPE_NONJOINING
+			|| join_type == GRUB_JOIN_TYPE_LEFT)
+		      left_join = 0;
+		    if (join_type == GRUB_JOIN_TYPE_RIGHT
+			|| join_type == GRUB_JOIN_TYPE_DUAL
+			|| join_type == GRUB_JOIN_TYPE_CAUSING)
+		      left_join = 1;
 		  }
-		if (join_type == GRUB_JOIN_TYPE_NONJOINING
-		    || join_type == GRUB_JOIN_TYPE_LEFT)
-		  left_join = 0;
-		if (join_type == GRUB_JOIN_TYPE_RIGHT
-		    || join_type == GRUB_JOIN_TYPE_DUAL
-		    || join_type == GRUB_JOIN_TYPE_CAUSING)
-		  left_join = 1;
 	      }
-	  }
 
-	  {
-	    int right_join = 0;
-	    signed i;
-	    for (i = kk - 1; i >= 0 && (unsigned) i + 1 > line_start;
-		 i--)
 	      {
-		enum grub_join_type join_type = get_join_type (visual[i].base);
-		if (!(visual[i].attributes
-		      & GRUB_UNICODE_GLYPH_ATTRIBUTE_RIGHT_JOINED_EXPLICIT)
-		    && (join_type == GRUB_JOIN_TYPE_RIGHT
-			|| join_type == GRUB_JOIN_TYPE_DUAL))
+		int right_join = 0;
+		signed i;
+		for (i = kk - 1; i >= 0 && (unsigned) i + 1 > line_start;
+		     i--)
 		  {
-		    if (right_join)
-		      visual[i].attributes
-			|= GRUB_UNICODE_GLYPH_ATTRIBUTE_RIGHT_JOINED;
-		    else
-		      visual[i].attributes
-			&= ~GRUB_UNICODE_GLYPH_ATTRIBUTE_RIGHT_JOINED;
+		    enum grub_join_type join_type = get_join_type (visual[i].base);
+		    if (!(visual[i].attributes
+			  & GRUB_UNICODE_GLYPH_ATTRIBUTE_RIGHT_JOINED_EXPLICIT)
+			&& (join_type == GRUB_JOIN_TYPE_RIGHT
+			    || join_type == GRUB_JOIN_TYPE_DUAL))
+		      {
+			if (right_join)
+			  visual[i].attributes
+			    |= GRUB_UNICODE_GLYPH_ATTRIBUTE_RIGHT_JOINED;
+			else
+			  visual[i].attributes
+			    &= ~GRUB_UNICODE_GLYPH_ATTRIBUTE_RIGHT_JOINED;
+		      }
+		    if (join_type == GRUB_JOIN_TYPE_NONJOINING
+			|| join_type == GRUB_JOIN_TYPE_RIGHT)
+		      right_join = 0;
+		    if (join_type == GRUB_JOIN_TYPE_LEFT
+			|| join_type == GRUB_JOIN_TYPE_DUAL
+			|| join_type == GRUB_JOIN_TYPE_CAUSING)
+		      right_join = 1;
 		  }
-		if (join_type == GRUB_JOIN_TYPE_NONJOINING
-		    || join_type == GRUB_JOIN_TYPE_RIGHT)
-		  right_join = 0;
-		if (join_type == GRUB_JOIN_TYPE_LEFT
-		    || join_type == GRUB_JOIN_TYPE_DUAL
-		    || join_type == GRUB_JOIN_TYPE_CAUSING)
-		  right_join = 1;
-	      }
-	  }		
+	      }		
+	    }
 
 	  grub_memcpy (outptr, &visual[line_start],
 		       (kk - line_start) * sizeof (visual[0]));
@@ -857,6 +904,30 @@ grub_bidi_line_logical_to_visual (const grub_uint32_t *logical,
   if (!visual)
     return -1;
 
+  /* Fast path: a line of printable ASCII (the overwhelmingly common case
+     for menu entries and messages) needs neither reordering, mirroring
+     nor joining.  Fill the visual glyphs directly and leave only the
+     line wrapping to do; zero bidi levels and attributes match what the
+     full algorithm computes for such input.  */
+  for (i = 0; i < logical_len; i++)
+    if (logical[i] >= 0x7f || (logical[i] < 0x20 && logical[i] != '\t'))
+      break;
+  if (i == logical_len)
+    {
+      grub_ssize_t ret;
+      for (i = 0; i < logical_len; i++)
+	{
+	  visual[i].base = logical[i];
+	  visual[i].orig_pos = i;
+	}
+      ret = bidi_line_wrap (visual_out, visual, logical_len,
+			    getcharwidth, getcharwidth_arg, maxwidth,
+			    startwidth, contchar, pos, primitive_wrap,
+			    log_end, 1);
+      grub_free (visual);
+      return ret;
+    }
+
   for (i = 0; i < logical_len; i++)
     {
       type = get_bidi_type (logical[i]);
@@ -1149,7 +1220,7 @@ grub_bidi_line_logical_to_visual (const grub_uint32_t *logical,
     grub_ssize_t ret;
     ret = bidi_line_wrap (visual_out, visual, visual_len,
 			  getcharwidth, getcharwidth_arg, maxwidth, startwidth, contchar,
-			  pos, primitive_wrap, log_end);
+			  pos, primitive_wrap, log_end, 0);
     grub_free (visual);
     return ret;
   }
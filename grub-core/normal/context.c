@@ -56,7 +56,7 @@ static grub_err_t
 grub_env_new_context (int export_all)
 {
   struct grub_env_context *context;
-  int i;
+  grub_size_t i;
   struct menu_pointer *menu;
 
   context = grub_zalloc (sizeof (*context));
@@ -71,26 +71,29 @@ grub_env_new_context (int export_all)
 
   context->prev = grub_current_context;
   grub_current_context = context;
+  grub_env_hot_reset ();
 
   menu->prev = current_menu;
   current_menu = menu;
 
   /* Copy exported variables.  */
-  for (i = 0; i < HASHSZ; i++)
+  for (i = 0; i < context->prev->nslots; i++)
     {
-      struct grub_env_var *var;
-
-      for (var = context->prev->vars[i]; var; var = var->next)
-	if (var->global || export_all)
-	  {
-	    if (grub_env_set (var->name, var->value) != GRUB_ERR_NONE)
-	      {
-		grub_env_context_close ();
-		return grub_errno;
-	      }
-	    grub_env_export (var->name);
-	    grub_register_variable_hook (var->name, var->read_hook, var->write_hook);
-	  }
+      struct grub_env_var *var = context->prev->vars[i];
+
+      if (! var || var == &grub_env_tombstone)
+	continue;
+
+      if (var->global || export_all)
+	{
+	  if (grub_env_set (var->name, var->value) != GRUB_ERR_NONE)
+	    {
+	      grub_env_context_close ();
+	      return grub_errno;
+	    }
+	  grub_env_export (var->name);
+	  grub_register_variable_hook (var->name, var->read_hook, var->write_hook);
+	}
     }
 
   return GRUB_ERR_NONE;
@@ -115,7 +118,7 @@ grub_err_t
 grub_env_context_close (void)
 {
   struct grub_env_context *context;
-  int i;
+  grub_size_t i;
   struct menu_pointer *menu;
 
   if (! grub_current_context->prev)
@@ -123,23 +126,23 @@ grub_env_context_close (void)
 		       "cannot close the initial context");
 
   /* Free the variables associated with this context.  */
-  for (i = 0; i < HASHSZ; i++)
+  for (i = 0; i < grub_current_context->nslots; i++)
     {
-      struct grub_env_var *p, *q;
+      struct grub_env_var *p = grub_current_context->vars[i];
 
-      for (p = grub_current_context->vars[i]; p; p = q)
-	{
-	  q = p->next;
-          grub_free (p->name);
-	  grub_free (p->value);
-	  grub_free (p);
-	}
+      if (! p || p == &grub_env_tombstone)
+	continue;
+      grub_free (p->name);
+      grub_free (p->value);
+      grub_free (p);
     }
+  grub_free (grub_current_context->vars);
 
   /* Restore the previous context.  */
   context = grub_current_context->prev;
   grub_free (grub_current_context);
   grub_current_context = context;
+  grub_env_hot_reset ();
 
   menu = current_menu->prev;
   if (current_menu->menu)
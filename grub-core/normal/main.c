@@ -80,6 +80,7 @@ grub_normal_free_menu (grub_menu_t menu)
       grub_free ((void *) entry->users);
       grub_free ((void *) entry->title);
       grub_free ((void *) entry->sourcecode);
+      grub_script_preparse_free (entry->preparsed);
       grub_free (entry);
       entry = next_entry;
     }
@@ -88,6 +89,57 @@ grub_normal_free_menu (grub_menu_t menu)
   grub_env_unset_menu ();
 }
 
+/* Serves lines out of a config file slurped into memory, so that
+   parsing does not issue one grub_file_read call per byte.  */
+struct config_buf_ctx
+{
+  char *buf;
+  grub_size_t pos;
+  grub_size_t size;
+};
+
+/* Helper for read_config_file.  */
+static grub_err_t
+read_config_buf_getline (char **line, int cont __attribute__ ((unused)),
+			 void *data)
+{
+  struct config_buf_ctx *ctx = data;
+
+  while (ctx->pos < ctx->size)
+    {
+      grub_size_t start = ctx->pos, first, i, j;
+      char *out;
+
+      while (ctx->pos < ctx->size && ctx->buf[ctx->pos] != '\n')
+	ctx->pos++;
+      first = ctx->pos;
+      if (ctx->pos < ctx->size)
+	ctx->pos++;
+
+      /* Skip comment lines, ignoring carriage returns like
+	 read_config_file_getline does.  */
+      for (i = start; i < first && ctx->buf[i] == '\r'; i++);
+      if (i < first && ctx->buf[i] == '#')
+	continue;
+
+      out = grub_malloc (first - start + 1);
+      if (!out)
+	{
+	  *line = 0;
+	  return grub_errno;
+	}
+      for (i = start, j = 0; i < first; i++)
+	if (ctx->buf[i] != '\r')
+	  out[j++] = ctx->buf[i];
+      out[j] = '\0';
+      *line = out;
+      return GRUB_ERR_NONE;
+    }
+
+  *line = 0;
+  return GRUB_ERR_NONE;
+}
+
 /* Helper for read_config_file.  */
 static grub_err_t
 read_config_file_getline (char **line, int cont __attribute__ ((unused)),
@@ -119,6 +171,8 @@ read_config_file (const char *config)
   char *old_file = 0, *old_dir = 0;
   char *config_dir, *ptr = 0;
   const char *ctmp;
+  char *filebuf = NULL;
+  struct config_buf_ctx bctx;
 
   grub_menu_t newmenu;
 
@@ -174,6 +228,31 @@ read_config_file (const char *config)
   grub_env_export ("config_file");
   grub_env_export ("config_directory");
 
+  /* Pull the whole config in with one read when its size is known and
+     reasonable; reading it line by line costs a grub_file_read call
+     per byte.  On failure fall back to the streaming path.  */
+  if (grub_file_size (file) != GRUB_FILE_SIZE_UNKNOWN
+      && grub_file_size (file) <= 0x100000)
+    {
+      grub_size_t filesize = grub_file_size (file);
+
+      filebuf = grub_malloc (filesize + 1);
+      if (filebuf
+	  && grub_file_read (file, filebuf, filesize)
+	     != (grub_ssize_t) filesize)
+	{
+	  grub_free (filebuf);
+	  filebuf = NULL;
+	}
+      if (filebuf)
+	{
+	  bctx.buf = filebuf;
+	  bctx.pos = 0;
+	  bctx.size = filesize;
+	}
+      grub_errno = GRUB_ERR_NONE;
+    }
+
   while (1)
     {
       char *line;
@@ -182,12 +261,21 @@ read_config_file (const char *config)
       grub_print_error ();
       grub_errno = GRUB_ERR_NONE;
 
-      if ((read_config_file_getline (&line, 0, file)) || (! line))
-	break;
-
-      grub_normal_parse_line (line, read_config_file_getline, file);
+      if (filebuf)
+	{
+	  if ((read_config_buf_getline (&line, 0, &bctx)) || (! line))
+	    break;
+	  grub_normal_parse_line (line, read_config_buf_getline, &bctx);
+	}
+      else
+	{
+	  if ((read_config_file_getline (&line, 0, file)) || (! line))
+	    break;
+	  grub_normal_parse_line (line, read_config_file_getline, file);
+	}
       grub_free (line);
     }
+  grub_free (filebuf);
 
   if (old_file)
     grub_env_set ("config_file", old_file);
@@ -280,7 +368,7 @@ grub_normal_execute (const char *config, int nested, int batch)
       grub_register_variable_hook ("prefix", NULL, read_lists_hook);
     }
 
-  grub_boot_time ("Executing config file");
+  grub_boot_time_enter ("Executing config file");
 
   if (config)
     {
@@ -306,7 +394,7 @@ grub_normal_execute (const char *config, int nested, int batch)
       grub_errno = GRUB_ERR_NONE;
     }
 
-  grub_boot_time ("Executed config file");
+  grub_boot_time_exit ("Executed config file");
 
   if (! batch)
     {
@@ -325,7 +413,7 @@ grub_normal_execute (const char *config, int nested, int batch)
 void
 grub_enter_normal_mode (const char *config)
 {
-  grub_boot_time ("Entering normal mode");
+  grub_boot_time_enter ("Entering normal mode");
   nested_level++;
   grub_normal_execute (config, 0, 0);
   grub_boot_time ("Entering shell");
@@ -333,7 +421,7 @@ grub_enter_normal_mode (const char *config)
   nested_level--;
   if (grub_normal_exit_level)
     grub_normal_exit_level--;
-  grub_boot_time ("Exiting normal mode");
+  grub_boot_time_exit ("Exiting normal mode");
 }
 
 static grub_err_t
@@ -618,7 +706,7 @@ GRUB_MOD_INIT(normal)
 {
   unsigned i;
 
-  grub_boot_time ("Preparing normal module");
+  grub_boot_time_enter ("Preparing normal module");
 
   /* Previously many modules depended on gzio. Be nice to user and load it.  */
   grub_dl_load ("gzio");
@@ -673,7 +761,7 @@ GRUB_MOD_INIT(normal)
   grub_env_set ("grub_platform", GRUB_PLATFORM);
   grub_env_export ("grub_platform");
 
-  grub_boot_time ("Normal module prepared");
+  grub_boot_time_exit ("Normal module prepared");
 }
 
 GRUB_MOD_FINI(normal)
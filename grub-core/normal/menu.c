@@ -19,6 +19,7 @@
 
 #include <grub/normal.h>
 #include <grub/misc.h>
+#include <grub/file.h>
 #include <grub/loader.h>
 #include <grub/mm.h>
 #include <grub/time.h>
@@ -69,7 +70,8 @@ grub_wait_after_message (void)
   endtime = grub_get_time_ms () + 10000;
 
   while (grub_get_time_ms () < endtime
-	 && grub_getkey_noblock () == GRUB_TERM_NO_KEY);
+	 && grub_getkey_noblock () == GRUB_TERM_NO_KEY)
+    grub_term_poll_pause ();
 
   grub_xputs ("\n");
 }
@@ -284,6 +286,169 @@ get_and_remove_first_entry_number (grub_menu_t menu, const char *name)
   return entry;
 }
 
+/* Parse ENTRY's body ahead of selection so that choosing it pays no
+   lex+parse cost.  Failures simply leave the entry on the interleaved
+   parse+execute path, which reports the error at the right point.  */
+static void
+menu_entry_preparse (grub_menu_entry_t entry)
+{
+  if (entry->preparse_tried)
+    return;
+  entry->preparse_tried = 1;
+  entry->preparsed = grub_script_preparse_sourcecode (entry->sourcecode);
+  if (! entry->preparsed)
+    grub_errno = GRUB_ERR_NONE;
+}
+
+/* Idle task hook pre-parsing one not-yet-visited entry per key poll,
+   so the parsing happens during the timeout countdown instead of at
+   selection time.  DATA points at the cursor into the entry list.  */
+static int
+menu_preparse_idle (void *data)
+{
+  grub_menu_entry_t *e = data;
+
+  while (*e && (*e)->preparse_tried)
+    *e = (*e)->next;
+  if (! *e)
+    return 1;
+  menu_entry_preparse (*e);
+  *e = (*e)->next;
+  return *e == NULL;
+}
+
+/* Speculative preload of the default entry's kernel and initrd.
+   While the menu counts down, pull the files the entry will most
+   likely open through the disk cache, so the boot that follows hits
+   warm blocks instead of waiting on the medium.  Only plain path
+   arguments are considered; anything needing expansion would require
+   executing the entry.  */
+
+#define MENU_PRELOAD_MAX_FILES	4
+#define MENU_PRELOAD_CHUNK	0x10000
+
+struct menu_preload_state
+{
+  char *paths[MENU_PRELOAD_MAX_FILES];
+  unsigned npaths;
+  unsigned cur;
+  grub_file_t file;
+  char *buf;
+};
+
+/* Return the first argument in P if it is a plain word starting a
+   path, else NULL.  */
+static char *
+menu_preload_extract_path (const char *p)
+{
+  const char *start;
+  grub_size_t len;
+
+  while (*p == ' ' || *p == '\t')
+    p++;
+  start = p;
+  while (*p && *p != ' ' && *p != '\t' && *p != '\n' && *p != ';'
+	 && *p != '#')
+    {
+      if (*p == '$' || *p == '"' || *p == '\'' || *p == '`' || *p == '\\')
+	return NULL;
+      p++;
+    }
+  len = p - start;
+  if (len == 0 || (start[0] != '/' && start[0] != '('))
+    return NULL;
+  return grub_strndup (start, len);
+}
+
+/* Collect preloadable file arguments of load commands in SOURCE.  */
+static void
+menu_preload_scan (struct menu_preload_state *st, const char *source)
+{
+  static const char *const loads[] =
+    { "linux", "linux16", "initrd", "initrd16", NULL };
+
+  while (*source && st->npaths < MENU_PRELOAD_MAX_FILES)
+    {
+      const char *eol = grub_strchr (source, '\n');
+      const char *p = source;
+      int i;
+
+      while (*p == ' ' || *p == '\t')
+	p++;
+      for (i = 0; loads[i]; i++)
+	{
+	  grub_size_t wl = grub_strlen (loads[i]);
+
+	  if (grub_strncmp (p, loads[i], wl) == 0
+	      && (p[wl] == ' ' || p[wl] == '\t'))
+	    {
+	      char *path = menu_preload_extract_path (p + wl);
+
+	      if (path)
+		st->paths[st->npaths++] = path;
+	      break;
+	    }
+	}
+      if (! eol)
+	break;
+      source = eol + 1;
+    }
+}
+
+/* Idle task hook streaming one chunk of the next pending file per key
+   poll.  The data itself is thrown away; the reads warm the disk
+   cache.  Failures are ignored: the real boot will report them.  */
+static int
+menu_preload_idle (void *data)
+{
+  struct menu_preload_state *st = data;
+
+  if (st->file == NULL)
+    {
+      if (st->cur >= st->npaths)
+	return 1;
+      if (st->buf == NULL)
+	st->buf = grub_malloc (MENU_PRELOAD_CHUNK);
+      if (st->buf == NULL)
+	{
+	  grub_errno = GRUB_ERR_NONE;
+	  return 1;
+	}
+      st->file = grub_file_open (st->paths[st->cur],
+				 GRUB_FILE_TYPE_NONE
+				 | GRUB_FILE_TYPE_SKIP_SIGNATURE);
+      if (st->file == NULL)
+	{
+	  grub_errno = GRUB_ERR_NONE;
+	  st->cur++;
+	  return st->cur >= st->npaths;
+	}
+    }
+
+  if (grub_file_read (st->file, st->buf, MENU_PRELOAD_CHUNK)
+      < MENU_PRELOAD_CHUNK)
+    {
+      grub_errno = GRUB_ERR_NONE;
+      grub_file_close (st->file);
+      st->file = NULL;
+      st->cur++;
+    }
+
+  return st->cur >= st->npaths;
+}
+
+static void
+menu_preload_fini (struct menu_preload_state *st)
+{
+  unsigned i;
+
+  if (st->file)
+    grub_file_close (st->file);
+  for (i = 0; i < st->npaths; i++)
+    grub_free (st->paths[i]);
+  grub_free (st->buf);
+}
+
 /* Run a menu entry.  */
 static grub_err_t
 grub_menu_execute_entry(grub_menu_entry_t entry, int auto_boot)
@@ -376,7 +541,14 @@ grub_menu_execute_entry(grub_menu_entry_t entry, int auto_boot)
   if (ptr && ptr[0] && ptr[1])
     grub_env_set ("default", ptr + 1);
 
-  grub_script_execute_new_scope (entry->sourcecode, entry->argc, entry->args);
+  menu_entry_preparse (entry);
+  if (entry->preparsed)
+    grub_script_execute_preparsed_new_scope (entry->sourcecode,
+					     entry->preparsed,
+					     entry->argc, entry->args);
+  else
+    grub_script_execute_new_scope (entry->sourcecode, entry->argc,
+				   entry->args);
 
   if (errs_before != grub_err_printed_errors)
     grub_wait_after_message ();
@@ -606,7 +778,7 @@ print_countdown (struct grub_term_coordinate *pos, int n)
    entry to be executed is a result of an automatic default selection because
    of the timeout.  */
 static int
-run_menu (grub_menu_t menu, int nested, int *auto_boot, int *notify_boot)
+run_menu_int (grub_menu_t menu, int nested, int *auto_boot, int *notify_boot)
 {
   grub_uint64_t saved_time;
   int default_entry, current_entry;
@@ -663,6 +835,8 @@ run_menu (grub_menu_t menu, int nested, int *auto_boot, int *notify_boot)
 	      timeout = -1;
 	      break;
 	    }
+	  if (key == GRUB_TERM_NO_KEY)
+	    grub_term_poll_pause ();
 
 	  if (timeout > 0 && has_second_elapsed (&saved_time))
 	    {
@@ -732,6 +906,8 @@ run_menu (grub_menu_t menu, int nested, int *auto_boot, int *notify_boot)
 	}
 
       c = grub_getkey_noblock ();
+      if (c == GRUB_TERM_NO_KEY)
+	grub_term_poll_pause ();
 
       /* Negative values are returned on error. */
       if ((c != GRUB_TERM_NO_KEY) && (c > 0))
@@ -841,6 +1017,48 @@ run_menu (grub_menu_t menu, int nested, int *auto_boot, int *notify_boot)
   /* Never reach here.  */
 }
 
+/* Wrapper around run_menu_int keeping an idle task registered for the
+   duration of the menu, so entry bodies get pre-parsed while the menu
+   waits for input.  */
+static int
+run_menu (grub_menu_t menu, int nested, int *auto_boot, int *notify_boot)
+{
+  int ret, default_entry;
+  grub_menu_entry_t preparse_next = menu->entry_list;
+  grub_menu_entry_t def;
+  struct menu_preload_state preload_state = { { NULL }, 0, 0, NULL, NULL };
+  struct grub_idle_task preparse_task = {
+    .next = NULL,
+    .hook = menu_preparse_idle,
+    .data = &preparse_next,
+    .priority = 0
+  };
+  struct grub_idle_task preload_task = {
+    .next = NULL,
+    .hook = menu_preload_idle,
+    .data = &preload_state,
+    /* Below the pre-parser: parsing all entries is cheap and over
+       quickly, while streaming the default kernel takes a while.  */
+    .priority = -1
+  };
+
+  default_entry = get_entry_number (menu, "default");
+  if (default_entry < 0 || default_entry >= menu->size)
+    default_entry = 0;
+  def = grub_menu_get_entry (menu, default_entry);
+  if (def && ! def->restricted)
+    menu_preload_scan (&preload_state, def->sourcecode);
+
+  grub_idle_task_register (&preparse_task);
+  grub_idle_task_register (&preload_task);
+  ret = run_menu_int (menu, nested, auto_boot, notify_boot);
+  grub_idle_task_unregister (&preload_task);
+  grub_idle_task_unregister (&preparse_task);
+  menu_preload_fini (&preload_state);
+
+  return ret;
+}
+
 /* Callback invoked immediately before a menu entry is executed.  */
 static void
 notify_booting (grub_menu_entry_t entry, void *userdata)
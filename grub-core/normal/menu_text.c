@@ -41,6 +41,9 @@ struct menu_viewer_data
     TIMEOUT_TERSE,
     TIMEOUT_TERSE_NO_MARGIN
   } timeout_msg;
+  /* The timeout message shown by the previous tick, used to rewrite
+     only the cells that changed.  */
+  char *timeout_prev;
   grub_menu_t menu;
   struct grub_term_output *term;
 };
@@ -430,14 +433,23 @@ grub_menu_init_page (int nested, int edit,
     - geo->entry_width - 1;
 }
 
+/* Return whether MSG consists only of single-cell ASCII characters, so
+   byte offsets map directly to screen columns.  */
+static int
+timeout_msg_is_ascii (const char *msg)
+{
+  for (; *msg; msg++)
+    if ((unsigned char) *msg < 0x20 || (unsigned char) *msg >= 0x7f)
+      return 0;
+  return 1;
+}
+
 static void
 menu_text_print_timeout (int timeout, void *dataptr)
 {
   struct menu_viewer_data *data = dataptr;
   char *msg_translated = 0;
-
-  grub_term_gotoxy (data->term,
-		    (struct grub_term_coordinate) { 0, data->geo.timeout_y });
+  int margin_left;
 
   if (data->timeout_msg == TIMEOUT_TERSE
       || data->timeout_msg == TIMEOUT_TERSE_NO_MARGIN)
@@ -465,14 +477,52 @@ menu_text_print_timeout (int timeout, void *dataptr)
 	}
     }
 
-  grub_print_message_indented (msg_translated,
-			       data->timeout_msg == TIMEOUT_TERSE_NO_MARGIN ? 0 : 3,
-			       data->timeout_msg == TIMEOUT_TERSE_NO_MARGIN ? 0 : 1,
-			       data->term);
-  grub_free (msg_translated);
+  margin_left = data->timeout_msg == TIMEOUT_TERSE_NO_MARGIN ? 0 : 3;
+
+  /* Usually only the countdown digits change between ticks.  Rewriting
+     just the cells that differ keeps slow serial consoles from
+     blocking on a whole-line repaint every second; gotoxy emits cursor
+     addressing for the jump.  Restricted to single-line ASCII messages
+     where byte offsets equal columns.  */
+  if (data->timeout_prev
+      && (int) grub_strlen (msg_translated) + margin_left + 1
+	 < (int) grub_term_width (data->term)
+      && timeout_msg_is_ascii (msg_translated)
+      && timeout_msg_is_ascii (data->timeout_prev))
+    {
+      const char *o = data->timeout_prev;
+      const char *n = msg_translated;
+      grub_size_t olen = grub_strlen (o);
+      grub_size_t i = 0, j;
+
+      while (o[i] && o[i] == n[i])
+	i++;
+
+      if (o[i] || n[i])
+	{
+	  grub_term_gotoxy (data->term, (struct grub_term_coordinate)
+			    { margin_left + i, data->geo.timeout_y });
+	  for (j = i; n[j]; j++)
+	    grub_putcode (n[j], data->term);
+	  /* Blank out leftovers if the message got shorter.  */
+	  for (; j < olen; j++)
+	    grub_putcode (' ', data->term);
+	}
+    }
+  else
+    {
+      grub_term_gotoxy (data->term,
+			(struct grub_term_coordinate) { 0, data->geo.timeout_y });
+      grub_print_message_indented (msg_translated, margin_left,
+				   data->timeout_msg == TIMEOUT_TERSE_NO_MARGIN ? 0 : 1,
+				   data->term);
+    }
+
+  grub_free (data->timeout_prev);
+  data->timeout_prev = msg_translated;
 
   grub_term_gotoxy (data->term,
-		    (struct grub_term_coordinate) { 
+		    (struct grub_term_coordinate) {
 		      grub_term_cursor_x (&data->geo),
 			data->geo.first_entry_y + data->offset });
   grub_term_refresh (data->term);
@@ -519,6 +569,7 @@ menu_text_fini (void *dataptr)
 
   grub_term_setcursor (data->term, 1);
   grub_term_cls (data->term);
+  grub_free (data->timeout_prev);
   grub_free (data);
 }
 
@@ -528,6 +579,9 @@ menu_text_clear_timeout (void *dataptr)
   struct menu_viewer_data *data = dataptr;
   int i;
 
+  grub_free (data->timeout_prev);
+  data->timeout_prev = 0;
+
   for (i = 0; i < data->geo.timeout_lines;i++)
     {
       grub_term_gotoxy (data->term, (struct grub_term_coordinate) {
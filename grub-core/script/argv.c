@@ -57,6 +57,7 @@ grub_script_argv_free (struct grub_script_argv *argv)
   argv->argc = 0;
   argv->args = 0;
   argv->script = 0;
+  argv->arglen = 0;
 }
 
 /* Make argv from argc, args pair.  */
@@ -64,7 +65,7 @@ int
 grub_script_argv_make (struct grub_script_argv *argv, int argc, char **args)
 {
   int i;
-  struct grub_script_argv r = { 0, 0, 0 };
+  struct grub_script_argv r = { 0, 0, 0, 0 };
 
   for (i = 0; i < argc; i++)
     if (grub_script_argv_next (&r)
@@ -97,6 +98,7 @@ grub_script_argv_next (struct grub_script_argv *argv)
 
   argv->argc++;
   argv->args = p;
+  argv->arglen = 0;
 
   if (argv->argc == 1)
     argv->args[0] = 0;
@@ -116,20 +118,28 @@ grub_script_argv_append (struct grub_script_argv *argv, const char *s,
   if (! s)
     return 0;
 
-  a = p ? grub_strlen (p) : 0;
+  /* Tracking the length makes repeated appends linear; rescanning the
+     argument with grub_strlen here made them quadratic.  */
+  a = p ? argv->arglen : 0;
 
   if (grub_add (a, slen, &sz) ||
       grub_add (sz, 1, &sz) ||
       grub_mul (sz, sizeof (char), &sz))
     return 1;
 
-  p = grub_realloc (p, round_up_exp (sz));
-  if (! p)
-    return 1;
+  /* The buffer already holds round_up_exp (a + 1) bytes; only grow it
+     when the new length crosses into the next power of two.  */
+  if (! p || round_up_exp (sz) > round_up_exp (a + 1))
+    {
+      p = grub_realloc (p, round_up_exp (sz));
+      if (! p)
+	return 1;
+    }
 
   grub_memcpy (p + a, s, slen);
   p[a+slen] = 0;
   argv->args[argv->argc - 1] = p;
+  argv->arglen = a + slen;
 
   return 0;
 }
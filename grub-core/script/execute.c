@@ -211,7 +211,7 @@ grub_script_setparams (grub_command_t cmd __attribute__((unused)),
 		       int argc, char **args)
 {
   struct grub_script_scope *new_scope;
-  struct grub_script_argv argv = { 0, 0, 0 };
+  struct grub_script_argv argv = { 0, 0, 0, 0 };
 
   if (! scope)
     return GRUB_ERR_INVALID_COMMAND;
@@ -286,7 +286,7 @@ static char **
 grub_script_env_get (const char *name, grub_script_arg_type_t type)
 {
   unsigned i;
-  struct grub_script_argv result = { 0, 0, 0 };
+  struct grub_script_argv result = { 0, 0, 0, 0 };
 
   if (grub_script_argv_next (&result))
     goto fail;
@@ -656,7 +656,7 @@ grub_script_arglist_to_argv (struct grub_script_arglist *arglist,
   int i;
   char **values = 0;
   struct grub_script_arg *arg = 0;
-  struct grub_script_argv result = { 0, 0, 0 };
+  struct grub_script_argv result = { 0, 0, 0, 0 };
 
   if (arglist == NULL)
     return 1;
@@ -797,6 +797,7 @@ cleanup:
 
   result.argc = 0;
   result.args = 0;
+  result.arglen = 0;
   for (i = 0; unexpanded.args[i]; i++)
     {
       char **expansions = 0;
@@ -943,6 +944,85 @@ grub_script_execute_sourcecode (const char *source)
   return ret;
 }
 
+/* Parse all top-level statements of SOURCE ahead of execution,
+   chaining them through next_siblings.  Returns NULL if any statement
+   fails to parse; the caller should then fall back to
+   grub_script_execute_sourcecode so the statements before the bad one
+   still run when the error is reached.  */
+struct grub_script *
+grub_script_preparse_sourcecode (const char *source)
+{
+  struct grub_script *head = 0, **tail = &head;
+
+  while (source)
+    {
+      char *line;
+      struct grub_script *parsed;
+
+      grub_script_execute_sourcecode_getline (&line, 0, &source);
+      parsed = grub_script_parse
+	(line, grub_script_execute_sourcecode_getline, &source);
+      grub_free (line);
+      if (! parsed)
+	{
+	  grub_script_preparse_free (head);
+	  return 0;
+	}
+
+      *tail = parsed;
+      tail = &parsed->next_siblings;
+    }
+
+  return head;
+}
+
+/* Free a statement chain built by grub_script_preparse_sourcecode.  */
+void
+grub_script_preparse_free (struct grub_script *head)
+{
+  struct grub_script *next;
+
+  while (head)
+    {
+      next = head->next_siblings;
+      head->next_siblings = 0;
+      grub_script_unref (head);
+      head = next;
+    }
+}
+
+/* Execute a pre-parsed statement chain in a new scope.  SOURCE is the
+   original script text; it is only used for platform boot labels.  */
+grub_err_t
+grub_script_execute_preparsed_new_scope (const char *source,
+					 struct grub_script *head,
+					 int argc, char **args)
+{
+  grub_err_t ret = 0;
+  struct grub_script *s;
+  struct grub_script_scope new_scope;
+  struct grub_script_scope *old_scope;
+
+#ifdef GRUB_MACHINE_IEEE1275
+  grub_ieee1275_set_boot_last_label (source);
+#else
+  (void) source;
+#endif
+
+  new_scope.argv.argc = argc;
+  new_scope.argv.args = args;
+  new_scope.flags = 0;
+
+  old_scope = scope;
+  scope = &new_scope;
+
+  for (s = head; s; s = s->next_siblings)
+    ret = grub_script_execute (s);
+
+  scope = old_scope;
+  return ret;
+}
+
 /* Execute a source script in new scope.  */
 grub_err_t
 grub_script_execute_new_scope (const char *source, int argc, char **args)
@@ -978,7 +1058,7 @@ grub_script_execute_cmdline (struct grub_script_cmd *cmd)
   unsigned int i;
   char **args;
   int invert;
-  struct grub_script_argv argv = { 0, 0, 0 };
+  struct grub_script_argv argv = { 0, 0, 0, 0 };
 
   /* Lookup the command.  */
   if (grub_script_arglist_to_argv (cmdline->arglist, &argv) || ! argv.args || ! argv.args[0])
@@ -1154,7 +1234,7 @@ grub_script_execute_cmdfor (struct grub_script_cmd *cmd)
 {
   unsigned i;
   grub_err_t result;
-  struct grub_script_argv argv = { 0, 0, 0 };
+  struct grub_script_argv argv = { 0, 0, 0, 0 };
   struct grub_script_cmdfor *cmdfor = (struct grub_script_cmdfor *) cmd;
 
   if (grub_script_arglist_to_argv (cmdfor->words, &argv))
@@ -32,45 +32,106 @@
    allocations.  The memory is freed in case of an error, or assigned
    to the parsed script when parsing was successful.
 
-   In case of the normal malloc, some additional bytes are allocated
-   for this datastructure.  All reserved memory is stored in a linked
-   list so it can be easily freed.  The original memory can be found
-   from &mem.  */
+   Each recording is backed by an arena, so the many small parse nodes
+   are bump-allocated from shared chunks and released in one pass
+   instead of being tracked (and later freed) one by one.  */
+/* Generated configurations repeat the same words (command names,
+   option switches, device strings) thousands of times; intern the
+   argument strings per recording so each distinct spelling is stored
+   once in the arena.  Sharing within one recording is safe: argument
+   strings are never modified in place and live exactly as long as the
+   recording's arena.  */
+#define GRUB_SCRIPT_INTERN_BUCKETS	64
+
+struct grub_script_intern_entry
+{
+  struct grub_script_intern_entry *next;
+  char *str;
+};
+
 struct grub_script_mem
 {
-  struct grub_script_mem *next;
-  char mem;
+  struct grub_arena arena;
+  struct grub_script_intern_entry *interned[GRUB_SCRIPT_INTERN_BUCKETS];
 };
 
-/* Return malloc'ed memory and keep track of the allocation.  */
+static struct grub_script_mem *
+grub_script_mem_get (struct grub_parser_param *state)
+{
+  if (!state->memused)
+    {
+      state->memused = grub_zalloc (sizeof (*state->memused));
+      if (!state->memused)
+	return 0;
+      grub_arena_init (&state->memused->arena, 0);
+    }
+
+  return state->memused;
+}
+
+/* Return memory from the current recording's arena.  */
 void *
 grub_script_malloc (struct grub_parser_param *state, grub_size_t size)
+{
+  struct grub_script_mem *mem = grub_script_mem_get (state);
+
+  if (!mem)
+    return 0;
+
+  return grub_arena_alloc (&mem->arena, size);
+}
+
+/* Return the recording's unique arena copy of STR.  */
+static char *
+grub_script_intern_string (struct grub_parser_param *state, const char *str)
 {
   struct grub_script_mem *mem;
-  mem = (struct grub_script_mem *) grub_malloc (size + sizeof (*mem)
-						- sizeof (char));
+  struct grub_script_intern_entry *ent;
+  grub_uint32_t hash = 5381;
+  const char *p;
+  grub_size_t len;
+  char *copy;
+
+  mem = grub_script_mem_get (state);
   if (!mem)
     return 0;
 
-  grub_dprintf ("scripting", "malloc %p\n", mem);
-  mem->next = state->memused;
-  state->memused = mem;
-  return (void *) &mem->mem;
+  for (p = str; *p; p++)
+    hash = hash * 33 + (grub_uint8_t) *p;
+  len = p - str + 1;
+
+  for (ent = mem->interned[hash % GRUB_SCRIPT_INTERN_BUCKETS]; ent;
+       ent = ent->next)
+    if (grub_strcmp (ent->str, str) == 0)
+      return ent->str;
+
+  copy = grub_arena_alloc (&mem->arena, len);
+  if (!copy)
+    return 0;
+  grub_memcpy (copy, str, len);
+
+  /* The string is usable even if it cannot be indexed.  */
+  ent = grub_arena_alloc (&mem->arena, sizeof (*ent));
+  if (ent)
+    {
+      ent->str = copy;
+      ent->next = mem->interned[hash % GRUB_SCRIPT_INTERN_BUCKETS];
+      mem->interned[hash % GRUB_SCRIPT_INTERN_BUCKETS] = ent;
+    }
+
+  return copy;
 }
 
 /* Free all memory described by MEM.  */
 void
 grub_script_mem_free (struct grub_script_mem *mem)
 {
-  struct grub_script_mem *memfree;
+  if (!mem)
+    return;
 
-  while (mem)
-    {
-      memfree = mem->next;
-      grub_dprintf ("scripting", "free %p\n", mem);
-      grub_free (mem);
-      mem = memfree;
-    }
+  grub_dprintf ("scripting", "free %p\n", mem);
+  grub_arena_release (&mem->arena);
+  grub_free (mem);
 }
 
 /* Start recording memory usage.  Returns the memory that should be
@@ -128,7 +189,6 @@ grub_script_arg_add (struct grub_parser_param *state,
 {
   struct grub_script_arg *argpart;
   struct grub_script_arg *ll;
-  int len;
 
   argpart =
     (struct grub_script_arg *) grub_script_malloc (state, sizeof (*arg));
@@ -138,12 +198,10 @@ grub_script_arg_add (struct grub_parser_param *state,
   argpart->type = type;
   argpart->script = 0;
 
-  len = grub_strlen (str) + 1;
-  argpart->str = grub_script_malloc (state, len);
+  argpart->str = grub_script_intern_string (state, str);
   if (!argpart->str)
     return arg; /* argpart is freed later, during grub_script_free.  */
 
-  grub_memcpy (argpart->str, str, len);
   argpart->next = 0;
 
   if (!arg)
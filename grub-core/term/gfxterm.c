@@ -123,7 +123,15 @@ static struct grub_video_render_target *text_layer;
 
 struct grub_gfxterm_background grub_gfxterm_background;
 
-static struct grub_dirty_region dirty_region;
+/* Number of independently tracked dirty rectangles.  A single bounding
+   box would union updates that are far apart on screen (the blinking
+   cursor and fresh output, say) into one large rectangle, repainting
+   everything in between.  When all slots are taken a new rectangle is
+   merged into the one whose bounding box grows the least.  */
+#define DIRTY_REGION_SLOTS 4
+
+static struct grub_dirty_region dirty_regions[DIRTY_REGION_SLOTS];
+static unsigned int dirty_region_count;
 
 static void dirty_region_reset (void);
 
@@ -523,45 +531,81 @@ redraw_screen_rect (unsigned int x, unsigned int y,
 static void
 dirty_region_reset (void)
 {
-  dirty_region.top_left_x = -1;
-  dirty_region.top_left_y = -1;
-  dirty_region.bottom_right_x = -1;
-  dirty_region.bottom_right_y = -1;
+  dirty_region_count = 0;
   repaint_was_scheduled = 0;
 }
 
 static int
 dirty_region_is_empty (void)
 {
-  if ((dirty_region.top_left_x == -1)
-      || (dirty_region.top_left_y == -1)
-      || (dirty_region.bottom_right_x == -1)
-      || (dirty_region.bottom_right_y == -1))
-    return 1;
-  return 0;
+  return dirty_region_count == 0;
+}
+
+/* By how much the area of REGION would grow if it were extended to
+   also cover the rectangle with corners (X0, Y0) and (X1, Y1).  */
+static int
+dirty_region_growth (struct grub_dirty_region *region,
+                     int x0, int y0, int x1, int y1)
+{
+  int ux0 = x0 < region->top_left_x ? x0 : region->top_left_x;
+  int uy0 = y0 < region->top_left_y ? y0 : region->top_left_y;
+  int ux1 = x1 > region->bottom_right_x ? x1 : region->bottom_right_x;
+  int uy1 = y1 > region->bottom_right_y ? y1 : region->bottom_right_y;
+
+  return (ux1 - ux0 + 1) * (uy1 - uy0 + 1)
+    - ((region->bottom_right_x - region->top_left_x + 1)
+       * (region->bottom_right_y - region->top_left_y + 1));
 }
 
 static void
 dirty_region_add_real (int x, int y, unsigned int width, unsigned int height)
 {
-  if (dirty_region_is_empty ())
+  struct grub_dirty_region *region;
+  unsigned int i;
+  int x1 = x + (int) width - 1;
+  int y1 = y + (int) height - 1;
+
+  /* Updates to nearby pixels (consecutive characters on a line, the
+     area of an earlier update) extend the rectangle they touch;
+     unrelated updates get a rectangle of their own.  */
+  for (i = 0; i < dirty_region_count; i++)
     {
-      dirty_region.top_left_x = x;
-      dirty_region.top_left_y = y;
-      dirty_region.bottom_right_x = x + width - 1;
-      dirty_region.bottom_right_y = y + height - 1;
+      region = &dirty_regions[i];
+      if (x <= region->bottom_right_x + 1
+          && x1 >= region->top_left_x - 1
+          && y <= region->bottom_right_y + 1
+          && y1 >= region->top_left_y - 1)
+        break;
     }
-  else
+
+  if (i == dirty_region_count)
     {
-      if (x < dirty_region.top_left_x)
-        dirty_region.top_left_x = x;
-      if (y < dirty_region.top_left_y)
-        dirty_region.top_left_y = y;
-      if ((x + (int)width - 1) > dirty_region.bottom_right_x)
-        dirty_region.bottom_right_x = x + width - 1;
-      if ((y + (int)height - 1) > dirty_region.bottom_right_y)
-        dirty_region.bottom_right_y = y + height - 1;
+      if (dirty_region_count < DIRTY_REGION_SLOTS)
+        {
+          region = &dirty_regions[dirty_region_count++];
+          region->top_left_x = x;
+          region->top_left_y = y;
+          region->bottom_right_x = x1;
+          region->bottom_right_y = y1;
+          return;
+        }
+
+      /* All slots taken: merge into the one that grows the least.  */
+      region = &dirty_regions[0];
+      for (i = 1; i < dirty_region_count; i++)
+        if (dirty_region_growth (&dirty_regions[i], x, y, x1, y1)
+            < dirty_region_growth (region, x, y, x1, y1))
+          region = &dirty_regions[i];
     }
+
+  if (x < region->top_left_x)
+    region->top_left_x = x;
+  if (y < region->top_left_y)
+    region->top_left_y = y;
+  if (x1 > region->bottom_right_x)
+    region->bottom_right_x = x1;
+  if (y1 > region->bottom_right_y)
+    region->bottom_right_y = y1;
 }
 
 static void
@@ -592,24 +636,23 @@ dirty_region_add_virtualscreen (void)
 static void
 dirty_region_redraw (void)
 {
-  int x;
-  int y;
-  int width;
-  int height;
+  unsigned int i;
 
   if (dirty_region_is_empty ())
     return;
 
-  x = dirty_region.top_left_x;
-  y = dirty_region.top_left_y;
-
-  width = dirty_region.bottom_right_x - x + 1;
-  height = dirty_region.bottom_right_y - y + 1;
-
   if (repaint_was_scheduled && grub_gfxterm_decorator_hook)
     grub_gfxterm_decorator_hook ();
 
-  redraw_screen_rect (x, y, width, height);
+  for (i = 0; i < dirty_region_count; i++)
+    {
+      int x = dirty_regions[i].top_left_x;
+      int y = dirty_regions[i].top_left_y;
+      int width = dirty_regions[i].bottom_right_x - x + 1;
+      int height = dirty_regions[i].bottom_right_y - y + 1;
+
+      redraw_screen_rect (x, y, width, height);
+    }
 }
 
 static inline void
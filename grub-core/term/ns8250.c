@@ -126,6 +126,16 @@ do_real_config (struct grub_serial_port *port)
       grub_outb (UART_ENABLE_DTRRTS | UART_ENABLE_OUT2, port->port + UART_MCR);
     }
 
+  /* Check whether the FIFO actually enabled (bits 6-7 of IIR are set
+     on a 16550A or later).  If it did, a full FIFO worth of bytes can
+     be written every time the transmitter reports empty.  */
+  if ((grub_inb (port->port + UART_IIR) & UART_FIFO_PRESENT)
+      == UART_FIFO_PRESENT)
+    port->tx_fifo_depth = 16;
+  else
+    port->tx_fifo_depth = 1;
+  port->tx_fifo_left = 0;
+
   /* Drain the input buffer.  */
   endtime = grub_get_time_ms () + 1000;
   while (grub_inb (port->port + UART_LSR) & UART_DATA_READY)
@@ -160,6 +170,16 @@ serial_hw_put (struct grub_serial_port *port, const int c)
 
   do_real_config (port);
 
+  /* UART_EMPTY_TRANSMITTER means the whole TX FIFO has drained, so a
+     burst of its depth can be stuffed without polling the LSR for
+     every byte.  */
+  if (port->tx_fifo_left > 0)
+    {
+      port->tx_fifo_left--;
+      grub_outb (c, port->port + UART_TX);
+      return;
+    }
+
   if (port->broken > 5)
     endtime = grub_get_time_ms ();
   else if (port->broken > 1)
@@ -180,9 +200,22 @@ serial_hw_put (struct grub_serial_port *port, const int c)
   if (port->broken)
     port->broken--;
 
+  port->tx_fifo_left = port->tx_fifo_depth - 1;
   grub_outb (c, port->port + UART_TX);
 }
 
+/* Report whether a character can be put without waiting.  */
+static int
+serial_hw_tx_ready (struct grub_serial_port *port)
+{
+  do_real_config (port);
+
+  if (port->tx_fifo_left > 0)
+    return 1;
+
+  return (grub_inb (port->port + UART_LSR) & UART_EMPTY_TRANSMITTER) != 0;
+}
+
 /* Initialize a serial device. PORT is the port number for a serial device.
    SPEED is a DTE-DTE speed which must be one of these: 2400, 4800, 9600,
    19200, 38400, 57600 and 115200. WORD_LEN is the word length to be used
@@ -228,7 +261,8 @@ struct grub_serial_driver grub_ns8250_driver =
   {
     .configure = serial_hw_configure,
     .fetch = serial_hw_fetch,
-    .put = serial_hw_put
+    .put = serial_hw_put,
+    .tx_ready = serial_hw_tx_ready
   };
 
 static char com_names[GRUB_SERIAL_PORT_NUM][20];
@@ -79,17 +79,101 @@ struct grub_serial_input_state
   struct grub_serial_port *port;
 };
 
-static void 
+/* Software TX ring size.  A text menu redraw over terminfo is a few
+   kilobytes, so one frame normally fits and never blocks mid-draw.  */
+#define GRUB_SERIAL_TXBUF_SIZE	4096
+
+/* Push out queued bytes for as long as the transmitter accepts them
+   without waiting.  */
+static void
+serial_txbuf_flush (struct grub_serial_port *port)
+{
+  while (port->txbuf_len > 0 && port->driver->tx_ready (port))
+    {
+      port->driver->put (port, port->txbuf[port->txbuf_start]);
+      port->txbuf_start = (port->txbuf_start + 1) % GRUB_SERIAL_TXBUF_SIZE;
+      port->txbuf_len--;
+    }
+}
+
+/* Push out all queued bytes, waiting on the transmitter as needed.  */
+static void
+serial_txbuf_drain (struct grub_serial_port *port)
+{
+  while (port->txbuf_len > 0)
+    {
+      port->driver->put (port, port->txbuf[port->txbuf_start]);
+      port->txbuf_start = (port->txbuf_start + 1) % GRUB_SERIAL_TXBUF_SIZE;
+      port->txbuf_len--;
+    }
+}
+
+static void
 serial_put (grub_term_output_t term, const int c)
 {
   struct grub_serial_output_state *data = term->data;
-  data->port->driver->put (data->port, c);
+  struct grub_serial_port *port = data->port;
+
+  /* Drivers without readiness polling keep the old synchronous path,
+     as does output before the heap is up.  */
+  if (!port->driver->tx_ready)
+    {
+      port->driver->put (port, c);
+      return;
+    }
+
+  serial_txbuf_flush (port);
+
+  if (port->txbuf_len == 0 && port->driver->tx_ready (port))
+    {
+      port->driver->put (port, c);
+      return;
+    }
+
+  if (!port->txbuf)
+    {
+      port->txbuf = grub_malloc (GRUB_SERIAL_TXBUF_SIZE);
+      if (!port->txbuf)
+	{
+	  grub_errno = GRUB_ERR_NONE;
+	  port->driver->put (port, c);
+	  return;
+	}
+    }
+
+  /* Ring full: wait for one byte to go out rather than dropping.  A
+     dropped byte in the middle of an escape sequence would desync the
+     remote terminal.  */
+  if (port->txbuf_len == GRUB_SERIAL_TXBUF_SIZE)
+    {
+      port->driver->put (port, port->txbuf[port->txbuf_start]);
+      port->txbuf_start = (port->txbuf_start + 1) % GRUB_SERIAL_TXBUF_SIZE;
+      port->txbuf_len--;
+    }
+
+  port->txbuf[(port->txbuf_start + port->txbuf_len)
+	      % GRUB_SERIAL_TXBUF_SIZE] = c;
+  port->txbuf_len++;
+}
+
+static void
+serial_refresh (grub_term_output_t term)
+{
+  struct grub_serial_output_state *data = term->data;
+
+  serial_txbuf_drain (data->port);
 }
 
 static int
 serial_fetch (grub_term_input_t term)
 {
   struct grub_serial_input_state *data = term->data;
+
+  /* Input is polled from idle loops; use the chance to push out
+     queued output.  */
+  if (data->port->txbuf_len > 0)
+    serial_txbuf_flush (data->port);
+
   return data->port->driver->fetch (data->port);
 }
 
@@ -135,6 +219,7 @@ static struct grub_term_output grub_serial_term_output =
   .cls = grub_terminfo_cls,
   .setcolorstate = grub_terminfo_setcolorstate,
   .setcursor = grub_terminfo_setcursor,
+  .refresh = serial_refresh,
   .flags = GRUB_TERM_CODE_TYPE_ASCII,
   .data = &grub_serial_terminfo_output,
   .progress_update_divisor = GRUB_PROGRESS_SLOW
@@ -370,6 +455,10 @@ grub_serial_register (struct grub_serial_port *port)
   out->name = in->name;
   grub_memcpy (outdata, &grub_serial_terminfo_output, sizeof (*outdata));
 
+  port->txbuf = NULL;
+  port->txbuf_start = 0;
+  port->txbuf_len = 0;
+
   grub_list_push (GRUB_AS_LIST_P (&grub_serial_ports), GRUB_AS_LIST (port));
   ((struct grub_serial_input_state *) in->data)->port = port;
   ((struct grub_serial_output_state *) out->data)->port = port;
@@ -398,6 +487,11 @@ grub_serial_register (struct grub_serial_port *port)
 void
 grub_serial_unregister (struct grub_serial_port *port)
 {
+  serial_txbuf_drain (port);
+  grub_free (port->txbuf);
+  port->txbuf = NULL;
+  port->txbuf_len = 0;
+
   if (port->driver->fini)
     port->driver->fini (port);
   
@@ -25,6 +25,7 @@
 #include <grub/mm.h>
 #include <grub/video.h>
 #include <grub/video_fb.h>
+#include <grub/env.h>
 #include <grub/efi/api.h>
 #include <grub/efi/efi.h>
 #include <grub/efi/edid.h>
@@ -390,7 +391,45 @@ grub_video_gop_setup (unsigned int width, unsigned int height,
 	  found = 1;
 	}
     }
- 
+
+  /* Try the mode a previous setup settled on before enumerating; a
+     single QueryMode call to validate it replaces one per mode.  */
+  if (!found)
+    {
+      const char *hint = grub_env_get ("gop_mode_hint");
+
+      if (hint)
+	{
+	  unsigned mode = grub_strtoul (hint, 0, 0);
+
+	  if (grub_errno == GRUB_ERR_NONE && mode < gop->mode->max_mode)
+	    {
+	      grub_efi_uintn_t size;
+	      grub_efi_status_t status;
+
+	      status = efi_call_4 (gop->query_mode, gop, mode, &size, &info);
+	      if (!status)
+		{
+		  bpp = grub_video_gop_get_bpp (info);
+		  if (bpp
+		      && !(preferred_width
+			   && (info->width > preferred_width
+			       || info->height > preferred_height))
+		      && ((info->width == width && info->height == height)
+			  || (width == 0 && height == 0))
+		      && (bpp == depth || depth == 0))
+		    {
+		      grub_dprintf ("video", "GOP: using hinted mode %d\n",
+				    mode);
+		      best_mode = mode;
+		      found = 1;
+		    }
+		}
+	    }
+	  grub_errno = GRUB_ERR_NONE;
+	}
+    }
+
   if (!found)
     {
       unsigned mode;
@@ -464,6 +503,15 @@ grub_video_gop_setup (unsigned int width, unsigned int height,
       efi_call_2 (gop->set_mode, gop, best_mode);
     }
 
+  /* Remember the winner for the next setup or, if the config saves
+     the environment, the next boot.  */
+  {
+    char hintbuf[16];
+
+    grub_snprintf (hintbuf, sizeof (hintbuf), "%u", best_mode);
+    grub_env_set ("gop_mode_hint", hintbuf);
+  }
+
   info = gop->mode->info;
 
   grub_video_gop_fill_mode_info (gop->mode->mode, info,
@@ -36,6 +36,8 @@ struct dirty
 {
   int first_line;
   int last_line;
+  int first_col;
+  int last_col;
 };
 
 static struct
@@ -830,15 +832,80 @@ grub_video_fb_unmap_color_int (struct grub_video_fbblit_info * source,
     }
 }
 
+/* Accumulate the bounding rectangle of the changed area; adjacent
+   updates coalesce into one box, and update_screen copies only the
+   box instead of whole frames.  */
 static void
-dirty (int y, int height)
+dirty (int x, int y, unsigned int width, unsigned int height)
 {
   if (framebuffer.render_target != framebuffer.back_target)
     return;
   if (framebuffer.current_dirty.first_line > y)
     framebuffer.current_dirty.first_line = y;
-  if (framebuffer.current_dirty.last_line < y + height)
-    framebuffer.current_dirty.last_line = y + height;
+  if (framebuffer.current_dirty.last_line < y + (int) height)
+    framebuffer.current_dirty.last_line = y + (int) height;
+  if (framebuffer.current_dirty.first_col > x)
+    framebuffer.current_dirty.first_col = x;
+  if (framebuffer.current_dirty.last_col < x + (int) width)
+    framebuffer.current_dirty.last_col = x + (int) width;
+}
+
+/* Reset the accumulated rectangle of D to empty.  */
+static void
+dirty_reset (struct dirty *d)
+{
+  d->first_line = framebuffer.back_target->mode_info.height;
+  d->last_line = 0;
+  d->first_col = framebuffer.back_target->mode_info.width;
+  d->last_col = 0;
+}
+
+/* Copy the rectangle D from the back target to PAGE.  */
+static grub_err_t
+doublebuf_copy_dirty (framebuf_t page, const struct dirty *d)
+{
+  struct grub_video_mode_info *mode_info = &framebuffer.back_target->mode_info;
+  int first_col, last_col;
+  grub_size_t copy_size;
+
+  if (d->first_line > d->last_line)
+    return GRUB_ERR_NONE;
+
+  first_col = d->first_col > 0 ? d->first_col : 0;
+  last_col = d->last_col < (int) mode_info->width
+    ? d->last_col : (int) mode_info->width;
+
+  if (first_col == 0 && last_col == (int) mode_info->width)
+    {
+      /* Full-width rectangle: one contiguous copy.  */
+      if (grub_sub (d->last_line, d->first_line, &copy_size) ||
+	  grub_mul (mode_info->pitch, copy_size, &copy_size))
+	{
+	  /* Shouldn't happen, but if it does we've a bug. */
+	  return GRUB_ERR_BUG;
+	}
+
+      grub_memcpy ((char *) page + d->first_line * mode_info->pitch,
+		   (char *) framebuffer.back_target->data
+		   + d->first_line * mode_info->pitch,
+		   copy_size);
+    }
+  else if (first_col < last_col)
+    {
+      grub_size_t row_skip = d->first_line * (grub_size_t) mode_info->pitch
+	+ first_col * (grub_size_t) mode_info->bytes_per_pixel;
+      grub_size_t row_size = (grub_size_t) (last_col - first_col)
+	* mode_info->bytes_per_pixel;
+      int y;
+
+      for (y = d->first_line; y < d->last_line;
+	   y++, row_skip += mode_info->pitch)
+	grub_memcpy ((char *) page + row_skip,
+		     (char *) framebuffer.back_target->data + row_skip,
+		     row_size);
+    }
+
+  return GRUB_ERR_NONE;
 }
 
 grub_err_t
@@ -896,7 +963,7 @@ grub_video_fb_fill_rect (grub_video_color_t color, int x, int y,
   x += area_x;
   y += area_y;
 
-  dirty (y, height);
+  dirty (x, y, width, height);
 
   /* Use fbblit_info to encapsulate rendering.  */
   target.mode_info = &framebuffer.render_target->mode_info;
@@ -1009,7 +1076,7 @@ grub_video_fb_blit_source (struct grub_video_fbblit_info *source,
   target.data = framebuffer.render_target->data;
 
   /* Do actual blitting.  */
-  dirty (y, height);
+  dirty (x, y, width, height);
   grub_video_fb_dispatch_blit (&target, source, oper, x, y, width, height,
                                offset_x, offset_y);
 
@@ -1061,7 +1128,9 @@ grub_video_fb_scroll (grub_video_color_t color, int dx, int dy)
   width = framebuffer.render_target->viewport.width - grub_abs (dx);
   height = framebuffer.render_target->viewport.height - grub_abs (dy);
 
-  dirty (framebuffer.render_target->viewport.y,
+  dirty (framebuffer.render_target->viewport.x,
+	 framebuffer.render_target->viewport.y,
+	 framebuffer.render_target->viewport.width,
 	 framebuffer.render_target->viewport.height);
 
   if (dx < 0)
@@ -1092,85 +1161,32 @@ grub_video_fb_scroll (grub_video_color_t color, int dx, int dy)
     {
       /* 3. Move data in render target.  */
       struct grub_video_fbblit_info target;
-      int i, j;
-      int linedelta, linelen;
+      grub_uint8_t *src, *dst;
+      grub_size_t pitch, linelen;
+      int j;
 
       target.mode_info = &framebuffer.render_target->mode_info;
       target.data = framebuffer.render_target->data;
 
-      linedelta = target.mode_info->pitch
-	- width * target.mode_info->bytes_per_pixel;
-      linelen = width * target.mode_info->bytes_per_pixel;
-#define DO_SCROLL                                                    \
-      /* Check vertical direction of the move.  */                   \
-      if (dy < 0 || (dy == 0 && dx < 0))                             \
-	{                                                            \
-	  dst = (void *) grub_video_fb_get_video_ptr (&target,       \
-						      dst_x, dst_y); \
-	  src = (void *) grub_video_fb_get_video_ptr (&target,	     \
-						      src_x, src_y); \
-	  /* 3a. Move data upwards.  */                              \
-	  for (j = 0; j < height; j++)                               \
-	    {                                                        \
-	      for (i = 0; i < linelen; i++)                          \
-		*(dst++) = *(src++);	                             \
-	      dst += linedelta;                                      \
-	      src += linedelta;                                      \
-	    }							     \
-	}                                                            \
-      else                                                           \
-	{                                                            \
-	  /* 3b. Move data downwards.  */                            \
-	  dst = (void *) grub_video_fb_get_video_ptr (&target,	     \
-					              dst_x + width, \
-					     dst_y + height - 1);    \
-	  src = (void *) grub_video_fb_get_video_ptr (&target,	     \
-					              src_x + width, \
-					     src_y + height - 1);    \
-	  dst--;                                                     \
-          src--;                                                     \
-	  for (j = 0; j < height; j++)                               \
-	    {                                                        \
-	      for (i = 0; i < linelen; i++)                          \
-		*(dst--) = *(src--);                                 \
-	      dst -= linedelta;                                      \
-	      src -= linedelta;                                      \
-	    }                                                        \
-	}
+      pitch = target.mode_info->pitch;
+      linelen = (grub_size_t) width * target.mode_info->bytes_per_pixel;
 
-      /* If everything is aligned on 32-bit use 32-bit copy.  */
-      if ((grub_addr_t) grub_video_fb_get_video_ptr (&target, src_x, src_y)
-	  % sizeof (grub_uint32_t) == 0
-	  && (grub_addr_t) grub_video_fb_get_video_ptr (&target, dst_x, dst_y) 
-	  % sizeof (grub_uint32_t) == 0
-	  && linelen % sizeof (grub_uint32_t) == 0
-	  && linedelta % sizeof (grub_uint32_t) == 0)
-	{
-	  grub_uint32_t *src, *dst;
-	  linelen /= sizeof (grub_uint32_t);
-	  linedelta /= sizeof (grub_uint32_t);
-	  DO_SCROLL
-	}
-      /* If everything is aligned on 16-bit use 16-bit copy.  */
-      else if ((grub_addr_t) grub_video_fb_get_video_ptr (&target, src_x, src_y)
-	       % sizeof (grub_uint16_t) == 0
-	       && (grub_addr_t) grub_video_fb_get_video_ptr (&target,
-							     dst_x, dst_y) 
-	       % sizeof (grub_uint16_t) == 0
-	       && linelen % sizeof (grub_uint16_t) == 0
-	       && linedelta % sizeof (grub_uint16_t) == 0)
-	{
-	  grub_uint16_t *src, *dst;
-	  linelen /= sizeof (grub_uint16_t);
-	  linedelta /= sizeof (grub_uint16_t);
-	  DO_SCROLL
-	}
-      /* If not aligned at all use 8-bit copy.  */
+      dst = (void *) grub_video_fb_get_video_ptr (&target, dst_x, dst_y);
+      src = (void *) grub_video_fb_get_video_ptr (&target, src_x, src_y);
+
+      if (linelen == pitch)
+	/* The rows are contiguous: move everything in one bulk copy.  */
+	grub_memmove (dst, src, (grub_size_t) height * pitch);
+      else if (dy < 0 || (dy == 0 && dx < 0))
+	/* 3a. Move data upwards, row by row.  */
+	for (j = 0; j < height; j++, dst += pitch, src += pitch)
+	  grub_memmove (dst, src, linelen);
       else
-	{
-	  grub_uint8_t *src, *dst;
-	  DO_SCROLL
-	}	
+	/* 3b. Move data downwards, starting from the last row so that
+	   overlapping source rows are read before being overwritten.  */
+	for (j = height - 1; j >= 0; j--)
+	  grub_memmove (dst + (grub_size_t) j * pitch,
+			src + (grub_size_t) j * pitch, linelen);
     }
 
   /* 4. Fill empty space with specified color.  In this implementation
@@ -1416,30 +1432,13 @@ grub_video_fb_get_active_render_target (struct grub_video_fbrender_target **targ
 static grub_err_t
 doublebuf_blit_update_screen (void)
 {
-  if (framebuffer.current_dirty.first_line
-      <= framebuffer.current_dirty.last_line)
-    {
-      grub_size_t copy_size;
-
-      if (grub_sub (framebuffer.current_dirty.last_line,
-		    framebuffer.current_dirty.first_line, &copy_size) ||
-	  grub_mul (framebuffer.back_target->mode_info.pitch, copy_size, &copy_size))
-	{
-	  /* Shouldn't happen, but if it does we've a bug. */
-	  return GRUB_ERR_BUG;
-	}
+  grub_err_t err;
 
-      grub_memcpy ((char *) framebuffer.pages[0] + framebuffer.current_dirty.first_line *
-		   framebuffer.back_target->mode_info.pitch,
-		   (char *) framebuffer.back_target->data + framebuffer.current_dirty.first_line *
-		   framebuffer.back_target->mode_info.pitch,
-		   copy_size);
-    }
-  framebuffer.current_dirty.first_line
-    = framebuffer.back_target->mode_info.height;
-  framebuffer.current_dirty.last_line = 0;
+  err = doublebuf_copy_dirty (framebuffer.pages[0],
+			      &framebuffer.current_dirty);
+  dirty_reset (&framebuffer.current_dirty);
 
-  return GRUB_ERR_NONE;
+  return err;
 }
 
 static grub_err_t
@@ -1470,8 +1469,7 @@ grub_video_fb_doublebuf_blit_init (struct grub_video_fbrender_target **back,
   framebuffer.pages[0] = framebuf;
   framebuffer.displayed_page = 0;
   framebuffer.render_page = 0;
-  framebuffer.current_dirty.first_line = mode_info.height;
-  framebuffer.current_dirty.last_line = 0;
+  dirty_reset (&framebuffer.current_dirty);
 
   return GRUB_ERR_NONE;
 }
@@ -1481,37 +1479,27 @@ doublebuf_pageflipping_update_screen (void)
 {
   int new_displayed_page;
   grub_err_t err;
-  int first_line, last_line;
-
-  first_line = framebuffer.current_dirty.first_line;
-  last_line = framebuffer.current_dirty.last_line;
-  if (first_line > framebuffer.previous_dirty.first_line)
-    first_line = framebuffer.previous_dirty.first_line;
-  if (last_line < framebuffer.previous_dirty.last_line)
-    last_line = framebuffer.previous_dirty.last_line;
-
-  if (first_line <= last_line)
-    {
-      grub_size_t copy_size;
-
-      if (grub_sub (last_line, first_line, &copy_size) ||
-	  grub_mul (framebuffer.back_target->mode_info.pitch, copy_size, &copy_size))
-	{
-	  /* Shouldn't happen, but if it does we've a bug. */
-	  return GRUB_ERR_BUG;
-	}
-
-      grub_memcpy ((char *) framebuffer.pages[framebuffer.render_page] + first_line *
-		   framebuffer.back_target->mode_info.pitch,
-		   (char *) framebuffer.back_target->data + first_line *
-		   framebuffer.back_target->mode_info.pitch,
-		   copy_size);
-    }
+  struct dirty both;
+
+  /* The page we are about to show still has the content from two
+     swaps ago; take the union of the last two rectangles.  */
+  both = framebuffer.current_dirty;
+  if (both.first_line > framebuffer.previous_dirty.first_line)
+    both.first_line = framebuffer.previous_dirty.first_line;
+  if (both.last_line < framebuffer.previous_dirty.last_line)
+    both.last_line = framebuffer.previous_dirty.last_line;
+  if (both.first_col > framebuffer.previous_dirty.first_col)
+    both.first_col = framebuffer.previous_dirty.first_col;
+  if (both.last_col < framebuffer.previous_dirty.last_col)
+    both.last_col = framebuffer.previous_dirty.last_col;
+
+  err = doublebuf_copy_dirty (framebuffer.pages[framebuffer.render_page],
+			      &both);
+  if (err)
+    return err;
 
   framebuffer.previous_dirty = framebuffer.current_dirty;
-  framebuffer.current_dirty.first_line
-    = framebuffer.back_target->mode_info.height;
-  framebuffer.current_dirty.last_line = 0;
+  dirty_reset (&framebuffer.current_dirty);
 
   /* Swap the page numbers in the framebuffer struct.  */
   new_displayed_page = framebuffer.render_page;
@@ -1570,12 +1558,8 @@ doublebuf_pageflipping_init (struct grub_video_mode_info *mode_info,
   framebuffer.pages[0] = page0_ptr;
   framebuffer.pages[1] = page1_ptr;
 
-  framebuffer.current_dirty.first_line
-    = framebuffer.back_target->mode_info.height;
-  framebuffer.current_dirty.last_line = 0;
-  framebuffer.previous_dirty.first_line
-    = framebuffer.back_target->mode_info.height;
-  framebuffer.previous_dirty.last_line = 0;
+  dirty_reset (&framebuffer.current_dirty);
+  dirty_reset (&framebuffer.previous_dirty);
 
   /* Set the framebuffer memory data pointer and display the right page.  */
   err = set_page_in (framebuffer.displayed_page);
@@ -1661,9 +1645,7 @@ grub_video_fb_setup (unsigned int mode_type, unsigned int mode_mask,
   framebuffer.displayed_page = 0;
   framebuffer.render_page = 0;
   framebuffer.set_page = 0;
-  framebuffer.current_dirty.first_line
-    = framebuffer.back_target->mode_info.height;
-  framebuffer.current_dirty.last_line = 0;
+  dirty_reset (&framebuffer.current_dirty);
 
   mode_info->mode_type &= ~GRUB_VIDEO_MODE_TYPE_DOUBLE_BUFFERED;
 
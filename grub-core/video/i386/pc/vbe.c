@@ -29,6 +29,7 @@
 #include <grub/video.h>
 #include <grub/i386/pc/int.h>
 #include <grub/i18n.h>
+#include <grub/env.h>
 #include <grub/cpu/cpuid.h>
 
 GRUB_MOD_LICENSE ("GPLv3+");
@@ -1006,99 +1007,165 @@ grub_video_vbe_setup (unsigned int width, unsigned int height,
 	}
     }
 
-  /* Walk thru mode list and try to find matching mode.  */
-  for (p = vbe_mode_list; *p != 0xFFFF; p++)
-    {
-      grub_uint32_t vbe_mode = *p;
-
-      grub_vbe_get_video_mode_info (vbe_mode, &vbe_mode_info);
-      if (grub_errno != GRUB_ERR_NONE)
-        {
-          /* Could not retrieve mode info, retreat.  */
-          grub_errno = GRUB_ERR_NONE;
-          break;
-        }
-
-      if ((vbe_mode_info.mode_attributes & GRUB_VBE_MODEATTR_SUPPORTED) == 0)
-        /* If not available, skip it.  */
-        continue;
-
-      if ((vbe_mode_info.mode_attributes & GRUB_VBE_MODEATTR_COLOR) == 0)
-        /* Monochrome is unusable.  */
-        continue;
-
-      if ((vbe_mode_info.mode_attributes & GRUB_VBE_MODEATTR_LFB_AVAIL) == 0)
-        /* We support only linear frame buffer modes.  */
-        continue;
-
-      if ((vbe_mode_info.mode_attributes & GRUB_VBE_MODEATTR_GRAPHICS) == 0)
-        /* We allow only graphical modes.  */
-        continue;
-
-      if ((vbe_mode_info.memory_model != GRUB_VBE_MEMORY_MODEL_PACKED_PIXEL)
-          && (vbe_mode_info.memory_model != GRUB_VBE_MEMORY_MODEL_DIRECT_COLOR))
-        /* Not compatible memory model.  */
-        continue;
+  /* The mode chosen on an earlier call (or an earlier boot, if the
+     config loads and saves the environment) can be tried directly;
+     one mode-info BIOS call to validate it replaces one per
+     enumerated mode.  */
+  {
+    const char *hint = grub_env_get ("vbe_mode_hint");
 
-      if (vbe_mode_info.bits_per_pixel != 8
-	  && vbe_mode_info.bits_per_pixel != 15
-	  && vbe_mode_info.bits_per_pixel != 16
-	  && vbe_mode_info.bits_per_pixel != 24
-	  && vbe_mode_info.bits_per_pixel != 32)
-	/* Unsupported bitdepth . */
-        continue;
+    if (hint)
+      {
+	grub_uint32_t vbe_mode = grub_strtoul (hint, 0, 0);
+
+	if (grub_errno == GRUB_ERR_NONE)
+	  {
+	    grub_vbe_get_video_mode_info (vbe_mode, &vbe_mode_info);
+	    if (grub_errno == GRUB_ERR_NONE
+		&& (vbe_mode_info.mode_attributes
+		    & GRUB_VBE_MODEATTR_SUPPORTED)
+		&& (vbe_mode_info.mode_attributes & GRUB_VBE_MODEATTR_COLOR)
+		&& (vbe_mode_info.mode_attributes
+		    & GRUB_VBE_MODEATTR_LFB_AVAIL)
+		&& (vbe_mode_info.mode_attributes
+		    & GRUB_VBE_MODEATTR_GRAPHICS)
+		&& (vbe_mode_info.memory_model
+		    == GRUB_VBE_MEMORY_MODEL_PACKED_PIXEL
+		    || vbe_mode_info.memory_model
+		    == GRUB_VBE_MEMORY_MODEL_DIRECT_COLOR)
+		&& (vbe_mode_info.bits_per_pixel == 8
+		    || vbe_mode_info.bits_per_pixel == 15
+		    || vbe_mode_info.bits_per_pixel == 16
+		    || vbe_mode_info.bits_per_pixel == 24
+		    || vbe_mode_info.bits_per_pixel == 32)
+		&& (preferred_mode
+		    ? (vbe_mode_info.x_resolution <= width
+		       && vbe_mode_info.y_resolution <= height)
+		    : ((vbe_mode_info.x_resolution == width
+			&& vbe_mode_info.y_resolution == height)
+		       || (width == 0 && height == 0)))
+		&& (depth == 0 || vbe_mode_info.bits_per_pixel == depth))
+	      {
+		unsigned my_mode_type = 0;
+
+		if (vbe_mode_info.memory_model
+		    == GRUB_VBE_MEMORY_MODEL_PACKED_PIXEL)
+		  my_mode_type |= GRUB_VIDEO_MODE_TYPE_INDEX_COLOR;
+		if (vbe_mode_info.memory_model
+		    == GRUB_VBE_MEMORY_MODEL_DIRECT_COLOR)
+		  my_mode_type |= GRUB_VIDEO_MODE_TYPE_RGB;
+
+		if ((my_mode_type & mode_mask
+		     & (GRUB_VIDEO_MODE_TYPE_RGB
+			| GRUB_VIDEO_MODE_TYPE_INDEX_COLOR))
+		    == (mode_type & mode_mask
+			& (GRUB_VIDEO_MODE_TYPE_RGB
+			   | GRUB_VIDEO_MODE_TYPE_INDEX_COLOR)))
+		  {
+		    best_vbe_mode = vbe_mode;
+		    grub_memcpy (&best_vbe_mode_info, &vbe_mode_info,
+				 sizeof (vbe_mode_info));
+		  }
+	      }
+	  }
+	grub_errno = GRUB_ERR_NONE;
+      }
+  }
 
-      if (preferred_mode)
-	{
-	  if (vbe_mode_info.x_resolution > width
-	      || vbe_mode_info.y_resolution > height)
-	    /* Resolution exceeds that of preferred mode.  */
-	    continue;
-	}
-      else
-	{
-	  if (((vbe_mode_info.x_resolution != width)
-	       || (vbe_mode_info.y_resolution != height))
-	      && width != 0 && height != 0)
-	    /* Non matching resolution.  */
-	    continue;
-	}
+  /* Walk thru mode list and try to find matching mode.  */
+  if (best_vbe_mode == 0)
+    for (p = vbe_mode_list; *p != 0xFFFF; p++)
+      {
+        grub_uint32_t vbe_mode = *p;
+
+        grub_vbe_get_video_mode_info (vbe_mode, &vbe_mode_info);
+        if (grub_errno != GRUB_ERR_NONE)
+          {
+            /* Could not retrieve mode info, retreat.  */
+            grub_errno = GRUB_ERR_NONE;
+            break;
+          }
+
+        if ((vbe_mode_info.mode_attributes & GRUB_VBE_MODEATTR_SUPPORTED) == 0)
+          /* If not available, skip it.  */
+          continue;
 
-      /* Check if user requested RGB or index color mode.  */
-      if ((mode_mask & GRUB_VIDEO_MODE_TYPE_COLOR_MASK) != 0)
-        {
-	  unsigned my_mode_type = 0;
+        if ((vbe_mode_info.mode_attributes & GRUB_VBE_MODEATTR_COLOR) == 0)
+          /* Monochrome is unusable.  */
+          continue;
 
-	  if (vbe_mode_info.memory_model == GRUB_VBE_MEMORY_MODEL_PACKED_PIXEL)
-	    my_mode_type |= GRUB_VIDEO_MODE_TYPE_INDEX_COLOR;
+        if ((vbe_mode_info.mode_attributes & GRUB_VBE_MODEATTR_LFB_AVAIL) == 0)
+          /* We support only linear frame buffer modes.  */
+          continue;
 
-	  if (vbe_mode_info.memory_model == GRUB_VBE_MEMORY_MODEL_DIRECT_COLOR)
-	    my_mode_type |= GRUB_VIDEO_MODE_TYPE_RGB;
+        if ((vbe_mode_info.mode_attributes & GRUB_VBE_MODEATTR_GRAPHICS) == 0)
+          /* We allow only graphical modes.  */
+          continue;
 
-	  if ((my_mode_type & mode_mask
-	       & (GRUB_VIDEO_MODE_TYPE_RGB | GRUB_VIDEO_MODE_TYPE_INDEX_COLOR))
-	      != (mode_type & mode_mask
-		  & (GRUB_VIDEO_MODE_TYPE_RGB
-		     | GRUB_VIDEO_MODE_TYPE_INDEX_COLOR)))
-	    continue;
-        }
+        if ((vbe_mode_info.memory_model != GRUB_VBE_MEMORY_MODEL_PACKED_PIXEL)
+            && (vbe_mode_info.memory_model != GRUB_VBE_MEMORY_MODEL_DIRECT_COLOR))
+          /* Not compatible memory model.  */
+          continue;
 
-      /* If there is a request for specific depth, ignore others.  */
-      if ((depth != 0) && (vbe_mode_info.bits_per_pixel != depth))
-        continue;
+        if (vbe_mode_info.bits_per_pixel != 8
+  	  && vbe_mode_info.bits_per_pixel != 15
+  	  && vbe_mode_info.bits_per_pixel != 16
+  	  && vbe_mode_info.bits_per_pixel != 24
+  	  && vbe_mode_info.bits_per_pixel != 32)
+  	/* Unsupported bitdepth . */
+          continue;
 
-      /* Select mode with most of "volume" (size of framebuffer in bits).  */
-      if (best_vbe_mode != 0)
-        if ((grub_uint64_t) vbe_mode_info.bits_per_pixel
-	    * vbe_mode_info.x_resolution * vbe_mode_info.y_resolution
-	    < (grub_uint64_t) best_vbe_mode_info.bits_per_pixel
-	    * best_vbe_mode_info.x_resolution * best_vbe_mode_info.y_resolution)
+        if (preferred_mode)
+  	{
+  	  if (vbe_mode_info.x_resolution > width
+  	      || vbe_mode_info.y_resolution > height)
+  	    /* Resolution exceeds that of preferred mode.  */
+  	    continue;
+  	}
+        else
+  	{
+  	  if (((vbe_mode_info.x_resolution != width)
+  	       || (vbe_mode_info.y_resolution != height))
+  	      && width != 0 && height != 0)
+  	    /* Non matching resolution.  */
+  	    continue;
+  	}
+
+        /* Check if user requested RGB or index color mode.  */
+        if ((mode_mask & GRUB_VIDEO_MODE_TYPE_COLOR_MASK) != 0)
+          {
+  	  unsigned my_mode_type = 0;
+
+  	  if (vbe_mode_info.memory_model == GRUB_VBE_MEMORY_MODEL_PACKED_PIXEL)
+  	    my_mode_type |= GRUB_VIDEO_MODE_TYPE_INDEX_COLOR;
+
+  	  if (vbe_mode_info.memory_model == GRUB_VBE_MEMORY_MODEL_DIRECT_COLOR)
+  	    my_mode_type |= GRUB_VIDEO_MODE_TYPE_RGB;
+
+  	  if ((my_mode_type & mode_mask
+  	       & (GRUB_VIDEO_MODE_TYPE_RGB | GRUB_VIDEO_MODE_TYPE_INDEX_COLOR))
+  	      != (mode_type & mode_mask
+  		  & (GRUB_VIDEO_MODE_TYPE_RGB
+  		     | GRUB_VIDEO_MODE_TYPE_INDEX_COLOR)))
+  	    continue;
+          }
+
+        /* If there is a request for specific depth, ignore others.  */
+        if ((depth != 0) && (vbe_mode_info.bits_per_pixel != depth))
           continue;
 
-      /* Save so far best mode information for later use.  */
-      best_vbe_mode = vbe_mode;
-      grub_memcpy (&best_vbe_mode_info, &vbe_mode_info, sizeof (vbe_mode_info));
-    }
+        /* Select mode with most of "volume" (size of framebuffer in bits).  */
+        if (best_vbe_mode != 0)
+          if ((grub_uint64_t) vbe_mode_info.bits_per_pixel
+  	    * vbe_mode_info.x_resolution * vbe_mode_info.y_resolution
+  	    < (grub_uint64_t) best_vbe_mode_info.bits_per_pixel
+  	    * best_vbe_mode_info.x_resolution * best_vbe_mode_info.y_resolution)
+            continue;
+
+        /* Save so far best mode information for later use.  */
+        best_vbe_mode = vbe_mode;
+        grub_memcpy (&best_vbe_mode_info, &vbe_mode_info, sizeof (vbe_mode_info));
+      }
 
   /* Try to initialize best mode found.  */
   if (best_vbe_mode != 0)
@@ -1111,6 +1178,15 @@ grub_video_vbe_setup (unsigned int width, unsigned int height,
       if (grub_errno != GRUB_ERR_NONE)
         return grub_errno;
 
+      /* Remember the winner; a later setup (or a later boot, if the
+	 config saves the environment) starts from it.  */
+      {
+	char buf[16];
+
+	grub_snprintf (buf, sizeof (buf), "0x%x", best_vbe_mode);
+	grub_env_set ("vbe_mode_hint", buf);
+      }
+
       /* Fill mode info details.  */
       vbe2videoinfo (best_vbe_mode, &active_vbe_mode_info,
 		     &framebuffer.mode_info);
@@ -587,16 +587,27 @@ grub_jpeg_decode_du (struct grub_jpeg_data *data, int id, jpeg_data_unit_t du)
   return GRUB_ERR_NONE;
 }
 
+/* Turn a chroma sample into additive R/G/B terms.  With subsampled
+   chroma several pixels share one sample, so the multiplications here
+   are hoisted out of the per-pixel loop.  */
 static void
-grub_jpeg_ycrcb_to_rgb (int yy, int cr, int cb, grub_uint8_t * rgb)
+grub_jpeg_ycrcb_deltas (int cr, int cb, int *dr, int *dg, int *db)
 {
-  int dd;
-
   cr -= 128;
   cb -= 128;
 
+  *dr = (cr * CONST (1.402)) >> SHIFT_BITS;
+  *dg = (cb * CONST (0.34414) + cr * CONST (0.71414)) >> SHIFT_BITS;
+  *db = (cb * CONST (1.772)) >> SHIFT_BITS;
+}
+
+static void
+grub_jpeg_ycrcb_to_rgb (int yy, int dr, int dg, int db, grub_uint8_t * rgb)
+{
+  int dd;
+
   /* Red  */
-  dd = yy + ((cr * CONST (1.402)) >> SHIFT_BITS);
+  dd = yy + dr;
   if (dd < 0)
     dd = 0;
   if (dd > 255)
@@ -608,7 +619,7 @@ grub_jpeg_ycrcb_to_rgb (int yy, int cr, int cb, grub_uint8_t * rgb)
 #endif
 
   /* Green  */
-  dd = yy - ((cb * CONST (0.34414) + cr * CONST (0.71414)) >> SHIFT_BITS);
+  dd = yy - dg;
   if (dd < 0)
     dd = 0;
   if (dd > 255)
@@ -620,7 +631,7 @@ grub_jpeg_ycrcb_to_rgb (int yy, int cr, int cb, grub_uint8_t * rgb)
 #endif
 
   /* Blue  */
-  dd = yy + ((cb * CONST (1.772)) >> SHIFT_BITS);
+  dd = yy + db;
   if (dd < 0)
     dd = 0;
   if (dd > 255)
@@ -740,28 +751,37 @@ grub_jpeg_decode_data (struct grub_jpeg_data *data)
 
 	ptr2 = data->bitmap_ptr;
 	for (r2 = 0; r2 < nr2; r2++, ptr2 += (data->image_width - nc2) * 3)
-	  for (c2 = 0; c2 < nc2; c2++, ptr2 += 3)
-	    {
-	      unsigned i0;
-	      int yy;
-
-	      i0 = (r2 >> data->log_vs) * 8 + (c2 >> data->log_hs);
-	      yy = data->ydu[(r2 / 8) * 2 + (c2 / 8)][(r2 % 8) * 8 + (c2 % 8)];
-
-	      if (data->color_components >= 3)
-		{
-		  int cr, cb;
-		  cr = data->crdu[i0];
-		  cb = data->cbdu[i0];
-		  grub_jpeg_ycrcb_to_rgb (yy, cr, cb, ptr2);
-		}
-	      else
-		{
-		  ptr2[0] = yy;
-		  ptr2[1] = yy;
-		  ptr2[2] = yy;
-		}
-	    }
+	  {
+	    int last_i0 = -1;
+	    int dr = 0, dg = 0, db = 0;
+
+	    for (c2 = 0; c2 < nc2; c2++, ptr2 += 3)
+	      {
+		unsigned i0;
+		int yy;
+
+		i0 = (r2 >> data->log_vs) * 8 + (c2 >> data->log_hs);
+		yy = data->ydu[(r2 / 8) * 2 + (c2 / 8)][(r2 % 8) * 8 + (c2 % 8)];
+
+		if (data->color_components >= 3)
+		  {
+		    if ((int) i0 != last_i0)
+		      {
+			grub_jpeg_ycrcb_deltas (data->crdu[i0],
+						data->cbdu[i0],
+						&dr, &dg, &db);
+			last_i0 = i0;
+		      }
+		    grub_jpeg_ycrcb_to_rgb (yy, dr, dg, db, ptr2);
+		  }
+		else
+		  {
+		    ptr2[0] = yy;
+		    ptr2[1] = yy;
+		    ptr2[2] = yy;
+		  }
+	      }
+	  }
       }
 
   return grub_errno;
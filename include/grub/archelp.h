@@ -35,6 +35,9 @@ typedef enum
 
 struct grub_archelp_data;
 
+/* Size of the opaque position blob exchanged through get_pos/set_pos.  */
+#define GRUB_ARCHELP_POS_WORDS	4
+
 struct grub_archelp_ops
 {
   grub_err_t
@@ -47,6 +50,22 @@ struct grub_archelp_ops
 
   void
   (*rewind) (struct grub_archelp_data *data);
+
+  /* The following three hooks are optional.  Providing all of them lets
+     the archive helper keep a member index across mounts of the same
+     archive, so that repeated opens don't rescan every header.  get_pos
+     must save whatever state is needed to re-serve the member just
+     returned by find_file; set_pos must restore it.  */
+  grub_disk_t
+  (*get_disk) (struct grub_archelp_data *data);
+
+  void
+  (*get_pos) (struct grub_archelp_data *data,
+	      grub_uint64_t pos[GRUB_ARCHELP_POS_WORDS]);
+
+  void
+  (*set_pos) (struct grub_archelp_data *data,
+	      const grub_uint64_t pos[GRUB_ARCHELP_POS_WORDS]);
 };
 
 grub_err_t
@@ -0,0 +1,44 @@
+/* argon2.h - Argon2i/Argon2id key derivation function */
+/*
+ *  GRUB  --  GRand Unified Bootloader
+ *  Copyright (C) 2026  Free Software Foundation, Inc.
+ *
+ *  GRUB is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GRUB is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GRUB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GRUB_ARGON2_HEADER
+#define GRUB_ARGON2_HEADER	1
+
+#include <grub/types.h>
+#include <grub/crypto.h>
+
+/* The numeric values are the type codes hashed into H0.  */
+typedef enum
+  {
+    GRUB_ARGON2I  = 1,
+    GRUB_ARGON2ID = 2
+  } grub_argon2_type_t;
+
+/* Derive OUTLEN bytes into OUT from PWD and SALT as specified by
+   RFC 9106 (version 0x13), with T_COST passes over M_COST KiB of
+   memory and LANES lanes.  Lanes are computed sequentially, which
+   yields the same result as a parallel implementation.  */
+gcry_err_code_t
+grub_argon2 (grub_argon2_type_t type, grub_uint32_t t_cost,
+	     grub_uint32_t m_cost, grub_uint32_t lanes,
+	     const grub_uint8_t *pwd, grub_size_t pwdlen,
+	     const grub_uint8_t *salt, grub_size_t saltlen,
+	     grub_uint8_t *out, grub_size_t outlen);
+
+#endif /* ! GRUB_ARGON2_HEADER */
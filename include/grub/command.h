@@ -111,11 +111,7 @@ grub_register_command_p1 (const char *name,
   return grub_register_command_prio (name, func, summary, description, 1);
 }
 
-static inline grub_command_t
-grub_command_find (const char *name)
-{
-  return grub_named_list_find (GRUB_AS_NAMED_LIST (grub_command_list), name);
-}
+grub_command_t EXPORT_FUNC(grub_command_find) (const char *name);
 
 static inline grub_err_t
 grub_command_execute (const char *name, int argc, char **argv)
@@ -109,6 +109,11 @@ struct grub_cryptodisk
   grub_uint64_t last_rekey;
   int rekey_derived_size;
   grub_disk_addr_t partition_start;
+  /* MRU-first list of recently decrypted metadata-sized reads, so that
+     re-reads evicted from the generic disk cache do not pay the cipher
+     again.  */
+  struct grub_cryptodisk_plain_line *plain_cache;
+  grub_size_t plain_cache_bytes;
 };
 typedef struct grub_cryptodisk *grub_cryptodisk_t;
 
@@ -52,6 +52,8 @@ enum grub_disk_dev_id
     GRUB_DISK_DEVICE_UBOOTDISK_ID,
     GRUB_DISK_DEVICE_XEN,
     GRUB_DISK_DEVICE_OBDISK_ID,
+    GRUB_DISK_DEVICE_NVME_ID,
+    GRUB_DISK_DEVICE_MMC_ID,
   };
 
 struct grub_disk;
@@ -96,6 +98,14 @@ struct grub_disk_dev
   grub_err_t (*disk_write) (struct grub_disk *disk, grub_disk_addr_t sector,
 		       grub_size_t size, const char *buf);
 
+  /* Optional.  Return a pointer to SIZE bytes of directly addressable
+     memory backing the disk starting at byte ADDR, or NULL if the range
+     is not addressable.  Devices backed by plain memory (memdisk)
+     provide this so reads bypass the disk cache and become a single
+     copy.  The pointer stays valid as long as the device is open.  */
+  const char * (*disk_direct_ptr) (struct grub_disk *disk,
+				   grub_uint64_t addr, grub_size_t size);
+
 #ifdef GRUB_UTIL
   struct grub_disk_memberlist *(*disk_memberlist) (struct grub_disk *disk);
   const char * (*disk_raidname) (struct grub_disk *disk);
@@ -138,6 +148,14 @@ struct grub_disk
   /* The partition information. This is machine-specific.  */
   struct grub_partition *partition;
 
+  /* Top-level partition list parsed from this disk, kept by
+     grub_partition_iterate() until the disk is closed or written.  */
+  struct grub_partition_cache *partcache;
+
+  /* The name grub_disk_open() was called with, used as the key for
+     reusing recently closed disks.  */
+  char *open_name;
+
   /* Called when a sector was read. OFFSET is between 0 and
      the sector size minus 1, and LENGTH is between 0 and the sector size.  */
   grub_disk_read_hook_t read_hook;
@@ -145,6 +163,17 @@ struct grub_disk
   /* Caller-specific data passed to the read hook.  */
   void *read_hook_data;
 
+  /* Readahead level requested via grub_disk_set_readahead()
+     (GRUB_DISK_READAHEAD_*).  */
+  int readahead;
+
+  /* First 512B sector just past the previous read, used to detect
+     sequential access.  */
+  grub_disk_addr_t readahead_next;
+
+  /* Number of consecutive sequential reads seen so far.  */
+  unsigned int readahead_seq;
+
   /* Device-specific data.  */
   void *data;
 };
@@ -169,8 +198,15 @@ typedef struct grub_disk_memberlist *grub_disk_memberlist_t;
  */
 #define GRUB_DISK_MAX_SECTORS	(1ULL << (60 - GRUB_DISK_SECTOR_BITS))
 
+/* The number of ways in each cache set.  Sequential metadata and data
+   reads hashing to the same set no longer evict each other.  */
+#define GRUB_DISK_CACHE_WAYS	4
+
+/* The number of cache sets.  */
+#define GRUB_DISK_CACHE_SETS	251
+
 /* The maximum number of disk caches.  */
-#define GRUB_DISK_CACHE_NUM	1021
+#define GRUB_DISK_CACHE_NUM	(GRUB_DISK_CACHE_SETS * GRUB_DISK_CACHE_WAYS)
 
 /* The size of a disk cache in 512B units. Must be at least as big as the
    largest supported sector size, currently 16K.  */
@@ -179,6 +215,10 @@ typedef struct grub_disk_memberlist *grub_disk_memberlist_t;
 
 #define GRUB_DISK_MAX_MAX_AGGLOMERATE ((1 << (30 - GRUB_DISK_CACHE_BITS - GRUB_DISK_SECTOR_BITS)) - 1)
 
+/* Aligned reads of at least this many cache lines are treated as bulk
+   data and bypass the disk cache.  */
+#define GRUB_DISK_CACHE_BULK_LINES	4
+
 /* Return value of grub_disk_native_sectors() in case disk size is unknown. */
 #define GRUB_DISK_SIZE_UNKNOWN	 0xffffffffffffffffULL
 
@@ -216,10 +256,17 @@ grub_disk_to_native_sector (grub_disk_t disk, grub_disk_addr_t sector)
 }
 
 /* This is called from the memory manager.  */
-void grub_disk_cache_invalidate_all (void);
+void EXPORT_FUNC(grub_disk_cache_invalidate_all) (void);
 
 void EXPORT_FUNC(grub_disk_dev_register) (grub_disk_dev_t dev);
 void EXPORT_FUNC(grub_disk_dev_unregister) (grub_disk_dev_t dev);
+
+/* Generation of the set of disk devices.  It moves when a driver is
+   (un)registered and when a driver creates or removes a device at
+   runtime, so cached enumeration results can be revalidated cheaply.
+   Never returns 0, letting callers use 0 as "nothing cached".  */
+unsigned long EXPORT_FUNC(grub_disk_dev_generation) (void);
+void EXPORT_FUNC(grub_disk_dev_generation_bump) (void);
 static inline int
 grub_disk_dev_iterate (grub_disk_dev_iterate_hook_t hook, void *hook_data)
 {
@@ -241,11 +288,28 @@ grub_err_t EXPORT_FUNC(grub_disk_read) (grub_disk_t disk,
 					grub_off_t offset,
 					grub_size_t size,
 					void *buf);
+/* One element of a scatter-read request.  */
+struct grub_disk_extent
+{
+  grub_disk_addr_t sector;
+  grub_off_t offset;
+  grub_size_t size;
+  void *buf;
+};
+
+grub_err_t EXPORT_FUNC(grub_disk_read_multi) (grub_disk_t disk,
+					      struct grub_disk_extent *vec,
+					      grub_size_t n);
 grub_err_t grub_disk_write (grub_disk_t disk,
 			    grub_disk_addr_t sector,
 			    grub_off_t offset,
 			    grub_size_t size,
 			    const void *buf);
+/* Combine the read-modify-write cycles of small writes issued between
+   these two calls; the last touched sector is programmed at the flush.
+   Reads of a not-yet-flushed sector return the old contents.  */
+void grub_disk_write_begin (grub_disk_t disk);
+grub_err_t grub_disk_write_flush (grub_disk_t disk);
 extern grub_err_t (*EXPORT_VAR(grub_disk_write_weak)) (grub_disk_t disk,
 						       grub_disk_addr_t sector,
 						       grub_off_t offset,
@@ -255,11 +319,47 @@ extern grub_err_t (*EXPORT_VAR(grub_disk_write_weak)) (grub_disk_t disk,
 
 grub_uint64_t EXPORT_FUNC(grub_disk_native_sectors) (grub_disk_t disk);
 
+/* Levels for grub_disk_set_readahead().  ON prefetches once a
+   sequential run has been detected.  EAGER is for bulk streaming where
+   the caller knows the whole file will be consumed start to finish: the
+   prefetch window opens wide immediately and re-opens right after
+   filesystem metadata reads interrupt the run, at the cost of a wasted
+   window when the promise is broken.  */
+#define GRUB_DISK_READAHEAD_OFF		0
+#define GRUB_DISK_READAHEAD_ON		1
+#define GRUB_DISK_READAHEAD_EAGER	2
+
+void EXPORT_FUNC(grub_disk_set_readahead) (grub_disk_t disk, int enable);
+
 #if DISK_CACHE_STATS
 void
 EXPORT_FUNC(grub_disk_cache_get_performance) (unsigned long *hits, unsigned long *misses);
 #endif
 
+/* Always-available cache statistics, broken down by disk identity.
+   OCCUPANCY is the number of cache lines currently holding this disk's
+   data; the other counters accumulate since boot or the last reset.  */
+struct grub_disk_cache_stats
+{
+  const char *name;
+  unsigned long dev_id;
+  unsigned long disk_id;
+  unsigned long hits;
+  unsigned long misses;
+  unsigned long evictions;
+  unsigned long agglomerated;
+  /* Sectors of GRUB_DISK_SECTOR_SIZE actually transferred from the
+     device, i.e. excluding cache hits.  */
+  unsigned long long sectors_read;
+  unsigned occupancy;
+};
+
+typedef int (*grub_disk_cache_stats_hook_t) (const struct grub_disk_cache_stats *stats,
+					     void *data);
+void EXPORT_FUNC(grub_disk_cache_stats_iterate) (grub_disk_cache_stats_hook_t hook,
+						 void *hook_data);
+void EXPORT_FUNC(grub_disk_cache_stats_reset) (void);
+
 extern void (* EXPORT_VAR(grub_disk_firmware_fini)) (void);
 extern int EXPORT_VAR(grub_disk_firmware_is_tainted);
 
@@ -283,6 +383,9 @@ struct grub_disk_cache
   grub_disk_addr_t sector;
   char *data;
   int lock;
+  /* Tick of the last hit or store, used for LRU replacement within
+     a cache set.  Zero marks a never-used entry.  */
+  grub_uint64_t last_use;
 };
 
 extern struct grub_disk_cache EXPORT_VAR(grub_disk_cache_table)[GRUB_DISK_CACHE_NUM];
@@ -59,6 +59,10 @@ struct grub_diskfilter_pv_id {
     int id;
   };
   grub_size_t uuidlen;
+  /* First data-area sector not yet rebuilt on this member, or 0 if the
+     member is fully in sync.  Detectors that understand rebuild state
+     (mdraid 1.x recovery_offset) fill this in; others leave it 0.  */
+  grub_disk_addr_t recovery_offset;
 };
 
 struct grub_diskfilter_pv {
@@ -69,6 +73,10 @@ struct grub_diskfilter_pv {
   grub_disk_addr_t part_start;
   grub_disk_addr_t part_size;
   grub_disk_addr_t start_sector; /* Sector number where the data area starts. */
+  /* First data-area sector not yet rebuilt, or 0 when fully in sync.
+     Reads reaching past it are refused so mirror and parity fallbacks
+     pick an in-sync member instead of returning stale data.  */
+  grub_disk_addr_t recovery_offset;
   struct grub_diskfilter_pv *next;
   /* Optional.  */
   grub_uint8_t *internal_id;
@@ -91,6 +99,10 @@ struct grub_diskfilter_lv {
   int scanned;
   int visible;
 
+  /* Lazily computed on first read: 1 when the segments are sorted by
+     start_extent so binary search is usable, -1 when not, 0 unknown.  */
+  int segments_sorted;
+
   /* Pointer to segment_count segments. */
   struct grub_diskfilter_segment *segments;
   struct grub_diskfilter_vg *vg;
@@ -21,14 +21,23 @@
 
 #include <grub/env.h>
 
-/* The size of the hash table.  */
-#define	HASHSZ	13
+/* The initial number of slots in the hash table.  Must be a power of
+   two, as must every grown size.  */
+#define GRUB_ENV_INITIAL_SLOTS	32
 
-/* A hashtable for quick lookup of variables.  */
+/* An open-addressing hash table for quick lookup of variables.  */
 struct grub_env_context
 {
-  /* A hash table for variables.  */
-  struct grub_env_var *vars[HASHSZ];
+  /* The slot array.  Empty slots are NULL; slots of deleted variables
+     hold &grub_env_tombstone so probe sequences keep running.  */
+  struct grub_env_var **vars;
+
+  /* The number of allocated slots (a power of two, or zero before the
+     first variable is set).  */
+  grub_size_t nslots;
+
+  /* The number of live plus deleted slots, driving the growth.  */
+  grub_size_t nused;
 
   /* One level deeper on the stack.  */
   struct grub_env_context *prev;
@@ -43,4 +52,11 @@ struct grub_env_sorted_var
 
 extern struct grub_env_context *EXPORT_VAR(grub_current_context);
 
+/* The marker stored in slots of deleted variables.  */
+extern struct grub_env_var EXPORT_VAR(grub_env_tombstone);
+
+/* Drop the interned-name lookup cache.  Must be called whenever the
+   current context changes.  */
+void EXPORT_FUNC(grub_env_hot_reset) (void);
+
 #endif /* ! GRUB_ENV_PRIVATE_HEADER */
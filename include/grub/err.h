@@ -92,6 +92,14 @@ grub_err_t EXPORT_FUNC(grub_error) (grub_err_t n, const char *file, const int li
 
 
 void EXPORT_FUNC(grub_fatal) (const char *fmt, ...) __attribute__ ((noreturn));
+
+/* While a probe section is open, grub_error() skips message formatting
+   for the error classes probe loops discard unseen (GRUB_ERR_BAD_FS and
+   GRUB_ERR_OUT_OF_RANGE); any other error is formatted as usual since
+   it will be reported.  Sections nest.  */
+void EXPORT_FUNC(grub_error_probe_begin) (void);
+void EXPORT_FUNC(grub_error_probe_end) (void);
+
 void EXPORT_FUNC(grub_error_push) (void);
 int EXPORT_FUNC(grub_error_pop) (void);
 void EXPORT_FUNC(grub_print_error) (void);
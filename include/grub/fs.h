@@ -39,8 +39,12 @@ struct grub_dirhook_info
   unsigned mtimeset:1;
   unsigned case_insensitive:1;
   unsigned inodeset:1;
+  unsigned sizeset:1;
   grub_int64_t mtime;
   grub_uint64_t inode;
+  /* File size in bytes.  Set when the filesystem has it in the directory
+     entry already, so callers need not open every file just for the size.  */
+  grub_off_t size;
 };
 
 typedef int (*grub_fs_dir_hook_t) (const char *filename,
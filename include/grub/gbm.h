@@ -0,0 +1,54 @@
+/* gbm.h - format of pre-decoded GRUB bitmap files */
+/*
+ *  GRUB  --  GRand Unified Bootloader
+ *  Copyright (C) 2026  Free Software Foundation, Inc.
+ *
+ *  GRUB is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GRUB is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GRUB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GRUB_GBM_HEADER
+#define GRUB_GBM_HEADER	1
+
+#include <grub/types.h>
+
+/*
+ * A .gbm file holds a bitmap in the exact in-memory layout used by
+ * grub_video_bitmap_create: tightly packed rows, top to bottom, with
+ * RGB[A] components in byte order.  Loading it is a header check and
+ * one bulk read -- no entropy decoding, no filtering, no per-pixel
+ * conversion.  grub-mktheme(1) produces these from PNG/JPEG/TGA images
+ * so that themes do not pay image decoding costs at boot.
+ *
+ * All integers are little-endian.
+ */
+
+#define GRUB_GBM_MAGIC		"GRUBgbm1"
+#define GRUB_GBM_MAGIC_SIZE	8
+
+/* Matches GRUB_VIDEO_BLIT_FORMAT_RGBA_8888.  */
+#define GRUB_GBM_FORMAT_RGBA8888	1
+/* Matches GRUB_VIDEO_BLIT_FORMAT_RGB_888.  */
+#define GRUB_GBM_FORMAT_RGB888		2
+
+struct grub_gbm_header
+{
+  char magic[GRUB_GBM_MAGIC_SIZE];
+  grub_uint32_t width;
+  grub_uint32_t height;
+  /* One of GRUB_GBM_FORMAT_*.  */
+  grub_uint32_t format;
+  grub_uint32_t reserved;
+};
+
+#endif /* ! GRUB_GBM_HEADER */
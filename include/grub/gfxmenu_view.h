@@ -69,6 +69,31 @@ grub_err_t grub_font_draw_string (const char *str,
 int grub_font_get_string_width (grub_font_t font,
 				const char *str);
 
+/* A string laid out once and retained across frames: the glyphs are
+   composed into a single 1-bit surface, so redrawing it is one blit.
+   The color is applied at draw time, not layout time.  */
+struct grub_font_string_layout
+{
+  /* Composed 1-bit packed surface; NULL if nothing is visible.  */
+  grub_uint8_t *scratch;
+  /* Surface extents in pixels.  */
+  int width;
+  int height;
+  /* Surface origin relative to the pen position and baseline.  */
+  int min_left;
+  int min_top;
+  /* Total advance width of the string.  */
+  int advance;
+};
+typedef struct grub_font_string_layout *grub_font_string_layout_t;
+
+grub_font_string_layout_t grub_font_layout_string (const char *str,
+						   grub_font_t font);
+grub_err_t grub_font_layout_draw (grub_font_string_layout_t layout,
+				  grub_video_color_t color,
+				  int left_x, int baseline_y);
+void grub_font_layout_free (grub_font_string_layout_t layout);
+
 
 /* Implementation details -- this should not be used outside of the
    view itself.  */
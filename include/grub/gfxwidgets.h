@@ -33,6 +33,12 @@ struct grub_gfxmenu_box
   struct grub_video_bitmap **raw_pixmaps;
   struct grub_video_bitmap **scaled_pixmaps;
 
+  /* When the center pixmap is a single opaque color, the interior is
+     drawn with grub_video_fill_rect instead of scaling and blitting a
+     content-sized bitmap.  */
+  int center_uniform;
+  grub_uint8_t center_rgba[4];
+
   void (*draw) (grub_gfxmenu_box_t self, int x, int y);
   void (*set_content_size) (grub_gfxmenu_box_t self,
                             int width, int height);
@@ -73,17 +73,21 @@ struct grub_gui_list_ops
 
 struct grub_gui_progress_ops
 {
-  void (*set_state) (void *self, int visible, int start, int current, int end);
+  int (*set_state) (void *self, int visible, int start, int current, int end);
 };
 
-typedef void (*grub_gfxmenu_set_state_t) (void *self, int visible, int start,
-					  int current, int end);
+/* Returns nonzero iff the new state differs from what the component
+   currently displays, so the caller can skip repainting it.  */
+typedef int (*grub_gfxmenu_set_state_t) (void *self, int visible, int start,
+					 int current, int end);
 
 struct grub_gfxmenu_timeout_notify
 {
   struct grub_gfxmenu_timeout_notify *next;
   grub_gfxmenu_set_state_t set_state;
   grub_gui_component_t self;
+  /* Set by the last set_state call: does the component need a repaint?  */
+  int changed;
 };
 
 extern struct grub_gfxmenu_timeout_notify *grub_gfxmenu_timeout_notifications;
@@ -97,6 +101,7 @@ grub_gfxmenu_timeout_register (grub_gui_component_t self,
     return grub_errno;
   ne->set_state = set_state;
   ne->self = self;
+  ne->changed = 1;
   ne->next = grub_gfxmenu_timeout_notifications;
   grub_gfxmenu_timeout_notifications = ne;
   return GRUB_ERR_NONE;
@@ -97,6 +97,12 @@ struct grub_hfsplus_btree
   grub_uint32_t root;
   grub_size_t nodesize;
 
+  /* Cached copy of the root node.  Every search starts there, so
+     keeping it memory-resident saves one node read per lookup.
+     Freed by grub_hfsplus_unmount.  */
+  char *root_cache;
+  int root_cache_valid;
+
   /* Catalog file node.  */
   struct grub_hfsplus_file file;
 };
@@ -122,6 +128,15 @@ struct grub_hfsplus_data
      filesystem (one inside a plain HFS wrapper).  */
   grub_disk_addr_t embedded_offset;
   int case_sensitive;
+
+  /* Memo of the last extent overflow record grub_hfsplus_read_block
+     used, so reading a fragmented fork sequentially does not search
+     the extent overflow tree again for every block crossing.  */
+  struct grub_hfsplus_extent extcache[8];
+  grub_disk_addr_t extcache_start;
+  grub_uint32_t extcache_fileid;
+  grub_uint8_t extcache_type;
+  int extcache_valid;
 };
 
 /* Internal representation of a catalog key.  */
@@ -19,10 +19,24 @@
 #ifndef GRUB_LOOPBACK_HEADER
 #define GRUB_LOOPBACK_HEADER	1
 
+/* A run of bytes of the backing file that is stored contiguously on the
+   backing disk, addressed relative to the partition the file lives on.  */
+struct grub_loopback_extent
+{
+  grub_off_t file_ofs;
+  grub_uint64_t disk_ofs;
+  grub_uint64_t len;
+};
+
 struct grub_loopback
 {
   char *devname;
   grub_file_t file;
+  /* Snapshot of the backing file's block map, or NULL if the extents
+     could not be resolved.  When present, reads go straight to the
+     backing disk and skip the backing filesystem.  */
+  struct grub_loopback_extent *blockmap;
+  grub_size_t nextents;
   struct grub_loopback *next;
   unsigned long id;
 };
@@ -27,6 +27,16 @@ struct bls_entry
   struct keyval **keyvals;
   int nkeyvals;
   char *filename;
+  /* Values of the hottest keys, remembered as the snippet is read so
+     lookups on them need not rescan keyvals.  */
+  char *title;
+  char *clinux;
+  /* Mutable copy of filename, pre-split into name/version/release so
+     sorting does not redo the split for every comparison.  */
+  char *verbuf;
+  char *vername;
+  char *verversion;
+  char *verrelease;
   int visible;
 };
 
@@ -36,6 +46,8 @@ struct grub_menu_entry_class
   struct grub_menu_entry_class *next;
 };
 
+struct grub_script;
+
 /* The menu entry.  */
 struct grub_menu_entry
 {
@@ -68,6 +80,16 @@ struct grub_menu_entry
 
   int submenu;
 
+  /* Top-level statements of sourcecode parsed ahead of selection,
+     chained through next_siblings.  Built lazily while the menu waits
+     for input; NULL means not parsed yet or fall back to the
+     interleaved parse+execute path.  */
+  struct grub_script *preparsed;
+
+  /* Nonzero once pre-parsing has been attempted, so a body that fails
+     to parse is not retried on every idle tick.  */
+  int preparse_tried;
+
   /* The next element.  */
   struct grub_menu_entry *next;
 
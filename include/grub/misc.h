@@ -493,6 +493,8 @@ struct grub_boot_time
   grub_uint64_t tp;
   const char *file;
   int line;
+  /* Nesting depth of enclosing grub_boot_time_enter scopes.  */
+  int level;
   char *msg;
 };
 
@@ -501,9 +503,29 @@ extern struct grub_boot_time *EXPORT_VAR(grub_boot_time_head);
 void EXPORT_FUNC(grub_real_boot_time) (const char *file,
 				       const int line,
 				       const char *fmt, ...) __attribute__ ((format (GNU_PRINTF, 3, 4)));
+void EXPORT_FUNC(grub_boot_time_adjust_level) (int delta);
 #define grub_boot_time(...) grub_real_boot_time(GRUB_FILE, __LINE__, __VA_ARGS__)
+/* Scoped probes: checkpoints recorded between an enter/exit pair get a
+   deeper level, which the boottime command can render as a tree.  The
+   two must be balanced on every path between them.  */
+#define grub_boot_time_enter(...) \
+  do \
+    { \
+      grub_real_boot_time (GRUB_FILE, __LINE__, __VA_ARGS__); \
+      grub_boot_time_adjust_level (1); \
+    } \
+  while (0)
+#define grub_boot_time_exit(...) \
+  do \
+    { \
+      grub_boot_time_adjust_level (-1); \
+      grub_real_boot_time (GRUB_FILE, __LINE__, __VA_ARGS__); \
+    } \
+  while (0)
 #else
 #define grub_boot_time(fmt, ...) grub_dprintf("boot", fmt "\n", ##__VA_ARGS__)
+#define grub_boot_time_enter(fmt, ...) grub_dprintf("boot", fmt "\n", ##__VA_ARGS__)
+#define grub_boot_time_exit(fmt, ...) grub_dprintf("boot", fmt "\n", ##__VA_ARGS__)
 #endif
 
 #define _grub_min(a, b, _a, _b)						      \
@@ -53,6 +53,27 @@ void *EXPORT_FUNC(grub_malloc) (grub_size_t size);
 void *EXPORT_FUNC(grub_zalloc) (grub_size_t size);
 void EXPORT_FUNC(grub_free) (void *ptr);
 void *EXPORT_FUNC(grub_realloc) (void *ptr, grub_size_t size);
+
+/*
+ * Bump allocator for groups of short-lived objects that are released
+ * together.  Allocation is a pointer increment within malloc'ed chunks
+ * and release frees all chunks in one pass, so transient workloads
+ * (parsing, argument expansion) neither fragment the regions nor pay
+ * the free-list walk per object.
+ */
+struct grub_arena_chunk;
+struct grub_arena
+{
+  struct grub_arena_chunk *chunks;
+  grub_uint8_t *cur;
+  grub_size_t left;
+  grub_size_t chunk_size;
+};
+typedef struct grub_arena *grub_arena_t;
+
+void EXPORT_FUNC(grub_arena_init) (grub_arena_t arena, grub_size_t chunk_size);
+void *EXPORT_FUNC(grub_arena_alloc) (grub_arena_t arena, grub_size_t size);
+void EXPORT_FUNC(grub_arena_release) (grub_arena_t arena);
 #ifndef GRUB_MACHINE_EMU
 void *EXPORT_FUNC(grub_memalign) (grub_size_t align, grub_size_t size);
 #endif
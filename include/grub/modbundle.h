@@ -0,0 +1,62 @@
+/* modbundle.h - format of pre-packed module bundles */
+/*
+ *  GRUB  --  GRand Unified Bootloader
+ *  Copyright (C) 2026  Free Software Foundation, Inc.
+ *
+ *  GRUB is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GRUB is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GRUB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GRUB_MODBUNDLE_HEADER
+#define GRUB_MODBUNDLE_HEADER	1
+
+#include <grub/types.h>
+
+/*
+ * A module bundle is a flat concatenation of .mod files behind a small
+ * index, produced by grub-mkmodbundle(1) and loaded by the `modbundle'
+ * command.  The point is to replace one file open/read round trip per
+ * module with a single bulk read; the modules inside are ordinary ELF
+ * objects and are linked by the regular grub_dl_load_core path.
+ *
+ * All integers are little-endian.  The layout is:
+ *
+ *   struct grub_modbundle_header
+ *   nmods times:
+ *     struct grub_modbundle_entry
+ *     module name, NUL-terminated, padded to GRUB_MODBUNDLE_ALIGN
+ *     module image, padded to GRUB_MODBUNDLE_ALIGN
+ */
+
+#define GRUB_MODBUNDLE_MAGIC	"GRUBmbdl"
+#define GRUB_MODBUNDLE_MAGIC_SIZE	8
+
+/* ELF headers inside the bundle must be naturally aligned.  */
+#define GRUB_MODBUNDLE_ALIGN	8
+
+struct grub_modbundle_header
+{
+  char magic[GRUB_MODBUNDLE_MAGIC_SIZE];
+  grub_uint32_t nmods;
+  grub_uint32_t reserved;
+};
+
+struct grub_modbundle_entry
+{
+  /* The length of the module name, including the terminating NUL.  */
+  grub_uint32_t namelen;
+  /* The length of the module image, without padding.  */
+  grub_uint32_t modlen;
+};
+
+#endif /* ! GRUB_MODBUNDLE_HEADER */
@@ -302,6 +302,13 @@ struct grub_net_network_level_interface
   grub_uint32_t my_ip;    /* DHCPv4 offered IP address */
   unsigned dhcp_tmo_left; /* DHCPv4 running retransmission timeout */
   unsigned dhcp_tmo;      /* DHCPv4 current retransmission timeout */
+  /* Link-layer header assembled for the last packet sent, reused
+     verbatim while the target and ethertype stay the same.  */
+  grub_uint8_t llhdr_cache[GRUB_NET_MAX_LINK_HEADER_SIZE];
+  grub_net_link_level_address_t llhdr_cache_target;
+  grub_uint16_t llhdr_cache_ethertype;
+  grub_uint8_t llhdr_cache_size;
+  int llhdr_cache_valid;
   void *data;
 };
 
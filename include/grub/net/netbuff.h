@@ -27,5 +27,7 @@ grub_err_t grub_netbuff_clear (struct grub_net_buff *net_buff);
 struct grub_net_buff * grub_netbuff_alloc (grub_size_t len);
 struct grub_net_buff * grub_netbuff_make_pkt (grub_size_t len);
 void grub_netbuff_free (struct grub_net_buff *net_buff);
+/* Release the buffers kept for recycling by grub_netbuff_free.  */
+void grub_netbuff_free_pool (void);
 
 #endif
@@ -39,6 +39,19 @@ grub_net_tcp_open (char *server,
 				     void *data),
 		   void *hook_data);
 
+/* Redirect the callbacks of an established socket, e.g. when an idle
+   keep-alive connection is handed to a new consumer.  */
+void
+grub_net_tcp_set_hooks (grub_net_tcp_socket_t sock,
+			grub_err_t (*recv_hook) (grub_net_tcp_socket_t sock,
+						 struct grub_net_buff *nb,
+						 void *data),
+			void (*error_hook) (grub_net_tcp_socket_t sock,
+					    void *data),
+			void (*fin_hook) (grub_net_tcp_socket_t sock,
+					  void *data),
+			void *hook_data);
+
 grub_net_tcp_listen_t
 grub_net_tcp_listen (grub_uint16_t port,
 		     const struct grub_net_network_level_interface *inf,
@@ -64,6 +64,9 @@
 /* Enable the FIFO.  */
 #define UART_ENABLE_FIFO_TRIGGER1       0x07
 
+/* Bits 6-7 of IIR, both set when a working FIFO is enabled.  */
+#define UART_FIFO_PRESENT	0xC0
+
 /* Turn on DTR, RTS, and OUT2.  */
 #define UART_ENABLE_DTRRTS	0x03
 
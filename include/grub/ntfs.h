@@ -148,6 +148,17 @@ struct grub_ntfs_file
   struct grub_ntfs_attr attr;
 };
 
+/* Number of fixed-up MFT records remembered per mount.  */
+#define GRUB_NTFS_MFT_CACHE_NUM 16
+
+struct grub_ntfs_mft_cache_entry
+{
+  grub_uint64_t mftno;
+  /* Fixed-up record of mft_size blocks; NULL marks an empty slot.  */
+  grub_uint8_t *buf;
+  grub_uint64_t last_use;
+};
+
 struct grub_ntfs_data
 {
   struct grub_ntfs_file cmft;
@@ -158,6 +169,8 @@ struct grub_ntfs_data
   int log_spc;
   grub_uint64_t mft_start;
   grub_uint64_t uuid;
+  struct grub_ntfs_mft_cache_entry mft_cache[GRUB_NTFS_MFT_CACHE_NUM];
+  grub_uint64_t mft_cache_tick;
 };
 
 struct grub_ntfs_comp_table_element
@@ -92,12 +92,21 @@ struct grub_partition
   grub_uint8_t msdostype;
 };
 
+/* Cached copy of one top-level partition, kept on the disk handle so
+   that repeated iterations don't re-read the partition table.  */
+struct grub_partition_cache
+{
+  struct grub_partition_cache *next;
+  struct grub_partition part;
+};
+
 grub_partition_t EXPORT_FUNC(grub_partition_probe) (struct grub_disk *disk,
 						    const char *str);
 int EXPORT_FUNC(grub_partition_iterate) (struct grub_disk *disk,
 					 grub_partition_iterate_hook_t hook,
 					 void *hook_data);
 char *EXPORT_FUNC(grub_partition_get_name) (const grub_partition_t partition);
+void EXPORT_FUNC(grub_partition_cache_free) (struct grub_disk *disk);
 
 
 extern grub_partition_map_t EXPORT_VAR(grub_partition_map_list);
@@ -80,6 +80,9 @@ struct grub_script_argv
   unsigned argc;
   char **args;
   struct grub_script *script;
+  /* Length of the argument currently being built (args[argc - 1]), so
+     appending fragments does not rescan the string each time.  */
+  grub_size_t arglen;
 };
 
 /* Pluggable wildcard translator.  */
@@ -90,6 +93,9 @@ struct grub_script_wildcard_translator
 extern struct grub_script_wildcard_translator *grub_wildcard_translator;
 extern struct grub_script_wildcard_translator grub_filename_translator;
 
+/* Drop the compiled glob programs cached by the filename translator.  */
+void grub_wildcard_regex_cache_flush (void);
+
 /* A complete argument.  It consists of a list of one or more `struct
    grub_script_arg's.  */
 struct grub_script_arglist
@@ -292,6 +298,11 @@ grub_script_arg_add (struct grub_parser_param *state,
 struct grub_script *grub_script_parse (char *script,
 				       grub_reader_getline_t getline_func,
 				       void *getline_func_data);
+struct grub_script *grub_script_preparse_sourcecode (const char *source);
+void grub_script_preparse_free (struct grub_script *head);
+grub_err_t grub_script_execute_preparsed_new_scope (const char *source,
+						    struct grub_script *head,
+						    int argc, char **args);
 void grub_script_free (struct grub_script *script);
 struct grub_script *grub_script_create (struct grub_script_cmd *cmd,
 					struct grub_script_mem *mem);
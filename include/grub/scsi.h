@@ -103,6 +103,10 @@ struct grub_scsi
   /* Size of one block.  */
   grub_uint32_t blocksize;
 
+  /* Maximum bytes the transport moves in one command.  Filled in by
+     the transport open function; zero selects a conservative default.  */
+  grub_size_t max_bytes;
+
   /* Device-specific data.  */
   void *data;
 };
@@ -36,4 +36,19 @@ void grub_search_label (const char *key, const char *var,
 			enum search_flags flags,
 			char **hints, unsigned nhints);
 
+/* Resolve several keys in one device scan.  vars may be NULL (print
+   matches) or hold one variable name per key.  */
+void grub_search_fs_file_multi (unsigned ntargets, const char * const *keys,
+				const char * const *vars,
+				enum search_flags flags,
+				char **hints, unsigned nhints);
+void grub_search_fs_uuid_multi (unsigned ntargets, const char * const *keys,
+				const char * const *vars,
+				enum search_flags flags,
+				char **hints, unsigned nhints);
+void grub_search_label_multi (unsigned ntargets, const char * const *keys,
+			      const char * const *vars,
+			      enum search_flags flags,
+			      char **hints, unsigned nhints);
+
 #endif
@@ -44,6 +44,9 @@ struct grub_serial_driver
   int (*fetch) (struct grub_serial_port *port);
   void (*put) (struct grub_serial_port *port, const int c);
   void (*fini) (struct grub_serial_port *port);
+  /* Nonzero iff put would accept a byte right now without waiting.
+     Optional; when absent the terminal glue writes synchronously.  */
+  int (*tx_ready) (struct grub_serial_port *port);
 };
 
 /* The type of parity.  */
@@ -81,6 +84,19 @@ struct grub_serial_port
   int configured;
   int broken;
 
+  /* TX FIFO depth, and how many bytes may still be written without
+     polling for transmitter readiness.  Used by the ns8250 driver.  */
+  int tx_fifo_depth;
+  int tx_fifo_left;
+
+  /* Software TX ring, used when the driver provides tx_ready.  Output
+     is queued here while the transmitter is busy and drained whenever
+     the port is polled, so a faster terminal mirrored on the same
+     output isn't stalled byte by byte.  NULL until first used.  */
+  grub_uint8_t *txbuf;
+  int txbuf_start;
+  int txbuf_len;
+
   /* This should be void *data but since serial is useful as an early console
      when malloc isn't available it's a union.
    */
@@ -329,6 +329,7 @@ grub_term_unregister_output (grub_term_output_t term)
 void grub_putcode (grub_uint32_t code, struct grub_term_output *term);
 int EXPORT_FUNC(grub_getkey) (void);
 int EXPORT_FUNC(grub_getkey_noblock) (void);
+void EXPORT_FUNC(grub_term_poll_pause) (void);
 int EXPORT_FUNC(grub_getkeystatus) (void);
 int EXPORT_FUNC(grub_key_is_interrupt) (int key);
 void grub_cls (void);
@@ -461,6 +462,24 @@ grub_print_spaces (struct grub_term_output *term, int number_spaces)
 
 extern void (*EXPORT_VAR (grub_term_poll_usb)) (int wait_for_completion);
 
+/* Cooperative background work run while the machine waits for a key,
+   e.g. during the menu timeout.  The hook is called once per idle key
+   poll and returns nonzero when it has no more work, which removes the
+   task from the queue.  Higher priority runs first.  The caller owns
+   the structure and must unregister it before it goes out of scope.  */
+struct grub_idle_task
+{
+  struct grub_idle_task *next;
+  int (*hook) (void *data);
+  void *data;
+  int priority;
+};
+typedef struct grub_idle_task *grub_idle_task_t;
+
+void EXPORT_FUNC(grub_idle_task_register) (grub_idle_task_t task);
+void EXPORT_FUNC(grub_idle_task_unregister) (grub_idle_task_t task);
+void EXPORT_FUNC(grub_idle_pump) (void);
+
 #define GRUB_TERM_REPEAT_PRE_INTERVAL 400
 #define GRUB_TERM_REPEAT_INTERVAL 50
 
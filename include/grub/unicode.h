@@ -241,7 +241,6 @@ enum
 extern struct grub_unicode_compact_range grub_unicode_compact[];
 extern struct grub_unicode_bidi_pair grub_unicode_bidi_pairs[];
 
-#define GRUB_UNICODE_MAX_CACHED_CHAR 0x20000
 /*  Unicode mandates an arbitrary limit.  */
 #define GRUB_BIDI_MAX_EXPLICIT_LEVEL 61
 
@@ -34,6 +34,7 @@ char *grub_util_get_path (const char *dir, const char *file);
 size_t grub_util_get_image_size (const char *path);
 char *grub_util_read_image (const char *path);
 void grub_util_load_image (const char *path, char *buf);
+void grub_util_enable_image_cache (void);
 void grub_util_write_image (const char *img, size_t size, FILE *out,
 			    const char *name);
 void grub_util_write_image_at (const void *img, size_t size, off_t offset,
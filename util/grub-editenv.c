@@ -59,6 +59,8 @@ static struct argp_option options[] = {
 
   {0,         0, 0, OPTION_DOC, N_("Options:"), -1},
   {"verbose", 'v', 0, 0, N_("print verbose messages."), 0},
+  {"transaction", 't', 0, 0,
+   N_("with the set command, read additional NAME=VALUE assignments from standard input, one per line, and apply them together with the command-line ones in a single write."), 0},
 
   { 0, 0, 0, 0, 0, 0 }
 };
@@ -74,6 +76,8 @@ void (*argp_program_version_hook) (FILE *, struct argp_state *) = print_version;
 /* Set the bug report address */
 const char *argp_program_bug_address = "<"PACKAGE_BUGREPORT">";
 
+static int transaction = 0;
+
 static error_t argp_parser (int key, char *arg, struct argp_state *state)
 {
   switch (key)
@@ -82,6 +86,10 @@ static error_t argp_parser (int key, char *arg, struct argp_state *state)
         verbosity++;
         break;
 
+      case 't':
+        transaction = 1;
+        break;
+
       case ARGP_KEY_NO_ARGS:
         fprintf (stderr, "%s",
 		 _("You need to specify at least one command.\n"));
@@ -123,6 +131,11 @@ block, use `rm %s'."),
   NULL, help_filter, NULL
 };
 
+/* Copy of the environment block as it was read from disk, used by
+   write_envblk to write back only the bytes that actually changed.  */
+static char *orig_buf;
+static size_t orig_size;
+
 static grub_envblk_t
 open_envblk_file (const char *name)
 {
@@ -166,6 +179,10 @@ open_envblk_file (const char *name)
 
   fclose (fp);
 
+  orig_buf = xmalloc (size);
+  memcpy (orig_buf, buf, size);
+  orig_size = size;
+
   envblk = grub_envblk_open (buf, size);
   if (! envblk)
     grub_util_error ("%s", _("invalid environment block"));
@@ -195,14 +212,45 @@ static void
 write_envblk (const char *name, grub_envblk_t envblk)
 {
   FILE *fp;
+  const char *buf = grub_envblk_buffer (envblk);
+  size_t size = grub_envblk_size (envblk);
+  size_t start = 0, end = size;
+
+  /* Narrow the write to the range that actually changed.  When the
+     environment block sits on a raw device this avoids dirtying
+     sectors whose contents are unmodified.  */
+  if (orig_buf && orig_size == size)
+    {
+      while (start < size && buf[start] == orig_buf[start])
+	start++;
+      if (start == size)
+	/* Nothing changed; leave the block alone.  */
+	return;
+      while (end > start && buf[end - 1] == orig_buf[end - 1])
+	end--;
+    }
 
-  fp = grub_util_fopen (name, "wb");
+  if (start == 0 && end == size)
+    fp = grub_util_fopen (name, "wb");
+  else
+    {
+      fp = grub_util_fopen (name, "r+b");
+      if (fp && fseek (fp, start, SEEK_SET) < 0)
+	grub_util_error (_("cannot seek `%s': %s"), name,
+			 strerror (errno));
+      if (! fp)
+	{
+	  /* The file disappeared under us; recreate it in full.  */
+	  start = 0;
+	  end = size;
+	  fp = grub_util_fopen (name, "wb");
+	}
+    }
   if (! fp)
     grub_util_error (_("cannot open `%s': %s"), name,
 		     strerror (errno));
 
-  if (fwrite (grub_envblk_buffer (envblk), 1, grub_envblk_size (envblk), fp)
-      != grub_envblk_size (envblk))
+  if (fwrite (buf + start, 1, end - start, fp) != end - start)
     grub_util_error (_("cannot write to `%s': %s"), name,
 		     strerror (errno));
 
@@ -234,6 +282,33 @@ set_variables (const char *name, int argc, char *argv[])
       argv++;
     }
 
+  if (transaction)
+    {
+      char *line = NULL;
+      size_t len = 0;
+      ssize_t llen;
+
+      while ((llen = getline (&line, &len, stdin)) > 0)
+	{
+	  char *p;
+
+	  if (line[llen - 1] == '\n')
+	    line[llen - 1] = '\0';
+	  if (line[0] == '\0')
+	    continue;
+
+	  p = strchr (line, '=');
+	  if (! p)
+	    grub_util_error (_("invalid parameter %s"), line);
+
+	  *(p++) = 0;
+
+	  if (! grub_envblk_set (envblk, line, p))
+	    grub_util_error ("%s", _("environment block too small"));
+	}
+      free (line);
+    }
+
   write_envblk (name, envblk);
   grub_envblk_close (envblk);
 }
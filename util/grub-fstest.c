@@ -32,11 +32,13 @@
 #include <grub/lib/hexdump.h>
 #include <grub/crypto.h>
 #include <grub/command.h>
+#include <grub/normal.h>
 #include <grub/i18n.h>
 #include <grub/zfs/zfs.h>
 #include <grub/emu/hostfile.h>
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <errno.h>
 #include <string.h>
 
@@ -69,7 +71,10 @@ enum {
   CMD_BLOCKLIST,
   CMD_TESTLOAD,
   CMD_ZFSINFO,
-  CMD_XNU_UUID
+  CMD_XNU_UUID,
+  CMD_BENCHCRYPTO,
+  CMD_BATCH,
+  CMD_BENCH
 };
 #define BUF_SIZE  32256
 
@@ -178,14 +183,42 @@ struct cp_hook_ctx
 {
   FILE *ff;
   const char *dest;
+  /* Bytes of zeros seen but not yet written; skipped over with a seek
+     so holes in the source stay holes in the copy.  */
+  grub_off_t hole;
 };
 
+static int
+buf_is_zero (const char *buf, int len)
+{
+  return len > 0 && buf[0] == 0 && memcmp (buf, buf + 1, len - 1) == 0;
+}
+
 static int
 cp_hook (grub_off_t ofs, char *buf, int len, void *_ctx)
 {
   struct cp_hook_ctx *ctx = _ctx;
   (void) ofs;
 
+  /* Filesystem drivers return zeros for unmapped blocks, so runs of
+     zeros mark (a superset of) the holes of a sparse source.  */
+  if (buf_is_zero (buf, len))
+    {
+      ctx->hole += len;
+      return 0;
+    }
+
+  if (ctx->hole)
+    {
+      if (fseeko (ctx->ff, ctx->hole, SEEK_CUR))
+	{
+	  grub_util_error (_("cannot write to `%s': %s"),
+			   ctx->dest, strerror (errno));
+	  return 1;
+	}
+      ctx->hole = 0;
+    }
+
   if ((int) fwrite (buf, 1, len, ctx->ff) != len)
     {
       grub_util_error (_("cannot write to `%s': %s"),
@@ -199,7 +232,7 @@ cp_hook (grub_off_t ofs, char *buf, int len, void *_ctx)
 static void
 cmd_cp (char *src, const char *dest)
 {
-  struct cp_hook_ctx ctx = 
+  struct cp_hook_ctx ctx =
     {
       .dest = dest
     };
@@ -212,6 +245,11 @@ cmd_cp (char *src, const char *dest)
       return;
     }
   read_file (src, cp_hook, &ctx);
+  /* A trailing hole still has to set the file size; one explicit zero
+     byte at the end does that without ftruncate.  */
+  if (ctx.hole
+      && (fseeko (ctx.ff, ctx.hole - 1, SEEK_CUR) || fputc (0, ctx.ff) == EOF))
+    grub_util_error (_("cannot write to `%s': %s"), dest, strerror (errno));
   fclose (ctx.ff);
 }
 
@@ -367,6 +405,171 @@ cmd_crc (char *pathname)
   free (crc32_context);
 }
 
+/* Run a command list from SCRIPT (stdin if NULL) against the already
+   mounted images, timing each operation.  One process and one mount for
+   a whole corpus instead of one per file.  */
+static void
+cmd_batch (const char *script)
+{
+  FILE *f = stdin;
+  char line[4096];
+
+  if (script && strcmp (script, "-") != 0)
+    {
+      f = grub_util_fopen (script, "r");
+      if (!f)
+	grub_util_error (_("cannot open `%s': %s"), script,
+			 strerror (errno));
+    }
+
+  while (fgets (line, sizeof (line), f))
+    {
+      char *argv[9];
+      char *p = line;
+      int argn = 0;
+      grub_uint64_t start;
+
+      line[strcspn (line, "\r\n")] = '\0';
+      while (*p && argn < 9)
+	{
+	  while (*p == ' ' || *p == '\t')
+	    *p++ = '\0';
+	  if (!*p)
+	    break;
+	  argv[argn++] = p;
+	  while (*p && *p != ' ' && *p != '\t')
+	    p++;
+	}
+      if (argn == 0 || argv[0][0] == '#')
+	continue;
+
+      start = grub_get_time_ms ();
+      if (strcmp (argv[0], "cp") == 0 && argn >= 3)
+	cmd_cp (argv[1], argv[2]);
+      else if (strcmp (argv[0], "cat") == 0 && argn >= 2)
+	cmd_cat (argv[1]);
+      else if (strcmp (argv[0], "cmp") == 0 && argn >= 3)
+	cmd_cmp (argv[1], argv[2]);
+      else if (strcmp (argv[0], "hex") == 0 && argn >= 2)
+	cmd_hex (argv[1]);
+      else if (strcmp (argv[0], "crc") == 0 && argn >= 2)
+	cmd_crc (argv[1]);
+      else if (strcmp (argv[0], "ls") == 0
+	       || strcmp (argv[0], "blocklist") == 0
+	       || strcmp (argv[0], "testload") == 0
+	       || strcmp (argv[0], "zfsinfo") == 0
+	       || strcmp (argv[0], "benchcrypto") == 0)
+	execute_command (argv[0], argn - 1, argv + 1);
+      else
+	{
+	  fprintf (stderr, _("skipping unknown batch command `%s'\n"),
+		   argv[0]);
+	  continue;
+	}
+      fprintf (stderr, "# %s: %llu ms\n", argv[0],
+	       (unsigned long long) (grub_get_time_ms () - start));
+    }
+
+  if (f != stdin)
+    fclose (f);
+}
+
+/* Read one file completely, discarding the data.  Returns nonzero on
+   failure without terminating, unlike read_file.  */
+static int
+bench_read (const char *path, grub_uint64_t *bytes)
+{
+  static char buf[BUF_SIZE];
+  grub_file_t file;
+  grub_ssize_t sz;
+
+  file = grub_file_open (path, GRUB_FILE_TYPE_NO_DECOMPRESS
+			 | GRUB_FILE_TYPE_FSTEST);
+  if (!file)
+    {
+      grub_errno = GRUB_ERR_NONE;
+      return 1;
+    }
+  while ((sz = grub_file_read (file, buf, BUF_SIZE)) > 0)
+    *bytes += sz;
+  grub_file_close (file);
+  if (sz < 0)
+    {
+      grub_errno = GRUB_ERR_NONE;
+      return 1;
+    }
+  return 0;
+}
+
+static int
+compare_latency (const void *a, const void *b)
+{
+  grub_uint32_t va = *(const grub_uint32_t *) a;
+  grub_uint32_t vb = *(const grub_uint32_t *) b;
+
+  return va < vb ? -1 : va > vb;
+}
+
+/* Read every file named in MANIFEST (one path per line), then report
+   aggregate throughput and per-file latency percentiles.  */
+static void
+cmd_bench (const char *manifest)
+{
+  FILE *f;
+  char line[4096];
+  grub_uint32_t *lat = NULL;
+  grub_size_t nlat = 0, maxlat = 0;
+  grub_uint64_t bytes = 0, start, elapsed;
+  unsigned failures = 0;
+
+  f = grub_util_fopen (manifest, "r");
+  if (!f)
+    grub_util_error (_("cannot open `%s': %s"), manifest,
+		     strerror (errno));
+
+  start = grub_get_time_ms ();
+  while (fgets (line, sizeof (line), f))
+    {
+      grub_uint64_t t0;
+
+      line[strcspn (line, "\r\n")] = '\0';
+      if (!line[0] || line[0] == '#')
+	continue;
+      if (nlat == maxlat)
+	{
+	  maxlat = maxlat ? 2 * maxlat : 1024;
+	  lat = xrealloc (lat, maxlat * sizeof (lat[0]));
+	}
+      t0 = grub_get_time_ms ();
+      if (bench_read (line, &bytes))
+	{
+	  failures++;
+	  continue;
+	}
+      lat[nlat++] = grub_get_time_ms () - t0;
+    }
+  elapsed = grub_get_time_ms () - start;
+  fclose (f);
+
+  printf (_("Files: %llu (%u failed)\n"),
+	  (unsigned long long) nlat, failures);
+  printf (_("Bytes: %llu in %llu ms\n"),
+	  (unsigned long long) bytes, (unsigned long long) elapsed);
+  if (elapsed)
+    printf (_("Throughput: %s\n"),
+	    grub_get_human_size (grub_divmod64 (bytes * 100ULL * 1000ULL,
+						elapsed, 0),
+				 GRUB_HUMAN_SIZE_SPEED));
+  if (nlat)
+    {
+      qsort (lat, nlat, sizeof (lat[0]), compare_latency);
+      printf (_("Latency (ms): min %u p50 %u p90 %u p99 %u max %u\n"),
+	      lat[0], lat[(nlat - 1) / 2], lat[(nlat - 1) * 9 / 10],
+	      lat[(nlat - 1) * 99 / 100], lat[nlat - 1]);
+    }
+  free (lat);
+}
+
 static const char *root = NULL;
 static int args_count = 0;
 static int nparm = 0;
@@ -458,6 +661,15 @@ fstest (int n)
       execute_command ("testload", n, args);
       grub_printf ("\n");
       break;
+    case CMD_BENCHCRYPTO:
+      execute_command ("benchcrypto", n, args);
+      break;
+    case CMD_BATCH:
+      cmd_batch (n ? args[0] : NULL);
+      break;
+    case CMD_BENCH:
+      cmd_bench (args[0]);
+      break;
     case CMD_XNU_UUID:
       {
 	grub_device_t dev;
@@ -512,6 +724,9 @@ static struct argp_option options[] = {
   {N_("crc FILE"), 0, 0     , OPTION_DOC, N_("Get crc32 checksum of FILE."), 1},
   {N_("blocklist FILE"), 0, 0, OPTION_DOC, N_("Display blocklist of FILE."), 1},
   {N_("xnu_uuid DEVICE"), 0, 0, OPTION_DOC, N_("Compute XNU UUID of the device."), 1},
+  {N_("benchcrypto [PRIMITIVE ...]"), 0, 0, OPTION_DOC, N_("Benchmark crypto and checksum primitives."), 1},
+  {N_("batch [FILE]"), 0, 0, OPTION_DOC, N_("Execute a command list from FILE (or stdin) against one mount, timing each operation."), 1},
+  {N_("bench MANIFEST"), 0, 0, OPTION_DOC, N_("Read all files listed in MANIFEST and report throughput and latency percentiles."), 1},
   
   {"root",      'r', N_("DEVICE_NAME"), 0, N_("Set root device."),                 2},
   {"skip",      's', N_("NUM"),           0, N_("Skip N bytes from output file."),   2},
@@ -706,6 +921,21 @@ argp_parser (int key, char *arg, struct argp_state *state)
 	  cmd = CMD_XNU_UUID;
 	  nparm = 0;
 	}
+      else if (grub_strcmp (arg, "benchcrypto") == 0)
+	{
+	  cmd = CMD_BENCHCRYPTO;
+	  nparm = 0;
+	}
+      else if (grub_strcmp (arg, "batch") == 0)
+	{
+	  cmd = CMD_BATCH;
+	  nparm = 0;
+	}
+      else if (grub_strcmp (arg, "bench") == 0)
+	{
+	  cmd = CMD_BENCH;
+	  nparm = 1;
+	}
       else
 	{
 	  fprintf (stderr, _("Invalid command %s.\n"), arg);
@@ -75,14 +75,68 @@ static int (*compress_func) (const char *src, const char *dest) = NULL;
 char *grub_install_copy_buffer;
 static char *dtb;
 
+/* Return 1 if DST already has exactly the contents of SRC.  Rereading
+   the target is much cheaper than rewriting it on flash media, and on a
+   repeat install most files are unchanged.  */
+static int
+grub_install_is_same_file (const char *src, const char *dst)
+{
+  grub_util_fd_t in, out;
+  char *cmp_buffer;
+  ssize_t r1, r2;
+  int ret = 0;
+
+  in = grub_util_fd_open (src, GRUB_UTIL_FD_O_RDONLY);
+  if (!GRUB_UTIL_FD_IS_VALID (in))
+    return 0;
+  out = grub_util_fd_open (dst, GRUB_UTIL_FD_O_RDONLY);
+  if (!GRUB_UTIL_FD_IS_VALID (out))
+    {
+      grub_util_fd_close (in);
+      return 0;
+    }
+
+  if (!grub_install_copy_buffer)
+    grub_install_copy_buffer = xmalloc (GRUB_INSTALL_COPY_BUFFER_SIZE);
+  cmp_buffer = xmalloc (GRUB_INSTALL_COPY_BUFFER_SIZE);
+
+  while (1)
+    {
+      r1 = grub_util_fd_read (in, grub_install_copy_buffer,
+			      GRUB_INSTALL_COPY_BUFFER_SIZE);
+      r2 = grub_util_fd_read (out, cmp_buffer,
+			      GRUB_INSTALL_COPY_BUFFER_SIZE);
+      if (r1 < 0 || r1 != r2)
+	break;
+      if (r1 == 0)
+	{
+	  ret = 1;
+	  break;
+	}
+      if (memcmp (grub_install_copy_buffer, cmp_buffer, r1) != 0)
+	break;
+    }
+
+  free (cmp_buffer);
+  grub_util_fd_close (in);
+  grub_util_fd_close (out);
+  return ret;
+}
+
 int
 grub_install_copy_file (const char *src,
 			const char *dst,
 			int is_needed)
 {
-  grub_util_fd_t in, out;  
+  grub_util_fd_t in, out;
   ssize_t r;
 
+  if (grub_install_is_same_file (src, dst))
+    {
+      grub_util_info ("`%s' is up to date, not copying `%s'", dst, src);
+      return 1;
+    }
+
   grub_util_info ("copying `%s' -> `%s'", src, dst);
 
   in = grub_util_fd_open (src, GRUB_UTIL_FD_O_RDONLY);
@@ -60,6 +60,11 @@
 
 
 
+enum
+  {
+    OPTION_MODULE_ORDER = 0x301
+  };
+
 static struct argp_option options[] = {
   {"directory",  'd', N_("DIR"), 0,
    /* TRANSLATORS: platform here isn't identifier. It can be translated.  */
@@ -83,6 +88,8 @@ static struct argp_option options[] = {
   {"format",  'O', N_("FORMAT"), 0, 0, 0},
   {"compression",  'C', "(xz|none|auto)", 0, N_("choose the compression to use for core image"), 0},
   {"sbat", 's', N_("FILE"), 0, N_("SBAT metadata"), 0},
+  {"module-order", OPTION_MODULE_ORDER, N_("FILE"), 0,
+   N_("lay out modules listed in FILE (one per line, e.g. from boot profiling) ahead of the others in the core image"), 0},
   {"disable-shim-lock", GRUB_INSTALL_OPTIONS_DISABLE_SHIM_LOCK, 0, 0, N_("disable shim_lock verifier"), 0},
   {"verbose",     'v', 0,      0, N_("print verbose messages."), 0},
   {"appended-signature-size", 'S', N_("SIZE"), 0, N_("Add a note segment reserving SIZE bytes for an appended signature"), 0},
@@ -130,6 +137,7 @@ struct arguments
   char *font;
   char *config;
   char *sbat;
+  char *module_order;
   int note;
   int disable_shim_lock;
   size_t appsig_size;
@@ -255,6 +263,13 @@ argp_parser (int key, char *arg, struct argp_state *state)
       arguments->sbat = xstrdup (arg);
       break;
 
+    case OPTION_MODULE_ORDER:
+      if (arguments->module_order)
+	free (arguments->module_order);
+
+      arguments->module_order = xstrdup (arg);
+      break;
+
     case GRUB_INSTALL_OPTIONS_DISABLE_SHIM_LOCK:
       arguments->disable_shim_lock = 1;
       break;
@@ -273,6 +288,56 @@ argp_parser (int key, char *arg, struct argp_state *state)
   return 0;
 }
 
+/* Move the modules named in FILENAME (one per line, first-used first,
+   e.g. as reported by boottime instrumentation) to the front of the
+   module list, keeping the relative order of the rest.
+   grub_util_resolve_dependencies () expands each module's dependencies
+   ahead of the module itself, so the reordered image stays loadable;
+   names in FILENAME that were not requested are ignored, so the image
+   contents do not change, only their layout.  */
+static void
+reorder_modules (const char *filename, char **modules, size_t nmodules)
+{
+  FILE *f;
+  char **ordered;
+  size_t nordered = 0, i;
+  char line[1024];
+
+  f = grub_util_fopen (filename, "r");
+  if (! f)
+    grub_util_error (_("cannot open `%s': %s"), filename,
+		     strerror (errno));
+
+  ordered = xcalloc (nmodules, sizeof (ordered[0]));
+
+  while (fgets (line, sizeof (line), f))
+    {
+      char *ptr = line + strlen (line);
+      while (ptr > line && (ptr[-1] == '\n' || ptr[-1] == '\r'))
+	*--ptr = '\0';
+      if (line[0] == '\0' || line[0] == '#')
+	continue;
+      for (i = 0; i < nmodules; i++)
+	if (modules[i] && strcmp (modules[i], line) == 0)
+	  {
+	    ordered[nordered++] = modules[i];
+	    modules[i] = NULL;
+	    break;
+	  }
+    }
+
+  fclose (f);
+
+  /* Modules the profile doesn't mention follow in their original
+     order.  */
+  for (i = 0; i < nmodules; i++)
+    if (modules[i])
+      ordered[nordered++] = modules[i];
+
+  memcpy (modules, ordered, nmodules * sizeof (modules[0]));
+  free (ordered);
+}
+
 static struct argp argp = {
   options, argp_parser, N_("[OPTION]... [MODULES]"),
   N_("Make a bootable image of GRUB."),
@@ -287,6 +352,9 @@ main (int argc, char *argv[])
   unsigned i;
 
   grub_util_host_init (&argc, &argv);
+  /* Every module is stat'ed during layout and read again during
+     assembly; cache the results.  */
+  grub_util_enable_image_cache ();
 
   memset (&arguments, 0, sizeof (struct arguments));
   arguments.comp = GRUB_COMPRESSION_AUTO;
@@ -339,6 +407,10 @@ main (int argc, char *argv[])
       strcpy (ptr, dn);
     }
 
+  if (arguments.module_order)
+    reorder_modules (arguments.module_order, arguments.modules,
+		     arguments.nmodules);
+
   grub_install_generate_image (arguments.dir, arguments.prefix, fp,
 			       arguments.output, arguments.modules,
 			       arguments.memdisk, arguments.pubkeys,
@@ -369,5 +441,8 @@ main (int argc, char *argv[])
   if (arguments.sbat)
     free (arguments.sbat);
 
+  if (arguments.module_order)
+    free (arguments.module_order);
+
   return 0;
 }
@@ -0,0 +1,125 @@
+/*
+ *  GRUB  --  GRand Unified Bootloader
+ *  Copyright (C) 2026  Free Software Foundation, Inc.
+ *
+ *  GRUB is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GRUB is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GRUB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#include <grub/types.h>
+#include <grub/modbundle.h>
+#include <grub/util/misc.h>
+#include <grub/misc.h>
+#include <grub/i18n.h>
+
+/* Write SIZE zero bytes so the next write is aligned.  */
+static void
+write_padding (FILE *out, size_t size)
+{
+  static const char zero[GRUB_MODBUNDLE_ALIGN];
+
+  if (size && fwrite (zero, 1, size, out) != size)
+    grub_util_error (_("cannot write to the output file: %s"),
+		     strerror (errno));
+}
+
+/* Return the module name of PATH: the basename without a .mod suffix.  */
+static char *
+module_name (const char *path)
+{
+  const char *base = strrchr (path, '/');
+  char *name, *p;
+
+  base = base ? base + 1 : path;
+  name = xstrdup (base);
+  p = strrchr (name, '.');
+  if (p && strcmp (p, ".mod") == 0)
+    *p = '\0';
+
+  return name;
+}
+
+int
+main (int argc, char **argv)
+{
+  FILE *out;
+  const char *out_fname = NULL;
+  struct grub_modbundle_header head;
+  int first_mod, i;
+
+  grub_util_host_init (&argc, &argv);
+
+  if (argc >= 2 && strcmp (argv[1], "-o") == 0 && argc >= 3)
+    {
+      out_fname = argv[2];
+      first_mod = 3;
+    }
+  else
+    first_mod = argc;
+
+  if (first_mod >= argc)
+    {
+      fprintf (stdout, _("Usage: %s -o OUTFILE MODULE.mod ...\n"), argv[0]);
+      return argc >= 2 && argv[1][0] == '-' && argv[1][1] == 'h' ? 0 : 1;
+    }
+
+  out = grub_util_fopen (out_fname, "wb");
+  if (!out)
+    grub_util_error (_("cannot open `%s': %s"), out_fname, strerror (errno));
+
+  memcpy (head.magic, GRUB_MODBUNDLE_MAGIC, GRUB_MODBUNDLE_MAGIC_SIZE);
+  head.nmods = grub_cpu_to_le32 (argc - first_mod);
+  head.reserved = 0;
+  if (fwrite (&head, 1, sizeof (head), out) != sizeof (head))
+    grub_util_error (_("cannot write to `%s': %s"), out_fname,
+		     strerror (errno));
+
+  for (i = first_mod; i < argc; i++)
+    {
+      struct grub_modbundle_entry entry;
+      char *name = module_name (argv[i]);
+      size_t namelen = strlen (name) + 1;
+      size_t modlen;
+      char *mod = grub_util_read_image (argv[i]);
+
+      modlen = grub_util_get_image_size (argv[i]);
+
+      entry.namelen = grub_cpu_to_le32 (namelen);
+      entry.modlen = grub_cpu_to_le32 (modlen);
+      if (fwrite (&entry, 1, sizeof (entry), out) != sizeof (entry)
+	  || fwrite (name, 1, namelen, out) != namelen)
+	grub_util_error (_("cannot write to `%s': %s"), out_fname,
+			 strerror (errno));
+      write_padding (out, ALIGN_UP (namelen, GRUB_MODBUNDLE_ALIGN) - namelen);
+
+      if (fwrite (mod, 1, modlen, out) != modlen)
+	grub_util_error (_("cannot write to `%s': %s"), out_fname,
+			 strerror (errno));
+      write_padding (out, ALIGN_UP (modlen, GRUB_MODBUNDLE_ALIGN) - modlen);
+
+      free (mod);
+      free (name);
+    }
+
+  if (fclose (out) == EOF)
+    grub_util_error (_("cannot write to `%s': %s"), out_fname,
+		     strerror (errno));
+
+  return 0;
+}
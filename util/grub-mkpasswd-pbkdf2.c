@@ -46,6 +46,7 @@ static struct argp_option options[] = {
   {"iteration-count",  'c', N_("NUM"), 0, N_("Number of PBKDF2 iterations"), 0},
   {"buflen",  'l', N_("NUM"), 0, N_("Length of generated hash"), 0},
   {"salt",  's', N_("NUM"), 0, N_("Length of salt"), 0},
+  {"batch",  'b', 0, 0, N_("Read passwords from stdin, one per line, and print one hash per line"), 0},
   { 0, 0, 0, 0, 0, 0 }
 };
 
@@ -54,6 +55,7 @@ struct arguments
   unsigned int count;
   unsigned int buflen;
   unsigned int saltlen;
+  int batch;
 };
 
 static error_t
@@ -76,6 +78,10 @@ argp_parser (int key, char *arg, struct argp_state *state)
     case 's':
       arguments->saltlen = strtoul (arg, NULL, 0);
       break;
+
+    case 'b':
+      arguments->batch = 1;
+      break;
     default:
       return ARGP_ERR_UNKNOWN;
     }
@@ -110,16 +116,63 @@ hexify (char *hex, grub_uint8_t *bin, grub_size_t n)
   *hex = 0;
 }
 
+/* Derive one hash for PASS with a fresh random salt and return the
+   formatted grub.pbkdf2.sha512 string, or NULL with a message printed
+   to stderr.  BUF and SALT are caller-provided scratch so a batch of
+   derivations does not reallocate them per password.  */
+static char *
+make_hash (const char *pass, struct arguments *arguments,
+	   grub_uint8_t *buf, grub_uint8_t *salt)
+{
+  char *result, *ptr;
+  gcry_err_code_t gcry_err;
+
+  if (grub_get_random (salt, arguments->saltlen))
+    {
+      fprintf (stderr, "%s\n", _("couldn't retrieve random data for salt"));
+      return NULL;
+    }
+
+  gcry_err = grub_crypto_pbkdf2 (GRUB_MD_SHA512,
+				 (const grub_uint8_t *) pass, strlen (pass),
+				 salt, arguments->saltlen,
+				 arguments->count, buf, arguments->buflen);
+  if (gcry_err)
+    {
+      fprintf (stderr, _("cryptographic error number %d"), gcry_err);
+      fprintf (stderr, "\n");
+      return NULL;
+    }
+
+  result = xmalloc (sizeof ("grub.pbkdf2.sha512.XXXXXXXXXXXXXXXXXXX.S.S")
+		    + arguments->buflen * 2 + arguments->saltlen * 2);
+  ptr = result;
+  memcpy (ptr, "grub.pbkdf2.sha512.", sizeof ("grub.pbkdf2.sha512.") - 1);
+  ptr += sizeof ("grub.pbkdf2.sha512.") - 1;
+
+  grub_snprintf (ptr, sizeof ("XXXXXXXXXXXXXXXXXXX"), "%d", arguments->count);
+  ptr += strlen (ptr);
+  *ptr++ = '.';
+  hexify (ptr, salt, arguments->saltlen);
+  ptr += arguments->saltlen * 2;
+  *ptr++ = '.';
+  hexify (ptr, buf, arguments->buflen);
+  ptr += arguments->buflen * 2;
+  *ptr = '\0';
+
+  return result;
+}
+
 int
 main (int argc, char *argv[])
 {
   struct arguments arguments = {
     .count = 10000,
     .buflen = 64,
-    .saltlen = 64
+    .saltlen = 64,
+    .batch = 0
   };
-  char *result, *ptr;
-  gcry_err_code_t gcry_err;
+  char *result;
   grub_uint8_t *buf, *salt;
   char pass1[GRUB_AUTH_MAX_PASSLEN];
   char pass2[GRUB_AUTH_MAX_PASSLEN];
@@ -135,7 +188,42 @@ main (int argc, char *argv[])
 
   buf = xmalloc (arguments.buflen);
   salt = xmalloc (arguments.saltlen);
-  
+
+  if (arguments.batch)
+    {
+      char *line = NULL;
+      size_t linesz = 0;
+      ssize_t len;
+      int err = 0;
+
+      /* One password per line, no prompt and no confirmation, so a
+	 provisioning run can push a whole batch through a single
+	 process (or several, split across cores).  */
+      while ((len = getline (&line, &linesz, stdin)) >= 0)
+	{
+	  if (len > 0 && line[len - 1] == '\n')
+	    line[len - 1] = '\0';
+
+	  result = make_hash (line, &arguments, buf, salt);
+	  memset (line, 0, linesz);
+	  if (!result)
+	    {
+	      err = 1;
+	      break;
+	    }
+	  printf ("%s\n", result);
+	  free (result);
+	}
+
+      free (line);
+      memset (buf, 0, arguments.buflen);
+      free (buf);
+      memset (salt, 0, arguments.saltlen);
+      free (salt);
+
+      return err;
+    }
+
   printf ("%s", _("Enter password: "));
   if (!grub_password_get (pass1, GRUB_AUTH_MAX_PASSLEN))
     {
@@ -161,50 +249,17 @@ main (int argc, char *argv[])
     }
   memset (pass2, 0, sizeof (pass2));
 
-  if (grub_get_random (salt, arguments.saltlen))
-    {
-      memset (pass1, 0, sizeof (pass1));
-      free (buf);
-      free (salt);
-      grub_util_error ("%s", _("couldn't retrieve random data for salt"));
-    }
-
-  gcry_err = grub_crypto_pbkdf2 (GRUB_MD_SHA512,
-				 (grub_uint8_t *) pass1, strlen (pass1),
-				 salt, arguments.saltlen,
-				 arguments.count, buf, arguments.buflen);
+  result = make_hash (pass1, &arguments, buf, salt);
   memset (pass1, 0, sizeof (pass1));
-
-  if (gcry_err)
-    {
-      memset (buf, 0, arguments.buflen);
-      free (buf);
-      memset (salt, 0, arguments.saltlen);
-      free (salt);
-      grub_util_error (_("cryptographic error number %d"), gcry_err);
-    }
-
-  result = xmalloc (sizeof ("grub.pbkdf2.sha512.XXXXXXXXXXXXXXXXXXX.S.S")
-		    + arguments.buflen * 2 + arguments.saltlen * 2);
-  ptr = result;
-  memcpy (ptr, "grub.pbkdf2.sha512.", sizeof ("grub.pbkdf2.sha512.") - 1);
-  ptr += sizeof ("grub.pbkdf2.sha512.") - 1;
-  
-  grub_snprintf (ptr, sizeof ("XXXXXXXXXXXXXXXXXXX"), "%d", arguments.count);
-  ptr += strlen (ptr);
-  *ptr++ = '.';
-  hexify (ptr, salt, arguments.saltlen);
-  ptr += arguments.saltlen * 2;
-  *ptr++ = '.';
-  hexify (ptr, buf, arguments.buflen);
-  ptr += arguments.buflen * 2;
-  *ptr = '\0';
-
-  printf (_("PBKDF2 hash of your password is %s\n"), result);
   memset (buf, 0, arguments.buflen);
   free (buf);
   memset (salt, 0, arguments.saltlen);
   free (salt);
+  if (!result)
+    exit (1);
+
+  printf (_("PBKDF2 hash of your password is %s\n"), result);
+  free (result);
 
   return 0;
 }
@@ -433,6 +433,8 @@ main (int argc, char *argv[])
 
   grub_util_host_init (&argc, &argv);
   grub_util_disable_fd_syncs ();
+  /* Several target images embed the same module files; read them once.  */
+  grub_util_enable_image_cache ();
 
   pkgdatadir = grub_util_get_pkgdatadir ();
 
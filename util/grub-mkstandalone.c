@@ -295,6 +295,7 @@ main (int argc, char *argv[])
 
   grub_util_host_init (&argc, &argv);
   grub_util_disable_fd_syncs ();
+  grub_util_enable_image_cache ();
 
   files = xcalloc (argc + 1, sizeof (files[0]));
 
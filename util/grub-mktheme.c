@@ -0,0 +1,412 @@
+/*
+ *  GRUB  --  GRand Unified Bootloader
+ *  Copyright (C) 2026  Free Software Foundation, Inc.
+ *
+ *  GRUB is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GRUB is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GRUB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <config.h>
+
+#include <grub/util/misc.h>
+#include <grub/i18n.h>
+#include <grub/emu/hostdisk.h>
+#include <grub/emu/hostfile.h>
+#include <grub/emu/misc.h>
+#include <grub/bitmap.h>
+#include <grub/bitmap_scale.h>
+#include <grub/gbm.h>
+#include <grub/misc.h>
+#include <grub/mm.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#pragma GCC diagnostic ignored "-Wmissing-prototypes"
+#pragma GCC diagnostic ignored "-Wmissing-declarations"
+#include <argp.h>
+#pragma GCC diagnostic error "-Wmissing-prototypes"
+#pragma GCC diagnostic error "-Wmissing-declarations"
+
+#include "progname.h"
+
+/*
+ * grub-mktheme compiles a gfxmenu theme directory: every PNG/JPEG/TGA
+ * image is decoded once, at build time, and written back out as a .gbm
+ * file in the raw layout the gbm reader loads with a single read.
+ * References in theme.txt are rewritten to the new file names.  With
+ * --resolution the desktop image is additionally pre-scaled to the
+ * display size so the boot-time scaling pass is skipped too.
+ */
+
+struct arguments
+{
+  char *input;
+  char *output;
+  int width;
+  int height;
+  int verbosity;
+};
+
+static struct argp_option options[] = {
+  {"output",  'o', N_("DIR"), 0,
+   N_("write the compiled theme to DIR."), 0},
+  {"resolution",  'r', N_("WIDTHxHEIGHT"), 0,
+   N_("pre-scale the desktop image for the given display resolution."), 0},
+  {"verbose",     'v', 0,      0, N_("print verbose messages."), 0},
+  { 0, 0, 0, 0, 0, 0 }
+};
+
+static error_t
+argp_parser (int key, char *arg, struct argp_state *state)
+{
+  struct arguments *arguments = state->input;
+
+  switch (key)
+    {
+    case 'o':
+      arguments->output = xstrdup (arg);
+      break;
+
+    case 'r':
+      {
+	char *end;
+	arguments->width = strtol (arg, &end, 10);
+	if (*end != 'x')
+	  argp_usage (state);
+	arguments->height = strtol (end + 1, &end, 10);
+	if (*end || arguments->width <= 0 || arguments->height <= 0)
+	  argp_usage (state);
+      }
+      break;
+
+    case 'v':
+      arguments->verbosity++;
+      break;
+
+    case ARGP_KEY_ARG:
+      if (arguments->input)
+	argp_usage (state);
+      arguments->input = xstrdup (arg);
+      break;
+
+    default:
+      return ARGP_ERR_UNKNOWN;
+    }
+  return 0;
+}
+
+static struct argp argp = {
+  options, argp_parser, N_("THEME_DIR"),
+  N_("Compile a gfxmenu theme directory for fast loading."),
+  NULL, NULL, NULL
+};
+
+/* The basename of the image named by the desktop-image property of
+   theme.txt, or NULL.  Only that image is pre-scaled.  */
+static char *desktop_image;
+
+/* Renames performed, for patching theme.txt afterwards.  */
+struct rename
+{
+  struct rename *next;
+  char *from;
+  char *to;
+};
+static struct rename *renames;
+
+static int width, height, verbosity;
+
+static const char *image_exts[] = { ".png", ".jpg", ".jpeg", ".tga", NULL };
+
+static const char *
+image_extension (const char *name)
+{
+  size_t len = strlen (name);
+  int i;
+
+  for (i = 0; image_exts[i]; i++)
+    {
+      size_t extlen = strlen (image_exts[i]);
+      if (len > extlen && strcasecmp (name + len - extlen,
+				      image_exts[i]) == 0)
+	return name + len - extlen;
+    }
+  return NULL;
+}
+
+/* Extract the basename of the desktop-image property from the theme.txt
+   contents in BUF so convert_image knows which file to pre-scale.  */
+static void
+find_desktop_image (const char *buf)
+{
+  const char *p, *start, *end, *base;
+
+  p = strstr (buf, "desktop-image");
+  if (!p)
+    return;
+  start = strchr (p, '"');
+  if (!start)
+    return;
+  end = strchr (start + 1, '"');
+  if (!end)
+    return;
+
+  for (base = end; base > start && *base != '/'; base--);
+  base++;
+  desktop_image = xmalloc (end - base + 1);
+  memcpy (desktop_image, base, end - base);
+  desktop_image[end - base] = '\0';
+}
+
+static void
+write_file (const char *path, const void *data, size_t len)
+{
+  FILE *out = grub_util_fopen (path, "wb");
+
+  if (!out)
+    grub_util_error (_("cannot open `%s': %s"), path, strerror (errno));
+  if (len && fwrite (data, 1, len, out) != len)
+    grub_util_error (_("cannot write to `%s': %s"), path, strerror (errno));
+  if (fclose (out) == EOF)
+    grub_util_error (_("cannot write to `%s': %s"), path, strerror (errno));
+}
+
+static void
+convert_image (const char *in_path, const char *out_path, const char *name)
+{
+  struct grub_video_bitmap *bitmap = NULL;
+  struct grub_gbm_header head;
+  char *grub_path, *canonical;
+  struct grub_video_mode_info *info;
+  grub_uint32_t format;
+  FILE *out;
+  size_t data_size;
+
+  canonical = grub_canonicalize_file_name (in_path);
+  if (!canonical)
+    grub_util_error (_("cannot open `%s': %s"), in_path, strerror (errno));
+  grub_path = xasprintf ("(host)/%s", canonical);
+  free (canonical);
+
+  if (grub_video_bitmap_load (&bitmap, grub_path) != GRUB_ERR_NONE)
+    grub_util_error (_("cannot open `%s': %s"), in_path, grub_errmsg);
+  free (grub_path);
+
+  /* Pre-scale the desktop image to the display resolution.  */
+  if (width > 0 && desktop_image && strcmp (name, desktop_image) == 0
+      && ((int) grub_video_bitmap_get_width (bitmap) != width
+	  || (int) grub_video_bitmap_get_height (bitmap) != height))
+    {
+      struct grub_video_bitmap *scaled = NULL;
+
+      if (grub_video_bitmap_create_scaled (&scaled, width, height, bitmap,
+					   GRUB_VIDEO_BITMAP_SCALE_METHOD_BEST)
+	  != GRUB_ERR_NONE)
+	grub_util_error (_("cannot scale `%s': %s"), in_path, grub_errmsg);
+      grub_video_bitmap_destroy (bitmap);
+      bitmap = scaled;
+    }
+
+  info = &bitmap->mode_info;
+  if (info->blit_format == GRUB_VIDEO_BLIT_FORMAT_RGBA_8888)
+    format = GRUB_GBM_FORMAT_RGBA8888;
+  else if (info->blit_format == GRUB_VIDEO_BLIT_FORMAT_RGB_888)
+    format = GRUB_GBM_FORMAT_RGB888;
+  else
+    grub_util_error (_("`%s' decoded to an unexpected pixel format"),
+		     in_path);
+
+  memcpy (head.magic, GRUB_GBM_MAGIC, GRUB_GBM_MAGIC_SIZE);
+  head.width = grub_cpu_to_le32 (info->width);
+  head.height = grub_cpu_to_le32 (info->height);
+  head.format = grub_cpu_to_le32 (format);
+  head.reserved = 0;
+  data_size = (size_t) info->pitch * info->height;
+
+  out = grub_util_fopen (out_path, "wb");
+  if (!out)
+    grub_util_error (_("cannot open `%s': %s"), out_path, strerror (errno));
+  if (fwrite (&head, 1, sizeof (head), out) != sizeof (head)
+      || fwrite (bitmap->data, 1, data_size, out) != data_size
+      || fclose (out) == EOF)
+    grub_util_error (_("cannot write to `%s': %s"), out_path,
+		     strerror (errno));
+
+  grub_video_bitmap_destroy (bitmap);
+}
+
+static void
+process_dir (const char *in_dir, const char *out_dir)
+{
+  grub_util_fd_dir_t dir;
+  grub_util_fd_dirent_t entry;
+
+  dir = grub_util_fd_opendir (in_dir);
+  if (!dir)
+    grub_util_error (_("cannot open directory `%s': %s"), in_dir,
+		     strerror (errno));
+
+  while ((entry = grub_util_fd_readdir (dir)))
+    {
+      const char *name = entry->d_name;
+      const char *ext;
+      char *in_path, *out_path;
+
+      if (strcmp (name, ".") == 0 || strcmp (name, "..") == 0)
+	continue;
+
+      in_path = grub_util_path_concat (2, in_dir, name);
+
+      if (grub_util_is_directory (in_path))
+	{
+	  out_path = grub_util_path_concat (2, out_dir, name);
+	  grub_util_mkdir (out_path);
+	  process_dir (in_path, out_path);
+	}
+      else if ((ext = image_extension (name)))
+	{
+	  struct rename *r = xmalloc (sizeof (*r));
+	  char *newname;
+
+	  newname = xmalloc (ext - name + sizeof (".gbm"));
+	  memcpy (newname, name, ext - name);
+	  strcpy (newname + (ext - name), ".gbm");
+
+	  out_path = grub_util_path_concat (2, out_dir, newname);
+	  if (verbosity)
+	    printf (_("compiling `%s' to `%s'\n"), in_path, out_path);
+	  convert_image (in_path, out_path, name);
+
+	  r->from = xstrdup (name);
+	  r->to = newname;
+	  r->next = renames;
+	  renames = r;
+	}
+      else if (strcmp (name, "theme.txt") != 0)
+	{
+	  /* Fonts and other assets are copied verbatim; theme.txt is
+	     written last, with image references rewritten.  */
+	  size_t size = grub_util_get_image_size (in_path);
+	  char *data = grub_util_read_image (in_path);
+
+	  out_path = grub_util_path_concat (2, out_dir, name);
+	  write_file (out_path, data, size);
+	  free (data);
+	}
+      else
+	out_path = NULL;
+
+      free (out_path);
+      free (in_path);
+    }
+
+  grub_util_fd_closedir (dir);
+}
+
+/* Write OUT_DIR/theme.txt from the original contents in BUF, with each
+   converted image name replaced by its .gbm counterpart.  */
+static void
+emit_theme_txt (const char *buf, size_t size, const char *out_dir)
+{
+  char *out_path = grub_util_path_concat (2, out_dir, "theme.txt");
+  FILE *out = grub_util_fopen (out_path, "wb");
+  size_t i;
+
+  if (!out)
+    grub_util_error (_("cannot open `%s': %s"), out_path, strerror (errno));
+
+  for (i = 0; i < size; )
+    {
+      struct rename *r;
+
+      for (r = renames; r; r = r->next)
+	{
+	  size_t len = strlen (r->from);
+	  if (len <= size - i && memcmp (buf + i, r->from, len) == 0)
+	    break;
+	}
+      if (r)
+	{
+	  if (fwrite (r->to, 1, strlen (r->to), out) != strlen (r->to))
+	    grub_util_error (_("cannot write to `%s': %s"), out_path,
+			     strerror (errno));
+	  i += strlen (r->from);
+	}
+      else
+	{
+	  if (fputc (buf[i], out) == EOF)
+	    grub_util_error (_("cannot write to `%s': %s"), out_path,
+			     strerror (errno));
+	  i++;
+	}
+    }
+
+  if (fclose (out) == EOF)
+    grub_util_error (_("cannot write to `%s': %s"), out_path,
+		     strerror (errno));
+  free (out_path);
+}
+
+int
+main (int argc, char *argv[])
+{
+  struct arguments arguments;
+  char *theme_txt_path, *theme_txt = NULL;
+  size_t theme_txt_size = 0;
+
+  grub_util_host_init (&argc, &argv);
+
+  memset (&arguments, 0, sizeof (struct arguments));
+  if (argp_parse (&argp, argc, argv, 0, 0, &arguments) != 0)
+    {
+      fprintf (stderr, "%s", _("Error in parsing command line arguments\n"));
+      exit (1);
+    }
+
+  if (!arguments.input || !arguments.output)
+    grub_util_error ("%s", _("input theme directory and output directory "
+			     "are required"));
+
+  width = arguments.width;
+  height = arguments.height;
+  verbosity = arguments.verbosity;
+
+  grub_init_all ();
+  grub_hostfs_init ();
+  grub_host_init ();
+
+  theme_txt_path = grub_util_path_concat (2, arguments.input, "theme.txt");
+  if (grub_util_is_regular (theme_txt_path))
+    {
+      theme_txt_size = grub_util_get_image_size (theme_txt_path);
+      theme_txt = grub_util_read_image (theme_txt_path);
+      theme_txt = xrealloc (theme_txt, theme_txt_size + 1);
+      theme_txt[theme_txt_size] = '\0';
+      find_desktop_image (theme_txt);
+    }
+  free (theme_txt_path);
+
+  grub_util_mkdir (arguments.output);
+  process_dir (arguments.input, arguments.output);
+
+  if (theme_txt)
+    {
+      emit_theme_txt (theme_txt, theme_txt_size, arguments.output);
+      free (theme_txt);
+    }
+
+  return 0;
+}
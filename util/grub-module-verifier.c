@@ -204,31 +204,42 @@ main (int argc, char **argv)
 {
   size_t module_size;
   unsigned arch, whitelist;
+  int i;
+  const char *arch_name, *platform;
   const char **whitelist_empty = 0;
   char *module_img;
-  if (argc != 4) {
-    fprintf (stderr, "usage: %s FILE ARCH PLATFORM\n", argv[0]);
+  if (argc < 4) {
+    fprintf (stderr, "usage: %s FILE... ARCH PLATFORM\n", argv[0]);
     return 1;
   }
 
+  arch_name = argv[argc - 2];
+  platform = argv[argc - 1];
+
   for (arch = 0; arch < ARRAY_SIZE(archs); arch++)
-    if (strcmp(archs[arch].name, argv[2]) == 0)
+    if (strcmp(archs[arch].name, arch_name) == 0)
       break;
   if (arch == ARRAY_SIZE(archs))
-    grub_util_error("%s: unknown arch: %s", argv[1], argv[2]);
+    grub_util_error("%s: unknown arch: %s", argv[1], arch_name);
 
   for (whitelist = 0; whitelist < ARRAY_SIZE(whitelists); whitelist++)
-    if (strcmp(whitelists[whitelist].arch, argv[2]) == 0
-	&& strcmp(whitelists[whitelist].platform, argv[3]) == 0)
+    if (strcmp(whitelists[whitelist].arch, arch_name) == 0
+	&& strcmp(whitelists[whitelist].platform, platform) == 0)
       break;
   if (whitelist != ARRAY_SIZE(whitelists))
     whitelist_empty = whitelists[whitelist].whitelist_empty;
 
-  module_size = grub_util_get_image_size (argv[1]);
-  module_img = grub_util_read_image (argv[1]);
-  if (archs[arch].voidp_sizeof == 8)
-    grub_module_verify64(argv[1], module_img, module_size, &archs[arch], whitelist_empty);
-  else
-    grub_module_verify32(argv[1], module_img, module_size, &archs[arch], whitelist_empty);
+  /* Any number of modules can be checked by one invocation; batch
+     callers save a process spawn and arch lookup per module.  */
+  for (i = 1; i < argc - 2; i++)
+    {
+      module_size = grub_util_get_image_size (argv[i]);
+      module_img = grub_util_read_image (argv[i]);
+      if (archs[arch].voidp_sizeof == 8)
+	grub_module_verify64(argv[i], module_img, module_size, &archs[arch], whitelist_empty);
+      else
+	grub_module_verify32(argv[i], module_img, module_size, &archs[arch], whitelist_empty);
+      free (module_img);
+    }
   return 0;
 }
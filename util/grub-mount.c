@@ -121,6 +121,64 @@ translate_error (void)
   return ret;
 }
 
+/* The mount is read-only, so attributes can be cached for its whole
+   lifetime.  The cache is filled by getattr and readdir; the getattr
+   storm a directory listing triggers is then served from memory
+   instead of re-iterating the directory per file.  */
+#define ATTR_CACHE_BUCKETS 1021
+
+struct attr_cache_entry
+{
+  struct attr_cache_entry *next;
+  char *path;
+  struct stat st;
+};
+
+static struct attr_cache_entry *attr_cache[ATTR_CACHE_BUCKETS];
+
+static unsigned
+attr_cache_bucket (const char *path)
+{
+  unsigned h = 5381;
+
+  while (*path)
+    h = h * 33 + (unsigned char) *path++;
+  return h % ATTR_CACHE_BUCKETS;
+}
+
+static int
+attr_cache_lookup (const char *path, struct stat *st)
+{
+  struct attr_cache_entry *e;
+
+  for (e = attr_cache[attr_cache_bucket (path)]; e; e = e->next)
+    if (strcmp (e->path, path) == 0)
+      {
+	*st = e->st;
+	return 1;
+      }
+  return 0;
+}
+
+static void
+attr_cache_store (const char *path, const struct stat *st)
+{
+  unsigned bucket = attr_cache_bucket (path);
+  struct attr_cache_entry *e;
+
+  for (e = attr_cache[bucket]; e; e = e->next)
+    if (strcmp (e->path, path) == 0)
+      {
+	e->st = *st;
+	return;
+      }
+  e = xmalloc (sizeof (*e));
+  e->path = xstrdup (path);
+  e->st = *st;
+  e->next = attr_cache[bucket];
+  attr_cache[bucket] = e;
+}
+
 /* Context for fuse_getattr.  */
 struct fuse_getattr_ctx
 {
@@ -167,6 +225,9 @@ fuse_getattr (const char *path, struct stat *st)
       return 0;
     }
 
+  if (attr_cache_lookup (path, st))
+    return 0;
+
   ctx.file_exists = 0;
 
   pathname = xstrdup (path);
@@ -226,6 +287,7 @@ fuse_getattr (const char *path, struct stat *st)
   st->st_blocks = (st->st_size + 511) >> 9;
   st->st_atime = st->st_mtime = st->st_ctime = ctx.file_info.mtimeset
     ? ctx.file_info.mtime : 0;
+  attr_cache_store (path, st);
   grub_errno = GRUB_ERR_NONE;
   return 0;
 }
@@ -236,29 +298,25 @@ fuse_opendir (const char *path, struct fuse_file_info *fi)
   return 0;
 }
 
-/* FIXME */
-static grub_file_t files[65536];
-static int first_fd = 1;
-
-static int 
-fuse_open (const char *path, struct fuse_file_info *fi __attribute__ ((unused)))
+static int
+fuse_open (const char *path, struct fuse_file_info *fi)
 {
   grub_file_t file;
   file = grub_file_open (path, GRUB_FILE_TYPE_MOUNT);
   if (! file)
     return translate_error ();
-  files[first_fd++] = file;
-  fi->fh = first_fd;
-  files[first_fd++] = file;
+  /* Keep the handle in the FUSE file info, so opens are not limited
+     by a descriptor table and never collide.  */
+  fi->fh = (grub_uint64_t) (grub_addr_t) file;
   grub_errno = GRUB_ERR_NONE;
   return 0;
-} 
+}
 
-static int 
+static int
 fuse_read (const char *path, char *buf, size_t sz, off_t off,
 	   struct fuse_file_info *fi)
 {
-  grub_file_t file = files[fi->fh];
+  grub_file_t file = (grub_file_t) (grub_addr_t) fi->fh;
   grub_ssize_t size;
 
   if (off > file->size)
@@ -276,11 +334,11 @@ fuse_read (const char *path, char *buf, size_t sz, off_t off,
     }
 } 
 
-static int 
+static int
 fuse_release (const char *path, struct fuse_file_info *fi)
 {
-  grub_file_close (files[fi->fh]);
-  files[fi->fh] = NULL;
+  grub_file_close ((grub_file_t) (grub_addr_t) fi->fh);
+  fi->fh = 0;
   grub_errno = GRUB_ERR_NONE;
   return 0;
 }
@@ -300,16 +358,16 @@ fuse_readdir_call_fill (const char *filename,
 {
   struct fuse_readdir_ctx *ctx = data;
   struct stat st;
+  char *tmp;
+  int cacheable = 1;
 
+  tmp = xasprintf ("%s%s%s", ctx->path, ctx->path[1] ? "/" : "", filename);
   grub_memset (&st, 0, sizeof (st));
   st.st_mode = info->dir ? (0555 | S_IFDIR) : (0444 | S_IFREG);
   if (!info->dir)
     {
       grub_file_t file;
-      char *tmp;
-      tmp = xasprintf ("%s/%s", ctx->path, filename);
       file = grub_file_open (tmp, GRUB_FILE_TYPE_GET_SIZE);
-      free (tmp);
       /* Symlink to directory.  */
       if (! file && grub_errno == GRUB_ERR_BAD_FILE_TYPE)
 	{
@@ -319,6 +377,8 @@ fuse_readdir_call_fill (const char *filename,
       else if (!file)
 	{
 	  grub_errno = GRUB_ERR_NONE;
+	  /* Let a later getattr report the error.  */
+	  cacheable = 0;
 	}
       else
 	{
@@ -330,6 +390,9 @@ fuse_readdir_call_fill (const char *filename,
   st.st_blocks = (st.st_size + 511) >> 9;
   st.st_atime = st.st_mtime = st.st_ctime
     = info->mtimeset ? info->mtime : 0;
+  if (cacheable)
+    attr_cache_store (tmp, &st);
+  free (tmp);
   ctx->fill (ctx->buf, filename, &st, 0);
   return 0;
 }
@@ -565,7 +628,8 @@ main (int argc, char *argv[])
   fuse_args = xrealloc (fuse_args, (fuse_argc + 2) * sizeof (fuse_args[0]));
   fuse_args[fuse_argc] = xstrdup (argv[0]);
   fuse_argc++;
-  /* Run single-threaded.  */
+  /* Run single-threaded: the GRUB core (grub_errno, the disk cache,
+     the filesystem drivers) is not reentrant.  */
   fuse_args[fuse_argc] = xstrdup ("-s");
   fuse_argc++;
 
@@ -56,6 +56,11 @@
 
 #include "progname.h"
 
+enum
+  {
+    OPTION_BATCH = 0x301
+  };
+
 enum {
   PRINT_FS,
   PRINT_FS_UUID,
@@ -105,6 +110,7 @@ static const char *targets[] =
 
 static int print = PRINT_FS;
 static unsigned int argument_is_device = 0;
+static int batch = 0;
 
 static char *
 get_targets_string (void)
@@ -726,12 +732,168 @@ free_device_names:
     }
 }
 
+static void
+probe_init (const char *dev_map)
+{
+  /* Initialize the emulated biosdisk driver.  */
+  grub_util_biosdisk_init (dev_map);
+
+  /* Initialize all modules. */
+  grub_init_all ();
+  grub_gcry_init_all ();
+
+  grub_lvm_fini ();
+  grub_mdraid09_fini ();
+  grub_mdraid1x_fini ();
+  grub_diskfilter_fini ();
+  grub_diskfilter_init ();
+  grub_mdraid09_init ();
+  grub_mdraid1x_init ();
+  grub_lvm_init ();
+}
+
+static void
+probe_fini (void)
+{
+  grub_gcry_fini_all ();
+  grub_fini_all ();
+  grub_util_biosdisk_fini ();
+}
+
+static char
+default_delim (void)
+{
+  /* Items of the hint targets go on a single line.  */
+  if (print == PRINT_BIOS_HINT
+      || print == PRINT_IEEE1275_HINT || print == PRINT_BAREMETAL_HINT
+      || print == PRINT_EFI_HINT || print == PRINT_ARC_HINT)
+    return ' ';
+
+  return '\n';
+}
+
+#if !defined (__MINGW32__) || defined (__CYGWIN__)
+
+#include <sys/wait.h>
+
+/* Batch mode: serve probe requests read from stdin, one per line, in the
+   form "file TARGET PATH" or "device TARGET DEVICE...".  Replies consist
+   of the usual probe output followed by a line reading either @PROBE_OK@
+   or @PROBE_ERR@.  An empty request is answered with @PROBE_OK@ and no
+   output; shell callers use it to check that the process came up.
+
+   All the expensive setup (loading the device map, scanning devices,
+   module initialization) is done once and shared by every request, which
+   is the whole point: grub-mkconfig issues dozens of probes and the
+   per-process setup dwarfs the actual probing.  Each request is probed
+   in a forked child so that the fatal error exits sprinkled through
+   probe() take down only that request, not the server.  */
+
+static void
+batch_answer (int ok)
+{
+  printf (ok ? "@PROBE_OK@\n" : "@PROBE_ERR@\n");
+  fflush (stdout);
+}
+
+static void
+batch_run (const char *dev_map)
+{
+  char *line = NULL;
+  size_t linesz = 0;
+  ssize_t len;
+  int inited = 0;
+
+  while ((len = getline (&line, &linesz, stdin)) > 0)
+    {
+      char *target, *args, *p;
+      unsigned int i;
+      pid_t pid;
+      int status;
+
+      if (line[len - 1] == '\n')
+	line[--len] = '\0';
+
+      if (len == 0)
+	{
+	  batch_answer (1);
+	  continue;
+	}
+
+      target = strchr (line, ' ');
+      args = target ? strchr (target + 1, ' ') : NULL;
+      if (args == NULL)
+	{
+	  batch_answer (0);
+	  continue;
+	}
+      *target++ = '\0';
+      *args++ = '\0';
+
+      for (i = PRINT_FS; i < ARRAY_SIZE (targets); i++)
+	if (strcmp (target, targets[i]) == 0)
+	  break;
+      if ((strcmp (line, "file") != 0 && strcmp (line, "device") != 0)
+	  || i == ARRAY_SIZE (targets) || args[0] == '\0')
+	{
+	  batch_answer (0);
+	  continue;
+	}
+
+      if (!inited)
+	{
+	  probe_init (dev_map);
+	  inited = 1;
+	}
+
+      fflush (stdout);
+      pid = fork ();
+      if (pid == 0)
+	{
+	  char delim;
+
+	  print = i;
+	  delim = default_delim ();
+
+	  if (strcmp (line, "device") == 0)
+	    {
+	      char **devices;
+	      unsigned int ndevices = 0;
+
+	      devices = xmalloc ((strlen (args) / 2 + 2)
+				 * sizeof (devices[0]));
+	      for (p = strtok (args, " "); p; p = strtok (NULL, " "))
+		devices[ndevices++] = p;
+	      devices[ndevices] = NULL;
+	      probe (NULL, devices, delim);
+	    }
+	  else
+	    probe (args, NULL, delim);
+
+	  if (delim == ' ')
+	    putchar ('\n');
+	  exit (0);
+	}
+
+      batch_answer (pid > 0 && waitpid (pid, &status, 0) == pid
+		    && WIFEXITED (status) && WEXITSTATUS (status) == 0);
+    }
+
+  free (line);
+  if (inited)
+    probe_fini ();
+}
+
+#endif
+
 static struct argp_option options[] = {
   {"device",  'd', 0, 0,
    N_("given argument is a system device, not a path"), 0},
   {"device-map",  'm', N_("FILE"), 0,
    N_("use FILE as the device map [default=%s]"), 0},
   {"target",  't', N_("TARGET"), 0, 0, 0},
+  {"batch", OPTION_BATCH, 0, 0,
+   N_("serve probe requests read from standard input"), 0},
   {"verbose",     'v', 0,      0,
    N_("print verbose messages (pass twice to enable debug printing)."), 0},
   {0, '0', 0, 0, N_("separate items in output using ASCII NUL characters"), 0},
@@ -816,11 +978,17 @@ argp_parser (int key, char *arg, struct argp_state *state)
       arguments->zero_delim = 1;
       break;
 
+    case OPTION_BATCH:
+      batch = 1;
+      break;
+
     case 'v':
       verbosity++;
       break;
 
     case ARGP_KEY_NO_ARGS:
+      if (batch)
+	break;
       fprintf (stderr, "%s", _("No path or device is specified.\n"));
       argp_usage (state);
       break;
@@ -868,6 +1036,26 @@ main (int argc, char *argv[])
   if (verbosity > 1)
     grub_env_set ("debug", "all");
 
+  if (batch)
+    {
+#if !defined (__MINGW32__) || defined (__CYGWIN__)
+      batch_run (arguments.dev_map ? : DEFAULT_DEVICE_MAP);
+
+      {
+	size_t i;
+	for (i = 0; i < arguments.ndevices; i++)
+	  free (arguments.devices[i]);
+      }
+      free (arguments.devices);
+      free (arguments.dev_map);
+
+      return 0;
+#else
+      grub_util_error ("%s",
+		       _("batch mode is not supported on this platform"));
+#endif
+    }
+
   /* Obtain ARGUMENT.  */
   if (arguments.ndevices != 1 && !argument_is_device)
     {
@@ -879,28 +1067,9 @@ main (int argc, char *argv[])
       exit(1);
     }
 
-  /* Initialize the emulated biosdisk driver.  */
-  grub_util_biosdisk_init (arguments.dev_map ? : DEFAULT_DEVICE_MAP);
+  probe_init (arguments.dev_map ? : DEFAULT_DEVICE_MAP);
 
-  /* Initialize all modules. */
-  grub_init_all ();
-  grub_gcry_init_all ();
-
-  grub_lvm_fini ();
-  grub_mdraid09_fini ();
-  grub_mdraid1x_fini ();
-  grub_diskfilter_fini ();
-  grub_diskfilter_init ();
-  grub_mdraid09_init ();
-  grub_mdraid1x_init ();
-  grub_lvm_init ();
-
-  if (print == PRINT_BIOS_HINT
-      || print == PRINT_IEEE1275_HINT || print == PRINT_BAREMETAL_HINT
-      || print == PRINT_EFI_HINT || print == PRINT_ARC_HINT)
-    delim = ' ';
-  else
-    delim = '\n';
+  delim = default_delim ();
 
   if (arguments.zero_delim)
     delim = '\0';
@@ -915,9 +1084,7 @@ main (int argc, char *argv[])
     putchar ('\n');
 
   /* Free resources.  */
-  grub_gcry_fini_all ();
-  grub_fini_all ();
-  grub_util_biosdisk_fini ();
+  probe_fini ();
 
   {
     size_t i;
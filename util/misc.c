@@ -78,24 +78,12 @@ char *
 grub_util_read_image (const char *path)
 {
   char *img;
-  FILE *fp;
   size_t size;
 
-  grub_util_info ("reading %s", path);
-
   size = grub_util_get_image_size (path);
   img = (char *) xmalloc (size);
 
-  fp = grub_util_fopen (path, "rb");
-  if (! fp)
-    grub_util_error (_("cannot open `%s': %s"), path,
-		     strerror (errno));
-
-  if (fread (img, 1, size, fp) != size)
-    grub_util_error (_("cannot read `%s': %s"), path,
-		     strerror (errno));
-
-  fclose (fp);
+  grub_util_load_image (path, img);
 
   return img;
 }